@@ -112,6 +112,14 @@
 /** @brief The ARP cache. */
     _static ARPCacheRow_t xARPCache[ ipconfigARP_CACHE_ENTRIES ];
 
+    #if ( ipconfigUDP_CONNECTED_SOCKETS == 1 )
+
+/** @brief Incremented each time an entry of the ARP cache is replaced or removed.
+ * Connected UDP sockets use it to see whether their cached MAC address is still
+ * valid. */
+        volatile UBaseType_t uxARPCacheGeneration = 0U;
+    #endif
+
 
 /*
  * IP-clash detection is currently only used internally. When DHCP doesn't respond, the
@@ -188,6 +196,23 @@
             /* The field ulTargetProtocolAddress is well-aligned, a 32-bits copy. */
             ulTargetProtocolAddress = pxARPHeader->ulTargetProtocolAddress;
 
+            #if ( ipconfigUSE_MIB_COUNTERS == 1 )
+            {
+                if( pxARPHeader->usOperation == ( uint16_t ) ipARP_REQUEST )
+                {
+                    ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxTargetEndPoint, eMIBArpInRequests );
+                }
+                else if( pxARPHeader->usOperation == ( uint16_t ) ipARP_REPLY )
+                {
+                    ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxTargetEndPoint, eMIBArpInReplies );
+                }
+                else
+                {
+                    /* Some other ARP operation. */
+                }
+            }
+            #endif /* ( ipconfigUSE_MIB_COUNTERS == 1 ) */
+
             if( uxARPClashCounter != 0U )
             {
                 /* Has the timeout been reached? */
@@ -206,6 +231,7 @@
                  * allowed for an ARP packet. Drop the packet. See RFC 1812 section
                  * 3.3.2. */
                 iptraceDROPPED_INVALID_ARP_PACKET( pxARPHeader );
+                ipDROP_FRAME( pxNetworkBuffer, eIPDropARPInvalid );
             }
             else if( ( ipFIRST_LOOPBACK_IPv4 <= ( FreeRTOS_ntohl( ulSenderProtocolAddress ) ) ) &&
                      ( ( FreeRTOS_ntohl( ulSenderProtocolAddress ) ) < ipLAST_LOOPBACK_IPv4 ) )
@@ -213,6 +239,7 @@
                 /* The local loopback addresses must never appear outside a host. See RFC 1122
                  * section 3.2.1.3. */
                 iptraceDROPPED_INVALID_ARP_PACKET( pxARPHeader );
+                ipDROP_FRAME( pxNetworkBuffer, eIPDropARPInvalid );
             }
             /* Check whether there is a clash with another device for this IP address. */
             else if( ( pxTargetEndPoint != NULL ) && ( ulSenderProtocolAddress == pxTargetEndPoint->ipv4_settings.ulIPAddress ) )
@@ -349,6 +376,7 @@
         else
         {
             iptraceDROPPED_INVALID_ARP_PACKET( pxARPHeader );
+            ipDROP_FRAME( pxNetworkBuffer, eIPDropARPInvalid );
         }
 
         return eReturn;
@@ -645,6 +673,10 @@
 
             if( xReady == pdFALSE )
             {
+                #if ( ipconfigUDP_CONNECTED_SOCKETS == 1 )
+                    uxARPCacheGeneration++;
+                #endif
+
                 if( xLocation.xMacEntry >= 0 )
                 {
                     xLocation.xUseEntry = xLocation.xMacEntry;
@@ -1133,6 +1165,10 @@
                     /* The entry is no longer valid.  Wipe it out. */
                     iptraceARP_TABLE_ENTRY_EXPIRED( xARPCache[ x ].ulIPAddress );
                     xARPCache[ x ].ulIPAddress = 0U;
+
+                    #if ( ipconfigUDP_CONNECTED_SOCKETS == 1 )
+                        uxARPCacheGeneration++;
+                    #endif
                 }
             }
         }
@@ -1229,6 +1265,7 @@
                     /* Only the IP-task is allowed to call this function directly. */
                     if( pxEndPoint->pxNetworkInterface != NULL )
                     {
+                        ipMIB_COUNT_OUTPUT( pxNetworkBuffer );
                         ( void ) pxEndPoint->pxNetworkInterface->pfOutput( pxEndPoint->pxNetworkInterface, pxNetworkBuffer, pdTRUE );
                     }
                 }
@@ -1441,6 +1478,10 @@
         {
             ( void ) memset( xARPCache, 0, sizeof( xARPCache ) );
         }
+
+        #if ( ipconfigUDP_CONNECTED_SOCKETS == 1 )
+            uxARPCacheGeneration++;
+        #endif
     }
 /*-----------------------------------------------------------*/
 
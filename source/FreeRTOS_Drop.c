@@ -0,0 +1,239 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file FreeRTOS_Drop.c
+ * @brief Implements the drop-reason counters of the FreeRTOS+TCP network stack.
+ *
+ * Most frames are dropped by the IP-task, but a failure to obtain a network
+ * buffer, or to pass a frame to the IP-task, is recorded by the calling task.
+ * Therefore all accesses are done while the scheduler is suspended.
+ *
+ * Every reason has its own capture ring, so that a flood of frames dropped for
+ * one reason does not overwrite the frames dropped for another reason.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_Drop.h"
+
+#if ( ipconfigUSE_DROP_REASONS == 1 )
+
+/** @brief The number of drops per reason. */
+    static DropCounters_t xDropCounters;
+
+    #if ( ipconfigDROP_CAPTURE_COUNT > 0 )
+
+/** @brief A ring with the most recent dropped frames of one reason that were
+ *         sampled. */
+        typedef struct xDROP_RING
+        {
+            DroppedFrame_t xFrames[ ipconfigDROP_CAPTURE_COUNT ]; /**< The captured frames. */
+            size_t uxHead;                                        /**< The index in xFrames where the next frame will be stored. */
+            size_t uxCount;                                       /**< The number of valid entries in xFrames. */
+            uint32_t ulSampleCountDown;                           /**< Counts down to the next drop that will be captured. */
+        } DropRing_t;
+
+/** @brief A capture ring for every drop reason, indexed by eIPDropReason_t. */
+        static DropRing_t xDropRings[ eIPDropReasonCount ];
+    #endif
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Record that a frame is dropped: increment the counter of the reason,
+ *        and when sampled, store the first bytes of the frame in the ring of
+ *        that reason.
+ *
+ * @param[in] pxNetworkBuffer The frame that is dropped, or NULL when there is
+ *                            no frame.
+ * @param[in] eReason The reason why the frame is dropped.
+ */
+    void vIPDropFrame( const struct xNETWORK_BUFFER * pxNetworkBuffer,
+                       eIPDropReason_t eReason )
+    {
+        #if ( ipconfigDROP_CAPTURE_COUNT > 0 )
+            DropRing_t * pxRing;
+            DroppedFrame_t * pxEntry;
+            size_t uxLength;
+        #endif
+
+        if( ( BaseType_t ) eReason < ( BaseType_t ) eIPDropReasonCount )
+        {
+            vTaskSuspendAll();
+            {
+                xDropCounters.ulCounters[ eReason ]++;
+
+                #if ( ipconfigDROP_CAPTURE_COUNT > 0 )
+                    pxRing = &( xDropRings[ eReason ] );
+
+                    if( pxRing->ulSampleCountDown > 0U )
+                    {
+                        pxRing->ulSampleCountDown--;
+                    }
+                    else
+                    {
+                        pxRing->ulSampleCountDown = ( uint32_t ) ipconfigDROP_CAPTURE_SAMPLE_RATE - 1U;
+
+                        pxEntry = &( pxRing->xFrames[ pxRing->uxHead ] );
+                        pxEntry->xTimeStamp = xTaskGetTickCount();
+                        pxEntry->ucReason = ( uint8_t ) eReason;
+                        pxEntry->usLength = 0U;
+                        pxEntry->usCaptured = 0U;
+
+                        if( ( pxNetworkBuffer != NULL ) && ( pxNetworkBuffer->pucEthernetBuffer != NULL ) )
+                        {
+                            uxLength = pxNetworkBuffer->xDataLength;
+                            pxEntry->usLength = ( uxLength > 0xFFFFU ) ? ( uint16_t ) 0xFFFFU : ( uint16_t ) uxLength;
+
+                            if( uxLength > ( size_t ) ipconfigDROP_CAPTURE_BYTES )
+                            {
+                                uxLength = ( size_t ) ipconfigDROP_CAPTURE_BYTES;
+                            }
+
+                            ( void ) memcpy( pxEntry->ucHeader, pxNetworkBuffer->pucEthernetBuffer, uxLength );
+                            pxEntry->usCaptured = ( uint16_t ) uxLength;
+                        }
+
+                        pxRing->uxHead++;
+
+                        if( pxRing->uxHead >= ( size_t ) ipconfigDROP_CAPTURE_COUNT )
+                        {
+                            pxRing->uxHead = 0U;
+                        }
+
+                        if( pxRing->uxCount < ( size_t ) ipconfigDROP_CAPTURE_COUNT )
+                        {
+                            pxRing->uxCount++;
+                        }
+                    }
+                #else /* if ( ipconfigDROP_CAPTURE_COUNT > 0 ) */
+                    ( void ) pxNetworkBuffer;
+                #endif /* if ( ipconfigDROP_CAPTURE_COUNT > 0 ) */
+            }
+            ( void ) xTaskResumeAll();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Get a snapshot of the drop counters.
+ *
+ * @param[out] pxCounters The snapshot will be written here.
+ *
+ * @return pdPASS when the snapshot was written, pdFAIL when pxCounters is NULL.
+ */
+    BaseType_t FreeRTOS_GetDropCounters( DropCounters_t * pxCounters )
+    {
+        BaseType_t xReturn = pdFAIL;
+
+        if( pxCounters != NULL )
+        {
+            vTaskSuspendAll();
+            {
+                ( void ) memcpy( pxCounters, &( xDropCounters ), sizeof( *pxCounters ) );
+            }
+            ( void ) xTaskResumeAll();
+
+            xReturn = pdPASS;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Clear the drop counters and the capture rings.
+ */
+    void FreeRTOS_ClearDropCounters( void )
+    {
+        vTaskSuspendAll();
+        {
+            ( void ) memset( &( xDropCounters ), 0, sizeof( xDropCounters ) );
+
+            #if ( ipconfigDROP_CAPTURE_COUNT > 0 )
+                ( void ) memset( xDropRings, 0, sizeof( xDropRings ) );
+            #endif
+        }
+        ( void ) xTaskResumeAll();
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigDROP_CAPTURE_COUNT > 0 )
+
+/**
+ * @brief Copy the captured frames of one drop reason, the oldest first.
+ *
+ * @param[in] eReason The drop reason whose frames are wanted.
+ * @param[out] pxFrames The array where the frames will be written.
+ * @param[in] uxMaxCount The number of entries in pxFrames.
+ *
+ * @return The number of frames that were copied.
+ */
+        size_t FreeRTOS_GetDroppedFrames( eIPDropReason_t eReason,
+                                          DroppedFrame_t * pxFrames,
+                                          size_t uxMaxCount )
+        {
+            size_t uxCopied = 0U;
+            size_t uxIndex;
+            size_t uxCount;
+            const DropRing_t * pxRing;
+
+            if( ( pxFrames != NULL ) && ( ( BaseType_t ) eReason < ( BaseType_t ) eIPDropReasonCount ) )
+            {
+                pxRing = &( xDropRings[ eReason ] );
+
+                vTaskSuspendAll();
+                {
+                    /* When not all entries fit, the most recent ones are copied. */
+                    uxCopied = ( pxRing->uxCount < uxMaxCount ) ? pxRing->uxCount : uxMaxCount;
+                    uxIndex = ( pxRing->uxHead + ( size_t ) ipconfigDROP_CAPTURE_COUNT - uxCopied ) % ( size_t ) ipconfigDROP_CAPTURE_COUNT;
+
+                    for( uxCount = 0U; uxCount < uxCopied; uxCount++ )
+                    {
+                        ( void ) memcpy( &( pxFrames[ uxCount ] ), &( pxRing->xFrames[ uxIndex ] ), sizeof( pxFrames[ uxCount ] ) );
+                        uxIndex = ( uxIndex + 1U ) % ( size_t ) ipconfigDROP_CAPTURE_COUNT;
+                    }
+                }
+                ( void ) xTaskResumeAll();
+            }
+
+            return uxCopied;
+        }
+    #endif /* ( ipconfigDROP_CAPTURE_COUNT > 0 ) */
+/*-----------------------------------------------------------*/
+
+#endif /* ( ipconfigUSE_DROP_REASONS == 1 ) */
@@ -97,6 +97,8 @@
             /* coverity[misra_c_2012_rule_11_3_violation] */
             ICMPPacket_t * pxICMPPacket = ( ( ICMPPacket_t * ) pxNetworkBuffer->pucEthernetBuffer );
 
+            ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIcmpInMsgs );
+
             switch( pxICMPPacket->xICMPHeader.ucTypeOfMessage )
             {
                 case ipICMP_ECHO_REQUEST:
@@ -120,6 +122,11 @@
                     break;
             }
         }
+        else
+        {
+            ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIcmpInErrors );
+            ipDROP_FRAME( pxNetworkBuffer, eIPDropICMPInvalid );
+        }
 
         return eReturn;
     }
@@ -0,0 +1,1439 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file FreeRTOS_IGMP.c
+ * @brief Implements multicast group management for the FreeRTOS+TCP network stack:
+ *        IGMPv3 for IPv4 and MLDv2 for IPv6, falling back to IGMPv2, IGMPv1 and
+ *        MLDv1 when an older querier is present on the link.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_IP_Timers.h"
+#include "FreeRTOS_IGMP.h"
+#include "FreeRTOS_Routing.h"
+#include "FreeRTOS_IPv4_Utils.h"
+#include "FreeRTOS_IPv6_Utils.h"
+#include "NetworkBufferManagement.h"
+
+#if ( ipconfigSUPPORT_IP_MULTICAST == 1 )
+
+/** @brief The period of the multicast timer in ms. IGMP expresses its
+ *         response times in tenths of a second. */
+    #define ipMULTICAST_TIMER_PERIOD_MS          ( 100U )
+
+/** @brief The number of unsolicited reports sent when a group is joined
+ *         ( the Robustness Variable of RFC 3376 and RFC 3810 ). */
+    #define ipMULTICAST_UNSOLICITED_REPORTS      ( 2U )
+
+/** @brief The number of timer periods between unsolicited reports. */
+    #define ipMULTICAST_UNSOLICITED_INTERVAL     ( 10U )
+
+/** @brief The number of timer periods during which the older protocol is used
+ *         after a query of an older querier was received ( 260 seconds ). */
+    #define ipMULTICAST_OLDER_QUERIER_TIMEOUT    ( 2600U )
+
+/** @brief The maximum response time for an IGMPv1 query, in timer periods. */
+    #define ipIGMP_V1_MAX_RESPONSE_TIME          ( 100U )
+
+/* Group record types of IGMPv3 and MLDv2 reports. */
+    #define ipMULTICAST_MODE_IS_EXCLUDE          ( ( uint8_t ) 2U ) /**< Current-state record: listening to all sources. */
+    #define ipMULTICAST_CHANGE_TO_INCLUDE        ( ( uint8_t ) 3U ) /**< State-change record: the group was left. */
+    #define ipMULTICAST_CHANGE_TO_EXCLUDE        ( ( uint8_t ) 4U ) /**< State-change record: the group was joined. */
+
+/* Sizes of the IGMP messages. */
+    #define ipIGMP_MESSAGE_SIZE                  ( 8U )  /**< An IGMPv1/v2 message, or the header of an IGMPv3 report. */
+    #define ipIGMP_V3_QUERY_MIN_SIZE             ( 12U ) /**< The minimum size of an IGMPv3 query. */
+    #define ipIGMP_V3_RECORD_SIZE                ( 8U )  /**< A group record without sources. */
+    #define ipIPv4_ROUTER_ALERT_SIZE             ( 4U )  /**< The IPv4 Router Alert option. */
+
+/* Sizes of the MLD messages. */
+    #define ipMLD_V1_MESSAGE_SIZE                ( 24U ) /**< An MLDv1 message. */
+    #define ipMLD_V2_QUERY_MIN_SIZE              ( 28U ) /**< The minimum size of an MLDv2 query. */
+    #define ipMLD_V2_REPORT_HEADER_SIZE          ( 8U )  /**< The header of an MLDv2 report. */
+    #define ipMLD_V2_RECORD_SIZE                 ( 20U ) /**< A group record without sources. */
+    #define ipIPv6_HOP_BY_HOP_SIZE               ( 8U )  /**< A Hop-by-Hop header with a Router Alert option. */
+
+/** @brief The address to which IGMPv2 leave messages are sent: 224.0.0.2 */
+    #define ipIGMP_ALL_ROUTERS_ADDRESS           ( 0xE0000002UL )
+
+/** @brief The address to which IGMPv3 reports are sent: 224.0.0.22 */
+    #define ipIGMP_V3_REPORT_ADDRESS             ( 0xE0000016UL )
+
+/** @brief The type of report that is sent for a group. */
+    typedef enum
+    {
+        eMulticastJoin,        /**< State-change report: the group was joined. */
+        eMulticastLeave,       /**< State-change report: the group was left. */
+        eMulticastCurrentState /**< Current-state report: the answer to a query. */
+    } eMulticastMessage_t;
+
+/** @brief A socket that has joined a multicast group on an interface. */
+    typedef struct xMULTICAST_MEMBERSHIP
+    {
+        IP_Address_t xGroup;                    /**< The multicast group address. */
+        struct xNetworkInterface * pxInterface; /**< The interface on which the group was joined. */
+        const struct xSOCKET * pxSocket;        /**< The socket that joined the group. */
+        uint16_t usReportTicks;                 /**< Timer periods until a report is sent, zero when no report is pending. */
+        uint16_t usOlderQuerierTicks;           /**< Timer periods during which IGMPv2 or MLDv1 will be used. */
+        uint16_t usV1QuerierTicks;              /**< Timer periods during which IGMPv1 will be used. */
+        uint8_t ucUnsolicitedReports;           /**< The number of unsolicited reports that are still to be sent. */
+        struct
+        {
+            uint32_t
+                bInUse : 1,        /**< This entry is in use. */
+                bIsIPv6 : 1,       /**< The group is an IPv6 group. */
+                bJoinPending : 1,  /**< The IP-task has not yet handled the join. */
+                bLeavePending : 1; /**< The IP-task has not yet handled the leave. */
+        }
+        bits;
+    } MulticastMembership_t;
+
+/** @brief The table of memberships. It is changed by the API while the
+ *         scheduler is suspended, and the IP-task does the network work. */
+    static MulticastMembership_t xMemberships[ ipconfigMULTICAST_MAX_MEMBERSHIPS ];
+
+/** @brief pdTRUE while the multicast timer is running. */
+    static BaseType_t xMulticastTimerActive = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Check if two entries describe the same group on the same interface.
+ */
+    static BaseType_t prvSameGroup( const MulticastMembership_t * pxLeft,
+                                    const MulticastMembership_t * pxRight );
+
+/*
+ * Check if other, active, memberships exist for the group of an entry.
+ */
+    static BaseType_t prvGroupHasOtherMember( size_t uxIndex );
+
+/*
+ * Check if an entry is the first membership for its group. Only the first
+ * one will send reports.
+ */
+    static BaseType_t prvIsFirstMember( size_t uxIndex );
+
+/*
+ * Start or stop the multicast timer, depending on the pending reports.
+ */
+    static void prvMulticastTimerUpdate( void );
+
+/*
+ * Let the network interface receive or drop the MAC address of a group.
+ */
+    static void prvUpdateMACFilter( const MulticastMembership_t * pxEntry,
+                                    BaseType_t xAdd );
+
+/*
+ * Find an end-point that can be used as the source of a report.
+ */
+    static NetworkEndPoint_t * prvMulticastEndPoint( const NetworkInterface_t * pxInterface,
+                                                     BaseType_t xIsIPv6 );
+
+/*
+ * Send a report for a group.
+ */
+    static void prvSendReport( const MulticastMembership_t * pxEntry,
+                               eMulticastMessage_t eMessage );
+
+/*
+ * Pass a complete IGMP or MLD frame to the network interface.
+ */
+    static void prvSendFrame( NetworkBufferDescriptor_t * pxNetworkBuffer,
+                              NetworkEndPoint_t * pxEndPoint );
+
+/*
+ * A query was received: schedule reports for the groups that it asks for.
+ */
+    static void prvMulticastQuery( const NetworkInterface_t * pxInterface,
+                                   BaseType_t xIsIPv6,
+                                   const IP_Address_t * pxGroup,
+                                   uint32_t ulMaxResponseTicks,
+                                   BaseType_t xOlderQuerier,
+                                   BaseType_t xV1Querier );
+
+/*
+ * Another host reported a group: in IGMPv2/MLDv1 mode, no report is needed.
+ */
+    static void prvMulticastReportHeard( const NetworkInterface_t * pxInterface,
+                                         BaseType_t xIsIPv6,
+                                         const IP_Address_t * pxGroup );
+
+    #if ( ipconfigUSE_IPv4 != 0 )
+
+/*
+ * Create and send an IGMPv1, IGMPv2 or IGMPv3 message.
+ */
+        static void prvSendIGMPMessage( const MulticastMembership_t * pxEntry,
+                                        eMulticastMessage_t eMessage );
+    #endif
+
+    #if ( ipconfigUSE_IPv6 != 0 )
+
+/*
+ * Create and send an MLDv1 or MLDv2 message.
+ */
+        static void prvSendMLDMessage( const MulticastMembership_t * pxEntry,
+                                       eMulticastMessage_t eMessage );
+    #endif
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check if two entries describe the same group on the same interface.
+ *
+ * @param[in] pxLeft The first entry.
+ * @param[in] pxRight The second entry.
+ *
+ * @return pdTRUE when the group, the address family and the interface are equal.
+ */
+    static BaseType_t prvSameGroup( const MulticastMembership_t * pxLeft,
+                                    const MulticastMembership_t * pxRight )
+    {
+        BaseType_t xReturn = pdFALSE;
+
+        if( ( pxLeft->bits.bIsIPv6 == pxRight->bits.bIsIPv6 ) &&
+            ( pxLeft->pxInterface == pxRight->pxInterface ) )
+        {
+            if( pxLeft->bits.bIsIPv6 != pdFALSE_UNSIGNED )
+            {
+                if( memcmp( pxLeft->xGroup.xIP_IPv6.ucBytes, pxRight->xGroup.xIP_IPv6.ucBytes, ipSIZE_OF_IPv6_ADDRESS ) == 0 )
+                {
+                    xReturn = pdTRUE;
+                }
+            }
+            else if( pxLeft->xGroup.ulIP_IPv4 == pxRight->xGroup.ulIP_IPv4 )
+            {
+                xReturn = pdTRUE;
+            }
+            else
+            {
+                /* Different IPv4 groups. */
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check if other memberships exist for the group of an entry. Entries
+ *        of which the join has not been handled yet are not counted.
+ *
+ * @param[in] uxIndex The index of the entry.
+ *
+ * @return pdTRUE when another socket is a member of the same group.
+ */
+    static BaseType_t prvGroupHasOtherMember( size_t uxIndex )
+    {
+        BaseType_t xReturn = pdFALSE;
+        size_t uxOther;
+
+        for( uxOther = 0U; uxOther < ( size_t ) ipconfigMULTICAST_MAX_MEMBERSHIPS; uxOther++ )
+        {
+            if( ( uxOther != uxIndex ) &&
+                ( xMemberships[ uxOther ].bits.bInUse != pdFALSE_UNSIGNED ) &&
+                ( xMemberships[ uxOther ].bits.bJoinPending == pdFALSE_UNSIGNED ) &&
+                ( prvSameGroup( &( xMemberships[ uxOther ] ), &( xMemberships[ uxIndex ] ) ) != pdFALSE ) )
+            {
+                xReturn = pdTRUE;
+                break;
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check if an entry is the first active membership of its group.
+ *
+ * @param[in] uxIndex The index of the entry.
+ *
+ * @return pdTRUE when no active entry with a lower index has the same group.
+ */
+    static BaseType_t prvIsFirstMember( size_t uxIndex )
+    {
+        BaseType_t xReturn = pdTRUE;
+        size_t uxOther;
+
+        for( uxOther = 0U; uxOther < uxIndex; uxOther++ )
+        {
+            if( ( xMemberships[ uxOther ].bits.bInUse != pdFALSE_UNSIGNED ) &&
+                ( xMemberships[ uxOther ].bits.bJoinPending == pdFALSE_UNSIGNED ) &&
+                ( xMemberships[ uxOther ].bits.bLeavePending == pdFALSE_UNSIGNED ) &&
+                ( prvSameGroup( &( xMemberships[ uxOther ] ), &( xMemberships[ uxIndex ] ) ) != pdFALSE ) )
+            {
+                xReturn = pdFALSE;
+                break;
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The timer is only running while a report is scheduled, or while an
+ *        older querier is present.
+ */
+    static void prvMulticastTimerUpdate( void )
+    {
+        BaseType_t xNeeded = pdFALSE;
+        size_t uxIndex;
+
+        for( uxIndex = 0U; uxIndex < ( size_t ) ipconfigMULTICAST_MAX_MEMBERSHIPS; uxIndex++ )
+        {
+            if( ( xMemberships[ uxIndex ].bits.bInUse != pdFALSE_UNSIGNED ) &&
+                ( ( xMemberships[ uxIndex ].usReportTicks != 0U ) ||
+                  ( xMemberships[ uxIndex ].usOlderQuerierTicks != 0U ) ||
+                  ( xMemberships[ uxIndex ].usV1QuerierTicks != 0U ) ) )
+            {
+                xNeeded = pdTRUE;
+                break;
+            }
+        }
+
+        if( xNeeded != xMulticastTimerActive )
+        {
+            if( xNeeded != pdFALSE )
+            {
+                vMulticastTimerReload( pdMS_TO_TICKS( ipMULTICAST_TIMER_PERIOD_MS ) );
+            }
+            else
+            {
+                vIPSetMulticastTimerEnableState( pdFALSE );
+            }
+
+            xMulticastTimerActive = xNeeded;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Add or remove the MAC address of a group to the filter of the
+ *        network interface. The driver counts the number of calls for
+ *        each address.
+ *
+ * @param[in] pxEntry The membership.
+ * @param[in] xAdd pdTRUE to receive the group, pdFALSE to drop it.
+ */
+    static void prvUpdateMACFilter( const MulticastMembership_t * pxEntry,
+                                    BaseType_t xAdd )
+    {
+        MACAddress_t xMACAddress;
+        NetworkInterface_t * pxInterface = pxEntry->pxInterface;
+
+        if( pxEntry->bits.bIsIPv6 != pdFALSE_UNSIGNED )
+        {
+            #if ( ipconfigUSE_IPv6 != 0 )
+                vSetMultiCastIPv6MacAddress( &( pxEntry->xGroup.xIP_IPv6 ), &( xMACAddress ) );
+            #endif
+        }
+        else
+        {
+            #if ( ipconfigUSE_IPv4 != 0 )
+                vSetMultiCastIPv4MacAddress( pxEntry->xGroup.ulIP_IPv4, &( xMACAddress ) );
+            #endif
+        }
+
+        if( xAdd != pdFALSE )
+        {
+            if( pxInterface->pfAddAllowedMAC != NULL )
+            {
+                pxInterface->pfAddAllowedMAC( pxInterface, xMACAddress.ucBytes );
+            }
+        }
+        else
+        {
+            if( pxInterface->pfRemoveAllowedMAC != NULL )
+            {
+                pxInterface->pfRemoveAllowedMAC( pxInterface, xMACAddress.ucBytes );
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Find an end-point of an interface that can be used as the source
+ *        of a report. For IPv4, an end-point with an address is preferred.
+ *        For IPv6, a link-local address is preferred, as required by MLD.
+ *
+ * @param[in] pxInterface The interface.
+ * @param[in] xIsIPv6 pdTRUE for an IPv6 end-point.
+ *
+ * @return The end-point, or NULL when the interface has none of the family.
+ */
+    static NetworkEndPoint_t * prvMulticastEndPoint( const NetworkInterface_t * pxInterface,
+                                                     BaseType_t xIsIPv6 )
+    {
+        NetworkEndPoint_t * pxEndPoint = FreeRTOS_FirstEndPoint( pxInterface );
+        NetworkEndPoint_t * pxFound = NULL;
+
+        while( pxEndPoint != NULL )
+        {
+            if( ( xIsIPv6 != pdFALSE ) && ( ENDPOINT_IS_IPv6( pxEndPoint ) ) )
+            {
+                if( pxFound == NULL )
+                {
+                    pxFound = pxEndPoint;
+                }
+
+                #if ( ipconfigUSE_IPv6 != 0 )
+                    if( xIPv6_GetIPType( &( pxEndPoint->ipv6_settings.xIPAddress ) ) == eIPv6_LinkLocal )
+                    {
+                        pxFound = pxEndPoint;
+                        break;
+                    }
+                #endif
+            }
+            else if( ( xIsIPv6 == pdFALSE ) && ( ENDPOINT_IS_IPv4( pxEndPoint ) ) )
+            {
+                if( pxFound == NULL )
+                {
+                    pxFound = pxEndPoint;
+                }
+
+                #if ( ipconfigUSE_IPv4 != 0 )
+                    if( pxEndPoint->ipv4_settings.ulIPAddress != 0U )
+                    {
+                        pxFound = pxEndPoint;
+                        break;
+                    }
+                #endif
+            }
+            else
+            {
+                /* An end-point of the other family. */
+            }
+
+            pxEndPoint = FreeRTOS_NextEndPoint( pxInterface, pxEndPoint );
+        }
+
+        return pxFound;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Send a report for a group, using the protocol of its family.
+ *
+ * @param[in] pxEntry A copy of the membership.
+ * @param[in] eMessage The type of report.
+ */
+    static void prvSendReport( const MulticastMembership_t * pxEntry,
+                               eMulticastMessage_t eMessage )
+    {
+        if( pxEntry->bits.bIsIPv6 != pdFALSE_UNSIGNED )
+        {
+            #if ( ipconfigUSE_IPv6 != 0 )
+                prvSendMLDMessage( pxEntry, eMessage );
+            #endif
+        }
+        else
+        {
+            #if ( ipconfigUSE_IPv4 != 0 )
+                prvSendIGMPMessage( pxEntry, eMessage );
+            #endif
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Pad a complete frame to the minimum size and pass it to the network
+ *        interface of the end-point.
+ *
+ * @param[in] pxNetworkBuffer The frame, it will be released after sending.
+ * @param[in] pxEndPoint The end-point from which the frame is sent.
+ */
+    static void prvSendFrame( NetworkBufferDescriptor_t * pxNetworkBuffer,
+                              NetworkEndPoint_t * pxEndPoint )
+    {
+        NetworkInterface_t * pxInterface = pxEndPoint->pxNetworkInterface;
+
+        pxNetworkBuffer->pxEndPoint = pxEndPoint;
+        pxNetworkBuffer->pxInterface = pxInterface;
+
+        #if ( ipconfigETHERNET_MINIMUM_PACKET_BYTES > 0 )
+        {
+            if( pxNetworkBuffer->xDataLength < ( size_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES )
+            {
+                ( void ) memset( &( pxNetworkBuffer->pucEthernetBuffer[ pxNetworkBuffer->xDataLength ] ), 0, ( size_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES - pxNetworkBuffer->xDataLength );
+                pxNetworkBuffer->xDataLength = ( size_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES;
+            }
+        }
+        #endif /* ( ipconfigETHERNET_MINIMUM_PACKET_BYTES > 0 ) */
+
+        iptraceNETWORK_INTERFACE_OUTPUT( pxNetworkBuffer->xDataLength, pxNetworkBuffer->pucEthernetBuffer );
+        ipMIB_COUNT_OUTPUT( pxNetworkBuffer );
+        ( void ) pxInterface->pfOutput( pxInterface, pxNetworkBuffer, pdTRUE );
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_IPv4 != 0 )
+
+/**
+ * @brief Create and send an IGMP message. While an IGMPv1 querier is present,
+ *        IGMPv1 reports are sent and leaving is silent ( RFC 2236 section 4 ).
+ *        While an IGMPv2 querier is present, IGMPv2 reports and leave
+ *        messages are sent, otherwise an IGMPv3 report with a single group
+ *        record.
+ *
+ * @param[in] pxEntry A copy of the membership.
+ * @param[in] eMessage The type of report.
+ */
+        static void prvSendIGMPMessage( const MulticastMembership_t * pxEntry,
+                                        eMulticastMessage_t eMessage )
+        {
+            NetworkEndPoint_t * pxEndPoint = prvMulticastEndPoint( pxEntry->pxInterface, pdFALSE );
+            NetworkBufferDescriptor_t * pxNetworkBuffer = NULL;
+            size_t uxIGMPLength;
+            uint32_t ulDestination;
+            uint8_t ucType;
+            uint8_t ucRecordType;
+
+            if( pxEntry->usV1QuerierTicks != 0U )
+            {
+                uxIGMPLength = ipIGMP_MESSAGE_SIZE;
+                ucType = ipIGMP_V1_MEMBERSHIP_REPORT;
+                ulDestination = pxEntry->xGroup.ulIP_IPv4;
+
+                if( eMessage == eMulticastLeave )
+                {
+                    /* IGMPv1 has no leave message. */
+                    pxEndPoint = NULL;
+                }
+            }
+            else if( pxEntry->usOlderQuerierTicks != 0U )
+            {
+                uxIGMPLength = ipIGMP_MESSAGE_SIZE;
+
+                if( eMessage == eMulticastLeave )
+                {
+                    ucType = ipIGMP_LEAVE_GROUP;
+                    ulDestination = FreeRTOS_htonl( ipIGMP_ALL_ROUTERS_ADDRESS );
+                }
+                else
+                {
+                    ucType = ipIGMP_V2_MEMBERSHIP_REPORT;
+                    ulDestination = pxEntry->xGroup.ulIP_IPv4;
+                }
+            }
+            else
+            {
+                uxIGMPLength = ipIGMP_MESSAGE_SIZE + ipIGMP_V3_RECORD_SIZE;
+                ucType = ipIGMP_V3_MEMBERSHIP_REPORT;
+                ulDestination = FreeRTOS_htonl( ipIGMP_V3_REPORT_ADDRESS );
+            }
+
+            if( pxEndPoint != NULL )
+            {
+                pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipIPv4_ROUTER_ALERT_SIZE + uxIGMPLength, ( TickType_t ) 0U );
+            }
+
+            if( pxNetworkBuffer != NULL )
+            {
+                uint8_t * pucBuffer = pxNetworkBuffer->pucEthernetBuffer;
+
+                /* MISRA Ref 11.3.1 [Misaligned access] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                /* coverity[misra_c_2012_rule_11_3_violation] */
+                EthernetHeader_t * pxEthernetHeader = ( ( EthernetHeader_t * ) pucBuffer );
+
+                /* MISRA Ref 11.3.1 [Misaligned access] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                /* coverity[misra_c_2012_rule_11_3_violation] */
+                IPHeader_t * pxIPHeader = ( ( IPHeader_t * ) &( pucBuffer[ ipSIZE_OF_ETH_HEADER ] ) );
+                uint8_t * pucOption = &( pucBuffer[ ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER ] );
+                uint8_t * pucIGMP = &( pucBuffer[ ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipIPv4_ROUTER_ALERT_SIZE ] );
+                uint16_t usChecksum;
+
+                pxNetworkBuffer->xDataLength = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipIPv4_ROUTER_ALERT_SIZE + uxIGMPLength;
+
+                vSetMultiCastIPv4MacAddress( ulDestination, &( pxEthernetHeader->xDestinationAddress ) );
+                ( void ) memcpy( pxEthernetHeader->xSourceAddress.ucBytes, pxEndPoint->xMACAddress.ucBytes, ipMAC_ADDRESS_LENGTH_BYTES );
+                pxEthernetHeader->usFrameType = ipIPv4_FRAME_TYPE;
+
+                /* The IP-header has one option: a Router Alert. */
+                pxIPHeader->ucVersionHeaderLength = ( uint8_t ) ( ipIPV4_VERSION_HEADER_LENGTH_MIN + ( ipIPv4_ROUTER_ALERT_SIZE >> 2 ) );
+                pxIPHeader->ucDifferentiatedServicesCode = 0xC0U; /* Internetwork control. */
+                pxIPHeader->usLength = FreeRTOS_htons( ( uint16_t ) ( ipSIZE_OF_IPv4_HEADER + ipIPv4_ROUTER_ALERT_SIZE + uxIGMPLength ) );
+                pxIPHeader->usIdentification = FreeRTOS_htons( usPacketIdentifier );
+                usPacketIdentifier++;
+                pxIPHeader->usFragmentOffset = 0U;
+                pxIPHeader->ucTimeToLive = 1U;
+                pxIPHeader->ucProtocol = ( uint8_t ) ipPROTOCOL_IGMP;
+                pxIPHeader->usHeaderChecksum = 0U;
+                pxIPHeader->ulSourceIPAddress = pxEndPoint->ipv4_settings.ulIPAddress;
+                pxIPHeader->ulDestinationIPAddress = ulDestination;
+
+                pucOption[ 0 ] = 0x94U; /* Copied flag, option number 20. */
+                pucOption[ 1 ] = 0x04U; /* Option length. */
+                pucOption[ 2 ] = 0x00U; /* Every router examines the packet. */
+                pucOption[ 3 ] = 0x00U;
+
+                ( void ) memset( pucIGMP, 0, uxIGMPLength );
+                pucIGMP[ 0 ] = ucType;
+
+                if( ucType == ipIGMP_V3_MEMBERSHIP_REPORT )
+                {
+                    if( eMessage == eMulticastJoin )
+                    {
+                        ucRecordType = ipMULTICAST_CHANGE_TO_EXCLUDE;
+                    }
+                    else if( eMessage == eMulticastLeave )
+                    {
+                        ucRecordType = ipMULTICAST_CHANGE_TO_INCLUDE;
+                    }
+                    else
+                    {
+                        ucRecordType = ipMULTICAST_MODE_IS_EXCLUDE;
+                    }
+
+                    /* One group record without sources. */
+                    pucIGMP[ 7 ] = 1U;
+                    pucIGMP[ ipIGMP_MESSAGE_SIZE ] = ucRecordType;
+                    ( void ) memcpy( &( pucIGMP[ ipIGMP_MESSAGE_SIZE + 4U ] ), &( pxEntry->xGroup.ulIP_IPv4 ), sizeof( uint32_t ) );
+                }
+                else
+                {
+                    ( void ) memcpy( &( pucIGMP[ 4 ] ), &( pxEntry->xGroup.ulIP_IPv4 ), sizeof( uint32_t ) );
+                }
+
+                /* Network interfaces do not calculate the IGMP checksum. */
+                usChecksum = usGenerateChecksum( 0U, pucIGMP, uxIGMPLength );
+                usChecksum = ( uint16_t ) ~FreeRTOS_htons( usChecksum );
+                ( void ) memcpy( &( pucIGMP[ 2 ] ), &( usChecksum ), sizeof( usChecksum ) );
+
+                #if ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+                {
+                    pxIPHeader->usHeaderChecksum = usGenerateChecksum( 0U, ( uint8_t * ) &( pxIPHeader->ucVersionHeaderLength ), ipSIZE_OF_IPv4_HEADER + ipIPv4_ROUTER_ALERT_SIZE );
+                    pxIPHeader->usHeaderChecksum = ( uint16_t ) ~FreeRTOS_htons( pxIPHeader->usHeaderChecksum );
+                }
+                #endif
+
+                prvSendFrame( pxNetworkBuffer, pxEndPoint );
+            }
+        }
+    #endif /* ( ipconfigUSE_IPv4 != 0 ) */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_IPv6 != 0 )
+
+/**
+ * @brief Create and send an MLD message. While an MLDv1 querier is present,
+ *        MLDv1 reports and done messages are sent, otherwise an MLDv2 report
+ *        with a single group record.
+ *
+ * @param[in] pxEntry A copy of the membership.
+ * @param[in] eMessage The type of report.
+ */
+        static void prvSendMLDMessage( const MulticastMembership_t * pxEntry,
+                                       eMulticastMessage_t eMessage )
+        {
+            NetworkEndPoint_t * pxEndPoint = prvMulticastEndPoint( pxEntry->pxInterface, pdTRUE );
+            NetworkBufferDescriptor_t * pxNetworkBuffer = NULL;
+            IPv6_Address_t xDestination;
+            size_t uxMLDLength;
+            uint8_t ucType;
+            uint8_t ucRecordType;
+
+            ( void ) memset( xDestination.ucBytes, 0, sizeof( xDestination.ucBytes ) );
+            xDestination.ucBytes[ 0 ] = 0xffU;
+            xDestination.ucBytes[ 1 ] = 0x02U;
+
+            if( pxEntry->usOlderQuerierTicks != 0U )
+            {
+                uxMLDLength = ipMLD_V1_MESSAGE_SIZE;
+
+                if( eMessage == eMulticastLeave )
+                {
+                    /* ff02::2, all routers. */
+                    ucType = ipICMP_MULTICAST_LISTENER_DONE_IPv6;
+                    xDestination.ucBytes[ 15 ] = 0x02U;
+                }
+                else
+                {
+                    ucType = ipICMP_MULTICAST_LISTENER_REPORT_IPv6;
+                    ( void ) memcpy( xDestination.ucBytes, pxEntry->xGroup.xIP_IPv6.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+                }
+            }
+            else
+            {
+                /* ff02::16, all MLDv2-capable routers. */
+                uxMLDLength = ipMLD_V2_REPORT_HEADER_SIZE + ipMLD_V2_RECORD_SIZE;
+                ucType = ipICMP_MULTICAST_LISTENER_REPORT_V2_IPv6;
+                xDestination.ucBytes[ 15 ] = 0x16U;
+            }
+
+            if( pxEndPoint != NULL )
+            {
+                pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER + ipIPv6_HOP_BY_HOP_SIZE + uxMLDLength, ( TickType_t ) 0U );
+            }
+
+            if( pxNetworkBuffer != NULL )
+            {
+                uint8_t * pucBuffer = pxNetworkBuffer->pucEthernetBuffer;
+
+                /* MISRA Ref 11.3.1 [Misaligned access] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                /* coverity[misra_c_2012_rule_11_3_violation] */
+                EthernetHeader_t * pxEthernetHeader = ( ( EthernetHeader_t * ) pucBuffer );
+
+                /* MISRA Ref 11.3.1 [Misaligned access] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                /* coverity[misra_c_2012_rule_11_3_violation] */
+                IPHeader_IPv6_t * pxIPHeader = ( ( IPHeader_IPv6_t * ) &( pucBuffer[ ipSIZE_OF_ETH_HEADER ] ) );
+                uint8_t * pucHopByHop = &( pucBuffer[ ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER ] );
+                uint8_t * pucMLD = &( pucBuffer[ ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER + ipIPv6_HOP_BY_HOP_SIZE ] );
+
+                pxNetworkBuffer->xDataLength = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER + ipIPv6_HOP_BY_HOP_SIZE + uxMLDLength;
+
+                vSetMultiCastIPv6MacAddress( &( xDestination ), &( pxEthernetHeader->xDestinationAddress ) );
+                ( void ) memcpy( pxEthernetHeader->xSourceAddress.ucBytes, pxEndPoint->xMACAddress.ucBytes, ipMAC_ADDRESS_LENGTH_BYTES );
+                pxEthernetHeader->usFrameType = ipIPv6_FRAME_TYPE;
+
+                pxIPHeader->ucVersionTrafficClass = 0x60U;
+                pxIPHeader->ucTrafficClassFlow = 0U;
+                pxIPHeader->usFlowLabel = 0U;
+                pxIPHeader->usPayloadLength = FreeRTOS_htons( ( uint16_t ) ( ipIPv6_HOP_BY_HOP_SIZE + uxMLDLength ) );
+                pxIPHeader->ucNextHeader = ipIPv6_EXT_HEADER_HOP_BY_HOP;
+                pxIPHeader->ucHopLimit = 1U;
+                ( void ) memcpy( pxIPHeader->xSourceAddress.ucBytes, pxEndPoint->ipv6_settings.xIPAddress.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+                ( void ) memcpy( pxIPHeader->xDestinationAddress.ucBytes, xDestination.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+
+                /* A Hop-by-Hop header with a Router Alert option for MLD. */
+                pucHopByHop[ 0 ] = ipPROTOCOL_ICMP_IPv6;
+                pucHopByHop[ 1 ] = 0x00U; /* The length in units of 8 bytes, minus one. */
+                pucHopByHop[ 2 ] = 0x05U; /* Router Alert. */
+                pucHopByHop[ 3 ] = 0x02U; /* Option length. */
+                pucHopByHop[ 4 ] = 0x00U; /* The value zero means MLD. */
+                pucHopByHop[ 5 ] = 0x00U;
+                pucHopByHop[ 6 ] = 0x01U; /* PadN. */
+                pucHopByHop[ 7 ] = 0x00U;
+
+                ( void ) memset( pucMLD, 0, uxMLDLength );
+                pucMLD[ 0 ] = ucType;
+
+                if( ucType == ipICMP_MULTICAST_LISTENER_REPORT_V2_IPv6 )
+                {
+                    if( eMessage == eMulticastJoin )
+                    {
+                        ucRecordType = ipMULTICAST_CHANGE_TO_EXCLUDE;
+                    }
+                    else if( eMessage == eMulticastLeave )
+                    {
+                        ucRecordType = ipMULTICAST_CHANGE_TO_INCLUDE;
+                    }
+                    else
+                    {
+                        ucRecordType = ipMULTICAST_MODE_IS_EXCLUDE;
+                    }
+
+                    /* One group record without sources. */
+                    pucMLD[ 7 ] = 1U;
+                    pucMLD[ ipMLD_V2_REPORT_HEADER_SIZE ] = ucRecordType;
+                    ( void ) memcpy( &( pucMLD[ ipMLD_V2_REPORT_HEADER_SIZE + 4U ] ), pxEntry->xGroup.xIP_IPv6.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+                }
+                else
+                {
+                    ( void ) memcpy( &( pucMLD[ 8 ] ), pxEntry->xGroup.xIP_IPv6.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+                }
+
+                #if ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+                {
+                    /* The checksum skips the Hop-by-Hop header. */
+                    ( void ) usGenerateProtocolChecksum( pucBuffer, pxNetworkBuffer->xDataLength, pdTRUE );
+                }
+                #endif
+
+                prvSendFrame( pxNetworkBuffer, pxEndPoint );
+            }
+        }
+    #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Register that a socket joins or leaves a multicast group. The table
+ *        is updated immediately, the IP-task will update the MAC filter and
+ *        send the reports.
+ *
+ * @param[in] pxSocket The UDP socket.
+ * @param[in] pxGroup The multicast group.
+ * @param[in] xIsIPv6 pdTRUE when the group is an IPv6 address.
+ * @param[in] pxInterface The interface on which the group is joined.
+ * @param[in] xJoin pdTRUE to join the group, pdFALSE to leave it.
+ *
+ * @return 0 on success, -pdFREERTOS_ERRNO_EADDRINUSE when the socket is
+ *         already a member, -pdFREERTOS_ERRNO_EADDRNOTAVAIL when it is not,
+ *         -pdFREERTOS_ERRNO_ENOMEM when the table is full, or
+ *         -pdFREERTOS_ERRNO_ENOBUFS when the IP-task could not be reached.
+ */
+    BaseType_t xMulticastMembershipRequest( const struct xSOCKET * pxSocket,
+                                            const IP_Address_t * pxGroup,
+                                            BaseType_t xIsIPv6,
+                                            struct xNetworkInterface * pxInterface,
+                                            BaseType_t xJoin )
+    {
+        BaseType_t xReturn = 0;
+        MulticastMembership_t xRequest;
+        MulticastMembership_t * pxFound = NULL;
+        MulticastMembership_t * pxFree = NULL;
+        size_t uxIndex;
+
+        ( void ) memset( &( xRequest ), 0, sizeof( xRequest ) );
+        ( void ) memcpy( &( xRequest.xGroup ), pxGroup, sizeof( xRequest.xGroup ) );
+        xRequest.pxInterface = pxInterface;
+        xRequest.pxSocket = pxSocket;
+        xRequest.bits.bInUse = pdTRUE_UNSIGNED;
+        xRequest.bits.bIsIPv6 = ( xIsIPv6 != pdFALSE ) ? pdTRUE_UNSIGNED : pdFALSE_UNSIGNED;
+
+        vTaskSuspendAll();
+        {
+            for( uxIndex = 0U; uxIndex < ( size_t ) ipconfigMULTICAST_MAX_MEMBERSHIPS; uxIndex++ )
+            {
+                MulticastMembership_t * pxEntry = &( xMemberships[ uxIndex ] );
+
+                if( pxEntry->bits.bInUse == pdFALSE_UNSIGNED )
+                {
+                    if( pxFree == NULL )
+                    {
+                        pxFree = pxEntry;
+                    }
+                }
+                else if( ( pxEntry->pxSocket == pxSocket ) &&
+                         ( pxEntry->bits.bLeavePending == pdFALSE_UNSIGNED ) &&
+                         ( prvSameGroup( pxEntry, &( xRequest ) ) != pdFALSE ) )
+                {
+                    pxFound = pxEntry;
+                }
+                else
+                {
+                    /* Another membership. */
+                }
+            }
+
+            if( xJoin != pdFALSE )
+            {
+                if( pxFound != NULL )
+                {
+                    xReturn = -pdFREERTOS_ERRNO_EADDRINUSE;
+                }
+                else if( pxFree == NULL )
+                {
+                    xReturn = -pdFREERTOS_ERRNO_ENOMEM;
+                }
+                else
+                {
+                    xRequest.bits.bJoinPending = pdTRUE_UNSIGNED;
+                    ( void ) memcpy( pxFree, &( xRequest ), sizeof( *pxFree ) );
+                    pxFound = pxFree;
+                }
+            }
+            else
+            {
+                if( pxFound == NULL )
+                {
+                    xReturn = -pdFREERTOS_ERRNO_EADDRNOTAVAIL;
+                }
+                else
+                {
+                    pxFound->bits.bLeavePending = pdTRUE_UNSIGNED;
+                }
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        if( xReturn == 0 )
+        {
+            if( xSendEventToIPTask( eMulticastGroupEvent ) != pdPASS )
+            {
+                /* Undo the request, unless another event has handled it already. */
+                vTaskSuspendAll();
+                {
+                    if( ( xJoin != pdFALSE ) && ( pxFound->bits.bJoinPending != pdFALSE_UNSIGNED ) )
+                    {
+                        pxFound->bits.bInUse = pdFALSE_UNSIGNED;
+                        xReturn = -pdFREERTOS_ERRNO_ENOBUFS;
+                    }
+                    else if( ( xJoin == pdFALSE ) && ( pxFound->bits.bInUse != pdFALSE_UNSIGNED ) )
+                    {
+                        pxFound->bits.bLeavePending = pdFALSE_UNSIGNED;
+                        xReturn = -pdFREERTOS_ERRNO_ENOBUFS;
+                    }
+                    else
+                    {
+                        /* The IP-task has seen the request. */
+                    }
+                }
+                ( void ) xTaskResumeAll();
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief A socket is being closed: leave all the groups that it has joined.
+ *
+ * @param[in] pxSocket The socket.
+ */
+    void vMulticastSocketClose( const struct xSOCKET * pxSocket )
+    {
+        BaseType_t xFound = pdFALSE;
+        size_t uxIndex;
+
+        vTaskSuspendAll();
+        {
+            for( uxIndex = 0U; uxIndex < ( size_t ) ipconfigMULTICAST_MAX_MEMBERSHIPS; uxIndex++ )
+            {
+                if( ( xMemberships[ uxIndex ].bits.bInUse != pdFALSE_UNSIGNED ) &&
+                    ( xMemberships[ uxIndex ].pxSocket == pxSocket ) )
+                {
+                    xMemberships[ uxIndex ].bits.bLeavePending = pdTRUE_UNSIGNED;
+                    xFound = pdTRUE;
+                }
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        if( xFound != pdFALSE )
+        {
+            vMulticastProcessRequests();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Handle the joins and leaves that were registered by the API. The
+ *        first member of a group sends the unsolicited reports, the last one
+ *        to leave sends the leave report.
+ */
+    void vMulticastProcessRequests( void )
+    {
+        MulticastMembership_t xEntry;
+        size_t uxIndex;
+
+        for( uxIndex = 0U; uxIndex < ( size_t ) ipconfigMULTICAST_MAX_MEMBERSHIPS; uxIndex++ )
+        {
+            MulticastMembership_t * pxEntry = &( xMemberships[ uxIndex ] );
+            BaseType_t xAddFilter = pdFALSE;
+            BaseType_t xRemoveFilter = pdFALSE;
+            BaseType_t xSendJoin = pdFALSE;
+            BaseType_t xSendLeave = pdFALSE;
+            size_t uxOther;
+
+            vTaskSuspendAll();
+            {
+                if( pxEntry->bits.bInUse == pdFALSE_UNSIGNED )
+                {
+                    /* Nothing to do. */
+                }
+                else if( pxEntry->bits.bLeavePending != pdFALSE_UNSIGNED )
+                {
+                    if( pxEntry->bits.bJoinPending == pdFALSE_UNSIGNED )
+                    {
+                        /* The join has been handled, so undo it. */
+                        xRemoveFilter = pdTRUE;
+                        xSendLeave = ( prvGroupHasOtherMember( uxIndex ) == pdFALSE ) ? pdTRUE : pdFALSE;
+                        ( void ) memcpy( &( xEntry ), pxEntry, sizeof( xEntry ) );
+                    }
+
+                    pxEntry->bits.bInUse = pdFALSE_UNSIGNED;
+                }
+                else if( pxEntry->bits.bJoinPending != pdFALSE_UNSIGNED )
+                {
+                    pxEntry->bits.bJoinPending = pdFALSE_UNSIGNED;
+                    xAddFilter = pdTRUE;
+
+                    /* Use the protocol version that is used for the other groups on the link. */
+                    for( uxOther = 0U; uxOther < ( size_t ) ipconfigMULTICAST_MAX_MEMBERSHIPS; uxOther++ )
+                    {
+                        if( ( uxOther != uxIndex ) &&
+                            ( xMemberships[ uxOther ].bits.bInUse != pdFALSE_UNSIGNED ) &&
+                            ( xMemberships[ uxOther ].bits.bIsIPv6 == pxEntry->bits.bIsIPv6 ) &&
+                            ( xMemberships[ uxOther ].pxInterface == pxEntry->pxInterface ) )
+                        {
+                            if( xMemberships[ uxOther ].usOlderQuerierTicks > pxEntry->usOlderQuerierTicks )
+                            {
+                                pxEntry->usOlderQuerierTicks = xMemberships[ uxOther ].usOlderQuerierTicks;
+                            }
+
+                            if( xMemberships[ uxOther ].usV1QuerierTicks > pxEntry->usV1QuerierTicks )
+                            {
+                                pxEntry->usV1QuerierTicks = xMemberships[ uxOther ].usV1QuerierTicks;
+                            }
+                        }
+                    }
+
+                    if( prvGroupHasOtherMember( uxIndex ) == pdFALSE )
+                    {
+                        /* The first report is sent now, the others will follow. */
+                        xSendJoin = pdTRUE;
+                        pxEntry->ucUnsolicitedReports = ( uint8_t ) ( ipMULTICAST_UNSOLICITED_REPORTS - 1U );
+                        pxEntry->usReportTicks = ( pxEntry->ucUnsolicitedReports != 0U ) ? ( uint16_t ) ipMULTICAST_UNSOLICITED_INTERVAL : 0U;
+                    }
+
+                    ( void ) memcpy( &( xEntry ), pxEntry, sizeof( xEntry ) );
+                }
+                else
+                {
+                    /* An active membership. */
+                }
+            }
+            ( void ) xTaskResumeAll();
+
+            if( xAddFilter != pdFALSE )
+            {
+                prvUpdateMACFilter( &( xEntry ), pdTRUE );
+            }
+
+            if( xSendJoin != pdFALSE )
+            {
+                prvSendReport( &( xEntry ), eMulticastJoin );
+            }
+
+            if( xRemoveFilter != pdFALSE )
+            {
+                prvUpdateMACFilter( &( xEntry ), pdFALSE );
+            }
+
+            if( xSendLeave != pdFALSE )
+            {
+                prvSendReport( &( xEntry ), eMulticastLeave );
+            }
+        }
+
+        prvMulticastTimerUpdate();
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The multicast timer has expired: send the reports that are due.
+ */
+    void vMulticastTimerExpired( void )
+    {
+        MulticastMembership_t xEntry;
+        size_t uxIndex;
+
+        for( uxIndex = 0U; uxIndex < ( size_t ) ipconfigMULTICAST_MAX_MEMBERSHIPS; uxIndex++ )
+        {
+            MulticastMembership_t * pxEntry = &( xMemberships[ uxIndex ] );
+            BaseType_t xSend = pdFALSE;
+            eMulticastMessage_t eMessage = eMulticastCurrentState;
+
+            vTaskSuspendAll();
+            {
+                if( ( pxEntry->bits.bInUse != pdFALSE_UNSIGNED ) &&
+                    ( pxEntry->bits.bJoinPending == pdFALSE_UNSIGNED ) &&
+                    ( pxEntry->bits.bLeavePending == pdFALSE_UNSIGNED ) )
+                {
+                    if( pxEntry->usOlderQuerierTicks != 0U )
+                    {
+                        pxEntry->usOlderQuerierTicks--;
+                    }
+
+                    if( pxEntry->usV1QuerierTicks != 0U )
+                    {
+                        pxEntry->usV1QuerierTicks--;
+                    }
+
+                    if( pxEntry->usReportTicks != 0U )
+                    {
+                        pxEntry->usReportTicks--;
+
+                        if( pxEntry->usReportTicks == 0U )
+                        {
+                            if( pxEntry->ucUnsolicitedReports != 0U )
+                            {
+                                pxEntry->ucUnsolicitedReports--;
+                                eMessage = eMulticastJoin;
+                                xSend = pdTRUE;
+
+                                if( pxEntry->ucUnsolicitedReports != 0U )
+                                {
+                                    pxEntry->usReportTicks = ( uint16_t ) ipMULTICAST_UNSOLICITED_INTERVAL;
+                                }
+                            }
+                            else
+                            {
+                                /* A query is answered by the first member of the group only. */
+                                xSend = prvIsFirstMember( uxIndex );
+                            }
+                        }
+                    }
+
+                    ( void ) memcpy( &( xEntry ), pxEntry, sizeof( xEntry ) );
+                }
+            }
+            ( void ) xTaskResumeAll();
+
+            if( xSend != pdFALSE )
+            {
+                prvSendReport( &( xEntry ), eMessage );
+            }
+        }
+
+        prvMulticastTimerUpdate();
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief An end-point went up: send unsolicited reports for the groups that
+ *        were joined on its interface, because the router may not know them.
+ *
+ * @param[in] pxEndPoint The end-point.
+ */
+    void vMulticastNetworkUp( const struct xNetworkEndPoint * pxEndPoint )
+    {
+        size_t uxIndex;
+        uint32_t ulIsIPv6 = ( ENDPOINT_IS_IPv6( pxEndPoint ) ) ? pdTRUE_UNSIGNED : pdFALSE_UNSIGNED;
+
+        vTaskSuspendAll();
+        {
+            for( uxIndex = 0U; uxIndex < ( size_t ) ipconfigMULTICAST_MAX_MEMBERSHIPS; uxIndex++ )
+            {
+                MulticastMembership_t * pxEntry = &( xMemberships[ uxIndex ] );
+
+                if( ( pxEntry->bits.bInUse != pdFALSE_UNSIGNED ) &&
+                    ( pxEntry->bits.bJoinPending == pdFALSE_UNSIGNED ) &&
+                    ( pxEntry->bits.bLeavePending == pdFALSE_UNSIGNED ) &&
+                    ( pxEntry->bits.bIsIPv6 == ulIsIPv6 ) &&
+                    ( pxEntry->pxInterface == pxEndPoint->pxNetworkInterface ) &&
+                    ( prvIsFirstMember( uxIndex ) != pdFALSE ) )
+                {
+                    pxEntry->ucUnsolicitedReports = ( uint8_t ) ipMULTICAST_UNSOLICITED_REPORTS;
+                    pxEntry->usReportTicks = 1U;
+                }
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        prvMulticastTimerUpdate();
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief A query was received. Every group that it asks for gets a report
+ *        after a random delay within the maximum response time, unless a
+ *        report was already scheduled earlier.
+ *
+ * @param[in] pxInterface The interface on which the query was received.
+ * @param[in] xIsIPv6 pdTRUE for an MLD query.
+ * @param[in] pxGroup The group that is queried, or NULL for a general query.
+ * @param[in] ulMaxResponseTicks The maximum response time in timer periods.
+ * @param[in] xOlderQuerier pdTRUE when the query came from an IGMPv1/v2 or MLDv1 querier.
+ * @param[in] xV1Querier pdTRUE when the query came from an IGMPv1 querier.
+ */
+    static void prvMulticastQuery( const NetworkInterface_t * pxInterface,
+                                   BaseType_t xIsIPv6,
+                                   const IP_Address_t * pxGroup,
+                                   uint32_t ulMaxResponseTicks,
+                                   BaseType_t xOlderQuerier,
+                                   BaseType_t xV1Querier )
+    {
+        MulticastMembership_t xQueried;
+        uint32_t ulRandom = 0U;
+        uint32_t ulMaximum = ( ulMaxResponseTicks > 1U ) ? ulMaxResponseTicks : 1U;
+        uint16_t usTicks;
+        size_t uxIndex;
+
+        if( ulMaximum > ( uint32_t ) ipMULTICAST_OLDER_QUERIER_TIMEOUT )
+        {
+            ulMaximum = ( uint32_t ) ipMULTICAST_OLDER_QUERIER_TIMEOUT;
+        }
+
+        if( xApplicationGetRandomNumber( &( ulRandom ) ) == pdFALSE )
+        {
+            ulRandom = 0U;
+        }
+
+        usTicks = ( uint16_t ) ( 1U + ( ulRandom % ulMaximum ) );
+
+        ( void ) memset( &( xQueried ), 0, sizeof( xQueried ) );
+
+        if( pxGroup != NULL )
+        {
+            ( void ) memcpy( &( xQueried.xGroup ), pxGroup, sizeof( xQueried.xGroup ) );
+        }
+
+        xQueried.pxInterface = ( struct xNetworkInterface * ) pxInterface;
+        xQueried.bits.bIsIPv6 = ( xIsIPv6 != pdFALSE ) ? pdTRUE_UNSIGNED : pdFALSE_UNSIGNED;
+
+        vTaskSuspendAll();
+        {
+            for( uxIndex = 0U; uxIndex < ( size_t ) ipconfigMULTICAST_MAX_MEMBERSHIPS; uxIndex++ )
+            {
+                MulticastMembership_t * pxEntry = &( xMemberships[ uxIndex ] );
+
+                if( ( pxEntry->bits.bInUse != pdFALSE_UNSIGNED ) &&
+                    ( pxEntry->bits.bIsIPv6 == xQueried.bits.bIsIPv6 ) &&
+                    ( pxEntry->pxInterface == pxInterface ) )
+                {
+                    if( xOlderQuerier != pdFALSE )
+                    {
+                        pxEntry->usOlderQuerierTicks = ( uint16_t ) ipMULTICAST_OLDER_QUERIER_TIMEOUT;
+                    }
+
+                    if( xV1Querier != pdFALSE )
+                    {
+                        pxEntry->usV1QuerierTicks = ( uint16_t ) ipMULTICAST_OLDER_QUERIER_TIMEOUT;
+                    }
+
+                    if( ( pxGroup == NULL ) || ( prvSameGroup( pxEntry, &( xQueried ) ) != pdFALSE ) )
+                    {
+                        if( ( pxEntry->usReportTicks == 0U ) || ( pxEntry->usReportTicks > usTicks ) )
+                        {
+                            pxEntry->usReportTicks = usTicks;
+                        }
+                    }
+                }
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        prvMulticastTimerUpdate();
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Another host has reported a group. An IGMPv2 or MLDv1 host does not
+ *        report a group when another host has done so already.
+ *
+ * @param[in] pxInterface The interface on which the report was received.
+ * @param[in] xIsIPv6 pdTRUE for an MLD report.
+ * @param[in] pxGroup The group that was reported.
+ */
+    static void prvMulticastReportHeard( const NetworkInterface_t * pxInterface,
+                                         BaseType_t xIsIPv6,
+                                         const IP_Address_t * pxGroup )
+    {
+        MulticastMembership_t xReported;
+        size_t uxIndex;
+
+        ( void ) memset( &( xReported ), 0, sizeof( xReported ) );
+        ( void ) memcpy( &( xReported.xGroup ), pxGroup, sizeof( xReported.xGroup ) );
+        xReported.pxInterface = ( struct xNetworkInterface * ) pxInterface;
+        xReported.bits.bIsIPv6 = ( xIsIPv6 != pdFALSE ) ? pdTRUE_UNSIGNED : pdFALSE_UNSIGNED;
+
+        vTaskSuspendAll();
+        {
+            for( uxIndex = 0U; uxIndex < ( size_t ) ipconfigMULTICAST_MAX_MEMBERSHIPS; uxIndex++ )
+            {
+                MulticastMembership_t * pxEntry = &( xMemberships[ uxIndex ] );
+
+                if( ( pxEntry->bits.bInUse != pdFALSE_UNSIGNED ) &&
+                    ( pxEntry->usOlderQuerierTicks != 0U ) &&
+                    ( pxEntry->ucUnsolicitedReports == 0U ) &&
+                    ( prvSameGroup( pxEntry, &( xReported ) ) != pdFALSE ) )
+                {
+                    pxEntry->usReportTicks = 0U;
+                }
+            }
+        }
+        ( void ) xTaskResumeAll();
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_IPv4 != 0 )
+
+/**
+ * @brief Process an incoming IGMP message: queries are answered, and reports
+ *        of other hosts may suppress our own report. The IP-options have been
+ *        removed already.
+ *
+ * @param[in] pxNetworkBuffer The received packet.
+ *
+ * @return eReleaseBuffer, the packet is not used any more.
+ */
+        eFrameProcessingResult_t eProcessIGMPPacket( const NetworkBufferDescriptor_t * const pxNetworkBuffer )
+        {
+            /* MISRA Ref 11.3.1 [Misaligned access] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+            /* coverity[misra_c_2012_rule_11_3_violation] */
+            const IPHeader_t * pxIPHeader = ( ( const IPHeader_t * ) &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER ] ) );
+            const uint8_t * pucIGMP = &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER ] );
+            const NetworkInterface_t * pxInterface = pxNetworkBuffer->pxInterface;
+            size_t uxLength = ( size_t ) FreeRTOS_ntohs( pxIPHeader->usLength );
+            IP_Address_t xGroup;
+            uint32_t ulMaxResponse;
+            uint8_t ucCode;
+
+            if( ( pxInterface == NULL ) && ( pxNetworkBuffer->pxEndPoint != NULL ) )
+            {
+                pxInterface = pxNetworkBuffer->pxEndPoint->pxNetworkInterface;
+            }
+
+            if( ( pxInterface != NULL ) &&
+                ( uxLength >= ( ipSIZE_OF_IPv4_HEADER + ipIGMP_MESSAGE_SIZE ) ) &&
+                ( pxNetworkBuffer->xDataLength >= ( ipSIZE_OF_ETH_HEADER + uxLength ) ) )
+            {
+                uxLength -= ipSIZE_OF_IPv4_HEADER;
+                ucCode = pucIGMP[ 1 ];
+                ( void ) memset( &( xGroup ), 0, sizeof( xGroup ) );
+                ( void ) memcpy( &( xGroup.ulIP_IPv4 ), &( pucIGMP[ 4 ] ), sizeof( uint32_t ) );
+
+                switch( pucIGMP[ 0 ] )
+                {
+                    case ipIGMP_MEMBERSHIP_QUERY:
+
+                        if( uxLength >= ipIGMP_V3_QUERY_MIN_SIZE )
+                        {
+                            /* IGMPv3: codes from 128 have a floating point format. */
+                            if( ucCode < 128U )
+                            {
+                                ulMaxResponse = ( uint32_t ) ucCode;
+                            }
+                            else
+                            {
+                                ulMaxResponse = ( ( uint32_t ) ucCode & 0x0FU ) | 0x10U;
+                                ulMaxResponse <<= ( ( ( uint32_t ) ucCode >> 4 ) & 0x07U ) + 3U;
+                            }
+
+                            prvMulticastQuery( pxInterface, pdFALSE, ( xGroup.ulIP_IPv4 == 0U ) ? NULL : &( xGroup ), ulMaxResponse, pdFALSE, pdFALSE );
+                        }
+                        else if( ucCode == 0U )
+                        {
+                            /* An IGMPv1 query has no maximum response time. */
+                            prvMulticastQuery( pxInterface, pdFALSE, ( xGroup.ulIP_IPv4 == 0U ) ? NULL : &( xGroup ), ( uint32_t ) ipIGMP_V1_MAX_RESPONSE_TIME, pdTRUE, pdTRUE );
+                        }
+                        else
+                        {
+                            /* IGMPv2 uses tenths of seconds. */
+                            prvMulticastQuery( pxInterface, pdFALSE, ( xGroup.ulIP_IPv4 == 0U ) ? NULL : &( xGroup ), ( uint32_t ) ucCode, pdTRUE, pdFALSE );
+                        }
+
+                        break;
+
+                    case ipIGMP_V1_MEMBERSHIP_REPORT:
+                    case ipIGMP_V2_MEMBERSHIP_REPORT:
+                        prvMulticastReportHeard( pxInterface, pdFALSE, &( xGroup ) );
+                        break;
+
+                    default:
+                        /* IGMPv3 reports and leave messages are meant for routers. */
+                        break;
+                }
+            }
+
+            return eReleaseBuffer;
+        }
+    #endif /* ( ipconfigUSE_IPv4 != 0 ) */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_IPv6 != 0 )
+
+/**
+ * @brief Process an incoming MLD query or report. The Hop-by-Hop header
+ *        has been removed already.
+ *
+ * @param[in] pxNetworkBuffer The received packet.
+ */
+        void vProcessMLDPacket( const NetworkBufferDescriptor_t * const pxNetworkBuffer )
+        {
+            /* MISRA Ref 11.3.1 [Misaligned access] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+            /* coverity[misra_c_2012_rule_11_3_violation] */
+            const IPHeader_IPv6_t * pxIPHeader = ( ( const IPHeader_IPv6_t * ) &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER ] ) );
+            const uint8_t * pucMLD = &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER ] );
+            const NetworkInterface_t * pxInterface = pxNetworkBuffer->pxInterface;
+            size_t uxLength = ( size_t ) FreeRTOS_ntohs( pxIPHeader->usPayloadLength );
+            IP_Address_t xGroup;
+            uint32_t ulCode;
+            uint32_t ulMaxResponse;
+
+            if( ( pxInterface == NULL ) && ( pxNetworkBuffer->pxEndPoint != NULL ) )
+            {
+                pxInterface = pxNetworkBuffer->pxEndPoint->pxNetworkInterface;
+            }
+
+            /* MLD messages are only valid with a hop limit of 1. */
+            if( ( pxInterface != NULL ) &&
+                ( pxIPHeader->ucHopLimit == 1U ) &&
+                ( uxLength >= ipMLD_V1_MESSAGE_SIZE ) &&
+                ( pxNetworkBuffer->xDataLength >= ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER + uxLength ) ) )
+            {
+                BaseType_t xIsGeneral;
+
+                ( void ) memset( &( xGroup ), 0, sizeof( xGroup ) );
+                ( void ) memcpy( xGroup.xIP_IPv6.ucBytes, &( pucMLD[ 8 ] ), ipSIZE_OF_IPv6_ADDRESS );
+                xIsGeneral = ( memcmp( xGroup.xIP_IPv6.ucBytes, FreeRTOS_in6addr_any.ucBytes, ipSIZE_OF_IPv6_ADDRESS ) == 0 ) ? pdTRUE : pdFALSE;
+                ulCode = ( ( ( uint32_t ) pucMLD[ 4 ] ) << 8 ) | ( ( uint32_t ) pucMLD[ 5 ] );
+
+                switch( pucMLD[ 0 ] )
+                {
+                    case ipICMP_MULTICAST_LISTENER_QUERY_IPv6:
+
+                        if( uxLength >= ipMLD_V2_QUERY_MIN_SIZE )
+                        {
+                            /* MLDv2: codes from 32768 have a floating point format. */
+                            if( ulCode < 32768U )
+                            {
+                                ulMaxResponse = ulCode;
+                            }
+                            else
+                            {
+                                ulMaxResponse = ( ulCode & 0x0FFFU ) | 0x1000U;
+                                ulMaxResponse <<= ( ( ulCode >> 12 ) & 0x07U ) + 3U;
+                            }
+
+                            prvMulticastQuery( pxInterface, pdTRUE, ( xIsGeneral != pdFALSE ) ? NULL : &( xGroup ), ulMaxResponse / ipMULTICAST_TIMER_PERIOD_MS, pdFALSE, pdFALSE );
+                        }
+                        else
+                        {
+                            prvMulticastQuery( pxInterface, pdTRUE, ( xIsGeneral != pdFALSE ) ? NULL : &( xGroup ), ulCode / ipMULTICAST_TIMER_PERIOD_MS, pdTRUE, pdFALSE );
+                        }
+
+                        break;
+
+                    case ipICMP_MULTICAST_LISTENER_REPORT_IPv6:
+                        prvMulticastReportHeard( pxInterface, pdTRUE, &( xGroup ) );
+                        break;
+
+                    default:
+                        /* MLDv2 reports and done messages are meant for routers. */
+                        break;
+                }
+            }
+        }
+    #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+/*-----------------------------------------------------------*/
+
+#endif /* ( ipconfigSUPPORT_IP_MULTICAST == 1 ) */
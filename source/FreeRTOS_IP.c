@@ -59,6 +59,8 @@
 #include "NetworkBufferManagement.h"
 #include "FreeRTOS_DNS.h"
 #include "FreeRTOS_Routing.h"
+#include "FreeRTOS_IGMP.h"
+#include "FreeRTOS_IP_Profiling.h"
 
 /** @brief Time delay between repeated attempts to initialise the network hardware. */
 #ifndef ipINITIALISATION_RETRY_DELAY
@@ -181,6 +183,9 @@ static void prvForwardTxPacket( NetworkBufferDescriptor_t * pxNetworkBuffer,
 
 static eFrameProcessingResult_t prvProcessUDPPacket( NetworkBufferDescriptor_t * const pxNetworkBuffer );
 
+/* Check the frame type and destination address of a received frame. */
+static eFrameProcessingResult_t prvConsiderFrameForProcessing( const uint8_t * const pucEthernetBuffer );
+
 /*-----------------------------------------------------------*/
 
 /** @brief The queue used to pass events into the IP-task for processing. */
@@ -259,12 +264,24 @@ static void prvProcessIPEventsAndTimers( void )
     FreeRTOS_Socket_t * pxSocket;
     struct freertos_sockaddr xAddress;
 
+    #if ( ipconfigUSE_IP_TASK_PROFILING == 1 )
+        uint64_t ullStartTime;
+    #endif
+
     ipconfigWATCHDOG_TIMER();
 
+    #if ( ipconfigUSE_IP_TASK_PROFILING == 1 )
+        ullStartTime = ipconfigIP_TASK_PROFILING_TIME();
+    #endif
+
     /* Check the Resolution, DHCP and TCP timers to see if there is any periodic
      * or timeout processing to perform. */
     vCheckNetworkTimers();
 
+    #if ( ipconfigUSE_IP_TASK_PROFILING == 1 )
+        vIPTaskProfileTimerCheck( ullStartTime );
+    #endif
+
     /* Calculate the acceptable maximum sleep time. */
     xNextIPSleep = xCalculateSleepTime();
 
@@ -294,6 +311,17 @@ static void prvProcessIPEventsAndTimers( void )
 
     iptraceNETWORK_EVENT_RECEIVED( xReceivedEvent.eEventType );
 
+    #if ( ipconfigUSE_IP_TASK_PROFILING == 1 )
+    {
+        ullStartTime = ipconfigIP_TASK_PROFILING_TIME();
+
+        if( xReceivedEvent.eEventType != eNoEvent )
+        {
+            vIPTaskProfileQueueWait( &( xReceivedEvent ), ullStartTime );
+        }
+    }
+    #endif /* ipconfigUSE_IP_TASK_PROFILING */
+
     switch( xReceivedEvent.eEventType )
     {
         case eNetworkDownEvent:
@@ -394,6 +422,28 @@ static void prvProcessIPEventsAndTimers( void )
             vProcessGeneratedUDPPacket( ( NetworkBufferDescriptor_t * ) xReceivedEvent.pvData );
             break;
 
+        case eSocketTxBatchEvent:
+
+            /* FreeRTOS_sendto_batch() has queued one or more packets to
+             * the socket that is located in the pvData member. */
+            #if ( ipconfigUDP_BATCH_CALLS == 1 )
+            {
+                vSocketSendBatch( ( FreeRTOS_Socket_t * ) xReceivedEvent.pvData );
+            }
+            #endif /* ipconfigUDP_BATCH_CALLS == 1 */
+            break;
+
+        case eMulticastGroupEvent:
+
+            /* A socket has joined or left a multicast group, update the
+             * MAC filters and send the reports. */
+            #if ( ipconfigSUPPORT_IP_MULTICAST == 1 )
+            {
+                vMulticastProcessRequests();
+            }
+            #endif /* ipconfigSUPPORT_IP_MULTICAST == 1 */
+            break;
+
         case eDHCPEvent:
             prvCallDHCP_RA_Handler( ( ( NetworkEndPoint_t * ) xReceivedEvent.pvData ) );
             break;
@@ -466,6 +516,20 @@ static void prvProcessIPEventsAndTimers( void )
             {
                 SocketSelect_t * pxSocketSet = ( SocketSelect_t * ) ( xReceivedEvent.pvData );
 
+                #if ( ipconfigSELECT_READY_LIST == 1 )
+                {
+                    /* Detach the sockets that are still waiting to be reported. */
+                    vTaskSuspendAll();
+                    {
+                        while( listLIST_IS_EMPTY( &( pxSocketSet->xReadyList ) ) == pdFALSE )
+                        {
+                            ( void ) uxListRemove( listGET_HEAD_ENTRY( &( pxSocketSet->xReadyList ) ) );
+                        }
+                    }
+                    ( void ) xTaskResumeAll();
+                }
+                #endif /* ipconfigSELECT_READY_LIST == 1 */
+
                 iptraceMEM_STATS_DELETE( pxSocketSet );
                 vEventGroupDelete( pxSocketSet->xSelectGroup );
                 vPortFree( ( void * ) pxSocketSet );
@@ -473,6 +537,32 @@ static void prvProcessIPEventsAndTimers( void )
             #endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
             break;
 
+        case eSocketRxGrowEvent:
+            #if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_RX_AUTOTUNE == 1 ) )
+            {
+                /* The reception window of a TCP socket has grown beyond the
+                 * size of its rxStream.  The user's task is waiting in
+                 * prvTCPRxStreamCheckGrow() until it is replaced. */
+                FreeRTOS_Socket_t * pxSocket = ( ( FreeRTOS_Socket_t * ) xReceivedEvent.pvData );
+
+                vTCPRxStreamGrow( pxSocket );
+                pxSocket->xEventBits |= ( EventBits_t ) eSOCKET_BOUND;
+                vSocketWakeUpUser( pxSocket );
+            }
+            #endif /* ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_RX_AUTOTUNE == 1 ) ) */
+            break;
+
+        case eSocketUDPHeaderEvent:
+
+            /* A connected UDP socket found that its cached headers are
+             * missing or older than the ARP cache. */
+            #if ( ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) && ( ipconfigUSE_IPv4 != 0 ) )
+            {
+                vSocketUDPHeaderRefresh( ( FreeRTOS_Socket_t * ) xReceivedEvent.pvData );
+            }
+            #endif /* ( ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) && ( ipconfigUSE_IPv4 != 0 ) ) */
+            break;
+
         case eNoEvent:
             /* xQueueReceive() returned because of a normal time-out. */
             break;
@@ -482,6 +572,12 @@ static void prvProcessIPEventsAndTimers( void )
             break;
     }
 
+    iptraceNETWORK_EVENT_PROCESSED( xReceivedEvent.eEventType );
+
+    #if ( ipconfigUSE_IP_TASK_PROFILING == 1 )
+        vIPTaskProfileProcessing( xReceivedEvent.eEventType, ullStartTime );
+    #endif
+
     prvIPTask_CheckPendingEvents();
 }
 
@@ -658,6 +754,21 @@ void vIPNetworkUpCalls( struct xNetworkEndPoint * pxEndPoint )
 
     pxEndPoint->bits.bEndPointUp = ipTRUE_BOOL;
 
+    #if ( ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) && ( ipconfigUSE_IPv4 != 0 ) )
+    {
+        /* The address of the end-point may have changed, the headers
+         * cached by connected UDP sockets must be built again. */
+        uxARPCacheGeneration++;
+    }
+    #endif
+
+    #if ( ipconfigSUPPORT_IP_MULTICAST == 1 )
+    {
+        /* Tell the routers about the groups that were joined on this interface. */
+        vMulticastNetworkUp( pxEndPoint );
+    }
+    #endif
+
     #if ( ipconfigUSE_NETWORK_EVENT_HOOK == 1 )
     #if ( ipconfigIPv4_BACKWARD_COMPATIBLE == 1 )
         {
@@ -745,6 +856,7 @@ static void prvForwardTxPacket( NetworkBufferDescriptor_t * pxNetworkBuffer,
 
     if( pxNetworkBuffer->pxInterface != NULL )
     {
+        ipMIB_COUNT_OUTPUT( pxNetworkBuffer );
         ( void ) pxNetworkBuffer->pxInterface->pfOutput( pxNetworkBuffer->pxInterface, pxNetworkBuffer, xReleaseAfterSend );
     }
 }
@@ -801,6 +913,11 @@ BaseType_t FreeRTOS_NetworkDownFromISR( struct xNetworkInterface * pxNetworkInte
     xNetworkDownEvent.eEventType = eNetworkDownEvent;
     xNetworkDownEvent.pvData = pxNetworkInterface;
 
+    #if ( ipconfigUSE_IP_TASK_PROFILING == 1 )
+        /* The clock may not be read from an interrupt. */
+        xNetworkDownEvent.ullPostTime = 0U;
+    #endif
+
     /* Simply send the network task the appropriate event. */
     if( xQueueSendToBackFromISR( xNetworkEventQueue, &xNetworkDownEvent, &xHigherPriorityTaskWoken ) != pdPASS )
     {
@@ -1333,7 +1450,15 @@ void FreeRTOS_ReleaseUDPPayloadBuffer( void const * pvBuffer )
         uint8_t * pucChar;
         size_t uxTotalLength;
         BaseType_t xEnoughSpace;
-        IPStackEvent_t xStackTxEvent = { eStackTxEvent, NULL };
+        IPStackEvent_t xStackTxEvent;
+
+        xStackTxEvent.eEventType = eStackTxEvent;
+        xStackTxEvent.pvData = NULL;
+
+        #if ( ipconfigUSE_IP_TASK_PROFILING == 1 )
+            /* Stamped by xSendEventStructToIPTask(). */
+            xStackTxEvent.ullPostTime = 0U;
+        #endif
 
         uxTotalLength = uxNumberOfBytesToSend + sizeof( ICMPPacket_t );
 
@@ -1385,7 +1510,7 @@ void FreeRTOS_ReleaseUDPPayloadBuffer( void const * pvBuffer )
                 if( xSendEventStructToIPTask( &( xStackTxEvent ), uxBlockTimeTicks ) != pdPASS )
                 {
                     vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
-                    iptraceSTACK_TX_EVENT_LOST( ipSTACK_TX_EVENT );
+                    iptraceSTACK_TX_EVENT_LOST( eStackTxEvent );
                 }
                 else
                 {
@@ -1438,6 +1563,10 @@ BaseType_t xSendEventStructToIPTask( const IPStackEvent_t * pxEvent,
     BaseType_t xReturn, xSendMessage;
     TickType_t uxUseTimeout = uxTimeout;
 
+    #if ( ipconfigUSE_IP_TASK_PROFILING == 1 )
+        IPStackEvent_t xStampedEvent;
+    #endif
+
     if( ( xIPIsNetworkTaskReady() == pdFALSE ) && ( pxEvent->eEventType != eNetworkDownEvent ) )
     {
         /* Only allow eNetworkDownEvent events if the IP task is not ready
@@ -1476,13 +1605,31 @@ BaseType_t xSendEventStructToIPTask( const IPStackEvent_t * pxEvent,
                 uxUseTimeout = ( TickType_t ) 0;
             }
 
-            xReturn = xQueueSendToBack( xNetworkEventQueue, pxEvent, uxUseTimeout );
+            #if ( ipconfigUSE_IP_TASK_PROFILING == 1 )
+            {
+                /* Send a copy that records when the event was posted. */
+                ( void ) memcpy( &( xStampedEvent ), pxEvent, sizeof( xStampedEvent ) );
+                xStampedEvent.ullPostTime = ipconfigIP_TASK_PROFILING_TIME();
+                xReturn = xQueueSendToBack( xNetworkEventQueue, &( xStampedEvent ), uxUseTimeout );
+            }
+            #else
+                xReturn = xQueueSendToBack( xNetworkEventQueue, pxEvent, uxUseTimeout );
+            #endif
 
             if( xReturn == pdFAIL )
             {
                 /* A message should have been sent to the IP task, but wasn't. */
                 FreeRTOS_debug_printf( ( "xSendEventStructToIPTask: CAN NOT ADD %d\n", pxEvent->eEventType ) );
                 iptraceSTACK_TX_EVENT_LOST( pxEvent->eEventType );
+
+                #if ( ( ipconfigUSE_DROP_REASONS == 1 ) || ( ipconfigUSE_MIB_COUNTERS == 1 ) )
+                    if( pxEvent->eEventType == eNetworkRxEvent )
+                    {
+                        /* The driver will release the received frame. */
+                        ipDROP_FRAME( ( const NetworkBufferDescriptor_t * ) pxEvent->pvData, eIPDropEventQueueFull );
+                        ipMIB_COUNT_FROM_TASK( eMIBIpInDiscards );
+                    }
+                #endif
             }
         }
         else
@@ -1499,12 +1646,35 @@ BaseType_t xSendEventStructToIPTask( const IPStackEvent_t * pxEvent,
 
 /**
  * @brief Decide whether this packet should be processed or not based on the IP address in the packet.
+ *        This is called by network drivers that filter frames themselves. A frame that is
+ *        rejected is counted as a drop; only its reason is recorded, as the length of the
+ *        frame is not known here.
  *
  * @param[in] pucEthernetBuffer The ethernet packet under consideration.
  *
  * @return Enum saying whether to release or to process the packet.
  */
 eFrameProcessingResult_t eConsiderFrameForProcessing( const uint8_t * const pucEthernetBuffer )
+{
+    eFrameProcessingResult_t eReturn = prvConsiderFrameForProcessing( pucEthernetBuffer );
+
+    if( eReturn != eProcessBuffer )
+    {
+        ipDROP_FRAME( NULL, eIPDropFiltered );
+    }
+
+    return eReturn;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Decide whether this packet should be processed or not based on the IP address in the packet.
+ *
+ * @param[in] pucEthernetBuffer The ethernet packet under consideration.
+ *
+ * @return Enum saying whether to release or to process the packet.
+ */
+static eFrameProcessingResult_t prvConsiderFrameForProcessing( const uint8_t * const pucEthernetBuffer )
 {
     eFrameProcessingResult_t eReturn = eReleaseBuffer;
 
@@ -1691,6 +1861,7 @@ static void prvProcessEthernetPacket( NetworkBufferDescriptor_t * const pxNetwor
 
         if( ( pxNetworkBuffer->pxInterface == NULL ) || ( pxNetworkBuffer->pxEndPoint == NULL ) )
         {
+            ipDROP_FRAME( pxNetworkBuffer, eIPDropNoEndPoint );
             break;
         }
 
@@ -1708,6 +1879,7 @@ static void prvProcessEthernetPacket( NetworkBufferDescriptor_t * const pxNetwor
         /* Interpret the Ethernet frame. */
         if( pxNetworkBuffer->xDataLength < sizeof( EthernetHeader_t ) )
         {
+            ipDROP_FRAME( pxNetworkBuffer, eIPDropTooShort );
             break;
         }
 
@@ -1720,7 +1892,7 @@ static void prvProcessEthernetPacket( NetworkBufferDescriptor_t * const pxNetwor
 
         /* The condition "eReturned == eProcessBuffer" must be true. */
         #if ( ipconfigETHERNET_DRIVER_FILTERS_FRAME_TYPES == 0 )
-            if( eConsiderFrameForProcessing( pxNetworkBuffer->pucEthernetBuffer ) == eProcessBuffer )
+            if( prvConsiderFrameForProcessing( pxNetworkBuffer->pucEthernetBuffer ) == eProcessBuffer )
         #endif
         {
             /* Interpret the received Ethernet packet. */
@@ -1739,6 +1911,7 @@ static void prvProcessEthernetPacket( NetworkBufferDescriptor_t * const pxNetwor
                         }
                         else
                         {
+                            ipDROP_FRAME( pxNetworkBuffer, eIPDropTooShort );
                             eReturned = eReleaseBuffer;
                         }
                         break;
@@ -1757,6 +1930,7 @@ static void prvProcessEthernetPacket( NetworkBufferDescriptor_t * const pxNetwor
                     }
                     else
                     {
+                        ipDROP_FRAME( pxNetworkBuffer, eIPDropTooShort );
                         eReturned = eReleaseBuffer;
                     }
 
@@ -1768,11 +1942,18 @@ static void prvProcessEthernetPacket( NetworkBufferDescriptor_t * const pxNetwor
                         eReturned = eApplicationProcessCustomFrameHook( pxNetworkBuffer );
                     #else
                         /* No other packet types are handled.  Nothing to do. */
+                        ipDROP_FRAME( pxNetworkBuffer, eIPDropUnknownFrameType );
                         eReturned = eReleaseBuffer;
                     #endif
                     break;
             } /* switch( pxEthernetHeader->usFrameType ) */
         }
+        #if ( ipconfigETHERNET_DRIVER_FILTERS_FRAME_TYPES == 0 )
+            else
+            {
+                ipDROP_FRAME( pxNetworkBuffer, eIPDropFiltered );
+            }
+        #endif
     } while( ipFALSE_BOOL );
 
     /* Perform any actions that resulted from processing the Ethernet frame. */
@@ -1811,6 +1992,8 @@ static void prvProcessEthernetPacket( NetworkBufferDescriptor_t * const pxNetwor
                 #endif /* if ipconfigIS_ENABLED( ipconfigUSE_IPv4 ) */
                 {
                     /* We are already waiting on one resolution. This frame will be dropped. */
+                    ipDROP_FRAME( pxNetworkBuffer, eIPDropResolutionPending );
+                    ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInDiscards );
                     vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
 
                     iptraceDELAYED_ARP_BUFFER_FULL();
@@ -1832,6 +2015,8 @@ static void prvProcessEthernetPacket( NetworkBufferDescriptor_t * const pxNetwor
                 #endif /* if ipconfigIS_ENABLED( ipconfigUSE_IPv6 ) */
                 {
                     /* We are already waiting on one resolution. This frame will be dropped. */
+                    ipDROP_FRAME( pxNetworkBuffer, eIPDropResolutionPending );
+                    ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInDiscards );
                     vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
 
                     iptraceDELAYED_ND_BUFFER_FULL();
@@ -1842,6 +2027,7 @@ static void prvProcessEthernetPacket( NetworkBufferDescriptor_t * const pxNetwor
             else
             {
                 /* Unknown frame type, drop the packet. */
+                ipDROP_FRAME( pxNetworkBuffer, eIPDropUnknownFrameType );
                 vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
             }
 
@@ -1988,6 +2174,8 @@ static eFrameProcessingResult_t prvProcessIPPacket( const IPPacket_t * pxIPPacke
         const IPHeader_t * pxIPHeader = &( pxIPPacket->xIPHeader );
     #endif /* ( ipconfigUSE_IPv4 != 0 ) */
 
+    ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInReceives );
+
     switch( pxIPPacket->xEthernetHeader.usFrameType )
     {
         #if ( ipconfigUSE_IPv6 != 0 )
@@ -1996,6 +2184,8 @@ static eFrameProcessingResult_t prvProcessIPPacket( const IPPacket_t * pxIPPacke
                 if( pxNetworkBuffer->xDataLength < sizeof( IPPacket_IPv6_t ) )
                 {
                     /* The packet size is less than minimum IPv6 packet. */
+                    ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInHdrErrors );
+                    ipDROP_FRAME( pxNetworkBuffer, eIPDropTooShort );
                     eReturn = eReleaseBuffer;
                 }
                 else
@@ -2033,6 +2223,8 @@ static eFrameProcessingResult_t prvProcessIPPacket( const IPPacket_t * pxIPPacke
                    if( ( uxHeaderLength > ( pxNetworkBuffer->xDataLength - ipSIZE_OF_ETH_HEADER ) ) ||
                        ( uxHeaderLength < ipSIZE_OF_IPv4_HEADER ) )
                    {
+                       ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInHdrErrors );
+                       ipDROP_FRAME( pxNetworkBuffer, eIPDropBadHeader );
                        eReturn = eReleaseBuffer;
                    }
                    else
@@ -2078,6 +2270,12 @@ static eFrameProcessingResult_t prvProcessIPPacket( const IPPacket_t * pxIPPacke
                         /* The size of the IP-header is larger than 20 bytes.
                          * The extra space is used for IP-options. */
                         eReturn = prvCheckIP4HeaderOptions( pxNetworkBuffer );
+
+                        if( eReturn == eReleaseBuffer )
+                        {
+                            ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInHdrErrors );
+                            ipDROP_FRAME( pxNetworkBuffer, eIPDropBadHeader );
+                        }
                     }
                     break;
             #endif /* ( ipconfigUSE_IPv4 != 0 ) */
@@ -2094,6 +2292,11 @@ static eFrameProcessingResult_t prvProcessIPPacket( const IPPacket_t * pxIPPacke
                             /* Ignore warning for `pxIPHeader_IPv6`. */
                             ucProtocol = pxIPHeader_IPv6->ucNextHeader;
                         }
+                        else
+                        {
+                            ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInHdrErrors );
+                            ipDROP_FRAME( pxNetworkBuffer, eIPDropBadHeader );
+                        }
                     }
                     break;
             #endif /* ( ipconfigUSE_IPv6 != 0 ) */
@@ -2162,28 +2365,41 @@ static eFrameProcessingResult_t prvProcessIPPacket( const IPPacket_t * pxIPPacke
                              * also be returned, and the source of the ping will know something
                              * went wrong because it will not be able to validate what it
                              * receives. */
+                            ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInDelivers );
+
                             #if ( ipconfigREPLY_TO_INCOMING_PINGS == 1 ) || ( ipconfigSUPPORT_OUTGOING_PINGS == 1 )
                             {
                                 eReturn = ProcessICMPPacket( pxNetworkBuffer );
                             }
                             #endif /* ( ipconfigREPLY_TO_INCOMING_PINGS == 1 ) || ( ipconfigSUPPORT_OUTGOING_PINGS == 1 ) */
                             break;
+
+                        #if ( ipconfigSUPPORT_IP_MULTICAST == 1 )
+                            case ipPROTOCOL_IGMP:
+                                /* A multicast query or a report of another host. */
+                                ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInDelivers );
+                                eReturn = eProcessIGMPPacket( pxNetworkBuffer );
+                                break;
+                        #endif /* ( ipconfigSUPPORT_IP_MULTICAST == 1 ) */
                     #endif /* ( ipconfigUSE_IPv4 != 0 ) */
 
                     #if ( ipconfigUSE_IPv6 != 0 )
                         case ipPROTOCOL_ICMP_IPv6:
+                            ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInDelivers );
                             eReturn = prvProcessICMPMessage_IPv6( pxNetworkBuffer );
                             break;
                     #endif /* ( ipconfigUSE_IPv6 != 0 ) */
 
                     case ipPROTOCOL_UDP:
                         /* The IP packet contained a UDP frame. */
+                        ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInDelivers );
 
                         eReturn = prvProcessUDPPacket( pxNetworkBuffer );
                         break;
 
                         #if ipconfigUSE_TCP == 1
                             case ipPROTOCOL_TCP:
+                                ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInDelivers );
 
                                 if( xProcessReceivedTCPPacket( pxNetworkBuffer ) == pdPASS )
                                 {
@@ -2193,6 +2409,8 @@ static eFrameProcessingResult_t prvProcessIPPacket( const IPPacket_t * pxIPPacke
                         #endif /* if ipconfigUSE_TCP == 1 */
                     default:
                         /* Not a supported frame type. */
+                        ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInUnknownProtos );
+                        ipDROP_FRAME( pxNetworkBuffer, eIPDropUnknownProtocol );
                         eReturn = eReleaseBuffer;
                         break;
                 }
@@ -2352,6 +2570,7 @@ void vReturnEthernetFrame( NetworkBufferDescriptor_t * pxNetworkBuffer,
             if( xIsCallingFromIPTask() == pdTRUE )
             {
                 iptraceNETWORK_INTERFACE_OUTPUT( pxNetworkBuffer->xDataLength, pxNetworkBuffer->pucEthernetBuffer );
+                ipMIB_COUNT_OUTPUT( pxNetworkBuffer );
                 ( void ) pxInterface->pfOutput( pxInterface, pxNetworkBuffer, xReleaseAfterSend );
             }
             else if( xReleaseAfterSend != pdFALSE )
@@ -0,0 +1,210 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file FreeRTOS_IP_Profiling.c
+ * @brief Keeps histograms of the time that the IP-task spends on each type of
+ *        event, of the time that events wait in the event queue, and of the
+ *        time spent checking the network timers.
+ *
+ * The histograms are only written by the IP-task, but they are read by other
+ * tasks. The IP-task updates a histogram within a short critical section,
+ * which is cheaper than suspending the scheduler for every sample. Other tasks
+ * suspend the scheduler while they copy or clear the histograms, so that the
+ * IP-task can not update them halfway.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_IP_Profiling.h"
+
+#if ( ipconfigUSE_IP_TASK_PROFILING == 1 )
+
+/** @brief The histograms of the IP-task. */
+    static IPTaskProfile_t xIPTaskProfile;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Add a duration to a histogram.
+ *
+ * @param[in] pxHistogram The histogram to update.
+ * @param[in] ullDuration The duration to add.
+ */
+    static void prvHistogramAdd( IPTaskHistogram_t * pxHistogram,
+                                 uint64_t ullDuration )
+    {
+        size_t uxBucket = 0U;
+        uint64_t ullValue = ullDuration;
+
+        /* The bucket is the number of significant bits in the duration. */
+        while( ( ullValue != 0U ) && ( uxBucket < ( ( size_t ) ipconfigIP_TASK_PROFILING_BUCKETS - 1U ) ) )
+        {
+            ullValue >>= 1;
+            uxBucket++;
+        }
+
+        taskENTER_CRITICAL();
+        {
+            pxHistogram->ulCount++;
+            pxHistogram->ullTotal += ullDuration;
+
+            if( pxHistogram->ullMax < ullDuration )
+            {
+                pxHistogram->ullMax = ullDuration;
+            }
+
+            pxHistogram->ulBuckets[ uxBucket ]++;
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Translate an event type to an index in the histogram arrays.
+ *
+ * @param[in] eEventType The event type.
+ *
+ * @return The index, or ipIP_TASK_PROFILE_EVENT_COUNT when the type is unknown.
+ */
+    static size_t prvEventIndex( eIPEvent_t eEventType )
+    {
+        BaseType_t xIndex = ( BaseType_t ) eEventType + 1;
+        size_t uxReturn = ipIP_TASK_PROFILE_EVENT_COUNT;
+
+        if( ( xIndex >= 0 ) && ( ( size_t ) xIndex < ipIP_TASK_PROFILE_EVENT_COUNT ) )
+        {
+            uxReturn = ( size_t ) xIndex;
+        }
+
+        return uxReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Add the time spent on an event to the histogram of its type.
+ *
+ * @param[in] eEventType The type of the event that was handled.
+ * @param[in] ullStartTime The time at which the handling started.
+ */
+    void vIPTaskProfileProcessing( eIPEvent_t eEventType,
+                                   uint64_t ullStartTime )
+    {
+        uint64_t ullNow = ipconfigIP_TASK_PROFILING_TIME();
+        size_t uxIndex = prvEventIndex( eEventType );
+
+        if( uxIndex < ipIP_TASK_PROFILE_EVENT_COUNT )
+        {
+            prvHistogramAdd( &( xIPTaskProfile.xProcessing[ uxIndex ] ), ullNow - ullStartTime );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Add the time that an event waited in the event queue to the histogram
+ *        of its type.
+ *
+ * @param[in] pxEvent The event that was received from the queue.
+ * @param[in] ullReceiveTime The time at which the event was received.
+ */
+    void vIPTaskProfileQueueWait( const IPStackEvent_t * pxEvent,
+                                  uint64_t ullReceiveTime )
+    {
+        size_t uxIndex = prvEventIndex( pxEvent->eEventType );
+
+        /* Events sent from an interrupt do not have a time stamp. */
+        if( ( uxIndex < ipIP_TASK_PROFILE_EVENT_COUNT ) &&
+            ( pxEvent->ullPostTime != 0U ) &&
+            ( pxEvent->ullPostTime <= ullReceiveTime ) )
+        {
+            prvHistogramAdd( &( xIPTaskProfile.xQueueWait[ uxIndex ] ), ullReceiveTime - pxEvent->ullPostTime );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Add the time spent in vCheckNetworkTimers() to its histogram.
+ *
+ * @param[in] ullStartTime The time at which the check started.
+ */
+    void vIPTaskProfileTimerCheck( uint64_t ullStartTime )
+    {
+        uint64_t ullNow = ipconfigIP_TASK_PROFILING_TIME();
+
+        prvHistogramAdd( &( xIPTaskProfile.xTimerCheck ), ullNow - ullStartTime );
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Get a snapshot of all histograms.
+ *
+ * @param[out] pxProfile The snapshot will be written here.
+ *
+ * @return pdPASS when the snapshot was written, pdFAIL when pxProfile is NULL.
+ */
+    BaseType_t FreeRTOS_GetIPTaskProfile( IPTaskProfile_t * pxProfile )
+    {
+        BaseType_t xReturn = pdFAIL;
+
+        if( pxProfile != NULL )
+        {
+            vTaskSuspendAll();
+            {
+                ( void ) memcpy( pxProfile, &( xIPTaskProfile ), sizeof( *pxProfile ) );
+            }
+            ( void ) xTaskResumeAll();
+
+            xReturn = pdPASS;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Clear all histograms.
+ */
+    void FreeRTOS_ClearIPTaskProfile( void )
+    {
+        vTaskSuspendAll();
+        {
+            ( void ) memset( &( xIPTaskProfile ), 0, sizeof( xIPTaskProfile ) );
+        }
+        ( void ) xTaskResumeAll();
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ( ipconfigUSE_IP_TASK_PROFILING == 1 ) */
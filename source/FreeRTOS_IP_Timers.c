@@ -55,6 +55,7 @@
 #include "NetworkBufferManagement.h"
 #include "FreeRTOS_Routing.h"
 #include "FreeRTOS_DNS.h"
+#include "FreeRTOS_IGMP.h"
 /*-----------------------------------------------------------*/
 
 /** @brief 'xAllNetworksUp' becomes pdTRUE when all network interfaces are initialised
@@ -120,6 +121,10 @@ static void prvIPTimerReload( IPTimer_t * pxTimer,
     /** @brief DNS timer, to check for timeouts when looking-up a domain. */
     static IPTimer_t xDNSTimer;
 #endif
+#if ( ipconfigSUPPORT_IP_MULTICAST == 1 )
+    /** @brief Multicast timer, to send the IGMP and MLD reports. */
+    static IPTimer_t xMulticastTimer;
+#endif
 
 /** @brief As long as not all networks are up, repeat initialisation by calling the
  * xNetworkInterfaceInitialise() function of the interfaces that are not ready. */
@@ -211,6 +216,18 @@ TickType_t xCalculateSleepTime( void )
     }
     #endif
 
+    #if ( ipconfigSUPPORT_IP_MULTICAST == 1 )
+    {
+        if( xMulticastTimer.bActive != pdFALSE_UNSIGNED )
+        {
+            if( xMulticastTimer.ulRemainingTime < uxMaximumSleepTime )
+            {
+                uxMaximumSleepTime = xMulticastTimer.ulRemainingTime;
+            }
+        }
+    }
+    #endif
+
     return uxMaximumSleepTime;
 }
 /*-----------------------------------------------------------*/
@@ -320,6 +337,16 @@ void vCheckNetworkTimers( void )
     }
     #endif /* ipconfigDNS_USE_CALLBACKS */
 
+    #if ( ipconfigSUPPORT_IP_MULTICAST == 1 )
+    {
+        /* Is it time to send multicast reports? */
+        if( prvIPTimerCheck( &xMulticastTimer ) != pdFALSE )
+        {
+            vMulticastTimerExpired();
+        }
+    }
+    #endif /* ipconfigSUPPORT_IP_MULTICAST */
+
     #if ( ipconfigUSE_TCP == 1 )
     {
         BaseType_t xWillSleep;
@@ -510,6 +537,20 @@ static void prvIPTimerReload( IPTimer_t * pxTimer,
 #endif /* ipconfigDNS_USE_CALLBACKS != 0 */
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigSUPPORT_IP_MULTICAST == 1 )
+
+/**
+ * @brief Reload the multicast timer.
+ *
+ * @param[in] xTime The reload value.
+ */
+    void vMulticastTimerReload( TickType_t xTime )
+    {
+        prvIPTimerReload( &xMulticastTimer, xTime );
+    }
+#endif /* ipconfigSUPPORT_IP_MULTICAST == 1 */
+/*-----------------------------------------------------------*/
+
 #if ( ipconfigUSE_DHCP == 1 ) || ( ipconfigUSE_RA == 1 )
 
 /**
@@ -731,6 +772,28 @@ static BaseType_t prvIPTimerCheck( IPTimer_t * pxTimer )
 #endif /* ipconfigDNS_USE_CALLBACKS == 1 */
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigSUPPORT_IP_MULTICAST == 1 )
+
+/**
+ * @brief Enable/disable the multicast timer.
+ *
+ * @param[in] xEnableState pdTRUE - enable timer; pdFALSE - disable timer.
+ */
+    void vIPSetMulticastTimerEnableState( BaseType_t xEnableState )
+    {
+        if( xEnableState != 0 )
+        {
+            xMulticastTimer.bActive = ipTRUE_BOOL;
+        }
+        else
+        {
+            xMulticastTimer.bActive = ipFALSE_BOOL;
+        }
+    }
+
+#endif /* ipconfigSUPPORT_IP_MULTICAST == 1 */
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Mark whether all interfaces are up or at least one interface is down.
  *        If all interfaces are up, the 'xNetworkTimer' will not be checked.
@@ -360,6 +360,8 @@ enum eFrameProcessingResult prvAllowIPPacketIPv4( const struct xIP_PACKET * cons
         if( ( ( pxIPHeader->usFragmentOffset & ipFRAGMENT_OFFSET_BIT_MASK ) != 0U ) || ( ( pxIPHeader->usFragmentOffset & ipFRAGMENT_FLAGS_MORE_FRAGMENTS ) != 0U ) )
         {
             /* Can not handle, fragmented packet. */
+            ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpReasmFails );
+            ipDROP_FRAME( pxNetworkBuffer, eIPDropFragment );
             eReturn = eReleaseBuffer;
         }
 
@@ -369,6 +371,8 @@ enum eFrameProcessingResult prvAllowIPPacketIPv4( const struct xIP_PACKET * cons
                  ( pxIPHeader->ucVersionHeaderLength > ipIPV4_VERSION_HEADER_LENGTH_MAX ) )
         {
             /* Can not handle, unknown or invalid header version. */
+            ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInHdrErrors );
+            ipDROP_FRAME( pxNetworkBuffer, eIPDropBadHeader );
             eReturn = eReleaseBuffer;
         }
         else if( ( xIsIPv4Loopback( ulDestinationIPAddress ) == pdTRUE ) ||
@@ -379,6 +383,8 @@ enum eFrameProcessingResult prvAllowIPPacketIPv4( const struct xIP_PACKET * cons
             {
                 /* The local loopback addresses must never appear outside a host. See RFC 1122
                  * section 3.2.1.3. */
+                ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInAddrErrors );
+                ipDROP_FRAME( pxNetworkBuffer, eIPDropAddress );
                 eReturn = eReleaseBuffer;
             }
         }
@@ -387,11 +393,15 @@ enum eFrameProcessingResult prvAllowIPPacketIPv4( const struct xIP_PACKET * cons
                          sizeof( MACAddress_t ) ) == 0 )
         {
             /* Ethernet source is a broadcast address. Drop the packet. */
+            ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInAddrErrors );
+            ipDROP_FRAME( pxNetworkBuffer, eIPDropAddress );
             eReturn = eReleaseBuffer;
         }
         else if( xIsIPv4Multicast( ulSourceIPAddress ) == pdTRUE )
         {
             /* Source is a multicast IP address. Drop the packet in conformity with RFC 1112 section 7.2. */
+            ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInAddrErrors );
+            ipDROP_FRAME( pxNetworkBuffer, eIPDropAddress );
             eReturn = eReleaseBuffer;
         }
 
@@ -410,6 +420,8 @@ enum eFrameProcessingResult prvAllowIPPacketIPv4( const struct xIP_PACKET * cons
                 ( xIsIPv4Multicast( ulDestinationIPAddress ) == pdFALSE ) )
             {
                 /* Packet is not for this node, release it */
+                ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInAddrErrors );
+                ipDROP_FRAME( pxNetworkBuffer, eIPDropAddress );
                 eReturn = eReleaseBuffer;
             }
             /* Is the source address correct? */
@@ -418,6 +430,8 @@ enum eFrameProcessingResult prvAllowIPPacketIPv4( const struct xIP_PACKET * cons
             {
                 /* The source address cannot be broadcast address. Replying to this
                  * packet may cause network storms. Drop the packet. */
+                ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInAddrErrors );
+                ipDROP_FRAME( pxNetworkBuffer, eIPDropAddress );
                 eReturn = eReleaseBuffer;
             }
             else if( ( memcmp( xBroadcastMACAddress.ucBytes,
@@ -427,6 +441,8 @@ enum eFrameProcessingResult prvAllowIPPacketIPv4( const struct xIP_PACKET * cons
             {
                 /* Ethernet address is a broadcast address, but the IP address is not a
                  * broadcast address. */
+                ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInAddrErrors );
+                ipDROP_FRAME( pxNetworkBuffer, eIPDropAddress );
                 eReturn = eReleaseBuffer;
             }
             else
@@ -448,6 +464,8 @@ enum eFrameProcessingResult prvAllowIPPacketIPv4( const struct xIP_PACKET * cons
                 {
                     /* Ethernet address is a broadcast address, but the IP address is not a
                      * broadcast address. */
+                    ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInAddrErrors );
+                    ipDROP_FRAME( pxNetworkBuffer, eIPDropAddress );
                     eReturn = eReleaseBuffer;
                 }
                 else
@@ -470,6 +488,8 @@ enum eFrameProcessingResult prvAllowIPPacketIPv4( const struct xIP_PACKET * cons
                 /* The endpoint is not up, and the destination MAC address of the
                  * packet is not matching the endpoint's MAC address nor broadcast
                  * MAC address. Drop the packet. */
+                ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInAddrErrors );
+                ipDROP_FRAME( pxNetworkBuffer, eIPDropAddress );
                 eReturn = eReleaseBuffer;
             }
             else
@@ -498,12 +518,17 @@ enum eFrameProcessingResult prvAllowIPPacketIPv4( const struct xIP_PACKET * cons
             if( usGenerateChecksum( 0U, ( const uint8_t * ) &( pxIPHeader->ucVersionHeaderLength ), ( size_t ) uxHeaderLength ) != ipCORRECT_CRC )
             {
                 /* Check sum in IP-header not correct. */
+                ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInHdrErrors );
+                ipMIB_COUNT_CHECKSUM_ERROR( pxNetworkBuffer, 0U );
+                ipDROP_FRAME( pxNetworkBuffer, eIPDropChecksum );
                 eReturn = eReleaseBuffer;
             }
             /* Is the upper-layer checksum (TCP/UDP/ICMP) correct? */
             else if( usGenerateProtocolChecksum( ( uint8_t * ) ( pxNetworkBuffer->pucEthernetBuffer ), pxNetworkBuffer->xDataLength, pdFALSE ) != ipCORRECT_CRC )
             {
                 /* Protocol checksum not accepted. */
+                ipMIB_COUNT_CHECKSUM_ERROR( pxNetworkBuffer, pxIPHeader->ucProtocol );
+                ipDROP_FRAME( pxNetworkBuffer, eIPDropChecksum );
                 eReturn = eReleaseBuffer;
             }
             else
@@ -519,6 +544,8 @@ enum eFrameProcessingResult prvAllowIPPacketIPv4( const struct xIP_PACKET * cons
             if( xCheckIPv4SizeFields( pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength ) != pdPASS )
             {
                 /* Some of the length checks were not successful. */
+                ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInHdrErrors );
+                ipDROP_FRAME( pxNetworkBuffer, eIPDropBadHeader );
                 eReturn = eReleaseBuffer;
             }
         }
@@ -560,6 +587,8 @@ enum eFrameProcessingResult prvAllowIPPacketIPv4( const struct xIP_PACKET * cons
                         #endif /* ( ipconfigHAS_PRINTF != 0 ) */
 
                         /* Protocol checksum not accepted. */
+                        ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBUdpInErrors );
+                        ipDROP_FRAME( pxNetworkBuffer, eIPDropChecksum );
                         eReturn = eReleaseBuffer;
                     }
                 }
@@ -501,6 +501,8 @@ eFrameProcessingResult_t prvAllowIPPacketIPv6( const IPHeader_IPv6_t * const pxI
         if( ( ( ucVersionTrafficClass & ( uint8_t ) 0xF0U ) >> 4 ) != 6U )
         {
             /* Can not handle, unknown or invalid header version. */
+            ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInHdrErrors );
+            ipDROP_FRAME( pxNetworkBuffer, eIPDropBadHeader );
             eReturn = eReleaseBuffer;
             FreeRTOS_printf( ( "prvAllowIPPacketIPv6: drop packet, invalid header version: %u\n", ( ucVersionTrafficClass & ( uint8_t ) 0xF0U ) >> 4 ) );
         }
@@ -524,6 +526,8 @@ eFrameProcessingResult_t prvAllowIPPacketIPv6( const IPHeader_IPv6_t * const pxI
         {
             /* Packet is not for this node, or the network is still not up,
              * release it */
+            ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInAddrErrors );
+            ipDROP_FRAME( pxNetworkBuffer, eIPDropAddress );
             eReturn = eReleaseBuffer;
             FreeRTOS_printf( ( "prvAllowIPPacketIPv6: drop %pip (from %pip)\n", pxDestinationIPAddress->ucBytes, pxIPv6Header->xSourceAddress.ucBytes ) );
         }
@@ -547,6 +551,8 @@ eFrameProcessingResult_t prvAllowIPPacketIPv6( const IPHeader_IPv6_t * const pxI
             if( usGenerateProtocolChecksum( ( uint8_t * ) ( pxNetworkBuffer->pucEthernetBuffer ), pxNetworkBuffer->xDataLength, pdFALSE ) != ipCORRECT_CRC )
             {
                 /* Protocol checksum not accepted. */
+                ipMIB_COUNT_CHECKSUM_ERROR( pxNetworkBuffer, pxIPv6Header->ucNextHeader );
+                ipDROP_FRAME( pxNetworkBuffer, eIPDropChecksum );
                 eReturn = eReleaseBuffer;
             }
         }
@@ -558,6 +564,8 @@ eFrameProcessingResult_t prvAllowIPPacketIPv6( const IPHeader_IPv6_t * const pxI
             if( xCheckIPv6SizeFields( pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength ) != pdPASS )
             {
                 /* Some of the length checks were not successful. */
+                ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIpInHdrErrors );
+                ipDROP_FRAME( pxNetworkBuffer, eIPDropBadHeader );
                 eReturn = eReleaseBuffer;
             }
         }
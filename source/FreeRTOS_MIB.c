@@ -0,0 +1,377 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file FreeRTOS_MIB.c
+ * @brief Implements the MIB counters of the FreeRTOS+TCP network stack.
+ *
+ * Most counters are only incremented by the IP-task, so no locking is needed
+ * there. A few events are counted by other tasks, e.g. when a network buffer
+ * could not be obtained: those go to a separate set that is only changed
+ * within a critical section. The snapshot function is called from user tasks:
+ * it suspends the scheduler while copying, so that it never sees a
+ * half-updated set.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_MIB.h"
+#include "FreeRTOS_Routing.h"
+
+#if ( ipconfigUSE_MIB_COUNTERS == 1 )
+
+/** @brief Counters of events for which neither an interface nor an end-point
+ *         is known, e.g. a packet that could not be routed. */
+    static MIBCounters_t xGlobalMIB;
+
+/** @brief Stack-wide counters of events that are counted outside the IP-task. */
+    static MIBCounters_t xFromTaskMIB;
+
+/*-----------------------------------------------------------*/
+
+    static void prvMIBAdd( MIBCounters_t * pxTarget,
+                           const MIBCounters_t * pxSource );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Increment a MIB counter. The event is counted in the most specific
+ *        owner that is known: the end-point, or else the interface, or else
+ *        the stack-wide set.
+ *
+ * @param[in] pxInterface The interface involved, or NULL when not known.
+ * @param[in] pxEndPoint The end-point involved, or NULL when not known.
+ * @param[in] eCounter The counter to be incremented.
+ */
+    void vMIBCount( struct xNetworkInterface * pxInterface,
+                    struct xNetworkEndPoint * pxEndPoint,
+                    eMIBCounter_t eCounter )
+    {
+        if( pxEndPoint != NULL )
+        {
+            pxEndPoint->xMIB.ulCounters[ eCounter ]++;
+        }
+        else if( pxInterface != NULL )
+        {
+            pxInterface->xMIB.ulCounters[ eCounter ]++;
+        }
+        else
+        {
+            xGlobalMIB.ulCounters[ eCounter ]++;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief A received packet was dropped because of a checksum error. Increment
+ *        the checksum counter, and the error counter of the protocol.
+ *
+ * @param[in] pxNetworkBuffer The packet that was dropped.
+ * @param[in] ucProtocol The protocol whose checksum was wrong.
+ */
+    void vMIBCountChecksumError( const struct xNETWORK_BUFFER * pxNetworkBuffer,
+                                 uint8_t ucProtocol )
+    {
+        vMIBCount( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBInCsumErrors );
+
+        switch( ucProtocol )
+        {
+            case ipPROTOCOL_ICMP:
+            case ipPROTOCOL_ICMP_IPv6:
+                vMIBCount( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIcmpInErrors );
+                break;
+
+            case ipPROTOCOL_UDP:
+                vMIBCount( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBUdpInErrors );
+                break;
+
+            case ipPROTOCOL_TCP:
+                vMIBCount( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBTcpInErrs );
+                break;
+
+            default:
+                /* An error in the IP-header or in an unknown protocol. */
+                break;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief A frame is about to be handed to a network interface. Look at its
+ *        contents and increment the output counters of the protocols involved.
+ *
+ * @param[in] pxNetworkBuffer The frame to be sent.
+ */
+    void vMIBCountOutput( const struct xNETWORK_BUFFER * pxNetworkBuffer )
+    {
+        const uint8_t * pucEthernetBuffer = pxNetworkBuffer->pucEthernetBuffer;
+        NetworkInterface_t * pxInterface = pxNetworkBuffer->pxInterface;
+        NetworkEndPoint_t * pxEndPoint = pxNetworkBuffer->pxEndPoint;
+        size_t uxIPHeaderLength = 0U;
+        uint8_t ucProtocol = 0U;
+
+        /* MISRA Ref 11.3.1 [Misaligned access] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+        /* coverity[misra_c_2012_rule_11_3_violation] */
+        const EthernetHeader_t * pxEthernetHeader = ( ( const EthernetHeader_t * ) pucEthernetBuffer );
+
+        if( ( pxInterface == NULL ) && ( pxEndPoint != NULL ) )
+        {
+            pxInterface = pxEndPoint->pxNetworkInterface;
+        }
+
+        switch( pxEthernetHeader->usFrameType )
+        {
+            #if ( ipconfigUSE_IPv4 != 0 )
+                case ipARP_FRAME_TYPE:
+
+                    if( pxNetworkBuffer->xDataLength >= sizeof( ARPPacket_t ) )
+                    {
+                        /* MISRA Ref 11.3.1 [Misaligned access] */
+                        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                        /* coverity[misra_c_2012_rule_11_3_violation] */
+                        const ARPPacket_t * pxARPPacket = ( ( const ARPPacket_t * ) pucEthernetBuffer );
+
+                        if( pxARPPacket->xARPHeader.usOperation == ( uint16_t ) ipARP_REQUEST )
+                        {
+                            vMIBCount( pxInterface, pxEndPoint, eMIBArpOutRequests );
+                        }
+                        else if( pxARPPacket->xARPHeader.usOperation == ( uint16_t ) ipARP_REPLY )
+                        {
+                            vMIBCount( pxInterface, pxEndPoint, eMIBArpOutReplies );
+                        }
+                        else
+                        {
+                            /* Some other ARP operation. */
+                        }
+                    }
+                    break;
+
+                case ipIPv4_FRAME_TYPE:
+
+                    if( pxNetworkBuffer->xDataLength >= sizeof( IPPacket_t ) )
+                    {
+                        /* MISRA Ref 11.3.1 [Misaligned access] */
+                        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                        /* coverity[misra_c_2012_rule_11_3_violation] */
+                        const IPPacket_t * pxIPPacket = ( ( const IPPacket_t * ) pucEthernetBuffer );
+
+                        uxIPHeaderLength = ( size_t ) ( ( pxIPPacket->xIPHeader.ucVersionHeaderLength & 0x0FU ) << 2 );
+                        ucProtocol = pxIPPacket->xIPHeader.ucProtocol;
+                        vMIBCount( pxInterface, pxEndPoint, eMIBIpOutRequests );
+                    }
+                    break;
+            #endif /* ( ipconfigUSE_IPv4 != 0 ) */
+
+            #if ( ipconfigUSE_IPv6 != 0 )
+                case ipIPv6_FRAME_TYPE:
+
+                    if( pxNetworkBuffer->xDataLength >= sizeof( IPPacket_IPv6_t ) )
+                    {
+                        /* MISRA Ref 11.3.1 [Misaligned access] */
+                        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                        /* coverity[misra_c_2012_rule_11_3_violation] */
+                        const IPPacket_IPv6_t * pxIPPacket_IPv6 = ( ( const IPPacket_IPv6_t * ) pucEthernetBuffer );
+
+                        uxIPHeaderLength = ipSIZE_OF_IPv6_HEADER;
+                        ucProtocol = pxIPPacket_IPv6->xIPHeader.ucNextHeader;
+                        vMIBCount( pxInterface, pxEndPoint, eMIBIpOutRequests );
+                    }
+                    break;
+            #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+
+            default:
+                /* Not an ARP or IP frame. */
+                break;
+        }
+
+        if( ( uxIPHeaderLength != 0U ) &&
+            ( pxNetworkBuffer->xDataLength > ( ipSIZE_OF_ETH_HEADER + uxIPHeaderLength ) ) )
+        {
+            /* Points to the first byte after the IP-header, e.g. the type of an ICMP message. */
+            const uint8_t * pucProtocolHeader = &( pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + uxIPHeaderLength ] );
+
+            switch( ucProtocol )
+            {
+                case ipPROTOCOL_ICMP:
+                    vMIBCount( pxInterface, pxEndPoint, eMIBIcmpOutMsgs );
+                    break;
+
+                case ipPROTOCOL_ICMP_IPv6:
+                    vMIBCount( pxInterface, pxEndPoint, eMIBIcmpOutMsgs );
+
+                    if( pucProtocolHeader[ 0 ] == ipICMP_NEIGHBOR_SOLICITATION_IPv6 )
+                    {
+                        vMIBCount( pxInterface, pxEndPoint, eMIBNdOutSolicitations );
+                    }
+                    else if( pucProtocolHeader[ 0 ] == ipICMP_NEIGHBOR_ADVERTISEMENT_IPv6 )
+                    {
+                        vMIBCount( pxInterface, pxEndPoint, eMIBNdOutAdvertisements );
+                    }
+                    else
+                    {
+                        /* Another ICMPv6 message. */
+                    }
+                    break;
+
+                case ipPROTOCOL_UDP:
+                    vMIBCount( pxInterface, pxEndPoint, eMIBUdpOutDatagrams );
+                    break;
+
+                    #if ( ipconfigUSE_TCP == 1 )
+                        case ipPROTOCOL_TCP:
+                            vMIBCount( pxInterface, pxEndPoint, eMIBTcpOutSegs );
+
+                            if( ( pxNetworkBuffer->xDataLength > ( ipSIZE_OF_ETH_HEADER + uxIPHeaderLength + ipTCP_FLAGS_OFFSET ) ) &&
+                                ( ( pucProtocolHeader[ ipTCP_FLAGS_OFFSET ] & tcpTCP_FLAG_RST ) != 0U ) )
+                            {
+                                vMIBCount( pxInterface, pxEndPoint, eMIBTcpOutRsts );
+                            }
+                            break;
+                    #endif /* ( ipconfigUSE_TCP == 1 ) */
+
+                default:
+                    /* IGMP, or a protocol that is not counted. */
+                    break;
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Increment a stack-wide counter. Unlike vMIBCount(), this may be
+ *        called from any task, e.g. when a network buffer could not be
+ *        obtained, or when a frame could not be passed to the IP-task.
+ *
+ * @param[in] eCounter The counter to be incremented.
+ */
+    void vMIBCountFromTask( eMIBCounter_t eCounter )
+    {
+        taskENTER_CRITICAL();
+        {
+            xFromTaskMIB.ulCounters[ eCounter ]++;
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Add one set of counters to another.
+ *
+ * @param[in,out] pxTarget The set that accumulates.
+ * @param[in] pxSource The set to be added.
+ */
+    static void prvMIBAdd( MIBCounters_t * pxTarget,
+                           const MIBCounters_t * pxSource )
+    {
+        BaseType_t xIndex;
+
+        for( xIndex = 0; xIndex < ( BaseType_t ) eMIBCounterCount; xIndex++ )
+        {
+            pxTarget->ulCounters[ xIndex ] += pxSource->ulCounters[ xIndex ];
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Get a snapshot of the MIB counters.
+ *
+ * @param[in] pxInterface When not NULL, and pxEndPoint is NULL: the counters of
+ *                        this interface and of all its end-points are returned.
+ * @param[in] pxEndPoint When not NULL: the counters of this end-point are returned.
+ * @param[out] pxCounters The snapshot will be written here. When both pxInterface
+ *                        and pxEndPoint are NULL, it contains the sum of all
+ *                        counters of the stack.
+ *
+ * @return pdPASS when the snapshot was written, pdFAIL when pxCounters is NULL.
+ */
+    BaseType_t FreeRTOS_GetMIBCounters( const struct xNetworkInterface * pxInterface,
+                                        const struct xNetworkEndPoint * pxEndPoint,
+                                        MIBCounters_t * pxCounters )
+    {
+        BaseType_t xReturn = pdFAIL;
+        const NetworkInterface_t * pxIterator;
+        NetworkEndPoint_t * pxEndPointIterator;
+
+        if( pxCounters != NULL )
+        {
+            ( void ) memset( pxCounters, 0, sizeof( *pxCounters ) );
+
+            vTaskSuspendAll();
+            {
+                if( pxEndPoint != NULL )
+                {
+                    prvMIBAdd( pxCounters, &( pxEndPoint->xMIB ) );
+                }
+                else
+                {
+                    if( pxInterface == NULL )
+                    {
+                        /* All interfaces, and the events that could not be attributed. */
+                        prvMIBAdd( pxCounters, &( xGlobalMIB ) );
+                        prvMIBAdd( pxCounters, &( xFromTaskMIB ) );
+
+                        for( pxIterator = FreeRTOS_FirstNetworkInterface();
+                             pxIterator != NULL;
+                             pxIterator = FreeRTOS_NextNetworkInterface( pxIterator ) )
+                        {
+                            prvMIBAdd( pxCounters, &( pxIterator->xMIB ) );
+                        }
+                    }
+                    else
+                    {
+                        prvMIBAdd( pxCounters, &( pxInterface->xMIB ) );
+                    }
+
+                    /* When pxInterface is NULL, all end-points will be visited. */
+                    for( pxEndPointIterator = FreeRTOS_FirstEndPoint( pxInterface );
+                         pxEndPointIterator != NULL;
+                         pxEndPointIterator = FreeRTOS_NextEndPoint( pxInterface, pxEndPointIterator ) )
+                    {
+                        prvMIBAdd( pxCounters, &( pxEndPointIterator->xMIB ) );
+                    }
+                }
+            }
+            ( void ) xTaskResumeAll();
+
+            xReturn = pdPASS;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ( ipconfigUSE_MIB_COUNTERS == 1 ) */
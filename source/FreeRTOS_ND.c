@@ -45,6 +45,7 @@
 #include "FreeRTOS_Routing.h"
 #include "FreeRTOS_ND.h"
 #include "FreeRTOS_IP_Timers.h"
+#include "FreeRTOS_IGMP.h"
 
 #if ( ipconfigUSE_LLMNR == 1 )
     #include "FreeRTOS_DNS.h"
@@ -733,11 +734,19 @@
             BaseType_t xReturn = pdFAIL;
             static uint16_t usSequenceNumber = 0;
             uint8_t * pucChar;
-            IPStackEvent_t xStackTxEvent = { eStackTxEvent, NULL };
+            IPStackEvent_t xStackTxEvent;
             NetworkEndPoint_t * pxEndPoint = NULL;
             size_t uxPacketLength = 0U;
             BaseType_t xEnoughSpace;
 
+            xStackTxEvent.eEventType = eStackTxEvent;
+            xStackTxEvent.pvData = NULL;
+
+            #if ( ipconfigUSE_IP_TASK_PROFILING == 1 )
+                /* Stamped by xSendEventStructToIPTask(). */
+                xStackTxEvent.ullPostTime = 0U;
+            #endif
+
             pxEndPoint = FreeRTOS_FindEndPointOnIP_IPv6( pxIPAddress );
 
             /* MISRA Ref 14.3.1 [Configuration dependent invariant] */
@@ -846,7 +855,7 @@
                     if( xSendEventStructToIPTask( &xStackTxEvent, uxBlockTimeTicks ) != pdPASS )
                     {
                         vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
-                        iptraceSTACK_TX_EVENT_LOST( ipSTACK_TX_EVENT );
+                        iptraceSTACK_TX_EVENT_LOST( eStackTxEvent );
                     }
                     else
                     {
@@ -1023,6 +1032,8 @@
             }
             #endif /* ( ipconfigHAS_PRINTF == 1 ) */
 
+            ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxEndPoint, eMIBIcmpInMsgs );
+
             if( pxEndPoint->bits.bIPv6 != pdFALSE_UNSIGNED )
             {
                 switch( pxICMPHeader_IPv6->ucTypeOfMessage )
@@ -1116,6 +1127,7 @@
                            const NetworkEndPoint_t * pxTargetedEndPoint = pxEndPoint;
                            const NetworkEndPoint_t * pxEndPointInSameSubnet;
 
+                           ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxEndPoint, eMIBNdInSolicitations );
                            uxICMPSize = sizeof( ICMPHeader_IPv6_t );
                            uxNeededSize = ( size_t ) ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER + uxICMPSize );
 
@@ -1166,6 +1178,8 @@
                     case ipICMP_NEIGHBOR_ADVERTISEMENT_IPv6:
                        {
                            size_t uxICMPSize;
+
+                           ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxEndPoint, eMIBNdInAdvertisements );
                            uxICMPSize = sizeof( ICMPHeader_IPv6_t );
                            uxNeededSize = ( size_t ) ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER + uxICMPSize );
 
@@ -1209,6 +1223,14 @@
                                 break;
                         #endif /* ( ipconfigUSE_RA != 0 ) */
 
+                        #if ( ipconfigSUPPORT_IP_MULTICAST == 1 )
+                            case ipICMP_MULTICAST_LISTENER_QUERY_IPv6:
+                            case ipICMP_MULTICAST_LISTENER_REPORT_IPv6:
+                                /* Size check is done inside vProcessMLDPacket */
+                                vProcessMLDPacket( pxNetworkBuffer );
+                                break;
+                        #endif /* ( ipconfigSUPPORT_IP_MULTICAST == 1 ) */
+
                     default:
                         /* All possible values are included here above. */
                         break;
@@ -1219,6 +1241,8 @@
         {
             /* Malformed ICMPv6 packet, release the network buffer (performed
              * in prvProcessEthernetPacket)*/
+            ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBIcmpInErrors );
+            ipDROP_FRAME( pxNetworkBuffer, eIPDropICMPInvalid );
         }
 
         return eReleaseBuffer;
@@ -1309,6 +1333,7 @@
             #endif
 
             /* Set the parameter 'bReleaseAfterSend'. */
+            ipMIB_COUNT_OUTPUT( pxNetworkBuffer );
             ( void ) pxInterface->pfOutput( pxInterface, pxNetworkBuffer, pdTRUE );
         }
     }
@@ -49,9 +49,11 @@
 #include "FreeRTOS_IPv4_Sockets.h"
 #include "FreeRTOS_IPv6_Sockets.h"
 #include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_ARP.h"
 #include "FreeRTOS_DNS.h"
 #include "NetworkBufferManagement.h"
 #include "FreeRTOS_Routing.h"
+#include "FreeRTOS_IGMP.h"
 
 #if ( ipconfigUSE_TCP_MEM_STATS != 0 )
     #include "tcp_mem_stats.h"
@@ -161,7 +163,7 @@ static NetworkBufferDescriptor_t * prvRecvFromWaitForPacket( FreeRTOS_Socket_t c
                                                              BaseType_t xFlags,
                                                              EventBits_t * pxEventBits );
 
-static int32_t prvSendUDPPacket( const FreeRTOS_Socket_t * pxSocket,
+static int32_t prvSendUDPPacket( FreeRTOS_Socket_t * pxSocket,
                                  NetworkBufferDescriptor_t * pxNetworkBuffer,
                                  size_t uxTotalDataLength,
                                  BaseType_t xFlags,
@@ -186,6 +188,30 @@ static int32_t prvSendUDPPacket( const FreeRTOS_Socket_t * pxSocket,
 
 #if ( ipconfigUSE_TCP == 1 )
 
+/*
+ * Get the value of a low- or high-water mark that applies to the current
+ * size of the rxStream.
+ */
+    static size_t prvTCPRxWaterMark( const FreeRTOS_Socket_t * pxSocket,
+                                     size_t uxMark );
+#endif /* ipconfigUSE_TCP == 1 */
+
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_RX_AUTOTUNE == 1 ) )
+
+/*
+ * Get the size of the rxStream that follows the tuned reception window.
+ */
+    static size_t prvTCPRxStreamSize( const FreeRTOS_Socket_t * pxSocket );
+
+/*
+ * Called by the user's task after reading: ask the IP-task to replace the
+ * rxStream with a bigger one when the reception window has grown.
+ */
+    static void prvTCPRxStreamCheckGrow( FreeRTOS_Socket_t * pxSocket );
+#endif /* ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_RX_AUTOTUNE == 1 ) ) */
+
+#if ( ipconfigUSE_TCP == 1 )
+
 /*
  * Called from FreeRTOS_send(): some checks which will be done before
  * sending a TCP packed.
@@ -233,6 +259,17 @@ static BaseType_t prvMakeSureSocketIsBound( FreeRTOS_Socket_t * pxSocket );
 
 #endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
 
+#if ( ipconfigSELECT_READY_LIST == 1 )
+
+/** @brief Add events to a socket and put it in the ready list of its socket set. */
+    static void prvSocketSetReady( FreeRTOS_Socket_t * pxSocket,
+                                   EventBits_t xSocketBits );
+
+/** @brief Take a socket out of the ready list of its socket set. */
+    static void prvSocketSetNotReady( FreeRTOS_Socket_t * pxSocket );
+
+#endif /* ipconfigSELECT_READY_LIST == 1 */
+
 #if ( ipconfigUSE_TCP == 1 )
 
 /** @brief This routine will wait for data to arrive in the stream buffer.
@@ -244,6 +281,22 @@ static BaseType_t prvMakeSureSocketIsBound( FreeRTOS_Socket_t * pxSocket );
 
 #if ( ipconfigUSE_TCP == 1 )
 
+/** @brief Call prvRecvWait() and handle an interrupt by FreeRTOS_SignalSocket().
+ */
+    static BaseType_t prvRecvWaitSignal( const FreeRTOS_Socket_t * pxSocket,
+                                         BaseType_t xFlags );
+#endif /* ( ipconfigUSE_TCP == 1 ) */
+
+#if ( ipconfigUSE_TCP == 1 )
+
+/** @brief Check if there is anything to read, either in the stream buffer or
+ *         in the list of lent segments.
+ */
+    static BaseType_t prvRecvGetCount( const FreeRTOS_Socket_t * pxSocket );
+#endif /* ( ipconfigUSE_TCP == 1 ) */
+
+#if ( ipconfigUSE_TCP == 1 )
+
 /** @brief Read the data from the stream buffer.
  */
     static BaseType_t prvRecvData( FreeRTOS_Socket_t * pxSocket,
@@ -252,6 +305,21 @@ static BaseType_t prvMakeSureSocketIsBound( FreeRTOS_Socket_t * pxSocket );
                                    BaseType_t xFlags );
 #endif /* ( ipconfigUSE_TCP == 1 ) */
 
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_RX_BUFFER_LENDING == 1 ) )
+
+/** @brief Read the data from the oldest lent segment.
+ */
+    static BaseType_t prvRecvLentData( FreeRTOS_Socket_t * pxSocket,
+                                       void * pvBuffer,
+                                       size_t uxBufferLength,
+                                       BaseType_t xFlags );
+
+/** @brief Account for bytes of lent segments that were consumed by the user.
+ */
+    static void prvRecvLentConsumed( FreeRTOS_Socket_t * pxSocket,
+                                     size_t uxLength );
+#endif /* ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_RX_BUFFER_LENDING == 1 ) ) */
+
 #if ( ipconfigUSE_TCP == 1 )
 
 /**
@@ -263,6 +331,113 @@ static BaseType_t prvMakeSureSocketIsBound( FreeRTOS_Socket_t * pxSocket );
                                       BaseType_t xFlags );
 #endif /* ( ipconfigUSE_TCP == 1 ) */
 
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ( ipconfigTCP_TX_BY_REFERENCE == 1 ) || ( ipconfigSOCKET_IOVEC_CALLS == 1 ) ) )
+
+/**
+ * @brief Wait until the txStream has space for a number of bytes that must be
+ *        added at once.
+ */
+    static BaseType_t prvTCPSendWaitSpace( FreeRTOS_Socket_t * pxSocket,
+                                           size_t uxLength,
+                                           BaseType_t xFlags );
+#endif /* ( ( ipconfigUSE_TCP == 1 ) && ( ( ipconfigTCP_TX_BY_REFERENCE == 1 ) || ( ipconfigSOCKET_IOVEC_CALLS == 1 ) ) ) */
+
+#if ( ipconfigUSE_TCP == 1 )
+
+/**
+ * @brief Clear the low-water flag when the user has read enough data.
+ */
+    static void prvRecvCheckLowWater( FreeRTOS_Socket_t * pxSocket );
+#endif /* ( ipconfigUSE_TCP == 1 ) */
+
+#if ( ipconfigSOCKET_IOVEC_CALLS == 1 )
+
+/**
+ * @brief Check an I/O vector and calculate the total number of bytes.
+ */
+    static BaseType_t prvIOVectorLength( const struct freertos_iovec * pxIOVector,
+                                         size_t uxIOCount,
+                                         size_t * puxTotal );
+#endif /* ( ipconfigSOCKET_IOVEC_CALLS == 1 ) */
+
+#if ( ipconfigUDP_BATCH_CALLS == 1 )
+
+/**
+ * @brief Move prepared UDP packets to the batch list of a socket and wake up the IP-task.
+ */
+    static BaseType_t prvSendBatchHandOver( FreeRTOS_Socket_t * pxSocket,
+                                            List_t * pxPacketList,
+                                            TickType_t xTicksToWait );
+#endif /* ( ipconfigUDP_BATCH_CALLS == 1 ) */
+
+#if ( ipconfigUDP_GSO == 1 )
+
+/**
+ * @brief Split a large UDP write into datagrams of the segment size of the socket.
+ */
+    static int32_t prvSendToSegmented( FreeRTOS_Socket_t * pxSocket,
+                                       const struct freertos_iovec * pxIOVector,
+                                       size_t uxIOCount,
+                                       size_t uxTotalDataLength,
+                                       BaseType_t xFlags,
+                                       const struct freertos_sockaddr * pxDestinationAddress,
+                                       size_t uxMaxPayloadLength,
+                                       size_t uxPayloadOffset );
+#endif /* ( ipconfigUDP_GSO == 1 ) */
+
+#if ( ipconfigUDP_CONNECTED_SOCKETS == 1 )
+
+/**
+ * @brief Called from FreeRTOS_connect(): fix or clear the peer of a UDP socket.
+ */
+    static BaseType_t prvUDPConnect( FreeRTOS_Socket_t * pxSocket,
+                                     const struct freertos_sockaddr * pxAddress );
+
+/**
+ * @brief Get the peer of a connected UDP socket.
+ */
+    static const struct freertos_sockaddr * prvUDPConnectedPeer( FreeRTOS_Socket_t * pxSocket );
+#endif /* ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) */
+
+#if ( ( ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) || ( ipconfigUDP_BATCH_CALLS == 1 ) ) && ( ipconfigUSE_IPv4 != 0 ) )
+
+/**
+ * @brief Build the headers of IPv4 UDP packets to a given peer.
+ */
+    static BaseType_t prvUDPHeaderBuild( UDPPacket_t * pxHeader,
+                                         uint32_t ulDestinationIP,
+                                         uint16_t usDestinationPort,
+                                         uint16_t usSourcePort,
+                                         NetworkEndPoint_t ** ppxEndPoint );
+
+/**
+ * @brief Complete an IPv4 UDP packet with headers made by prvUDPHeaderBuild().
+ */
+    static void prvUDPHeaderComplete( const UDPPacket_t * pxHeader,
+                                      NetworkEndPoint_t * pxEndPoint,
+                                      NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                      size_t uxTotalDataLength,
+                                      uint8_t ucSocketOptions );
+#endif /* ( ( ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) || ( ipconfigUDP_BATCH_CALLS == 1 ) ) && ( ipconfigUSE_IPv4 != 0 ) ) */
+
+#if ( ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) && ( ipconfigUSE_IPv4 != 0 ) )
+
+/**
+ * @brief Complete a datagram for the peer of a connected socket with the cached headers.
+ */
+    static BaseType_t prvUDPConnectedHeaders( FreeRTOS_Socket_t * pxSocket,
+                                              NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                              size_t uxTotalDataLength );
+#endif /* ( ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) && ( ipconfigUSE_IPv4 != 0 ) ) */
+
+#if ( ipconfigUSE_TCP == 1 )
+
+/**
+ * @brief Called from FreeRTOS_connect(): wait until a TCP connection is established.
+ */
+    static BaseType_t prvTCPConnectWait( FreeRTOS_Socket_t * pxSocket );
+#endif /* ( ipconfigUSE_TCP == 1 ) */
+
 #if ( ipconfigUSE_CALLBACKS == 1 )
 
 /**
@@ -291,6 +466,34 @@ static BaseType_t prvMakeSureSocketIsBound( FreeRTOS_Socket_t * pxSocket );
                                                 const void * pvOptionValue );
 #endif /* ( ipconfigUSE_TCP != 0 ) */
 
+#if ( ( ipconfigUSE_TCP != 0 ) && ( ipconfigTCP_PACING == 1 ) )
+
+/**
+ * @brief Handle the socket option FREERTOS_SO_PACING_RATE.
+ */
+    static BaseType_t prvSetOptionPacingRate( FreeRTOS_Socket_t * pxSocket,
+                                              const void * pvOptionValue );
+#endif /* ( ( ipconfigUSE_TCP != 0 ) && ( ipconfigTCP_PACING == 1 ) ) */
+
+#if ( ( ipconfigUSE_TCP != 0 ) && ( ipconfigTCP_RX_BUFFER_LENDING == 1 ) )
+
+/**
+ * @brief Handle the socket option FREERTOS_SO_RX_BUFFER_LENDING.
+ */
+    static BaseType_t prvSetOptionRxBufferLending( FreeRTOS_Socket_t * pxSocket,
+                                                   const void * pvOptionValue );
+#endif /* ( ( ipconfigUSE_TCP != 0 ) && ( ipconfigTCP_RX_BUFFER_LENDING == 1 ) ) */
+
+#if ( ipconfigSUPPORT_IP_MULTICAST == 1 )
+
+/**
+ * @brief Handle the socket options that join or leave a multicast group.
+ */
+    static BaseType_t prvSetOptionMembership( const FreeRTOS_Socket_t * pxSocket,
+                                              int32_t lOptionName,
+                                              const void * pvOptionValue );
+#endif /* ( ipconfigSUPPORT_IP_MULTICAST == 1 ) */
+
 #if ( ipconfigUSE_TCP != 0 )
 
 /**
@@ -344,13 +547,37 @@ static int32_t prvRecvFrom_CopyPacket( uint8_t * pucEthernetBuffer,
                                        BaseType_t xFlags,
                                        int32_t lDataLength );
 
-static int32_t prvSendTo_ActualSend( const FreeRTOS_Socket_t * pxSocket,
-                                     const void * pvBuffer,
+static int32_t prvSendTo_ActualSend( FreeRTOS_Socket_t * pxSocket,
+                                     const struct freertos_iovec * pxIOVector,
+                                     size_t uxIOCount,
                                      size_t uxTotalDataLength,
                                      BaseType_t xFlags,
                                      const struct freertos_sockaddr * pxDestinationAddress,
                                      size_t uxPayloadOffset );
 
+static void prvSendToGather( uint8_t * pucTarget,
+                             const struct freertos_iovec * pxIOVector,
+                             size_t uxIOCount,
+                             size_t uxOffset,
+                             size_t uxLength );
+
+static int32_t prvSendToCommon( FreeRTOS_Socket_t * pxSocket,
+                                const struct freertos_iovec * pxIOVector,
+                                size_t uxIOCount,
+                                size_t uxTotalDataLength,
+                                BaseType_t xFlags,
+                                const struct freertos_sockaddr * pxDestinationAddress );
+
+static int32_t prvSendToGetPayloadOffset( const struct freertos_sockaddr * pxDestinationAddress,
+                                          size_t * puxMaxPayloadLength,
+                                          size_t * puxPayloadOffset );
+
+static void prvPrepareUDPPacket( const FreeRTOS_Socket_t * pxSocket,
+                                 NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                 size_t uxTotalDataLength,
+                                 const struct freertos_sockaddr * pxDestinationAddress,
+                                 size_t uxPayloadOffset );
+
 #if ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_CALLBACKS == 1 )
 
 /** @brief The application can attach callback functions to a socket. In this function,
@@ -596,6 +823,20 @@ static BaseType_t prvDetermineSocketSize( BaseType_t xDomain,
         /* The above values are just defaults, and can be overridden by
          * calling FreeRTOS_setsockopt().  No buffers will be allocated until a
          * socket is connected and data is exchanged. */
+
+        #if ( ipconfigTCP_ACCEPT_QUEUE == 1 )
+        {
+            vListInitialise( &( pxSocket->u.xTCP.xAcceptQueue ) );
+            vListInitialiseItem( &( pxSocket->u.xTCP.xAcceptItem ) );
+            listSET_LIST_ITEM_OWNER( &( pxSocket->u.xTCP.xAcceptItem ), ( void * ) pxSocket );
+        }
+        #endif
+
+        #if ( ipconfigTCP_RX_BUFFER_LENDING == 1 )
+        {
+            vListInitialise( &( pxSocket->u.xTCP.xRxLentList ) );
+        }
+        #endif
     }
 #endif /* ( ipconfigUSE_TCP == 1 ) */
 /*-----------------------------------------------------------*/
@@ -732,6 +973,12 @@ Socket_t FreeRTOS_socket( BaseType_t xDomain,
 
                 vListInitialise( &( pxSocket->u.xUDP.xWaitingPacketsList ) );
 
+                #if ( ipconfigUDP_BATCH_CALLS == 1 )
+                {
+                    vListInitialise( &( pxSocket->u.xUDP.xTxBatchList ) );
+                }
+                #endif
+
                 #if ( ipconfigUDP_MAX_RX_PACKETS > 0U )
                 {
                     pxSocket->u.xUDP.uxMaxPackets = ( UBaseType_t ) ipconfigUDP_MAX_RX_PACKETS;
@@ -753,6 +1000,13 @@ Socket_t FreeRTOS_socket( BaseType_t xDomain,
             vListInitialiseItem( &( pxSocket->xBoundSocketListItem ) );
             listSET_LIST_ITEM_OWNER( &( pxSocket->xBoundSocketListItem ), ( void * ) pxSocket );
 
+            #if ( ipconfigSELECT_READY_LIST == 1 )
+            {
+                vListInitialiseItem( &( pxSocket->xSelectReadyItem ) );
+                listSET_LIST_ITEM_OWNER( &( pxSocket->xSelectReadyItem ), ( void * ) pxSocket );
+            }
+            #endif
+
             pxSocket->xReceiveBlockTime = ipconfigSOCK_DEFAULT_RECEIVE_BLOCK_TIME;
             pxSocket->xSendBlockTime = ipconfigSOCK_DEFAULT_SEND_BLOCK_TIME;
             pxSocket->ucSocketOptions = ( uint8_t ) FREERTOS_SO_UDPCKSUM_OUT;
@@ -787,6 +1041,12 @@ Socket_t FreeRTOS_socket( BaseType_t xDomain,
             ( void ) memset( pxSocketSet, 0, sizeof( *pxSocketSet ) );
             pxSocketSet->xSelectGroup = xEventGroupCreate();
 
+            #if ( ipconfigSELECT_READY_LIST == 1 )
+            {
+                vListInitialise( &( pxSocketSet->xReadyList ) );
+            }
+            #endif
+
             if( pxSocketSet->xSelectGroup == NULL )
             {
                 vPortFree( pxSocketSet );
@@ -856,6 +1116,16 @@ Socket_t FreeRTOS_socket( BaseType_t xDomain,
 
         if( ( pxSocket->xSelectBits & ( ( EventBits_t ) eSELECT_ALL ) ) != ( EventBits_t ) 0U )
         {
+            #if ( ipconfigSELECT_READY_LIST == 1 )
+            {
+                if( pxSocket->pxSocketSet != pxSocketSet )
+                {
+                    /* The socket moves to another set, forget its pending events. */
+                    prvSocketSetNotReady( pxSocket );
+                }
+            }
+            #endif
+
             /* Adding a socket to a socket set. */
             pxSocket->pxSocketSet = ( SocketSelect_t * ) xSocketSet;
 
@@ -897,6 +1167,12 @@ Socket_t FreeRTOS_socket( BaseType_t xDomain,
         }
         else
         {
+            #if ( ipconfigSELECT_READY_LIST == 1 )
+            {
+                prvSocketSetNotReady( pxSocket );
+            }
+            #endif
+
             /* disconnect it from the socket set */
             pxSocket->pxSocketSet = NULL;
         }
@@ -1079,6 +1355,165 @@ Socket_t FreeRTOS_socket( BaseType_t xDomain,
 #endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigSELECT_READY_LIST == 1 )
+
+/**
+ * @brief Add events to a socket, and make sure that the socket is in the
+ *        ready list of its socket set. Called by the IP-task.
+ *
+ * @param[in] pxSocket The socket that has new events.
+ * @param[in] xSocketBits The select events that have occurred.
+ */
+    static void prvSocketSetReady( FreeRTOS_Socket_t * pxSocket,
+                                   EventBits_t xSocketBits )
+    {
+        /* The ready list is emptied by the user's task in FreeRTOS_select_ready(). */
+        vTaskSuspendAll();
+        {
+            pxSocket->xSocketBits |= xSocketBits;
+
+            if( listLIST_ITEM_CONTAINER( &( pxSocket->xSelectReadyItem ) ) == NULL )
+            {
+                vListInsertEnd( &( pxSocket->pxSocketSet->xReadyList ), &( pxSocket->xSelectReadyItem ) );
+            }
+        }
+        ( void ) xTaskResumeAll();
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Take a socket out of the ready list of its socket set, if it is in it.
+ *
+ * @param[in] pxSocket The socket to be removed.
+ */
+    static void prvSocketSetNotReady( FreeRTOS_Socket_t * pxSocket )
+    {
+        vTaskSuspendAll();
+        {
+            if( listLIST_ITEM_CONTAINER( &( pxSocket->xSelectReadyItem ) ) != NULL )
+            {
+                ( void ) uxListRemove( &( pxSocket->xSelectReadyItem ) );
+            }
+        }
+        ( void ) xTaskResumeAll();
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Wait until sockets in a socket set have events of interest, and return
+ *        those sockets along with their events.
+ *
+ * @param[in] xSocketSet The socket set to wait on.
+ * @param[out] pxReadySockets An array that will receive the sockets and their events.
+ * @param[in] xMaxCount The number of entries in 'pxReadySockets'.
+ * @param[in] xBlockTimeTicks Maximum time ticks to wait for an event to occur.
+ *                   If the value is 'portMAX_DELAY' then the function will wait
+ *                   indefinitely for an event to occur.
+ *
+ * @return The number of entries stored in 'pxReadySockets', zero in case of a
+ *         time-out. -pdFREERTOS_ERRNO_EINTR is returned when the socket set was
+ *         signalled while no socket was ready, and -pdFREERTOS_ERRNO_EINVAL
+ *         when a parameter is invalid.
+ *
+ * @note The cost of this function depends on the number of sockets that have
+ *       events, not on the number of sockets in the set. The sockets are
+ *       returned in the order in which their first pending event occurred.
+ */
+    BaseType_t FreeRTOS_select_ready( SocketSet_t xSocketSet,
+                                      SocketReady_t * pxReadySockets,
+                                      BaseType_t xMaxCount,
+                                      TickType_t xBlockTimeTicks )
+    {
+        TimeOut_t xTimeOut;
+        TickType_t xRemainingTime = xBlockTimeTicks;
+        SocketSelect_t * pxSocketSet = ( SocketSelect_t * ) xSocketSet;
+        FreeRTOS_Socket_t * pxSocket;
+        EventBits_t xEvents;
+        BaseType_t xCount = 0;
+
+        configASSERT( xSocketSet != NULL );
+
+        if( ( pxReadySockets == NULL ) || ( xMaxCount <= 0 ) )
+        {
+            xCount = -pdFREERTOS_ERRNO_EINVAL;
+        }
+        else
+        {
+            vTaskSetTimeOutState( &xTimeOut );
+
+            for( ; ; )
+            {
+                vTaskSuspendAll();
+                {
+                    while( ( xCount < xMaxCount ) && ( listLIST_IS_EMPTY( &( pxSocketSet->xReadyList ) ) == pdFALSE ) )
+                    {
+                        pxSocket = ( ( FreeRTOS_Socket_t * ) listGET_OWNER_OF_HEAD_ENTRY( &( pxSocketSet->xReadyList ) ) );
+                        ( void ) uxListRemove( &( pxSocket->xSelectReadyItem ) );
+
+                        /* Only report the events that the user asked for. */
+                        xEvents = pxSocket->xSocketBits & pxSocket->xSelectBits & ( ( EventBits_t ) eSELECT_ALL );
+
+                        if( xEvents != 0U )
+                        {
+                            pxReadySockets[ xCount ].xSocket = ( Socket_t ) pxSocket;
+                            pxReadySockets[ xCount ].xEvents = xEvents;
+
+                            /* Consume the reported events only, the other bits are
+                             * still looked-up by FreeRTOS_FD_ISSET(). */
+                            pxSocket->xSocketBits &= ~xEvents;
+                            xCount++;
+                        }
+                    }
+
+                    if( listLIST_IS_EMPTY( &( pxSocketSet->xReadyList ) ) != pdFALSE )
+                    {
+                        /* All events have been reported, the next call must block
+                         * until the IP-task reports a new event. */
+                        ( void ) xEventGroupClearBits( pxSocketSet->xSelectGroup,
+                                                       ( EventBits_t ) eSELECT_READ | ( EventBits_t ) eSELECT_WRITE | ( EventBits_t ) eSELECT_EXCEPT );
+                    }
+                }
+                ( void ) xTaskResumeAll();
+
+                if( xCount != 0 )
+                {
+                    break;
+                }
+
+                /* Has the timeout been reached? */
+                if( xTaskCheckForTimeOut( &xTimeOut, &xRemainingTime ) != pdFALSE )
+                {
+                    break;
+                }
+
+                #if ( ipconfigSUPPORT_SIGNALS != 0 )
+                {
+                    EventBits_t uxResult;
+
+                    uxResult = xEventGroupWaitBits( pxSocketSet->xSelectGroup, ( ( EventBits_t ) eSELECT_ALL ), pdFALSE, pdFALSE, xRemainingTime );
+
+                    if( ( uxResult & ( ( EventBits_t ) eSELECT_INTR ) ) != 0U )
+                    {
+                        ( void ) xEventGroupClearBits( pxSocketSet->xSelectGroup, ( EventBits_t ) eSELECT_INTR );
+                        FreeRTOS_debug_printf( ( "FreeRTOS_select_ready: interrupted\n" ) );
+                        xCount = -pdFREERTOS_ERRNO_EINTR;
+                        break;
+                    }
+                }
+                #else
+                {
+                    ( void ) xEventGroupWaitBits( pxSocketSet->xSelectGroup, ( ( EventBits_t ) eSELECT_ALL ), pdFALSE, pdFALSE, xRemainingTime );
+                }
+                #endif /* ipconfigSUPPORT_SIGNALS */
+            }
+        }
+
+        return xCount;
+    }
+
+#endif /* ipconfigSELECT_READY_LIST == 1 */
+/*-----------------------------------------------------------*/
+
 /**
  * @brief : called from FreeRTOS_recvfrom(). This function waits for an incoming
  *          UDP packet, or until a time-out occurs.
@@ -1386,27 +1821,20 @@ static BaseType_t prvMakeSureSocketIsBound( FreeRTOS_Socket_t * pxSocket )
 
 
 /**
- * @brief Forward a UDP packet to the IP-task, so it will be sent.
+ * @brief Fill in the addresses, the length and the socket options of a UDP
+ *        packet, before it is passed to the IP-task.
  * @param[in] pxSocket  The socket on which a packet is sent.
  * @param[in] pxNetworkBuffer  The packet to be sent.
  * @param[in] uxTotalDataLength  The total number of payload bytes in the packet.
- * @param[in] xFlags  The flag 'FREERTOS_ZERO_COPY' will be checked.
  * @param[in] pxDestinationAddress  The address of the destination.
- * @param[in] xTicksToWait  Number of ticks to wait, in case the IP-queue is full.
  * @param[in] uxPayloadOffset  The number of bytes in the packet before the payload.
- * @return The number of bytes sent on success, otherwise zero.
  */
-static int32_t prvSendUDPPacket( const FreeRTOS_Socket_t * pxSocket,
+static void prvPrepareUDPPacket( const FreeRTOS_Socket_t * pxSocket,
                                  NetworkBufferDescriptor_t * pxNetworkBuffer,
                                  size_t uxTotalDataLength,
-                                 BaseType_t xFlags,
                                  const struct freertos_sockaddr * pxDestinationAddress,
-                                 TickType_t xTicksToWait,
                                  size_t uxPayloadOffset )
 {
-    int32_t lReturn = 0;
-    IPStackEvent_t xStackTxEvent = { eStackTxEvent, NULL };
-
     switch( pxDestinationAddress->sin_family ) /* LCOV_EXCL_BR_LINE Exclude this line because default case is checked before calling. */
     {
         #if ( ipconfigUSE_IPv6 != 0 )
@@ -1433,26 +1861,71 @@ static int32_t prvSendUDPPacket( const FreeRTOS_Socket_t * pxSocket,
     /* The socket options are passed to the IP layer in the
      * space that will eventually get used by the Ethernet header. */
     pxNetworkBuffer->pucEthernetBuffer[ ipSOCKET_OPTIONS_OFFSET ] = pxSocket->ucSocketOptions;
+}
+/*-----------------------------------------------------------*/
 
-    /* Tell the networking task that the packet needs sending. */
-    xStackTxEvent.pvData = pxNetworkBuffer;
-
-    /* Ask the IP-task to send this packet */
-    if( xSendEventStructToIPTask( &xStackTxEvent, xTicksToWait ) == pdPASS )
-    {
-        /* The packet was successfully sent to the IP task. */
-        lReturn = ( int32_t ) uxTotalDataLength;
-        #if ( ipconfigUSE_CALLBACKS == 1 )
-        {
-            if( ipconfigIS_VALID_PROG_ADDRESS( pxSocket->u.xUDP.pxHandleSent ) )
-            {
-                pxSocket->u.xUDP.pxHandleSent( ( FreeRTOS_Socket_t * ) pxSocket, uxTotalDataLength );
-            }
-        }
-        #endif /* ipconfigUSE_CALLBACKS */
-    }
-    else
-    {
+/**
+ * @brief Forward a UDP packet to the IP-task, so it will be sent.
+ * @param[in] pxSocket  The socket on which a packet is sent.
+ * @param[in] pxNetworkBuffer  The packet to be sent.
+ * @param[in] uxTotalDataLength  The total number of payload bytes in the packet.
+ * @param[in] xFlags  The flag 'FREERTOS_ZERO_COPY' will be checked.
+ * @param[in] pxDestinationAddress  The address of the destination.
+ * @param[in] xTicksToWait  Number of ticks to wait, in case the IP-queue is full.
+ * @param[in] uxPayloadOffset  The number of bytes in the packet before the payload.
+ * @return The number of bytes sent on success, otherwise zero.
+ */
+static int32_t prvSendUDPPacket( FreeRTOS_Socket_t * pxSocket,
+                                 NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                 size_t uxTotalDataLength,
+                                 BaseType_t xFlags,
+                                 const struct freertos_sockaddr * pxDestinationAddress,
+                                 TickType_t xTicksToWait,
+                                 size_t uxPayloadOffset )
+{
+    int32_t lReturn = 0;
+    IPStackEvent_t xStackTxEvent;
+
+    xStackTxEvent.eEventType = eStackTxEvent;
+    xStackTxEvent.pvData = NULL;
+
+    #if ( ipconfigUSE_IP_TASK_PROFILING == 1 )
+        /* Stamped by xSendEventStructToIPTask(). */
+        xStackTxEvent.ullPostTime = 0U;
+    #endif
+
+    #if ( ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) && ( ipconfigUSE_IPv4 != 0 ) )
+        if( ( pxDestinationAddress == &( pxSocket->u.xUDP.xRemoteAddress ) ) &&
+            ( prvUDPConnectedHeaders( pxSocket, pxNetworkBuffer, uxTotalDataLength ) == pdTRUE ) )
+        {
+            /* The packet is complete, the IP-task can pass it to the driver. */
+            xStackTxEvent.eEventType = eNetworkTxEvent;
+        }
+        else
+    #endif /* ( ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) && ( ipconfigUSE_IPv4 != 0 ) ) */
+    {
+        prvPrepareUDPPacket( pxSocket, pxNetworkBuffer, uxTotalDataLength, pxDestinationAddress, uxPayloadOffset );
+    }
+
+    /* Tell the networking task that the packet needs sending. */
+    xStackTxEvent.pvData = pxNetworkBuffer;
+
+    /* Ask the IP-task to send this packet */
+    if( xSendEventStructToIPTask( &xStackTxEvent, xTicksToWait ) == pdPASS )
+    {
+        /* The packet was successfully sent to the IP task. */
+        lReturn = ( int32_t ) uxTotalDataLength;
+        #if ( ipconfigUSE_CALLBACKS == 1 )
+        {
+            if( ipconfigIS_VALID_PROG_ADDRESS( pxSocket->u.xUDP.pxHandleSent ) )
+            {
+                pxSocket->u.xUDP.pxHandleSent( ( FreeRTOS_Socket_t * ) pxSocket, uxTotalDataLength );
+            }
+        }
+        #endif /* ipconfigUSE_CALLBACKS */
+    }
+    else
+    {
         /* If the buffer was allocated in this function, release
          * it. */
         if( ( ( UBaseType_t ) xFlags & ( UBaseType_t ) FREERTOS_ZERO_COPY ) == 0U )
@@ -1460,7 +1933,7 @@ static int32_t prvSendUDPPacket( const FreeRTOS_Socket_t * pxSocket,
             vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
         }
 
-        iptraceSTACK_TX_EVENT_LOST( ipSTACK_TX_EVENT );
+        iptraceSTACK_TX_EVENT_LOST( eStackTxEvent );
     }
 
     return lReturn;
@@ -1468,10 +1941,13 @@ static int32_t prvSendUDPPacket( const FreeRTOS_Socket_t * pxSocket,
 /*-----------------------------------------------------------*/
 
 /**
- * @brief Called by FreeRTOS_sendto(), it will actually send a UDP packet.
+ * @brief Called by prvSendToCommon(), it will actually send a UDP packet.
  * @param[in] pxSocket The socket used for sending.
- * @param[in] pvBuffer The character buffer as provided by the caller.
- * @param[in] uxTotalDataLength The number of byte in the buffer.
+ * @param[in] pxIOVector The buffers as provided by the caller. With
+ *                       FREERTOS_ZERO_COPY, it is a single buffer that
+ *                       points to the payload of a network buffer.
+ * @param[in] uxIOCount The number of buffers in 'pxIOVector'.
+ * @param[in] uxTotalDataLength The total number of bytes in the buffers.
  * @param[in] xFlags The flags that were passed to FreeRTOS_sendto()
  *                    It will test for FREERTOS_MSG_DONTWAIT and for
  *                    FREERTOS_ZERO_COPY.
@@ -1480,8 +1956,9 @@ static int32_t prvSendUDPPacket( const FreeRTOS_Socket_t * pxSocket,
  *                             on the IP type: IPv4 or IPv6.
  * @return The number of bytes stored in the socket for transmission.
  */
-static int32_t prvSendTo_ActualSend( const FreeRTOS_Socket_t * pxSocket,
-                                     const void * pvBuffer,
+static int32_t prvSendTo_ActualSend( FreeRTOS_Socket_t * pxSocket,
+                                     const struct freertos_iovec * pxIOVector,
+                                     size_t uxIOCount,
                                      size_t uxTotalDataLength,
                                      BaseType_t xFlags,
                                      const struct freertos_sockaddr * pxDestinationAddress,
@@ -1512,8 +1989,7 @@ static int32_t prvSendTo_ActualSend( const FreeRTOS_Socket_t * pxSocket,
 
         if( pxNetworkBuffer != NULL )
         {
-            void * pvCopyDest = ( void * ) &( pxNetworkBuffer->pucEthernetBuffer[ uxPayloadOffset ] );
-            ( void ) memcpy( pvCopyDest, pvBuffer, uxTotalDataLength );
+            prvSendToGather( &( pxNetworkBuffer->pucEthernetBuffer[ uxPayloadOffset ] ), pxIOVector, uxIOCount, 0U, uxTotalDataLength );
 
             if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdTRUE )
             {
@@ -1527,7 +2003,7 @@ static int32_t prvSendTo_ActualSend( const FreeRTOS_Socket_t * pxSocket,
         /* When zero copy is used, pvBuffer is a pointer to the
          * payload of a buffer that has already been obtained from the
          * stack.  Obtain the network buffer pointer from the buffer. */
-        pxNetworkBuffer = pxUDPPayloadBuffer_to_NetworkBuffer( pvBuffer );
+        pxNetworkBuffer = pxUDPPayloadBuffer_to_NetworkBuffer( pxIOVector[ 0 ].iov_base );
     }
 
     if( pxNetworkBuffer != NULL )
@@ -1554,6 +2030,205 @@ static int32_t prvSendTo_ActualSend( const FreeRTOS_Socket_t * pxSocket,
 }
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Determine the maximum UDP payload length and the offset of the payload
+ *        in a network buffer, for a given destination address.
+ * @param[in] pxDestinationAddress The address to which the data is to be sent.
+ * @param[out] puxMaxPayloadLength The maximum number of bytes in a UDP payload.
+ * @param[out] puxPayloadOffset The number of bytes in the packet before the payload.
+ * @return Zero on success, or -pdFREERTOS_ERRNO_EINVAL when the address family
+ *         is not supported.
+ */
+static int32_t prvSendToGetPayloadOffset( const struct freertos_sockaddr * pxDestinationAddress,
+                                          size_t * puxMaxPayloadLength,
+                                          size_t * puxPayloadOffset )
+{
+    int32_t lReturn = 0;
+
+    switch( pxDestinationAddress->sin_family )
+    {
+        #if ( ipconfigUSE_IPv6 != 0 )
+            case FREERTOS_AF_INET6:
+                *puxMaxPayloadLength = ipconfigNETWORK_MTU - ( ipSIZE_OF_IPv6_HEADER + ipSIZE_OF_UDP_HEADER );
+                *puxPayloadOffset = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER + ipSIZE_OF_UDP_HEADER;
+                break;
+        #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+
+        #if ( ipconfigUSE_IPv4 != 0 )
+            case FREERTOS_AF_INET4:
+                *puxMaxPayloadLength = ipconfigNETWORK_MTU - ( ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_UDP_HEADER );
+                *puxPayloadOffset = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_UDP_HEADER;
+                break;
+        #endif /* ( ipconfigUSE_IPv4 != 0 ) */
+
+        default:
+            FreeRTOS_debug_printf( ( "FreeRTOS_sendto: Undefined sin_family \n" ) );
+            lReturn = -pdFREERTOS_ERRNO_EINVAL;
+            break;
+    }
+
+    return lReturn;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Copy a part of the data of an I/O vector to a network buffer.
+ *
+ * @param[in] pucTarget Where the data must be copied to.
+ * @param[in] pxIOVector The buffers that hold the data.
+ * @param[in] uxIOCount The number of buffers in 'pxIOVector'.
+ * @param[in] uxOffset The offset of the first byte to copy, counted from the
+ *                     start of the first buffer.
+ * @param[in] uxLength The number of bytes to copy.
+ */
+static void prvSendToGather( uint8_t * pucTarget,
+                             const struct freertos_iovec * pxIOVector,
+                             size_t uxIOCount,
+                             size_t uxOffset,
+                             size_t uxLength )
+{
+    size_t uxIndex;
+    size_t uxSkip = uxOffset;
+    size_t uxCopied = 0U;
+
+    for( uxIndex = 0U; ( uxIndex < uxIOCount ) && ( uxCopied < uxLength ); uxIndex++ )
+    {
+        size_t uxBufferLength = pxIOVector[ uxIndex ].iov_len;
+
+        if( uxSkip >= uxBufferLength )
+        {
+            /* This buffer lies entirely before the offset. */
+            uxSkip -= uxBufferLength;
+        }
+        else
+        {
+            const uint8_t * pucSource = ( const uint8_t * ) pxIOVector[ uxIndex ].iov_base;
+            size_t uxCount = uxBufferLength - uxSkip;
+
+            if( uxCount > ( uxLength - uxCopied ) )
+            {
+                uxCount = uxLength - uxCopied;
+            }
+
+            ( void ) memcpy( &( pucTarget[ uxCopied ] ), &( pucSource[ uxSkip ] ), uxCount );
+            uxCopied += uxCount;
+            uxSkip = 0U;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The part of FreeRTOS_sendto() and FreeRTOS_sendmsg() that does not
+ *        depend on the way the caller passes the data.
+ *
+ * @param[in] pxSocket The socket being sent to.
+ * @param[in] pxIOVector The buffers that hold the data.
+ * @param[in] uxIOCount The number of buffers in 'pxIOVector'.
+ * @param[in] uxTotalDataLength The total number of bytes in the buffers.
+ * @param[in] xFlags Possibly FREERTOS_MSG_DONTWAIT and/or FREERTOS_ZERO_COPY.
+ * @param[in] pxDestinationAddress The address to which the data is to be sent.
+ *                                  It may be NULL for a connected UDP socket.
+ *
+ * @return When positive: the total number of bytes sent, when negative an error
+ *         has occurred.
+ */
+static int32_t prvSendToCommon( FreeRTOS_Socket_t * pxSocket,
+                                const struct freertos_iovec * pxIOVector,
+                                size_t uxIOCount,
+                                size_t uxTotalDataLength,
+                                BaseType_t xFlags,
+                                const struct freertos_sockaddr * pxDestinationAddress )
+{
+    int32_t lReturn = 0;
+    size_t uxMaxPayloadLength = 0;
+    size_t uxPayloadOffset = 0;
+    BaseType_t xSegmented = pdFALSE;
+
+    #if ( ipconfigIPv4_BACKWARD_COMPATIBLE == 1 )
+        struct freertos_sockaddr xTempDestinationAddress;
+
+        if( ( pxDestinationAddress != NULL ) && ( pxDestinationAddress->sin_family != FREERTOS_AF_INET6 ) && ( pxDestinationAddress->sin_family != FREERTOS_AF_INET ) )
+        {
+            ( void ) memcpy( &xTempDestinationAddress, pxDestinationAddress, sizeof( struct freertos_sockaddr ) );
+
+            /* Default to FREERTOS_AF_INET family if either FREERTOS_AF_INET6/FREERTOS_AF_INET
+             *  is not specified in sin_family, if ipconfigIPv4_BACKWARD_COMPATIBLE is enabled. */
+            xTempDestinationAddress.sin_family = FREERTOS_AF_INET;
+            pxDestinationAddress = &xTempDestinationAddress;
+        }
+    #endif /* ( ipconfigIPv4_BACKWARD_COMPATIBLE == 1 ) */
+
+    #if ( ipconfigUDP_CONNECTED_SOCKETS == 1 )
+        if( pxDestinationAddress == NULL )
+        {
+            /* A connected socket sends to its peer. */
+            pxDestinationAddress = prvUDPConnectedPeer( pxSocket );
+        }
+    #endif /* ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) */
+
+    if( pxDestinationAddress == NULL )
+    {
+        /* No address was given, and the socket is not connected. */
+        lReturn = -pdFREERTOS_ERRNO_EINVAL;
+    }
+    else
+    {
+        lReturn = prvSendToGetPayloadOffset( pxDestinationAddress, &( uxMaxPayloadLength ), &( uxPayloadOffset ) );
+    }
+
+    if( lReturn == 0 )
+    {
+        #if ( ipconfigUDP_GSO == 1 )
+        {
+            if( ( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_UDP ) &&
+                ( pxSocket->u.xUDP.uxSegmentSize != 0U ) &&
+                ( uxTotalDataLength > pxSocket->u.xUDP.uxSegmentSize ) )
+            {
+                /* The data will be split into several datagrams. */
+                xSegmented = pdTRUE;
+
+                if( prvMakeSureSocketIsBound( pxSocket ) == pdTRUE )
+                {
+                    lReturn = prvSendToSegmented( pxSocket, pxIOVector, uxIOCount, uxTotalDataLength, xFlags, pxDestinationAddress, uxMaxPayloadLength, uxPayloadOffset );
+                }
+                else
+                {
+                    iptraceSENDTO_SOCKET_NOT_BOUND();
+                }
+            }
+        }
+        #endif /* ( ipconfigUDP_GSO == 1 ) */
+
+        if( xSegmented == pdFALSE )
+        {
+            if( uxTotalDataLength <= ( size_t ) uxMaxPayloadLength )
+            {
+                /* If the socket is not already bound to an address, bind it now.
+                 * Passing NULL as the address parameter tells FreeRTOS_bind() to select
+                 * the address to bind to. */
+                if( prvMakeSureSocketIsBound( pxSocket ) == pdTRUE )
+                {
+                    lReturn = prvSendTo_ActualSend( pxSocket, pxIOVector, uxIOCount, uxTotalDataLength, xFlags, pxDestinationAddress, uxPayloadOffset );
+                }
+                else
+                {
+                    /* No comment. */
+                    iptraceSENDTO_SOCKET_NOT_BOUND();
+                }
+            }
+            else
+            {
+                /* The data is longer than the available buffer space. */
+                iptraceSENDTO_DATA_TOO_LONG();
+            }
+        }
+    }
+
+    return lReturn;
+}
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Send data to a socket. The socket must have already been created by a
  *        successful call to FreeRTOS_socket(). It works for UDP-sockets only.
@@ -1564,6 +2239,7 @@ static int32_t prvSendTo_ActualSend( const FreeRTOS_Socket_t * pxSocket,
  * @param[in] xFlags Flags used to communicate preferences to the function.
  *                    Possibly FREERTOS_MSG_DONTWAIT and/or FREERTOS_ZERO_COPY.
  * @param[in] pxDestinationAddress The address to which the data is to be sent.
+ *                                  It may be NULL for a connected UDP socket.
  * @param[in] xDestinationAddressLength This parameter is present to adhere to the
  *                  Berkeley sockets standard. Else, it is not used.
  *
@@ -1577,80 +2253,695 @@ int32_t FreeRTOS_sendto( Socket_t xSocket,
                          const struct freertos_sockaddr * pxDestinationAddress,
                          socklen_t xDestinationAddressLength )
 {
-    int32_t lReturn = 0;
     FreeRTOS_Socket_t * pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
-    size_t uxMaxPayloadLength = 0;
-    size_t uxPayloadOffset = 0;
-
-    #if ( ipconfigIPv4_BACKWARD_COMPATIBLE == 1 )
-        struct freertos_sockaddr xTempDestinationAddress;
-
-        if( ( pxDestinationAddress != NULL ) && ( pxDestinationAddress->sin_family != FREERTOS_AF_INET6 ) && ( pxDestinationAddress->sin_family != FREERTOS_AF_INET ) )
-        {
-            ( void ) memcpy( &xTempDestinationAddress, pxDestinationAddress, sizeof( struct freertos_sockaddr ) );
-
-            /* Default to FREERTOS_AF_INET family if either FREERTOS_AF_INET6/FREERTOS_AF_INET
-             *  is not specified in sin_family, if ipconfigIPv4_BACKWARD_COMPATIBLE is enabled. */
-            xTempDestinationAddress.sin_family = FREERTOS_AF_INET;
-            pxDestinationAddress = &xTempDestinationAddress;
-        }
-    #endif /* ( ipconfigIPv4_BACKWARD_COMPATIBLE == 1 ) */
+    struct freertos_iovec xVector;
 
     /* The function prototype is designed to maintain the expected Berkeley
      * sockets standard, but this implementation does not use all the
      * parameters. */
     ( void ) xDestinationAddressLength;
-    configASSERT( pxDestinationAddress != NULL );
+
+    #if ( ipconfigUDP_CONNECTED_SOCKETS == 0 )
+        configASSERT( pxDestinationAddress != NULL );
+    #endif
+
     configASSERT( pvBuffer != NULL );
 
-    switch( pxDestinationAddress->sin_family )
+    /* The data is not modified, the cast is needed because 'iov_base' is
+     * not const. */
+    xVector.iov_base = ( void * ) pvBuffer;
+    xVector.iov_len = uxTotalDataLength;
+
+    return prvSendToCommon( pxSocket, &( xVector ), 1U, uxTotalDataLength, xFlags, pxDestinationAddress );
+} /* Tested */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigSOCKET_IOVEC_CALLS == 1 )
+
+/**
+ * @brief Check the buffers of an I/O vector and add up their lengths.
+ *
+ * @param[in] pxIOVector The array of buffers.
+ * @param[in] uxIOCount The number of buffers in the array.
+ * @param[out] puxTotal The total number of bytes.
+ *
+ * @return pdTRUE when the vector is valid, otherwise pdFALSE.
+ */
+    static BaseType_t prvIOVectorLength( const struct freertos_iovec * pxIOVector,
+                                         size_t uxIOCount,
+                                         size_t * puxTotal )
     {
-        #if ( ipconfigUSE_IPv6 != 0 )
-            case FREERTOS_AF_INET6:
-                uxMaxPayloadLength = ipconfigNETWORK_MTU - ( ipSIZE_OF_IPv6_HEADER + ipSIZE_OF_UDP_HEADER );
-                uxPayloadOffset = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER + ipSIZE_OF_UDP_HEADER;
-                break;
-        #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+        BaseType_t xValid = pdFALSE;
+        size_t uxTotal = 0U;
+        size_t uxIndex;
+
+        if( ( pxIOVector != NULL ) && ( uxIOCount > 0U ) )
+        {
+            xValid = pdTRUE;
+
+            for( uxIndex = 0U; uxIndex < uxIOCount; uxIndex++ )
+            {
+                if( ( ( pxIOVector[ uxIndex ].iov_base == NULL ) && ( pxIOVector[ uxIndex ].iov_len != 0U ) ) ||
+                    ( ( uxTotal + pxIOVector[ uxIndex ].iov_len ) < uxTotal ) )
+                {
+                    /* A NULL buffer, or the total length wraps around. */
+                    xValid = pdFALSE;
+                    break;
+                }
+
+                uxTotal += pxIOVector[ uxIndex ].iov_len;
+            }
+        }
+
+        *puxTotal = uxTotal;
+
+        return xValid;
+    }
+#endif /* ( ipconfigSOCKET_IOVEC_CALLS == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigSOCKET_IOVEC_CALLS == 1 )
+
+/**
+ * @brief Send a UDP datagram whose payload is gathered from several buffers.
+ *        The buffers are copied into a single network buffer. Otherwise it
+ *        behaves like FreeRTOS_sendto(): a socket with a segment size splits
+ *        the data into several datagrams.
+ *
+ * @param[in] xSocket The socket being used to send the data.
+ * @param[in] pxIOVector The buffers that form the payload.
+ * @param[in] uxIOCount The number of buffers in 'pxIOVector'.
+ * @param[in] xFlags Zero or FREERTOS_MSG_DONTWAIT. FREERTOS_ZERO_COPY is not
+ *                   supported.
+ * @param[in] pxDestinationAddress The address to which the data is to be sent.
+ * @param[in] xDestinationAddressLength This parameter is present to adhere to the
+ *                                      Berkeley sockets standard. Else, it is not used.
+ *
+ * @return The number of bytes queued for transmission, or zero if the
+ *         datagram was not sent, or -pdFREERTOS_ERRNO_EINVAL in case of
+ *         bad parameters.
+ */
+    int32_t FreeRTOS_sendmsg( Socket_t xSocket,
+                              const struct freertos_iovec * pxIOVector,
+                              size_t uxIOCount,
+                              BaseType_t xFlags,
+                              const struct freertos_sockaddr * pxDestinationAddress,
+                              socklen_t xDestinationAddressLength )
+    {
+        int32_t lReturn = -pdFREERTOS_ERRNO_EINVAL;
+        FreeRTOS_Socket_t * pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+        size_t uxTotalDataLength = 0U;
+
+        ( void ) xDestinationAddressLength;
+
+        if( ( ( ( UBaseType_t ) xFlags & ( UBaseType_t ) FREERTOS_ZERO_COPY ) == 0U ) &&
+            ( prvIOVectorLength( pxIOVector, uxIOCount, &( uxTotalDataLength ) ) != pdFALSE ) )
+        {
+            /* From here on, the datagram is handled like in FreeRTOS_sendto(),
+             * which also looks up the peer of a connected socket. */
+            lReturn = prvSendToCommon( pxSocket, pxIOVector, uxIOCount, uxTotalDataLength, xFlags, pxDestinationAddress );
+        }
+
+        return lReturn;
+    }
+#endif /* ( ipconfigSOCKET_IOVEC_CALLS == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUDP_BATCH_CALLS == 1 )
+
+/**
+ * @brief Move prepared UDP packets to the batch list of a socket and wake up
+ *        the IP-task. When the list of the socket was not empty, an event is
+ *        already pending for it.
+ *
+ * @param[in] pxSocket The UDP socket.
+ * @param[in] pxPacketList The prepared packets, the list will be emptied.
+ * @param[in] xTicksToWait The time to wait when the IP-queue is full.
+ *
+ * @return pdPASS when the IP-task will send the packets, pdFAIL when they
+ *         had to be dropped.
+ */
+    static BaseType_t prvSendBatchHandOver( FreeRTOS_Socket_t * pxSocket,
+                                            List_t * pxPacketList,
+                                            TickType_t xTicksToWait )
+    {
+        BaseType_t xReturn = pdPASS;
+        BaseType_t xWasEmpty;
+        NetworkBufferDescriptor_t * pxNetworkBuffer;
+        IPStackEvent_t xBatchEvent;
+
+        xBatchEvent.eEventType = eSocketTxBatchEvent;
+        xBatchEvent.pvData = NULL;
+
+        #if ( ipconfigUSE_IP_TASK_PROFILING == 1 )
+            /* Stamped by xSendEventStructToIPTask(). */
+            xBatchEvent.ullPostTime = 0U;
+        #endif
+
+        vTaskSuspendAll();
+        {
+            xWasEmpty = listLIST_IS_EMPTY( &( pxSocket->u.xUDP.xTxBatchList ) );
+
+            while( listLIST_IS_EMPTY( pxPacketList ) == pdFALSE )
+            {
+                pxNetworkBuffer = ( ( NetworkBufferDescriptor_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxPacketList ) );
+                ( void ) uxListRemove( &( pxNetworkBuffer->xBufferListItem ) );
+                vListInsertEnd( &( pxSocket->u.xUDP.xTxBatchList ), &( pxNetworkBuffer->xBufferListItem ) );
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        if( xWasEmpty != pdFALSE )
+        {
+            xBatchEvent.pvData = pxSocket;
+
+            if( xSendEventStructToIPTask( &xBatchEvent, xTicksToWait ) != pdPASS )
+            {
+                /* Nobody will send the packets, drop them. */
+                vTaskSuspendAll();
+                {
+                    while( listLIST_IS_EMPTY( &( pxSocket->u.xUDP.xTxBatchList ) ) == pdFALSE )
+                    {
+                        pxNetworkBuffer = ( ( NetworkBufferDescriptor_t * ) listGET_OWNER_OF_HEAD_ENTRY( &( pxSocket->u.xUDP.xTxBatchList ) ) );
+                        ( void ) uxListRemove( &( pxNetworkBuffer->xBufferListItem ) );
+                        vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+                    }
+                }
+                ( void ) xTaskResumeAll();
+
+                iptraceSTACK_TX_EVENT_LOST( eStackTxEvent );
+                xReturn = pdFAIL;
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUDP_GSO == 1 )
+
+/**
+ * @brief Called by prvSendToCommon() when the data is larger than the segment
+ *        size of the socket: split the data into datagrams and pass them to the
+ *        IP-task with a single message.
+ *
+ * @param[in] pxSocket The UDP socket, it is already bound.
+ * @param[in] pxIOVector The buffers that hold the data to be sent.
+ * @param[in] uxIOCount The number of buffers in 'pxIOVector'.
+ * @param[in] uxTotalDataLength The total number of bytes in 'pxIOVector'.
+ * @param[in] xFlags Zero or FREERTOS_MSG_DONTWAIT.
+ * @param[in] pxDestinationAddress The address to which the data is to be sent.
+ * @param[in] uxMaxPayloadLength The maximum size of a datagram.
+ * @param[in] uxPayloadOffset The offset of the UDP payload in a packet.
+ *
+ * @return The number of bytes queued, which is always a multiple of the
+ *         segment size unless all data was queued. A negative error code
+ *         is returned when not a single datagram could be queued.
+ */
+        static int32_t prvSendToSegmented( FreeRTOS_Socket_t * pxSocket,
+                                           const struct freertos_iovec * pxIOVector,
+                                           size_t uxIOCount,
+                                           size_t uxTotalDataLength,
+                                           BaseType_t xFlags,
+                                           const struct freertos_sockaddr * pxDestinationAddress,
+                                           size_t uxMaxPayloadLength,
+                                           size_t uxPayloadOffset )
+        {
+            int32_t lReturn = 0;
+            size_t uxSegmentSize = pxSocket->u.xUDP.uxSegmentSize;
+            size_t uxOffset = 0U;
+            TickType_t xTicksToWait = ( TickType_t ) 0U;
+            TimeOut_t xTimeOut;
+            List_t xPacketList;
+            NetworkBufferDescriptor_t * pxNetworkBuffer;
+
+            if( ( uxSegmentSize > uxMaxPayloadLength ) ||
+                ( ( ( UBaseType_t ) xFlags & ( UBaseType_t ) FREERTOS_ZERO_COPY ) != 0U ) )
+            {
+                iptraceSENDTO_DATA_TOO_LONG();
+                lReturn = -pdFREERTOS_ERRNO_EINVAL;
+            }
+            else
+            {
+                vListInitialise( &( xPacketList ) );
+
+                if( ( ( ( UBaseType_t ) xFlags & ( UBaseType_t ) FREERTOS_MSG_DONTWAIT ) == 0U ) &&
+                    ( xIsCallingFromIPTask() == pdFALSE ) )
+                {
+                    xTicksToWait = pxSocket->xSendBlockTime;
+                }
+
+                vTaskSetTimeOutState( &xTimeOut );
+
+                while( uxOffset < uxTotalDataLength )
+                {
+                    size_t uxLength = FreeRTOS_min_size_t( uxSegmentSize, uxTotalDataLength - uxOffset );
+
+                    pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( uxPayloadOffset + uxLength, xTicksToWait );
+
+                    if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdTRUE )
+                    {
+                        /* The entire block time has been used up. */
+                        xTicksToWait = ( TickType_t ) 0;
+                    }
+
+                    if( pxNetworkBuffer == NULL )
+                    {
+                        iptraceNO_BUFFER_FOR_SENDTO();
+                        break;
+                    }
+
+                    prvSendToGather( &( pxNetworkBuffer->pucEthernetBuffer[ uxPayloadOffset ] ), pxIOVector, uxIOCount, uxOffset, uxLength );
+                    pxNetworkBuffer->pxEndPoint = pxSocket->pxEndPoint;
+                    prvPrepareUDPPacket( pxSocket, pxNetworkBuffer, uxLength, pxDestinationAddress, uxPayloadOffset );
+                    vListInsertEnd( &( xPacketList ), &( pxNetworkBuffer->xBufferListItem ) );
+                    uxOffset += uxLength;
+                }
+
+                if( listLIST_IS_EMPTY( &( xPacketList ) ) != pdFALSE )
+                {
+                    lReturn = -pdFREERTOS_ERRNO_ENOBUFS;
+                }
+                else if( prvSendBatchHandOver( pxSocket, &( xPacketList ), xTicksToWait ) == pdPASS )
+                {
+                    lReturn = ( int32_t ) uxOffset;
+
+                    #if ( ipconfigUSE_CALLBACKS == 1 )
+                    {
+                        if( ipconfigIS_VALID_PROG_ADDRESS( pxSocket->u.xUDP.pxHandleSent ) )
+                        {
+                            pxSocket->u.xUDP.pxHandleSent( pxSocket, uxOffset );
+                        }
+                    }
+                    #endif /* ipconfigUSE_CALLBACKS */
+                }
+                else
+                {
+                    /* The packets were dropped. */
+                }
+            }
+
+            return lReturn;
+        }
+    #endif /* ( ipconfigUDP_GSO == 1 ) */
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Send several datagrams from a UDP socket. All packets are passed to the
+ *        IP-task with a single message.
+ *
+ * @param[in] xSocket The UDP socket used for sending.
+ * @param[in,out] pxDatagrams The datagrams to be sent. For each datagram that is
+ *                            queued, 'uxDataLength' will be set.
+ * @param[in] xCount The number of datagrams in 'pxDatagrams'.
+ * @param[in] xFlags Possibly FREERTOS_MSG_DONTWAIT and/or FREERTOS_ZERO_COPY.
+ *
+ * @return The number of datagrams that were queued for transmission, or a
+ *         negative error code when the first datagram could not be queued.
+ *         -pdFREERTOS_ERRNO_EINVAL is returned when the socket is not a bound
+ *         UDP socket.
+ *         Once queued, a network buffer belongs to the IP-task, also when
+ *         FREERTOS_ZERO_COPY is used. -pdFREERTOS_ERRNO_EAGAIN is returned
+ *         when the IP-task could not be reached. In that case all queued
+ *         packets have been released, including the zero-copy buffers.
+ */
+    BaseType_t FreeRTOS_sendto_batch( Socket_t xSocket,
+                                      UDPDatagram_t * pxDatagrams,
+                                      BaseType_t xCount,
+                                      BaseType_t xFlags )
+    {
+        FreeRTOS_Socket_t * pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+        BaseType_t xReturn = 0;
+        BaseType_t xIndex;
+        int32_t lResult = 0;
+        size_t uxMaxPayloadLength = 0;
+        size_t uxPayloadOffset = 0;
+        TickType_t xTicksToWait = ( TickType_t ) 0U;
+        TimeOut_t xTimeOut;
+        List_t xPacketList;
+        NetworkBufferDescriptor_t * pxNetworkBuffer;
+
+        if( ( pxDatagrams == NULL ) || ( xCount <= 0 ) )
+        {
+            xReturn = -pdFREERTOS_ERRNO_EINVAL;
+        }
+        else if( prvValidSocket( pxSocket, FREERTOS_IPPROTO_UDP, pdTRUE ) == pdFALSE )
+        {
+            /* Not a UDP socket, or it is not bound. */
+            iptraceSENDTO_SOCKET_NOT_BOUND();
+            xReturn = -pdFREERTOS_ERRNO_EINVAL;
+        }
+        else
+        {
+            vListInitialise( &( xPacketList ) );
+
+            if( ( ( ( UBaseType_t ) xFlags & ( UBaseType_t ) FREERTOS_MSG_DONTWAIT ) == 0U ) &&
+                ( xIsCallingFromIPTask() == pdFALSE ) )
+            {
+                xTicksToWait = pxSocket->xSendBlockTime;
+            }
+
+            vTaskSetTimeOutState( &xTimeOut );
+
+            /* Prepare all packets before the IP-task gets involved. */
+            for( xIndex = 0; xIndex < xCount; xIndex++ )
+            {
+                UDPDatagram_t * pxDatagram = &( pxDatagrams[ xIndex ] );
+
+                lResult = prvSendToGetPayloadOffset( &( pxDatagram->xAddress ), &( uxMaxPayloadLength ), &( uxPayloadOffset ) );
+
+                if( lResult != 0 )
+                {
+                    break;
+                }
+
+                if( pxDatagram->uxBufferLength > uxMaxPayloadLength )
+                {
+                    iptraceSENDTO_DATA_TOO_LONG();
+                    lResult = -pdFREERTOS_ERRNO_EINVAL;
+                    break;
+                }
+
+                if( ( ( UBaseType_t ) xFlags & ( UBaseType_t ) FREERTOS_ZERO_COPY ) == 0U )
+                {
+                    pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( uxPayloadOffset + pxDatagram->uxBufferLength, xTicksToWait );
+
+                    if( pxNetworkBuffer != NULL )
+                    {
+                        ( void ) memcpy( &( pxNetworkBuffer->pucEthernetBuffer[ uxPayloadOffset ] ), pxDatagram->pvBuffer, pxDatagram->uxBufferLength );
+                    }
+
+                    if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdTRUE )
+                    {
+                        /* The entire block time has been used up. */
+                        xTicksToWait = ( TickType_t ) 0;
+                    }
+                }
+                else
+                {
+                    pxNetworkBuffer = pxUDPPayloadBuffer_to_NetworkBuffer( pxDatagram->pvBuffer );
+                }
+
+                if( pxNetworkBuffer == NULL )
+                {
+                    iptraceNO_BUFFER_FOR_SENDTO();
+                    lResult = -pdFREERTOS_ERRNO_ENOBUFS;
+                    break;
+                }
+
+                pxNetworkBuffer->pxEndPoint = pxSocket->pxEndPoint;
+                prvPrepareUDPPacket( pxSocket, pxNetworkBuffer, pxDatagram->uxBufferLength, &( pxDatagram->xAddress ), uxPayloadOffset );
+                vListInsertEnd( &( xPacketList ), &( pxNetworkBuffer->xBufferListItem ) );
+                pxDatagram->uxDataLength = pxDatagram->uxBufferLength;
+            }
+
+            xReturn = ( BaseType_t ) listCURRENT_LIST_LENGTH( &( xPacketList ) );
+
+            if( xReturn == 0 )
+            {
+                /* Not a single packet could be prepared. */
+                xReturn = ( BaseType_t ) lResult;
+            }
+            else
+            {
+                if( prvSendBatchHandOver( pxSocket, &( xPacketList ), xTicksToWait ) == pdFAIL )
+                {
+                    /* The packets were dropped, the caller may not use the
+                     * zero-copy buffers anymore. */
+                    xReturn = -pdFREERTOS_ERRNO_EAGAIN;
+                }
+
+                #if ( ipconfigUSE_CALLBACKS == 1 )
+                {
+                    if( ipconfigIS_VALID_PROG_ADDRESS( pxSocket->u.xUDP.pxHandleSent ) )
+                    {
+                        for( xIndex = 0; xIndex < xReturn; xIndex++ )
+                        {
+                            pxSocket->u.xUDP.pxHandleSent( pxSocket, pxDatagrams[ xIndex ].uxDataLength );
+                        }
+                    }
+                }
+                #endif /* ipconfigUSE_CALLBACKS */
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Called by the IP-task to send the packets that were queued by
+ *        FreeRTOS_sendto_batch().
+ *
+ * @param[in] pxSocket The UDP socket that has queued packets.
+ */
+    void vSocketSendBatch( FreeRTOS_Socket_t * pxSocket )
+    {
+        NetworkBufferDescriptor_t * pxNetworkBuffer;
 
         #if ( ipconfigUSE_IPv4 != 0 )
-            case FREERTOS_AF_INET4:
-                uxMaxPayloadLength = ipconfigNETWORK_MTU - ( ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_UDP_HEADER );
-                uxPayloadOffset = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_UDP_HEADER;
+            /* Consecutive packets to the same peer share a single ARP lookup
+             * and a single set of headers. */
+            UDPPacket_t xHeader;
+            NetworkEndPoint_t * pxHeaderEndPoint = NULL;
+            const NetworkEndPoint_t * pxBoundEndPoint = NULL;
+            BaseType_t xHeaderValid = pdFALSE;
+        #endif
+
+        for( ; ; )
+        {
+            pxNetworkBuffer = NULL;
+
+            vTaskSuspendAll();
+            {
+                if( listLIST_IS_EMPTY( &( pxSocket->u.xUDP.xTxBatchList ) ) == pdFALSE )
+                {
+                    pxNetworkBuffer = ( ( NetworkBufferDescriptor_t * ) listGET_OWNER_OF_HEAD_ENTRY( &( pxSocket->u.xUDP.xTxBatchList ) ) );
+                    ( void ) uxListRemove( &( pxNetworkBuffer->xBufferListItem ) );
+                }
+            }
+            ( void ) xTaskResumeAll();
+
+            if( pxNetworkBuffer == NULL )
+            {
                 break;
-        #endif /* ( ipconfigUSE_IPv4 != 0 ) */
+            }
 
-        default:
-            FreeRTOS_debug_printf( ( "FreeRTOS_sendto: Undefined sin_family \n" ) );
-            lReturn = -pdFREERTOS_ERRNO_EINVAL;
-            break;
+            #if ( ipconfigUSE_IPv4 != 0 )
+                if( uxIPHeaderSizePacket( pxNetworkBuffer ) == ipSIZE_OF_IPv4_HEADER )
+                {
+                    if( ( xHeaderValid == pdFALSE ) ||
+                        ( pxNetworkBuffer->xIPAddress.ulIP_IPv4 != xHeader.xIPHeader.ulDestinationIPAddress ) ||
+                        ( pxNetworkBuffer->usPort != xHeader.xUDPHeader.usDestinationPort ) ||
+                        ( pxNetworkBuffer->pxEndPoint != pxBoundEndPoint ) )
+                    {
+                        pxBoundEndPoint = pxNetworkBuffer->pxEndPoint;
+                        pxHeaderEndPoint = pxNetworkBuffer->pxEndPoint;
+                        xHeaderValid = prvUDPHeaderBuild( &( xHeader ),
+                                                          pxNetworkBuffer->xIPAddress.ulIP_IPv4,
+                                                          pxNetworkBuffer->usPort,
+                                                          pxNetworkBuffer->usBoundPort,
+                                                          &( pxHeaderEndPoint ) );
+                    }
+
+                    if( xHeaderValid != pdFALSE )
+                    {
+                        if( ( pxHeaderEndPoint->pxNetworkInterface != NULL ) &&
+                            ( pxHeaderEndPoint->pxNetworkInterface->pfOutput != NULL ) )
+                        {
+                            prvUDPHeaderComplete( &( xHeader ),
+                                                  pxHeaderEndPoint,
+                                                  pxNetworkBuffer,
+                                                  pxNetworkBuffer->xDataLength - sizeof( UDPPacket_t ),
+                                                  pxNetworkBuffer->pucEthernetBuffer[ ipSOCKET_OPTIONS_OFFSET ] );
+                            iptraceNETWORK_INTERFACE_OUTPUT( pxNetworkBuffer->xDataLength, pxNetworkBuffer->pucEthernetBuffer );
+                            ipMIB_COUNT_OUTPUT( pxNetworkBuffer );
+
+                            /* The driver releases the buffer, also when it fails to send it. */
+                            ( void ) pxHeaderEndPoint->pxNetworkInterface->pfOutput( pxHeaderEndPoint->pxNetworkInterface, pxNetworkBuffer, pdTRUE );
+                        }
+                        else
+                        {
+                            /* The end-point has no way to send the packet, drop it. */
+                            vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+                        }
+
+                        continue;
+                    }
+                }
+            #endif /* ( ipconfigUSE_IPv4 != 0 ) */
+
+            vProcessGeneratedUDPPacket( pxNetworkBuffer );
+        }
     }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Called by FreeRTOS_recvfrom_batch(): store a received packet in a
+ *        datagram descriptor.
+ *
+ * @param[in] pxNetworkBuffer The received packet.
+ * @param[out] pxDatagram The descriptor to be filled in.
+ * @param[in] xFlags Only 'FREERTOS_ZERO_COPY' will be tested.
+ *
+ * @return The number of bytes stored, or a negative error code.
+ */
+    static int32_t prvRecvFromBatch_Store( NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                           UDPDatagram_t * pxDatagram,
+                                           BaseType_t xFlags )
+    {
+        int32_t lReturn = 0;
+        size_t uxPayloadOffset = 0;
+        void * pvBuffer;
+
+        switch( uxIPHeaderSizePacket( pxNetworkBuffer ) )
+        {
+            #if ( ipconfigUSE_IPv4 != 0 )
+                case ipSIZE_OF_IPv4_HEADER:
+                    uxPayloadOffset = xRecv_Update_IPv4( pxNetworkBuffer, &( pxDatagram->xAddress ) );
+                    break;
+            #endif /* ( ipconfigUSE_IPv4 != 0 ) */
+
+            #if ( ipconfigUSE_IPv6 != 0 )
+                case ipSIZE_OF_IPv6_HEADER:
+                    uxPayloadOffset = xRecv_Update_IPv6( pxNetworkBuffer, &( pxDatagram->xAddress ) );
+                    break;
+            #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+
+            default:
+                /* MISRA 16.4 Compliance */
+                lReturn = -pdFREERTOS_ERRNO_EINVAL;
+                break;
+        }
 
-    if( lReturn == 0 )
-    {
-        if( uxTotalDataLength <= ( size_t ) uxMaxPayloadLength )
+        if( lReturn == 0 )
         {
-            /* If the socket is not already bound to an address, bind it now.
-             * Passing NULL as the address parameter tells FreeRTOS_bind() to select
-             * the address to bind to. */
-            if( prvMakeSureSocketIsBound( pxSocket ) == pdTRUE )
+            if( ( ( UBaseType_t ) xFlags & ( UBaseType_t ) FREERTOS_ZERO_COPY ) == 0U )
             {
-                lReturn = prvSendTo_ActualSend( pxSocket, pvBuffer, uxTotalDataLength, xFlags, pxDestinationAddress, uxPayloadOffset );
+                pvBuffer = pxDatagram->pvBuffer;
             }
             else
             {
-                /* No comment. */
-                iptraceSENDTO_SOCKET_NOT_BOUND();
+                /* The payload pointer will be stored in 'pvBuffer'. */
+                pvBuffer = ( void * ) &( pxDatagram->pvBuffer );
             }
+
+            lReturn = prvRecvFrom_CopyPacket( &( pxNetworkBuffer->pucEthernetBuffer[ uxPayloadOffset ] ),
+                                              pvBuffer,
+                                              pxDatagram->uxBufferLength,
+                                              xFlags,
+                                              ( int32_t ) ( pxNetworkBuffer->xDataLength - uxPayloadOffset ) );
+            pxDatagram->uxDataLength = ( size_t ) lReturn;
+        }
+
+        return lReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Receive several datagrams from a UDP socket. The call blocks, like
+ *        FreeRTOS_recvfrom(), until at least one datagram is available.
+ *        Then it returns all waiting datagrams, up to 'xCount'.
+ *
+ * @param[in] xSocket The UDP socket.
+ * @param[in,out] pxDatagrams The descriptors that will receive the datagrams.
+ *                For each descriptor, 'pvBuffer' and 'uxBufferLength' must be
+ *                provided, unless FREERTOS_ZERO_COPY is used. In that case,
+ *                'pvBuffer' will point to the payload of a network buffer that
+ *                must be released by calling FreeRTOS_ReleaseUDPPayloadBuffer().
+ * @param[in] xCount The number of elements in 'pxDatagrams'.
+ * @param[in] xFlags Possibly FREERTOS_MSG_DONTWAIT and/or FREERTOS_ZERO_COPY.
+ *                   FREERTOS_MSG_PEEK is not supported.
+ *
+ * @return The number of datagrams received, or a negative error code. When
+ *         not a single datagram could be stored, the error of the last
+ *         attempt is returned.
+ */
+    BaseType_t FreeRTOS_recvfrom_batch( Socket_t xSocket,
+                                        UDPDatagram_t * pxDatagrams,
+                                        BaseType_t xCount,
+                                        BaseType_t xFlags )
+    {
+        const FreeRTOS_Socket_t * pxSocket = ( const FreeRTOS_Socket_t * ) xSocket;
+        NetworkBufferDescriptor_t * pxNetworkBuffer;
+        EventBits_t xEventBits = ( EventBits_t ) 0;
+        BaseType_t xReturn = 0;
+        int32_t lResult = 0;
+
+        if( ( prvValidSocket( pxSocket, FREERTOS_IPPROTO_UDP, pdTRUE ) == pdFALSE ) ||
+            ( pxDatagrams == NULL ) ||
+            ( xCount <= 0 ) ||
+            ( ( ( UBaseType_t ) xFlags & ( UBaseType_t ) FREERTOS_MSG_PEEK ) != 0U ) )
+        {
+            xReturn = -pdFREERTOS_ERRNO_EINVAL;
         }
         else
         {
-            /* The data is longer than the available buffer space. */
-            iptraceSENDTO_DATA_TOO_LONG();
+            pxNetworkBuffer = prvRecvFromWaitForPacket( pxSocket, xFlags, &( xEventBits ) );
+
+            if( pxNetworkBuffer == NULL )
+            {
+                #if ( ipconfigSUPPORT_SIGNALS != 0 )
+                    if( ( xEventBits & ( EventBits_t ) eSOCKET_INTR ) != 0U )
+                    {
+                        xReturn = -pdFREERTOS_ERRNO_EINTR;
+                        iptraceRECVFROM_INTERRUPTED();
+                    }
+                    else
+                #endif /* ipconfigSUPPORT_SIGNALS */
+                {
+                    ( void ) xEventBits;
+                    xReturn = -pdFREERTOS_ERRNO_EWOULDBLOCK;
+                    iptraceRECVFROM_TIMEOUT();
+                }
+            }
+
+            while( pxNetworkBuffer != NULL )
+            {
+                lResult = prvRecvFromBatch_Store( pxNetworkBuffer, &( pxDatagrams[ xReturn ] ), xFlags );
+
+                if( lResult >= 0 )
+                {
+                    xReturn++;
+
+                    if( ( ( UBaseType_t ) xFlags & ( UBaseType_t ) FREERTOS_ZERO_COPY ) == 0U )
+                    {
+                        vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+                    }
+                }
+                else
+                {
+                    vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+                }
+
+                pxNetworkBuffer = NULL;
+
+                if( xReturn < xCount )
+                {
+                    /* Take the next packet, if it is already waiting. */
+                    vTaskSuspendAll();
+                    {
+                        if( listLIST_IS_EMPTY( &( pxSocket->u.xUDP.xWaitingPacketsList ) ) == pdFALSE )
+                        {
+                            pxNetworkBuffer = ( ( NetworkBufferDescriptor_t * ) listGET_OWNER_OF_HEAD_ENTRY( &( pxSocket->u.xUDP.xWaitingPacketsList ) ) );
+                            ( void ) uxListRemove( &( pxNetworkBuffer->xBufferListItem ) );
+                        }
+                    }
+                    ( void ) xTaskResumeAll();
+                }
+            }
+
+            if( ( xReturn == 0 ) && ( lResult < 0 ) )
+            {
+                /* Not a single datagram could be stored. */
+                xReturn = ( BaseType_t ) lResult;
+            }
         }
+
+        return xReturn;
     }
 
-    return lReturn;
-} /* Tested */
+#endif /* ipconfigUDP_BATCH_CALLS == 1 */
 /*-----------------------------------------------------------*/
 
 /**
@@ -2081,6 +3372,13 @@ void * vSocketClose( FreeRTOS_Socket_t * pxSocket )
 {
     NetworkBufferDescriptor_t * pxNetworkBuffer;
 
+    #if ( ipconfigSELECT_READY_LIST == 1 )
+    {
+        /* The socket may not stay in the ready list of a socket set. */
+        prvSocketSetNotReady( pxSocket );
+    }
+    #endif
+
     #if ( ipconfigUSE_TCP == 1 )
     {
         /* For TCP: clean up a little more. */
@@ -2111,6 +3409,40 @@ void * vSocketClose( FreeRTOS_Socket_t * pxSocket )
                 vPortFreeLarge( pxSocket->u.xTCP.txStream );
             }
 
+            #if ( ipconfigTCP_TX_BY_REFERENCE == 1 )
+            {
+                /* The application memory that was queued is not used any more. */
+                vTCPTxRefFlush( pxSocket );
+            }
+            #endif
+
+            #if ( ipconfigTCP_RX_BUFFER_LENDING == 1 )
+            {
+                /* Release the segments that were not yet taken by the user. */
+                while( listCURRENT_LIST_LENGTH( &( pxSocket->u.xTCP.xRxLentList ) ) > 0U )
+                {
+                    pxNetworkBuffer = ( ( NetworkBufferDescriptor_t * ) listGET_OWNER_OF_HEAD_ENTRY( &( pxSocket->u.xTCP.xRxLentList ) ) );
+                    ( void ) uxListRemove( &( pxNetworkBuffer->xBufferListItem ) );
+                    vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+                }
+            }
+            #endif /* ipconfigTCP_RX_BUFFER_LENDING */
+
+            #if ( ipconfigTCP_ACCEPT_QUEUE == 1 )
+            {
+                /* A child socket that was never accepted may still be queued
+                 * in the accept queue of its parent. */
+                vTaskSuspendAll();
+                {
+                    if( listLIST_ITEM_CONTAINER( &( pxSocket->u.xTCP.xAcceptItem ) ) != NULL )
+                    {
+                        ( void ) uxListRemove( &( pxSocket->u.xTCP.xAcceptItem ) );
+                    }
+                }
+                ( void ) xTaskResumeAll();
+            }
+            #endif /* ipconfigTCP_ACCEPT_QUEUE */
+
             /* In case this is a child socket, make sure the child-count of the
              * parent socket is decreased. */
             prvTCPSetSocketCount( pxSocket );
@@ -2150,6 +3482,25 @@ void * vSocketClose( FreeRTOS_Socket_t * pxSocket )
             ( void ) uxListRemove( &( pxNetworkBuffer->xBufferListItem ) );
             vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
         }
+
+        #if ( ipconfigUDP_BATCH_CALLS == 1 )
+        {
+            /* Packets that were queued by FreeRTOS_sendto_batch() but not sent. */
+            while( listCURRENT_LIST_LENGTH( &( pxSocket->u.xUDP.xTxBatchList ) ) > 0U )
+            {
+                pxNetworkBuffer = ( ( NetworkBufferDescriptor_t * ) listGET_OWNER_OF_HEAD_ENTRY( &( pxSocket->u.xUDP.xTxBatchList ) ) );
+                ( void ) uxListRemove( &( pxNetworkBuffer->xBufferListItem ) );
+                vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+            }
+        }
+        #endif /* ipconfigUDP_BATCH_CALLS */
+
+        #if ( ipconfigSUPPORT_IP_MULTICAST == 1 )
+        {
+            /* Leave the multicast groups that were joined by this socket. */
+            vMulticastSocketClose( pxSocket );
+        }
+        #endif /* ipconfigSUPPORT_IP_MULTICAST */
     }
 
     if( pxSocket->xEventGroup != NULL )
@@ -2542,7 +3893,18 @@ void * vSocketClose( FreeRTOS_Socket_t * pxSocket )
              * adapt the window size parameters */
             if( pxTCP->xTCPWindow.u.bits.bHasInit != ipFALSE_BOOL )
             {
-                pxTCP->xTCPWindow.xSize.ulRxWindowLength = ( uint32_t ) ( pxTCP->uxRxWinSize * pxTCP->usMSS );
+                #if ( ipconfigTCP_RX_AUTOTUNE == 1 )
+                {
+                    /* The configured size is the limit for autotuning. */
+                    pxTCP->xTCPWindow.ulRxWindowMaximum = ( uint32_t ) ( pxTCP->uxRxWinSize * pxTCP->usMSS );
+                    pxTCP->xTCPWindow.xSize.ulRxWindowLength = FreeRTOS_min_uint32( pxTCP->xTCPWindow.xSize.ulRxWindowLength,
+                                                                                    pxTCP->xTCPWindow.ulRxWindowMaximum );
+                }
+                #else
+                {
+                    pxTCP->xTCPWindow.xSize.ulRxWindowLength = ( uint32_t ) ( pxTCP->uxRxWinSize * pxTCP->usMSS );
+                }
+                #endif
                 pxTCP->xTCPWindow.xSize.ulTxWindowLength = ( uint32_t ) ( pxTCP->uxTxWinSize * pxTCP->usMSS );
             }
         }
@@ -2637,6 +3999,185 @@ void * vSocketClose( FreeRTOS_Socket_t * pxSocket )
 #endif /* ( ipconfigUSE_TCP != 0 ) */
 /*-----------------------------------------------------------*/
 
+#if ( ( ipconfigUSE_TCP != 0 ) && ( ipconfigTCP_PACING == 1 ) )
+
+/**
+ * @brief Handle the socket option FREERTOS_SO_PACING_RATE, which sets the
+ *        rate at which TCP segments are sent, in bytes per second. A rate of
+ *        zero lets the IP-stack derive the rate from the window and the SRTT.
+ *
+ * @param[in] pxSocket The TCP socket used for the connection.
+ * @param[in] pvOptionValue A pointer to a uint32_t that contains the rate.
+ */
+    static BaseType_t prvSetOptionPacingRate( FreeRTOS_Socket_t * pxSocket,
+                                              const void * pvOptionValue )
+    {
+        BaseType_t xReturn = -pdFREERTOS_ERRNO_EINVAL;
+
+        if( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP )
+        {
+            pxSocket->u.xTCP.ulPacingRate = *( ( const uint32_t * ) pvOptionValue );
+
+            if( ( pxSocket->u.xTCP.eTCPState >= eESTABLISHED ) &&
+                ( FreeRTOS_outstanding( pxSocket ) != 0 ) )
+            {
+                /* Data might be held back by the old rate, let the IP-task
+                 * check it. */
+                pxSocket->u.xTCP.usTimeout = 1U;
+                ( void ) xSendEventToIPTask( eTCPTimerEvent );
+            }
+
+            xReturn = 0;
+        }
+
+        return xReturn;
+    }
+#endif /* ( ( ipconfigUSE_TCP != 0 ) && ( ipconfigTCP_PACING == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( ipconfigUSE_TCP != 0 ) && ( ipconfigTCP_RX_BUFFER_LENDING == 1 ) )
+
+/**
+ * @brief Handle the socket option FREERTOS_SO_RX_BUFFER_LENDING. When set,
+ *        segments that arrive in-order while the RX stream is empty will be
+ *        lent to the user, see FreeRTOS_recv_lent().
+ *
+ * @param[in] pxSocket The TCP socket used for the connection.
+ * @param[in] pvOptionValue A pointer to a BaseType_t: pdTRUE or pdFALSE.
+ */
+    static BaseType_t prvSetOptionRxBufferLending( FreeRTOS_Socket_t * pxSocket,
+                                                   const void * pvOptionValue )
+    {
+        BaseType_t xReturn = -pdFREERTOS_ERRNO_EINVAL;
+
+        if( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP )
+        {
+            if( *( ( const BaseType_t * ) pvOptionValue ) != 0 )
+            {
+                pxSocket->u.xTCP.bits.bRxLending = ipTRUE_BOOL;
+            }
+            else
+            {
+                pxSocket->u.xTCP.bits.bRxLending = ipFALSE_BOOL;
+            }
+
+            xReturn = 0;
+        }
+
+        return xReturn;
+    }
+#endif /* ( ( ipconfigUSE_TCP != 0 ) && ( ipconfigTCP_RX_BUFFER_LENDING == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigSUPPORT_IP_MULTICAST == 1 )
+
+/**
+ * @brief Handle the socket options FREERTOS_SO_IP_ADD_MEMBERSHIP,
+ *        FREERTOS_SO_IP_DROP_MEMBERSHIP, FREERTOS_SO_IPV6_ADD_MEMBERSHIP and
+ *        FREERTOS_SO_IPV6_DROP_MEMBERSHIP. The interface is looked up here,
+ *        the IP-task will update the MAC filter and send the reports.
+ *
+ * @param[in] pxSocket The UDP socket.
+ * @param[in] lOptionName The option name.
+ * @param[in] pvOptionValue A pointer to a struct freertos_ip_mreq or freertos_ipv6_mreq.
+ *
+ * @return 0 on success, or a negative errno value.
+ */
+    static BaseType_t prvSetOptionMembership( const FreeRTOS_Socket_t * pxSocket,
+                                              int32_t lOptionName,
+                                              const void * pvOptionValue )
+    {
+        BaseType_t xReturn = -pdFREERTOS_ERRNO_EINVAL;
+        BaseType_t xJoin = pdFALSE;
+        BaseType_t xIsIPv6 = pdFALSE;
+        NetworkInterface_t * pxInterface = NULL;
+        IP_Address_t xGroup;
+
+        ( void ) memset( &( xGroup ), 0, sizeof( xGroup ) );
+
+        if( ( lOptionName == FREERTOS_SO_IP_ADD_MEMBERSHIP ) || ( lOptionName == FREERTOS_SO_IPV6_ADD_MEMBERSHIP ) )
+        {
+            xJoin = pdTRUE;
+        }
+
+        if( ( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_UDP ) && ( pvOptionValue != NULL ) )
+        {
+            if( ( lOptionName == FREERTOS_SO_IP_ADD_MEMBERSHIP ) || ( lOptionName == FREERTOS_SO_IP_DROP_MEMBERSHIP ) )
+            {
+                #if ( ipconfigUSE_IPv4 != 0 )
+                {
+                    const struct freertos_ip_mreq * pxRequest = ( const struct freertos_ip_mreq * ) pvOptionValue;
+                    NetworkEndPoint_t * pxEndPoint = NULL;
+
+                    if( xIsIPv4Multicast( pxRequest->imr_multiaddr ) != pdFALSE )
+                    {
+                        xGroup.ulIP_IPv4 = pxRequest->imr_multiaddr;
+
+                        if( pxRequest->imr_interface != FREERTOS_INADDR_ANY )
+                        {
+                            pxEndPoint = FreeRTOS_FindEndPointOnIP_IPv4( pxRequest->imr_interface );
+                        }
+                        else if( ( pxSocket->pxEndPoint != NULL ) && ( ENDPOINT_IS_IPv4( pxSocket->pxEndPoint ) ) )
+                        {
+                            pxEndPoint = pxSocket->pxEndPoint;
+                        }
+                        else
+                        {
+                            /* Use the first interface that has an IPv4 end-point. */
+                            for( pxEndPoint = FreeRTOS_FirstEndPoint( NULL );
+                                 pxEndPoint != NULL;
+                                 pxEndPoint = FreeRTOS_NextEndPoint( NULL, pxEndPoint ) )
+                            {
+                                if( ENDPOINT_IS_IPv4( pxEndPoint ) )
+                                {
+                                    break;
+                                }
+                            }
+                        }
+
+                        if( pxEndPoint != NULL )
+                        {
+                            pxInterface = pxEndPoint->pxNetworkInterface;
+                        }
+                    }
+                }
+                #endif /* ( ipconfigUSE_IPv4 != 0 ) */
+            }
+            else
+            {
+                #if ( ipconfigUSE_IPv6 != 0 )
+                {
+                    const struct freertos_ipv6_mreq * pxRequest = ( const struct freertos_ipv6_mreq * ) pvOptionValue;
+                    const NetworkEndPoint_t * pxEndPoint;
+
+                    if( xIsIPv6AllowedMulticast( &( pxRequest->ipv6mr_multiaddr ) ) != pdFALSE )
+                    {
+                        ( void ) memcpy( xGroup.xIP_IPv6.ucBytes, pxRequest->ipv6mr_multiaddr.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+                        xIsIPv6 = pdTRUE;
+
+                        /* The interface must have an IPv6 end-point to send the reports. */
+                        pxEndPoint = FreeRTOS_FirstEndPoint_IPv6( pxRequest->ipv6mr_interface );
+
+                        if( ( pxEndPoint != NULL ) && ( ENDPOINT_IS_IPv6( pxEndPoint ) ) )
+                        {
+                            pxInterface = pxEndPoint->pxNetworkInterface;
+                        }
+                    }
+                }
+                #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+            }
+        }
+
+        if( pxInterface != NULL )
+        {
+            xReturn = xMulticastMembershipRequest( pxSocket, &( xGroup ), xIsIPv6, pxInterface, xJoin );
+        }
+
+        return xReturn;
+    }
+#endif /* ( ipconfigSUPPORT_IP_MULTICAST == 1 ) */
+/*-----------------------------------------------------------*/
+
 #if ( ipconfigUSE_TCP != 0 )
 
 /**
@@ -2852,6 +4393,28 @@ BaseType_t FreeRTOS_setsockopt( Socket_t xSocket,
                         break;
                 #endif /* ipconfigUDP_MAX_RX_PACKETS */
 
+                #if ( ipconfigUDP_GSO == 1 )
+                    case FREERTOS_SO_UDP_SEGMENT:
+
+                        if( pxSocket->ucProtocol != ( uint8_t ) FREERTOS_IPPROTO_UDP )
+                        {
+                            break; /* will return -pdFREERTOS_ERRNO_EINVAL */
+                        }
+
+                        pxSocket->u.xUDP.uxSegmentSize = *( ( const size_t * ) pvOptionValue );
+                        xReturn = 0;
+                        break;
+                #endif /* ipconfigUDP_GSO */
+
+                #if ( ipconfigSUPPORT_IP_MULTICAST == 1 )
+                    case FREERTOS_SO_IP_ADD_MEMBERSHIP:
+                    case FREERTOS_SO_IP_DROP_MEMBERSHIP:
+                    case FREERTOS_SO_IPV6_ADD_MEMBERSHIP:
+                    case FREERTOS_SO_IPV6_DROP_MEMBERSHIP:
+                        xReturn = prvSetOptionMembership( pxSocket, lOptionName, pvOptionValue );
+                        break;
+                #endif /* ipconfigSUPPORT_IP_MULTICAST */
+
             case FREERTOS_SO_UDPCKSUM_OUT:
 
                 /* Turn calculating of the UDP checksum on/off for this socket. If pvOptionValue
@@ -2946,6 +4509,18 @@ BaseType_t FreeRTOS_setsockopt( Socket_t xSocket,
                     case FREERTOS_SO_STOP_RX: /* Refuse to receive more packets. */
                         xReturn = prvSetOptionStopRX( pxSocket, pvOptionValue );
                         break;
+
+                    #if ( ipconfigTCP_PACING == 1 )
+                        case FREERTOS_SO_PACING_RATE: /* Set the pacing rate in bytes per second. */
+                            xReturn = prvSetOptionPacingRate( pxSocket, pvOptionValue );
+                            break;
+                    #endif
+
+                    #if ( ipconfigTCP_RX_BUFFER_LENDING == 1 )
+                        case FREERTOS_SO_RX_BUFFER_LENDING: /* Lend received segments to the user. */
+                            xReturn = prvSetOptionRxBufferLending( pxSocket, pvOptionValue );
+                            break;
+                    #endif
                 #endif /* ipconfigUSE_TCP == 1 */
 
             default:
@@ -3084,22 +4659,93 @@ FreeRTOS_Socket_t * pxUDPSocketLookup( UBaseType_t uxLocalPort )
     const ListItem_t * pxListItem;
     FreeRTOS_Socket_t * pxSocket = NULL;
 
-    /* Looking up a socket is quite simple, find a match with the local port.
-     *
-     * See if there is a list item associated with the port number on the
-     * list of bound sockets. */
-    pxListItem = pxListFindListItemWithValue( &xBoundUDPSocketsList, ( TickType_t ) uxLocalPort );
+    /* Looking up a socket is quite simple, find a match with the local port.
+     *
+     * See if there is a list item associated with the port number on the
+     * list of bound sockets. */
+    pxListItem = pxListFindListItemWithValue( &xBoundUDPSocketsList, ( TickType_t ) uxLocalPort );
+
+    if( pxListItem != NULL )
+    {
+        /* The owner of the list item is the socket itself. */
+        pxSocket = ( ( FreeRTOS_Socket_t * ) listGET_LIST_ITEM_OWNER( pxListItem ) );
+        configASSERT( pxSocket != NULL );
+    }
+
+    return pxSocket;
+}
+
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUDP_CONNECTED_SOCKETS == 1 )
+
+/**
+ * @brief Check if a received UDP packet may be delivered to a socket. A
+ *        connected socket only accepts packets from its peer.
+ *
+ * @param[in] pxSocket The socket found by pxUDPSocketLookup().
+ * @param[in] pxNetworkBuffer The received packet.
+ *
+ * @return pdTRUE when the packet may be delivered, otherwise pdFALSE.
+ */
+    BaseType_t xUDPSocketAcceptsPacket( const FreeRTOS_Socket_t * pxSocket,
+                                        const NetworkBufferDescriptor_t * pxNetworkBuffer )
+    {
+        BaseType_t xReturn = pdTRUE;
+        const struct freertos_sockaddr * pxPeer = &( pxSocket->u.xUDP.xRemoteAddress );
+
+        /* MISRA Ref 11.3.1 [Misaligned access] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+        /* coverity[misra_c_2012_rule_11_3_violation] */
+        const EthernetHeader_t * pxEthernetHeader = ( ( const EthernetHeader_t * ) pxNetworkBuffer->pucEthernetBuffer );
+
+        if( pxSocket->u.xUDP.xIsConnected != pdFALSE )
+        {
+            xReturn = pdFALSE;
+
+            if( pxNetworkBuffer->usPort == pxPeer->sin_port )
+            {
+                switch( pxPeer->sin_family )
+                {
+                    #if ( ipconfigUSE_IPv6 != 0 )
+                        case FREERTOS_AF_INET6:
+                           {
+                               /* MISRA Ref 11.3.1 [Misaligned access] */
+                               /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                               /* coverity[misra_c_2012_rule_11_3_violation] */
+                               const UDPPacket_IPv6_t * pxUDPPacket_IPv6 = ( ( const UDPPacket_IPv6_t * ) pxNetworkBuffer->pucEthernetBuffer );
+
+                               if( ( pxEthernetHeader->usFrameType == ipIPv6_FRAME_TYPE ) &&
+                                   ( memcmp( pxUDPPacket_IPv6->xIPHeader.xSourceAddress.ucBytes, pxPeer->sin_address.xIP_IPv6.ucBytes, ipSIZE_OF_IPv6_ADDRESS ) == 0 ) )
+                               {
+                                   xReturn = pdTRUE;
+                               }
+                           }
+                           break;
+                    #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+
+                    #if ( ipconfigUSE_IPv4 != 0 )
+                        case FREERTOS_AF_INET4:
+
+                            if( ( pxEthernetHeader->usFrameType == ipIPv4_FRAME_TYPE ) &&
+                                ( pxNetworkBuffer->xIPAddress.ulIP_IPv4 == pxPeer->sin_address.ulIP_IPv4 ) )
+                            {
+                                xReturn = pdTRUE;
+                            }
+                            break;
+                    #endif /* ( ipconfigUSE_IPv4 != 0 ) */
 
-    if( pxListItem != NULL )
-    {
-        /* The owner of the list item is the socket itself. */
-        pxSocket = ( ( FreeRTOS_Socket_t * ) listGET_LIST_ITEM_OWNER( pxListItem ) );
-        configASSERT( pxSocket != NULL );
-    }
+                    default:
+                        /* MISRA 16.4 Compliance */
+                        break;
+                }
+            }
+        }
 
-    return pxSocket;
-}
+        return xReturn;
+    }
 
+#endif /* ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) */
 /*-----------------------------------------------------------*/
 
 #define sockDIGIT_COUNT    ( 3U ) /**< Each nibble is expressed in at most 3 digits such as "192". */
@@ -3563,7 +5209,15 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
 
             if( xSelectBits != 0U )
             {
-                pxSocket->xSocketBits |= xSelectBits;
+                #if ( ipconfigSELECT_READY_LIST == 1 )
+                {
+                    prvSocketSetReady( pxSocket, xSelectBits );
+                }
+                #else
+                {
+                    pxSocket->xSocketBits |= xSelectBits;
+                }
+                #endif
                 ( void ) xEventGroupSetBits( pxSocket->pxSocketSet->xSelectGroup, xSelectBits );
             }
         }
@@ -3767,7 +5421,94 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
 #if ( ipconfigUSE_TCP == 1 )
 
 /**
- * @brief Connect to a remote port.
+ * @brief Called from #FreeRTOS_connect(): wait until the connection is
+ *        established, or until it fails or the receive time-out expires.
+ *
+ * @param[in] pxSocket The socket that is connecting.
+ *
+ * @return 0 when connected, otherwise a negative error code.
+ */
+    static BaseType_t prvTCPConnectWait( FreeRTOS_Socket_t * pxSocket )
+    {
+        TickType_t xRemainingTime;
+        BaseType_t xTimed = pdFALSE;
+        BaseType_t xResult;
+        TimeOut_t xTimeOut;
+
+        /* And wait for the result */
+        for( ; ; )
+        {
+            EventBits_t uxEvents;
+
+            if( xTimed == pdFALSE )
+            {
+                /* Only in the first round, check for non-blocking */
+                xRemainingTime = pxSocket->xReceiveBlockTime;
+
+                if( xRemainingTime == ( TickType_t ) 0 )
+                {
+                    /* Not yet connected, correct state, non-blocking. */
+                    xResult = -pdFREERTOS_ERRNO_EWOULDBLOCK;
+                    break;
+                }
+
+                /* Don't get here a second time. */
+                xTimed = pdTRUE;
+
+                /* Fetch the current time */
+                vTaskSetTimeOutState( &xTimeOut );
+            }
+
+            /* Did it get connected while sleeping ? */
+            xResult = FreeRTOS_issocketconnected( pxSocket );
+
+            /* Returns positive when connected, negative means an error */
+            if( xResult < 0 )
+            {
+                /* Return the error */
+                break;
+            }
+
+            if( xResult > 0 )
+            {
+                /* Socket now connected, return a zero */
+                xResult = 0;
+                break;
+            }
+
+            /* Is it allowed to sleep more? */
+            if( xTaskCheckForTimeOut( &xTimeOut, &xRemainingTime ) != pdFALSE )
+            {
+                xResult = -pdFREERTOS_ERRNO_ETIMEDOUT;
+                break;
+            }
+
+            /* Go sleeping until we get any down-stream event */
+            uxEvents = xEventGroupWaitBits( pxSocket->xEventGroup,
+                                            ( EventBits_t ) eSOCKET_CONNECT | ( EventBits_t ) eSOCKET_CLOSED,
+                                            pdTRUE /*xClearOnExit*/,
+                                            pdFALSE /*xWaitAllBits*/,
+                                            xRemainingTime );
+
+            if( ( uxEvents & ( EventBits_t ) eSOCKET_CLOSED ) != 0U )
+            {
+                xResult = -pdFREERTOS_ERRNO_ENOTCONN;
+                FreeRTOS_debug_printf( ( "FreeRTOS_connect() stopped due to an error\n" ) );
+                break;
+            }
+        }
+
+        return xResult;
+    }
+
+#endif /* ipconfigUSE_TCP */
+/*-----------------------------------------------------------*/
+
+#if ( ( ipconfigUSE_TCP == 1 ) || ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) )
+
+/**
+ * @brief Connect to a remote port. For a UDP socket, this only fixes the
+ *        peer, see ipconfigUDP_CONNECTED_SOCKETS.
  *
  * @param[in] xClientSocket The socket initiating the connection.
  * @param[in] pxAddress The address of the remote socket.
@@ -3783,10 +5524,7 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
                                  socklen_t xAddressLength )
     {
         FreeRTOS_Socket_t * pxSocket = ( FreeRTOS_Socket_t * ) xClientSocket;
-        TickType_t xRemainingTime;
-        BaseType_t xTimed = pdFALSE;
         BaseType_t xResult = -pdFREERTOS_ERRNO_EINVAL;
-        TimeOut_t xTimeOut;
 
         #if ( ipconfigIPv4_BACKWARD_COMPATIBLE == 1 )
             struct freertos_sockaddr xTempAddress;
@@ -3804,78 +5542,364 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
 
         ( void ) xAddressLength;
 
-        xResult = prvTCPConnectStart( pxSocket, pxAddress );
-
-        if( xResult == 0 )
-        {
-            /* And wait for the result */
-            for( ; ; )
+        #if ( ipconfigUDP_CONNECTED_SOCKETS == 1 )
+            if( prvValidSocket( pxSocket, FREERTOS_IPPROTO_UDP, pdFALSE ) == pdTRUE )
             {
-                EventBits_t uxEvents;
+                xResult = prvUDPConnect( pxSocket, pxAddress );
+            }
+            else
+        #endif /* ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) */
+        {
+            #if ( ipconfigUSE_TCP == 1 )
+                xResult = prvTCPConnectStart( pxSocket, pxAddress );
 
-                if( xTimed == pdFALSE )
+                if( xResult == 0 )
                 {
-                    /* Only in the first round, check for non-blocking */
-                    xRemainingTime = pxSocket->xReceiveBlockTime;
+                    xResult = prvTCPConnectWait( pxSocket );
+                }
+            #endif /* ( ipconfigUSE_TCP == 1 ) */
+        }
 
-                    if( xRemainingTime == ( TickType_t ) 0 )
-                    {
-                        /* Not yet connected, correct state, non-blocking. */
-                        xResult = -pdFREERTOS_ERRNO_EWOULDBLOCK;
-                        break;
-                    }
+        return xResult;
+    }
 
-                    /* Don't get here a second time. */
-                    xTimed = pdTRUE;
+#endif /* ( ( ipconfigUSE_TCP == 1 ) || ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) ) */
+/*-----------------------------------------------------------*/
 
-                    /* Fetch the current time */
-                    vTaskSetTimeOutState( &xTimeOut );
-                }
+#if ( ipconfigUDP_CONNECTED_SOCKETS == 1 )
 
-                /* Did it get connected while sleeping ? */
-                xResult = FreeRTOS_issocketconnected( pxSocket );
+/**
+ * @brief Called from #FreeRTOS_connect(): fix the peer of a UDP socket, or
+ *        dissolve the association when 'pxAddress' is NULL.
+ *
+ * @param[in] pxSocket The UDP socket.
+ * @param[in] pxAddress The address of the peer, or NULL.
+ *
+ * @return 0 on success, otherwise a negative error code.
+ */
+    static BaseType_t prvUDPConnect( FreeRTOS_Socket_t * pxSocket,
+                                     const struct freertos_sockaddr * pxAddress )
+    {
+        BaseType_t xResult = 0;
+        size_t uxMaxPayloadLength = 0U;
+        size_t uxPayloadOffset = 0U;
 
-                /* Returns positive when connected, negative means an error */
-                if( xResult < 0 )
-                {
-                    /* Return the error */
-                    break;
-                }
+        if( pxAddress != NULL )
+        {
+            /* Only check the address family. */
+            xResult = ( BaseType_t ) prvSendToGetPayloadOffset( pxAddress, &( uxMaxPayloadLength ), &( uxPayloadOffset ) );
 
-                if( xResult > 0 )
-                {
-                    /* Socket now connected, return a zero */
-                    xResult = 0;
-                    break;
-                }
+            if( ( xResult == 0 ) && ( prvMakeSureSocketIsBound( pxSocket ) == pdFALSE ) )
+            {
+                xResult = -pdFREERTOS_ERRNO_EADDRNOTAVAIL;
+            }
+        }
 
-                /* Is it allowed to sleep more? */
-                if( xTaskCheckForTimeOut( &xTimeOut, &xRemainingTime ) != pdFALSE )
+        if( xResult == 0 )
+        {
+            /* The IP-task reads the peer when filtering incoming packets. */
+            vTaskSuspendAll();
+            {
+                if( pxAddress != NULL )
                 {
-                    xResult = -pdFREERTOS_ERRNO_ETIMEDOUT;
-                    break;
+                    ( void ) memcpy( &( pxSocket->u.xUDP.xRemoteAddress ), pxAddress, sizeof( pxSocket->u.xUDP.xRemoteAddress ) );
+                    pxSocket->u.xUDP.xIsConnected = pdTRUE;
                 }
-
-                /* Go sleeping until we get any down-stream event */
-                uxEvents = xEventGroupWaitBits( pxSocket->xEventGroup,
-                                                ( EventBits_t ) eSOCKET_CONNECT | ( EventBits_t ) eSOCKET_CLOSED,
-                                                pdTRUE /*xClearOnExit*/,
-                                                pdFALSE /*xWaitAllBits*/,
-                                                xRemainingTime );
-
-                if( ( uxEvents & ( EventBits_t ) eSOCKET_CLOSED ) != 0U )
+                else
                 {
-                    xResult = -pdFREERTOS_ERRNO_ENOTCONN;
-                    FreeRTOS_debug_printf( ( "FreeRTOS_connect() stopped due to an error\n" ) );
-                    break;
+                    pxSocket->u.xUDP.xIsConnected = pdFALSE;
                 }
+
+                #if ( ipconfigUSE_IPv4 != 0 )
+                    /* The first packet will ask the IP-task for new headers. */
+                    pxSocket->u.xUDP.xHeaderValid = pdFALSE;
+                    pxSocket->u.xUDP.uxARPGeneration = uxARPCacheGeneration - 1U;
+                #endif
             }
+            ( void ) xTaskResumeAll();
         }
 
         return xResult;
     }
 
-#endif /* ipconfigUSE_TCP */
+#endif /* ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) || ( ipconfigUDP_BATCH_CALLS == 1 ) ) && ( ipconfigUSE_IPv4 != 0 ) )
+
+/**
+ * @brief Build the Ethernet, IP and UDP headers for IPv4 packets to a given
+ *        peer, so that they can be used for several packets.
+ *
+ * @param[out] pxHeader Where the headers will be stored.
+ * @param[in] ulDestinationIP The IP address of the peer.
+ * @param[in] usDestinationPort The port number of the peer, network order.
+ * @param[in] usSourcePort The local port number, network order.
+ * @param[in,out] ppxEndPoint The end-point to send from. When it points to
+ *                            NULL, the end-point found in the ARP cache is used.
+ *
+ * @return pdTRUE when the MAC address of the next hop is known and the
+ *         headers are ready, otherwise pdFALSE.
+ */
+    static BaseType_t prvUDPHeaderBuild( UDPPacket_t * pxHeader,
+                                         uint32_t ulDestinationIP,
+                                         uint16_t usDestinationPort,
+                                         uint16_t usSourcePort,
+                                         NetworkEndPoint_t ** ppxEndPoint )
+    {
+        BaseType_t xReturn = pdFALSE;
+        eResolutionLookupResult_t eResult = eResolutionFailed;
+        uint32_t ulIPAddress = ulDestinationIP;
+        MACAddress_t xMACAddress;
+        NetworkEndPoint_t * pxFoundEndPoint = NULL;
+        NetworkEndPoint_t * pxEndPoint;
+
+        /* Multi-cast packets may need a special TTL, they take the normal path. */
+        if( xIsIPv4Multicast( ulIPAddress ) == pdFALSE )
+        {
+            eResult = eARPGetCacheEntry( &( ulIPAddress ), &( xMACAddress ), &( pxFoundEndPoint ) );
+        }
+
+        /* Like vProcessGeneratedUDPPacket_IPv4(), prefer the end-point of the socket. */
+        pxEndPoint = ( *ppxEndPoint != NULL ) ? *ppxEndPoint : pxFoundEndPoint;
+
+        if( ( eResult == eResolutionCacheHit ) &&
+            ( pxEndPoint != NULL ) &&
+            ( pxEndPoint->ipv4_settings.ulIPAddress != 0U ) )
+        {
+            ( void ) memset( pxHeader, 0, sizeof( *pxHeader ) );
+            ( void ) memcpy( pxHeader->xEthernetHeader.xDestinationAddress.ucBytes, xMACAddress.ucBytes, ipMAC_ADDRESS_LENGTH_BYTES );
+            ( void ) memcpy( pxHeader->xEthernetHeader.xSourceAddress.ucBytes, pxEndPoint->xMACAddress.ucBytes, ipMAC_ADDRESS_LENGTH_BYTES );
+            pxHeader->xEthernetHeader.usFrameType = ipIPv4_FRAME_TYPE;
+            pxHeader->xIPHeader.ucVersionHeaderLength = ipIPV4_VERSION_HEADER_LENGTH_MIN;
+            pxHeader->xIPHeader.ucTimeToLive = ipconfigUDP_TIME_TO_LIVE;
+            pxHeader->xIPHeader.ucProtocol = ipPROTOCOL_UDP;
+            #if ( ipconfigFORCE_IP_DONT_FRAGMENT != 0 )
+                pxHeader->xIPHeader.usFragmentOffset = ipFRAGMENT_FLAGS_DONT_FRAGMENT;
+            #endif
+            pxHeader->xIPHeader.ulSourceIPAddress = pxEndPoint->ipv4_settings.ulIPAddress;
+            pxHeader->xIPHeader.ulDestinationIPAddress = ulDestinationIP;
+            pxHeader->xUDPHeader.usSourcePort = usSourcePort;
+            pxHeader->xUDPHeader.usDestinationPort = usDestinationPort;
+
+            *ppxEndPoint = pxEndPoint;
+            xReturn = pdTRUE;
+        }
+
+        return xReturn;
+    }
+
+#endif /* ( ( ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) || ( ipconfigUDP_BATCH_CALLS == 1 ) ) && ( ipconfigUSE_IPv4 != 0 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) || ( ipconfigUDP_BATCH_CALLS == 1 ) ) && ( ipconfigUSE_IPv4 != 0 ) )
+
+/**
+ * @brief Complete an IPv4 UDP packet with headers made by prvUDPHeaderBuild().
+ *        The packet can be passed to the network interface directly.
+ *
+ * @param[in] pxHeader The pre-built headers.
+ * @param[in] pxEndPoint The end-point returned by prvUDPHeaderBuild().
+ * @param[in] pxNetworkBuffer The packet, the payload is already in place.
+ * @param[in] uxTotalDataLength The number of payload bytes.
+ * @param[in] ucSocketOptions The socket options, FREERTOS_SO_UDPCKSUM_OUT is tested.
+ */
+    static void prvUDPHeaderComplete( const UDPPacket_t * pxHeader,
+                                      NetworkEndPoint_t * pxEndPoint,
+                                      NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                      size_t uxTotalDataLength,
+                                      uint8_t ucSocketOptions )
+    {
+        /* MISRA Ref 11.3.1 [Misaligned access] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+        /* coverity[misra_c_2012_rule_11_3_violation] */
+        UDPPacket_t * pxUDPPacket = ( ( UDPPacket_t * ) pxNetworkBuffer->pucEthernetBuffer );
+
+        iptraceSENDING_UDP_PACKET( pxHeader->xIPHeader.ulDestinationIPAddress );
+
+        ( void ) memcpy( pxUDPPacket, pxHeader, sizeof( *pxHeader ) );
+
+        pxNetworkBuffer->xDataLength = uxTotalDataLength + sizeof( UDPPacket_t );
+        pxNetworkBuffer->xIPAddress.ulIP_IPv4 = pxHeader->xIPHeader.ulDestinationIPAddress;
+        pxNetworkBuffer->usPort = pxHeader->xUDPHeader.usDestinationPort;
+        pxNetworkBuffer->usBoundPort = pxHeader->xUDPHeader.usSourcePort;
+        pxNetworkBuffer->pxEndPoint = pxEndPoint;
+        pxNetworkBuffer->pxInterface = pxEndPoint->pxNetworkInterface;
+
+        pxUDPPacket->xUDPHeader.usLength = FreeRTOS_htons( ( uint16_t ) ( uxTotalDataLength + sizeof( UDPHeader_t ) ) );
+        pxUDPPacket->xIPHeader.usLength = FreeRTOS_htons( ( uint16_t ) ( uxTotalDataLength + sizeof( IPHeader_t ) + sizeof( UDPHeader_t ) ) );
+
+        #if ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+        {
+            pxUDPPacket->xIPHeader.usHeaderChecksum = usGenerateChecksum( 0U, ( uint8_t * ) &( pxUDPPacket->xIPHeader.ucVersionHeaderLength ), ipSIZE_OF_IPv4_HEADER );
+            pxUDPPacket->xIPHeader.usHeaderChecksum = ( uint16_t ) ~FreeRTOS_htons( pxUDPPacket->xIPHeader.usHeaderChecksum );
+
+            if( ( ucSocketOptions & ( uint8_t ) FREERTOS_SO_UDPCKSUM_OUT ) != 0U )
+            {
+                ( void ) usGenerateProtocolChecksum( pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength, pdTRUE );
+            }
+        }
+        #else
+            ( void ) ucSocketOptions;
+        #endif /* ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 ) */
+
+        #if ( ipconfigETHERNET_MINIMUM_PACKET_BYTES > 0 )
+        {
+            if( pxNetworkBuffer->xDataLength < ( size_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES )
+            {
+                ( void ) memset( &( pxNetworkBuffer->pucEthernetBuffer[ pxNetworkBuffer->xDataLength ] ), 0, ( size_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES - pxNetworkBuffer->xDataLength );
+                pxNetworkBuffer->xDataLength = ( size_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES;
+            }
+        }
+        #endif /* ( ipconfigETHERNET_MINIMUM_PACKET_BYTES > 0 ) */
+    }
+
+#endif /* ( ( ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) || ( ipconfigUDP_BATCH_CALLS == 1 ) ) && ( ipconfigUSE_IPv4 != 0 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUDP_CONNECTED_SOCKETS == 1 )
+
+/**
+ * @brief Get the address of the peer of a connected UDP socket.
+ *
+ * @param[in] pxSocket The socket.
+ *
+ * @return The peer, or NULL when the socket is not a connected UDP socket.
+ */
+    static const struct freertos_sockaddr * prvUDPConnectedPeer( FreeRTOS_Socket_t * pxSocket )
+    {
+        const struct freertos_sockaddr * pxPeer = NULL;
+
+        if( ( prvValidSocket( pxSocket, FREERTOS_IPPROTO_UDP, pdFALSE ) == pdTRUE ) &&
+            ( pxSocket->u.xUDP.xIsConnected != pdFALSE ) )
+        {
+            pxPeer = &( pxSocket->u.xUDP.xRemoteAddress );
+        }
+
+        return pxPeer;
+    }
+
+#endif /* ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) && ( ipconfigUSE_IPv4 != 0 ) )
+
+/**
+ * @brief Complete a UDP packet for the peer of a connected socket, using the
+ *        headers cached by vSocketUDPHeaderRefresh(). The packet can be passed
+ *        to the network interface without an ARP lookup.
+ *        When the headers are missing or older than the ARP cache, the IP-task
+ *        is asked to build them again.
+ *
+ * @param[in] pxSocket The connected socket.
+ * @param[in] pxNetworkBuffer The packet, the payload is already in place.
+ * @param[in] uxTotalDataLength The number of payload bytes.
+ *
+ * @return pdTRUE when the packet is complete, pdFALSE when the headers are not
+ *         available and the packet must go through the IP-task as usual.
+ */
+    static BaseType_t prvUDPConnectedHeaders( FreeRTOS_Socket_t * pxSocket,
+                                              NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                              size_t uxTotalDataLength )
+    {
+        BaseType_t xReturn = pdFALSE;
+        BaseType_t xRefresh = pdFALSE;
+        UDPPacket_t xHeader;
+        NetworkEndPoint_t * pxEndPoint = NULL;
+        IPStackEvent_t xHeaderEvent;
+
+        /* Take a consistent copy, the IP-task may be refreshing the headers. */
+        vTaskSuspendAll();
+        {
+            if( ( pxSocket->u.xUDP.xHeaderValid != pdFALSE ) &&
+                ( pxSocket->u.xUDP.uxARPGeneration == uxARPCacheGeneration ) )
+            {
+                ( void ) memcpy( &( xHeader ), pxSocket->u.xUDP.ucHeader, sizeof( xHeader ) );
+                pxEndPoint = pxSocket->u.xUDP.pxRemoteEndPoint;
+                xReturn = pdTRUE;
+            }
+            else if( ( pxSocket->u.xUDP.xHeaderPending == pdFALSE ) &&
+                     ( pxSocket->u.xUDP.uxARPGeneration != uxARPCacheGeneration ) )
+            {
+                pxSocket->u.xUDP.xHeaderPending = pdTRUE;
+                xRefresh = pdTRUE;
+            }
+            else
+            {
+                /* A request is pending, or the peer was not found in an ARP
+                 * cache that has not changed since. */
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        if( xReturn == pdTRUE )
+        {
+            prvUDPHeaderComplete( &( xHeader ), pxEndPoint, pxNetworkBuffer, uxTotalDataLength, pxSocket->ucSocketOptions );
+        }
+        else if( xRefresh != pdFALSE )
+        {
+            /* The ARP cache and the end-points belong to the IP-task. */
+            xHeaderEvent.eEventType = eSocketUDPHeaderEvent;
+            xHeaderEvent.pvData = pxSocket;
+
+            if( xSendEventStructToIPTask( &( xHeaderEvent ), 0U ) != pdPASS )
+            {
+                /* A next packet will try again. */
+                pxSocket->u.xUDP.xHeaderPending = pdFALSE;
+            }
+        }
+        else
+        {
+            /* MISRA 15.7 Compliance */
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Called by the IP-task to build the headers for the peer of a
+ *        connected UDP socket again, after prvUDPConnectedHeaders() found that
+ *        they were missing or that the ARP cache has changed.
+ *
+ * @param[in] pxSocket The connected UDP socket.
+ */
+    void vSocketUDPHeaderRefresh( FreeRTOS_Socket_t * pxSocket )
+    {
+        UDPPacket_t xHeader;
+        NetworkEndPoint_t * pxEndPoint = pxSocket->pxEndPoint;
+        BaseType_t xHeaderValid = pdFALSE;
+        UBaseType_t uxGeneration = uxARPCacheGeneration;
+        const struct freertos_sockaddr * pxPeer = &( pxSocket->u.xUDP.xRemoteAddress );
+
+        if( ( pxSocket->u.xUDP.xIsConnected != pdFALSE ) &&
+            ( pxPeer->sin_family == ( uint8_t ) FREERTOS_AF_INET4 ) )
+        {
+            xHeaderValid = prvUDPHeaderBuild( &( xHeader ),
+                                              pxPeer->sin_address.ulIP_IPv4,
+                                              pxPeer->sin_port,
+                                              ( uint16_t ) socketGET_SOCKET_PORT( pxSocket ),
+                                              &( pxEndPoint ) );
+        }
+
+        /* The user's task reads the headers while the scheduler is suspended. */
+        vTaskSuspendAll();
+        {
+            if( xHeaderValid != pdFALSE )
+            {
+                ( void ) memcpy( pxSocket->u.xUDP.ucHeader, &( xHeader ), sizeof( xHeader ) );
+                pxSocket->u.xUDP.pxRemoteEndPoint = pxEndPoint;
+            }
+
+            /* After a failure, wait for a change of the ARP cache before trying again. */
+            pxSocket->u.xUDP.uxARPGeneration = uxGeneration;
+            pxSocket->u.xUDP.xHeaderValid = xHeaderValid;
+            pxSocket->u.xUDP.xHeaderPending = pdFALSE;
+        }
+        ( void ) xTaskResumeAll();
+    }
+
+#endif /* ( ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) && ( ipconfigUSE_IPv4 != 0 ) ) */
 /*-----------------------------------------------------------*/
 
 #if ( ipconfigUSE_TCP == 1 )
@@ -3899,7 +5923,20 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
         {
             if( pxParentSocket->u.xTCP.bits.bReuseSocket == ipFALSE_BOOL )
             {
-                pxClientSocket = pxParentSocket->u.xTCP.pxPeerSocket;
+                #if ( ipconfigTCP_ACCEPT_QUEUE == 1 )
+                {
+                    /* Take the oldest child from the accept queue. */
+                    if( listLIST_IS_EMPTY( &( pxParentSocket->u.xTCP.xAcceptQueue ) ) == pdFALSE )
+                    {
+                        pxClientSocket = ( ( FreeRTOS_Socket_t * ) listGET_OWNER_OF_HEAD_ENTRY( &( pxParentSocket->u.xTCP.xAcceptQueue ) ) );
+                        ( void ) uxListRemove( &( pxClientSocket->u.xTCP.xAcceptItem ) );
+                    }
+                }
+                #else
+                {
+                    pxClientSocket = pxParentSocket->u.xTCP.pxPeerSocket;
+                }
+                #endif /* ipconfigTCP_ACCEPT_QUEUE */
             }
             else
             {
@@ -4001,7 +6038,10 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
         TickType_t xRemainingTime;
         BaseType_t xTimed = pdFALSE;
         TimeOut_t xTimeOut;
-        IPStackEvent_t xAskEvent;
+
+        #if ( ipconfigTCP_ACCEPT_QUEUE == 0 )
+            IPStackEvent_t xAskEvent;
+        #endif
 
         if( prvValidSocket( pxSocket, FREERTOS_IPPROTO_TCP, pdTRUE ) == pdFALSE )
         {
@@ -4031,14 +6071,18 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
 
                 if( pxClientSocket != NULL )
                 {
-                    if( pxSocket->u.xTCP.bits.bReuseSocket == ipFALSE_BOOL )
+                    #if ( ipconfigTCP_ACCEPT_QUEUE == 0 )
                     {
-                        /* Ask to set an event in 'xEventGroup' as soon as a new
-                         * client gets connected for this listening socket. */
-                        xAskEvent.eEventType = eTCPAcceptEvent;
-                        xAskEvent.pvData = pxSocket;
-                        ( void ) xSendEventStructToIPTask( &xAskEvent, portMAX_DELAY );
+                        if( pxSocket->u.xTCP.bits.bReuseSocket == ipFALSE_BOOL )
+                        {
+                            /* Ask to set an event in 'xEventGroup' as soon as a new
+                             * client gets connected for this listening socket. */
+                            xAskEvent.eEventType = eTCPAcceptEvent;
+                            xAskEvent.pvData = pxSocket;
+                            ( void ) xSendEventStructToIPTask( &xAskEvent, portMAX_DELAY );
+                        }
                     }
+                    #endif /* ipconfigTCP_ACCEPT_QUEUE == 0 */
 
                     break;
                 }
@@ -4078,6 +6122,71 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
         return pxClientSocket;
     }
 
+    #if ( ipconfigTCP_ACCEPT_QUEUE == 1 )
+
+/**
+ * @brief Accept several connections on a listening socket in a single call.
+ *
+ * @param[in] xServerSocket The socket in listening mode.
+ * @param[out] pxClientSockets An array that will receive the connected sockets.
+ * @param[in] xMaxCount The number of entries in 'pxClientSockets'.
+ *
+ * @return The number of sockets that were stored in 'pxClientSockets'. Zero is
+ *         returned when no connection became ready within the receive time-out
+ *         of the listening socket. -pdFREERTOS_ERRNO_EINVAL is returned when a
+ *         parameter is invalid, or when the socket is not a listening socket
+ *         that creates child sockets.
+ *
+ * @note Only the first connection is waited for, the other ones are taken from
+ *       the accept queue when they are already available.
+ */
+        BaseType_t FreeRTOS_accept_batch( Socket_t xServerSocket,
+                                          Socket_t * pxClientSockets,
+                                          BaseType_t xMaxCount )
+        {
+            FreeRTOS_Socket_t * pxSocket = ( FreeRTOS_Socket_t * ) xServerSocket;
+            FreeRTOS_Socket_t * pxClientSocket;
+            BaseType_t xCount = 0;
+
+            if( ( pxClientSockets == NULL ) ||
+                ( xMaxCount <= 0 ) ||
+                ( prvValidSocket( pxSocket, FREERTOS_IPPROTO_TCP, pdTRUE ) == pdFALSE ) ||
+                ( pxSocket->u.xTCP.bits.bReuseSocket != ipFALSE_BOOL ) )
+            {
+                xCount = -pdFREERTOS_ERRNO_EINVAL;
+            }
+            else
+            {
+                /* The first client is waited for as in a normal call to accept(). */
+                pxClientSocket = FreeRTOS_accept( xServerSocket, NULL, NULL );
+
+                /* MISRA Ref 11.4.1 [Socket error and integer to pointer conversion] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-114 */
+                /* coverity[misra_c_2012_rule_11_4_violation] */
+                if( pxClientSocket == FREERTOS_INVALID_SOCKET )
+                {
+                    xCount = -pdFREERTOS_ERRNO_EINVAL;
+                }
+
+                while( ( xCount >= 0 ) && ( pxClientSocket != NULL ) )
+                {
+                    pxClientSockets[ xCount ] = pxClientSocket;
+                    xCount++;
+
+                    if( xCount >= xMaxCount )
+                    {
+                        break;
+                    }
+
+                    /* Collect the clients that are ready already, without blocking. */
+                    pxClientSocket = prvAcceptWaitClient( pxSocket, NULL, NULL );
+                }
+            }
+
+            return xCount;
+        }
+    #endif /* ipconfigTCP_ACCEPT_QUEUE == 1 */
+
 #endif /* ipconfigUSE_TCP */
 /*-----------------------------------------------------------*/
 
@@ -4114,20 +6223,7 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
                                             ( size_t ) uxBufferLength,
                                             xIsPeek );
 
-            if( pxSocket->u.xTCP.bits.bLowWater != ipFALSE_BOOL )
-            {
-                /* We had reached the low-water mark, now see if the flag
-                 * can be cleared */
-                size_t uxFrontSpace = uxStreamBufferFrontSpace( pxSocket->u.xTCP.rxStream );
-
-                if( uxFrontSpace >= pxSocket->u.xTCP.uxEnoughSpace )
-                {
-                    pxSocket->u.xTCP.bits.bLowWater = ipFALSE_BOOL;
-                    pxSocket->u.xTCP.bits.bWinChange = ipTRUE_BOOL;
-                    pxSocket->u.xTCP.usTimeout = 1U; /* because bLowWater is cleared. */
-                    ( void ) xSendEventToIPTask( eTCPTimerEvent );
-                }
-            }
+            prvRecvCheckLowWater( pxSocket );
         }
         else
         {
@@ -4142,6 +6238,73 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
 
 #if ( ipconfigUSE_TCP == 1 )
 
+/**
+ * @brief Called after data has been read from the rxStream. When the
+ *        low-water mark had been reached, see if there is enough space now
+ *        to let the IP-task send a window update.
+ *        When the reception window is tuned, this is also the moment to let
+ *        the rxStream grow.
+ *
+ * @param[in] pxSocket The socket owning the connection.
+ */
+    static void prvRecvCheckLowWater( FreeRTOS_Socket_t * pxSocket )
+    {
+        #if ( ipconfigTCP_RX_AUTOTUNE == 1 )
+        {
+            prvTCPRxStreamCheckGrow( pxSocket );
+        }
+        #endif
+
+        if( pxSocket->u.xTCP.bits.bLowWater != ipFALSE_BOOL )
+        {
+            /* We had reached the low-water mark, now see if the flag
+             * can be cleared */
+            size_t uxFrontSpace = uxStreamBufferFrontSpace( pxSocket->u.xTCP.rxStream );
+
+            if( uxFrontSpace >= prvTCPRxWaterMark( pxSocket, pxSocket->u.xTCP.uxEnoughSpace ) )
+            {
+                pxSocket->u.xTCP.bits.bLowWater = ipFALSE_BOOL;
+                pxSocket->u.xTCP.bits.bWinChange = ipTRUE_BOOL;
+                pxSocket->u.xTCP.usTimeout = 1U; /* because bLowWater is cleared. */
+                ( void ) xSendEventToIPTask( eTCPTimerEvent );
+            }
+        }
+    }
+#endif /* ( ipconfigUSE_TCP == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_TCP == 1 )
+
+/**
+ * @brief Called by prvRecvWait() to see if there is anything to read.
+ *
+ * @param[in] pxSocket The socket owning the connection.
+ *
+ * @return The number of bytes in the stream buffer. When lent segments are
+ *         queued, their count is added so that the result is non-zero.
+ */
+    static BaseType_t prvRecvGetCount( const FreeRTOS_Socket_t * pxSocket )
+    {
+        BaseType_t xCount = 0;
+
+        if( pxSocket->u.xTCP.rxStream != NULL )
+        {
+            xCount = ( BaseType_t ) uxStreamBufferGetSize( pxSocket->u.xTCP.rxStream );
+        }
+
+        #if ( ipconfigTCP_RX_BUFFER_LENDING == 1 )
+        {
+            xCount += ( BaseType_t ) listCURRENT_LIST_LENGTH( &( pxSocket->u.xTCP.xRxLentList ) );
+        }
+        #endif
+
+        return xCount;
+    }
+#endif /* ( ipconfigUSE_TCP == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_TCP == 1 )
+
 /**
  * @brief After FreeRTOS_recv() has checked the validity of the parameters,
  *        this routine will wait for data to arrive in the stream buffer.
@@ -4162,10 +6325,7 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
         TimeOut_t xTimeOut;
         EventBits_t xEventBits = ( EventBits_t ) 0U;
 
-        if( pxSocket->u.xTCP.rxStream != NULL )
-        {
-            xByteCount = ( BaseType_t ) uxStreamBufferGetSize( pxSocket->u.xTCP.rxStream );
-        }
+        xByteCount = prvRecvGetCount( pxSocket );
 
         while( xByteCount == 0 )
         {
@@ -4240,10 +6400,7 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
             }
             #endif /* ipconfigSUPPORT_SIGNALS */
 
-            if( pxSocket->u.xTCP.rxStream != NULL )
-            {
-                xByteCount = ( BaseType_t ) uxStreamBufferGetSize( pxSocket->u.xTCP.rxStream );
-            }
+            xByteCount = prvRecvGetCount( pxSocket );
         } /* while( xByteCount == 0 ) */
 
         *( pxEventBits ) = xEventBits;
@@ -4255,6 +6412,49 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
 
 #if ( ipconfigUSE_TCP == 1 )
 
+/**
+ * @brief Wait for incoming data like prvRecvWait(). When the wait was
+ *        interrupted by a signal, -pdFREERTOS_ERRNO_EINTR is returned and the
+ *        other event bits that were cleared are set again.
+ *
+ * @param[in] pxSocket The socket owning the connection.
+ * @param[in] xFlags flags passed by the user, see prvRecvWait().
+ *
+ * @return The result of prvRecvWait(), or -pdFREERTOS_ERRNO_EINTR.
+ */
+    static BaseType_t prvRecvWaitSignal( const FreeRTOS_Socket_t * pxSocket,
+                                         BaseType_t xFlags )
+    {
+        EventBits_t xEventBits = ( EventBits_t ) 0U;
+        BaseType_t xByteCount = prvRecvWait( pxSocket, &( xEventBits ), xFlags );
+
+        #if ( ipconfigSUPPORT_SIGNALS != 0 )
+        {
+            if( ( xEventBits & ( EventBits_t ) eSOCKET_INTR ) != 0U )
+            {
+                if( ( xEventBits & ( ( EventBits_t ) eSOCKET_RECEIVE | ( EventBits_t ) eSOCKET_CLOSED ) ) != 0U )
+                {
+                    /* Shouldn't have cleared other flags. */
+                    xEventBits &= ~( ( EventBits_t ) eSOCKET_INTR );
+                    ( void ) xEventGroupSetBits( pxSocket->xEventGroup, xEventBits );
+                }
+
+                xByteCount = -pdFREERTOS_ERRNO_EINTR;
+            }
+        }
+        #else
+        {
+            ( void ) xEventBits;
+        }
+        #endif /* ipconfigSUPPORT_SIGNALS */
+
+        return xByteCount;
+    }
+#endif /* ( ipconfigUSE_TCP == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_TCP == 1 )
+
 /**
  * @brief Read incoming data from a TCP socket. Only after the last
  *        byte has been read, a close error might be returned.
@@ -4276,7 +6476,6 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
     {
         BaseType_t xByteCount = 0;
         FreeRTOS_Socket_t * pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
-        EventBits_t xEventBits = ( EventBits_t ) 0U;
 
         /* Check if the socket is valid, has type TCP and if it is bound to a
          * port. */
@@ -4287,42 +6486,273 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
         else if( ( ( ( uint32_t ) xFlags & ( uint32_t ) FREERTOS_ZERO_COPY ) != 0U ) &&
                  ( pvBuffer == NULL ) )
         {
-            /* In zero-copy mode, pvBuffer is a pointer to a pointer ( not NULL ). */
-            xByteCount = -pdFREERTOS_ERRNO_EINVAL;
+            /* In zero-copy mode, pvBuffer is a pointer to a pointer ( not NULL ). */
+            xByteCount = -pdFREERTOS_ERRNO_EINVAL;
+        }
+        else
+        {
+            /* The function parameters have been checked, now wait for incoming data. */
+            xByteCount = prvRecvWaitSignal( pxSocket, xFlags );
+
+            if( xByteCount > 0 )
+            {
+                #if ( ipconfigTCP_RX_BUFFER_LENDING == 1 )
+                    if( listLIST_IS_EMPTY( &( pxSocket->u.xTCP.xRxLentList ) ) == pdFALSE )
+                    {
+                        /* Lent segments precede the data in the stream buffer,
+                         * their data is copied out first. */
+                        xByteCount = prvRecvLentData( pxSocket, pvBuffer, uxBufferLength, xFlags );
+                    }
+                    else
+                #endif
+                {
+                    /* Get the actual data from the buffer, or in case of zero-copy,
+                     * let *pvBuffer point to the RX-stream of the socket. */
+                    xByteCount = prvRecvData( pxSocket, pvBuffer, uxBufferLength, xFlags );
+                }
+            }
+        } /* prvValidSocket() */
+
+        return xByteCount;
+    }
+
+
+#endif /* ipconfigUSE_TCP */
+/*-----------------------------------------------------------*/
+
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_RX_BUFFER_LENDING == 1 ) )
+
+/**
+ * @brief Borrow the oldest received segment of a TCP socket that has the
+ *        option FREERTOS_SO_RX_BUFFER_LENDING set. No data will be copied.
+ *        Lent segments always precede the data in the stream buffer: when
+ *        this function returns zero with '*ppxBuffer' equal to NULL, the
+ *        next bytes must be read by calling FreeRTOS_recv().
+ *
+ * @param[in] xSocket The socket owning the connection.
+ * @param[out] ppxBuffer The network buffer that is lent to the caller.
+ * @param[out] puxOffset The offset of the payload within 'pucEthernetBuffer'.
+ * @param[in] xFlags Only FREERTOS_MSG_DONTWAIT is checked.
+ *
+ * @return The length of the payload, or zero when no segment is available,
+ *         or else a negative error code, like FreeRTOS_recv().
+ *         Each segment must be given back by calling FreeRTOS_release_lent()
+ *         before the socket is closed.
+ */
+    BaseType_t FreeRTOS_recv_lent( Socket_t xSocket,
+                                   NetworkBufferDescriptor_t ** ppxBuffer,
+                                   size_t * puxOffset,
+                                   BaseType_t xFlags )
+    {
+        BaseType_t xByteCount;
+        FreeRTOS_Socket_t * pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+        NetworkBufferDescriptor_t * pxNetworkBuffer = NULL;
+
+        if( ( prvValidSocket( pxSocket, FREERTOS_IPPROTO_TCP, pdTRUE ) == pdFALSE ) ||
+            ( ppxBuffer == NULL ) ||
+            ( puxOffset == NULL ) )
+        {
+            xByteCount = -pdFREERTOS_ERRNO_EINVAL;
+        }
+        else
+        {
+            *ppxBuffer = NULL;
+
+            xByteCount = prvRecvWaitSignal( pxSocket, xFlags );
+
+            if( xByteCount > 0 )
+            {
+                /* The IP-task appends to the list. */
+                vTaskSuspendAll();
+                {
+                    if( listLIST_IS_EMPTY( &( pxSocket->u.xTCP.xRxLentList ) ) == pdFALSE )
+                    {
+                        pxNetworkBuffer = ( ( NetworkBufferDescriptor_t * ) listGET_OWNER_OF_HEAD_ENTRY( &( pxSocket->u.xTCP.xRxLentList ) ) );
+                        ( void ) uxListRemove( &( pxNetworkBuffer->xBufferListItem ) );
+                    }
+                }
+                ( void ) xTaskResumeAll();
+
+                if( pxNetworkBuffer != NULL )
+                {
+                    *puxOffset = pxNetworkBuffer->uxPayloadOffset;
+                    *ppxBuffer = pxNetworkBuffer;
+                    xByteCount = ( BaseType_t ) ( pxNetworkBuffer->xDataLength - *puxOffset );
+                }
+                else
+                {
+                    /* The data is in the stream buffer. */
+                    xByteCount = 0;
+                }
+            }
+        } /* prvValidSocket() */
+
+        return xByteCount;
+    }
+#endif /* ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_RX_BUFFER_LENDING == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_RX_BUFFER_LENDING == 1 ) )
+
+/**
+ * @brief Give back a segment that was obtained by calling FreeRTOS_recv_lent().
+ *        The space becomes available again in the reception window.
+ *
+ * @param[in] xSocket The socket owning the connection.
+ * @param[in] pxBuffer The network buffer that was lent.
+ *
+ * @return 0 on success, or -pdFREERTOS_ERRNO_EINVAL in case of bad parameters.
+ */
+    BaseType_t FreeRTOS_release_lent( Socket_t xSocket,
+                                      NetworkBufferDescriptor_t * pxBuffer )
+    {
+        BaseType_t xReturn;
+        FreeRTOS_Socket_t * pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+
+        if( ( prvValidSocket( pxSocket, FREERTOS_IPPROTO_TCP, pdFALSE ) == pdFALSE ) ||
+            ( pxBuffer == NULL ) ||
+            ( listLIST_ITEM_CONTAINER( &( pxBuffer->xBufferListItem ) ) != NULL ) )
+        {
+            xReturn = -pdFREERTOS_ERRNO_EINVAL;
+        }
+        else
+        {
+            size_t uxLength = pxBuffer->xDataLength - pxBuffer->uxPayloadOffset;
+
+            vReleaseNetworkBufferAndDescriptor( pxBuffer );
+            prvRecvLentConsumed( pxSocket, uxLength );
+
+            xReturn = 0;
+        }
+
+        return xReturn;
+    }
+#endif /* ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_RX_BUFFER_LENDING == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_RX_BUFFER_LENDING == 1 ) )
+
+/**
+ * @brief Called by FreeRTOS_recv() when lent segments are queued: read the
+ *        data from the oldest segment, as if it were stored in the rxStream.
+ *        The segment is released once all of its data has been read.
+ *
+ * @param[in] pxSocket The socket owning the connection.
+ * @param[out] pvBuffer The buffer to store the data in, or a pointer to a
+ *                      pointer in case of FREERTOS_ZERO_COPY.
+ * @param[in] uxBufferLength The length of the buffer.
+ * @param[in] xFlags FREERTOS_ZERO_COPY and FREERTOS_MSG_PEEK are checked.
+ *
+ * @return The number of bytes read, at most the size of one segment.
+ */
+    static BaseType_t prvRecvLentData( FreeRTOS_Socket_t * pxSocket,
+                                       void * pvBuffer,
+                                       size_t uxBufferLength,
+                                       BaseType_t xFlags )
+    {
+        BaseType_t xByteCount = 0;
+        NetworkBufferDescriptor_t * pxNetworkBuffer = NULL;
+
+        /* The IP-task appends to the list. */
+        vTaskSuspendAll();
+        {
+            if( listLIST_IS_EMPTY( &( pxSocket->u.xTCP.xRxLentList ) ) == pdFALSE )
+            {
+                pxNetworkBuffer = ( ( NetworkBufferDescriptor_t * ) listGET_OWNER_OF_HEAD_ENTRY( &( pxSocket->u.xTCP.xRxLentList ) ) );
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        if( pxNetworkBuffer != NULL )
+        {
+            uint8_t * pucPayload = &( pxNetworkBuffer->pucEthernetBuffer[ pxNetworkBuffer->uxPayloadOffset ] );
+            size_t uxLength = pxNetworkBuffer->xDataLength - pxNetworkBuffer->uxPayloadOffset;
+
+            if( ( ( uint32_t ) xFlags & ( uint32_t ) FREERTOS_ZERO_COPY ) != 0U )
+            {
+                /* The data is consumed by a next call with pvBuffer equal to NULL. */
+                *( ( uint8_t ** ) pvBuffer ) = pucPayload;
+            }
+            else
+            {
+                uxLength = FreeRTOS_min_size_t( uxLength, uxBufferLength );
+
+                if( pvBuffer != NULL )
+                {
+                    ( void ) memcpy( pvBuffer, pucPayload, uxLength );
+                }
+
+                if( ( ( uint32_t ) xFlags & ( uint32_t ) FREERTOS_MSG_PEEK ) == 0U )
+                {
+                    pxNetworkBuffer->uxPayloadOffset += uxLength;
+
+                    if( pxNetworkBuffer->uxPayloadOffset >= pxNetworkBuffer->xDataLength )
+                    {
+                        vTaskSuspendAll();
+                        {
+                            ( void ) uxListRemove( &( pxNetworkBuffer->xBufferListItem ) );
+                        }
+                        ( void ) xTaskResumeAll();
+
+                        vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+                    }
+
+                    prvRecvLentConsumed( pxSocket, uxLength );
+                }
+            }
+
+            xByteCount = ( BaseType_t ) uxLength;
+        }
+
+        return xByteCount;
+    }
+#endif /* ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_RX_BUFFER_LENDING == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_RX_BUFFER_LENDING == 1 ) )
+
+/**
+ * @brief Bytes of lent segments have been consumed by the user. The space
+ *        becomes available again in the reception window. When the low-water
+ *        mark had been reached, see if a window update can be sent.
+ *
+ * @param[in] pxSocket The socket owning the connection.
+ * @param[in] uxLength The number of bytes consumed.
+ */
+    static void prvRecvLentConsumed( FreeRTOS_Socket_t * pxSocket,
+                                     size_t uxLength )
+    {
+        vTaskSuspendAll();
+        {
+            pxSocket->u.xTCP.uxRxLentBytes -= FreeRTOS_min_size_t( uxLength, pxSocket->u.xTCP.uxRxLentBytes );
         }
-        else
-        {
-            /* The function parameters have been checked, now wait for incoming data. */
-            xByteCount = prvRecvWait( pxSocket, &( xEventBits ), xFlags );
-
-            #if ( ipconfigSUPPORT_SIGNALS != 0 )
-                if( ( xEventBits & ( EventBits_t ) eSOCKET_INTR ) != 0U )
-                {
-                    if( ( xEventBits & ( ( EventBits_t ) eSOCKET_RECEIVE | ( EventBits_t ) eSOCKET_CLOSED ) ) != 0U )
-                    {
-                        /* Shouldn't have cleared other flags. */
-                        xEventBits &= ~( ( EventBits_t ) eSOCKET_INTR );
-                        ( void ) xEventGroupSetBits( pxSocket->xEventGroup, xEventBits );
-                    }
+        ( void ) xTaskResumeAll();
 
-                    xByteCount = -pdFREERTOS_ERRNO_EINTR;
-                }
-                else
-            #endif /* ipconfigSUPPORT_SIGNALS */
+        if( pxSocket->u.xTCP.bits.bLowWater != ipFALSE_BOOL )
+        {
+            /* We had reached the low-water mark, now see if the flag
+             * can be cleared */
+            uint32_t ulFrontSpace;
 
-            if( xByteCount > 0 )
+            if( pxSocket->u.xTCP.rxStream != NULL )
             {
-                /* Get the actual data from the buffer, or in case of zero-copy,
-                 * let *pvBuffer point to the RX-stream of the socket. */
-                xByteCount = prvRecvData( pxSocket, pvBuffer, uxBufferLength, xFlags );
+                ulFrontSpace = ( uint32_t ) uxStreamBufferFrontSpace( pxSocket->u.xTCP.rxStream );
+            }
+            else
+            {
+                ulFrontSpace = ( uint32_t ) pxSocket->u.xTCP.uxRxStreamSize;
             }
-        } /* prvValidSocket() */
 
-        return xByteCount;
+            if( ulTCPRxLendSpace( pxSocket, ulFrontSpace ) >= ( uint32_t ) prvTCPRxWaterMark( pxSocket, pxSocket->u.xTCP.uxEnoughSpace ) )
+            {
+                pxSocket->u.xTCP.bits.bLowWater = ipFALSE_BOOL;
+                pxSocket->u.xTCP.bits.bWinChange = ipTRUE_BOOL;
+                pxSocket->u.xTCP.usTimeout = 1U; /* because bLowWater is cleared. */
+                ( void ) xSendEventToIPTask( eTCPTimerEvent );
+            }
+        }
     }
-
-
-#endif /* ipconfigUSE_TCP */
+#endif /* ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_RX_BUFFER_LENDING == 1 ) ) */
 /*-----------------------------------------------------------*/
 
 #if ( ipconfigUSE_TCP == 1 )
@@ -4518,6 +6948,10 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
         TimeOut_t xTimeOut;
         const uint8_t * pucSource = ( const uint8_t * ) pvBuffer;
 
+        #if ( ipconfigTCP_INFO == 1 )
+            TickType_t xBlockStart;
+        #endif
+
         /* While there are still bytes to be sent. */
         while( xBytesLeft > 0 )
         {
@@ -4616,94 +7050,476 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
                 /* Don't get here a second time. */
                 xTimed = pdTRUE;
 
-                /* Fetch the current time. */
-                vTaskSetTimeOutState( &xTimeOut );
+                /* Fetch the current time. */
+                vTaskSetTimeOutState( &xTimeOut );
+            }
+            else
+            {
+                /* Has the timeout been reached? */
+                if( xTaskCheckForTimeOut( &xTimeOut, &xRemainingTime ) != pdFALSE )
+                {
+                    break;
+                }
+            }
+
+            #if ( ipconfigTCP_INFO == 1 )
+            {
+                xBlockStart = xTaskGetTickCount();
+            }
+            #endif
+
+            /* Go sleeping until a SEND or a CLOSE event is received. */
+            ( void ) xEventGroupWaitBits( pxSocket->xEventGroup, ( EventBits_t ) eSOCKET_SEND | ( EventBits_t ) eSOCKET_CLOSED,
+                                          pdTRUE /*xClearOnExit*/, pdFALSE /*xWaitAllBits*/, xRemainingTime );
+
+            #if ( ipconfigTCP_INFO == 1 )
+            {
+                pxSocket->u.xTCP.xStreamBlockedTicks += xTaskGetTickCount() - xBlockStart;
+            }
+            #endif
+
+            xByteCount = ( BaseType_t ) prvTCPSendCheck( pxSocket, uxDataLength );
+
+            if( xByteCount < 0 )
+            {
+                /* In a meanwhile, the connection has dropped, stop iterating. */
+                break;
+            }
+
+            /* See if in a meanwhile there is space in the TX-stream. */
+            xByteCount = ( BaseType_t ) uxStreamBufferGetSpace( pxSocket->u.xTCP.txStream );
+        } /* while( xBytesLeft > 0 ) */
+
+        return xBytesSent;
+    }
+
+/**
+ * @brief Send data using a TCP socket. It is not necessary to have the socket
+ *        connected already. Outgoing data will be stored and delivered as soon as
+ *        the socket gets connected.
+ *
+ * @param[in] xSocket  The socket owning the connection.
+ * @param[in] pvBuffer The buffer containing the data. The value of this pointer
+ *                      may be NULL in case zero-copy transmissions are used.
+ *                      It is used in combination with 'FreeRTOS_get_tx_head()'.
+ * @param[in] uxDataLength The length of the data to be added.
+ * @param[in] xFlags This parameter is not used. (zero or FREERTOS_MSG_DONTWAIT).
+ *
+ * @return The number of bytes actually sent. Zero when nothing could be sent
+ *         or a negative error code in case an error occurred.
+ */
+    BaseType_t FreeRTOS_send( Socket_t xSocket,
+                              const void * pvBuffer,
+                              size_t uxDataLength,
+                              BaseType_t xFlags )
+    {
+        BaseType_t xByteCount;
+        FreeRTOS_Socket_t * pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+
+        xByteCount = ( BaseType_t ) prvTCPSendCheck( pxSocket, uxDataLength );
+
+        if( xByteCount > 0 )
+        {
+            /* prvTCPSendLoop() will try to send as many bytes as possible,
+             * returning number of bytes that have been queued for transmission.. */
+            xByteCount = prvTCPSendLoop( pxSocket, pvBuffer, uxDataLength, xFlags );
+
+            if( xByteCount == 0 )
+            {
+                if( pxSocket->u.xTCP.eTCPState > eESTABLISHED )
+                {
+                    xByteCount = ( BaseType_t ) -pdFREERTOS_ERRNO_ENOTCONN;
+                }
+                else
+                {
+                    if( ipconfigTCP_MAY_LOG_PORT( pxSocket->usLocalPort ) )
+                    {
+                        FreeRTOS_debug_printf( ( "FreeRTOS_send: %u -> %xip:%d: no space\n",
+                                                 pxSocket->usLocalPort,
+                                                 ( unsigned ) pxSocket->u.xTCP.xRemoteIP.ulIP_IPv4,
+                                                 pxSocket->u.xTCP.usRemotePort ) );
+                    }
+
+                    xByteCount = ( BaseType_t ) -pdFREERTOS_ERRNO_ENOSPC;
+                }
+            }
+        }
+
+        return xByteCount;
+    }
+
+
+#endif /* ipconfigUSE_TCP */
+/*-----------------------------------------------------------*/
+
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ( ipconfigTCP_TX_BY_REFERENCE == 1 ) || ( ipconfigSOCKET_IOVEC_CALLS == 1 ) ) )
+
+/**
+ * @brief Called from FreeRTOS_send_ref() and FreeRTOS_sendv(): wait until the
+ *        txStream has enough space to hold all bytes at once.
+ *
+ * @param[in] pxSocket The socket owning the connection.
+ * @param[in] uxLength The number of bytes that must fit in the txStream.
+ * @param[in] xFlags Only the flag 'FREERTOS_MSG_DONTWAIT' will be tested.
+ *
+ * @return 1 when there is enough space, 0 when the time-out was reached,
+ *         or a negative error code when the connection has dropped.
+ */
+    static BaseType_t prvTCPSendWaitSpace( FreeRTOS_Socket_t * pxSocket,
+                                           size_t uxLength,
+                                           BaseType_t xFlags )
+    {
+        BaseType_t xResult = 0;
+        TickType_t xRemainingTime = pxSocket->xSendBlockTime;
+        TimeOut_t xTimeOut;
+
+        #if ( ipconfigTCP_INFO == 1 )
+            TickType_t xBlockStart;
+        #endif
+
+        if( ( xIsCallingFromIPTask() != pdFALSE ) ||
+            ( ( ( uint32_t ) xFlags & ( uint32_t ) FREERTOS_MSG_DONTWAIT ) != 0U ) )
+        {
+            /* Never block the IP-task, see prvTCPSendLoop(). */
+            xRemainingTime = ( TickType_t ) 0U;
+        }
+
+        vTaskSetTimeOutState( &xTimeOut );
+
+        for( ; ; )
+        {
+            if( uxStreamBufferGetSpace( pxSocket->u.xTCP.txStream ) >= uxLength )
+            {
+                xResult = 1;
+                break;
+            }
+
+            if( ( xRemainingTime == ( TickType_t ) 0U ) ||
+                ( xTaskCheckForTimeOut( &xTimeOut, &xRemainingTime ) != pdFALSE ) )
+            {
+                break;
+            }
+
+            #if ( ipconfigTCP_INFO == 1 )
+            {
+                xBlockStart = xTaskGetTickCount();
+            }
+            #endif
+
+            /* Go sleeping until a SEND or a CLOSE event is received. */
+            ( void ) xEventGroupWaitBits( pxSocket->xEventGroup, ( EventBits_t ) eSOCKET_SEND | ( EventBits_t ) eSOCKET_CLOSED,
+                                          pdTRUE /*xClearOnExit*/, pdFALSE /*xWaitAllBits*/, xRemainingTime );
+
+            #if ( ipconfigTCP_INFO == 1 )
+            {
+                pxSocket->u.xTCP.xStreamBlockedTicks += xTaskGetTickCount() - xBlockStart;
+            }
+            #endif
+
+            xResult = ( BaseType_t ) prvTCPSendCheck( pxSocket, uxLength );
+
+            if( xResult <= 0 )
+            {
+                /* In a meanwhile, the connection has dropped. */
+                break;
+            }
+
+            xResult = 0;
+        }
+
+        return xResult;
+    }
+#endif /* ( ( ipconfigUSE_TCP == 1 ) && ( ( ipconfigTCP_TX_BY_REFERENCE == 1 ) || ( ipconfigSOCKET_IOVEC_CALLS == 1 ) ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_TX_BY_REFERENCE == 1 ) )
+
+/**
+ * @brief Send application-owned memory using a TCP socket. The data is not
+ *        copied to the txStream, only space is reserved there. Segments will
+ *        be filled from 'pxReference->pucData' until the peer has
+ *        acknowledged all bytes. After that, the IP-task will call
+ *        'pxReference->pxHandleDone'. The memory and the structure must stay
+ *        valid and unchanged until then.
+ *
+ * @param[in] xSocket The socket owning the connection.
+ * @param[in] pxReference The memory to be sent. 'uxLength' may not be larger
+ *                        than the size of the txStream: large objects are sent
+ *                        as a series of references.
+ * @param[in] xFlags Zero or FREERTOS_MSG_DONTWAIT.
+ *
+ * @return The number of bytes queued, which is either zero or all bytes of the
+ *         reference, or a negative error code.
+ */
+    BaseType_t FreeRTOS_send_ref( Socket_t xSocket,
+                                  TCPTxReference_t * pxReference,
+                                  BaseType_t xFlags )
+    {
+        BaseType_t xResult;
+        FreeRTOS_Socket_t * pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+
+        if( ( pxReference == NULL ) || ( pxReference->pucData == NULL ) )
+        {
+            xResult = -pdFREERTOS_ERRNO_EINVAL;
+        }
+        else
+        {
+            xResult = ( BaseType_t ) prvTCPSendCheck( pxSocket, pxReference->uxLength );
+        }
+
+        if( xResult > 0 )
+        {
+            /* The stream can hold at most LENGTH - 1 bytes. */
+            if( pxReference->uxLength >= pxSocket->u.xTCP.txStream->LENGTH )
+            {
+                xResult = -pdFREERTOS_ERRNO_EINVAL;
+            }
+            else
+            {
+                xResult = prvTCPSendWaitSpace( pxSocket, pxReference->uxLength, xFlags );
+            }
+        }
+
+        if( xResult > 0 )
+        {
+            pxReference->pxNext = NULL;
+            pxReference->uxAcked = 0U;
+
+            /* The IP-task may not see the new bytes before the reference is
+             * linked. */
+            vTaskSuspendAll();
+            {
+                pxReference->uxPosition = pxSocket->u.xTCP.txStream->uxHead;
+
+                if( pxSocket->u.xTCP.pxTxRefLast == NULL )
+                {
+                    pxSocket->u.xTCP.pxTxRefFirst = pxReference;
+                }
+                else
+                {
+                    pxSocket->u.xTCP.pxTxRefLast->pxNext = pxReference;
+                }
+
+                pxSocket->u.xTCP.pxTxRefLast = pxReference;
+
+                if( pxSocket->u.xTCP.bits.bCloseAfterSend != ipFALSE_BOOL )
+                {
+                    pxSocket->u.xTCP.bits.bCloseRequested = ipTRUE_BOOL;
+                }
+
+                /* Only advance the head, nothing is copied. */
+                ( void ) uxStreamBufferAdd( pxSocket->u.xTCP.txStream, 0U, NULL, pxReference->uxLength );
+            }
+            ( void ) xTaskResumeAll();
+
+            pxSocket->u.xTCP.usTimeout = 1U;
+
+            if( xIsCallingFromIPTask() == pdFALSE )
+            {
+                ( void ) xSendEventToIPTask( eTCPTimerEvent );
+            }
+
+            xResult = ( BaseType_t ) pxReference->uxLength;
+        }
+
+        return xResult;
+    }
+#endif /* ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_TX_BY_REFERENCE == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigSOCKET_IOVEC_CALLS == 1 ) )
+
+/**
+ * @brief Send the contents of several buffers using a TCP socket. All bytes
+ *        are added to the txStream in one step, so that e.g. a header and a
+ *        payload can be sent in the same segment.
+ *
+ * @param[in] xSocket The socket owning the connection.
+ * @param[in] pxIOVector The buffers to be sent.
+ * @param[in] uxIOCount The number of buffers in 'pxIOVector'.
+ * @param[in] xFlags Zero or FREERTOS_MSG_DONTWAIT.
+ *
+ * @return The number of bytes queued, which is either zero or the total
+ *         length of all buffers, or a negative error code. The total length
+ *         may not be larger than the size of the txStream.
+ */
+    BaseType_t FreeRTOS_sendv( Socket_t xSocket,
+                               const struct freertos_iovec * pxIOVector,
+                               size_t uxIOCount,
+                               BaseType_t xFlags )
+    {
+        BaseType_t xResult;
+        FreeRTOS_Socket_t * pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+        size_t uxTotal = 0U;
+
+        if( prvIOVectorLength( pxIOVector, uxIOCount, &( uxTotal ) ) == pdFALSE )
+        {
+            xResult = -pdFREERTOS_ERRNO_EINVAL;
+        }
+        else
+        {
+            xResult = ( BaseType_t ) prvTCPSendCheck( pxSocket, uxTotal );
+        }
+
+        if( xResult > 0 )
+        {
+            /* The stream can hold at most LENGTH - 1 bytes. */
+            if( uxTotal >= pxSocket->u.xTCP.txStream->LENGTH )
+            {
+                xResult = -pdFREERTOS_ERRNO_EINVAL;
             }
             else
             {
-                /* Has the timeout been reached? */
-                if( xTaskCheckForTimeOut( &xTimeOut, &xRemainingTime ) != pdFALSE )
+                xResult = prvTCPSendWaitSpace( pxSocket, uxTotal, xFlags );
+            }
+        }
+
+        if( xResult > 0 )
+        {
+            size_t uxIndex;
+            size_t uxOffset = pxIOVector[ 0 ].iov_len;
+
+            /* First store the other buffers beyond the head, where the IP-task
+             * will not look yet. */
+            for( uxIndex = 1U; uxIndex < uxIOCount; uxIndex++ )
+            {
+                if( pxIOVector[ uxIndex ].iov_len != 0U )
                 {
-                    break;
+                    ( void ) uxStreamBufferAdd( pxSocket->u.xTCP.txStream, uxOffset, ( const uint8_t * ) pxIOVector[ uxIndex ].iov_base, pxIOVector[ uxIndex ].iov_len );
+                    uxOffset += pxIOVector[ uxIndex ].iov_len;
                 }
             }
 
-            /* Go sleeping until a SEND or a CLOSE event is received. */
-            ( void ) xEventGroupWaitBits( pxSocket->xEventGroup, ( EventBits_t ) eSOCKET_SEND | ( EventBits_t ) eSOCKET_CLOSED,
-                                          pdTRUE /*xClearOnExit*/, pdFALSE /*xWaitAllBits*/, xRemainingTime );
+            /* Now add the first buffer and move the head over all bytes, before
+             * the IP-task can see any of them. */
+            vTaskSuspendAll();
+            {
+                if( pxSocket->u.xTCP.bits.bCloseAfterSend != ipFALSE_BOOL )
+                {
+                    pxSocket->u.xTCP.bits.bCloseRequested = ipTRUE_BOOL;
+                }
 
-            xByteCount = ( BaseType_t ) prvTCPSendCheck( pxSocket, uxDataLength );
+                ( void ) uxStreamBufferAdd( pxSocket->u.xTCP.txStream, 0U, ( const uint8_t * ) pxIOVector[ 0 ].iov_base, pxIOVector[ 0 ].iov_len );
+                ( void ) uxStreamBufferAdd( pxSocket->u.xTCP.txStream, 0U, NULL, uxTotal - pxIOVector[ 0 ].iov_len );
+            }
+            ( void ) xTaskResumeAll();
 
-            if( xByteCount < 0 )
+            pxSocket->u.xTCP.usTimeout = 1U;
+
+            if( xIsCallingFromIPTask() == pdFALSE )
             {
-                /* In a meanwhile, the connection has dropped, stop iterating. */
-                break;
+                ( void ) xSendEventToIPTask( eTCPTimerEvent );
             }
 
-            /* See if in a meanwhile there is space in the TX-stream. */
-            xByteCount = ( BaseType_t ) uxStreamBufferGetSpace( pxSocket->u.xTCP.txStream );
-        } /* while( xBytesLeft > 0 ) */
+            xResult = ( BaseType_t ) uxTotal;
+        }
 
-        return xBytesSent;
+        return xResult;
     }
+#endif /* ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigSOCKET_IOVEC_CALLS == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigSOCKET_IOVEC_CALLS == 1 ) )
 
 /**
- * @brief Send data using a TCP socket. It is not necessary to have the socket
- *        connected already. Outgoing data will be stored and delivered as soon as
- *        the socket gets connected.
+ * @brief Read incoming data from a TCP socket into several buffers. The
+ *        buffers are filled in order, as long as data is available.
  *
- * @param[in] xSocket  The socket owning the connection.
- * @param[in] pvBuffer The buffer containing the data. The value of this pointer
- *                      may be NULL in case zero-copy transmissions are used.
- *                      It is used in combination with 'FreeRTOS_get_tx_head()'.
- * @param[in] uxDataLength The length of the data to be added.
- * @param[in] xFlags This parameter is not used. (zero or FREERTOS_MSG_DONTWAIT).
+ * @param[in] xSocket The socket owning the connection.
+ * @param[in] pxIOVector The buffers to store the incoming data in.
+ * @param[in] uxIOCount The number of buffers in 'pxIOVector'.
+ * @param[in] xFlags FREERTOS_MSG_DONTWAIT and/or FREERTOS_MSG_PEEK.
  *
- * @return The number of bytes actually sent. Zero when nothing could be sent
- *         or a negative error code in case an error occurred.
+ * @return The total number of bytes stored, or a negative error code, like
+ *         FreeRTOS_recv().
  */
-    BaseType_t FreeRTOS_send( Socket_t xSocket,
-                              const void * pvBuffer,
-                              size_t uxDataLength,
-                              BaseType_t xFlags )
+    BaseType_t FreeRTOS_recvv( Socket_t xSocket,
+                               const struct freertos_iovec * pxIOVector,
+                               size_t uxIOCount,
+                               BaseType_t xFlags )
     {
         BaseType_t xByteCount;
         FreeRTOS_Socket_t * pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+        size_t uxTotal = 0U;
 
-        xByteCount = ( BaseType_t ) prvTCPSendCheck( pxSocket, uxDataLength );
-
-        if( xByteCount > 0 )
+        if( ( prvValidSocket( pxSocket, FREERTOS_IPPROTO_TCP, pdTRUE ) == pdFALSE ) ||
+            ( ( ( uint32_t ) xFlags & ( uint32_t ) FREERTOS_ZERO_COPY ) != 0U ) ||
+            ( prvIOVectorLength( pxIOVector, uxIOCount, &( uxTotal ) ) == pdFALSE ) )
         {
-            /* prvTCPSendLoop() will try to send as many bytes as possible,
-             * returning number of bytes that have been queued for transmission.. */
-            xByteCount = prvTCPSendLoop( pxSocket, pvBuffer, uxDataLength, xFlags );
+            xByteCount = -pdFREERTOS_ERRNO_EINVAL;
+        }
+        else
+        {
+            xByteCount = prvRecvWaitSignal( pxSocket, xFlags );
 
-            if( xByteCount == 0 )
-            {
-                if( pxSocket->u.xTCP.eTCPState > eESTABLISHED )
+            #if ( ipconfigTCP_RX_BUFFER_LENDING == 1 )
+                if( ( xByteCount > 0 ) && ( listLIST_IS_EMPTY( &( pxSocket->u.xTCP.xRxLentList ) ) == pdFALSE ) )
                 {
-                    xByteCount = ( BaseType_t ) -pdFREERTOS_ERRNO_ENOTCONN;
+                    BaseType_t xIsPeek = ( ( ( uint32_t ) xFlags & ( uint32_t ) FREERTOS_MSG_PEEK ) != 0U ) ? 1L : 0L;
+                    size_t uxDone = 0U;
+                    size_t uxIndex;
+
+                    /* Like FreeRTOS_recv(), copy the data out of the lent
+                     * segments first. A segment may end halfway a buffer. */
+                    for( uxIndex = 0U; uxIndex < uxIOCount; uxIndex++ )
+                    {
+                        size_t uxCount = 0U;
+
+                        if( pxIOVector[ uxIndex ].iov_len != 0U )
+                        {
+                            uxCount = ( size_t ) prvRecvLentData( pxSocket, pxIOVector[ uxIndex ].iov_base, pxIOVector[ uxIndex ].iov_len, xFlags );
+                            uxDone += uxCount;
+                        }
+
+                        if( ( uxCount < pxIOVector[ uxIndex ].iov_len ) || ( xIsPeek != 0 ) )
+                        {
+                            /* When peeking, only the first buffer is filled. */
+                            break;
+                        }
+                    }
+
+                    xByteCount = ( BaseType_t ) uxDone;
                 }
                 else
+            #endif /* ( ipconfigTCP_RX_BUFFER_LENDING == 1 ) */
+
+            if( ( xByteCount > 0 ) && ( pxSocket->u.xTCP.rxStream != NULL ) )
+            {
+                BaseType_t xIsPeek = ( ( ( uint32_t ) xFlags & ( uint32_t ) FREERTOS_MSG_PEEK ) != 0U ) ? 1L : 0L;
+                size_t uxDone = 0U;
+                size_t uxIndex;
+
+                for( uxIndex = 0U; uxIndex < uxIOCount; uxIndex++ )
                 {
-                    if( ipconfigTCP_MAY_LOG_PORT( pxSocket->usLocalPort ) )
+                    size_t uxCount;
+
+                    /* When peeking, the tail doesn't move: use an offset. */
+                    uxCount = uxStreamBufferGet( pxSocket->u.xTCP.rxStream,
+                                                 ( xIsPeek != 0 ) ? uxDone : 0U,
+                                                 ( uint8_t * ) pxIOVector[ uxIndex ].iov_base,
+                                                 pxIOVector[ uxIndex ].iov_len,
+                                                 xIsPeek );
+                    uxDone += uxCount;
+
+                    if( uxCount < pxIOVector[ uxIndex ].iov_len )
                     {
-                        FreeRTOS_debug_printf( ( "FreeRTOS_send: %u -> %xip:%d: no space\n",
-                                                 pxSocket->usLocalPort,
-                                                 ( unsigned ) pxSocket->u.xTCP.xRemoteIP.ulIP_IPv4,
-                                                 pxSocket->u.xTCP.usRemotePort ) );
+                        break;
                     }
-
-                    xByteCount = ( BaseType_t ) -pdFREERTOS_ERRNO_ENOSPC;
                 }
+
+                prvRecvCheckLowWater( pxSocket );
+
+                xByteCount = ( BaseType_t ) uxDone;
+            }
+            else
+            {
+                /* An error, or no data. */
             }
         }
 
         return xByteCount;
     }
-
-
-#endif /* ipconfigUSE_TCP */
+#endif /* ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigSOCKET_IOVEC_CALLS == 1 ) ) */
 /*-----------------------------------------------------------*/
 
 #if ( ipconfigUSE_TCP == 1 )
@@ -4760,10 +7576,28 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
                     vStreamBufferClear( pxSocket->u.xTCP.txStream );
                 }
 
+                #if ( ipconfigTCP_TX_BY_REFERENCE == 1 )
+                {
+                    vTCPTxRefFlush( pxSocket );
+                }
+                #endif
+
                 ( void ) memset( pxSocket->u.xTCP.xPacket.u.ucLastPacket, 0, sizeof( pxSocket->u.xTCP.xPacket.u.ucLastPacket ) );
                 ( void ) memset( &pxSocket->u.xTCP.xTCPWindow, 0, sizeof( pxSocket->u.xTCP.xTCPWindow ) );
                 ( void ) memset( &pxSocket->u.xTCP.bits, 0, sizeof( pxSocket->u.xTCP.bits ) );
 
+                #if ( ipconfigTCP_INFO == 1 )
+                {
+                    /* The window counters were cleared above, now also
+                     * the counters of the previous connection. */
+                    pxSocket->u.xTCP.ulSegmentsSent = 0U;
+                    pxSocket->u.xTCP.ulSegmentsReceived = 0U;
+                    pxSocket->u.xTCP.ulBytesReceived = 0U;
+                    pxSocket->u.xTCP.xZeroWindowTicks = 0U;
+                    pxSocket->u.xTCP.xStreamBlockedTicks = 0U;
+                }
+                #endif /* ipconfigTCP_INFO */
+
                 /* Now set the bReuseSocket flag again, because the bits have
                  * just been cleared. */
                 pxSocket->u.xTCP.bits.bReuseSocket = ipTRUE_BOOL;
@@ -5068,92 +7902,291 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
          * creation, it could still be changed with setsockopt(). */
         if( xIsInputStream != pdFALSE )
         {
-            size_t uxLittlePerc = sock20_PERCENT;
-            size_t uxEnoughPerc = sock80_PERCENT;
-            size_t uxSegmentCount = pxSocket->u.xTCP.uxRxStreamSize / pxSocket->u.xTCP.usMSS;
-            static const struct Percent
+            size_t uxLittlePerc = sock20_PERCENT;
+            size_t uxEnoughPerc = sock80_PERCENT;
+            size_t uxSegmentCount = pxSocket->u.xTCP.uxRxStreamSize / pxSocket->u.xTCP.usMSS;
+            static const struct Percent
+            {
+                size_t uxPercLittle, uxPercEnough;
+            }
+            xPercTable[] =
+            {
+                { 0U,  100U }, /* 1 segment. */
+                { 50U, 100U }, /* 2 segments. */
+                { 34U, 100U }, /* 3 segments. */
+                { 25U, 100U }, /* 4 segments. */
+            };
+
+            if( ( uxSegmentCount > 0U ) &&
+                ( uxSegmentCount <= ARRAY_USIZE( xPercTable ) ) )
+            {
+                uxLittlePerc = xPercTable[ uxSegmentCount - 1U ].uxPercLittle;
+                uxEnoughPerc = xPercTable[ uxSegmentCount - 1U ].uxPercEnough;
+            }
+
+            #if ( ipconfigTCP_RX_AUTOTUNE == 1 )
+            {
+                /* Start with the size of the tuned window, the stream will
+                 * grow along with the window. */
+                uxLength = prvTCPRxStreamSize( pxSocket );
+            }
+            #else
+            {
+                uxLength = pxSocket->u.xTCP.uxRxStreamSize;
+            }
+            #endif
+
+            if( pxSocket->u.xTCP.uxLittleSpace == 0U )
+            {
+                pxSocket->u.xTCP.uxLittleSpace = ( uxLittlePerc * pxSocket->u.xTCP.uxRxStreamSize ) / sock100_PERCENT;
+            }
+
+            if( pxSocket->u.xTCP.uxEnoughSpace == 0U )
+            {
+                pxSocket->u.xTCP.uxEnoughSpace = ( uxEnoughPerc * pxSocket->u.xTCP.uxRxStreamSize ) / sock100_PERCENT;
+            }
+        }
+        else
+        {
+            uxLength = pxSocket->u.xTCP.uxTxStreamSize;
+        }
+
+        /* Add an extra 4 (or 8) bytes. */
+        uxLength += sizeof( size_t );
+
+        /* And make the length a multiple of sizeof( size_t ). */
+        uxLength &= ~( sizeof( size_t ) - 1U );
+
+        uxSize = ( sizeof( *pxBuffer ) + uxLength ) - sizeof( pxBuffer->ucArray );
+
+        /* MISRA Ref 4.12.1 [Use of dynamic memory]. */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#directive-412. */
+        /* coverity[misra_c_2012_directive_4_12_violation] */
+        pxBuffer = ( ( StreamBuffer_t * ) pvPortMallocLarge( uxSize ) );
+
+        if( pxBuffer == NULL )
+        {
+            FreeRTOS_debug_printf( ( "prvTCPCreateStream: malloc failed\n" ) );
+            pxSocket->u.xTCP.bits.bMallocError = ipTRUE_BOOL;
+            vTCPStateChange( pxSocket, eCLOSE_WAIT );
+        }
+        else
+        {
+            /* Clear the markers of the stream */
+            ( void ) memset( pxBuffer, 0, sizeof( *pxBuffer ) - sizeof( pxBuffer->ucArray ) );
+            pxBuffer->LENGTH = ( size_t ) uxLength;
+
+            if( xTCPWindowLoggingLevel != 0 )
+            {
+                FreeRTOS_debug_printf( ( "prvTCPCreateStream: %cxStream created %u bytes (total %u)\n", ( xIsInputStream != 0 ) ? 'R' : 'T', ( unsigned ) uxLength, ( unsigned ) uxSize ) );
+            }
+
+            if( xIsInputStream != 0 )
+            {
+                iptraceMEM_STATS_CREATE( tcpRX_STREAM_BUFFER, pxBuffer, uxSize );
+                pxSocket->u.xTCP.rxStream = pxBuffer;
+            }
+            else
+            {
+                iptraceMEM_STATS_CREATE( tcpTX_STREAM_BUFFER, pxBuffer, uxSize );
+                pxSocket->u.xTCP.txStream = pxBuffer;
+            }
+        }
+
+        return pxBuffer;
+    }
+
+
+#endif /* ipconfigUSE_TCP */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_TCP == 1 )
+
+/**
+ * @brief The low- and high-water marks are defined for an rxStream of
+ *        'uxRxStreamSize' bytes. When the rxStream is smaller, because it
+ *        follows the tuned reception window, the marks are scaled down.
+ *
+ * @param[in] pxSocket The socket owning the rxStream.
+ * @param[in] uxMark Either 'uxLittleSpace' or 'uxEnoughSpace'.
+ *
+ * @return The mark that applies to the current rxStream.
+ */
+    static size_t prvTCPRxWaterMark( const FreeRTOS_Socket_t * pxSocket,
+                                     size_t uxMark )
+    {
+        size_t uxReturn = uxMark;
+
+        #if ( ipconfigTCP_RX_AUTOTUNE == 1 )
+        {
+            const StreamBuffer_t * pxStream = pxSocket->u.xTCP.rxStream;
+
+            if( ( pxStream != NULL ) && ( pxStream->LENGTH <= pxSocket->u.xTCP.uxRxStreamSize ) )
+            {
+                uxReturn = ( size_t ) ( ( ( uint64_t ) uxMark * ( uint64_t ) ( pxStream->LENGTH - 1U ) ) /
+                                        ( uint64_t ) pxSocket->u.xTCP.uxRxStreamSize );
+            }
+        }
+        #else
+        {
+            ( void ) pxSocket;
+        }
+        #endif /* ipconfigTCP_RX_AUTOTUNE */
+
+        return uxReturn;
+    }
+#endif /* ipconfigUSE_TCP */
+/*-----------------------------------------------------------*/
+
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_RX_AUTOTUNE == 1 ) )
+
+/**
+ * @brief Get the size of the rxStream for a socket that tunes its reception
+ *        window: the current window, but no more than 'uxRxStreamSize'.
+ *
+ * @param[in] pxSocket The socket owning the connection.
+ *
+ * @return The number of bytes that the rxStream should be able to hold.
+ */
+    static size_t prvTCPRxStreamSize( const FreeRTOS_Socket_t * pxSocket )
+    {
+        size_t uxSize = pxSocket->u.xTCP.uxRxStreamSize;
+        const TCPWindow_t * pxWindow = &( pxSocket->u.xTCP.xTCPWindow );
+
+        if( ( pxWindow->u.bits.bHasInit != ipFALSE_BOOL ) && ( pxWindow->xSize.ulRxWindowLength != 0U ) )
+        {
+            uxSize = FreeRTOS_min_size_t( uxSize, ( size_t ) pxWindow->xSize.ulRxWindowLength );
+        }
+
+        return uxSize;
+    }
+#endif /* ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_RX_AUTOTUNE == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_RX_AUTOTUNE == 1 ) )
+
+/**
+ * @brief Get the length that the rxStream should have, including the extra
+ *        4 (or 8) bytes and rounded like prvTCPCreateStream() does.
+ *
+ * @param[in] pxSocket The socket owning the connection.
+ *
+ * @return The value for the 'LENGTH' field of the rxStream.
+ */
+    static size_t prvTCPRxStreamLength( const FreeRTOS_Socket_t * pxSocket )
+    {
+        size_t uxLength;
+
+        uxLength = prvTCPRxStreamSize( pxSocket ) + sizeof( size_t );
+        uxLength &= ~( sizeof( size_t ) - 1U );
+
+        return uxLength;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Called by the user's task after reading from the rxStream. When the
+ *        IP-task has let the reception window grow beyond the size of the
+ *        rxStream, the IP-task is asked to replace the stream with a bigger
+ *        one. The user's task waits until that is done, so it will not read
+ *        from the stream while it is being replaced.
+ *
+ * @param[in] pxSocket The socket owning the connection.
+ */
+    static void prvTCPRxStreamCheckGrow( FreeRTOS_Socket_t * pxSocket )
+    {
+        IPStackEvent_t xGrowEvent;
+
+        if( ( pxSocket->u.xTCP.rxStream != NULL ) &&
+            ( prvTCPRxStreamLength( pxSocket ) > pxSocket->u.xTCP.rxStream->LENGTH ) )
+        {
+            if( xIsCallingFromIPTask() != pdFALSE )
             {
-                size_t uxPercLittle, uxPercEnough;
+                /* Called from a call-back, the stream can be replaced now. */
+                vTCPRxStreamGrow( pxSocket );
             }
-            xPercTable[] =
+            else
             {
-                { 0U,  100U }, /* 1 segment. */
-                { 50U, 100U }, /* 2 segments. */
-                { 34U, 100U }, /* 3 segments. */
-                { 25U, 100U }, /* 4 segments. */
-            };
+                xGrowEvent.eEventType = eSocketRxGrowEvent;
+                xGrowEvent.pvData = pxSocket;
 
-            if( ( uxSegmentCount > 0U ) &&
-                ( uxSegmentCount <= ARRAY_USIZE( xPercTable ) ) )
-            {
-                uxLittlePerc = xPercTable[ uxSegmentCount - 1U ].uxPercLittle;
-                uxEnoughPerc = xPercTable[ uxSegmentCount - 1U ].uxPercEnough;
+                /* Do not block: when the queue is full, the stream will be
+                 * replaced after a next call to recv(). */
+                if( xSendEventStructToIPTask( &xGrowEvent, 0U ) != pdFAIL )
+                {
+                    /* The IP-task will set the 'eSOCKET_BOUND' bit when it has
+                     * done its job, like it does for FreeRTOS_bind(). */
+                    ( void ) xEventGroupWaitBits( pxSocket->xEventGroup, ( EventBits_t ) eSOCKET_BOUND, pdTRUE /*xClearOnExit*/, pdFALSE /*xWaitAllBits*/, portMAX_DELAY );
+                }
             }
+        }
+    }
+/*-----------------------------------------------------------*/
 
-            uxLength = pxSocket->u.xTCP.uxRxStreamSize;
+/**
+ * @brief Called by the IP-task when the reception window has grown beyond the
+ *        size of the rxStream: the stream is replaced by a bigger one. The
+ *        data, also the data that arrived out of order, keeps its position
+ *        relative to the tail. The user's task that asked for it, is waiting
+ *        in prvTCPRxStreamCheckGrow() and does not access the stream.
+ *
+ * @param[in] pxSocket The socket owning the connection.
+ */
+    void vTCPRxStreamGrow( FreeRTOS_Socket_t * pxSocket )
+    {
+        StreamBuffer_t * pxOldStream = pxSocket->u.xTCP.rxStream;
+        StreamBuffer_t * pxNewStream;
+        size_t uxLength;
+        size_t uxSize;
+        size_t uxTail;
+        size_t uxCount;
+        size_t uxFirst;
 
-            if( pxSocket->u.xTCP.uxLittleSpace == 0U )
-            {
-                pxSocket->u.xTCP.uxLittleSpace = ( uxLittlePerc * pxSocket->u.xTCP.uxRxStreamSize ) / sock100_PERCENT;
-            }
+        uxLength = prvTCPRxStreamLength( pxSocket );
 
-            if( pxSocket->u.xTCP.uxEnoughSpace == 0U )
-            {
-                pxSocket->u.xTCP.uxEnoughSpace = ( uxEnoughPerc * pxSocket->u.xTCP.uxRxStreamSize ) / sock100_PERCENT;
-            }
-        }
-        else
+        if( ( pxOldStream != NULL ) && ( uxLength > pxOldStream->LENGTH ) )
         {
-            uxLength = pxSocket->u.xTCP.uxTxStreamSize;
-        }
+            uxSize = ( sizeof( *pxNewStream ) + uxLength ) - sizeof( pxNewStream->ucArray );
 
-        /* Add an extra 4 (or 8) bytes. */
-        uxLength += sizeof( size_t );
+            /* MISRA Ref 4.12.1 [Use of dynamic memory]. */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#directive-412. */
+            /* coverity[misra_c_2012_directive_4_12_violation] */
+            pxNewStream = ( ( StreamBuffer_t * ) pvPortMallocLarge( uxSize ) );
 
-        /* And make the length a multiple of sizeof( size_t ). */
-        uxLength &= ~( sizeof( size_t ) - 1U );
+            if( pxNewStream != NULL )
+            {
+                ( void ) memset( pxNewStream, 0, sizeof( *pxNewStream ) - sizeof( pxNewStream->ucArray ) );
+                pxNewStream->LENGTH = uxLength;
 
-        uxSize = ( sizeof( *pxBuffer ) + uxLength ) - sizeof( pxBuffer->ucArray );
+                uxTail = pxOldStream->uxTail;
+                uxCount = uxStreamBufferDistance( pxOldStream, uxTail, pxOldStream->uxFront );
+                uxFirst = FreeRTOS_min_size_t( pxOldStream->LENGTH - uxTail, uxCount );
 
-        /* MISRA Ref 4.12.1 [Use of dynamic memory]. */
-        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#directive-412. */
-        /* coverity[misra_c_2012_directive_4_12_violation] */
-        pxBuffer = ( ( StreamBuffer_t * ) pvPortMallocLarge( uxSize ) );
+                ( void ) memcpy( pxNewStream->ucArray, &( pxOldStream->ucArray[ uxTail ] ), uxFirst );
 
-        if( pxBuffer == NULL )
-        {
-            FreeRTOS_debug_printf( ( "prvTCPCreateStream: malloc failed\n" ) );
-            pxSocket->u.xTCP.bits.bMallocError = ipTRUE_BOOL;
-            vTCPStateChange( pxSocket, eCLOSE_WAIT );
-        }
-        else
-        {
-            /* Clear the markers of the stream */
-            ( void ) memset( pxBuffer, 0, sizeof( *pxBuffer ) - sizeof( pxBuffer->ucArray ) );
-            pxBuffer->LENGTH = ( size_t ) uxLength;
+                if( uxCount > uxFirst )
+                {
+                    ( void ) memcpy( &( pxNewStream->ucArray[ uxFirst ] ), pxOldStream->ucArray, uxCount - uxFirst );
+                }
 
-            if( xTCPWindowLoggingLevel != 0 )
-            {
-                FreeRTOS_debug_printf( ( "prvTCPCreateStream: %cxStream created %u bytes (total %u)\n", ( xIsInputStream != 0 ) ? 'R' : 'T', ( unsigned ) uxLength, ( unsigned ) uxSize ) );
-            }
+                pxNewStream->uxHead = uxStreamBufferDistance( pxOldStream, uxTail, pxOldStream->uxHead );
+                pxNewStream->uxFront = uxCount;
+                pxSocket->u.xTCP.rxStream = pxNewStream;
 
-            if( xIsInputStream != 0 )
-            {
-                iptraceMEM_STATS_CREATE( tcpRX_STREAM_BUFFER, pxBuffer, uxSize );
-                pxSocket->u.xTCP.rxStream = pxBuffer;
-            }
-            else
-            {
-                iptraceMEM_STATS_CREATE( tcpTX_STREAM_BUFFER, pxBuffer, uxSize );
-                pxSocket->u.xTCP.txStream = pxBuffer;
+                if( xTCPWindowLoggingLevel != 0 )
+                {
+                    FreeRTOS_debug_printf( ( "vTCPRxStreamGrow: RxStream %u -> %u bytes\n",
+                                             ( unsigned ) pxOldStream->LENGTH,
+                                             ( unsigned ) uxLength ) );
+                }
+
+                iptraceMEM_STATS_DELETE( pxOldStream );
+                vPortFreeLarge( pxOldStream );
+                iptraceMEM_STATS_CREATE( tcpRX_STREAM_BUFFER, pxNewStream, uxSize );
             }
         }
-
-        return pxBuffer;
     }
-
-
-#endif /* ipconfigUSE_TCP */
+#endif /* ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_RX_AUTOTUNE == 1 ) ) */
 /*-----------------------------------------------------------*/
 
 #if ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_CALLBACKS == 1 )
@@ -5216,9 +8249,18 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
         /* See if running out of space. */
         if( pxSocket->u.xTCP.bits.bLowWater == ipFALSE_BOOL )
         {
-            size_t uxFrontSpace = uxStreamBufferFrontSpace( pxSocket->u.xTCP.rxStream );
+            #if ( ipconfigTCP_RX_BUFFER_LENDING == 1 )
+                /* A lent segment may arrive before the rxStream was created. */
+                size_t uxFrontSpace = ( pxSocket->u.xTCP.rxStream != NULL ) ?
+                                      uxStreamBufferFrontSpace( pxSocket->u.xTCP.rxStream ) :
+                                      pxSocket->u.xTCP.uxRxStreamSize;
+
+                uxFrontSpace = ( size_t ) ulTCPRxLendSpace( pxSocket, ( uint32_t ) uxFrontSpace );
+            #else
+                size_t uxFrontSpace = uxStreamBufferFrontSpace( pxSocket->u.xTCP.rxStream );
+            #endif
 
-            if( uxFrontSpace <= pxSocket->u.xTCP.uxLittleSpace )
+            if( uxFrontSpace <= prvTCPRxWaterMark( pxSocket, pxSocket->u.xTCP.uxLittleSpace ) )
             {
                 pxSocket->u.xTCP.bits.bLowWater = ipTRUE_BOOL;
                 pxSocket->u.xTCP.bits.bWinChange = ipTRUE_BOOL;
@@ -5346,6 +8388,247 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
 #endif /* ipconfigUSE_TCP */
 /*-----------------------------------------------------------*/
 
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_RX_BUFFER_LENDING == 1 ) )
+
+/**
+ * @brief Called from the IP-task: queue a received segment on the socket so
+ *        that it can be lent to the user, instead of adding it to rxStream.
+ *
+ * @param[in] pxSocket The socket that received the segment.
+ * @param[in] pxNetworkBuffer The network buffer. Its 'xDataLength' marks the
+ *            end of the payload, 'uxPayloadOffset' holds the offset of the
+ *            payload.
+ */
+    void vTCPRxLendQueue( FreeRTOS_Socket_t * pxSocket,
+                          NetworkBufferDescriptor_t * pxNetworkBuffer )
+    {
+        /* The user takes segments from the list while the IP-task adds them. */
+        vTaskSuspendAll();
+        {
+            vListInsertEnd( &( pxSocket->u.xTCP.xRxLentList ), &( pxNetworkBuffer->xBufferListItem ) );
+            pxSocket->u.xTCP.uxRxLentBytes += pxNetworkBuffer->xDataLength - pxNetworkBuffer->uxPayloadOffset;
+        }
+        ( void ) xTaskResumeAll();
+
+        /* Check the low-water mark and wake up the user. */
+        vTCPAddRxdata_Stored( pxSocket );
+    }
+#endif /* ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_RX_BUFFER_LENDING == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_RX_BUFFER_LENDING == 1 ) )
+
+/**
+ * @brief Subtract the bytes that are lent to the user from the space that is
+ *        available in the reception stream.
+ *
+ * @param[in] pxSocket The socket owning the connection.
+ * @param[in] ulSpace The free space in the reception stream.
+ *
+ * @return The space that may be advertised to the peer.
+ */
+    uint32_t ulTCPRxLendSpace( const FreeRTOS_Socket_t * pxSocket,
+                               uint32_t ulSpace )
+    {
+        uint32_t ulLent = ( uint32_t ) pxSocket->u.xTCP.uxRxLentBytes;
+
+        return ( ulSpace > ulLent ) ? ( ulSpace - ulLent ) : 0U;
+    }
+#endif /* ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_RX_BUFFER_LENDING == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_TX_BY_REFERENCE == 1 ) )
+
+/**
+ * @brief Called from prvTCPPrepareSend(): copy outgoing data into a network
+ *        buffer. Bytes that were queued by FreeRTOS_send_ref() are read from
+ *        the application memory, all other bytes from the txStream.
+ *
+ * @param[in] pxSocket The socket owning the connection.
+ * @param[in] uxOffset The distance from the tail of txStream to the first byte.
+ * @param[out] pucTarget Where the data must be copied to.
+ * @param[in] uxLength The number of bytes to copy.
+ *
+ * @return The number of bytes copied.
+ */
+    size_t uxTCPTxRefGet( FreeRTOS_Socket_t * pxSocket,
+                          size_t uxOffset,
+                          uint8_t * pucTarget,
+                          size_t uxLength )
+    {
+        StreamBuffer_t * pxStream = pxSocket->u.xTCP.txStream;
+        const TCPTxReference_t * pxReference = pxSocket->u.xTCP.pxTxRefFirst;
+        size_t uxDone = 0U;
+
+        while( uxDone < uxLength )
+        {
+            size_t uxPosition = uxOffset + uxDone;
+            size_t uxCount = uxLength - uxDone;
+            size_t uxRefStart = 0U;
+            size_t uxRefEnd = 0U;
+
+            /* Skip the references that end before the current position. */
+            while( pxReference != NULL )
+            {
+                uxRefStart = uxStreamBufferDistance( pxStream, pxStream->uxTail, pxReference->uxPosition );
+                uxRefEnd = uxRefStart + ( pxReference->uxLength - pxReference->uxAcked );
+
+                if( uxRefEnd > uxPosition )
+                {
+                    break;
+                }
+
+                pxReference = pxReference->pxNext;
+            }
+
+            if( ( pxReference == NULL ) || ( uxRefStart > uxPosition ) )
+            {
+                /* Copied data: take it from the stream, up to the next reference. */
+                if( pxReference != NULL )
+                {
+                    uxCount = FreeRTOS_min_size_t( uxCount, uxRefStart - uxPosition );
+                }
+
+                uxCount = uxStreamBufferGet( pxStream, uxPosition, &( pucTarget[ uxDone ] ), uxCount, pdTRUE );
+
+                if( uxCount == 0U )
+                {
+                    break;
+                }
+            }
+            else
+            {
+                size_t uxSkip = pxReference->uxAcked + ( uxPosition - uxRefStart );
+
+                uxCount = FreeRTOS_min_size_t( uxCount, uxRefEnd - uxPosition );
+                ( void ) memcpy( &( pucTarget[ uxDone ] ), &( pxReference->pucData[ uxSkip ] ), uxCount );
+            }
+
+            uxDone += uxCount;
+        }
+
+        return uxDone;
+    }
+#endif /* ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_TX_BY_REFERENCE == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_TX_BY_REFERENCE == 1 ) )
+
+/**
+ * @brief Called from the IP-task when 'ulCount' bytes at the tail of txStream
+ *        have been acknowledged, just before the tail is advanced. References
+ *        that are completely acknowledged are removed and reported.
+ *
+ * @param[in] pxSocket The socket owning the connection.
+ * @param[in] ulCount The number of bytes acknowledged.
+ */
+    void vTCPTxRefAcked( FreeRTOS_Socket_t * pxSocket,
+                         uint32_t ulCount )
+    {
+        const StreamBuffer_t * pxStream = pxSocket->u.xTCP.txStream;
+        size_t uxTail = pxStream->uxTail;
+        size_t uxLeft = ( size_t ) ulCount;
+        TCPTxReference_t * pxReference = pxSocket->u.xTCP.pxTxRefFirst;
+
+        while( ( uxLeft > 0U ) && ( pxReference != NULL ) )
+        {
+            size_t uxGap = uxStreamBufferDistance( pxStream, uxTail, pxReference->uxPosition );
+            size_t uxRemaining = pxReference->uxLength - pxReference->uxAcked;
+
+            if( uxGap >= uxLeft )
+            {
+                /* Only copied data before this reference was acknowledged. */
+                break;
+            }
+
+            uxLeft -= uxGap;
+
+            if( uxRemaining > uxLeft )
+            {
+                /* Partially acknowledged. */
+                pxReference->uxAcked += uxLeft;
+                pxReference->uxPosition += uxLeft;
+
+                if( pxReference->uxPosition >= pxStream->LENGTH )
+                {
+                    pxReference->uxPosition -= pxStream->LENGTH;
+                }
+
+                uxLeft = 0U;
+            }
+            else
+            {
+                uxLeft -= uxRemaining;
+                uxTail = pxReference->uxPosition + uxRemaining;
+
+                if( uxTail >= pxStream->LENGTH )
+                {
+                    uxTail -= pxStream->LENGTH;
+                }
+
+                /* The user appends references to the list. */
+                vTaskSuspendAll();
+                {
+                    pxSocket->u.xTCP.pxTxRefFirst = pxReference->pxNext;
+
+                    if( pxSocket->u.xTCP.pxTxRefFirst == NULL )
+                    {
+                        pxSocket->u.xTCP.pxTxRefLast = NULL;
+                    }
+                }
+                ( void ) xTaskResumeAll();
+
+                pxReference->uxAcked = pxReference->uxLength;
+
+                if( ipconfigIS_VALID_PROG_ADDRESS( pxReference->pxHandleDone ) )
+                {
+                    pxReference->pxHandleDone( ( Socket_t ) pxSocket, pxReference, pdTRUE );
+                }
+
+                pxReference = pxSocket->u.xTCP.pxTxRefFirst;
+            }
+        }
+    }
+#endif /* ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_TX_BY_REFERENCE == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_TX_BY_REFERENCE == 1 ) )
+
+/**
+ * @brief Forget all references that are queued on a socket, for instance
+ *        because it is being closed. Their owners are told that the memory
+ *        is not in use any more.
+ *
+ * @param[in] pxSocket The socket owning the connection.
+ */
+    void vTCPTxRefFlush( FreeRTOS_Socket_t * pxSocket )
+    {
+        TCPTxReference_t * pxReference;
+
+        vTaskSuspendAll();
+        {
+            pxReference = pxSocket->u.xTCP.pxTxRefFirst;
+            pxSocket->u.xTCP.pxTxRefFirst = NULL;
+            pxSocket->u.xTCP.pxTxRefLast = NULL;
+        }
+        ( void ) xTaskResumeAll();
+
+        while( pxReference != NULL )
+        {
+            /* Read 'pxNext' first, the owner may re-use the structure. */
+            TCPTxReference_t * pxNext = pxReference->pxNext;
+
+            if( ipconfigIS_VALID_PROG_ADDRESS( pxReference->pxHandleDone ) )
+            {
+                pxReference->pxHandleDone( ( Socket_t ) pxSocket, pxReference, pdFALSE );
+            }
+
+            pxReference = pxNext;
+        }
+    }
+#endif /* ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_TX_BY_REFERENCE == 1 ) ) */
+/*-----------------------------------------------------------*/
+
 #if ( ipconfigUSE_TCP == 1 )
 
 /**
@@ -5640,6 +8923,80 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
 #endif /* ipconfigUSE_TCP */
 /*-----------------------------------------------------------*/
 
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_INFO == 1 ) )
+
+/**
+ * @brief Get the statistics of a TCP connection. The counters are copied
+ *        while the scheduler is suspended, so they belong together.
+ *
+ * @param[in] xSocket The TCP socket.
+ * @param[out] pxInfo The structure that will be filled in.
+ *
+ * @return 0 on success, or -pdFREERTOS_ERRNO_EINVAL when the socket is
+ *         not a valid TCP socket.
+ */
+    BaseType_t FreeRTOS_GetTCPInfo( ConstSocket_t xSocket,
+                                    TCPInfo_t * pxInfo )
+    {
+        const FreeRTOS_Socket_t * pxSocket = ( const FreeRTOS_Socket_t * ) xSocket;
+        const TCPWindow_t * pxWindow;
+        TickType_t xZeroWindowTicks;
+        BaseType_t xReturn = -pdFREERTOS_ERRNO_EINVAL;
+
+        if( ( xSocketValid( pxSocket ) == pdTRUE ) &&
+            ( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP ) &&
+            ( pxInfo != NULL ) )
+        {
+            pxWindow = &( pxSocket->u.xTCP.xTCPWindow );
+
+            vTaskSuspendAll();
+            {
+                pxInfo->ucState = ( uint8_t ) pxSocket->u.xTCP.eTCPState;
+                pxInfo->usMSS = pxSocket->u.xTCP.usMSS;
+                pxInfo->ulBytesSent = pxWindow->ulBytesSent;
+                pxInfo->ulBytesReceived = pxSocket->u.xTCP.ulBytesReceived;
+                pxInfo->ulSegmentsSent = pxSocket->u.xTCP.ulSegmentsSent;
+                pxInfo->ulSegmentsReceived = pxSocket->u.xTCP.ulSegmentsReceived;
+                pxInfo->ulRetransmissions = pxWindow->ulRetransmissions;
+                pxInfo->ulSRTT = ( uint32_t ) pxWindow->lSRTT;
+                #if ( ipconfigUSE_TCP_RTO_RFC6298 == 1 )
+                {
+                    pxInfo->ulRTO = ( uint32_t ) pxWindow->lRTO;
+                }
+                #else
+                {
+                    /* The first retransmission takes place after 2 * SRTT. */
+                    pxInfo->ulRTO = 2U * ( uint32_t ) pxWindow->lSRTT;
+                }
+                #endif
+                pxInfo->ulPeerWindow = pxSocket->u.xTCP.ulWindowSize;
+                pxInfo->ulTxWindow = pxWindow->xSize.ulTxWindowLength;
+                pxInfo->ulRxWindow = pxWindow->xSize.ulRxWindowLength;
+                pxInfo->ulSACKsSent = pxWindow->ulSACKsSent;
+                pxInfo->ulSACKsReceived = pxWindow->ulSACKsReceived;
+
+                xZeroWindowTicks = pxSocket->u.xTCP.xZeroWindowTicks;
+
+                if( pxSocket->u.xTCP.bits.bZeroWindow != pdFALSE_UNSIGNED )
+                {
+                    /* Include the period that is still going on. */
+                    xZeroWindowTicks += xTaskGetTickCount() - pxSocket->u.xTCP.xZeroWindowStart;
+                }
+
+                pxInfo->ulZeroWindowTime = ( uint32_t ) pdTICKS_TO_MS( xZeroWindowTicks );
+                pxInfo->ulStreamBlockedTime = ( uint32_t ) pdTICKS_TO_MS( pxSocket->u.xTCP.xStreamBlockedTicks );
+            }
+            ( void ) xTaskResumeAll();
+
+            xReturn = 0;
+        }
+
+        return xReturn;
+    }
+
+#endif /* ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_INFO == 1 ) ) */
+/*-----------------------------------------------------------*/
+
 #if ( ipconfigUSE_TCP == 1 )
 
 /**
@@ -6143,6 +9500,15 @@ BaseType_t FreeRTOS_GetIPType( ConstSocket_t xSocket )
                  * by FreeRTOS_FD_ISSSET() */
                 pxSocket->xSocketBits = xSocketBits;
 
+                #if ( ipconfigSELECT_READY_LIST == 1 )
+                {
+                    if( xSocketBits != 0U )
+                    {
+                        prvSocketSetReady( pxSocket, xSocketBits );
+                    }
+                }
+                #endif
+
                 /* The ORed value will be used to set the bits in the event
                  * group. */
                 xGroupBits |= xSocketBits;
@@ -6248,6 +9614,11 @@ BaseType_t FreeRTOS_GetIPType( ConstSocket_t xSocket )
         xEvent.eEventType = eSocketSignalEvent;
         xEvent.pvData = pxSocket;
 
+        #if ( ipconfigUSE_IP_TASK_PROFILING == 1 )
+            /* The clock may not be read from an interrupt. */
+            xEvent.ullPostTime = 0U;
+        #endif
+
         /* The IP-task will call FreeRTOS_SignalSocket for this socket. */
         xReturn = xQueueSendToBackFromISR( xNetworkEventQueue, &xEvent, pxHigherPriorityTaskWoken );
 
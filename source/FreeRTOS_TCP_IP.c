@@ -167,6 +167,24 @@
                      * ACK may be sent now. */
                     if( pxSocket->u.xTCP.eTCPState != eCLOSED )
                     {
+                        size_t uxAckLength = uxIPHeaderSizeSocket( pxSocket ) + ipSIZE_OF_TCP_HEADER;
+
+                        #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+                        {
+                            if( pxSocket->u.xTCP.bits.bTimeStamps != ipFALSE_BOOL )
+                            {
+                                /* MISRA Ref 11.3.1 [Misaligned access] */
+                                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                                /* coverity[misra_c_2012_rule_11_3_violation] */
+                                ProtocolHeaders_t * pxProtocolHeaders = ( ( ProtocolHeaders_t * )
+                                                                          &( pxSocket->u.xTCP.pxAckMessage->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + uxIPHeaderSizeSocket( pxSocket ) ] ) );
+
+                                /* The delayed ACK carries nothing but a time-stamp, refresh it. */
+                                uxAckLength += prvTCPAddTimeStampOption( pxSocket, &( pxProtocolHeaders->xTCPHeader ), 0U );
+                            }
+                        }
+                        #endif /* ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 */
+
                         if( ( xTCPWindowLoggingLevel > 1 ) && ipconfigTCP_MAY_LOG_PORT( pxSocket->usLocalPort ) )
                         {
                             FreeRTOS_debug_printf( ( "Send[%u->%u] del ACK %u SEQ %u (len %u)\n",
@@ -174,10 +192,10 @@
                                                      pxSocket->u.xTCP.usRemotePort,
                                                      ( unsigned ) ( pxSocket->u.xTCP.xTCPWindow.rx.ulCurrentSequenceNumber - pxSocket->u.xTCP.xTCPWindow.rx.ulFirstSequenceNumber ),
                                                      ( unsigned ) ( pxSocket->u.xTCP.xTCPWindow.ulOurSequenceNumber - pxSocket->u.xTCP.xTCPWindow.tx.ulFirstSequenceNumber ),
-                                                     ( unsigned ) ( uxIPHeaderSizeSocket( pxSocket ) + ipSIZE_OF_TCP_HEADER ) ) );
+                                                     ( unsigned ) uxAckLength ) );
                         }
 
-                        prvTCPReturnPacket( pxSocket, pxSocket->u.xTCP.pxAckMessage, ( uint32_t ) ( uxIPHeaderSizeSocket( pxSocket ) + ipSIZE_OF_TCP_HEADER ), ipconfigZERO_COPY_TX_DRIVER );
+                        prvTCPReturnPacket( pxSocket, pxSocket->u.xTCP.pxAckMessage, ( uint32_t ) uxAckLength, ipconfigZERO_COPY_TX_DRIVER );
 
                         #if ( ipconfigZERO_COPY_TX_DRIVER != 0 )
                         {
@@ -265,6 +283,7 @@
     }
     /*-----------------------------------------------------------*/
 
+    #if ( ipconfigTCP_ACCEPT_QUEUE == 0 )
     static BaseType_t vTCPRemoveTCPChild( const FreeRTOS_Socket_t * pxChildSocket )
     {
         BaseType_t xReturn = pdFALSE;
@@ -298,6 +317,7 @@
 
         return xReturn;
     }
+    #endif /* ipconfigTCP_ACCEPT_QUEUE == 0 */
 
 /**
  * @brief Changing to a new state. Centralised here to do specific actions such as
@@ -367,10 +387,25 @@
                          * call-back must be made, in which case 'xConnected' will
                          * be set to the parent socket. */
 
-                        if( xParent->u.xTCP.pxPeerSocket == NULL )
+                        #if ( ipconfigTCP_ACCEPT_QUEUE == 1 )
                         {
-                            xParent->u.xTCP.pxPeerSocket = pxSocket;
+                            /* Append the child to the accept queue of its parent.
+                             * The queue is read by FreeRTOS_accept() from the
+                             * user's task, so it must be modified atomically. */
+                            vTaskSuspendAll();
+                            {
+                                vListInsertEnd( &( xParent->u.xTCP.xAcceptQueue ), &( pxSocket->u.xTCP.xAcceptItem ) );
+                            }
+                            ( void ) xTaskResumeAll();
+                        }
+                        #else
+                        {
+                            if( xParent->u.xTCP.pxPeerSocket == NULL )
+                            {
+                                xParent->u.xTCP.pxPeerSocket = pxSocket;
+                            }
                         }
+                        #endif /* ipconfigTCP_ACCEPT_QUEUE */
 
                         xParent->xEventBits |= ( EventBits_t ) eSOCKET_ACCEPT;
 
@@ -462,6 +497,19 @@
         /* Fill in the new state. */
         pxSocket->u.xTCP.eTCPState = eTCPState;
 
+        #if ( ipconfigTCP_INFO == 1 )
+        {
+            /* After a reset or the final segment, the peer will not open its
+             * window any more: end a zero-window period that is going on. */
+            if( ( pxSocket->u.xTCP.bits.bZeroWindow != pdFALSE_UNSIGNED ) &&
+                ( ( eTCPState == eCLOSED ) || ( eTCPState == eCLOSE_WAIT ) || ( eTCPState == eTIME_WAIT ) ) )
+            {
+                pxSocket->u.xTCP.bits.bZeroWindow = pdFALSE_UNSIGNED;
+                pxSocket->u.xTCP.xZeroWindowTicks += xTaskGetTickCount() - pxSocket->u.xTCP.xZeroWindowStart;
+            }
+        }
+        #endif /* ipconfigTCP_INFO */
+
         if( ( eTCPState == eCLOSED ) ||
             ( eTCPState == eCLOSE_WAIT ) )
         {
@@ -503,7 +551,23 @@
                 {
                     if( pxSocket->u.xTCP.bits.bReuseSocket == ipFALSE_BOOL )
                     {
-                        xHasCleared = vTCPRemoveTCPChild( pxSocket );
+                        #if ( ipconfigTCP_ACCEPT_QUEUE == 1 )
+                        {
+                            /* The parent never refers to its children, it only
+                             * holds them in its accept queue. The queue is also
+                             * read by FreeRTOS_accept(), the scheduler is suspended
+                             * while the child is removed from it. */
+                            if( listLIST_ITEM_CONTAINER( &( pxSocket->u.xTCP.xAcceptItem ) ) != NULL )
+                            {
+                                ( void ) uxListRemove( &( pxSocket->u.xTCP.xAcceptItem ) );
+                                xHasCleared = pdTRUE;
+                            }
+                        }
+                        #else
+                        {
+                            xHasCleared = vTCPRemoveTCPChild( pxSocket );
+                        }
+                        #endif /* ipconfigTCP_ACCEPT_QUEUE */
                         ( void ) xHasCleared;
 
                         pxSocket->u.xTCP.bits.bPassQueued = ipFALSE_BOOL;
@@ -661,6 +725,18 @@
                 if( xResult != ( BaseType_t ) 0 )
                 {
                     ulDelayMs = 1U;
+
+                    #if ( ipconfigTCP_PACING == 1 )
+                    {
+                        /* Data is waiting, but maybe it is being paced.
+                         * Retransmissions are not paced. */
+                        if( xTCPWindowTxHasRetransmission( &( pxSocket->u.xTCP.xTCPWindow ) ) == pdFALSE )
+                        {
+                            ulDelayMs = FreeRTOS_max_uint32( ulDelayMs, prvTCPPacingDelay( pxSocket ) );
+                            ulDelayMs = FreeRTOS_min_uint32( ulDelayMs, tcpMAXIMUM_TCP_WAKEUP_TIME_MS );
+                        }
+                    }
+                    #endif
                 }
                 else
                 {
@@ -757,9 +833,13 @@
         pxNetworkBuffer = pxDescriptor;
         uxIPHeaderOffset = ipSIZE_OF_ETH_HEADER + uxIPHeaderSizePacket( pxNetworkBuffer );
 
+        ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBTcpInSegs );
+
         /* Check for a minimum packet size. */
         if( pxNetworkBuffer->xDataLength < ( uxIPHeaderOffset + ipSIZE_OF_TCP_HEADER ) )
         {
+            ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBTcpInErrs );
+            ipDROP_FRAME( pxNetworkBuffer, eIPDropTCPRejected );
             xResult = pdFAIL;
         }
         else
@@ -788,6 +868,9 @@
 
                 FreeRTOS_debug_printf( ( "TCP: No active socket on port %d (%d)\n", usLocalPort, usRemotePort ) );
 
+                /* Record the drop before the buffer is turned into a RST. */
+                ipDROP_FRAME( pxNetworkBuffer, eIPDropTCPRejected );
+
                 /* Send a RST to all packets that can not be handled.  As a result
                  * the other party will get a ECONN error.  There are two exceptions:
                  * 1) A packet that already has the RST flag set.
@@ -823,6 +906,8 @@
                         }
                         #endif /* ipconfigHAS_DEBUG_PRINTF */
 
+                        ipDROP_FRAME( pxNetworkBuffer, eIPDropTCPRejected );
+
                         if( ( ucTCPFlags & tcpTCP_FLAG_RST ) == 0U )
                         {
                             ( void ) prvTCPSendReset( pxNetworkBuffer );
@@ -839,8 +924,14 @@
 
                         if( pxSocket == NULL )
                         {
+                            /* prvHandleListen() has recorded the drop, before it might
+                             * turn the buffer into a RST. */
                             xResult = pdFAIL;
                         }
+                        else
+                        {
+                            ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBTcpPassiveOpens );
+                        }
                     }
                 } /* if( pxSocket->u.xTCP.eTCPState == eTCP_LISTEN ). */
                 else
@@ -895,6 +986,7 @@
                     {
                         /* SYN flag while this socket is already connected. */
                         FreeRTOS_debug_printf( ( "TCP: SYN unexpected from %u\n", usRemotePort ) );
+                        ipDROP_FRAME( pxNetworkBuffer, eIPDropTCPRejected );
 
                         /* The packet cannot be handled. */
                         xResult = pdFAIL;
@@ -935,6 +1027,12 @@
                 if( ( pxTCPHeader->ucTCPOffset & tcpTCP_OFFSET_LENGTH_BITS ) > tcpTCP_OFFSET_STANDARD_LENGTH )
                 {
                     xResult = prvCheckOptions( pxSocket, pxNetworkBuffer );
+
+                    if( xResult == pdFAIL )
+                    {
+                        ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBTcpInErrs );
+                        ipDROP_FRAME( pxNetworkBuffer, eIPDropTCPRejected );
+                    }
                 }
 
                 if( xResult != pdFAIL )
@@ -953,6 +1051,31 @@
                     }
                     #endif /* ipconfigUSE_TCP_WIN */
 
+                    #if ( ipconfigTCP_INFO == 1 )
+                    {
+                        pxSocket->u.xTCP.ulSegmentsReceived++;
+
+                        /* Measure how long the peer keeps its window closed. */
+                        if( pxSocket->u.xTCP.ulWindowSize == 0U )
+                        {
+                            if( pxSocket->u.xTCP.bits.bZeroWindow == pdFALSE_UNSIGNED )
+                            {
+                                pxSocket->u.xTCP.bits.bZeroWindow = pdTRUE_UNSIGNED;
+                                pxSocket->u.xTCP.xZeroWindowStart = xTaskGetTickCount();
+                            }
+                        }
+                        else if( pxSocket->u.xTCP.bits.bZeroWindow != pdFALSE_UNSIGNED )
+                        {
+                            pxSocket->u.xTCP.bits.bZeroWindow = pdFALSE_UNSIGNED;
+                            pxSocket->u.xTCP.xZeroWindowTicks += xTaskGetTickCount() - pxSocket->u.xTCP.xZeroWindowStart;
+                        }
+                        else
+                        {
+                            /* The window is still open. */
+                        }
+                    }
+                    #endif /* ipconfigTCP_INFO */
+
                     /* In prvTCPHandleState() the incoming messages will be handled
                      * depending on the current state of the connection. */
                     if( prvTCPHandleState( pxSocket, &pxNetworkBuffer ) > 0 )
@@ -78,6 +78,29 @@
                                        FreeRTOS_Socket_t * const pxSocket );
     #endif /* ( ipconfigUSE_TCP_WIN == 1 ) */
 
+    #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+
+/*
+ * Read the TSval and TSecr from a TCP Timestamps option.
+ */
+        static void prvReadTimeStampOption( const uint8_t * const pucPtr,
+                                            FreeRTOS_Socket_t * const pxSocket,
+                                            BaseType_t xHasSYNFlag );
+    #endif /* ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 ) */
+
+    #if ( ipconfigTCP_RX_BUFFER_LENDING == 1 )
+
+/*
+ * See if a received segment can be lent to the user, in stead of copying it
+ * to the rxStream.
+ */
+        static BaseType_t prvTCPRxLendPrepare( FreeRTOS_Socket_t * pxSocket,
+                                               NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                               const uint8_t * pucRxBuffer,
+                                               size_t uxHeaderLength,
+                                               uint32_t ulRxLength );
+    #endif /* ( ipconfigTCP_RX_BUFFER_LENDING == 1 ) */
+
 /**
  * @brief Parse the TCP option(s) received, if present.
  *
@@ -167,6 +190,17 @@
                         uxOptionsLength -= ( size_t ) lResult;
                         pucPtr = &( pucPtr[ lResult ] );
                     }
+
+                    #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+                    {
+                        /* RFC 7323: the TSecr field is only valid when the
+                         * ACK bit is set. */
+                        if( ( pxTCPHeader->ucTCPFlags & tcpTCP_FLAG_ACK ) == ( uint8_t ) 0U )
+                        {
+                            pxSocket->u.xTCP.xTCPWindow.u.bits.bTSEchoValid = pdFALSE_UNSIGNED;
+                        }
+                    }
+                    #endif
                 }
             }
         }
@@ -254,6 +288,21 @@
                 }
             }
         #endif /* ipconfigUSE_TCP_WIN */
+        #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+            else if( pucPtr[ 0 ] == tcpTCP_OPT_TIMESTAMP )
+            {
+                /* The TCP Timestamps option, RFC 7323. */
+                if( ( uxRemainingOptionsBytes < ( size_t ) tcpTCP_OPT_TIMESTAMP_LEN ) || ( pucPtr[ 1 ] != ( uint8_t ) tcpTCP_OPT_TIMESTAMP_LEN ) )
+                {
+                    lIndex = -1;
+                }
+                else
+                {
+                    prvReadTimeStampOption( pucPtr, pxSocket, xHasSYNFlag );
+                    lIndex = ( int32_t ) tcpTCP_OPT_TIMESTAMP_LEN;
+                }
+            }
+        #endif /* ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 */
         else if( pucPtr[ 0 ] == tcpTCP_OPT_MSS )
         {
             /* Confirm that the option fits in the remaining buffer space. */
@@ -391,6 +440,12 @@
              */
             if( ( pxSocket->u.xTCP.txStream != NULL ) && ( ulCount > 0U ) )
             {
+                #if ( ipconfigTCP_TX_BY_REFERENCE == 1 )
+                {
+                    vTCPTxRefAcked( pxSocket, ulCount );
+                }
+                #endif
+
                 /* Just advancing the tail index, 'ulCount' bytes have been confirmed. */
                 ( void ) uxStreamBufferGet( pxSocket->u.xTCP.txStream, 0, NULL, ( size_t ) ulCount, pdFALSE );
                 pxSocket->xEventBits |= ( EventBits_t ) eSOCKET_SEND;
@@ -423,6 +478,58 @@
     #endif /* ( ipconfigUSE_TCP_WIN != 0 ) */
     /*-----------------------------------------------------------*/
 
+    #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+
+/**
+ * @brief Read a TCP Timestamps option: remember the peer's TSval so that it
+ *        can be echoed, and pass the echoed TSecr to the sliding window, which
+ *        will use it to sample the round-trip time.
+ *
+ * @param[in] pucPtr Pointer to the time-stamp option, which is known to be
+ *                   complete.
+ * @param[in] pxSocket Socket handling the TCP connection.
+ * @param[in] xHasSYNFlag Whether the header has the SYN flag or not.
+ */
+        static void prvReadTimeStampOption( const uint8_t * const pucPtr,
+                                            FreeRTOS_Socket_t * const pxSocket,
+                                            BaseType_t xHasSYNFlag )
+        {
+            TCPWindow_t * pxTCPWindow = &( pxSocket->u.xTCP.xTCPWindow );
+            uint32_t ulTSVal = ulChar2u32( &( pucPtr[ 2 ] ) );
+            uint32_t ulTSEcr = ulChar2u32( &( pucPtr[ 6 ] ) );
+
+            if( xHasSYNFlag != 0 )
+            {
+                /* The peer offers time-stamps, or it accepts our offer. */
+                pxSocket->u.xTCP.bits.bTimeStamps = ipTRUE_BOOL;
+                pxTCPWindow->ulTSRecent = ulTSVal;
+            }
+            else if( pxSocket->u.xTCP.bits.bTimeStamps != ipFALSE_BOOL )
+            {
+                /* Only follow the peer's clock forward, an older time-stamp
+                 * belongs to a segment that was delayed in the network. */
+                if( ( ( ulTSVal - pxTCPWindow->ulTSRecent ) & 0x80000000U ) == 0U )
+                {
+                    pxTCPWindow->ulTSRecent = ulTSVal;
+                }
+            }
+            else
+            {
+                /* Time-stamps were not negotiated, ignore the option. */
+            }
+
+            if( pxSocket->u.xTCP.bits.bTimeStamps != ipFALSE_BOOL )
+            {
+                /* Any value is a valid echo, including zero. Whether the
+                 * segment has the ACK flag is checked in prvCheckOptions(). */
+                pxTCPWindow->ulTSEcho = ulTSEcr;
+                pxTCPWindow->u.bits.bTSEchoValid = pdTRUE_UNSIGNED;
+            }
+        }
+
+    #endif /* ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 ) */
+    /*-----------------------------------------------------------*/
+
 /**
  * @brief prvCheckRxData(): called from prvTCPHandleState(). The
  *        first thing that will be done is find the TCP payload data
@@ -552,6 +659,83 @@
     }
     /*-----------------------------------------------------------*/
 
+    #if ( ipconfigTCP_RX_BUFFER_LENDING == 1 )
+
+/**
+ * @brief Called by prvStoreRxData() for data that has arrived in-order. The
+ *        segment will be lent to the user when the socket has the option
+ *        FREERTOS_SO_RX_BUFFER_LENDING set, and when all earlier data has
+ *        been read from the rxStream.
+ *        The reply to the peer can not be built in the lent buffer. It will be
+ *        built in a copy of the headers, which is stored in 'pxRxLendReply'.
+ *
+ * @param[in] pxSocket The socket owning the connection.
+ * @param[in] pxNetworkBuffer The network buffer descriptor.
+ * @param[in] pucRxBuffer The first byte of the payload that must be stored.
+ * @param[in] uxHeaderLength The number of bytes from the start of the ethernet
+ *                           header up to the TCP payload.
+ * @param[in] ulRxLength The number of bytes to be stored.
+ *
+ * @return pdTRUE when the segment will be lent, otherwise pdFALSE.
+ */
+        static BaseType_t prvTCPRxLendPrepare( FreeRTOS_Socket_t * pxSocket,
+                                               NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                               const uint8_t * pucRxBuffer,
+                                               size_t uxHeaderLength,
+                                               uint32_t ulRxLength )
+        {
+            BaseType_t xLend = pdFALSE;
+            const StreamBuffer_t * pxStream = pxSocket->u.xTCP.rxStream;
+
+            if( ( pxSocket->u.xTCP.bits.bRxLending != ipFALSE_BOOL ) &&
+                ( pxSocket->u.xTCP.eTCPState >= eESTABLISHED ) &&
+                ( pxSocket->u.xTCP.xTCPWindow.ulUserDataLength == 0U ) )
+            {
+                xLend = pdTRUE;
+
+                /* Data that is stored in the rxStream, also out-of-order data,
+                 * must be passed to the user first. */
+                if( ( pxStream != NULL ) &&
+                    ( ( uxStreamBufferGetSize( pxStream ) != 0U ) || ( pxStream->uxFront != pxStream->uxHead ) ) )
+                {
+                    xLend = pdFALSE;
+                }
+
+                #if ( ipconfigUSE_CALLBACKS == 1 )
+                {
+                    /* The reception handler has its own zero-copy method. */
+                    if( ipconfigIS_VALID_PROG_ADDRESS( pxSocket->u.xTCP.pxHandleReceive ) )
+                    {
+                        xLend = pdFALSE;
+                    }
+                }
+                #endif /* ipconfigUSE_CALLBACKS */
+            }
+
+            if( xLend != pdFALSE )
+            {
+                size_t uxReplyLength = FreeRTOS_max_size_t( uxHeaderLength, sizeof( pxSocket->u.xTCP.xPacket.u.ucLastPacket ) );
+
+                pxSocket->u.xTCP.pxRxLendReply = pxDuplicateNetworkBufferWithDescriptor( pxNetworkBuffer, uxReplyLength );
+
+                if( pxSocket->u.xTCP.pxRxLendReply == NULL )
+                {
+                    /* Out of buffers: copy the data to the rxStream as usual. */
+                    xLend = pdFALSE;
+                }
+                else
+                {
+                    /* Remember where the payload starts and ends. */
+                    pxNetworkBuffer->uxPayloadOffset = ( size_t ) ( pucRxBuffer - pxNetworkBuffer->pucEthernetBuffer );
+                    pxNetworkBuffer->xDataLength = pxNetworkBuffer->uxPayloadOffset + ( size_t ) ulRxLength;
+                }
+            }
+
+            return xLend;
+        }
+    #endif /* ( ipconfigTCP_RX_BUFFER_LENDING == 1 ) */
+    /*-----------------------------------------------------------*/
+
 /**
  * @brief prvStoreRxData(): called from prvTCPHandleState().
  *        The second thing is to do is check if the payload data may
@@ -590,6 +774,10 @@
         {
             uint32_t ulSkipCount = 0;
 
+            #if ( ipconfigTCP_RX_AUTOTUNE == 1 ) || ( ipconfigTCP_INFO == 1 )
+                uint32_t ulRxNext = pxTCPWindow->rx.ulCurrentSequenceNumber;
+            #endif
+
             /* See if way may accept the data contents and forward it to the socket
              * owner.
              *
@@ -606,6 +794,13 @@
                 ulSpace = ( uint32_t ) pxSocket->u.xTCP.uxRxStreamSize;
             }
 
+            #if ( ipconfigTCP_RX_BUFFER_LENDING == 1 )
+            {
+                /* Lent segments still occupy a part of the reception window. */
+                ulSpace = ulTCPRxLendSpace( pxSocket, ulSpace );
+            }
+            #endif
+
             lOffset = lTCPWindowRxCheck( pxTCPWindow, ulSequenceNumber, ulRxLength, ulSpace, &( ulSkipCount ) );
 
             if( lOffset >= 0 )
@@ -623,7 +818,19 @@
                     pucRxBuffer = &( pucRecvData[ ulSkipCount ] );
                 }
 
-                lStored = lTCPAddRxdata( pxSocket, ( uint32_t ) lOffset, pucRxBuffer, ulRxLength );
+                #if ( ipconfigTCP_RX_BUFFER_LENDING == 1 )
+                    if( ( lOffset == 0 ) &&
+                        ( prvTCPRxLendPrepare( pxSocket, pxNetworkBuffer, pucRxBuffer,
+                                               ( size_t ) ( pucRecvData - pxNetworkBuffer->pucEthernetBuffer ), ulRxLength ) != pdFALSE ) )
+                    {
+                        /* prvTCPHandleState() will queue the segment. */
+                        lStored = ( int32_t ) ulRxLength;
+                    }
+                    else
+                #endif /* ipconfigTCP_RX_BUFFER_LENDING */
+                {
+                    lStored = lTCPAddRxdata( pxSocket, ( uint32_t ) lOffset, pucRxBuffer, ulRxLength );
+                }
 
                 if( lStored != ( int32_t ) ulRxLength )
                 {
@@ -651,6 +858,23 @@
                 }
             }
             #endif /* ipconfigUSE_TCP_WIN */
+
+            #if ( ipconfigTCP_RX_AUTOTUNE == 1 )
+            {
+                /* The distance that RCV.NXT has moved is the amount of data
+                 * that was delivered in order. */
+                if( xResult == 0 )
+                {
+                    ( void ) xTCPWindowRxAutoTune( pxTCPWindow, pxTCPWindow->rx.ulCurrentSequenceNumber - ulRxNext );
+                }
+            }
+            #endif /* ipconfigTCP_RX_AUTOTUNE */
+
+            #if ( ipconfigTCP_INFO == 1 )
+            {
+                pxSocket->u.xTCP.ulBytesReceived += pxTCPWindow->rx.ulCurrentSequenceNumber - ulRxNext;
+            }
+            #endif /* ipconfigTCP_INFO */
         }
         else
         {
@@ -243,6 +243,7 @@
         TCPWindow_t * pxTCPWindow = &pxSocket->u.xTCP.xTCPWindow;
         BaseType_t xSendLength = 0;
         uint32_t ulAckNr = FreeRTOS_ntohl( pxTCPHeader->ulAckNr );
+        UBaseType_t uxOptionsLength = pxTCPWindow->ucOptionLength;
 
         if( ( ucTCPFlags & tcpTCP_FLAG_FIN ) != 0U )
         {
@@ -305,13 +306,23 @@
 
         pxTCPWindow->ulOurSequenceNumber = pxTCPWindow->tx.ulCurrentSequenceNumber;
 
+        #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+        {
+            if( pxSocket->u.xTCP.bits.bTimeStamps != ipFALSE_BOOL )
+            {
+                /* The time-stamp is placed behind the SACK option, if any. */
+                uxOptionsLength = prvTCPAddTimeStampOption( pxSocket, pxTCPHeader, uxOptionsLength );
+            }
+        }
+        #endif /* ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 */
+
         if( pxTCPHeader->ucTCPFlags != 0U )
         {
-            ucIntermediateResult = ( uint8_t ) ( uxIPHeaderSizeSocket( pxSocket ) + ipSIZE_OF_TCP_HEADER + pxTCPWindow->ucOptionLength );
+            ucIntermediateResult = ( uint8_t ) ( uxIPHeaderSizeSocket( pxSocket ) + ipSIZE_OF_TCP_HEADER + uxOptionsLength );
             xSendLength = ( BaseType_t ) ucIntermediateResult;
         }
 
-        pxTCPHeader->ucTCPOffset = ( uint8_t ) ( ( ipSIZE_OF_TCP_HEADER + pxTCPWindow->ucOptionLength ) << 2 );
+        pxTCPHeader->ucTCPOffset = ( uint8_t ) ( ( ipSIZE_OF_TCP_HEADER + uxOptionsLength ) << 2 );
 
         if( xTCPWindowLoggingLevel != 0 )
         {
@@ -471,6 +482,22 @@
             }
             #endif /* ipconfigUSE_TCP_WIN */
 
+            #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+            {
+                if( pxSocket->u.xTCP.bits.bTimeStamps != ipFALSE_BOOL )
+                {
+                    /* Every segment will carry a time-stamp of 12 bytes, make the
+                     * segments smaller so that they still fit in the MTU. */
+                    pxTCPWindow->u.bits.bTimeStamps = ipTRUE_BOOL;
+
+                    if( pxTCPWindow->usMSS > ( uint16_t ) ( tcpMINIMUM_SEGMENT_LENGTH + tcpTCP_OPT_TIMESTAMP_SPACE ) )
+                    {
+                        pxTCPWindow->usMSS = ( uint16_t ) ( pxTCPWindow->usMSS - tcpTCP_OPT_TIMESTAMP_SPACE );
+                    }
+                }
+            }
+            #endif /* ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 */
+
             /* This was the third step of connecting: SYN, SYN+ACK, ACK so now the
              * connection is established. */
             vTCPStateChange( pxSocket, eESTABLISHED );
@@ -544,6 +571,12 @@
                  * confirmed, and because there is new space in the txStream, the
                  * user/owner should be woken up. */
                 /* _HT_ : only in case the socket's waiting? */
+                #if ( ipconfigTCP_TX_BY_REFERENCE == 1 )
+                {
+                    vTCPTxRefAcked( pxSocket, ulCount );
+                }
+                #endif
+
                 if( uxStreamBufferGet( pxSocket->u.xTCP.txStream, 0U, NULL, ( size_t ) ulCount, pdFALSE ) != 0U )
                 {
                     pxSocket->xEventBits |= ( EventBits_t ) eSOCKET_SEND;
@@ -664,8 +697,12 @@
                 /* _HT_ patch: since the MTU has be fixed at 1500 in stead of 1526, TCP
                  * can not send-out both TCP options and also a full packet. Sending
                  * options (SACK) is always more urgent than sending data, which can be
-                 * sent later. */
-                if( uxOptionsLength == 0U )
+                 * sent later.  A time-stamp alone is not considered as an option here. */
+                #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+                    if( uxOptionsLength == prvTCPTimeStampLength( pxSocket ) )
+                #else
+                    if( uxOptionsLength == 0U )
+                #endif
                 {
                     /* prvTCPPrepareSend might allocate a bigger network buffer, if
                      * necessary. */
@@ -770,6 +807,26 @@
         {
             eIPTCPState_t eState;
 
+            #if ( ipconfigTCP_RX_BUFFER_LENDING == 1 )
+            {
+                if( pxSocket->u.xTCP.pxRxLendReply != NULL )
+                {
+                    /* The received segment is lent to the user.  The reply
+                     * will be built in the copy of its headers. */
+                    vTCPRxLendQueue( pxSocket, *ppxNetworkBuffer );
+                    *ppxNetworkBuffer = pxSocket->u.xTCP.pxRxLendReply;
+                    pxSocket->u.xTCP.pxRxLendReply = NULL;
+
+                    /* MISRA Ref 11.3.1 [Misaligned access] */
+                    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                    /* coverity[misra_c_2012_rule_11_3_violation] */
+                    pxProtocolHeaders = ( ( ProtocolHeaders_t * )
+                                          &( ( *ppxNetworkBuffer )->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + uxIPHeaderSizePacket( *ppxNetworkBuffer ) ] ) );
+                    pxTCPHeader = &( pxProtocolHeaders->xTCPHeader );
+                }
+            }
+            #endif /* ipconfigTCP_RX_BUFFER_LENDING */
+
             uxOptionsLength = prvSetOptions( pxSocket, *ppxNetworkBuffer );
 
             if( ( pxSocket->u.xTCP.eTCPState == eSYN_RECEIVED ) && ( ( ucTCPFlags & ( uint8_t ) tcpTCP_FLAG_CTRL ) == ( uint8_t ) tcpTCP_FLAG_SYN ) )
@@ -935,6 +992,7 @@
             default:
                 /* Shouldn't reach here */
                 /* MISRA 16.4 Compliance */
+                ipDROP_FRAME( pxNetworkBuffer, eIPDropTCPRejected );
                 break;
         }
 
@@ -969,6 +1027,18 @@
         pxNewSocket->u.xTCP.uxRxWinSize = pxSocket->u.xTCP.uxRxWinSize;
         pxNewSocket->u.xTCP.uxTxWinSize = pxSocket->u.xTCP.uxTxWinSize;
 
+        #if ( ipconfigTCP_PACING == 1 )
+        {
+            pxNewSocket->u.xTCP.ulPacingRate = pxSocket->u.xTCP.ulPacingRate;
+        }
+        #endif
+
+        #if ( ipconfigTCP_RX_BUFFER_LENDING == 1 )
+        {
+            pxNewSocket->u.xTCP.bits.bRxLending = pxSocket->u.xTCP.bits.bRxLending;
+        }
+        #endif
+
         #if ( ipconfigSOCKET_HAS_USER_SEMAPHORE == 1 )
         {
             pxNewSocket->pxUserSemaphore = pxSocket->pxUserSemaphore;
@@ -133,6 +133,7 @@ FreeRTOS_Socket_t * prvHandleListen_IPV4( FreeRTOS_Socket_t * pxSocket,
                                    pxSocket->u.xTCP.usChildCount,
                                    pxSocket->u.xTCP.usBacklog,
                                    ( pxSocket->u.xTCP.usChildCount == 1U ) ? "" : "ren" ) );
+                ipDROP_FRAME( pxNetworkBuffer, eIPDropTCPRejected );
                 ( void ) prvTCPSendReset( pxNetworkBuffer );
             }
             else
@@ -146,6 +147,7 @@ FreeRTOS_Socket_t * prvHandleListen_IPV4( FreeRTOS_Socket_t * pxSocket,
                 if( ( pxNewSocket == NULL ) || ( pxNewSocket == FREERTOS_INVALID_SOCKET ) )
                 {
                     FreeRTOS_debug_printf( ( "TCP: Listen: new socket failed\n" ) );
+                    ipDROP_FRAME( pxNetworkBuffer, eIPDropTCPRejected );
                     ( void ) prvTCPSendReset( pxNetworkBuffer );
                 }
                 else if( prvTCPSocketCopy( pxNewSocket, pxSocket ) != pdFALSE )
@@ -160,10 +162,16 @@ FreeRTOS_Socket_t * prvHandleListen_IPV4( FreeRTOS_Socket_t * pxSocket,
                 else
                 {
                     /* Copying failed somehow. */
+                    ipDROP_FRAME( pxNetworkBuffer, eIPDropTCPRejected );
                 }
             }
         }
     }
+    else
+    {
+        /* Not sent to this node, or no sequence number could be obtained. */
+        ipDROP_FRAME( pxNetworkBuffer, eIPDropTCPRejected );
+    }
 
     if( ( ulInitialSequenceNumber != 0U ) && ( pxReturn != NULL ) )
     {
@@ -202,6 +210,7 @@ FreeRTOS_Socket_t * prvHandleListen_IPV4( FreeRTOS_Socket_t * pxSocket,
                     ( void ) vSocketClose( pxReturn );
                 }
 
+                ipDROP_FRAME( pxNetworkBuffer, eIPDropTCPRejected );
                 pxReturn = NULL;
                 break;
             }
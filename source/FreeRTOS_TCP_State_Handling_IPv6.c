@@ -128,6 +128,7 @@ FreeRTOS_Socket_t * prvHandleListen_IPV6( FreeRTOS_Socket_t * pxSocket,
                                    pxSocket->u.xTCP.usChildCount,
                                    pxSocket->u.xTCP.usBacklog,
                                    ( pxSocket->u.xTCP.usChildCount == 1U ) ? "" : "ren" ) );
+                ipDROP_FRAME( pxNetworkBuffer, eIPDropTCPRejected );
                 ( void ) prvTCPSendReset( pxNetworkBuffer );
             }
             else
@@ -141,6 +142,7 @@ FreeRTOS_Socket_t * prvHandleListen_IPV6( FreeRTOS_Socket_t * pxSocket,
                 if( ( pxNewSocket == NULL ) || ( pxNewSocket == FREERTOS_INVALID_SOCKET ) )
                 {
                     FreeRTOS_debug_printf( ( "TCP: Listen: new socket failed\n" ) );
+                    ipDROP_FRAME( pxNetworkBuffer, eIPDropTCPRejected );
                     ( void ) prvTCPSendReset( pxNetworkBuffer );
                 }
                 else if( prvTCPSocketCopy( pxNewSocket, pxSocket ) != pdFALSE )
@@ -155,10 +157,16 @@ FreeRTOS_Socket_t * prvHandleListen_IPV6( FreeRTOS_Socket_t * pxSocket,
                 else
                 {
                     /* Copying failed somehow. */
+                    ipDROP_FRAME( pxNetworkBuffer, eIPDropTCPRejected );
                 }
             }
         }
     }
+    else
+    {
+        /* Not sent to this node, or no sequence number could be obtained. */
+        ipDROP_FRAME( pxNetworkBuffer, eIPDropTCPRejected );
+    }
 
     if( ( xHasSequence != pdFALSE ) && ( pxReturn != NULL ) )
     {
@@ -202,6 +210,7 @@ FreeRTOS_Socket_t * prvHandleListen_IPV6( FreeRTOS_Socket_t * pxSocket,
                     ( void ) vSocketClose( pxReturn );
                 }
 
+                ipDROP_FRAME( pxNetworkBuffer, eIPDropTCPRejected );
                 pxReturn = NULL;
                 break;
             }
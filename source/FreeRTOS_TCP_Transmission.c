@@ -169,6 +169,18 @@
 
                 /* Repeat Count is used for a connecting socket, to limit the number
                  * of tries. */
+                #if ( ipconfigUSE_MIB_COUNTERS == 1 )
+                {
+                    if( pxSocket->u.xTCP.ucRepCount == 0U )
+                    {
+                        ipMIB_COUNT( NULL, pxSocket->pxEndPoint, eMIBTcpActiveOpens );
+                    }
+                    else
+                    {
+                        ipMIB_COUNT( NULL, pxSocket->pxEndPoint, eMIBTcpRetransSegs );
+                    }
+                }
+                #endif /* ( ipconfigUSE_MIB_COUNTERS == 1 ) */
                 pxSocket->u.xTCP.ucRepCount++;
 
                 /* Send the SYN message to make a connection.  The messages is
@@ -205,6 +217,14 @@
         UBaseType_t uxOptionsLength = 0U;
         int32_t xSendLength;
 
+        #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+        {
+            /* Every segment will carry a time-stamp, prvTCPPrepareSend() will
+             * write it. */
+            uxOptionsLength = prvTCPTimeStampLength( pxSocket );
+        }
+        #endif
+
         for( uxIndex = 0U; uxIndex < ( UBaseType_t ) SEND_REPEATED_COUNT; uxIndex++ )
         {
             /* prvTCPPrepareSend() might allocate a network buffer if there is data
@@ -277,6 +297,13 @@
             configASSERT( pdFALSE );
         }
 
+        #if ( ipconfigTCP_INFO == 1 )
+            if( pxSocket != NULL )
+            {
+                pxSocket->u.xTCP.ulSegmentsSent++;
+            }
+        #endif /* ipconfigTCP_INFO */
+
         #if ( ipconfigUSE_IPv6 != 0 )
             if( xIsIPv6 == pdTRUE )
             {
@@ -329,6 +356,13 @@
             ulFrontSpace = ( uint32_t ) pxSocket->u.xTCP.uxRxStreamSize;
         }
 
+        #if ( ipconfigTCP_RX_BUFFER_LENDING == 1 )
+        {
+            /* Segments that are lent to the user are not yet released. */
+            ulFrontSpace = ulTCPRxLendSpace( pxSocket, ulFrontSpace );
+        }
+        #endif
+
         /* Take the minimum of the RX buffer space and the RX window size. */
         ulSpace = FreeRTOS_min_uint32( pxTCPWindow->xSize.ulRxWindowLength, ulFrontSpace );
 
@@ -606,8 +640,231 @@
             uxOptionsLength += 4U;
         }
         #endif /* ipconfigUSE_TCP_WIN == 0 */
+
+        #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+        {
+            /* Time-stamps are always offered in a SYN. A SYN+ACK will only
+             * contain them when the peer has offered them. */
+            if( ( pxSocket->u.xTCP.eTCPState == eCONNECT_SYN ) ||
+                ( pxSocket->u.xTCP.bits.bTimeStamps != ipFALSE_BOOL ) )
+            {
+                uxOptionsLength = prvTCPAddTimeStampOption( pxSocket, pxTCPHeader, uxOptionsLength );
+            }
+        }
+        #endif /* ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 */
+
         return uxOptionsLength; /* bytes, not words. */
     }
+    /*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+
+/**
+ * @brief Add the TCP Timestamps option ( RFC 7323 ) to an outgoing packet:
+ *        NOP, NOP, kind 8, length 10, TSval and TSecr.
+ *
+ * @param[in] pxSocket The socket owning the connection.
+ * @param[in,out] pxTCPHeader The TCP header in which the option will be written.
+ * @param[in] uxOptionsLength The offset in the options field where the time-stamp
+ *                            will be written.
+ *
+ * @return The length of the options, including the time-stamp.
+ */
+        UBaseType_t prvTCPAddTimeStampOption( const FreeRTOS_Socket_t * pxSocket,
+                                              TCPHeader_t * pxTCPHeader,
+                                              UBaseType_t uxOptionsLength )
+        {
+            uint32_t ulTSVal = ulTCPWindowGetTimeStamp();
+            uint32_t ulTSEcr = pxSocket->u.xTCP.xTCPWindow.ulTSRecent;
+            uint8_t * pucOption = &( pxTCPHeader->ucOptdata[ uxOptionsLength ] );
+
+            configASSERT( ( uxOptionsLength + tcpTCP_OPT_TIMESTAMP_SPACE ) <= ipSIZE_TCP_OPTIONS );
+
+            pucOption[ 0 ] = tcpTCP_OPT_NOOP;
+            pucOption[ 1 ] = tcpTCP_OPT_NOOP;
+            pucOption[ 2 ] = ( uint8_t ) tcpTCP_OPT_TIMESTAMP;
+            pucOption[ 3 ] = ( uint8_t ) tcpTCP_OPT_TIMESTAMP_LEN;
+            pucOption[ 4 ] = ( uint8_t ) ( ulTSVal >> 24 );
+            pucOption[ 5 ] = ( uint8_t ) ( ( ulTSVal >> 16 ) & 0xffU );
+            pucOption[ 6 ] = ( uint8_t ) ( ( ulTSVal >> 8 ) & 0xffU );
+            pucOption[ 7 ] = ( uint8_t ) ( ulTSVal & 0xffU );
+            pucOption[ 8 ] = ( uint8_t ) ( ulTSEcr >> 24 );
+            pucOption[ 9 ] = ( uint8_t ) ( ( ulTSEcr >> 16 ) & 0xffU );
+            pucOption[ 10 ] = ( uint8_t ) ( ( ulTSEcr >> 8 ) & 0xffU );
+            pucOption[ 11 ] = ( uint8_t ) ( ulTSEcr & 0xffU );
+
+            return uxOptionsLength + tcpTCP_OPT_TIMESTAMP_SPACE;
+        }
+    #endif /* ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 */
+    /*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+
+/**
+ * @brief Find the number of option bytes that every segment of a connection
+ *        will use for the time-stamp.
+ *
+ * @param[in] pxSocket The socket owning the connection.
+ *
+ * @return tcpTCP_OPT_TIMESTAMP_SPACE when time-stamps were negotiated, else zero.
+ */
+        UBaseType_t prvTCPTimeStampLength( const FreeRTOS_Socket_t * pxSocket )
+        {
+            UBaseType_t uxLength = 0U;
+
+            if( pxSocket->u.xTCP.bits.bTimeStamps != ipFALSE_BOOL )
+            {
+                uxLength = tcpTCP_OPT_TIMESTAMP_SPACE;
+            }
+
+            return uxLength;
+        }
+    #endif /* ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 */
+    /*-----------------------------------------------------------*/
+
+    #if ( ipconfigTCP_PACING == 1 )
+
+/**
+ * @brief Calculate the number of bytes that may be sent at a given rate
+ *        during a period of time.
+ *
+ * @param[in] ulRate The pacing rate in bytes per second.
+ * @param[in] ulPeriodMs The period in ms.
+ *
+ * @return The number of bytes, never more than the rate itself.
+ */
+        static uint32_t prvTCPPacingBytes( uint32_t ulRate,
+                                           uint32_t ulPeriodMs )
+        {
+            uint32_t ulBytes;
+
+            if( ulPeriodMs >= 1000U )
+            {
+                ulBytes = ulRate;
+            }
+            else
+            {
+                /* Split the rate to avoid an overflow. */
+                ulBytes = ( ( ulRate / 1000U ) * ulPeriodMs ) + ( ( ( ulRate % 1000U ) * ulPeriodMs ) / 1000U );
+            }
+
+            return ulBytes;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Get the pacing rate of a socket. When the user didn't set it,
+ *        the rate is twice the window divided by the SRTT.
+ *
+ * @param[in] pxSocket The socket owning the connection.
+ *
+ * @return The pacing rate in bytes per second, or zero when the rate is unknown.
+ */
+        static uint32_t prvTCPPacingRate( const FreeRTOS_Socket_t * pxSocket )
+        {
+            uint32_t ulRate = pxSocket->u.xTCP.ulPacingRate;
+
+            if( ulRate == 0U )
+            {
+                const TCPWindow_t * pxTCPWindow = &( pxSocket->u.xTCP.xTCPWindow );
+                uint32_t ulWindow = FreeRTOS_min_uint32( pxSocket->u.xTCP.ulWindowSize, pxTCPWindow->xSize.ulTxWindowLength );
+                uint32_t ulSRTT = ( uint32_t ) FreeRTOS_max_int32( pxTCPWindow->lSRTT, 1 );
+
+                if( ulWindow <= ( UINT32_MAX / 2000U ) )
+                {
+                    ulRate = ( ulWindow * 2000U ) / ulSRTT;
+                }
+                else if( ( ulWindow / ulSRTT ) <= ( UINT32_MAX / 2000U ) )
+                {
+                    ulRate = ( ulWindow / ulSRTT ) * 2000U;
+                }
+                else
+                {
+                    ulRate = UINT32_MAX;
+                }
+            }
+
+            return ulRate;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Add the credit that was earned since the last call, and see if
+ *        a segment may be sent now.
+ *
+ * @param[in] pxSocket The socket owning the connection.
+ *
+ * @return pdTRUE when a segment may be sent, otherwise pdFALSE.
+ */
+        BaseType_t prvTCPPacingMaySend( FreeRTOS_Socket_t * pxSocket )
+        {
+            BaseType_t xReturn = pdTRUE;
+            uint32_t ulRate = prvTCPPacingRate( pxSocket );
+
+            if( ulRate != 0U )
+            {
+                TickType_t xNow = xTaskGetTickCount();
+                TickType_t xElapsed = xNow - pxSocket->u.xTCP.xPacingLastTime;
+                uint32_t ulElapsedMs;
+                uint32_t ulBurst;
+                int32_t lCredit = pxSocket->u.xTCP.lPacingCredit;
+
+                /* The credit of one second is never more than the rate. Clamp
+                 * the ticks before converting them, because the multiplication
+                 * in pdTICKS_TO_MS() overflows after a long idle period. */
+                if( xElapsed > pdMS_TO_TICKS( 1000U ) )
+                {
+                    xElapsed = pdMS_TO_TICKS( 1000U );
+                }
+
+                ulElapsedMs = ( uint32_t ) pdTICKS_TO_MS( xElapsed );
+
+                /* Allow a burst of 2 segments, or whatever the rate allows during
+                 * a clock tick, because the timer can not wake up more often. */
+                ulBurst = FreeRTOS_max_uint32( 2U * ( uint32_t ) pxSocket->u.xTCP.usMSS,
+                                               prvTCPPacingBytes( ulRate, ( uint32_t ) portTICK_PERIOD_MS ) );
+                ulBurst = FreeRTOS_min_uint32( ulBurst, 0x3fffffffU );
+
+                if( ulElapsedMs != 0U )
+                {
+                    pxSocket->u.xTCP.xPacingLastTime = xNow;
+                    lCredit += ( int32_t ) FreeRTOS_min_uint32( prvTCPPacingBytes( ulRate, ulElapsedMs ), ulBurst );
+                    pxSocket->u.xTCP.lPacingCredit = FreeRTOS_min_int32( lCredit, ( int32_t ) ulBurst );
+                }
+
+                if( pxSocket->u.xTCP.lPacingCredit <= 0 )
+                {
+                    xReturn = pdFALSE;
+                }
+            }
+
+            return xReturn;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Calculate how long a socket must wait before the next segment may be sent.
+ *
+ * @param[in] pxSocket The socket owning the connection.
+ *
+ * @return The number of ms to wait, zero when a segment may be sent now.
+ */
+        uint32_t prvTCPPacingDelay( const FreeRTOS_Socket_t * pxSocket )
+        {
+            uint32_t ulDelayMs = 0U;
+            uint32_t ulRate = prvTCPPacingRate( pxSocket );
+
+            if( ( ulRate != 0U ) && ( pxSocket->u.xTCP.lPacingCredit <= 0 ) )
+            {
+                /* The credit is at most one segment below zero. */
+                uint32_t ulDeficit = ( uint32_t ) ( 1 - pxSocket->u.xTCP.lPacingCredit );
+
+                ulDelayMs = ( ( ulDeficit * 1000U ) / ulRate ) + 1U;
+            }
+
+            return ulDelayMs;
+        }
+    #endif /* ipconfigTCP_PACING == 1 */
 
 /**
  * @brief Check if the size of a network buffer is big enough to hold the outgoing message.
@@ -852,7 +1109,39 @@
              * Because some TCP-stacks (like uIP) use it for flow-control. */
             if( pxSocket->u.xTCP.usMSS > 1U )
             {
-                lDataLen = ( int32_t ) ulTCPWindowTxGet( pxTCPWindow, pxSocket->u.xTCP.ulWindowSize, &lStreamPos );
+                #if ( ipconfigTCP_PACING == 1 )
+                    /* When pacing, a new segment may only be sent when there is
+                     * credit. A retransmission replaces data that was lost, it
+                     * is sent at once and it does not use credit. */
+                    BaseType_t xIsRetransmission = xTCPWindowTxHasRetransmission( pxTCPWindow );
+
+                    if( ( xIsRetransmission != pdFALSE ) || ( prvTCPPacingMaySend( pxSocket ) != pdFALSE ) )
+                #endif
+                {
+                    #if ( ipconfigUSE_MIB_COUNTERS == 1 )
+                        uint32_t ulRetransmissions = pxTCPWindow->ulRetransmissions;
+                    #endif
+
+                    lDataLen = ( int32_t ) ulTCPWindowTxGet( pxTCPWindow, pxSocket->u.xTCP.ulWindowSize, &lStreamPos );
+
+                    #if ( ipconfigUSE_MIB_COUNTERS == 1 )
+                    {
+                        if( pxTCPWindow->ulRetransmissions != ulRetransmissions )
+                        {
+                            ipMIB_COUNT( NULL, pxSocket->pxEndPoint, eMIBTcpRetransSegs );
+                        }
+                    }
+                    #endif
+
+                    #if ( ipconfigTCP_PACING == 1 )
+                    {
+                        if( xIsRetransmission == pdFALSE )
+                        {
+                            pxSocket->u.xTCP.lPacingCredit -= lDataLen;
+                        }
+                    }
+                    #endif
+                }
             }
 
             if( lDataLen > 0 )
@@ -882,7 +1171,12 @@
 
                     /* Here data is copied from the txStream in 'peek' mode.  Only
                      * when the packets are acked, the tail marker will be updated. */
-                    ulDataGot = ( uint32_t ) uxStreamBufferGet( pxSocket->u.xTCP.txStream, uxOffset, pucSendData, ( size_t ) lDataLen, pdTRUE );
+                    #if ( ipconfigTCP_TX_BY_REFERENCE == 1 )
+                        /* Data sent by reference is read from the application memory. */
+                        ulDataGot = ( uint32_t ) uxTCPTxRefGet( pxSocket, uxOffset, pucSendData, ( size_t ) lDataLen );
+                    #else
+                        ulDataGot = ( uint32_t ) uxStreamBufferGet( pxSocket->u.xTCP.txStream, uxOffset, pucSendData, ( size_t ) lDataLen, pdTRUE );
+                    #endif
 
                     #if ( ipconfigHAS_DEBUG_PRINTF != 0 )
                     {
@@ -1002,6 +1296,17 @@
                 pxProtocolHeaders->xTCPHeader.ucTCPFlags &= ( ( uint8_t ) ~tcpTCP_FLAG_PSH );
                 pxProtocolHeaders->xTCPHeader.ucTCPOffset = ( uint8_t ) ( ( ipSIZE_OF_TCP_HEADER + uxOptionsLength ) << 2 ); /*_RB_ "2" needs comment. */
 
+                #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+                {
+                    /* When time-stamps are used, 'uxOptionsLength' covers just
+                     * the time-stamp.  Write it with the current time. */
+                    if( ( uxOptionsLength != 0U ) && ( pxSocket->u.xTCP.bits.bTimeStamps != ipFALSE_BOOL ) )
+                    {
+                        ( void ) prvTCPAddTimeStampOption( pxSocket, &( pxProtocolHeaders->xTCPHeader ), 0U );
+                    }
+                }
+                #endif
+
                 pxProtocolHeaders->xTCPHeader.ucTCPFlags |= ( uint8_t ) tcpTCP_FLAG_ACK;
 
                 if( lDataLen != 0L )
@@ -1139,6 +1444,17 @@
             /* Nothing. */
         }
 
+        #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+        {
+            if( pxSocket->u.xTCP.bits.bTimeStamps != ipFALSE_BOOL )
+            {
+                /* The time-stamp follows the other options, if any. */
+                uxOptionsLength = prvTCPAddTimeStampOption( pxSocket, pxTCPHeader, uxOptionsLength );
+                pxTCPHeader->ucTCPOffset = ( uint8_t ) ( ( ipSIZE_OF_TCP_HEADER + uxOptionsLength ) << 2 );
+            }
+        }
+        #endif
+
         return uxOptionsLength;
     }
     /*-----------------------------------------------------------*/
@@ -1178,9 +1494,17 @@
         #if ( ipconfigUSE_TCP_WIN == 1 )
             /* Two steps to please MISRA. */
             size_t uxSize = uxIPHeaderSizePacket( *ppxNetworkBuffer ) + ipSIZE_OF_TCP_HEADER;
-            BaseType_t xSizeWithoutData = ( BaseType_t ) uxSize;
-
+            BaseType_t xSizeWithoutData;
             int32_t lMinLength;
+
+            #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+            {
+                /* A time-stamp alone does not prevent an ACK from being delayed. */
+                uxSize += prvTCPTimeStampLength( pxSocket );
+            }
+            #endif
+
+            xSizeWithoutData = ( BaseType_t ) uxSize;
         #endif
 
         /* Set the time-out field, so that we'll be called by the IP-task in case no
@@ -170,6 +170,7 @@ void prvTCPReturnPacket_IPV4( FreeRTOS_Socket_t * pxSocket,
 
                 if( pxNetworkBuffer->pxEndPoint == NULL )
                 {
+                    ipMIB_COUNT( NULL, NULL, eMIBIpOutNoRoutes );
                     break;
                 }
             }
@@ -247,6 +248,7 @@ void prvTCPReturnPacket_IPV4( FreeRTOS_Socket_t * pxSocket,
 
             if( pxNetworkBuffer->pxEndPoint == NULL )
             {
+                ipMIB_COUNT( NULL, NULL, eMIBIpOutNoRoutes );
                 break;
             }
 
@@ -286,6 +288,7 @@ void prvTCPReturnPacket_IPV4( FreeRTOS_Socket_t * pxSocket,
             configASSERT( pxNetworkBuffer->pxEndPoint->pxNetworkInterface->pfOutput != NULL );
 
             pxInterface = pxNetworkBuffer->pxEndPoint->pxNetworkInterface;
+            ipMIB_COUNT_OUTPUT( pxNetworkBuffer );
             ( void ) pxInterface->pfOutput( pxInterface, pxNetworkBuffer, xDoRelease );
 
             if( xDoRelease == pdFALSE )
@@ -178,6 +178,8 @@ void prvTCPReturnPacket_IPV6( FreeRTOS_Socket_t * pxSocket,
 
                 if( pxNetworkBuffer->pxEndPoint == NULL )
                 {
+                    ipMIB_COUNT( NULL, NULL, eMIBIpOutNoRoutes );
+
                     if( xDoRelease != pdFALSE )
                     {
                         vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
@@ -280,6 +282,7 @@ void prvTCPReturnPacket_IPV6( FreeRTOS_Socket_t * pxSocket,
             configASSERT( pxNetworkBuffer->pxEndPoint->pxNetworkInterface->pfOutput != NULL );
 
             pxInterface = pxNetworkBuffer->pxEndPoint->pxNetworkInterface;
+            ipMIB_COUNT_OUTPUT( pxNetworkBuffer );
             ( void ) pxInterface->pfOutput( pxInterface, pxNetworkBuffer, xDoRelease );
 
             if( xDoRelease == pdFALSE )
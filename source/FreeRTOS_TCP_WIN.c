@@ -58,6 +58,19 @@
     #define winSRTT_DECREMENT_CURRENT    7                                     /**< Current decrement for the smoothed RTT. */
     #define winSRTT_CAP_mS               ( ipconfigTCP_SRTT_MINIMUM_VALUE_MS ) /**< Cap in milliseconds. */
 
+    #if ( ipconfigUSE_TCP_RTO_RFC6298 == 1 )
+/* Constants used for the Retransmission Time-Out (RTO), see RFC 6298. */
+        #define winRTO_INITIAL_mS        ( 1000 )                              /**< The RTO before the first RTT sample has been taken. */
+        #define winRTO_MAXIMUM_mS        ( 60000 )                             /**< The RTO, including back-off, will not exceed this value. */
+        #define winRTO_GRANULARITY_mS    ( ( int32_t ) portTICK_PERIOD_MS )    /**< The clock granularity 'G'. */
+    #endif
+
+    #if ( ipconfigTCP_TAIL_LOSS_PROBE == 1 )
+/* Constants used for the Tail Loss Probe (TLP), see RFC 8985. */
+        #define winTLP_MINIMUM_mS        ( 10U )                               /**< The minimum probe time-out. */
+        #define winTLP_DELAYED_ACK_mS    ( 200U )                              /**< Added to the PTO when a single segment is outstanding. */
+    #endif
+
     #if ( ipconfigUSE_TCP_WIN == 1 )
 
 /** @brief Create a new Rx window. */
@@ -187,6 +200,24 @@
                                                   uint32_t ulWindowSize );
     #endif /* ipconfigUSE_TCP_WIN == 1 */
 
+/*
+ * Return the time in ms that a segment may be outstanding before it must be
+ * retransmitted.  It includes the exponential back-off.
+ */
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+        static uint32_t prvTCPWindowTxGetRTO( const TCPWindow_t * pxWindow,
+                                              const TCPSegment_t * pxSegment );
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+
+/*
+ * Find the segment that would be sent as a tail loss probe, along with the
+ * time in ms before the probe time-out expires.
+ */
+    #if ( ipconfigTCP_TAIL_LOSS_PROBE == 1 )
+        static TCPSegment_t * prvTCPWindowTxGetProbe( const TCPWindow_t * pxWindow,
+                                                      uint32_t * pulDelay );
+    #endif /* ipconfigTCP_TAIL_LOSS_PROBE == 1 */
+
 /*
  * An acknowledge was received.  See if some outstanding data may be removed
  * from the transmission queue(s).
@@ -201,10 +232,40 @@
  * A higher Tx block has been acknowledged.  Now iterate through the xWaitQueue
  * to find a possible condition for a FAST retransmission.
  */
-    #if ( ipconfigUSE_TCP_WIN == 1 )
+    #if ( ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigTCP_SACK_RECOVERY == 0 ) )
         static uint32_t prvTCPWindowFastRetransmit( TCPWindow_t * pxWindow,
                                                     uint32_t ulFirst );
-    #endif /* ipconfigUSE_TCP_WIN == 1 */
+    #endif /* ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigTCP_SACK_RECOVERY == 0 ) */
+
+/*
+ * Use the list of transmitted segments as a SACK scoreboard: mark segments
+ * as lost and queue them for retransmission ( RFC 6675 ).
+ */
+    #if ( ipconfigTCP_SACK_RECOVERY == 1 )
+        static uint32_t prvTCPWindowTxScoreboard( TCPWindow_t * pxWindow );
+    #endif /* ipconfigTCP_SACK_RECOVERY == 1 */
+
+/*
+ * End a SACK based loss recovery, and clear the marks of the scoreboard.
+ */
+    #if ( ipconfigTCP_SACK_RECOVERY == 1 )
+        static void prvTCPWindowTxLeaveRecovery( TCPWindow_t * pxWindow );
+    #endif /* ipconfigTCP_SACK_RECOVERY == 1 */
+
+/*
+ * Estimate the number of bytes in flight, the 'pipe' of RFC 6675.
+ */
+    #if ( ipconfigTCP_SACK_RECOVERY == 1 )
+        static uint32_t prvTCPWindowTxPipe( const TCPWindow_t * pxWindow );
+    #endif /* ipconfigTCP_SACK_RECOVERY == 1 */
+
+/*
+ * Update the estimate of the RTT as seen by the receiver.
+ */
+    #if ( ipconfigTCP_RX_AUTOTUNE == 1 )
+        static void prvTCPWindowRxUpdateRTT( TCPWindow_t * pxWindow,
+                                             TickType_t uxNow );
+    #endif /* ipconfigTCP_RX_AUTOTUNE == 1 */
 
 /*-----------------------------------------------------------*/
 
@@ -630,6 +691,164 @@
     #endif /* ipconfigUSE_TCP_WIN == 1 */
 /*-----------------------------------------------------------*/
 
+    #if ( ipconfigTCP_RX_AUTOTUNE == 1 )
+
+/**
+ * @brief Called for every segment that was received in order: keep an estimate
+ *        of the round-trip time as seen by the receiver in 'lRxSRTT'. A socket
+ *        that only receives data never updates 'lSRTT', which is based on the
+ *        ACKs of transmitted data.
+ *        When time-stamps are used, a sample is taken each time the peer echoes
+ *        a new TSval: it is the age of the ACK that carried it. Otherwise, a
+ *        sample is the time in which one window of data was received, which is
+ *        close to the RTT when the window is the bottleneck.
+ *        Because a sample may include the time that the peer had no data to
+ *        send, a smaller sample is taken over immediately.
+ *
+ * @param[in] pxWindow The TCP window.
+ * @param[in] uxNow The current tick count.
+ */
+        static void prvTCPWindowRxUpdateRTT( TCPWindow_t * pxWindow,
+                                             TickType_t uxNow )
+        {
+            int32_t lSample = -1;
+            uint32_t ulRxNext = pxWindow->rx.ulCurrentSequenceNumber;
+
+            #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+                if( pxWindow->u.bits.bTSEchoValid != pdFALSE_UNSIGNED )
+                {
+                    if( pxWindow->ulTSEcho != pxWindow->ulRxRTTEcho )
+                    {
+                        pxWindow->ulRxRTTEcho = pxWindow->ulTSEcho;
+                        lSample = ( int32_t ) ( ulTCPWindowGetTimeStamp() - pxWindow->ulTSEcho );
+                    }
+                }
+                else
+            #endif /* ipconfigUSE_TCP_TIMESTAMP_OPTION */
+            {
+                if( ( pxWindow->u.bits.bRxRTTActive != pdFALSE_UNSIGNED ) &&
+                    ( xSequenceGreaterThanOrEqual( ulRxNext, pxWindow->ulRxRTTSequence ) != pdFALSE ) )
+                {
+                    lSample = ( int32_t ) pdTICKS_TO_MS( uxNow - pxWindow->uxRxRTTTime );
+                    pxWindow->u.bits.bRxRTTActive = pdFALSE_UNSIGNED;
+                }
+
+                if( pxWindow->u.bits.bRxRTTActive == pdFALSE_UNSIGNED )
+                {
+                    /* Measure the time until one more window has been received. */
+                    pxWindow->ulRxRTTSequence = ulRxNext + pxWindow->xSize.ulRxWindowLength;
+                    pxWindow->uxRxRTTTime = uxNow;
+                    pxWindow->u.bits.bRxRTTActive = pdTRUE_UNSIGNED;
+                }
+            }
+
+            if( lSample >= 0 )
+            {
+                lSample = FreeRTOS_max_int32( lSample, 1 );
+
+                if( ( pxWindow->lRxSRTT == 0 ) || ( lSample < pxWindow->lRxSRTT ) )
+                {
+                    pxWindow->lRxSRTT = lSample;
+                }
+                else
+                {
+                    pxWindow->lRxSRTT = ( ( 7 * pxWindow->lRxSRTT ) + lSample ) / 8;
+                }
+            }
+        }
+    #endif /* ipconfigTCP_RX_AUTOTUNE == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigTCP_RX_AUTOTUNE == 1 )
+
+/**
+ * @brief Account for data that was received in order, and see if the reception
+ *        window must grow. Once per RTT, the number of bytes received is
+ *        compared with the size of the window. When the peer has used at least
+ *        75% of the window, the window is considered to be the bottleneck, and
+ *        it will grow to twice the amount of data received per RTT.
+ *        The RTT is measured by the receiver, see prvTCPWindowRxUpdateRTT().
+ *
+ * @param[in] pxWindow The TCP window.
+ * @param[in] ulLength The number of bytes that were received in order.
+ *
+ * @return pdTRUE when the reception window has grown, otherwise pdFALSE.
+ */
+        BaseType_t xTCPWindowRxAutoTune( TCPWindow_t * pxWindow,
+                                         uint32_t ulLength )
+        {
+            BaseType_t xReturn = pdFALSE;
+            TickType_t uxNow = xTaskGetTickCount();
+            int32_t lRTT;
+            uint32_t ulInterval, ulElapsed, ulPerRTT, ulTarget;
+            uint32_t ulMSS = ( uint32_t ) pxWindow->usMSS;
+
+            prvTCPWindowRxUpdateRTT( pxWindow, uxNow );
+
+            if( pxWindow->ulRxAutoTuneBytes == 0U )
+            {
+                /* Start a new measurement. */
+                pxWindow->uxRxAutoTuneTime = uxNow;
+            }
+
+            pxWindow->ulRxAutoTuneBytes += ulLength;
+
+            /* Measure during at least one RTT. Until the receiver has measured
+             * it, use the SRTT of the transmission side. */
+            lRTT = ( pxWindow->lRxSRTT != 0 ) ? pxWindow->lRxSRTT : pxWindow->lSRTT;
+            ulInterval = ( uint32_t ) FreeRTOS_max_int32( lRTT, ( int32_t ) winSRTT_CAP_mS );
+
+            if( ulInterval == 0U )
+            {
+                ulInterval = 1U;
+            }
+
+            ulElapsed = ( uint32_t ) pdTICKS_TO_MS( uxNow - pxWindow->uxRxAutoTuneTime );
+
+            if( ( ulElapsed >= ulInterval ) && ( ulMSS != 0U ) )
+            {
+                /* The data may not have arrived in a single RTT, so the
+                 * measurement may have taken several round-trips. */
+                ulPerRTT = pxWindow->ulRxAutoTuneBytes / ( ulElapsed / ulInterval );
+
+                if( ulPerRTT >= ( pxWindow->xSize.ulRxWindowLength - ( pxWindow->xSize.ulRxWindowLength / 4U ) ) )
+                {
+                    /* Grow to twice the bandwidth-delay product, rounded up to a
+                     * whole number of segments. */
+                    if( ulPerRTT >= ( pxWindow->ulRxWindowMaximum / 2U ) )
+                    {
+                        ulTarget = pxWindow->ulRxWindowMaximum;
+                    }
+                    else
+                    {
+                        ulTarget = ( ( ( 2U * ulPerRTT ) + ulMSS - 1U ) / ulMSS ) * ulMSS;
+                        ulTarget = FreeRTOS_min_uint32( ulTarget, pxWindow->ulRxWindowMaximum );
+                    }
+
+                    if( ulTarget > pxWindow->xSize.ulRxWindowLength )
+                    {
+                        if( xTCPWindowLoggingLevel != 0 )
+                        {
+                            FreeRTOS_debug_printf( ( "xTCPWindowRxAutoTune: %u bytes per %u ms: RxWin %u -> %u\n",
+                                                     ( unsigned ) ulPerRTT,
+                                                     ( unsigned ) ulInterval,
+                                                     ( unsigned ) pxWindow->xSize.ulRxWindowLength,
+                                                     ( unsigned ) ulTarget ) );
+                        }
+
+                        pxWindow->xSize.ulRxWindowLength = ulTarget;
+                        xReturn = pdTRUE;
+                    }
+                }
+
+                pxWindow->ulRxAutoTuneBytes = 0U;
+            }
+
+            return xReturn;
+        }
+    #endif /* ipconfigTCP_RX_AUTOTUNE == 1 */
+/*-----------------------------------------------------------*/
+
     #if ( ipconfigUSE_TCP_WIN == 1 )
 
 /**
@@ -813,6 +1032,19 @@
         pxWindow->xSize.ulRxWindowLength = ulRxWindowLength;
         pxWindow->xSize.ulTxWindowLength = ulTxWindowLength;
 
+        #if ( ipconfigTCP_RX_AUTOTUNE == 1 )
+        {
+            /* The configured window becomes the limit, start small. */
+            pxWindow->ulRxWindowMaximum = ulRxWindowLength;
+
+            if( ulMSS != 0U )
+            {
+                pxWindow->xSize.ulRxWindowLength = FreeRTOS_min_uint32( ulRxWindowLength,
+                                                                        ( uint32_t ) ipconfigTCP_RX_AUTOTUNE_INITIAL_SEGMENTS * ulMSS );
+            }
+        }
+        #endif
+
         vTCPWindowInit( pxWindow, ulAckNumber, ulSequenceNumber, ulMSS );
 
         return xReturn;
@@ -860,6 +1092,26 @@
         /*Start with a timeout of 2 * 500 ms (1 sec). */
         pxWindow->lSRTT = l500ms;
 
+        #if ( ipconfigUSE_TCP_RTO_RFC6298 == 1 )
+        {
+            /* No RTT has been measured yet, use an RTO of 1 second. */
+            pxWindow->lRTTVar = 0;
+            pxWindow->lRTO = winRTO_INITIAL_mS;
+        }
+        #endif
+
+        #if ( ipconfigTCP_RX_AUTOTUNE == 1 )
+        {
+            pxWindow->ulRxAutoTuneBytes = 0U;
+            pxWindow->lRxSRTT = 0;
+            #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+            {
+                pxWindow->ulRxRTTEcho = 0U;
+            }
+            #endif
+        }
+        #endif
+
         /* Just for logging, to print relative sequence numbers. */
         pxWindow->rx.ulFirstSequenceNumber = ulAckNumber;
 
@@ -1171,6 +1423,16 @@
                 }
             }
 
+            #if ( ipconfigTCP_INFO == 1 )
+            {
+                /* Only count the SACK when it will be sent. */
+                if( pxWindow->ucOptionLength != 0U )
+                {
+                    pxWindow->ulSACKsSent++;
+                }
+            }
+            #endif
+
             return lReturn;
         }
     #endif /* ipconfigUSE_TCP_WIN == 1 */
@@ -1566,6 +1828,17 @@
                  * more new segment of size MSS.  xSize.ulTxWindowLength is the self-imposed
                  * limitation of the transmission window (in case of many resends it
                  * may be decreased). */
+                #if ( ipconfigTCP_SACK_RECOVERY == 1 )
+                {
+                    if( pxWindow->u.bits.bInRecovery != ipFALSE_BOOL )
+                    {
+                        /* During a recovery, only the data in flight counts,
+                         * not the data that has been SACK'd or lost. */
+                        ulTxOutstanding = prvTCPWindowTxPipe( pxWindow );
+                    }
+                }
+                #endif
+
                 if( ( ulTxOutstanding != 0U ) &&
                     ( pxWindow->xSize.ulTxWindowLength <
                       ( ulTxOutstanding + ( ( uint32_t ) pxSegment->lDataLength ) ) ) )
@@ -1581,6 +1854,114 @@
 
     #if ( ipconfigUSE_TCP_WIN == 1 )
 
+/**
+ * @brief Get the retransmission time-out of an outstanding segment.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] pxSegment The segment that is waiting for an ACK.
+ *
+ * @return The number of ms after which the segment must be sent again.
+ */
+        static uint32_t prvTCPWindowTxGetRTO( const TCPWindow_t * pxWindow,
+                                              const TCPSegment_t * pxSegment )
+        {
+            uint32_t ulMaxAge;
+
+            #if ( ipconfigUSE_TCP_RTO_RFC6298 == 1 )
+            {
+                uint32_t ulCount;
+
+                /* The first transmission waits for one RTO, every retransmission
+                 * doubles the time-out, up to a maximum of 60 seconds. */
+                ulMaxAge = ( uint32_t ) pxWindow->lRTO;
+
+                for( ulCount = 1U; ulCount < ( uint32_t ) pxSegment->u.bits.ucTransmitCount; ulCount++ )
+                {
+                    if( ulMaxAge >= ( uint32_t ) winRTO_MAXIMUM_mS )
+                    {
+                        break;
+                    }
+
+                    ulMaxAge <<= 1;
+                }
+
+                if( ulMaxAge > ( uint32_t ) winRTO_MAXIMUM_mS )
+                {
+                    ulMaxAge = ( uint32_t ) winRTO_MAXIMUM_mS;
+                }
+            }
+            #else /* if ( ipconfigUSE_TCP_RTO_RFC6298 == 1 ) */
+            {
+                /* As 'ucTransmitCount' has a minimum of 1, take 2 * SRTT. */
+                ulMaxAge = ( ( uint32_t ) 1U ) << pxSegment->u.bits.ucTransmitCount;
+                ulMaxAge *= ( uint32_t ) pxWindow->lSRTT;
+            }
+            #endif /* if ( ipconfigUSE_TCP_RTO_RFC6298 == 1 ) */
+
+            return ulMaxAge;
+        }
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigTCP_TAIL_LOSS_PROBE == 1 )
+
+/**
+ * @brief See if a tail loss probe is armed. The probe time-out (PTO) starts
+ *        when the most recently sent segment was transmitted, and it lasts
+ *        2 * SRTT. Only the first transmission of a flight is probed, and at
+ *        most once until new data is acknowledged.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[out] pulDelay The number of ms before the PTO expires, zero when it has expired.
+ *
+ * @return The segment to be sent as a probe, or NULL when no probe is armed.
+ */
+        static TCPSegment_t * prvTCPWindowTxGetProbe( const TCPWindow_t * pxWindow,
+                                                      uint32_t * pulDelay )
+        {
+            TCPSegment_t * pxReturn = NULL;
+            const TCPSegment_t * pxHead = xTCPWindowPeekHead( &( pxWindow->xWaitQueue ) );
+
+            *pulDelay = 0U;
+
+            if( ( pxHead != NULL ) &&
+                ( pxHead->u.bits.ucTransmitCount == 1U ) &&
+                ( pxWindow->u.bits.bProbeSent == ipFALSE_BOOL ) )
+            {
+                /* The tail of the waiting queue is the most recently sent segment. */
+                TCPSegment_t * pxTail = ( TCPSegment_t * ) listGET_LIST_ITEM_OWNER( pxWindow->xWaitQueue.xListEnd.pxPrevious );
+                uint32_t ulPTO = 2U * ( uint32_t ) pxWindow->lSRTT;
+                uint32_t ulAge;
+
+                if( pxTail == pxHead )
+                {
+                    /* A single segment is outstanding, the peer might delay its ACK. */
+                    ulPTO += winTLP_DELAYED_ACK_mS;
+                }
+
+                ulPTO = FreeRTOS_max_uint32( ulPTO, winTLP_MINIMUM_mS );
+
+                /* The probe is only useful when it comes before the RTO. */
+                if( ulPTO < prvTCPWindowTxGetRTO( pxWindow, pxHead ) )
+                {
+                    ulAge = ulTimerGetAge( &( pxTail->xTransmitTimer ) );
+
+                    if( ulPTO > ulAge )
+                    {
+                        *pulDelay = ulPTO - ulAge;
+                    }
+
+                    pxReturn = pxTail;
+                }
+            }
+
+            return pxReturn;
+        }
+    #endif /* ipconfigTCP_TAIL_LOSS_PROBE == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+
 /**
  * @brief Returns true if there is TX data that can be sent right now.
  *
@@ -1613,17 +1994,14 @@
 
                 if( pxSegment != NULL )
                 {
-                    uint32_t ulSRTT = ( uint32_t ) pxWindow->lSRTT;
-
                     /* There is an outstanding segment, see if it is time to resend
                      * it. */
                     ulAge = ulTimerGetAge( &pxSegment->xTransmitTimer );
 
                     /* After a packet has been sent for the first time, it will wait
-                     * '1 * ulSRTT' ms for an ACK. A second time it will wait '2 * ulSRTT' ms,
+                     * one RTO for an ACK. A second time it will wait 2 RTO's,
                      * each time doubling the time-out */
-                    ulMaxAge = ( ( uint32_t ) 1U << pxSegment->u.bits.ucTransmitCount );
-                    ulMaxAge *= ulSRTT;
+                    ulMaxAge = prvTCPWindowTxGetRTO( pxWindow, pxSegment );
 
                     if( ulMaxAge > ulAge )
                     {
@@ -1631,6 +2009,19 @@
                         *pulDelay = ulMaxAge - ulAge;
                     }
 
+                    #if ( ipconfigTCP_TAIL_LOSS_PROBE == 1 )
+                    {
+                        uint32_t ulProbeDelay;
+
+                        /* A tail loss probe may have to be sent before the RTO. */
+                        if( ( prvTCPWindowTxGetProbe( pxWindow, &( ulProbeDelay ) ) != NULL ) &&
+                            ( ulProbeDelay < *pulDelay ) )
+                        {
+                            *pulDelay = ulProbeDelay;
+                        }
+                    }
+                    #endif
+
                     xReturn = pdTRUE;
                 }
                 else
@@ -1684,10 +2075,7 @@
             if( pxSegment != NULL )
             {
                 /* Do check the timing. */
-                uint32_t ulMaxTime;
-
-                ulMaxTime = ( ( uint32_t ) 1U ) << pxSegment->u.bits.ucTransmitCount;
-                ulMaxTime *= ( uint32_t ) pxWindow->lSRTT;
+                uint32_t ulMaxTime = prvTCPWindowTxGetRTO( pxWindow, pxSegment );
 
                 if( ulTimerGetAge( &pxSegment->xTransmitTimer ) > ulMaxTime )
                 {
@@ -1785,6 +2173,42 @@
     #endif /* ipconfigUSE_TCP_WIN == 1 */
 /*-----------------------------------------------------------*/
 
+    #if ( ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigTCP_PACING == 1 ) )
+
+/**
+ * @brief See if the segment that ulTCPWindowTxGet() will return next is a
+ *        retransmission: a segment in the priority queue, or the oldest
+ *        outstanding segment when its retransmission timer has expired.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ *
+ * @return pdTRUE when a retransmission is due, otherwise pdFALSE.
+ */
+        BaseType_t xTCPWindowTxHasRetransmission( const TCPWindow_t * pxWindow )
+        {
+            BaseType_t xReturn = pdFALSE;
+            const TCPSegment_t * pxSegment;
+
+            if( listLIST_IS_EMPTY( &( pxWindow->xPriorityQueue ) ) == pdFALSE )
+            {
+                xReturn = pdTRUE;
+            }
+            else
+            {
+                pxSegment = xTCPWindowPeekHead( &( pxWindow->xWaitQueue ) );
+
+                if( ( pxSegment != NULL ) &&
+                    ( ulTimerGetAge( &( pxSegment->xTransmitTimer ) ) > prvTCPWindowTxGetRTO( pxWindow, pxSegment ) ) )
+                {
+                    xReturn = pdTRUE;
+                }
+            }
+
+            return xReturn;
+        }
+    #endif /* ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigTCP_PACING == 1 ) */
+/*-----------------------------------------------------------*/
+
     #if ( ipconfigUSE_TCP_WIN == 1 )
 
 /**
@@ -1803,6 +2227,7 @@
         {
             TCPSegment_t * pxSegment;
             uint32_t ulReturn = 0U;
+            BaseType_t xIsProbe = pdFALSE;
 
             /* Fetches data to be sent-out now.
              *
@@ -1824,6 +2249,16 @@
                                              ( unsigned ) ( pxSegment->ulSequenceNumber - pxWindow->tx.ulFirstSequenceNumber ),
                                              ( unsigned ) ulWindowSize ) );
                 }
+
+                #if ( ipconfigTCP_SACK_RECOVERY == 1 )
+                {
+                    if( pxSegment->u.bits.bIsLost != ipFALSE_BOOL )
+                    {
+                        /* The lost segment will be in flight again. */
+                        pxSegment->u.bits.bSackRexmit = ipTRUE_BOOL;
+                    }
+                }
+                #endif
             }
             else
             {
@@ -1832,12 +2267,57 @@
                  * have been sent earlier. */
                 pxSegment = pxTCPWindowTx_GetWaitQueue( pxWindow );
 
+                #if ( ipconfigTCP_SACK_RECOVERY == 1 )
+                {
+                    if( ( pxSegment != NULL ) && ( pxWindow->u.bits.bInRecovery != ipFALSE_BOOL ) )
+                    {
+                        /* An RTO ends the SACK based recovery. */
+                        prvTCPWindowTxLeaveRecovery( pxWindow );
+                    }
+                }
+                #endif
+
                 if( pxSegment == NULL )
                 {
                     /* New messages: sent-out for the first time.  Check current
                      * sliding window size of peer. */
                     pxSegment = pxTCPWindowTx_GetTXQueue( pxWindow, ulWindowSize );
                 }
+
+                #if ( ipconfigTCP_TAIL_LOSS_PROBE == 1 )
+                {
+                    uint32_t ulProbeDelay;
+
+                    if( pxSegment == NULL )
+                    {
+                        /* Nothing else to send, see if the probe time-out has expired.
+                         * If so, the most recently sent segment will be sent again. */
+                        pxSegment = prvTCPWindowTxGetProbe( pxWindow, &( ulProbeDelay ) );
+
+                        if( ( pxSegment != NULL ) && ( ulProbeDelay == 0U ) )
+                        {
+                            ( void ) uxListRemove( &( pxSegment->xQueueItem ) );
+                            pxSegment->u.bits.ucDupAckCount = ( uint8_t ) 0U;
+                            pxSegment->u.bits.bIsProbe = ipTRUE_BOOL;
+                            pxWindow->u.bits.bProbeSent = ipTRUE_BOOL;
+                            xIsProbe = pdTRUE;
+
+                            if( xTCPWindowLoggingLevel != 0 )
+                            {
+                                FreeRTOS_debug_printf( ( "ulTCPWindowTxGet[%u,%u]: TLP %d bytes for sequence number %u\n",
+                                                         pxWindow->usPeerPortNumber,
+                                                         pxWindow->usOurPortNumber,
+                                                         ( int ) pxSegment->lDataLength,
+                                                         ( unsigned ) ( pxSegment->ulSequenceNumber - pxWindow->tx.ulFirstSequenceNumber ) ) );
+                            }
+                        }
+                        else
+                        {
+                            pxSegment = NULL;
+                        }
+                    }
+                }
+                #endif /* ipconfigTCP_TAIL_LOSS_PROBE == 1 */
             }
 
             /* See if it has already been determined to return 0. */
@@ -1852,9 +2332,37 @@
                 /* And mark it as outstanding. */
                 pxSegment->u.bits.bOutstanding = ipTRUE_BOOL;
 
-                /* Administer the transmit count, needed for fast
-                 * retransmissions. */
-                ( pxSegment->u.bits.ucTransmitCount )++;
+                if( xIsProbe != pdFALSE )
+                {
+                    /* A probe is not counted as a transmission: it must not
+                     * back off the RTO ( RFC 8985 ). */
+                    #if ( ipconfigTCP_INFO == 1 ) || ( ipconfigUSE_MIB_COUNTERS == 1 )
+                    {
+                        pxWindow->ulRetransmissions++;
+                    }
+                    #endif
+                }
+                else
+                {
+                    /* Administer the transmit count, needed for fast
+                     * retransmissions. */
+                    ( pxSegment->u.bits.ucTransmitCount )++;
+
+                    #if ( ipconfigTCP_INFO == 1 ) || ( ipconfigUSE_MIB_COUNTERS == 1 )
+                    {
+                        if( pxSegment->u.bits.ucTransmitCount > 1U )
+                        {
+                            pxWindow->ulRetransmissions++;
+                        }
+                    }
+                    #endif /* ( ipconfigTCP_INFO == 1 ) || ( ipconfigUSE_MIB_COUNTERS == 1 ) */
+                }
+
+                #if ( ipconfigTCP_INFO == 1 )
+                {
+                    pxWindow->ulBytesSent += ( uint32_t ) pxSegment->lDataLength;
+                }
+                #endif /* ipconfigTCP_INFO == 1 */
 
                 /* If there have been several retransmissions (4), decrease the
                  * size of the transmission window to at most 2 times MSS. */
@@ -1887,7 +2395,7 @@
     #endif /* ipconfigUSE_TCP_WIN == 1 */
 /*-----------------------------------------------------------*/
 
-    #if ( ipconfigUSE_TCP_WIN == 1 )
+    #if ( ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigUSE_TCP_RTO_RFC6298 == 0 ) )
 
 /**
  * @brief Data has been sent, and an ACK has been received. Make an estimate
@@ -1934,7 +2442,78 @@
                 pxWindow->lSRTT = winSRTT_CAP_mS;
             }
         }
-    #endif /* ipconfigUSE_TCP_WIN == 1 */
+    #endif /* ( ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigUSE_TCP_RTO_RFC6298 == 0 ) ) */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_RTO_RFC6298 == 1 )
+
+/**
+ * @brief A new RTT sample has been taken. Update SRTT, RTTVAR and the
+ *        retransmission time-out as described in RFC 6298, section 2.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] lMeasured The measured round-trip time in ms.
+ */
+        static void prvTCPWindowTxCheckAck_CalcRTO( TCPWindow_t * pxWindow,
+                                                    int32_t lMeasured )
+        {
+            int32_t mS = lMeasured;
+            int32_t lDelta;
+            int32_t lVariance;
+
+            /* Limit the sample, so that the arithmetic below can not overflow. */
+            if( ( mS < 0 ) || ( mS > winRTO_MAXIMUM_mS ) )
+            {
+                mS = winRTO_MAXIMUM_mS;
+            }
+
+            if( pxWindow->u.bits.bRTTSampled == ipFALSE_BOOL )
+            {
+                /* The first measurement: SRTT = R, RTTVAR = R / 2. */
+                pxWindow->lSRTT = mS;
+                pxWindow->lRTTVar = mS / 2;
+                pxWindow->u.bits.bRTTSampled = ipTRUE_BOOL;
+            }
+            else
+            {
+                /* RTTVAR = ( 1 - beta ) * RTTVAR + beta * | SRTT - R |, beta = 1/4
+                 * SRTT = ( 1 - alpha ) * SRTT + alpha * R, alpha = 1/8
+                 * RTTVAR must be updated before SRTT. */
+                lDelta = pxWindow->lSRTT - mS;
+
+                if( lDelta < 0 )
+                {
+                    lDelta = -lDelta;
+                }
+
+                pxWindow->lRTTVar = ( ( 3 * pxWindow->lRTTVar ) + lDelta ) / 4;
+                pxWindow->lSRTT = ( ( 7 * pxWindow->lSRTT ) + mS ) / 8;
+            }
+
+            /* RTO = SRTT + max( G, K * RTTVAR ), K = 4 */
+            lVariance = 4 * pxWindow->lRTTVar;
+
+            if( lVariance < winRTO_GRANULARITY_mS )
+            {
+                lVariance = winRTO_GRANULARITY_mS;
+            }
+
+            pxWindow->lRTO = pxWindow->lSRTT + lVariance;
+
+            if( pxWindow->lRTO < winSRTT_CAP_mS )
+            {
+                pxWindow->lRTO = winSRTT_CAP_mS;
+            }
+            else if( pxWindow->lRTO > winRTO_MAXIMUM_mS )
+            {
+                pxWindow->lRTO = winRTO_MAXIMUM_mS;
+            }
+            else
+            {
+                /* The RTO is within its limits. */
+            }
+        }
+    #endif /* ipconfigUSE_TCP_RTO_RFC6298 == 1 */
 /*-----------------------------------------------------------*/
 
     #if ( ipconfigUSE_TCP_WIN == 1 )
@@ -2042,12 +2621,29 @@
                     /* This segment is fully ACK'd, set the flag. */
                     pxSegment->u.bits.bAcked = ipTRUE_BOOL;
 
+                    #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+                        /* When time-stamps are used, the echoed time-stamp gives
+                         * a valid RTT sample, also for a retransmitted segment. */
+                        if( ( pxWindow->u.bits.bTSEchoValid != pdFALSE_UNSIGNED ) &&
+                            ( ( pxSegment->ulSequenceNumber + ulDataLength ) == ulLast ) )
+                        {
+                            prvTCPWindowTxCheckAck_CalcRTO( pxWindow, ( int32_t ) ( ulTCPWindowGetTimeStamp() - pxWindow->ulTSEcho ) );
+                            pxWindow->u.bits.bTSEchoValid = pdFALSE_UNSIGNED;
+                        }
+                        else
+                    #endif /* ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 */
+
                     /* Calculate the RTT only if the segment was sent-out for the
                      * first time and if this is the last ACK'd segment in a range. */
                     if( ( pxSegment->u.bits.ucTransmitCount == 1U ) &&
+                        ( pxSegment->u.bits.bIsProbe == ipFALSE_BOOL ) &&
                         ( ( pxSegment->ulSequenceNumber + ulDataLength ) == ulLast ) )
                     {
-                        prvTCPWindowTxCheckAck_CalcSRTT( pxWindow, pxSegment );
+                        #if ( ipconfigUSE_TCP_RTO_RFC6298 == 1 )
+                            prvTCPWindowTxCheckAck_CalcRTO( pxWindow, ( int32_t ) ulTimerGetAge( &( pxSegment->xTransmitTimer ) ) );
+                        #else
+                            prvTCPWindowTxCheckAck_CalcSRTT( pxWindow, pxSegment );
+                        #endif
                     }
 
                     /* Unlink it from the 3 queues, but do not destroy it (yet). */
@@ -2094,7 +2690,7 @@
     #endif /* ipconfigUSE_TCP_WIN == 1 */
 /*-----------------------------------------------------------*/
 
-    #if ( ipconfigUSE_TCP_WIN == 1 )
+    #if ( ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigTCP_SACK_RECOVERY == 0 ) )
 
 /**
  * @brief See if there are segments that need a fast retransmission.
@@ -2167,7 +2763,167 @@
 
             return ulCount;
         }
-    #endif /* ipconfigUSE_TCP_WIN == 1 */
+    #endif /* ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigTCP_SACK_RECOVERY == 0 ) */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigTCP_SACK_RECOVERY == 1 )
+
+/**
+ * @brief Update the SACK scoreboard. The segments in 'xTxSegments' are sorted
+ *        on sequence number, and 'bAcked' tells which ones have been SACK'd.
+ *        A segment is lost when at least 3 SACK'd segments, or more than
+ *        2 * MSS of SACK'd data, have a higher sequence number ( IsLost() in
+ *        RFC 6675 ). Lost segments are moved to the priority queue, from
+ *        lowest to highest sequence number.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ *
+ * @return The number of segments that were queued for retransmission.
+ */
+        static uint32_t prvTCPWindowTxScoreboard( TCPWindow_t * pxWindow )
+        {
+            /* MISRA Ref 11.3.1 [Misaligned access] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+            /* coverity[misra_c_2012_rule_11_3_violation] */
+            const ListItem_t * pxEnd = ( ( const ListItem_t * ) &( pxWindow->xTxSegments.xListEnd ) );
+            const ListItem_t * pxIterator;
+            TCPSegment_t * pxSegment;
+            uint32_t ulSackedCount = 0U;
+            uint32_t ulSackedBytes = 0U;
+            uint32_t ulLostBytes = ( DUPLICATE_ACKS_BEFORE_FAST_RETRANSMIT - 1U ) * ( uint32_t ) pxWindow->usMSS;
+            uint32_t ulCount = 0U;
+
+            /* First count all SACK'd segments. */
+            for( pxIterator = listGET_NEXT( pxEnd ); pxIterator != pxEnd; pxIterator = listGET_NEXT( pxIterator ) )
+            {
+                pxSegment = ( ( TCPSegment_t * ) listGET_LIST_ITEM_OWNER( pxIterator ) );
+
+                if( pxSegment->u.bits.bAcked != ipFALSE_BOOL )
+                {
+                    ulSackedCount++;
+                    ulSackedBytes += ( uint32_t ) pxSegment->lDataLength;
+                }
+            }
+
+            /* Now walk from low to high, while 'ulSackedCount' and 'ulSackedBytes'
+             * tell what has been SACK'd above the current segment. */
+            pxIterator = listGET_NEXT( pxEnd );
+
+            while( ( pxIterator != pxEnd ) && ( ulSackedCount != 0U ) )
+            {
+                pxSegment = ( ( TCPSegment_t * ) listGET_LIST_ITEM_OWNER( pxIterator ) );
+                pxIterator = listGET_NEXT( pxIterator );
+
+                if( pxSegment->u.bits.bAcked != ipFALSE_BOOL )
+                {
+                    ulSackedCount--;
+                    ulSackedBytes -= ( uint32_t ) pxSegment->lDataLength;
+                }
+                else if( ( pxSegment->u.bits.bOutstanding != ipFALSE_BOOL ) &&
+                         ( pxSegment->u.bits.bIsLost == ipFALSE_BOOL ) &&
+                         ( ( ulSackedCount >= DUPLICATE_ACKS_BEFORE_FAST_RETRANSMIT ) || ( ulSackedBytes > ulLostBytes ) ) )
+                {
+                    pxSegment->u.bits.bIsLost = ipTRUE_BOOL;
+
+                    if( pxWindow->u.bits.bInRecovery == ipFALSE_BOOL )
+                    {
+                        /* Start a recovery episode, it lasts until all data
+                         * that has been sent so far is acknowledged. */
+                        pxWindow->u.bits.bInRecovery = ipTRUE_BOOL;
+                        pxWindow->ulRecoveryPoint = pxWindow->tx.ulHighestSequenceNumber;
+                    }
+
+                    if( listLIST_ITEM_CONTAINER( &( pxSegment->xQueueItem ) ) == &( pxWindow->xWaitQueue ) )
+                    {
+                        if( ( xTCPWindowLoggingLevel >= 0 ) && ( ipconfigTCP_MAY_LOG_PORT( pxWindow->usOurPortNumber ) ) )
+                        {
+                            FreeRTOS_debug_printf( ( "prvTCPWindowTxScoreboard: Lost sequence number %u (%u SACK'd above)\n",
+                                                     ( unsigned ) ( pxSegment->ulSequenceNumber - pxWindow->tx.ulFirstSequenceNumber ),
+                                                     ( unsigned ) ulSackedCount ) );
+                        }
+
+                        /* Move it from xWaitQueue to the priority queue, so it gets
+                         * retransmitted immediately. */
+                        ( void ) uxListRemove( &( pxSegment->xQueueItem ) );
+                        vListInsertFifo( &( pxWindow->xPriorityQueue ), &( pxSegment->xQueueItem ) );
+                        ulCount++;
+                    }
+                }
+                else
+                {
+                    /* Not lost, or already being recovered. */
+                }
+            }
+
+            return ulCount;
+        }
+    #endif /* ipconfigTCP_SACK_RECOVERY == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigTCP_SACK_RECOVERY == 1 )
+
+/**
+ * @brief End a loss recovery episode, either because all data that was outstanding
+ *        at its start has been acknowledged, or because of an RTO.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ */
+        static void prvTCPWindowTxLeaveRecovery( TCPWindow_t * pxWindow )
+        {
+            /* MISRA Ref 11.3.1 [Misaligned access] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+            /* coverity[misra_c_2012_rule_11_3_violation] */
+            const ListItem_t * pxEnd = ( ( const ListItem_t * ) &( pxWindow->xTxSegments.xListEnd ) );
+            const ListItem_t * pxIterator;
+            TCPSegment_t * pxSegment;
+
+            pxWindow->u.bits.bInRecovery = ipFALSE_BOOL;
+
+            for( pxIterator = listGET_NEXT( pxEnd ); pxIterator != pxEnd; pxIterator = listGET_NEXT( pxIterator ) )
+            {
+                pxSegment = ( ( TCPSegment_t * ) listGET_LIST_ITEM_OWNER( pxIterator ) );
+                pxSegment->u.bits.bIsLost = ipFALSE_BOOL;
+                pxSegment->u.bits.bSackRexmit = ipFALSE_BOOL;
+            }
+        }
+    #endif /* ipconfigTCP_SACK_RECOVERY == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigTCP_SACK_RECOVERY == 1 )
+
+/**
+ * @brief Estimate the number of bytes in flight: all outstanding data that is
+ *        not SACK'd, and not lost unless it has been retransmitted ( RFC 6675 ).
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ *
+ * @return The number of bytes in flight.
+ */
+        static uint32_t prvTCPWindowTxPipe( const TCPWindow_t * pxWindow )
+        {
+            /* MISRA Ref 11.3.1 [Misaligned access] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+            /* coverity[misra_c_2012_rule_11_3_violation] */
+            const ListItem_t * pxEnd = ( ( const ListItem_t * ) &( pxWindow->xTxSegments.xListEnd ) );
+            const ListItem_t * pxIterator;
+            const TCPSegment_t * pxSegment;
+            uint32_t ulPipe = 0U;
+
+            for( pxIterator = listGET_NEXT( pxEnd ); pxIterator != pxEnd; pxIterator = listGET_NEXT( pxIterator ) )
+            {
+                pxSegment = ( ( const TCPSegment_t * ) listGET_LIST_ITEM_OWNER( pxIterator ) );
+
+                if( ( pxSegment->u.bits.bOutstanding != ipFALSE_BOOL ) &&
+                    ( pxSegment->u.bits.bAcked == ipFALSE_BOOL ) &&
+                    ( ( pxSegment->u.bits.bIsLost == ipFALSE_BOOL ) || ( pxSegment->u.bits.bSackRexmit != ipFALSE_BOOL ) ) )
+                {
+                    ulPipe += ( uint32_t ) pxSegment->lDataLength;
+                }
+            }
+
+            return ulPipe;
+        }
+    #endif /* ipconfigTCP_SACK_RECOVERY == 1 */
 /*-----------------------------------------------------------*/
 
     #if ( ipconfigUSE_TCP_WIN == 1 )
@@ -2197,7 +2953,36 @@
             else
             {
                 ulReturn = prvTCPWindowTxCheckAck( pxWindow, ulFirstSequence, ulSequenceNumber );
+
+                #if ( ipconfigTCP_TAIL_LOSS_PROBE == 1 )
+                {
+                    if( ulReturn != 0U )
+                    {
+                        /* New data was acknowledged, a new probe may be armed. */
+                        pxWindow->u.bits.bProbeSent = ipFALSE_BOOL;
+                    }
+                }
+                #endif
+
+                #if ( ipconfigTCP_SACK_RECOVERY == 1 )
+                {
+                    if( ( pxWindow->u.bits.bInRecovery != ipFALSE_BOOL ) &&
+                        ( xSequenceGreaterThanOrEqual( ulSequenceNumber, pxWindow->ulRecoveryPoint ) != pdFALSE ) )
+                    {
+                        /* All data that was outstanding when the losses were
+                         * detected has been acknowledged. */
+                        prvTCPWindowTxLeaveRecovery( pxWindow );
+                    }
+                }
+                #endif
+            }
+
+            #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+            {
+                /* The echoed time-stamp belongs to this ACK only. */
+                pxWindow->u.bits.bTSEchoValid = pdFALSE_UNSIGNED;
             }
+            #endif
 
             return ulReturn;
         }
@@ -2223,9 +3008,24 @@
             uint32_t ulAckCount;
             uint32_t ulCurrentSequenceNumber = pxWindow->tx.ulCurrentSequenceNumber;
 
+            #if ( ipconfigTCP_INFO == 1 )
+            {
+                pxWindow->ulSACKsReceived++;
+            }
+            #endif
+
             /* Receive a SACK option. */
             ulAckCount = prvTCPWindowTxCheckAck( pxWindow, ulFirst, ulLast );
-            ( void ) prvTCPWindowFastRetransmit( pxWindow, ulFirst );
+
+            #if ( ipconfigTCP_SACK_RECOVERY == 1 )
+            {
+                ( void ) prvTCPWindowTxScoreboard( pxWindow );
+            }
+            #else
+            {
+                ( void ) prvTCPWindowFastRetransmit( pxWindow, ulFirst );
+            }
+            #endif
 
             if( ( xTCPWindowLoggingLevel >= 1 ) && ( xSequenceGreaterThan( ulFirst, ulCurrentSequenceNumber ) != pdFALSE ) )
             {
@@ -2242,4 +3042,35 @@
     #endif /* ipconfigUSE_TCP_WIN == 1 */
 /*-----------------------------------------------------------*/
 
+    #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+
+/**
+ * @brief Get the value of the clock that is used for the TCP Timestamps option.
+ *        The same clock is used to calculate the RTT from an echoed time-stamp.
+ *        The clock is a free-running counter of milliseconds, which is advanced
+ *        by the number of ticks that passed since the previous call. Converting
+ *        the tick count itself would make the clock jump when the tick count
+ *        wraps, unless the tick rate is 1000 Hz.
+ *        Only called from the IP-task.
+ *
+ * @return The time in ms, which wraps at 2^32.
+ */
+        uint32_t ulTCPWindowGetTimeStamp( void )
+        {
+            static TickType_t xLastTickCount = 0U;
+            static uint32_t ulTimeStampMS = 0U;
+            static uint32_t ulRemainder = 0U; /* In units of 1 / configTICK_RATE_HZ ms. */
+            TickType_t xNow = xTaskGetTickCount();
+            TickType_t xElapsed = xNow - xLastTickCount;
+            uint64_t ullElapsed = ( ( ( uint64_t ) xElapsed ) * 1000U ) + ulRemainder;
+
+            xLastTickCount = xNow;
+            ulTimeStampMS += ( uint32_t ) ( ullElapsed / ( uint64_t ) configTICK_RATE_HZ );
+            ulRemainder = ( uint32_t ) ( ullElapsed % ( uint64_t ) configTICK_RATE_HZ );
+
+            return ulTimeStampMS;
+        }
+    #endif /* ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 */
+/*-----------------------------------------------------------*/
+
 #endif /* ipconfigUSE_TCP == 1 */
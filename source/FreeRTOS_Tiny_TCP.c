@@ -279,6 +279,22 @@
                 {
                     pxSegment->u.bits.bOutstanding = pdTRUE_UNSIGNED;
                     pxSegment->u.bits.ucTransmitCount++;
+
+                    #if ( ipconfigTCP_INFO == 1 )
+                    {
+                        pxWindow->ulBytesSent += ulLength;
+                    }
+                    #endif /* ipconfigTCP_INFO == 1 */
+
+                    #if ( ipconfigTCP_INFO == 1 ) || ( ipconfigUSE_MIB_COUNTERS == 1 )
+                    {
+                        if( pxSegment->u.bits.ucTransmitCount > 1U )
+                        {
+                            pxWindow->ulRetransmissions++;
+                        }
+                    }
+                    #endif /* ( ipconfigTCP_INFO == 1 ) || ( ipconfigUSE_MIB_COUNTERS == 1 ) */
+
                     vTCPTimerSet( &pxSegment->xTransmitTimer );
                     pxWindow->ulOurSequenceNumber = pxSegment->ulSequenceNumber;
                     *plPosition = pxSegment->lStreamPos;
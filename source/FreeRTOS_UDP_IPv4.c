@@ -277,6 +277,7 @@ void vProcessGeneratedUDPPacket_IPv4( NetworkBufferDescriptor_t * const pxNetwor
 
             if( pxNetworkBuffer->pxEndPoint == NULL )
             {
+                ipMIB_COUNT( NULL, NULL, eMIBIpOutNoRoutes );
                 eReturned = eResolutionFailed;
             }
             else
@@ -326,12 +327,14 @@ void vProcessGeneratedUDPPacket_IPv4( NetworkBufferDescriptor_t * const pxNetwor
 
             if( ( pxInterface != NULL ) && ( pxInterface->pfOutput != NULL ) )
             {
+                ipMIB_COUNT_OUTPUT( pxNetworkBuffer );
                 ( void ) pxInterface->pfOutput( pxInterface, pxNetworkBuffer, pdTRUE );
             }
         }
         else
         {
             /* The packet can't be sent (no route found).  Drop the packet. */
+            ipMIB_COUNT( NULL, NULL, eMIBIpOutNoRoutes );
             vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
         }
     }
@@ -377,6 +380,14 @@ BaseType_t xProcessReceivedUDPPacket_IPv4( NetworkBufferDescriptor_t * pxNetwork
     /* Caller must check for minimum packet size. */
     pxSocket = pxUDPSocketLookup( usPort );
 
+    #if ( ipconfigUDP_CONNECTED_SOCKETS == 1 )
+        if( ( pxSocket != NULL ) && ( xUDPSocketAcceptsPacket( pxSocket, pxNetworkBuffer ) == pdFALSE ) )
+        {
+            /* The socket is connected to another peer. */
+            pxSocket = NULL;
+        }
+    #endif
+
     *pxIsWaitingForARPResolution = pdFALSE;
 
     do
@@ -431,6 +442,7 @@ BaseType_t xProcessReceivedUDPPacket_IPv4( NetworkBufferDescriptor_t * pxNetwork
                                   &( xSourceAddress ),
                                   &( destinationAddress ) ) != 0 )
                     {
+                        ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBUdpInDatagrams );
                         xReturn = pdFAIL; /* xHandler has consumed the data, do not add it to .xWaitingPacketsList'. */
                     }
                 }
@@ -446,6 +458,8 @@ BaseType_t xProcessReceivedUDPPacket_IPv4( NetworkBufferDescriptor_t * pxNetwork
                         FreeRTOS_debug_printf( ( "xProcessReceivedUDPPacket: buffer full %ld >= %ld port %u\n",
                                                  listCURRENT_LIST_LENGTH( &( pxSocket->u.xUDP.xWaitingPacketsList ) ),
                                                  pxSocket->u.xUDP.uxMaxPackets, pxSocket->usLocalPort ) );
+                        ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBUdpInErrors );
+                        ipDROP_FRAME( pxNetworkBuffer, eIPDropUDPQueueFull );
                         xReturn = pdFAIL; /* we did not consume or release the buffer */
                     }
                 }
@@ -466,6 +480,8 @@ BaseType_t xProcessReceivedUDPPacket_IPv4( NetworkBufferDescriptor_t * pxNetwork
                 }
                 ( void ) xTaskResumeAll();
 
+                ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBUdpInDatagrams );
+
                 /* Set the socket's receive event */
                 if( pxSocket->xEventGroup != NULL )
                 {
@@ -565,6 +581,8 @@ BaseType_t xProcessReceivedUDPPacket_IPv4( NetworkBufferDescriptor_t * pxNetwork
                 else
             #endif /* ipconfigUSE_NBNS */
             {
+                ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBUdpNoPorts );
+                ipDROP_FRAME( pxNetworkBuffer, eIPDropUDPNoSocket );
                 xReturn = pdFAIL;
             }
         }
@@ -350,11 +350,13 @@ void vProcessGeneratedUDPPacket_IPv6( NetworkBufferDescriptor_t * const pxNetwor
             }
             #endif /* if( ipconfigETHERNET_MINIMUM_PACKET_BYTES > 0 ) */
             iptraceNETWORK_INTERFACE_OUTPUT( pxNetworkBuffer->xDataLength, pxNetworkBuffer->pucEthernetBuffer );
+            ipMIB_COUNT_OUTPUT( pxNetworkBuffer );
             ( void ) pxInterface->pfOutput( pxInterface, pxNetworkBuffer, pdTRUE );
         }
         else
         {
             /* The packet can't be sent (no route found).  Drop the packet. */
+            ipMIB_COUNT( NULL, NULL, eMIBIpOutNoRoutes );
             vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
         }
     }
@@ -401,6 +403,14 @@ BaseType_t xProcessReceivedUDPPacket_IPv6( NetworkBufferDescriptor_t * pxNetwork
     /* Caller must check for minimum packet size. */
     pxSocket = pxUDPSocketLookup( usPort );
 
+    #if ( ipconfigUDP_CONNECTED_SOCKETS == 1 )
+        if( ( pxSocket != NULL ) && ( xUDPSocketAcceptsPacket( pxSocket, pxNetworkBuffer ) == pdFALSE ) )
+        {
+            /* The socket is connected to another peer. */
+            pxSocket = NULL;
+        }
+    #endif
+
     *pxIsWaitingForNDResolution = pdFALSE;
 
     do
@@ -412,6 +422,8 @@ BaseType_t xProcessReceivedUDPPacket_IPv6( NetworkBufferDescriptor_t * pxNetwork
             FreeRTOS_debug_printf( ( "xProcessReceivedUDPPacket_IPv6: Drop packets with checksum %d\n",
                                      pxUDPPacket_IPv6->xUDPHeader.usChecksum ) );
 
+            ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBUdpInErrors );
+            ipDROP_FRAME( pxNetworkBuffer, eIPDropChecksum );
             xReturn = pdFAIL;
             break;
         }
@@ -462,6 +474,7 @@ BaseType_t xProcessReceivedUDPPacket_IPv6( NetworkBufferDescriptor_t * pxNetwork
                                   &( xSourceAddress ),
                                   &( destinationAddress ) ) != 0 )
                     {
+                        ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBUdpInDatagrams );
                         xReturn = pdFAIL; /* xHandler has consumed the data, do not add it to .xWaitingPacketsList'. */
                     }
                 }
@@ -477,6 +490,8 @@ BaseType_t xProcessReceivedUDPPacket_IPv6( NetworkBufferDescriptor_t * pxNetwork
                         FreeRTOS_debug_printf( ( "xProcessReceivedUDPPacket: buffer full %ld >= %ld port %u\n",
                                                  listCURRENT_LIST_LENGTH( &( pxSocket->u.xUDP.xWaitingPacketsList ) ),
                                                  pxSocket->u.xUDP.uxMaxPackets, pxSocket->usLocalPort ) );
+                        ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBUdpInErrors );
+                        ipDROP_FRAME( pxNetworkBuffer, eIPDropUDPQueueFull );
                         xReturn = pdFAIL; /* we did not consume or release the buffer */
                     }
                 }
@@ -497,6 +512,8 @@ BaseType_t xProcessReceivedUDPPacket_IPv6( NetworkBufferDescriptor_t * pxNetwork
                 }
                 ( void ) xTaskResumeAll();
 
+                ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBUdpInDatagrams );
+
                 /* Set the socket's receive event */
                 if( pxSocket->xEventGroup != NULL )
                 {
@@ -579,6 +596,8 @@ BaseType_t xProcessReceivedUDPPacket_IPv6( NetworkBufferDescriptor_t * pxNetwork
                 else
             #endif /* ipconfigUSE_NBNS */
             {
+                ipMIB_COUNT( pxNetworkBuffer->pxInterface, pxNetworkBuffer->pxEndPoint, eMIBUdpNoPorts );
+                ipDROP_FRAME( pxNetworkBuffer, eIPDropUDPNoSocket );
                 xReturn = pdFAIL;
             }
         }
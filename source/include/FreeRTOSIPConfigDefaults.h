@@ -1643,6 +1643,360 @@ STATIC_ASSERT( ipconfigTCP_KEEP_ALIVE_INTERVAL <= ( portMAX_DELAY / configTICK_R
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * ipconfigUSE_TCP_RTO_RFC6298
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When enabled, the retransmission time-out of a TCP connection is calculated
+ * as described in RFC 6298: the sliding window keeps both a smoothed RTT
+ * ( SRTT ) and an RTT variance ( RTTVAR ), and the time-out becomes
+ * RTO = SRTT + max( G, 4 * RTTVAR ), doubled after each retransmission of a
+ * segment. Karn's rule is applied: segments that were retransmitted are not
+ * used to sample the RTT, unless the time-stamps of ipconfigUSE_TCP_TIMESTAMP_OPTION
+ * are in use.
+ *
+ * The RTO will never be smaller than ipconfigTCP_SRTT_MINIMUM_VALUE_MS.
+ *
+ * When disabled, the older estimator is used: a single weighted SRTT,
+ * and a retransmission after '2^n * SRTT' ms.
+ *
+ * Requires ipconfigUSE_TCP_WIN.
+ */
+
+#ifndef ipconfigUSE_TCP_RTO_RFC6298
+    #define ipconfigUSE_TCP_RTO_RFC6298    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_TCP_RTO_RFC6298 != ipconfigDISABLE ) && ( ipconfigUSE_TCP_RTO_RFC6298 != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TCP_RTO_RFC6298 configuration
+#endif
+
+#if ( ipconfigIS_ENABLED( ipconfigUSE_TCP_RTO_RFC6298 ) && ipconfigIS_DISABLED( ipconfigUSE_TCP_WIN ) )
+    #error ipconfigUSE_TCP_RTO_RFC6298 requires ipconfigUSE_TCP_WIN
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_TCP_TIMESTAMP_OPTION
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When enabled, the TCP Timestamps option ( RFC 7323 ) is offered in every
+ * SYN, and it is accepted when a peer offers it. Once it has been negotiated,
+ * each TCP segment carries a time-stamp of 12 bytes ( NOP, NOP, TSopt ).
+ * The echoed time-stamps allow the RTT to be sampled for every ACK that
+ * confirms new data, even while segments are being retransmitted.
+ *
+ * Because of the extra option bytes, the effective segment size of a
+ * connection will be 12 bytes smaller than its MSS.
+ *
+ * Requires ipconfigUSE_TCP_RTO_RFC6298, which uses the RTT samples.
+ */
+
+#ifndef ipconfigUSE_TCP_TIMESTAMP_OPTION
+    #define ipconfigUSE_TCP_TIMESTAMP_OPTION    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_TCP_TIMESTAMP_OPTION != ipconfigDISABLE ) && ( ipconfigUSE_TCP_TIMESTAMP_OPTION != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TCP_TIMESTAMP_OPTION configuration
+#endif
+
+#if ( ipconfigIS_ENABLED( ipconfigUSE_TCP_TIMESTAMP_OPTION ) && ipconfigIS_DISABLED( ipconfigUSE_TCP_RTO_RFC6298 ) )
+    #error ipconfigUSE_TCP_TIMESTAMP_OPTION requires ipconfigUSE_TCP_RTO_RFC6298
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigTCP_RX_AUTOTUNE
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When enabled, a TCP connection starts with a small reception window of
+ * ipconfigTCP_RX_AUTOTUNE_INITIAL_SEGMENTS segments. Every RTT, the number
+ * of bytes that were received in order is compared with the window size.
+ * When the peer used most of the window, the window is the bottleneck and
+ * it will grow to twice the measured bandwidth-delay product. The RTT is
+ * measured by the receiver, from the TCP time-stamps when available, or
+ * else from the time in which one window of data is received.
+ *
+ * The window never grows beyond the configured reception window, i.e. the
+ * 'uxRxWinSize' set by ipconfigTCP_RX_BUFFER_LENGTH or FREERTOS_SO_WIN_PROPERTIES.
+ * The reception stream is allocated with the size of the tuned window, and
+ * no more than the configured stream size. When the window has grown, the
+ * next read by the application asks the IP-task to replace the stream with
+ * a bigger one, and waits until that is done. The window scale factor is calculated from the configured
+ * maximum, because it can not be changed after the SYN phase.
+ * The window never shrinks.
+ *
+ * Requires ipconfigUSE_TCP_WIN.
+ */
+
+#ifndef ipconfigTCP_RX_AUTOTUNE
+    #define ipconfigTCP_RX_AUTOTUNE    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigTCP_RX_AUTOTUNE != ipconfigDISABLE ) && ( ipconfigTCP_RX_AUTOTUNE != ipconfigENABLE ) )
+    #error Invalid ipconfigTCP_RX_AUTOTUNE configuration
+#endif
+
+#if ( ipconfigIS_ENABLED( ipconfigTCP_RX_AUTOTUNE ) && ipconfigIS_DISABLED( ipconfigUSE_TCP_WIN ) )
+    #error ipconfigTCP_RX_AUTOTUNE requires ipconfigUSE_TCP_WIN
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigTCP_RX_AUTOTUNE_INITIAL_SEGMENTS
+ *
+ * Type: uint32_t
+ * Unit: count of segments ( MSS )
+ * Minimum: 1
+ *
+ * The initial size of the reception window when ipconfigTCP_RX_AUTOTUNE
+ * is enabled. When the configured reception window is smaller, that
+ * value will be used.
+ */
+
+#ifndef ipconfigTCP_RX_AUTOTUNE_INITIAL_SEGMENTS
+    #define ipconfigTCP_RX_AUTOTUNE_INITIAL_SEGMENTS    ( 2U )
+#endif
+
+#if ( ipconfigTCP_RX_AUTOTUNE_INITIAL_SEGMENTS < 1 )
+    #error ipconfigTCP_RX_AUTOTUNE_INITIAL_SEGMENTS must be at least 1
+#endif
+
+#if ( ipconfigTCP_RX_AUTOTUNE_INITIAL_SEGMENTS > UINT32_MAX )
+    #error ipconfigTCP_RX_AUTOTUNE_INITIAL_SEGMENTS overflows a uint32_t
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigTCP_PACING
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When enabled, the transmission of TCP segments is paced: in stead of
+ * sending all segments that fit in the window back-to-back, a TCP socket
+ * only sends a segment when it has enough credit. The credit grows with
+ * the pacing rate, and it is capped to a small burst of two segments, or
+ * to what the rate allows during one clock tick, whichever is larger.
+ * When a segment is held back, the socket's timer is set to wake up the
+ * IP-task at the moment that the next segment may be sent. The timer
+ * can not wake up more often than once per clock tick, so a paced segment
+ * may be delayed by up to one tick.
+ *
+ * Retransmissions are not paced: they are sent as soon as they are due,
+ * and they do not use credit.
+ *
+ * The pacing rate of a socket can be set with the socket option
+ * FREERTOS_SO_PACING_RATE, in bytes per second. When it is zero, which is
+ * the default, the rate is derived from the window and the SRTT:
+ * 2 * min( peer's window, TX window ) / SRTT.
+ *
+ * Requires ipconfigUSE_TCP_WIN.
+ */
+
+#ifndef ipconfigTCP_PACING
+    #define ipconfigTCP_PACING    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigTCP_PACING != ipconfigDISABLE ) && ( ipconfigTCP_PACING != ipconfigENABLE ) )
+    #error Invalid ipconfigTCP_PACING configuration
+#endif
+
+#if ( ipconfigIS_ENABLED( ipconfigTCP_PACING ) && ipconfigIS_DISABLED( ipconfigUSE_TCP_WIN ) )
+    #error ipconfigTCP_PACING requires ipconfigUSE_TCP_WIN
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigTCP_TAIL_LOSS_PROBE
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When the last segment of a burst is lost, no duplicate ACKs will arrive
+ * to trigger a fast retransmission, and the connection has to wait for a
+ * full RTO. When enabled, a Tail Loss Probe ( TLP, see RFC 8985 ) is sent
+ * after a Probe Time-Out ( PTO ) of 2 * SRTT: the most recently sent segment
+ * is retransmitted, so that the peer will report the loss with a (S)ACK.
+ * When only one segment is outstanding, the PTO is extended with 200 ms
+ * to allow for a delayed ACK.
+ *
+ * At most one probe is sent until an ACK confirms new data. No probe is sent
+ * when the PTO would expire after the RTO.
+ *
+ * Requires ipconfigUSE_TCP_WIN.
+ */
+
+#ifndef ipconfigTCP_TAIL_LOSS_PROBE
+    #define ipconfigTCP_TAIL_LOSS_PROBE    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigTCP_TAIL_LOSS_PROBE != ipconfigDISABLE ) && ( ipconfigTCP_TAIL_LOSS_PROBE != ipconfigENABLE ) )
+    #error Invalid ipconfigTCP_TAIL_LOSS_PROBE configuration
+#endif
+
+#if ( ipconfigIS_ENABLED( ipconfigTCP_TAIL_LOSS_PROBE ) && ipconfigIS_DISABLED( ipconfigUSE_TCP_WIN ) )
+    #error ipconfigTCP_TAIL_LOSS_PROBE requires ipconfigUSE_TCP_WIN
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigTCP_SACK_RECOVERY
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When disabled, a segment is retransmitted quickly when it has been
+ * passed by 3 SACK options, which are counted per segment.
+ *
+ * When enabled, loss recovery follows RFC 6675: the list of transmitted
+ * segments is used as a scoreboard. After each SACK, every segment that
+ * has at least 3 SACK'd segments, or more than 2 * MSS of SACK'd data above
+ * it, is considered lost, and all of them are retransmitted within the same
+ * recovery episode. The episode ends when the data that was outstanding at
+ * its start has been acknowledged, or when an RTO occurs. During recovery,
+ * new data may be sent as long as the estimated data in flight ( 'pipe',
+ * the outstanding data that is neither SACK'd nor lost ) fits in the TX window.
+ *
+ * Requires ipconfigUSE_TCP_WIN.
+ */
+
+#ifndef ipconfigTCP_SACK_RECOVERY
+    #define ipconfigTCP_SACK_RECOVERY    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigTCP_SACK_RECOVERY != ipconfigDISABLE ) && ( ipconfigTCP_SACK_RECOVERY != ipconfigENABLE ) )
+    #error Invalid ipconfigTCP_SACK_RECOVERY configuration
+#endif
+
+#if ( ipconfigIS_ENABLED( ipconfigTCP_SACK_RECOVERY ) && ipconfigIS_DISABLED( ipconfigUSE_TCP_WIN ) )
+    #error ipconfigTCP_SACK_RECOVERY requires ipconfigUSE_TCP_WIN
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigTCP_ACCEPT_QUEUE
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When disabled, a listening socket refers to at most one connected child
+ * socket. After each successful call to FreeRTOS_accept(), the IP-task
+ * searches the list of bound TCP sockets for the next child that is ready
+ * to be accepted.
+ *
+ * When enabled, a listening socket keeps a FIFO of child sockets that have
+ * completed the 3-way handshake. FreeRTOS_accept() takes the oldest child
+ * from that queue without involving the IP-task, and the function
+ * FreeRTOS_accept_batch() becomes available to take several children in a
+ * single call.
+ */
+
+#ifndef ipconfigTCP_ACCEPT_QUEUE
+    #define ipconfigTCP_ACCEPT_QUEUE    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigTCP_ACCEPT_QUEUE != ipconfigDISABLE ) && ( ipconfigTCP_ACCEPT_QUEUE != ipconfigENABLE ) )
+    #error Invalid ipconfigTCP_ACCEPT_QUEUE configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigTCP_RX_BUFFER_LENDING
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When enabled, a TCP socket may opt in with the socket option
+ * FREERTOS_SO_RX_BUFFER_LENDING. For such a socket, a segment that arrives
+ * in order while the RX stream is empty is not copied into the stream.
+ * Instead, the network buffer itself is queued on the socket and lent to the
+ * application through FreeRTOS_recv_lent(). The application gives it back by
+ * calling FreeRTOS_release_lent(). Lent bytes are counted against the
+ * advertised reception window until they are released. FreeRTOS_recv() can
+ * still be used on such a socket, it copies the data out of the lent segments.
+ *
+ * Each lent segment holds a network buffer, so ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS
+ * may have to be increased. The ACK for a lent segment is built in a separate,
+ * small network buffer.
+ */
+
+#ifndef ipconfigTCP_RX_BUFFER_LENDING
+    #define ipconfigTCP_RX_BUFFER_LENDING    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigTCP_RX_BUFFER_LENDING != ipconfigDISABLE ) && ( ipconfigTCP_RX_BUFFER_LENDING != ipconfigENABLE ) )
+    #error Invalid ipconfigTCP_RX_BUFFER_LENDING configuration
+#endif
+
+#if ( ipconfigIS_ENABLED( ipconfigTCP_RX_BUFFER_LENDING ) && ipconfigIS_DISABLED( ipconfigUSE_TCP ) )
+    #error ipconfigTCP_RX_BUFFER_LENDING requires ipconfigUSE_TCP
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigTCP_TX_BY_REFERENCE
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When enabled, the function FreeRTOS_send_ref() becomes available. It
+ * queues application-owned memory for transmission on a TCP socket without
+ * copying it to the txStream. Only the space in the txStream is reserved.
+ * Outgoing segments are filled directly from the application memory, also
+ * when they are retransmitted. The memory must stay valid and unchanged
+ * until the peer has acknowledged all of it. At that moment the IP-task
+ * calls the completion handler of the reference.
+ */
+
+#ifndef ipconfigTCP_TX_BY_REFERENCE
+    #define ipconfigTCP_TX_BY_REFERENCE    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigTCP_TX_BY_REFERENCE != ipconfigDISABLE ) && ( ipconfigTCP_TX_BY_REFERENCE != ipconfigENABLE ) )
+    #error Invalid ipconfigTCP_TX_BY_REFERENCE configuration
+#endif
+
+#if ( ipconfigIS_ENABLED( ipconfigTCP_TX_BY_REFERENCE ) && ipconfigIS_DISABLED( ipconfigUSE_TCP ) )
+    #error ipconfigTCP_TX_BY_REFERENCE requires ipconfigUSE_TCP
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigTCP_INFO
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When enabled, every TCP socket keeps a small set of statistics, and the
+ * function FreeRTOS_GetTCPInfo() becomes available to read them: bytes and
+ * segments sent and received, retransmissions, SRTT and RTO, the current
+ * windows, SACK options sent and received, the time during which the peer
+ * advertised a zero window, and the time that FreeRTOS_send() waited for
+ * space in the TX stream. The counters are updated by simple additions
+ * and do not depend on logging, so they can be used in production builds.
+ */
+
+#ifndef ipconfigTCP_INFO
+    #define ipconfigTCP_INFO    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigTCP_INFO != ipconfigDISABLE ) && ( ipconfigTCP_INFO != ipconfigENABLE ) )
+    #error Invalid ipconfigTCP_INFO configuration
+#endif
+
+#if ( ipconfigIS_ENABLED( ipconfigTCP_INFO ) && ipconfigIS_DISABLED( ipconfigUSE_TCP ) )
+    #error ipconfigTCP_INFO requires ipconfigUSE_TCP
+#endif
+
+/*---------------------------------------------------------------------------*/
+
 /*
  * ipconfigTCP_WIN_SEG_COUNT
  *
@@ -1743,6 +2097,168 @@ STATIC_ASSERT( ipconfigTCP_KEEP_ALIVE_INTERVAL <= ( portMAX_DELAY / configTICK_R
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * ipconfigUDP_BATCH_CALLS
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When enabled, the functions FreeRTOS_sendto_batch() and
+ * FreeRTOS_recvfrom_batch() become available. They are the equivalents of
+ * sendmmsg() and recvmmsg(): several datagrams are passed to the IP-task
+ * with a single message, or several waiting datagrams are taken from a
+ * socket in a single call. Both functions also support FREERTOS_ZERO_COPY.
+ */
+
+#ifndef ipconfigUDP_BATCH_CALLS
+    #define ipconfigUDP_BATCH_CALLS    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUDP_BATCH_CALLS != ipconfigDISABLE ) && ( ipconfigUDP_BATCH_CALLS != ipconfigENABLE ) )
+    #error Invalid ipconfigUDP_BATCH_CALLS configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigSOCKET_IOVEC_CALLS
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When enabled, vectored I/O becomes available: FreeRTOS_sendv() and
+ * FreeRTOS_recvv() for TCP sockets, and FreeRTOS_sendmsg() for UDP sockets.
+ * Each of these functions takes an array of 'struct freertos_iovec'.
+ *
+ * FreeRTOS_sendv() adds all buffers to the txStream in one step. The IP-task
+ * never sees a part of them, so a header and a payload can go out in a
+ * single segment. FreeRTOS_sendmsg() gathers the buffers into a single
+ * network buffer and sends them as one datagram.
+ */
+
+#ifndef ipconfigSOCKET_IOVEC_CALLS
+    #define ipconfigSOCKET_IOVEC_CALLS    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigSOCKET_IOVEC_CALLS != ipconfigDISABLE ) && ( ipconfigSOCKET_IOVEC_CALLS != ipconfigENABLE ) )
+    #error Invalid ipconfigSOCKET_IOVEC_CALLS configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUDP_CONNECTED_SOCKETS
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When enabled, FreeRTOS_connect() can be called for a UDP socket. It fixes
+ * the peer of the socket: FreeRTOS_sendto() may then be called with a NULL
+ * destination address, and datagrams from other hosts or ports will not be
+ * delivered to the socket. Passing a NULL address to FreeRTOS_connect()
+ * dissolves the association.
+ *
+ * For an IPv4 peer, the end-point, the MAC address and the Ethernet/IP/UDP
+ * headers are cached in the socket. As long as the ARP cache does not
+ * change, a datagram is completed by the sending task and passed directly
+ * to the network interface, without an ARP lookup in the IP-task. The
+ * headers are built by the IP-task, which is asked to do so after a change
+ * of the ARP cache or of an end-point; meanwhile datagrams take the normal
+ * path.
+ */
+
+#ifndef ipconfigUDP_CONNECTED_SOCKETS
+    #define ipconfigUDP_CONNECTED_SOCKETS    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUDP_CONNECTED_SOCKETS != ipconfigDISABLE ) && ( ipconfigUDP_CONNECTED_SOCKETS != ipconfigENABLE ) )
+    #error Invalid ipconfigUDP_CONNECTED_SOCKETS configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUDP_GSO
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * UDP generic segmentation offload. When enabled, the socket option
+ * FREERTOS_SO_UDP_SEGMENT sets a segment size for a UDP socket. A call to
+ * FreeRTOS_sendto() with more data than one segment will then split the data
+ * into datagrams of that size, the last one may be shorter. All datagrams
+ * are passed to the IP-task with a single message, and they share one ARP
+ * lookup and one set of headers.
+ *
+ * The datagrams are queued like the ones from FreeRTOS_sendto_batch(), so
+ * ipconfigUDP_BATCH_CALLS must be enabled as well.
+ */
+
+#ifndef ipconfigUDP_GSO
+    #define ipconfigUDP_GSO    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUDP_GSO != ipconfigDISABLE ) && ( ipconfigUDP_GSO != ipconfigENABLE ) )
+    #error Invalid ipconfigUDP_GSO configuration
+#endif
+
+#if ( ( ipconfigUDP_GSO == ipconfigENABLE ) && ( ipconfigUDP_BATCH_CALLS == ipconfigDISABLE ) )
+    #error ipconfigUDP_GSO requires ipconfigUDP_BATCH_CALLS
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigSUPPORT_IP_MULTICAST
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When enabled, UDP sockets can join multicast groups with the socket options
+ * FREERTOS_SO_IP_ADD_MEMBERSHIP / FREERTOS_SO_IP_DROP_MEMBERSHIP (IPv4) and
+ * FREERTOS_SO_IPV6_ADD_MEMBERSHIP / FREERTOS_SO_IPV6_DROP_MEMBERSHIP (IPv6).
+ * Joining a group registers its MAC address with the pfAddAllowedMAC()
+ * function of the network interface, so that a driver can let the EMAC
+ * filter multicast frames in hardware. The stack sends IGMPv3 or MLDv2
+ * reports when a group is joined or left, and answers the queries of a
+ * multicast router. When an IGMPv1/v2 or MLDv1 querier is heard, the older
+ * protocol is used on that interface for a while. While an IGMPv1 querier is
+ * present, groups are left without sending a message.
+ *
+ * IGMP queries carry the IP Router Alert option, so for IPv4 also
+ * ipconfigIP_PASS_PACKETS_WITH_IP_OPTIONS must be enabled.
+ */
+
+#ifndef ipconfigSUPPORT_IP_MULTICAST
+    #define ipconfigSUPPORT_IP_MULTICAST    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigSUPPORT_IP_MULTICAST != ipconfigDISABLE ) && ( ipconfigSUPPORT_IP_MULTICAST != ipconfigENABLE ) )
+    #error Invalid ipconfigSUPPORT_IP_MULTICAST configuration
+#endif
+
+#if ( ( ipconfigSUPPORT_IP_MULTICAST == ipconfigENABLE ) && ( ipconfigUSE_IPv4 != 0 ) && ( ipconfigIP_PASS_PACKETS_WITH_IP_OPTIONS == ipconfigDISABLE ) )
+    #error ipconfigSUPPORT_IP_MULTICAST requires ipconfigIP_PASS_PACKETS_WITH_IP_OPTIONS
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigMULTICAST_MAX_MEMBERSHIPS
+ *
+ * Type: size_t
+ * Minimum: 1
+ *
+ * The maximum number of multicast group memberships, when
+ * ipconfigSUPPORT_IP_MULTICAST is enabled. Every socket that joins a group
+ * uses one entry, also when another socket has joined the same group.
+ */
+
+#ifndef ipconfigMULTICAST_MAX_MEMBERSHIPS
+    #define ipconfigMULTICAST_MAX_MEMBERSHIPS    8
+#endif
+
+#if ( ipconfigMULTICAST_MAX_MEMBERSHIPS < 1 )
+    #error ipconfigMULTICAST_MAX_MEMBERSHIPS must be at least 1
+#endif
+
+/*---------------------------------------------------------------------------*/
+
 /*
  * ipconfigUDP_MAX_SEND_BLOCK_TIME_TICKS
  *
@@ -1920,6 +2436,36 @@ STATIC_ASSERT( ipconfigUDP_MAX_SEND_BLOCK_TIME_TICKS <= portMAX_DELAY );
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * ipconfigSELECT_READY_LIST
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When enabled, every socket set keeps a list of its sockets that have
+ * pending events. A socket is added to that list by the IP-task at the
+ * moment an event of interest occurs, and FreeRTOS_select_ready() returns
+ * the sockets from that list together with their events. Unlike
+ * FreeRTOS_select(), it does not have to inspect all sockets in the
+ * system. Events are reported once, so the application should handle a
+ * socket until it has no more data or space, before waiting again.
+ *
+ * Requires ipconfigSUPPORT_SELECT_FUNCTION.
+ */
+
+#ifndef ipconfigSELECT_READY_LIST
+    #define ipconfigSELECT_READY_LIST    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigSELECT_READY_LIST != ipconfigDISABLE ) && ( ipconfigSELECT_READY_LIST != ipconfigENABLE ) )
+    #error Invalid ipconfigSELECT_READY_LIST configuration
+#endif
+
+#if ( ipconfigIS_ENABLED( ipconfigSELECT_READY_LIST ) && ipconfigIS_DISABLED( ipconfigSUPPORT_SELECT_FUNCTION ) )
+    #error ipconfigSELECT_READY_LIST requires ipconfigSUPPORT_SELECT_FUNCTION
+#endif
+
+/*---------------------------------------------------------------------------*/
+
 /*
  * ipconfigSOCK_DEFAULT_RECEIVE_BLOCK_TIME
  *
@@ -3417,6 +3963,280 @@ STATIC_ASSERT( ipconfigDNS_SEND_BLOCK_TIME_TICKS <= portMAX_DELAY );
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * ipconfigUSE_TRACE_RING
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * See this utility: tools/tcp_utilities/tcp_trace_ring.md
+ *
+ * Allow inclusion of a utility that implements the iptrace macros by writing
+ * small binary records into a ring buffer in RAM. The ring can be sent over
+ * UDP or written to a file, and decoded on a host with
+ * tools/tcp_utilities/tcp_trace_decode.py.
+ */
+
+#ifndef ipconfigUSE_TRACE_RING
+    #define ipconfigUSE_TRACE_RING    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_TRACE_RING != ipconfigDISABLE ) && ( ipconfigUSE_TRACE_RING != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TRACE_RING configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigTRACE_RING_RECORD_COUNT
+ *
+ * Type: size_t
+ * Unit: count of TraceRingRecord_t ( 16 bytes each )
+ * Minimum: 2, must be a power of 2
+ *
+ * Defines the number of records that the trace ring can hold. When the ring
+ * is full, the oldest records are overwritten.
+ */
+
+#ifndef ipconfigTRACE_RING_RECORD_COUNT
+    #define ipconfigTRACE_RING_RECORD_COUNT    ( 1024 )
+#endif
+
+#if ( ipconfigTRACE_RING_RECORD_COUNT < 2 )
+    #error ipconfigTRACE_RING_RECORD_COUNT must be at least 2
+#endif
+
+#if ( ( ipconfigTRACE_RING_RECORD_COUNT & ( ipconfigTRACE_RING_RECORD_COUNT - 1 ) ) != 0 )
+    #error ipconfigTRACE_RING_RECORD_COUNT must be a power of 2
+#endif
+
+#if ( ipconfigTRACE_RING_RECORD_COUNT > 0x80000000 )
+    #error ipconfigTRACE_RING_RECORD_COUNT overflows the 32-bit record index
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_PCAPNG_CAPTURE
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * See this utility: tools/tcp_utilities/tcp_pcapng.md
+ *
+ * Allow inclusion of a utility that implements iptraceDUMP_PACKET() by
+ * streaming the frames in pcapng format to a file, a ring of files, or a
+ * pipe, to be inspected with Wireshark.
+ *
+ * Only for the Linux port, the file is written by a separate pthread.
+ */
+
+#ifndef ipconfigUSE_PCAPNG_CAPTURE
+    #define ipconfigUSE_PCAPNG_CAPTURE    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_PCAPNG_CAPTURE != ipconfigDISABLE ) && ( ipconfigUSE_PCAPNG_CAPTURE != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_PCAPNG_CAPTURE configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_MIB_COUNTERS
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When enabled, the IP-task keeps a set of counters modelled after the
+ * IP, ICMP, UDP and TCP MIB's of RFC 4293 and RFC 4022, together with
+ * counters for ARP and Neighbour Discovery. Every event is counted once, in
+ * the most specific owner that is known at that moment: the end-point, or
+ * else the interface, or else a stack-wide set. The counters can be read
+ * with FreeRTOS_GetMIBCounters(). Counting costs one increment per event,
+ * so it can be left enabled in production builds.
+ */
+
+#ifndef ipconfigUSE_MIB_COUNTERS
+    #define ipconfigUSE_MIB_COUNTERS    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_MIB_COUNTERS != ipconfigDISABLE ) && ( ipconfigUSE_MIB_COUNTERS != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_MIB_COUNTERS configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_DROP_REASONS
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When enabled, every place where the stack discards a received frame, or
+ * fails to obtain a network buffer, records the reason in a counter of type
+ * eIPDropReason_t. The counters can be read with FreeRTOS_GetDropCounters().
+ * Optionally, the first bytes of the dropped frames are kept in a ring per
+ * reason, see ipconfigDROP_CAPTURE_COUNT.
+ */
+
+#ifndef ipconfigUSE_DROP_REASONS
+    #define ipconfigUSE_DROP_REASONS    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_DROP_REASONS != ipconfigDISABLE ) && ( ipconfigUSE_DROP_REASONS != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_DROP_REASONS configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigDROP_CAPTURE_COUNT
+ *
+ * Type: size_t
+ * Unit: count of DroppedFrame_t
+ * Minimum: 0
+ *
+ * The number of dropped frames that are kept in the ring of every drop
+ * reason, oldest entries are overwritten. They can be read with
+ * FreeRTOS_GetDroppedFrames(). There is a ring for each eIPDropReason_t, so
+ * the memory used grows with the number of reasons. When zero, only the
+ * counters are kept. Only used when ipconfigUSE_DROP_REASONS is enabled.
+ */
+
+#ifndef ipconfigDROP_CAPTURE_COUNT
+    #define ipconfigDROP_CAPTURE_COUNT    ( 0 )
+#endif
+
+#if ( ipconfigDROP_CAPTURE_COUNT < 0 )
+    #error ipconfigDROP_CAPTURE_COUNT must be at least 0
+#endif
+
+#if ( ipconfigDROP_CAPTURE_COUNT > SIZE_MAX )
+    #error ipconfigDROP_CAPTURE_COUNT overflows a size_t
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigDROP_CAPTURE_BYTES
+ *
+ * Type: size_t
+ * Unit: bytes
+ * Minimum: 14 ( the size of an Ethernet header )
+ * Maximum: 65535
+ *
+ * The number of bytes, counted from the start of the Ethernet header, that
+ * are stored for each captured frame. 64 bytes is enough for the Ethernet,
+ * IP and TCP headers of most frames.
+ */
+
+#ifndef ipconfigDROP_CAPTURE_BYTES
+    #define ipconfigDROP_CAPTURE_BYTES    ( 64 )
+#endif
+
+#if ( ipconfigDROP_CAPTURE_BYTES < 14 )
+    #error ipconfigDROP_CAPTURE_BYTES must be at least 14
+#endif
+
+#if ( ipconfigDROP_CAPTURE_BYTES > 65535 )
+    #error ipconfigDROP_CAPTURE_BYTES must be at most 65535
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigDROP_CAPTURE_SAMPLE_RATE
+ *
+ * Type: uint32_t
+ * Unit: count of dropped frames
+ * Minimum: 1
+ *
+ * Only one in every ipconfigDROP_CAPTURE_SAMPLE_RATE frames dropped for a
+ * reason is stored in the capture ring of that reason. The counters are
+ * always incremented. A value larger than one limits the cost of capturing
+ * during a flood of bad frames.
+ */
+
+#ifndef ipconfigDROP_CAPTURE_SAMPLE_RATE
+    #define ipconfigDROP_CAPTURE_SAMPLE_RATE    ( 1 )
+#endif
+
+#if ( ipconfigDROP_CAPTURE_SAMPLE_RATE < 1 )
+    #error ipconfigDROP_CAPTURE_SAMPLE_RATE must be at least 1
+#endif
+
+#if ( ipconfigDROP_CAPTURE_SAMPLE_RATE > UINT32_MAX )
+    #error ipconfigDROP_CAPTURE_SAMPLE_RATE overflows a uint32_t
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_IP_TASK_PROFILING
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When enabled, the IP-task measures how long it spends on every type of
+ * eIPEvent_t, how long events waited in the event queue, and how long the
+ * timer checks took. The durations are kept in histograms that can be read
+ * with FreeRTOS_GetIPTaskProfile(). The clock is defined by
+ * ipconfigIP_TASK_PROFILING_TIME(). Every queued event grows by 8 bytes to
+ * store its time of posting.
+ */
+
+#ifndef ipconfigUSE_IP_TASK_PROFILING
+    #define ipconfigUSE_IP_TASK_PROFILING    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_IP_TASK_PROFILING != ipconfigDISABLE ) && ( ipconfigUSE_IP_TASK_PROFILING != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_IP_TASK_PROFILING configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigIP_TASK_PROFILING_TIME
+ *
+ * Type: Macro Function
+ * Unit: any, e.g. microseconds or CPU cycles
+ *
+ * Returns the current time as a uint64_t that never decreases. The default
+ * calls the application-supplied function ullGetHighResolutionTime(). The
+ * resolution should be much finer than a clock tick for the histograms to be
+ * useful. It is also called by tasks that post events to the IP-task, but
+ * not from interrupts. A driver that posts an IPStackEvent_t directly with
+ * xQueueSendToBackFromISR() must set its field 'ullPostTime' to 0.
+ */
+
+#ifndef ipconfigIP_TASK_PROFILING_TIME
+    #define ipconfigIP_TASK_PROFILING_TIME()    ullGetHighResolutionTime()
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigIP_TASK_PROFILING_BUCKETS
+ *
+ * Type: size_t
+ * Unit: count of histogram buckets
+ * Minimum: 2
+ * Maximum: 64
+ *
+ * The number of buckets of each histogram. Bucket 0 counts durations of 0,
+ * bucket N counts durations from 2^(N-1) up to 2^N - 1 time units. The last
+ * bucket also counts all longer durations.
+ */
+
+#ifndef ipconfigIP_TASK_PROFILING_BUCKETS
+    #define ipconfigIP_TASK_PROFILING_BUCKETS    ( 20 )
+#endif
+
+#if ( ipconfigIP_TASK_PROFILING_BUCKETS < 2 )
+    #error ipconfigIP_TASK_PROFILING_BUCKETS must be at least 2
+#endif
+
+#if ( ipconfigIP_TASK_PROFILING_BUCKETS > 64 )
+    #error ipconfigIP_TASK_PROFILING_BUCKETS must be at most 64
+#endif
+
+/*---------------------------------------------------------------------------*/
+
 /*
  * ipconfigENABLE_BACKWARD_COMPATIBILITY
  *
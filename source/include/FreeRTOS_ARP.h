@@ -89,6 +89,11 @@ void vARPRefreshCacheEntry( const MACAddress_t * pxMACAddress,
                             const uint32_t ulIPAddress,
                             struct xNetworkEndPoint * pxEndPoint );
 
+#if ( ipconfigUDP_CONNECTED_SOCKETS == 1 )
+    /* Changes each time an entry of the ARP cache is replaced or removed. */
+    extern volatile UBaseType_t uxARPCacheGeneration;
+#endif
+
 #if ( ipconfigARP_USE_CLASH_DETECTION != 0 )
     /* Becomes non-zero if another device responded to a gratuitous ARP message. */
     extern BaseType_t xARPHadIPClash;
@@ -0,0 +1,131 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file FreeRTOS_Drop.h
+ * @brief Header file for the drop-reason counters of the FreeRTOS+TCP network
+ *        stack.
+ */
+
+#ifndef FREERTOS_DROP_H
+#define FREERTOS_DROP_H
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/** @brief The reasons why a received frame can be dropped. The values are used
+ * as an index in DropCounters_t. */
+typedef enum eIP_DROP_REASON
+{
+    eIPDropNoEndPoint = 0,     /**< The frame has no interface or end-point attached. */
+    eIPDropTooShort,           /**< The frame is shorter than the headers that it should contain. */
+    eIPDropFiltered,           /**< The frame was rejected by eConsiderFrameForProcessing(), e.g. a foreign MAC-address. */
+    eIPDropUnknownFrameType,   /**< The frame type is not handled by the stack. */
+    eIPDropResolutionPending,  /**< The sender is not in the ARP/ND cache, and a resolution is already pending. */
+    eIPDropBadHeader,          /**< The IP header or its options are malformed. */
+    eIPDropFragment,           /**< The packet is an IP fragment, fragments are not reassembled. */
+    eIPDropAddress,            /**< The source or destination address is not valid or not for this host. */
+    eIPDropChecksum,           /**< An IP, ICMP, UDP or TCP checksum is wrong. */
+    eIPDropUnknownProtocol,    /**< The IP protocol is not supported. */
+    eIPDropICMPInvalid,        /**< An ICMP or ICMPv6 message is malformed. */
+    eIPDropARPInvalid,         /**< An ARP packet is malformed or not acceptable. */
+    eIPDropUDPNoSocket,        /**< No UDP socket is bound to the destination port. */
+    eIPDropUDPQueueFull,       /**< The reception queue of the UDP socket is full. */
+    eIPDropTCPRejected,        /**< A TCP segment is malformed or does not belong to a connection. */
+    eIPDropNoBuffer,           /**< A network buffer could not be obtained. */
+    eIPDropEventQueueFull,     /**< A received frame could not be passed to the IP-task. */
+    eIPDropReasonCount         /**< The number of reasons, must be the last entry. */
+} eIPDropReason_t;
+
+/** @brief A counter for every drop reason, indexed by eIPDropReason_t. */
+typedef struct xDROP_COUNTERS
+{
+    uint32_t ulCounters[ eIPDropReasonCount ]; /**< The counters, indexed by eIPDropReason_t. */
+} DropCounters_t;
+
+#if ( ipconfigUSE_DROP_REASONS == 1 )
+
+    #if ( ipconfigDROP_CAPTURE_COUNT > 0 )
+
+/** @brief A copy of the first bytes of a dropped frame. */
+        typedef struct xDROPPED_FRAME
+        {
+            TickType_t xTimeStamp;                          /**< The tick count at the moment of the drop. */
+            uint8_t ucReason;                               /**< The drop reason, an eIPDropReason_t. */
+            uint16_t usLength;                              /**< The original length of the frame, capped at 65535. */
+            uint16_t usCaptured;                            /**< The number of valid bytes in ucHeader. */
+            uint8_t ucHeader[ ipconfigDROP_CAPTURE_BYTES ]; /**< The first bytes of the frame, starting at the Ethernet header. */
+        } DroppedFrame_t;
+    #endif
+
+/*
+ * Record that a frame is dropped. pxNetworkBuffer may be NULL when there is no
+ * frame, e.g. when no network buffer could be obtained. Must not be called from
+ * an interrupt.
+ */
+    void vIPDropFrame( const struct xNETWORK_BUFFER * pxNetworkBuffer,
+                       eIPDropReason_t eReason );
+
+/*
+ * Get a snapshot of the drop counters.
+ */
+    BaseType_t FreeRTOS_GetDropCounters( DropCounters_t * pxCounters );
+
+/*
+ * Clear the drop counters and the capture rings.
+ */
+    void FreeRTOS_ClearDropCounters( void );
+
+    #if ( ipconfigDROP_CAPTURE_COUNT > 0 )
+
+/*
+ * Copy at most uxMaxCount captured frames that were dropped for the given
+ * reason, the oldest first. Returns the number of frames copied.
+ */
+        size_t FreeRTOS_GetDroppedFrames( eIPDropReason_t eReason,
+                                          DroppedFrame_t * pxFrames,
+                                          size_t uxMaxCount );
+    #endif
+
+    #define ipDROP_FRAME( pxNetworkBuffer, eReason )    vIPDropFrame( ( pxNetworkBuffer ), ( eReason ) )
+#else
+    #define ipDROP_FRAME( pxNetworkBuffer, eReason )
+#endif /* ( ipconfigUSE_DROP_REASONS == 1 ) */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    } /* extern "C" */
+#endif
+/* *INDENT-ON* */
+
+#endif /* FREERTOS_DROP_H */
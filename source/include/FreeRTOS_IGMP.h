@@ -0,0 +1,112 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file FreeRTOS_IGMP.h
+ * @brief Header file for multicast group management (IGMP and MLD) for the
+ *        FreeRTOS+TCP network stack.
+ */
+
+#ifndef FREERTOS_IGMP_H
+#define FREERTOS_IGMP_H
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/* IGMP message types. */
+#define ipIGMP_MEMBERSHIP_QUERY        ( ( uint8_t ) 0x11U ) /**< IGMP membership query, all versions. */
+#define ipIGMP_V1_MEMBERSHIP_REPORT    ( ( uint8_t ) 0x12U ) /**< IGMPv1 membership report. */
+#define ipIGMP_V2_MEMBERSHIP_REPORT    ( ( uint8_t ) 0x16U ) /**< IGMPv2 membership report. */
+#define ipIGMP_LEAVE_GROUP             ( ( uint8_t ) 0x17U ) /**< IGMPv2 leave group. */
+#define ipIGMP_V3_MEMBERSHIP_REPORT    ( ( uint8_t ) 0x22U ) /**< IGMPv3 membership report. */
+
+#if ( ipconfigSUPPORT_IP_MULTICAST == 1 )
+
+/*
+ * Called from FreeRTOS_setsockopt(): register that a socket joins or leaves
+ * a multicast group. The actual work is done by the IP-task.
+ */
+    BaseType_t xMulticastMembershipRequest( const struct xSOCKET * pxSocket,
+                                            const IP_Address_t * pxGroup,
+                                            BaseType_t xIsIPv6,
+                                            struct xNetworkInterface * pxInterface,
+                                            BaseType_t xJoin );
+
+/*
+ * Called by the IP-task when a socket is closed: leave all its groups.
+ */
+    void vMulticastSocketClose( const struct xSOCKET * pxSocket );
+
+/*
+ * Called by the IP-task on an eMulticastGroupEvent: update the MAC filters
+ * and send reports for the groups that were joined or left.
+ */
+    void vMulticastProcessRequests( void );
+
+/*
+ * Called by the IP-task when the multicast timer has expired.
+ */
+    void vMulticastTimerExpired( void );
+
+/*
+ * Called by the IP-task when an end-point goes up: announce the groups
+ * that were joined on its interface.
+ */
+    void vMulticastNetworkUp( const struct xNetworkEndPoint * pxEndPoint );
+
+    #if ( ipconfigUSE_IPv4 != 0 )
+
+/*
+ * Process an incoming IGMP message.
+ */
+        eFrameProcessingResult_t eProcessIGMPPacket( const NetworkBufferDescriptor_t * const pxNetworkBuffer );
+    #endif
+
+    #if ( ipconfigUSE_IPv6 != 0 )
+
+/*
+ * Process an incoming MLD query or report.
+ */
+        void vProcessMLDPacket( const NetworkBufferDescriptor_t * const pxNetworkBuffer );
+    #endif
+
+#endif /* ( ipconfigSUPPORT_IP_MULTICAST == 1 ) */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    } /* extern "C" */
+#endif
+/* *INDENT-ON* */
+
+#endif /* FREERTOS_IGMP_H */
@@ -172,6 +172,9 @@ typedef struct xNETWORK_BUFFER
     #if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
         struct xNETWORK_BUFFER * pxNextBuffer; /**< Possible optimisation for expert users - requires network driver support. */
     #endif
+    #if ( ipconfigTCP_RX_BUFFER_LENDING != 0 )
+        size_t uxPayloadOffset;                /**< The offset of the payload of a TCP segment that is lent to the user. */
+    #endif
 
 #define ul_IPAddress     xIPAddress.xIP_IPv4
 #define x_IPv6Address    xIPAddress.xIP_IPv6
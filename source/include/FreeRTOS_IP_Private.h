@@ -34,6 +34,7 @@
 #include "FreeRTOS_Sockets.h"
 #include "FreeRTOS_Stream_Buffer.h"
 #include "FreeRTOS_Routing.h"
+#include "FreeRTOS_Drop.h"
 
 #if ( ipconfigUSE_TCP == 1 )
     #include "FreeRTOS_TCP_WIN.h"
@@ -85,7 +86,11 @@ typedef enum
     eSocketCloseEvent,    /*11: Send a message to the IP-task to close a socket. */
     eSocketSelectEvent,   /*12: Send a message to the IP-task for select(). */
     eSocketSignalEvent,   /*13: A socket must be signalled. */
-    eSocketSetDeleteEvent /*14: A socket set must be deleted. */
+    eSocketSetDeleteEvent, /*14: A socket set must be deleted. */
+    eSocketTxBatchEvent,   /*15: A UDP socket has queued a batch of packets to transmit. */
+    eMulticastGroupEvent,  /*16: A socket has joined or left a multicast group. */
+    eSocketRxGrowEvent,    /*17: A TCP socket asks to replace its rxStream with a bigger one. */
+    eSocketUDPHeaderEvent  /*18: A connected UDP socket asks to build its cached headers again. */
 } eIPEvent_t;
 
 /**
@@ -235,6 +240,9 @@ typedef struct IP_TASK_COMMANDS
 {
     eIPEvent_t eEventType; /**< The event-type enum */
     void * pvData;         /**< The data in the event */
+    #if ( ipconfigUSE_IP_TASK_PROFILING == 1 )
+        uint64_t ullPostTime; /**< The time at which the event was posted, or 0 when unknown. */
+    #endif
 } IPStackEvent_t;
 
 /** @brief This struct describes a packet, it is used by the function
@@ -532,6 +540,12 @@ BaseType_t xIPIsNetworkTaskReady( void );
             #if ( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
                 bConnPassed : 1,       /**< Connecting socket: Socket has been passed in a successful select()  */
             #endif /* ipconfigSUPPORT_SELECT_FUNCTION */
+            #if ( ipconfigTCP_RX_BUFFER_LENDING == 1 )
+                bRxLending : 1,        /**< In-order segments are lent to the application, see FreeRTOS_recv_lent() */
+            #endif /* ipconfigTCP_RX_BUFFER_LENDING */
+            #if ( ipconfigTCP_INFO == 1 )
+                bZeroWindow : 1,       /**< The peer advertises a zero window, see 'xZeroWindowStart' */
+            #endif /* ipconfigTCP_INFO */
             bFinAccepted : 1,          /**< This socket has received (or sent) a FIN and accepted it */
                 bFinSent : 1,          /**< We've sent out a FIN */
                 bFinRecv : 1,          /**< We've received a FIN from our peer */
@@ -539,7 +553,8 @@ BaseType_t xIPIsNetworkTaskReady( void );
                 bFinLast : 1,          /**< The last ACK (after FIN and FIN+ACK) has been sent or will be sent by the peer */
                 bRxStopped : 1,        /**< Application asked to temporarily stop reception */
                 bMallocError : 1,      /**< There was an error allocating a stream */
-                bWinScaling : 1;       /**< A TCP-Window Scaling option was offered and accepted in the SYN phase. */
+                bWinScaling : 1,       /**< A TCP-Window Scaling option was offered and accepted in the SYN phase. */
+                bTimeStamps : 1;       /**< The TCP Timestamps option was offered and accepted in the SYN phase. */
         } bits;                        /**< The bits structure */
         uint32_t ulHighestRxAllowed;   /**< The highest sequence number that we can receive at any moment */
         uint16_t usTimeout;            /**< Time (in ticks) after which this socket needs attention */
@@ -584,6 +599,32 @@ BaseType_t xIPIsNetworkTaskReady( void );
         uint32_t ulWindowSize;                /**< Current Window size advertised by peer */
         size_t uxRxWinSize;                   /**< Fixed value: size of the TCP reception window */
         size_t uxTxWinSize;                   /**< Fixed value: size of the TCP transmit window */
+        #if ( ipconfigTCP_PACING == 1 )
+            uint32_t ulPacingRate;            /**< Pacing rate in bytes per second, zero means: derived from the window and the SRTT */
+            int32_t lPacingCredit;            /**< The number of bytes that may be sent now, it may become negative */
+            TickType_t xPacingLastTime;       /**< The time at which 'lPacingCredit' was last updated */
+        #endif
+        #if ( ipconfigTCP_ACCEPT_QUEUE == 1 )
+            List_t xAcceptQueue;              /**< For a listening socket: the children that are ready to be accepted */
+            ListItem_t xAcceptItem;           /**< For a child socket: its entry in the parent's 'xAcceptQueue' */
+        #endif
+        #if ( ipconfigTCP_RX_BUFFER_LENDING == 1 )
+            List_t xRxLentList;                        /**< Received network buffers waiting to be lent to the application */
+            size_t uxRxLentBytes;                      /**< Payload bytes queued or lent, but not yet released */
+            NetworkBufferDescriptor_t * pxRxLendReply; /**< Set by prvStoreRxData(): the buffer in which the ACK will be built */
+        #endif
+        #if ( ipconfigTCP_TX_BY_REFERENCE == 1 )
+            TCPTxReference_t * pxTxRefFirst; /**< The oldest reference that has not been acknowledged completely */
+            TCPTxReference_t * pxTxRefLast;  /**< The reference that was queued last */
+        #endif
+        #if ( ipconfigTCP_INFO == 1 )
+            uint32_t ulSegmentsSent;         /**< Statistics: the number of segments sent */
+            uint32_t ulSegmentsReceived;     /**< Statistics: the number of segments received */
+            uint32_t ulBytesReceived;        /**< Statistics: the number of data bytes received in order */
+            TickType_t xZeroWindowStart;     /**< The time at which the peer started to advertise a zero window */
+            TickType_t xZeroWindowTicks;     /**< Statistics: the time spent with a zero peer window, not counting the current period */
+            TickType_t xStreamBlockedTicks;  /**< Statistics: the time that senders waited for space in the TX stream */
+        #endif
 
         TCPWindow_t xTCPWindow;               /**< The TCP window struct*/
     } IPTCPSocket_t;
@@ -599,6 +640,24 @@ typedef struct UDPSOCKET
     #if ( ipconfigUDP_MAX_RX_PACKETS > 0 )
         UBaseType_t uxMaxPackets; /**< Protection: limits the number of packets buffered per socket */
     #endif /* ipconfigUDP_MAX_RX_PACKETS */
+    #if ( ipconfigUDP_BATCH_CALLS == 1 )
+        List_t xTxBatchList; /**< Outgoing packets, waiting to be sent by the IP-task */
+    #endif /* ipconfigUDP_BATCH_CALLS */
+    #if ( ipconfigUDP_CONNECTED_SOCKETS == 1 )
+        BaseType_t xIsConnected;                 /**< pdTRUE when FreeRTOS_connect() has fixed the peer. */
+        struct freertos_sockaddr xRemoteAddress; /**< The peer of a connected socket. */
+        #if ( ipconfigUSE_IPv4 != 0 )
+            BaseType_t xHeaderValid;                    /**< pdTRUE when 'ucHeader' may be used. */
+            BaseType_t xHeaderPending;                  /**< pdTRUE while the IP-task is asked to build 'ucHeader'. */
+            UBaseType_t uxARPGeneration;                /**< The value of 'uxARPCacheGeneration' when 'ucHeader' was made. */
+            struct xNetworkEndPoint * pxRemoteEndPoint; /**< The end-point through which the peer is reached. */
+            /** The pre-built Ethernet, IP and UDP headers for the peer. */
+            uint8_t ucHeader[ sizeof( UDPPacket_t ) ];
+        #endif /* ( ipconfigUSE_IPv4 != 0 ) */
+    #endif /* ipconfigUDP_CONNECTED_SOCKETS */
+    #if ( ipconfigUDP_GSO == 1 )
+        size_t uxSegmentSize; /**< When non-zero, FreeRTOS_sendto() splits the data in datagrams of this size. */
+    #endif /* ipconfigUDP_GSO */
     #if ( ipconfigUSE_CALLBACKS == 1 )
         FOnUDPReceive_t pxHandleReceive; /**<
                                           * In case of a UDP socket:
@@ -659,6 +718,9 @@ struct xSOCKET
 
         EventBits_t xSocketBits;          /**< These bits indicate the events which have actually occurred.
                                            * They are maintained by the IP-task */
+        #if ( ipconfigSELECT_READY_LIST == 1 )
+            ListItem_t xSelectReadyItem;  /**< Used to reference the socket from the ready list of its socket set. */
+        #endif
     #endif /* ipconfigSUPPORT_SELECT_FUNCTION */
     struct xNetworkEndPoint * pxEndPoint; /**< The end-point to which the socket is bound. */
 
@@ -711,6 +773,15 @@ struct xSOCKET
  */
 FreeRTOS_Socket_t * pxUDPSocketLookup( UBaseType_t uxLocalPort );
 
+#if ( ipconfigUDP_CONNECTED_SOCKETS == 1 )
+
+/*
+ * A connected UDP socket only accepts packets from its peer.
+ */
+    BaseType_t xUDPSocketAcceptsPacket( const FreeRTOS_Socket_t * pxSocket,
+                                        const NetworkBufferDescriptor_t * pxNetworkBuffer );
+#endif
+
 /*
  * Calculate the upper-layer checksum
  * Works both for UDP, ICMP and TCP packages
@@ -752,6 +823,60 @@ int32_t lTCPAddRxdata( FreeRTOS_Socket_t * pxSocket,
                        const uint8_t * pcData,
                        uint32_t ulByteCount );
 
+#if ( ipconfigTCP_RX_AUTOTUNE == 1 )
+
+/*
+ * Called by the IP-task to replace the rxStream of a socket with a bigger
+ * one, after the reception window has grown.
+ */
+    void vTCPRxStreamGrow( FreeRTOS_Socket_t * pxSocket );
+#endif
+
+#if ( ipconfigTCP_RX_BUFFER_LENDING == 1 )
+
+/*
+ * Instead of copying it to the rxStream, queue a received segment on the
+ * socket so it can be lent to the application.  The item value of
+ * 'xBufferListItem' holds the offset of the payload.
+ */
+    void vTCPRxLendQueue( FreeRTOS_Socket_t * pxSocket,
+                          NetworkBufferDescriptor_t * pxNetworkBuffer );
+
+/*
+ * Subtract the number of bytes that are lent out from the space that is
+ * available in the reception stream.
+ */
+    uint32_t ulTCPRxLendSpace( const FreeRTOS_Socket_t * pxSocket,
+                               uint32_t ulSpace );
+#endif /* ipconfigTCP_RX_BUFFER_LENDING */
+
+#if ( ipconfigTCP_TX_BY_REFERENCE == 1 )
+
+/*
+ * Copy outgoing data, found at 'uxOffset' bytes from the tail of txStream.
+ * Bytes that were queued by FreeRTOS_send_ref() are read from the memory of
+ * the application, the other bytes from the txStream.
+ */
+    size_t uxTCPTxRefGet( FreeRTOS_Socket_t * pxSocket,
+                          size_t uxOffset,
+                          uint8_t * pucTarget,
+                          size_t uxLength );
+
+/*
+ * 'ulCount' bytes at the tail of txStream have been acknowledged.  Must be
+ * called before the tail is advanced.  Completed references are reported to
+ * their owner.
+ */
+    void vTCPTxRefAcked( FreeRTOS_Socket_t * pxSocket,
+                         uint32_t ulCount );
+
+/*
+ * Forget all queued references, their owners are told that the memory is not
+ * used any more.
+ */
+    void vTCPTxRefFlush( FreeRTOS_Socket_t * pxSocket );
+#endif /* ipconfigTCP_TX_BY_REFERENCE */
+
 /*
  * Currently called for any important event.
  */
@@ -820,6 +945,24 @@ size_t uxIPHeaderSizeSocket( const FreeRTOS_Socket_t * pxSocket );
 /* Returns pdTRUE is this function is called from the IP-task */
 BaseType_t xIsCallingFromIPTask( void );
 
+#if ( ipconfigUDP_BATCH_CALLS == 1 )
+
+/*
+ * Called by the IP-task to send the packets that were queued by a call to
+ * FreeRTOS_sendto_batch().
+ */
+    void vSocketSendBatch( FreeRTOS_Socket_t * pxSocket );
+#endif /* ipconfigUDP_BATCH_CALLS */
+
+#if ( ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) && ( ipconfigUSE_IPv4 != 0 ) )
+
+/*
+ * Called by the IP-task to build the headers for the peer of a connected UDP
+ * socket again.
+ */
+    void vSocketUDPHeaderRefresh( FreeRTOS_Socket_t * pxSocket );
+#endif /* ( ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) && ( ipconfigUSE_IPv4 != 0 ) ) */
+
 #if ( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
 
 /** @brief Structure for event groups of the Socket Select functions */
@@ -828,6 +971,9 @@ BaseType_t xIsCallingFromIPTask( void );
         /** @brief Event group for the socket select function.
          */
         EventGroupHandle_t xSelectGroup;
+        #if ( ipconfigSELECT_READY_LIST == 1 )
+            List_t xReadyList; /**< The sockets that have events which have not been reported yet. */
+        #endif
     } SocketSelect_t;
 
     extern void vSocketSelect( const SocketSelect_t * pxSocketSet );
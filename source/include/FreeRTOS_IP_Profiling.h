@@ -0,0 +1,113 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file FreeRTOS_IP_Profiling.h
+ * @brief Header file for the processing-time histograms of the IP-task.
+ */
+
+#ifndef FREERTOS_IP_PROFILING_H
+#define FREERTOS_IP_PROFILING_H
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+#if ( ipconfigUSE_IP_TASK_PROFILING == 1 )
+
+/** @brief The number of histograms per kind of measurement: one for every eIPEvent_t,
+ * including eNoEvent. The histogram of an event is found at index ( eEventType + 1 ). */
+    #define ipIP_TASK_PROFILE_EVENT_COUNT    ( ( size_t ) eSocketUDPHeaderEvent + 2U )
+
+/** @brief A histogram of durations, in units of ipconfigIP_TASK_PROFILING_TIME().
+ * Bucket 0 counts durations of 0, bucket N counts durations from 2^(N-1) up to
+ * 2^N - 1. The last bucket also counts all longer durations. */
+    typedef struct xIP_TASK_HISTOGRAM
+    {
+        uint32_t ulCount;                                           /**< The number of durations measured. */
+        uint64_t ullTotal;                                          /**< The sum of all durations. */
+        uint64_t ullMax;                                            /**< The longest duration. */
+        uint32_t ulBuckets[ ipconfigIP_TASK_PROFILING_BUCKETS ];    /**< The number of durations per bucket. */
+    } IPTaskHistogram_t;
+
+/** @brief All histograms kept for the IP-task. */
+    typedef struct xIP_TASK_PROFILE
+    {
+        IPTaskHistogram_t xProcessing[ ipIP_TASK_PROFILE_EVENT_COUNT ]; /**< The time spent handling an event, per event type. */
+        IPTaskHistogram_t xQueueWait[ ipIP_TASK_PROFILE_EVENT_COUNT ];  /**< The time an event waited in the queue, per event type. */
+        IPTaskHistogram_t xTimerCheck;                                  /**< The time spent in vCheckNetworkTimers(). */
+    } IPTaskProfile_t;
+
+/* The application-supplied clock used by the default ipconfigIP_TASK_PROFILING_TIME(). */
+    extern uint64_t ullGetHighResolutionTime( void );
+
+/*
+ * Add the time spent on an event to its histogram. Only to be called from
+ * the IP-task.
+ */
+    void vIPTaskProfileProcessing( eIPEvent_t eEventType,
+                                   uint64_t ullStartTime );
+
+/*
+ * Add the time that an event waited in the event queue to its histogram.
+ * Events that were posted without a time stamp are ignored. Only to be
+ * called from the IP-task.
+ */
+    void vIPTaskProfileQueueWait( const IPStackEvent_t * pxEvent,
+                                  uint64_t ullReceiveTime );
+
+/*
+ * Add the time spent in vCheckNetworkTimers() to its histogram. Only to be
+ * called from the IP-task.
+ */
+    void vIPTaskProfileTimerCheck( uint64_t ullStartTime );
+
+/*
+ * Get a snapshot of all histograms.
+ */
+    BaseType_t FreeRTOS_GetIPTaskProfile( IPTaskProfile_t * pxProfile );
+
+/*
+ * Clear all histograms.
+ */
+    void FreeRTOS_ClearIPTaskProfile( void );
+
+#endif /* ( ipconfigUSE_IP_TASK_PROFILING == 1 ) */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    } /* extern "C" */
+#endif
+/* *INDENT-ON* */
+
+#endif /* FREERTOS_IP_PROFILING_H */
@@ -143,6 +143,15 @@ void vIPSetTCPTimerExpiredState( BaseType_t xExpiredState );
     void vIPSetDNSTimerEnableState( BaseType_t xEnableState );
 #endif /* ipconfigDNS_USE_CALLBACKS != 0 */
 
+#if ( ipconfigSUPPORT_IP_MULTICAST == 1 )
+
+/**
+ * @brief Enable/disable the multicast timer.
+ * @param[in] xEnableState: pdTRUE - enable timer; pdFALSE - disable timer.
+ */
+    void vIPSetMulticastTimerEnableState( BaseType_t xEnableState );
+#endif /* ipconfigSUPPORT_IP_MULTICAST == 1 */
+
 /**
  * Sets the reload time of an TCP timer and restarts it.
  */
@@ -161,6 +170,14 @@ void vTCPTimerReload( TickType_t xTime );
     void vDNSTimerReload( uint32_t ulCheckTime );
 #endif /* ipconfigDNS_USE_CALLBACKS != 0 */
 
+#if ( ipconfigSUPPORT_IP_MULTICAST == 1 )
+
+/**
+ * Reload the multicast timer.
+ */
+    void vMulticastTimerReload( TickType_t xTime );
+#endif /* ipconfigSUPPORT_IP_MULTICAST == 1 */
+
 /**
  * Reload the Network timer.
  */
@@ -54,10 +54,14 @@
 #define ipICMP_PARAMETER_PROBLEM_IPv6            ( ( uint8_t ) 4U )
 #define ipICMP_PING_REQUEST_IPv6                 ( ( uint8_t ) 128U )
 #define ipICMP_PING_REPLY_IPv6                   ( ( uint8_t ) 129U )
+#define ipICMP_MULTICAST_LISTENER_QUERY_IPv6     ( ( uint8_t ) 130U )
+#define ipICMP_MULTICAST_LISTENER_REPORT_IPv6    ( ( uint8_t ) 131U )
+#define ipICMP_MULTICAST_LISTENER_DONE_IPv6      ( ( uint8_t ) 132U )
 #define ipICMP_ROUTER_SOLICITATION_IPv6          ( ( uint8_t ) 133U )
 #define ipICMP_ROUTER_ADVERTISEMENT_IPv6         ( ( uint8_t ) 134U )
 #define ipICMP_NEIGHBOR_SOLICITATION_IPv6        ( ( uint8_t ) 135U )
 #define ipICMP_NEIGHBOR_ADVERTISEMENT_IPv6       ( ( uint8_t ) 136U )
+#define ipICMP_MULTICAST_LISTENER_REPORT_V2_IPv6 ( ( uint8_t ) 143U )
 
 
 #define ipIPv6_EXT_HEADER_HOP_BY_HOP             0U
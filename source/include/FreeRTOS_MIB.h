@@ -0,0 +1,146 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file FreeRTOS_MIB.h
+ * @brief Header file for the MIB counters of the FreeRTOS+TCP network stack.
+ */
+
+#ifndef FREERTOS_MIB_H
+#define FREERTOS_MIB_H
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/** @brief The counters that are kept, named after the objects of RFC 4293 ( IP-MIB )
+ * and RFC 4022 ( TCP-MIB ). The values are used as an index in MIBCounters_t. */
+typedef enum eMIB_COUNTER
+{
+    eMIBIpInReceives = 0,    /**< IP-packets received, including the ones with errors. */
+    eMIBIpInHdrErrors,       /**< IP-packets dropped because of a malformed header or a header checksum error. */
+    eMIBIpInAddrErrors,      /**< IP-packets dropped because the address is not valid or not for this host. */
+    eMIBIpInUnknownProtos,   /**< IP-packets dropped because the protocol is not supported. */
+    eMIBIpInDiscards,        /**< IP-packets that were valid but were dropped, e.g. for lack of buffers. */
+    eMIBIpReasmFails,        /**< IP-fragments dropped, the stack does not reassemble fragments. */
+    eMIBIpInDelivers,        /**< IP-packets passed to ICMP, IGMP, UDP or TCP. */
+    eMIBIpOutRequests,       /**< IP-packets that were handed to a network interface. */
+    eMIBIpOutNoRoutes,       /**< IP-packets dropped because no end-point was found to send them. */
+    eMIBInCsumErrors,        /**< Packets dropped because of any IP, ICMP, UDP or TCP checksum error. */
+    eMIBIcmpInMsgs,          /**< ICMP and ICMPv6 messages received. */
+    eMIBIcmpInErrors,        /**< ICMP and ICMPv6 messages dropped because of an error. */
+    eMIBIcmpOutMsgs,         /**< ICMP and ICMPv6 messages sent. */
+    eMIBUdpInDatagrams,      /**< UDP datagrams delivered to a socket. */
+    eMIBUdpNoPorts,          /**< UDP datagrams for which no socket was bound to the port. */
+    eMIBUdpInErrors,         /**< UDP datagrams dropped for other reasons, e.g. a full socket queue. */
+    eMIBUdpOutDatagrams,     /**< UDP datagrams sent. */
+    eMIBTcpActiveOpens,      /**< TCP connections that were started with FreeRTOS_connect(). */
+    eMIBTcpPassiveOpens,     /**< TCP connections that were created by a listening socket. */
+    eMIBTcpInSegs,           /**< TCP segments received, including the ones with errors. */
+    eMIBTcpOutSegs,          /**< TCP segments sent, including retransmissions. */
+    eMIBTcpRetransSegs,      /**< TCP segments retransmitted. */
+    eMIBTcpInErrs,           /**< TCP segments dropped because of an error. */
+    eMIBTcpOutRsts,          /**< TCP segments sent with the RST flag set. */
+    eMIBArpInRequests,       /**< ARP requests received. */
+    eMIBArpInReplies,        /**< ARP replies received. */
+    eMIBArpOutRequests,      /**< ARP requests sent. */
+    eMIBArpOutReplies,       /**< ARP replies sent. */
+    eMIBNdInSolicitations,   /**< Neighbour solicitations received. */
+    eMIBNdInAdvertisements,  /**< Neighbour advertisements received. */
+    eMIBNdOutSolicitations,  /**< Neighbour solicitations sent. */
+    eMIBNdOutAdvertisements, /**< Neighbour advertisements sent. */
+    eMIBCounterCount         /**< The number of counters, must be the last entry. */
+} eMIBCounter_t;
+
+/** @brief A set of MIB counters, indexed by eMIBCounter_t. The counters wrap around
+ * like the Counter32 type of SNMP. */
+typedef struct xMIB_COUNTERS
+{
+    uint32_t ulCounters[ eMIBCounterCount ]; /**< The counters, indexed by eMIBCounter_t. */
+} MIBCounters_t;
+
+#if ( ipconfigUSE_MIB_COUNTERS == 1 )
+
+/*
+ * Increment a counter of the end-point, or if it is NULL, of the interface,
+ * or if that is also NULL, of the stack-wide set. Only to be called from
+ * the IP-task.
+ */
+    void vMIBCount( struct xNetworkInterface * pxInterface,
+                    struct xNetworkEndPoint * pxEndPoint,
+                    eMIBCounter_t eCounter );
+
+/*
+ * A checksum error was found in a packet of the given protocol: increment
+ * both the checksum counter and the error counter of that protocol.
+ */
+    void vMIBCountChecksumError( const struct xNETWORK_BUFFER * pxNetworkBuffer,
+                                 uint8_t ucProtocol );
+
+/*
+ * A frame is about to be handed to a network interface: increment the output
+ * counters for the protocols that it carries. Only to be called from the IP-task.
+ */
+    void vMIBCountOutput( const struct xNETWORK_BUFFER * pxNetworkBuffer );
+
+/*
+ * Increment a stack-wide counter from any task, e.g. when a network buffer
+ * could not be obtained. Must not be called from an interrupt.
+ */
+    void vMIBCountFromTask( eMIBCounter_t eCounter );
+
+/*
+ * Get a snapshot of the counters of an end-point; or of an interface and all
+ * its end-points; or, when both parameters are NULL, of the whole stack.
+ */
+    BaseType_t FreeRTOS_GetMIBCounters( const struct xNetworkInterface * pxInterface,
+                                        const struct xNetworkEndPoint * pxEndPoint,
+                                        MIBCounters_t * pxCounters );
+
+    #define ipMIB_COUNT( pxInterface, pxEndPoint, eCounter )             vMIBCount( ( pxInterface ), ( pxEndPoint ), ( eCounter ) )
+    #define ipMIB_COUNT_CHECKSUM_ERROR( pxNetworkBuffer, ucProtocol )    vMIBCountChecksumError( ( pxNetworkBuffer ), ( ucProtocol ) )
+    #define ipMIB_COUNT_OUTPUT( pxNetworkBuffer )                        vMIBCountOutput( pxNetworkBuffer )
+    #define ipMIB_COUNT_FROM_TASK( eCounter )                            vMIBCountFromTask( eCounter )
+#else
+    #define ipMIB_COUNT( pxInterface, pxEndPoint, eCounter )
+    #define ipMIB_COUNT_CHECKSUM_ERROR( pxNetworkBuffer, ucProtocol )
+    #define ipMIB_COUNT_OUTPUT( pxNetworkBuffer )
+    #define ipMIB_COUNT_FROM_TASK( eCounter )
+#endif /* ( ipconfigUSE_MIB_COUNTERS == 1 ) */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    } /* extern "C" */
+#endif
+/* *INDENT-ON* */
+
+#endif /* FREERTOS_MIB_H */
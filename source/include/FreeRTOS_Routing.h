@@ -29,6 +29,7 @@
     #include "FreeRTOS.h"
     #include "FreeRTOS_IP.h"
     #include "FreeRTOS_Sockets.h"
+    #include "FreeRTOS_MIB.h"
 
     #if ( ipconfigUSE_DHCP != 0 )
         #include "FreeRTOS_DHCP.h"
@@ -110,6 +111,10 @@
                 bCallDownEvent : 1;           /**< The down-event must be called. */
         } bits;                               /**< A collection of boolean flags. */
 
+        #if ( ipconfigUSE_MIB_COUNTERS == 1 )
+            MIBCounters_t xMIB;               /**< Counters of events that could not be attributed to an end-point. */
+        #endif
+
         struct xNetworkEndPoint * pxEndPoint; /**< A list of end-points bound to this interface. */
         struct xNetworkInterface * pxNext;    /**< The next interface in a linked list. */
     } NetworkInterface_t;
@@ -221,6 +226,9 @@
         #if ( ipconfigUSE_RA != 0 )
             RAData_t xRAData;                    /**< A description of the Router Advertisement ( RA ) client state machine. */
         #endif /* ( ipconfigUSE_RA != 0 ) */
+        #if ( ipconfigUSE_MIB_COUNTERS == 1 )
+            MIBCounters_t xMIB;                  /**< The MIB counters of this end-point. */
+        #endif
         NetworkInterface_t * pxNetworkInterface; /**< The network interface that owns this end-point. */
         struct xNetworkEndPoint * pxNext;        /**< The next end-point in the chain. */
     } NetworkEndPoint_t;
@@ -150,6 +150,26 @@
     #if ( ipconfigUSE_TCP == 1 )
         #define FREERTOS_SO_SET_LOW_HIGH_WATER            ( 18 )
     #endif
+
+    #if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_PACING == 1 ) )
+        #define FREERTOS_SO_PACING_RATE    ( 19 ) /* Set the TCP pacing rate in bytes per second, parameter is a pointer to uint32_t. Zero means: automatic. */
+    #endif
+
+    #if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_RX_BUFFER_LENDING == 1 ) )
+        #define FREERTOS_SO_RX_BUFFER_LENDING    ( 20 ) /* Lend received TCP segments to the application, parameter is a pointer to BaseType_t: pdTRUE or pdFALSE. */
+    #endif
+
+    #if ( ipconfigUDP_GSO == 1 )
+        #define FREERTOS_SO_UDP_SEGMENT    ( 21 ) /* Split large UDP writes into datagrams, parameter is a pointer to size_t: the segment size, zero turns it off. */
+    #endif
+
+    #if ( ipconfigSUPPORT_IP_MULTICAST == 1 )
+        #define FREERTOS_SO_IP_ADD_MEMBERSHIP       ( 22 ) /* Join an IPv4 multicast group, parameter is a pointer to struct freertos_ip_mreq. */
+        #define FREERTOS_SO_IP_DROP_MEMBERSHIP      ( 23 ) /* Leave an IPv4 multicast group, parameter is a pointer to struct freertos_ip_mreq. */
+        #define FREERTOS_SO_IPV6_ADD_MEMBERSHIP     ( 24 ) /* Join an IPv6 multicast group, parameter is a pointer to struct freertos_ipv6_mreq. */
+        #define FREERTOS_SO_IPV6_DROP_MEMBERSHIP    ( 25 ) /* Leave an IPv6 multicast group, parameter is a pointer to struct freertos_ipv6_mreq. */
+    #endif
+
     #define FREERTOS_INADDR_ANY                           ( 0U )           /* The 0.0.0.0 IPv4 address. */
     #define FREERTOS_INADDR_BROADCAST                     ( 0xffffffffUL ) /* 255.255.255.255 is a special broadcast address that represents all host attached to the physical network. */
 
@@ -190,6 +210,37 @@
 /** Introduce a short name to make casting easier. */
     typedef struct freertos_sockaddr   xFreertosSocAddr;
 
+/**
+ * One buffer of an I/O vector, like the Berkeley 'struct iovec'.
+ * FreeRTOS_sendto() also uses it internally, so it is always defined.
+ */
+    struct freertos_iovec
+    {
+        void * iov_base; /**< The start of the buffer. */
+        size_t iov_len;  /**< The number of bytes in the buffer. */
+    };
+
+    #if ( ipconfigSUPPORT_IP_MULTICAST == 1 )
+
+/**
+ * The parameter of FREERTOS_SO_IP_ADD_MEMBERSHIP and FREERTOS_SO_IP_DROP_MEMBERSHIP.
+ */
+        struct freertos_ip_mreq
+        {
+            uint32_t imr_multiaddr; /**< The IPv4 multicast group, in network byte order. */
+            uint32_t imr_interface; /**< The address of a local end-point, or FREERTOS_INADDR_ANY. */
+        };
+
+/**
+ * The parameter of FREERTOS_SO_IPV6_ADD_MEMBERSHIP and FREERTOS_SO_IPV6_DROP_MEMBERSHIP.
+ */
+        struct freertos_ipv6_mreq
+        {
+            IPv6_Address_t ipv6mr_multiaddr;              /**< The IPv6 multicast group. */
+            struct xNetworkInterface * ipv6mr_interface; /**< The interface, or NULL for the first interface with an IPv6 end-point. */
+        };
+    #endif /* ( ipconfigSUPPORT_IP_MULTICAST == 1 ) */
+
 /* The socket type itself. */
     struct xSOCKET;
     typedef struct xSOCKET             * Socket_t;
@@ -267,6 +318,51 @@
                                struct freertos_sockaddr * pxSourceAddress,
                                socklen_t * pxSourceAddressLength );
 
+    #if ( ipconfigUDP_BATCH_CALLS == 1 )
+
+/* A single datagram, as used by FreeRTOS_sendto_batch() and FreeRTOS_recvfrom_batch(). */
+        typedef struct xUDP_DATAGRAM
+        {
+            void * pvBuffer;                   /**< The payload. With FREERTOS_ZERO_COPY: a payload obtained from FreeRTOS_GetUDPPayloadBuffer_Multi() when sending, or the received payload. */
+            size_t uxBufferLength;             /**< Sending: the number of bytes to send. Receiving: the size of 'pvBuffer'. */
+            size_t uxDataLength;               /**< The number of bytes actually sent or received. */
+            struct freertos_sockaddr xAddress; /**< Sending: the destination address. Receiving: the source address. */
+        } UDPDatagram_t;
+
+/* Send several datagrams from a UDP socket with a single message to the IP-task.
+ * Queued buffers belong to the IP-task, also with FREERTOS_ZERO_COPY. When
+ * -pdFREERTOS_ERRNO_EAGAIN is returned, they have been released already. */
+        BaseType_t FreeRTOS_sendto_batch( Socket_t xSocket,
+                                          UDPDatagram_t * pxDatagrams,
+                                          BaseType_t xCount,
+                                          BaseType_t xFlags );
+
+/* Receive several waiting datagrams from a UDP socket in a single call. */
+        BaseType_t FreeRTOS_recvfrom_batch( Socket_t xSocket,
+                                            UDPDatagram_t * pxDatagrams,
+                                            BaseType_t xCount,
+                                            BaseType_t xFlags );
+    #endif /* ( ipconfigUDP_BATCH_CALLS == 1 ) */
+
+    #if ( ipconfigSOCKET_IOVEC_CALLS == 1 )
+
+/* Gather several buffers into a single UDP datagram. */
+        int32_t FreeRTOS_sendmsg( Socket_t xSocket,
+                                  const struct freertos_iovec * pxIOVector,
+                                  size_t uxIOCount,
+                                  BaseType_t xFlags,
+                                  const struct freertos_sockaddr * pxDestinationAddress,
+                                  socklen_t xDestinationAddressLength );
+    #endif /* ( ipconfigSOCKET_IOVEC_CALLS == 1 ) */
+
+    #if ( ( ipconfigUSE_TCP == 0 ) && ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) )
+
+/* Fix the peer of a UDP socket, see ipconfigUDP_CONNECTED_SOCKETS. */
+        BaseType_t FreeRTOS_connect( Socket_t xClientSocket,
+                                     const struct freertos_sockaddr * pxAddress,
+                                     socklen_t xAddressLength );
+    #endif /* ( ( ipconfigUSE_TCP == 0 ) && ( ipconfigUDP_CONNECTED_SOCKETS == 1 ) ) */
+
 
 /* Function to get the local address and IP port. */
     size_t FreeRTOS_GetLocalAddress( ConstSocket_t xSocket,
@@ -307,6 +403,62 @@
             size_t uxEnoughSpace; /**< Send a GO when buffer space grows above X bytes */
         } LowHighWater_t;
 
+        #if ( ipconfigTCP_INFO == 1 )
+
+/**
+ * Statistics of a TCP connection, as returned by FreeRTOS_GetTCPInfo().
+ * The counters start at zero when the socket is created, and wrap around.
+ */
+            typedef struct xTCP_INFO
+            {
+                uint8_t ucState;              /**< The connection state, an eIPTCPState_t value. */
+                uint16_t usMSS;               /**< The current Maximum Segment Size. */
+                uint32_t ulBytesSent;         /**< Data bytes passed to the network, including retransmissions. */
+                uint32_t ulBytesReceived;     /**< Data bytes received in order. */
+                uint32_t ulSegmentsSent;      /**< Segments sent, including pure ACKs. */
+                uint32_t ulSegmentsReceived;  /**< Segments received. */
+                uint32_t ulRetransmissions;   /**< Segments that were sent more than once. */
+                uint32_t ulSRTT;              /**< Unit: ms. The smoothed round-trip time. */
+                uint32_t ulRTO;               /**< Unit: ms. The retransmission time-out, before back-off. */
+                uint32_t ulPeerWindow;        /**< Unit: bytes. The reception window advertised by the peer. */
+                uint32_t ulTxWindow;          /**< Unit: bytes. The local transmission window. */
+                uint32_t ulRxWindow;          /**< Unit: bytes. The local reception window. */
+                uint32_t ulSACKsSent;         /**< SACK options sent for out-of-order data. */
+                uint32_t ulSACKsReceived;     /**< SACK blocks received from the peer. */
+                uint32_t ulZeroWindowTime;    /**< Unit: ms. Time during which the peer advertised a zero window. */
+                uint32_t ulStreamBlockedTime; /**< Unit: ms. Time that FreeRTOS_send() waited for space in the TX stream. */
+            } TCPInfo_t;
+        #endif /* ( ipconfigTCP_INFO == 1 ) */
+
+        #if ( ipconfigTCP_TX_BY_REFERENCE == 1 )
+
+            struct xTCP_TX_REFERENCE;
+
+/* Called from the IP-task when the memory of a reference is not used any more.
+ * 'xAcked' is pdTRUE when the peer has acknowledged all bytes, and pdFALSE when
+ * the socket was closed or reused before that. */
+            typedef void (* FOnTCPTxRefDone_t )( Socket_t xSocket,
+                                                 struct xTCP_TX_REFERENCE * pxReference,
+                                                 BaseType_t xAcked );
+
+/**
+ * A block of application memory that is sent by FreeRTOS_send_ref().
+ * The structure must stay valid until the completion handler has been called.
+ */
+            typedef struct xTCP_TX_REFERENCE
+            {
+                const uint8_t * pucData;             /**< The memory to be sent, it will not be copied to the txStream. */
+                size_t uxLength;                     /**< The number of bytes in 'pucData'. */
+                FOnTCPTxRefDone_t pxHandleDone;      /**< Optional completion handler. */
+                void * pvContext;                    /**< Free for use by the application. */
+
+                /* The fields below are used by the IP-stack. */
+                struct xTCP_TX_REFERENCE * pxNext;   /**< The next reference that was queued on the same socket. */
+                size_t uxPosition;                   /**< Position in txStream of the first unacknowledged byte. */
+                size_t uxAcked;                      /**< The number of bytes acknowledged by the peer. */
+            } TCPTxReference_t;
+        #endif /* ( ipconfigTCP_TX_BY_REFERENCE == 1 ) */
+
 /* Connect a TCP socket to a remote socket. */
         BaseType_t FreeRTOS_connect( Socket_t xClientSocket,
                                      const struct freertos_sockaddr * pxAddress,
@@ -322,12 +474,43 @@
                                   struct freertos_sockaddr * pxAddress,
                                   socklen_t * pxAddressLength );
 
+        #if ( ipconfigTCP_ACCEPT_QUEUE == 1 )
+
+/* Accept several connections on a TCP socket at once. */
+            BaseType_t FreeRTOS_accept_batch( Socket_t xServerSocket,
+                                              Socket_t * pxClientSockets,
+                                              BaseType_t xMaxCount );
+        #endif
+
 /* Send data to a TCP socket. */
         BaseType_t FreeRTOS_send( Socket_t xSocket,
                                   const void * pvBuffer,
                                   size_t uxDataLength,
                                   BaseType_t xFlags );
 
+        #if ( ipconfigSOCKET_IOVEC_CALLS == 1 )
+
+/* Send several buffers to a TCP socket, they are added to the stream at once. */
+            BaseType_t FreeRTOS_sendv( Socket_t xSocket,
+                                       const struct freertos_iovec * pxIOVector,
+                                       size_t uxIOCount,
+                                       BaseType_t xFlags );
+
+/* Receive data from a TCP socket into several buffers. */
+            BaseType_t FreeRTOS_recvv( Socket_t xSocket,
+                                       const struct freertos_iovec * pxIOVector,
+                                       size_t uxIOCount,
+                                       BaseType_t xFlags );
+        #endif /* ( ipconfigSOCKET_IOVEC_CALLS == 1 ) */
+
+        #if ( ipconfigTCP_TX_BY_REFERENCE == 1 )
+
+/* Send application-owned memory to a TCP socket without copying it. */
+            BaseType_t FreeRTOS_send_ref( Socket_t xSocket,
+                                          TCPTxReference_t * pxReference,
+                                          BaseType_t xFlags );
+        #endif
+
 /* Receive data from a TCP socket */
         BaseType_t FreeRTOS_recv( Socket_t xSocket,
                                   void * pvBuffer,
@@ -345,6 +528,21 @@
                                                      void const * pvBuffer,
                                                      BaseType_t xByteCount );
 
+        #if ( ipconfigTCP_RX_BUFFER_LENDING == 1 )
+
+/* Borrow the next received segment of a TCP socket that has the option
+ * FREERTOS_SO_RX_BUFFER_LENDING set. The payload starts at
+ * '( *ppxBuffer )->pucEthernetBuffer + *puxOffset'. */
+            BaseType_t FreeRTOS_recv_lent( Socket_t xSocket,
+                                           struct xNETWORK_BUFFER ** ppxBuffer,
+                                           size_t * puxOffset,
+                                           BaseType_t xFlags );
+
+/* Give back a segment that was obtained by calling FreeRTOS_recv_lent(). */
+            BaseType_t FreeRTOS_release_lent( Socket_t xSocket,
+                                              struct xNETWORK_BUFFER * pxBuffer );
+        #endif
+
 /* Returns the number of bytes available in the Rx buffer. */
         BaseType_t FreeRTOS_rx_size( ConstSocket_t xSocket );
 
@@ -374,6 +572,13 @@
 /* For internal use only: return the connection status. */
         BaseType_t FreeRTOS_connstatus( ConstSocket_t xSocket );
 
+        #if ( ipconfigTCP_INFO == 1 )
+
+/* Get the statistics of a TCP connection. */
+            BaseType_t FreeRTOS_GetTCPInfo( ConstSocket_t xSocket,
+                                            TCPInfo_t * pxInfo );
+        #endif
+
 /* For advanced applications only:
  * Get a direct pointer to the beginning of the circular transmit buffer.
  * In case the buffer was not yet created, it will be created in
@@ -561,6 +766,23 @@
         EventBits_t FreeRTOS_FD_ISSET( const ConstSocket_t xSocket,
                                        const ConstSocketSet_t xSocketSet );
 
+        #if ( ipconfigSELECT_READY_LIST == 1 )
+
+/* A socket that has events, as returned by FreeRTOS_select_ready(). */
+            typedef struct xSOCKET_READY
+            {
+                Socket_t xSocket;    /**< The socket that has events. */
+                EventBits_t xEvents; /**< A combination of the eSelectEvent_t bits. */
+            } SocketReady_t;
+
+/* Block on a "socket set" until at least one of its sockets has an event of
+ * interest, and return only the sockets that have events. */
+            BaseType_t FreeRTOS_select_ready( SocketSet_t xSocketSet,
+                                              SocketReady_t * pxReadySockets,
+                                              BaseType_t xMaxCount,
+                                              TickType_t xBlockTimeTicks );
+        #endif /* ( ipconfigSELECT_READY_LIST == 1 ) */
+
     #endif /* ( ipconfigSUPPORT_SELECT_FUNCTION == 1 ) */
 
 
@@ -110,6 +110,7 @@ typedef enum eTCP_STATE
 #define tcpTCP_OPT_WSOPT_MAXIMUM_VALUE    ( 14U )        /**< Maximum value of TCP WSOPT option. */
 
 #define tcpTCP_OPT_TIMESTAMP_LEN          10             /**< fixed length of the time-stamp option. */
+#define tcpTCP_OPT_TIMESTAMP_SPACE        12U            /**< Space needed for NOP, NOP, and the time-stamp option. */
 
 /** @brief
  * Minimum segment length as outlined by RFC 791 section 3.1.
@@ -115,6 +115,37 @@ BaseType_t prvTCPCreateWindow( FreeRTOS_Socket_t * pxSocket );
 UBaseType_t prvSetSynAckOptions( FreeRTOS_Socket_t * pxSocket,
                                  TCPHeader_t * pxTCPHeader );
 
+#if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+
+/*
+ * Write the TCP Timestamps option at a given offset in the options field.
+ * Returns the new length of the options.
+ */
+    UBaseType_t prvTCPAddTimeStampOption( const FreeRTOS_Socket_t * pxSocket,
+                                          TCPHeader_t * pxTCPHeader,
+                                          UBaseType_t uxOptionsLength );
+
+/*
+ * Returns the number of option bytes that are occupied by the time-stamp,
+ * which is zero when the option was not negotiated.
+ */
+    UBaseType_t prvTCPTimeStampLength( const FreeRTOS_Socket_t * pxSocket );
+#endif
+
+#if ( ipconfigTCP_PACING == 1 )
+
+/*
+ * Update the pacing credit of a socket, and return pdTRUE if a segment may
+ * be sent now.
+ */
+    BaseType_t prvTCPPacingMaySend( FreeRTOS_Socket_t * pxSocket );
+
+/*
+ * Returns the number of ms before the next segment may be sent.
+ */
+    uint32_t prvTCPPacingDelay( const FreeRTOS_Socket_t * pxSocket );
+#endif
+
 /*
  * Prepare an outgoing message, if anything has to be sent.
  */
@@ -63,7 +63,10 @@ typedef struct xTCP_SEGMENT
                 ucDupAckCount : 8,   /**< Counts the number of times that a higher segment was ACK'd. After 3 times a Fast Retransmission takes place */
                 bOutstanding : 1,    /**< It the peer's turn, we're just waiting for an ACK */
                 bAcked : 1,          /**< This segment has been acknowledged */
-                bIsForRx : 1;        /**< pdTRUE if segment is used for reception */
+                bIsForRx : 1,        /**< pdTRUE if segment is used for reception */
+                bIsLost : 1,         /**< The SACK scoreboard considers this segment as lost ( RFC 6675 ) */
+                bSackRexmit : 1,     /**< This lost segment has been retransmitted in the current recovery */
+                bIsProbe : 1;        /**< This segment was sent again as a tail loss probe, which is not counted in 'ucTransmitCount' */
         } bits;
         uint32_t ulFlags;
     } u;                                /**< A collection of boolean flags. */
@@ -83,7 +86,9 @@ typedef struct xTCP_WINSIZE
 /** @brief If TCP time-stamps are being used, they will occupy 12 bytes in
  * each packet, and thus the message space will become smaller.
  * Keep this as a multiple of 4 */
-#if ( ipconfigUSE_TCP_WIN == 1 )
+#if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+    #define ipSIZE_TCP_OPTIONS    28U
+#elif ( ipconfigUSE_TCP_WIN == 1 )
     #define ipSIZE_TCP_OPTIONS    16U
 #else
     #define ipSIZE_TCP_OPTIONS    12U
@@ -101,8 +106,13 @@ typedef struct xTCP_WINDOW
             uint32_t
                 bHasInit : 1,      /**< The window structure has been initialised */
                 bSendFullSize : 1, /**< May only send packets with a size equal to MSS (for optimisation) */
-                bTimeStamps : 1;   /**< Socket is supposed to use TCP time-stamps. This depends on the */
-        } bits;                    /**< party which opens the connection */
+                bTimeStamps : 1,   /**< Socket is supposed to use TCP time-stamps, as negotiated in the SYN phase */
+                bRTTSampled : 1,   /**< At least one RTT sample has been taken ( RFC 6298 ) */
+                bProbeSent : 1,    /**< A tail loss probe was sent, and no new data has been acknowledged since */
+                bInRecovery : 1,   /**< A SACK based loss recovery is in progress ( RFC 6675 ) */
+                bRxRTTActive : 1,  /**< Reception window autotuning: an RTT measurement without time-stamps is in progress */
+                bTSEchoValid : 1;  /**< 'ulTSEcho' holds the TSecr of the ACK that is being processed */
+        } bits;                    /**< The bits structure */
         uint32_t ulFlags;
     } u;                           /**< A collection of boolean flags. */
     TCPWinSize_t xSize;            /**< The TCP window sizes of the incoming and outgoing streams. */
@@ -121,6 +131,38 @@ typedef struct xTCP_WINDOW
     uint32_t ulUserDataLength;                                             /**< Number of bytes in Rx buffer which may be passed to the user, after having received a 'missing packet' */
     uint32_t ulNextTxSequenceNumber;                                       /**< The sequence number given to the next byte to be added for transmission */
     int32_t lSRTT;                                                         /**< Smoothed Round Trip Time, it may increment quickly and it decrements slower */
+    #if ( ipconfigUSE_TCP_RTO_RFC6298 == 1 )
+        int32_t lRTTVar;                                                   /**< RTT variation, as described in RFC 6298 */
+        int32_t lRTO;                                                      /**< Retransmission time-out in ms, before back-off */
+    #endif
+    #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+        uint32_t ulTSRecent;                                               /**< The most recent TSval received from the peer, echoed in TSecr */
+        uint32_t ulTSEcho;                                                 /**< The TSecr of the last packet received, only valid when 'bTSEchoValid' is set */
+    #endif
+    #if ( ipconfigTCP_SACK_RECOVERY == 1 )
+        uint32_t ulRecoveryPoint;                                          /**< The loss recovery ends when this sequence number is acknowledged */
+    #endif
+    #if ( ipconfigTCP_RX_AUTOTUNE == 1 )
+        uint32_t ulRxWindowMaximum;                                        /**< The limit up to which 'xSize.ulRxWindowLength' may grow */
+        uint32_t ulRxAutoTuneBytes;                                        /**< Bytes received in order during the current measurement */
+        TickType_t uxRxAutoTuneTime;                                       /**< Tick count at which the current measurement started */
+        int32_t lRxSRTT;                                                   /**< The RTT in ms as seen by the receiver, zero when not yet measured */
+        uint32_t ulRxRTTSequence;                                          /**< Without time-stamps: RTT sample is taken when RCV.NXT reaches this number */
+        TickType_t uxRxRTTTime;                                            /**< Without time-stamps: tick count at which the RTT measurement started */
+        #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+            uint32_t ulRxRTTEcho;                                          /**< With time-stamps: the TSecr from which the last RTT sample was taken */
+        #endif
+    #endif
+    #if ( ipconfigTCP_INFO == 1 )
+        uint32_t ulBytesSent;                                              /**< Statistics: data bytes passed to the network, including retransmissions */
+    #endif
+    #if ( ipconfigTCP_INFO == 1 ) || ( ipconfigUSE_MIB_COUNTERS == 1 )
+        uint32_t ulRetransmissions;                                        /**< Statistics: the number of segments that were sent more than once */
+    #endif
+    #if ( ipconfigTCP_INFO == 1 )
+        uint32_t ulSACKsSent;                                              /**< Statistics: the number of SACK options prepared for the peer */
+        uint32_t ulSACKsReceived;                                          /**< Statistics: the number of SACK blocks received from the peer */
+    #endif
     uint8_t ucOptionLength;                                                /**< Number of valid bytes in ulOptionsData[] */
     #if ( ipconfigUSE_TCP_WIN == 1 )
         List_t xPriorityQueue;                                             /**< Priority queue: segments which must be sent immediately */
@@ -186,6 +228,13 @@ int32_t lTCPWindowRxCheck( TCPWindow_t * pxWindow,
  * if there are no 'open' reception segments */
 BaseType_t xTCPWindowRxEmpty( const TCPWindow_t * pxWindow );
 
+#if ( ipconfigTCP_RX_AUTOTUNE == 1 )
+    /* Account for data that was received in order, and grow the reception window
+     * when it appears to be the bottleneck. Returns pdTRUE when the window has grown. */
+    BaseType_t xTCPWindowRxAutoTune( TCPWindow_t * pxWindow,
+                                     uint32_t ulLength );
+#endif
+
 /*=============================================================================
  *
  * Tx functions
@@ -214,6 +263,11 @@ uint32_t ulTCPWindowTxGet( TCPWindow_t * pxWindow,
                            uint32_t ulWindowSize,
                            int32_t * plPosition );
 
+#if ( ipconfigTCP_PACING == 1 )
+    /* Returns pdTRUE when the next segment to be fetched is a retransmission. */
+    BaseType_t xTCPWindowTxHasRetransmission( const TCPWindow_t * pxWindow );
+#endif
+
 /* Receive a normal ACK */
 uint32_t ulTCPWindowTxAck( TCPWindow_t * pxWindow,
                            uint32_t ulSequenceNumber );
@@ -223,6 +277,11 @@ uint32_t ulTCPWindowTxSack( TCPWindow_t * pxWindow,
                             uint32_t ulFirst,
                             uint32_t ulLast );
 
+#if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+    /* Returns the value of the clock used for TCP time-stamps, in ms. */
+    uint32_t ulTCPWindowGetTimeStamp( void );
+#endif
+
 /**
  * @brief Check if a > b, where a and b are rolling counters.
  *
@@ -142,6 +142,19 @@
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * iptraceNETWORK_EVENT_PROCESSED
+ *
+ * Called when the IP task has finished processing an event, that was
+ * reported by iptraceNETWORK_EVENT_RECEIVED(). It is also called when the
+ * IP task woke up without an event ( eNoEvent ), to check the timers.
+ */
+#ifndef iptraceNETWORK_EVENT_PROCESSED
+    #define iptraceNETWORK_EVENT_PROCESSED( eEvent )
+#endif
+
+/*---------------------------------------------------------------------------*/
+
 /*
  * iptraceNETWORK_INTERFACE_INPUT
  *
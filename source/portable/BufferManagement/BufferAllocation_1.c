@@ -316,6 +316,8 @@ NetworkBufferDescriptor_t * pxGetNetworkBufferWithDescriptor( size_t xRequestedS
             FreeRTOS_printf( ( "pxGetNetworkBufferWithDescriptor: module not initialised or `xRequestedSizeBytes` too small" ) );
             /* lint wants to see at least a comment. */
             iptraceFAILED_TO_OBTAIN_NETWORK_BUFFER();
+            ipDROP_FRAME( NULL, eIPDropNoBuffer );
+            ipMIB_COUNT_FROM_TASK( eMIBIpInDiscards );
         }
     }
 
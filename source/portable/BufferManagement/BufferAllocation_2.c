@@ -380,6 +380,8 @@ NetworkBufferDescriptor_t * pxGetNetworkBufferWithDescriptor( size_t xRequestedS
     if( pxReturn == NULL )
     {
         iptraceFAILED_TO_OBTAIN_NETWORK_BUFFER();
+        ipDROP_FRAME( NULL, eIPDropNoBuffer );
+        ipMIB_COUNT_FROM_TASK( eMIBIpInDiscards );
     }
     else
     {
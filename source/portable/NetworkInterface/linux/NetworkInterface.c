@@ -242,6 +242,11 @@ static BaseType_t xNetworkInterfaceOutput( NetworkInterface_t * pxInterface,
         ( xSpace >= ( pxNetworkBuffer->xDataLength +
                       sizeof( pxNetworkBuffer->xDataLength ) ) ) )
     {
+        /* The packets sent will be written to a capture file, only if
+         * 'ipconfigUSE_DUMP_PACKETS' or 'ipconfigUSE_PCAPNG_CAPTURE' is
+         * defined. Otherwise, there is no action. */
+        iptraceDUMP_PACKET( pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength, pdFALSE );
+
         /* First write in the length of the data, then write in the data
          * itself. */
         uxStreamBufferAdd( xSendBuffer,
@@ -966,6 +971,12 @@ static void prvInterruptSimulatorTask( void * pvParameters )
                      * interrupt. */
                     if( xPacketBouncedBack( pucPacketData ) == pdFALSE )
                     {
+                        /* The received packets will be written to a capture
+                         * file, only if 'ipconfigUSE_DUMP_PACKETS' or
+                         * 'ipconfigUSE_PCAPNG_CAPTURE' is defined. Otherwise,
+                         * there is no action. */
+                        iptraceDUMP_PACKET( pucPacketData, ( size_t ) pxHeader->len, pdTRUE );
+
                         pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( pxHeader->len, 0 );
                     }
                     else
@@ -0,0 +1,825 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/*
+ * ReplayNetworkInterface.c
+ * A network interface that replays a recorded pcap or pcapng file into the
+ * IP-task, as fast as the IP-task can process the frames. The frames that the
+ * stack sends in return are counted and dropped. It runs on the Windows and
+ * Linux simulators, as it reads the capture with the C library.
+ * See source/portable/NetworkInterface/replay/README.md for a description.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_Routing.h"
+#include "NetworkBufferManagement.h"
+#include "NetworkInterface.h"
+
+#include "ReplayNetworkInterface.h"
+
+/* The clock used to time the replay, in microseconds. By default the
+ * application-supplied function ullGetHighResolutionTime(). */
+#ifndef replayTIME_US
+    extern uint64_t ullGetHighResolutionTime( void );
+    #define replayTIME_US()    ullGetHighResolutionTime()
+#endif
+
+/* The longest time to wait for a network buffer, or for space in the queue of
+ * the IP-task. Waiting longer means that the stack is stuck. */
+#ifndef replayWAIT_MS
+    #define replayWAIT_MS    1000U
+#endif
+
+/* The largest frame that can be replayed. */
+#define replayMAX_FRAME_SIZE           ( ipconfigNETWORK_MTU + ipSIZE_OF_ETH_HEADER )
+
+/* The link type of Ethernet, in both pcap and pcapng. */
+#define replayLINKTYPE_ETHERNET        1U
+
+/* The magic numbers of the file formats. */
+#define replayPCAP_MAGIC_US            0xA1B2C3D4U
+#define replayPCAP_MAGIC_NS            0xA1B23C4DU
+#define replayPCAPNG_SHB               0x0A0D0D0AU
+#define replayPCAPNG_BYTE_ORDER        0x1A2B3C4DU
+
+/* The pcapng blocks that are understood, the others are skipped. */
+#define replayPCAPNG_IDB               0x00000001U
+#define replayPCAPNG_SPB               0x00000003U
+#define replayPCAPNG_EPB               0x00000006U
+
+/* The number of pcapng interfaces whose link type is remembered. */
+#define replayMAX_PCAPNG_INTERFACES    8U
+
+/* The position of a frame within the loaded file. */
+typedef struct xREPLAY_FRAME
+{
+    uint32_t ulOffset;
+    uint16_t usLength;
+} ReplayFrame_t;
+
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvReplay_Initialise( NetworkInterface_t * pxInterface );
+static BaseType_t prvReplay_Output( NetworkInterface_t * pxInterface,
+                                    NetworkBufferDescriptor_t * const pxDescriptor,
+                                    BaseType_t bReleaseAfterSend );
+static BaseType_t prvReplay_GetPhyLinkStatus( NetworkInterface_t * pxInterface );
+
+/*-----------------------------------------------------------*/
+
+/* The interface added by pxReplay_FillInterfaceDescriptor(). */
+static NetworkInterface_t * pxReplayInterface = NULL;
+
+/* The capture file, and the frames found in it. */
+static uint8_t * pucFileData = NULL;
+static size_t uxFileSize = 0U;
+static ReplayFrame_t * pxFrames = NULL;
+static uint32_t ulFrameCount = 0U;
+static uint32_t ulFrameSpace = 0U;
+static uint32_t ulFramesSkipped = 0U;
+
+/* Set while xReplayRun() is running, the trace functions do nothing otherwise. */
+static volatile BaseType_t xReplayActive = pdFALSE;
+
+/* Updated by the IP-task, read by xReplayRun(). */
+static volatile uint32_t ulFramesProcessed = 0U;
+static volatile uint32_t ulFramesSent = 0U;
+static volatile uint64_t ullLastProcessed = 0U;
+static uint64_t ullInputTime = 0U;
+static eReplayProtocol_t eInputProtocol = eReplayOther;
+static ReplayProtocolStats_t xProtocolStats[ eReplayProtocolCount ];
+
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvReplay_Initialise( NetworkInterface_t * pxInterface )
+{
+    ( void ) pxInterface;
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigIPv4_BACKWARD_COMPATIBLE != 0 )
+
+/* Do not call the following function directly. It is there for downward compatibility.
+ * The function FreeRTOS_IPInit() will call it to initialice the interface and end-point
+ * objects.  See the description in FreeRTOS_Routing.h. */
+    NetworkInterface_t * pxFillInterfaceDescriptor( BaseType_t xEMACIndex,
+                                                    NetworkInterface_t * pxInterface )
+    {
+        return pxReplay_FillInterfaceDescriptor( xEMACIndex, pxInterface );
+    }
+
+#endif /* ( ipconfigIPv4_BACKWARD_COMPATIBLE != 0 ) */
+/*-----------------------------------------------------------*/
+
+NetworkInterface_t * pxReplay_FillInterfaceDescriptor( BaseType_t xEMACIndex,
+                                                       NetworkInterface_t * pxInterface )
+{
+/* This function pxReplay_FillInterfaceDescriptor() adds a network-interface.
+ * Make sure that the object pointed to by 'pxInterface'
+ * is declared static or global, and that it will remain to exist. */
+
+    memset( pxInterface, '\0', sizeof( *pxInterface ) );
+    pxInterface->pcName = "Replay";                  /* Just for logging, debugging. */
+    pxInterface->pvArgument = ( void * ) xEMACIndex; /* Has only meaning for the driver functions. */
+    pxInterface->pfInitialise = prvReplay_Initialise;
+    pxInterface->pfOutput = prvReplay_Output;
+    pxInterface->pfGetPhyLinkStatus = prvReplay_GetPhyLinkStatus;
+
+    FreeRTOS_AddNetworkInterface( pxInterface );
+    pxReplayInterface = pxInterface;
+
+    return pxInterface;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvReplay_GetPhyLinkStatus( NetworkInterface_t * pxInterface )
+{
+    ( void ) pxInterface;
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvReplay_Output( NetworkInterface_t * pxInterface,
+                                    NetworkBufferDescriptor_t * const pxDescriptor,
+                                    BaseType_t bReleaseAfterSend )
+{
+    ( void ) pxInterface;
+
+    /* There is no wire: the replies of the stack are counted and dropped. */
+    ulFramesSent++;
+
+    if( bReleaseAfterSend != pdFALSE )
+    {
+        vReleaseNetworkBufferAndDescriptor( pxDescriptor );
+    }
+
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+/* Find the class of a frame, looking only at the Ethernet and IP headers. */
+static eReplayProtocol_t prvClassify( const uint8_t * pucFrame,
+                                      size_t uxLength )
+{
+    eReplayProtocol_t eProtocol = eReplayOther;
+    uint16_t usFrameType;
+    uint8_t ucProtocol = 0U;
+
+    if( uxLength >= ipSIZE_OF_ETH_HEADER )
+    {
+        usFrameType = ( uint16_t ) ( ( ( uint16_t ) pucFrame[ 12 ] << 8 ) | pucFrame[ 13 ] );
+
+        if( usFrameType == 0x0806U )
+        {
+            eProtocol = eReplayARP;
+        }
+        else if( ( usFrameType == 0x0800U ) && ( uxLength >= ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER ) ) )
+        {
+            ucProtocol = pucFrame[ ipSIZE_OF_ETH_HEADER + 9U ];
+        }
+        else if( ( usFrameType == 0x86DDU ) && ( uxLength >= ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER ) ) )
+        {
+            /* Only the first next-header: extension headers are counted as 'other'. */
+            ucProtocol = pucFrame[ ipSIZE_OF_ETH_HEADER + 6U ];
+        }
+        else
+        {
+            /* Another frame type, or too short. */
+        }
+    }
+
+    switch( ucProtocol )
+    {
+        case ipPROTOCOL_ICMP:
+        case ipPROTOCOL_ICMP_IPv6:
+            eProtocol = eReplayICMP;
+            break;
+
+        case ipPROTOCOL_UDP:
+            eProtocol = eReplayUDP;
+            break;
+
+        case ipPROTOCOL_TCP:
+            eProtocol = eReplayTCP;
+            break;
+
+        default:
+            /* Not IP, or another protocol. */
+            break;
+    }
+
+    return eProtocol;
+}
+/*-----------------------------------------------------------*/
+
+void vReplayTraceInput( const uint8_t * pucEthernetBuffer,
+                        size_t uxLength )
+{
+    if( xReplayActive != pdFALSE )
+    {
+        eInputProtocol = prvClassify( pucEthernetBuffer, uxLength );
+        ullInputTime = replayTIME_US();
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vReplayTraceEventProcessed( BaseType_t xEvent )
+{
+    uint64_t ullNow;
+    uint64_t ullTime;
+    ReplayProtocolStats_t * pxStats;
+
+    if( ( xReplayActive != pdFALSE ) && ( xEvent == ( BaseType_t ) eNetworkRxEvent ) )
+    {
+        ullNow = replayTIME_US();
+
+        /* A frame that was dropped before it reached prvProcessEthernetPacket()
+         * is counted, but not timed. */
+        if( ( ullInputTime != 0U ) && ( ullNow >= ullInputTime ) )
+        {
+            ullTime = ullNow - ullInputTime;
+            pxStats = &( xProtocolStats[ eInputProtocol ] );
+            pxStats->ulFrames++;
+            pxStats->ullTotalUs += ullTime;
+
+            if( ullTime > pxStats->ulMaxUs )
+            {
+                pxStats->ulMaxUs = ( uint32_t ) ullTime;
+            }
+        }
+
+        ullInputTime = 0U;
+        ullLastProcessed = ullNow;
+        ulFramesProcessed++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+/* Read a 32-bit value from the capture, in the byte order of the file. */
+static uint32_t prvRead32( const uint8_t * pucData,
+                           BaseType_t xSwapped )
+{
+    uint32_t ulValue;
+
+    ( void ) memcpy( &( ulValue ), pucData, sizeof( ulValue ) );
+
+    if( xSwapped != pdFALSE )
+    {
+        ulValue = ( ( ulValue & 0x000000FFU ) << 24 ) |
+                  ( ( ulValue & 0x0000FF00U ) << 8 ) |
+                  ( ( ulValue & 0x00FF0000U ) >> 8 ) |
+                  ( ( ulValue & 0xFF000000U ) >> 24 );
+    }
+
+    return ulValue;
+}
+/*-----------------------------------------------------------*/
+
+/* Add a frame to the index, or count it as skipped. */
+static BaseType_t prvAddFrame( uint32_t ulOffset,
+                               uint32_t ulCaptured,
+                               uint32_t ulOriginal,
+                               uint32_t ulLinkType )
+{
+    BaseType_t xReturn = pdPASS;
+    ReplayFrame_t * pxNewFrames;
+
+    if( ( ulLinkType != replayLINKTYPE_ETHERNET ) ||
+        ( ulCaptured != ulOriginal ) ||
+        ( ulCaptured < ipSIZE_OF_ETH_HEADER ) ||
+        ( ulCaptured > replayMAX_FRAME_SIZE ) )
+    {
+        ulFramesSkipped++;
+    }
+    else
+    {
+        if( ulFrameCount == ulFrameSpace )
+        {
+            ulFrameSpace = ( ulFrameSpace == 0U ) ? 1024U : ( ulFrameSpace * 2U );
+            pxNewFrames = ( ReplayFrame_t * ) realloc( pxFrames, ulFrameSpace * sizeof( *pxFrames ) );
+
+            if( pxNewFrames == NULL )
+            {
+                xReturn = pdFAIL;
+            }
+            else
+            {
+                pxFrames = pxNewFrames;
+            }
+        }
+
+        if( xReturn == pdPASS )
+        {
+            pxFrames[ ulFrameCount ].ulOffset = ulOffset;
+            pxFrames[ ulFrameCount ].usLength = ( uint16_t ) ulCaptured;
+            ulFrameCount++;
+        }
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+/* Index a classic pcap file: a 24-byte header, then records with a 16-byte header. */
+static BaseType_t prvIndexPcap( BaseType_t xSwapped )
+{
+    BaseType_t xReturn = pdPASS;
+    uint32_t ulLinkType = prvRead32( &( pucFileData[ 20 ] ), xSwapped );
+    size_t uxOffset = 24U;
+    uint32_t ulCaptured;
+
+    while( ( xReturn == pdPASS ) && ( ( uxOffset + 16U ) <= uxFileSize ) )
+    {
+        ulCaptured = prvRead32( &( pucFileData[ uxOffset + 8U ] ), xSwapped );
+
+        if( ulCaptured > ( uxFileSize - uxOffset - 16U ) )
+        {
+            /* The last record is cut short. */
+            ulFramesSkipped++;
+            break;
+        }
+
+        xReturn = prvAddFrame( ( uint32_t ) ( uxOffset + 16U ), ulCaptured,
+                               prvRead32( &( pucFileData[ uxOffset + 12U ] ), xSwapped ), ulLinkType );
+        uxOffset += 16U + ulCaptured;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+/* Index a pcapng file: use the Enhanced and Simple Packet Blocks, and the
+ * link types of the Interface Description Blocks. */
+static BaseType_t prvIndexPcapNG( void )
+{
+    BaseType_t xReturn = pdPASS;
+    BaseType_t xSwapped = pdFALSE;
+    uint32_t ulLinkTypes[ replayMAX_PCAPNG_INTERFACES ];
+    uint32_t ulInterfaces = 0U;
+    uint32_t ulBlockType;
+    uint32_t ulBlockLength;
+    uint32_t ulInterface;
+    uint32_t ulLinkType;
+    uint16_t usLinkType;
+    uint32_t ulCaptured;
+    size_t uxOffset = 0U;
+
+    while( ( xReturn == pdPASS ) && ( ( uxOffset + 12U ) <= uxFileSize ) )
+    {
+        ulBlockType = prvRead32( &( pucFileData[ uxOffset ] ), pdFALSE );
+
+        if( ulBlockType == replayPCAPNG_SHB )
+        {
+            /* A new section, which may have another byte order and its own interfaces. */
+            xSwapped = ( prvRead32( &( pucFileData[ uxOffset + 8U ] ), pdFALSE ) != replayPCAPNG_BYTE_ORDER ) ? pdTRUE : pdFALSE;
+            ulInterfaces = 0U;
+        }
+        else
+        {
+            ulBlockType = prvRead32( &( pucFileData[ uxOffset ] ), xSwapped );
+        }
+
+        ulBlockLength = prvRead32( &( pucFileData[ uxOffset + 4U ] ), xSwapped );
+
+        if( ( ulBlockLength < 12U ) || ( ( ulBlockLength % 4U ) != 0U ) || ( ulBlockLength > ( uxFileSize - uxOffset ) ) )
+        {
+            /* A damaged or truncated block, nothing after it can be trusted. */
+            ulFramesSkipped++;
+            break;
+        }
+
+        if( ( ulBlockType == replayPCAPNG_IDB ) && ( ulBlockLength >= 20U ) )
+        {
+            if( ulInterfaces < replayMAX_PCAPNG_INTERFACES )
+            {
+                /* The link type is a 16-bit field, followed by 16 reserved bits. */
+                ( void ) memcpy( &( usLinkType ), &( pucFileData[ uxOffset + 8U ] ), sizeof( usLinkType ) );
+
+                if( xSwapped != pdFALSE )
+                {
+                    usLinkType = ( uint16_t ) ( ( usLinkType << 8 ) | ( usLinkType >> 8 ) );
+                }
+
+                ulLinkTypes[ ulInterfaces ] = usLinkType;
+            }
+
+            ulInterfaces++;
+        }
+        else if( ( ulBlockType == replayPCAPNG_EPB ) && ( ulBlockLength >= 32U ) )
+        {
+            ulInterface = prvRead32( &( pucFileData[ uxOffset + 8U ] ), xSwapped );
+            ulCaptured = prvRead32( &( pucFileData[ uxOffset + 20U ] ), xSwapped );
+            ulLinkType = ( ulInterface < ulInterfaces ) && ( ulInterface < replayMAX_PCAPNG_INTERFACES ) ? ulLinkTypes[ ulInterface ] : 0U;
+
+            if( ulCaptured > ( ulBlockLength - 32U ) )
+            {
+                ulFramesSkipped++;
+            }
+            else
+            {
+                xReturn = prvAddFrame( ( uint32_t ) ( uxOffset + 28U ), ulCaptured,
+                                       prvRead32( &( pucFileData[ uxOffset + 24U ] ), xSwapped ), ulLinkType );
+            }
+        }
+        else if( ( ulBlockType == replayPCAPNG_SPB ) && ( ulBlockLength >= 16U ) )
+        {
+            /* A Simple Packet Block only has the original length, and belongs to the first interface. */
+            ulCaptured = prvRead32( &( pucFileData[ uxOffset + 8U ] ), xSwapped );
+            ulLinkType = ( ulInterfaces > 0U ) ? ulLinkTypes[ 0 ] : 0U;
+
+            if( ulCaptured > ( ulBlockLength - 16U ) )
+            {
+                ulFramesSkipped++;
+            }
+            else
+            {
+                xReturn = prvAddFrame( ( uint32_t ) ( uxOffset + 12U ), ulCaptured, ulCaptured, ulLinkType );
+            }
+        }
+        else
+        {
+            /* Another block type, e.g. statistics or name resolution. */
+        }
+
+        uxOffset += ulBlockLength;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+/* Free the loaded file and its index. */
+static void prvUnload( void )
+{
+    free( pucFileData );
+    free( pxFrames );
+    pucFileData = NULL;
+    pxFrames = NULL;
+    uxFileSize = 0U;
+    ulFrameCount = 0U;
+    ulFrameSpace = 0U;
+    ulFramesSkipped = 0U;
+}
+/*-----------------------------------------------------------*/
+
+/* Read the whole file into memory and index its frames, so that the replay
+ * itself does not depend on the speed of the disk. */
+static BaseType_t prvLoad( const char * pcFileName )
+{
+    BaseType_t xReturn = pdFAIL;
+    FILE * pxFile;
+    long lSize;
+    uint32_t ulMagic;
+
+    pxFile = fopen( pcFileName, "rb" );
+
+    if( pxFile == NULL )
+    {
+        FreeRTOS_printf( ( "xReplayRun: can not open '%s'\n", pcFileName ) );
+    }
+    else
+    {
+        if( ( fseek( pxFile, 0L, SEEK_END ) == 0 ) && ( ( lSize = ftell( pxFile ) ) >= 24L ) &&
+            ( ( unsigned long ) lSize <= 0xFFFFFFFFUL ) && ( fseek( pxFile, 0L, SEEK_SET ) == 0 ) )
+        {
+            uxFileSize = ( size_t ) lSize;
+            pucFileData = ( uint8_t * ) malloc( uxFileSize );
+
+            if( ( pucFileData != NULL ) && ( fread( pucFileData, 1U, uxFileSize, pxFile ) == uxFileSize ) )
+            {
+                xReturn = pdPASS;
+            }
+        }
+
+        ( void ) fclose( pxFile );
+
+        if( xReturn == pdPASS )
+        {
+            ulMagic = prvRead32( pucFileData, pdFALSE );
+
+            if( ( ulMagic == replayPCAP_MAGIC_US ) || ( ulMagic == replayPCAP_MAGIC_NS ) )
+            {
+                xReturn = prvIndexPcap( pdFALSE );
+            }
+            else if( ( prvRead32( pucFileData, pdTRUE ) == replayPCAP_MAGIC_US ) ||
+                     ( prvRead32( pucFileData, pdTRUE ) == replayPCAP_MAGIC_NS ) )
+            {
+                xReturn = prvIndexPcap( pdTRUE );
+            }
+            else if( ulMagic == replayPCAPNG_SHB )
+            {
+                xReturn = prvIndexPcapNG();
+            }
+            else
+            {
+                FreeRTOS_printf( ( "xReplayRun: '%s' is not a pcap or pcapng file\n", pcFileName ) );
+                xReturn = pdFAIL;
+            }
+        }
+        else
+        {
+            FreeRTOS_printf( ( "xReplayRun: can not read '%s'\n", pcFileName ) );
+        }
+
+        if( ( xReturn == pdPASS ) && ( ulFrameCount == 0U ) )
+        {
+            FreeRTOS_printf( ( "xReplayRun: no Ethernet frames in '%s'\n", pcFileName ) );
+            xReturn = pdFAIL;
+        }
+    }
+
+    if( xReturn != pdPASS )
+    {
+        prvUnload();
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+/* Post all frames of the file once. Returns pdFAIL when the stack did not
+ * take a frame within replayWAIT_MS. */
+static BaseType_t prvReplayLoop( const MACAddress_t * pxRewriteMAC,
+                                 ReplayResult_t * pxResult )
+{
+    BaseType_t xReturn = pdPASS;
+    NetworkBufferDescriptor_t * pxDescriptor;
+    IPStackEvent_t xRxEvent;
+    uint32_t ulIndex;
+    size_t uxLength;
+
+    for( ulIndex = 0U; ulIndex < ulFrameCount; ulIndex++ )
+    {
+        uxLength = pxFrames[ ulIndex ].usLength;
+        pxDescriptor = pxGetNetworkBufferWithDescriptor( uxLength, pdMS_TO_TICKS( replayWAIT_MS ) );
+
+        if( pxDescriptor == NULL )
+        {
+            pxResult->ulTimeouts++;
+            xReturn = pdFAIL;
+            break;
+        }
+
+        ( void ) memcpy( pxDescriptor->pucEthernetBuffer, &( pucFileData[ pxFrames[ ulIndex ].ulOffset ] ), uxLength );
+        pxDescriptor->xDataLength = uxLength;
+
+        if( ( pxRewriteMAC != NULL ) && ( ( pxDescriptor->pucEthernetBuffer[ 0 ] & 0x01U ) == 0U ) )
+        {
+            /* A unicast frame, make it look as if it was sent to this device. */
+            ( void ) memcpy( pxDescriptor->pucEthernetBuffer, pxRewriteMAC->ucBytes, sizeof( pxRewriteMAC->ucBytes ) );
+        }
+
+        pxDescriptor->pxInterface = pxReplayInterface;
+        pxDescriptor->pxEndPoint = FreeRTOS_MatchingEndpoint( pxReplayInterface, pxDescriptor->pucEthernetBuffer );
+
+        if( pxDescriptor->pxEndPoint == NULL )
+        {
+            vReleaseNetworkBufferAndDescriptor( pxDescriptor );
+            pxResult->ulFramesNoEndPoint++;
+            continue;
+        }
+
+        iptraceNETWORK_INTERFACE_RECEIVE();
+
+        xRxEvent.eEventType = eNetworkRxEvent;
+        xRxEvent.pvData = ( void * ) pxDescriptor;
+
+        /* Block while the queue is full: the IP-task sets the pace. */
+        if( xSendEventStructToIPTask( &xRxEvent, pdMS_TO_TICKS( replayWAIT_MS ) ) != pdPASS )
+        {
+            vReleaseNetworkBufferAndDescriptor( pxDescriptor );
+            iptraceETHERNET_RX_EVENT_LOST();
+            pxResult->ulTimeouts++;
+            xReturn = pdFAIL;
+            break;
+        }
+
+        pxResult->ulFramesPosted++;
+        pxResult->ullBytesPosted += uxLength;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+/* Wait until the IP-task has processed all posted frames. With the trace
+ * macros the frames are counted; without them, the network buffers are
+ * counted, which can not tell how long ago the last one was returned. */
+static uint64_t prvWaitUntilDone( uint32_t ulPosted,
+                                  UBaseType_t uxFreeBuffers )
+{
+    uint64_t ullDone = 0U;
+    uint32_t ulLastCount = ulFramesProcessed;
+    TickType_t xIdleTicks = 0U;
+
+    for( ; ; )
+    {
+        if( ulFramesProcessed >= ulPosted )
+        {
+            ullDone = ullLastProcessed;
+            break;
+        }
+
+        if( ( ulFramesProcessed == 0U ) && ( uxGetNumberOfFreeNetworkBuffers() >= uxFreeBuffers ) )
+        {
+            ullDone = replayTIME_US();
+            break;
+        }
+
+        if( ulFramesProcessed != ulLastCount )
+        {
+            ulLastCount = ulFramesProcessed;
+            xIdleTicks = 0U;
+        }
+        else if( xIdleTicks >= pdMS_TO_TICKS( replayWAIT_MS ) )
+        {
+            /* No more progress: some buffers are held by the stack, e.g. a
+             * packet waiting for an ARP reply. */
+            ullDone = ( ulFramesProcessed != 0U ) ? ullLastProcessed : replayTIME_US();
+            break;
+        }
+        else
+        {
+            /* Still busy. */
+        }
+
+        vTaskDelay( 1U );
+        xIdleTicks++;
+    }
+
+    return ullDone;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xReplayRun( const ReplaySettings_t * pxSettings,
+                       ReplayResult_t * pxResult )
+{
+    BaseType_t xReturn = pdFAIL;
+    const MACAddress_t * pxRewriteMAC = NULL;
+    const NetworkEndPoint_t * pxEndPoint;
+    UBaseType_t uxFreeBuffers;
+    uint64_t ullStart;
+    uint64_t ullDone;
+    uint32_t ulLoop;
+
+    if( pxResult != NULL )
+    {
+        ( void ) memset( pxResult, 0, sizeof( *pxResult ) );
+    }
+
+    if( ( pxSettings == NULL ) || ( pxSettings->pcFileName == NULL ) || ( pxResult == NULL ) )
+    {
+        /* Invalid parameters. */
+    }
+    else if( ( pxReplayInterface == NULL ) || ( xReplayActive != pdFALSE ) || ( xIsCallingFromIPTask() != pdFALSE ) )
+    {
+        FreeRTOS_printf( ( "xReplayRun: no replay interface, or called from the wrong task\n" ) );
+    }
+    else if( prvLoad( pxSettings->pcFileName ) == pdPASS )
+    {
+        ( void ) memset( xProtocolStats, 0, sizeof( xProtocolStats ) );
+        pxResult->ulFramesInFile = ulFrameCount;
+        pxResult->ulFramesSkipped = ulFramesSkipped;
+
+        if( pxSettings->xRewriteMAC != pdFALSE )
+        {
+            pxEndPoint = FreeRTOS_FirstEndPoint( pxReplayInterface );
+
+            if( pxEndPoint != NULL )
+            {
+                pxRewriteMAC = &( pxEndPoint->xMACAddress );
+            }
+        }
+
+        ulFramesProcessed = 0U;
+        ulFramesSent = 0U;
+        ullInputTime = 0U;
+        uxFreeBuffers = uxGetNumberOfFreeNetworkBuffers();
+        xReplayActive = pdTRUE;
+
+        ullStart = replayTIME_US();
+
+        for( ulLoop = 0U; ulLoop < ( ( pxSettings->ulLoops > 0U ) ? pxSettings->ulLoops : 1U ); ulLoop++ )
+        {
+            if( prvReplayLoop( pxRewriteMAC, pxResult ) != pdPASS )
+            {
+                FreeRTOS_printf( ( "xReplayRun: the stack did not take frame %u of loop %u\n",
+                                   ( unsigned ) pxResult->ulFramesPosted, ( unsigned ) ulLoop ) );
+                break;
+            }
+        }
+
+        ullDone = prvWaitUntilDone( pxResult->ulFramesPosted, uxFreeBuffers );
+        xReplayActive = pdFALSE;
+
+        pxResult->ulFramesProcessed = ulFramesProcessed;
+        pxResult->ulFramesSent = ulFramesSent;
+        pxResult->ullElapsedUs = ( ullDone > ullStart ) ? ( ullDone - ullStart ) : 1U;
+        pxResult->ulFramesPerSecond = ( uint32_t ) ( ( ( uint64_t ) pxResult->ulFramesPosted * 1000000U ) / pxResult->ullElapsedUs );
+        pxResult->xTraceHooks = ( ulFramesProcessed != 0U ) ? pdTRUE : pdFALSE;
+        ( void ) memcpy( pxResult->xProtocols, xProtocolStats, sizeof( pxResult->xProtocols ) );
+
+        prvUnload();
+        xReturn = ( pxResult->ulTimeouts == 0U ) ? pdPASS : pdFAIL;
+    }
+    else
+    {
+        /* prvLoad() has logged the problem. */
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vReplayPrintResult( const ReplayResult_t * pxResult )
+{
+    static const char * const pcNames[ eReplayProtocolCount ] = { "ARP", "ICMP", "UDP", "TCP", "other" };
+    const ReplayProtocolStats_t * pxStats;
+    uint64_t ullTimed = 0U;
+    uint32_t ulMeanNs;
+    uint32_t ulShare;
+    BaseType_t xIndex;
+
+    FreeRTOS_printf( ( "Replay: %u frames per loop, %u skipped, %u posted, %u without end-point, %u sent back\n",
+                       ( unsigned ) pxResult->ulFramesInFile,
+                       ( unsigned ) pxResult->ulFramesSkipped,
+                       ( unsigned ) pxResult->ulFramesPosted,
+                       ( unsigned ) pxResult->ulFramesNoEndPoint,
+                       ( unsigned ) pxResult->ulFramesSent ) );
+    FreeRTOS_printf( ( "Replay: %u ms, %u frames/s, %u KB%s\n",
+                       ( unsigned ) ( pxResult->ullElapsedUs / 1000U ),
+                       ( unsigned ) pxResult->ulFramesPerSecond,
+                       ( unsigned ) ( pxResult->ullBytesPosted / 1024U ),
+                       ( pxResult->ulTimeouts != 0U ) ? ", stopped by a time-out" : "" ) );
+
+    if( pxResult->xTraceHooks == pdFALSE )
+    {
+        FreeRTOS_printf( ( "Replay: no per-protocol times, define replayUSE_TRACE_HOOKS as 1\n" ) );
+    }
+    else
+    {
+        for( xIndex = 0; xIndex < ( BaseType_t ) eReplayProtocolCount; xIndex++ )
+        {
+            ullTimed += pxResult->xProtocols[ xIndex ].ullTotalUs;
+        }
+
+        for( xIndex = 0; xIndex < ( BaseType_t ) eReplayProtocolCount; xIndex++ )
+        {
+            pxStats = &( pxResult->xProtocols[ xIndex ] );
+
+            if( pxStats->ulFrames != 0U )
+            {
+                ulMeanNs = ( uint32_t ) ( ( pxStats->ullTotalUs * 1000U ) / pxStats->ulFrames );
+                ulShare = ( ullTimed != 0U ) ? ( uint32_t ) ( ( pxStats->ullTotalUs * 100U ) / ullTimed ) : 0U;
+
+                FreeRTOS_printf( ( "  %-5s %8u frames  mean %6u ns  max %6u us  %3u%% of the time\n",
+                                   pcNames[ xIndex ],
+                                   ( unsigned ) pxStats->ulFrames,
+                                   ( unsigned ) ulMeanNs,
+                                   ( unsigned ) pxStats->ulMaxUs,
+                                   ( unsigned ) ulShare ) );
+                ( void ) ulMeanNs;
+                ( void ) ulShare;
+            }
+        }
+    }
+
+    ( void ) pcNames;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,147 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/*
+ * ReplayNetworkInterface.h
+ * A network interface that feeds the frames of a recorded pcap or pcapng
+ * file into the IP-task as fast as it can take them, to measure the cost of
+ * receiving and processing packets without any real hardware or driver.
+ * See source/portable/NetworkInterface/replay/README.md for a description.
+ *
+ * This header does not include any FreeRTOS+TCP header, so that it can be
+ * included from FreeRTOSIPConfig.h in order to install the trace macros.
+ */
+
+#ifndef REPLAY_NETWORK_INTERFACE_H
+
+    #define REPLAY_NETWORK_INTERFACE_H
+
+    #include <stddef.h>
+    #include <stdint.h>
+
+    #ifdef __cplusplus
+    extern "C" {
+    #endif
+
+/* Define as 1 in FreeRTOSIPConfig.h, before including this header, to let
+ * the trace macros count the processed frames and time them per protocol.
+ * Without the trace macros only the total rate can be measured, and less
+ * precisely. */
+    #ifndef replayUSE_TRACE_HOOKS
+        #define replayUSE_TRACE_HOOKS    0
+    #endif
+
+/* The classes of frames for which the processing time is measured. */
+    typedef enum eREPLAY_PROTOCOL
+    {
+        eReplayARP = 0, /* ARP requests and replies. */
+        eReplayICMP,    /* ICMP and ICMPv6, so including Neighbour Discovery. */
+        eReplayUDP,     /* UDP over IPv4 or IPv6. */
+        eReplayTCP,     /* TCP over IPv4 or IPv6. */
+        eReplayOther,   /* Anything else, e.g. IGMP, IPv6 extension headers, other frame types. */
+        eReplayProtocolCount
+    } eReplayProtocol_t;
+
+/* The settings of a replay. */
+    typedef struct xREPLAY_SETTINGS
+    {
+        const char * pcFileName; /* A pcap or pcapng file with Ethernet frames. */
+        uint32_t ulLoops;        /* The number of times that the whole file is replayed, at least 1. */
+        BaseType_t xRewriteMAC;  /* pdTRUE to replace the destination of unicast frames with the MAC-address of the end-point. */
+    } ReplaySettings_t;
+
+/* The processing time of one class of frames, measured by the IP-task from
+ * the start of prvProcessEthernetPacket() until the event is done. */
+    typedef struct xREPLAY_PROTOCOL_STATS
+    {
+        uint32_t ulFrames;   /* The number of frames that were timed. */
+        uint32_t ulMaxUs;    /* Unit: microseconds. The longest processing time. */
+        uint64_t ullTotalUs; /* Unit: microseconds. The sum of all processing times. */
+    } ReplayProtocolStats_t;
+
+/* The results of a replay. */
+    typedef struct xREPLAY_RESULT
+    {
+        uint32_t ulFramesInFile;      /* The frames that can be replayed, per loop. */
+        uint32_t ulFramesSkipped;     /* Frames in the file that are not Ethernet, cut short by the capture, or too long. */
+        uint32_t ulFramesPosted;      /* Frames passed to the IP-task, in all loops. */
+        uint32_t ulFramesProcessed;   /* Frames for which the IP-task finished, only counted by the trace macros. */
+        uint32_t ulFramesNoEndPoint;  /* Frames that were not posted because no end-point matched. */
+        uint32_t ulFramesSent;        /* Frames that the stack sent in return, the interface drops them. */
+        uint32_t ulTimeouts;          /* Failures to get a network buffer or to post an event, these end the replay. */
+        uint64_t ullBytesPosted;      /* The sum of the lengths of the posted frames. */
+        uint64_t ullElapsedUs;        /* Unit: microseconds. From the first post until the last frame was processed. */
+        uint32_t ulFramesPerSecond;   /* ulFramesPosted divided by ullElapsedUs. */
+        BaseType_t xTraceHooks;       /* pdTRUE when the trace macros were seen working, and xProtocols[] is valid. */
+        ReplayProtocolStats_t xProtocols[ eReplayProtocolCount ];
+    } ReplayResult_t;
+
+    struct xNetworkInterface;
+
+/*
+ * Add the replay interface. Its end-points must be added by the application,
+ * with the addresses that the device had in the capture.
+ */
+    struct xNetworkInterface * pxReplay_FillInterfaceDescriptor( BaseType_t xEMACIndex,
+                                                                 struct xNetworkInterface * pxInterface );
+
+/*
+ * Load a capture file into memory and replay it. The function blocks until
+ * the IP-task has processed the last frame. Only one replay can run at a time.
+ * It must be called from a task with a lower priority than the IP-task, but
+ * not from the IP-task itself.
+ */
+    BaseType_t xReplayRun( const ReplaySettings_t * pxSettings,
+                           ReplayResult_t * pxResult );
+
+/*
+ * Print the results of a replay with FreeRTOS_printf().
+ */
+    void vReplayPrintResult( const ReplayResult_t * pxResult );
+
+/* The functions called by the trace macros. A project that defines these
+ * trace macros itself, can call the functions from its own definitions. */
+    void vReplayTraceInput( const uint8_t * pucEthernetBuffer,
+                            size_t uxLength );
+    void vReplayTraceEventProcessed( BaseType_t xEvent );
+
+    #if ( replayUSE_TRACE_HOOKS == 1 )
+        #ifndef iptraceNETWORK_INTERFACE_INPUT
+            #define iptraceNETWORK_INTERFACE_INPUT( uxDataLength, pucEthernetBuffer )    vReplayTraceInput( ( pucEthernetBuffer ), ( size_t ) ( uxDataLength ) )
+        #endif
+
+        #ifndef iptraceNETWORK_EVENT_PROCESSED
+            #define iptraceNETWORK_EVENT_PROCESSED( eEvent )    vReplayTraceEventProcessed( ( BaseType_t ) ( eEvent ) )
+        #endif
+    #endif /* ( replayUSE_TRACE_HOOKS == 1 ) */
+
+    #ifdef __cplusplus
+}         /* extern "C" */
+    #endif
+
+#endif /* REPLAY_NETWORK_INTERFACE_H */
@@ -0,0 +1,79 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/*****************************************************************************
+*
+* See the following URL for configuration information.
+* http://www.freertos.org/FreeRTOS-Plus/FreeRTOS_Plus_TCP/TCP_IP_Configuration.html
+*
+*****************************************************************************/
+
+
+#ifndef FREERTOS_IP_CONFIG_H
+#define FREERTOS_IP_CONFIG_H
+
+/* The configuration of the micro-benchmarks in test/benchmark. It enables
+ * the features whose hot paths are measured, with cache sizes that make the
+ * cost of a linear search visible. Other settings keep their defaults, so
+ * that the numbers stay comparable with a typical application. */
+
+/* It is not sensible for this macro to have a default value as it is hardware
+ * dependent. */
+#define ipconfigBYTE_ORDER                         pdFREERTOS_LITTLE_ENDIAN
+
+/* The benchmark adds its own interface and end-points. */
+#define ipconfigIPv4_BACKWARD_COMPATIBLE           0
+
+#define ipconfigUSE_IPv4                           1
+#define ipconfigUSE_IPv6                           1
+#define ipconfigUSE_TCP                            1
+#define ipconfigUSE_DHCP                           0
+#define ipconfigUSE_DHCPv6                         0
+#define ipconfigUSE_RA                             0
+
+#define ipconfigUSE_DNS                            1
+#define ipconfigUSE_DNS_CACHE                      1
+#define ipconfigDNS_CACHE_ENTRIES                  16
+#define ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY      4
+#define ipconfigDNS_USE_CALLBACKS                  0
+#define ipconfigUSE_LLMNR                          0
+#define ipconfigUSE_NBNS                           0
+#define ipconfigUSE_MDNS                           0
+
+#define ipconfigARP_CACHE_ENTRIES                  32
+#define ipconfigND_CACHE_ENTRIES                   32
+
+#define ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS     60
+
+/* Logging would disturb the measurements. */
+#define ipconfigHAS_DEBUG_PRINTF                   0
+#define ipconfigHAS_PRINTF                         0
+
+/* The windows simulator cannot really simulate MAC interrupts, and needs to
+ * block occasionally to allow other tasks to run. */
+#define configWINDOWS_MAC_INTERRUPT_SIMULATOR_DELAY    ( 20 / portTICK_PERIOD_MS )
+
+#endif /* ifndef FREERTOS_IP_CONFIG_H */
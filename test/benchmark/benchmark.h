@@ -0,0 +1,96 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/**
+ * @file benchmark.h
+ * @brief The runner of the micro-benchmarks in test/benchmark.
+ */
+
+#ifndef BENCHMARK_H
+
+    #define BENCHMARK_H
+
+    #include <stddef.h>
+    #include <stdint.h>
+
+    #ifdef __cplusplus
+    extern "C" {
+    #endif
+
+/* The number of timed runs of every benchmark; the median and the minimum
+ * are reported. */
+    #ifndef benchmarkREPEAT_COUNT
+        #define benchmarkREPEAT_COUNT    5U
+    #endif
+
+/* The most benchmarks in one run of the program. */
+    #ifndef benchmarkMAX_RESULTS
+        #define benchmarkMAX_RESULTS    128U
+    #endif
+
+/* A function that performs the measured operation 'ulIterations' times. The
+ * context is set up by the caller, outside of the timed section. */
+    typedef void (* BenchmarkFunction_t)( void * pvContext,
+                                          uint32_t ulIterations );
+
+/* The result of one benchmark. */
+    typedef struct xBENCHMARK_RESULT
+    {
+        char cName[ 64 ];        /* E.g. "checksum/1460/align1". */
+        uint32_t ulIterations;   /* Iterations in every timed run. */
+        double dMedianNs;        /* Unit: ns per operation. The median of the timed runs. */
+        double dMinNs;           /* Unit: ns per operation. The fastest of the timed runs. */
+        size_t uxBytesPerOp;     /* The bytes handled by one operation, or 0. */
+    } BenchmarkResult_t;
+
+/*
+ * Time a function: find the number of iterations that takes the minimum time,
+ * then time benchmarkREPEAT_COUNT runs. The name is printed with printf()-style
+ * arguments. Benchmarks whose name does not contain the filter are skipped.
+ */
+    void vBenchmarkRun( BenchmarkFunction_t pxFunction,
+                        void * pvContext,
+                        size_t uxBytesPerOp,
+                        const char * pcNameFormat,
+                        ... );
+
+/*
+ * Keep the compiler from removing a computation whose result is not used.
+ */
+    void vBenchmarkConsume( uintptr_t uxValue );
+
+/*
+ * Run all benchmarks, implemented in benchmark_cases.c.
+ */
+    void vBenchmarkRunAll( void );
+
+    #ifdef __cplusplus
+}         /* extern "C" */
+    #endif
+
+#endif /* BENCHMARK_H */
@@ -0,0 +1,922 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/**
+ * @file benchmark_cases.c
+ * @brief The micro-benchmarks of the primitives that the IP-task runs for
+ *        every packet: the checksum, the stream buffers, the socket lookups,
+ *        the ARP, ND and DNS caches, the DNS parser and the network buffers.
+ *
+ * The benchmarks call the internal functions directly, from a task with a
+ * lower priority than the IP-task. The IP-task has nothing to do in the
+ * meantime, so it does not interfere with the lists and caches that are
+ * used.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include <FreeRTOS.h>
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_Sockets.h"
+#include "FreeRTOS_Stream_Buffer.h"
+#include "FreeRTOS_ARP.h"
+#include "FreeRTOS_ND.h"
+#include "FreeRTOS_DNS.h"
+#include "FreeRTOS_DNS_Parser.h"
+#include "FreeRTOS_Routing.h"
+#include "NetworkBufferManagement.h"
+
+#include "benchmark.h"
+
+/* The largest block of which the checksum is measured. */
+#define benchmarkCHECKSUM_MAX_SIZE    8192U
+
+/* The size of the stream buffers, like a large TCP receive window. */
+#define benchmarkSTREAM_SIZE          65536U
+
+/* The largest number of sockets bound at the same time. */
+#define benchmarkMAX_SOCKETS          256U
+
+/* The local port of the sockets, and the first remote port of the TCP
+ * children. */
+#define benchmarkFIRST_PORT           10000U
+#define benchmarkTCP_SERVER_PORT      80U
+#define benchmarkTCP_REMOTE_PORT      40000U
+
+/* The number of answers in the largest DNS reply. */
+#define benchmarkDNS_MAX_ANSWERS      4U
+
+/* The number of elements in an array, as a size_t. */
+#define benchmarkCOUNT( x )           ( sizeof( x ) / sizeof( ( x )[ 0 ] ) )
+
+/*-----------------------------------------------------------*/
+
+/** @brief The parameters of the checksum benchmark. */
+typedef struct xChecksumContext
+{
+    const uint8_t * pucData; /**< The first byte, at the alignment being measured. */
+    size_t uxLength;         /**< The number of bytes in the checksum. */
+} ChecksumContext_t;
+
+/** @brief The parameters of the stream buffer benchmarks. */
+typedef struct xStreamContext
+{
+    StreamBuffer_t * pxBuffer; /**< The stream buffer, which is empty before and after a run. */
+    uint8_t * pucData;         /**< The data that is written, and read back. */
+    size_t uxChunk;            /**< The number of bytes written and read in one operation. */
+} StreamContext_t;
+
+/** @brief The parameters of the socket lookup benchmarks. */
+typedef struct xLookupContext
+{
+    size_t uxCount;          /**< The number of sockets, and the number of keys to cycle through. */
+    BaseType_t xMiss;        /**< pdTRUE when a key is looked up that has no socket. */
+    uint32_t ulRemoteIP;     /**< The IP-address of the TCP peers, in network order. */
+} LookupContext_t;
+
+/** @brief The parameters of the ARP, ND and DNS cache benchmarks. */
+typedef struct xCacheContext
+{
+    NetworkEndPoint_t * pxEndPoint; /**< The end-point on the network of the addresses. */
+    size_t uxCount;                 /**< The number of entries to cycle through. */
+    BaseType_t xMiss;               /**< pdTRUE when an entry is looked up that is not in the cache. */
+} CacheContext_t;
+
+/** @brief The parameters of the DNS parser benchmark. */
+typedef struct xDNSContext
+{
+    uint8_t * pucReply;  /**< A reply from a DNS server. */
+    size_t uxLength;     /**< The length of the reply. */
+} DNSContext_t;
+
+/*-----------------------------------------------------------*/
+
+/* The data of the checksum benchmark, with room to shift its start. It is
+ * declared as 64-bit words to make sure that it is aligned. */
+static uint64_t ullChecksumData[ ( benchmarkCHECKSUM_MAX_SIZE / sizeof( uint64_t ) ) + 1U ];
+
+/* The sockets of the lookup benchmarks. */
+static FreeRTOS_Socket_t * pxSockets[ benchmarkMAX_SOCKETS + 1U ];
+
+/*-----------------------------------------------------------*/
+
+static void prvChecksum( void * pvContext,
+                         uint32_t ulIterations )
+{
+    const ChecksumContext_t * pxContext = ( const ChecksumContext_t * ) pvContext;
+    uint16_t usSum = 0U;
+    uint32_t ulIndex;
+
+    /* Every sum depends on the previous one, so the calls can not be
+     * merged or hoisted out of the loop. */
+    for( ulIndex = 0U; ulIndex < ulIterations; ulIndex++ )
+    {
+        usSum = usGenerateChecksum( usSum, pxContext->pucData, pxContext->uxLength );
+    }
+
+    vBenchmarkConsume( usSum );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunChecksum( void )
+{
+    static const size_t uxSizes[] = { 20U, 64U, 256U, 576U, 1460U, benchmarkCHECKSUM_MAX_SIZE };
+    ChecksumContext_t xContext;
+    uint8_t * pucData = ( uint8_t * ) ullChecksumData;
+    size_t uxSize;
+    size_t uxAlign;
+    size_t uxIndex;
+
+    for( uxIndex = 0U; uxIndex < sizeof( ullChecksumData ); uxIndex++ )
+    {
+        pucData[ uxIndex ] = ( uint8_t ) ( ( uxIndex * 7U ) + 3U );
+    }
+
+    for( uxSize = 0U; uxSize < benchmarkCOUNT( uxSizes ); uxSize++ )
+    {
+        /* Network buffers are aligned, but the data of a TCP segment or a
+         * UDP payload may start at any byte. */
+        for( uxAlign = 0U; uxAlign < 4U; uxAlign++ )
+        {
+            xContext.pucData = &( pucData[ uxAlign ] );
+            xContext.uxLength = uxSizes[ uxSize ];
+
+            vBenchmarkRun( prvChecksum, &( xContext ), uxSizes[ uxSize ],
+                           "checksum/%u/align%u", ( unsigned ) uxSizes[ uxSize ], ( unsigned ) uxAlign );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvStreamAddGet( void * pvContext,
+                             uint32_t ulIterations )
+{
+    const StreamContext_t * pxContext = ( const StreamContext_t * ) pvContext;
+    size_t uxCount = 0U;
+    uint32_t ulIndex;
+
+    for( ulIndex = 0U; ulIndex < ulIterations; ulIndex++ )
+    {
+        uxCount += uxStreamBufferAdd( pxContext->pxBuffer, 0U, pxContext->pucData, pxContext->uxChunk );
+        uxCount += uxStreamBufferGet( pxContext->pxBuffer, 0U, pxContext->pucData, pxContext->uxChunk, pdFALSE );
+    }
+
+    vBenchmarkConsume( uxCount );
+}
+/*-----------------------------------------------------------*/
+
+static void prvStreamOutOfOrder( void * pvContext,
+                                 uint32_t ulIterations )
+{
+    const StreamContext_t * pxContext = ( const StreamContext_t * ) pvContext;
+    size_t uxCount = 0U;
+    uint32_t ulIndex;
+
+    /* As TCP does when a segment arrives before its predecessor: the second
+     * chunk is stored beyond the head, then the first chunk fills the gap. */
+    for( ulIndex = 0U; ulIndex < ulIterations; ulIndex++ )
+    {
+        uxCount += uxStreamBufferAdd( pxContext->pxBuffer, pxContext->uxChunk, pxContext->pucData, pxContext->uxChunk );
+        uxCount += uxStreamBufferAdd( pxContext->pxBuffer, 0U, pxContext->pucData, pxContext->uxChunk );
+        uxCount += uxStreamBufferGet( pxContext->pxBuffer, 0U, pxContext->pucData, 2U * pxContext->uxChunk, pdFALSE );
+    }
+
+    vBenchmarkConsume( uxCount );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunStreamBuffer( void )
+{
+    static const size_t uxChunks[] = { 1U, 64U, 536U, 1460U };
+    StreamContext_t xContext;
+    size_t uxLength;
+    size_t uxIndex;
+
+    /* Allocated in the same way as prvTCPCreateStream() does. */
+    uxLength = benchmarkSTREAM_SIZE + sizeof( size_t );
+    uxLength &= ~( sizeof( size_t ) - 1U );
+
+    xContext.pxBuffer = ( StreamBuffer_t * ) pvPortMalloc( ( sizeof( *xContext.pxBuffer ) + uxLength ) - sizeof( xContext.pxBuffer->ucArray ) );
+    xContext.pucData = ( uint8_t * ) pvPortMalloc( 2U * uxChunks[ benchmarkCOUNT( uxChunks ) - 1U ] );
+
+    if( ( xContext.pxBuffer != NULL ) && ( xContext.pucData != NULL ) )
+    {
+        ( void ) memset( xContext.pxBuffer, 0, sizeof( *xContext.pxBuffer ) - sizeof( xContext.pxBuffer->ucArray ) );
+        xContext.pxBuffer->LENGTH = uxLength;
+        ( void ) memset( xContext.pucData, 0x55, 2U * uxChunks[ benchmarkCOUNT( uxChunks ) - 1U ] );
+
+        for( uxIndex = 0U; uxIndex < benchmarkCOUNT( uxChunks ); uxIndex++ )
+        {
+            xContext.uxChunk = uxChunks[ uxIndex ];
+
+            vBenchmarkRun( prvStreamAddGet, &( xContext ), xContext.uxChunk,
+                           "stream_buffer/add_get/%u", ( unsigned ) xContext.uxChunk );
+            vBenchmarkRun( prvStreamOutOfOrder, &( xContext ), 2U * xContext.uxChunk,
+                           "stream_buffer/out_of_order/%u", ( unsigned ) xContext.uxChunk );
+        }
+    }
+
+    vPortFree( xContext.pucData );
+    vPortFree( xContext.pxBuffer );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Create a socket and add it to the list of bound sockets, as the
+ *        IP-task does when it handles an eSocketBindEvent.
+ */
+static FreeRTOS_Socket_t * prvCreateBoundSocket( BaseType_t xProtocol,
+                                                 uint16_t usPort )
+{
+    struct freertos_sockaddr xAddress;
+    FreeRTOS_Socket_t * pxSocket;
+    BaseType_t xDomain;
+    BaseType_t xType = ( xProtocol == FREERTOS_IPPROTO_TCP ) ? FREERTOS_SOCK_STREAM : FREERTOS_SOCK_DGRAM;
+
+    #if ( ipconfigUSE_IPv4 != 0 )
+        xDomain = FREERTOS_AF_INET;
+    #else
+        xDomain = FREERTOS_AF_INET6;
+    #endif
+
+    pxSocket = ( FreeRTOS_Socket_t * ) FreeRTOS_socket( xDomain, xType, xProtocol );
+
+    if( pxSocket == FREERTOS_INVALID_SOCKET )
+    {
+        pxSocket = NULL;
+    }
+    else
+    {
+        ( void ) memset( &( xAddress ), 0, sizeof( xAddress ) );
+        xAddress.sin_family = ( uint8_t ) xDomain;
+        xAddress.sin_port = FreeRTOS_htons( usPort );
+
+        /* An internal bind allows more TCP sockets on the same port. */
+        if( vSocketBind( pxSocket, &( xAddress ), sizeof( xAddress ), pdTRUE ) != 0 )
+        {
+            ( void ) vSocketClose( pxSocket );
+            pxSocket = NULL;
+        }
+    }
+
+    return pxSocket;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCloseSockets( size_t uxCount )
+{
+    size_t uxIndex;
+
+    for( uxIndex = 0U; uxIndex < uxCount; uxIndex++ )
+    {
+        if( pxSockets[ uxIndex ] != NULL )
+        {
+            #if ( ipconfigUSE_TCP == 1 )
+                if( pxSockets[ uxIndex ]->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP )
+                {
+                    pxSockets[ uxIndex ]->u.xTCP.eTCPState = eCLOSED;
+                }
+            #endif
+
+            ( void ) vSocketClose( pxSockets[ uxIndex ] );
+            pxSockets[ uxIndex ] = NULL;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvUDPLookup( void * pvContext,
+                          uint32_t ulIterations )
+{
+    const LookupContext_t * pxContext = ( const LookupContext_t * ) pvContext;
+    uintptr_t uxFound = 0U;
+    size_t uxNext = 0U;
+    uint16_t usPort;
+    uint32_t ulIndex;
+
+    for( ulIndex = 0U; ulIndex < ulIterations; ulIndex++ )
+    {
+        /* Cycle through all ports, so the average position in the list is
+         * measured. A miss searches the whole list. */
+        usPort = ( uint16_t ) ( benchmarkFIRST_PORT + ( ( pxContext->xMiss != pdFALSE ) ? pxContext->uxCount : uxNext ) );
+        uxFound += ( uintptr_t ) pxUDPSocketLookup( FreeRTOS_htons( usPort ) );
+
+        uxNext++;
+
+        if( uxNext == pxContext->uxCount )
+        {
+            uxNext = 0U;
+        }
+    }
+
+    vBenchmarkConsume( uxFound );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunUDPLookup( void )
+{
+    static const size_t uxCounts[] = { 1U, 16U, 64U, benchmarkMAX_SOCKETS };
+    LookupContext_t xContext;
+    size_t uxIndex;
+    size_t uxSocket;
+
+    ( void ) memset( &( xContext ), 0, sizeof( xContext ) );
+
+    for( uxIndex = 0U; uxIndex < benchmarkCOUNT( uxCounts ); uxIndex++ )
+    {
+        xContext.uxCount = uxCounts[ uxIndex ];
+
+        for( uxSocket = 0U; uxSocket < xContext.uxCount; uxSocket++ )
+        {
+            pxSockets[ uxSocket ] = prvCreateBoundSocket( FREERTOS_IPPROTO_UDP, ( uint16_t ) ( benchmarkFIRST_PORT + uxSocket ) );
+
+            if( pxSockets[ uxSocket ] == NULL )
+            {
+                break;
+            }
+        }
+
+        if( uxSocket == xContext.uxCount )
+        {
+            xContext.xMiss = pdFALSE;
+            vBenchmarkRun( prvUDPLookup, &( xContext ), 0U, "udp_lookup/%u/hit", ( unsigned ) xContext.uxCount );
+            xContext.xMiss = pdTRUE;
+            vBenchmarkRun( prvUDPLookup, &( xContext ), 0U, "udp_lookup/%u/miss", ( unsigned ) xContext.uxCount );
+        }
+        else
+        {
+            fprintf( stderr, "Can not create %u UDP sockets\n", ( unsigned ) xContext.uxCount );
+        }
+
+        prvCloseSockets( uxSocket );
+    }
+}
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_TCP == 1 )
+
+    static void prvTCPLookup( void * pvContext,
+                              uint32_t ulIterations )
+    {
+        const LookupContext_t * pxContext = ( const LookupContext_t * ) pvContext;
+        IPv46_Address_t xRemoteIP;
+        uintptr_t uxFound = 0U;
+        size_t uxNext = 0U;
+        uint32_t ulIndex;
+        UBaseType_t uxRemotePort;
+
+        ( void ) memset( &( xRemoteIP ), 0, sizeof( xRemoteIP ) );
+        xRemoteIP.xIPAddress.ulIP_IPv4 = pxContext->ulRemoteIP;
+
+        for( ulIndex = 0U; ulIndex < ulIterations; ulIndex++ )
+        {
+            /* A miss is a SYN from a new peer: the whole list is searched
+             * before the listening socket is returned. */
+            uxRemotePort = benchmarkTCP_REMOTE_PORT + ( ( pxContext->xMiss != pdFALSE ) ? pxContext->uxCount : uxNext );
+            uxFound += ( uintptr_t ) pxTCPSocketLookup( 0U, benchmarkTCP_SERVER_PORT, xRemoteIP, uxRemotePort );
+
+            uxNext++;
+
+            if( uxNext == pxContext->uxCount )
+            {
+                uxNext = 0U;
+            }
+        }
+
+        vBenchmarkConsume( uxFound );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvRunTCPLookup( void )
+    {
+        static const size_t uxCounts[] = { 1U, 16U, 64U, benchmarkMAX_SOCKETS };
+        LookupContext_t xContext;
+        size_t uxIndex;
+        size_t uxSocket;
+        FreeRTOS_Socket_t * pxSocket;
+
+        ( void ) memset( &( xContext ), 0, sizeof( xContext ) );
+        xContext.ulRemoteIP = FreeRTOS_inet_addr_quick( 192, 168, 10, 100 );
+
+        for( uxIndex = 0U; uxIndex < benchmarkCOUNT( uxCounts ); uxIndex++ )
+        {
+            xContext.uxCount = uxCounts[ uxIndex ];
+
+            /* A server socket, followed by one established child socket per
+             * connection, as a web server would have. The states are set
+             * directly: the sockets never see a packet, and a zero time-out
+             * keeps the TCP timer of the IP-task away from them. */
+            for( uxSocket = 0U; uxSocket <= xContext.uxCount; uxSocket++ )
+            {
+                pxSocket = prvCreateBoundSocket( FREERTOS_IPPROTO_TCP, benchmarkTCP_SERVER_PORT );
+                pxSockets[ uxSocket ] = pxSocket;
+
+                if( pxSocket == NULL )
+                {
+                    break;
+                }
+
+                if( uxSocket == 0U )
+                {
+                    pxSocket->u.xTCP.eTCPState = eTCP_LISTEN;
+                }
+                else
+                {
+                    pxSocket->u.xTCP.eTCPState = eESTABLISHED;
+                    pxSocket->u.xTCP.usRemotePort = ( uint16_t ) ( benchmarkTCP_REMOTE_PORT + uxSocket - 1U );
+                    pxSocket->u.xTCP.xRemoteIP.ulIP_IPv4 = xContext.ulRemoteIP;
+                }
+            }
+
+            if( uxSocket > xContext.uxCount )
+            {
+                xContext.xMiss = pdFALSE;
+                vBenchmarkRun( prvTCPLookup, &( xContext ), 0U, "tcp_lookup/%u/hit", ( unsigned ) xContext.uxCount );
+                xContext.xMiss = pdTRUE;
+                vBenchmarkRun( prvTCPLookup, &( xContext ), 0U, "tcp_lookup/%u/listener", ( unsigned ) xContext.uxCount );
+            }
+            else
+            {
+                fprintf( stderr, "Can not create %u TCP sockets\n", ( unsigned ) xContext.uxCount + 1U );
+            }
+
+            prvCloseSockets( uxSocket );
+        }
+    }
+
+#endif /* ipconfigUSE_TCP == 1 */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_IPv4 != 0 )
+
+/**
+ * @brief The IP-address of a neighbour: the entries are numbered from the
+ *        first address on the network of the end-point, skipping the
+ *        address zero.
+ */
+    static uint32_t prvIPv4Neighbour( const NetworkEndPoint_t * pxEndPoint,
+                                      size_t uxIndex )
+    {
+        uint32_t ulNetwork = pxEndPoint->ipv4_settings.ulIPAddress & pxEndPoint->ipv4_settings.ulNetMask;
+
+        return ulNetwork | FreeRTOS_htonl( ( uint32_t ) uxIndex + 16U );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvARPRefresh( void * pvContext,
+                               uint32_t ulIterations )
+    {
+        const CacheContext_t * pxContext = ( const CacheContext_t * ) pvContext;
+        MACAddress_t xMACAddress = { { 0x02, 0x00, 0x00, 0x00, 0x01, 0x00 } };
+        size_t uxNext = 0U;
+        uint32_t ulIndex;
+
+        for( ulIndex = 0U; ulIndex < ulIterations; ulIndex++ )
+        {
+            xMACAddress.ucBytes[ 5 ] = ( uint8_t ) uxNext;
+            vARPRefreshCacheEntry( &( xMACAddress ), prvIPv4Neighbour( pxContext->pxEndPoint, uxNext ), pxContext->pxEndPoint );
+
+            uxNext++;
+
+            if( uxNext == pxContext->uxCount )
+            {
+                uxNext = 0U;
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvARPLookup( void * pvContext,
+                              uint32_t ulIterations )
+    {
+        const CacheContext_t * pxContext = ( const CacheContext_t * ) pvContext;
+        MACAddress_t xMACAddress;
+        NetworkEndPoint_t * pxEndPoint;
+        uint32_t ulIPAddress;
+        uintptr_t uxHits = 0U;
+        size_t uxNext = 0U;
+        uint32_t ulIndex;
+
+        for( ulIndex = 0U; ulIndex < ulIterations; ulIndex++ )
+        {
+            ulIPAddress = prvIPv4Neighbour( pxContext->pxEndPoint, ( pxContext->xMiss != pdFALSE ) ? pxContext->uxCount : uxNext );
+
+            if( eARPGetCacheEntry( &( ulIPAddress ), &( xMACAddress ), &( pxEndPoint ) ) == eResolutionCacheHit )
+            {
+                uxHits++;
+            }
+
+            uxNext++;
+
+            if( uxNext == pxContext->uxCount )
+            {
+                uxNext = 0U;
+            }
+        }
+
+        vBenchmarkConsume( uxHits );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvRunARP( void )
+    {
+        CacheContext_t xContext;
+
+        ( void ) memset( &( xContext ), 0, sizeof( xContext ) );
+        xContext.pxEndPoint = FreeRTOS_FirstEndPoint( NULL );
+
+        while( ( xContext.pxEndPoint != NULL ) && ( ENDPOINT_IS_IPv4( xContext.pxEndPoint ) == 0 ) )
+        {
+            xContext.pxEndPoint = FreeRTOS_NextEndPoint( NULL, xContext.pxEndPoint );
+        }
+
+        if( xContext.pxEndPoint != NULL )
+        {
+            /* Fill the cache, then measure the lookups in a full cache. */
+            xContext.uxCount = ipconfigARP_CACHE_ENTRIES;
+            prvARPRefresh( &( xContext ), ipconfigARP_CACHE_ENTRIES );
+
+            vBenchmarkRun( prvARPRefresh, &( xContext ), 0U, "arp/refresh/%u", ( unsigned ) xContext.uxCount );
+            xContext.xMiss = pdFALSE;
+            vBenchmarkRun( prvARPLookup, &( xContext ), 0U, "arp/lookup/%u/hit", ( unsigned ) xContext.uxCount );
+            xContext.xMiss = pdTRUE;
+            vBenchmarkRun( prvARPLookup, &( xContext ), 0U, "arp/lookup/%u/miss", ( unsigned ) xContext.uxCount );
+        }
+    }
+
+#endif /* ipconfigUSE_IPv4 != 0 */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_IPv6 != 0 )
+
+/**
+ * @brief The IP-address of a neighbour: the prefix of the end-point followed
+ *        by a host number.
+ */
+    static void prvIPv6Neighbour( const NetworkEndPoint_t * pxEndPoint,
+                                  size_t uxIndex,
+                                  IPv6_Address_t * pxAddress )
+    {
+        ( void ) memcpy( pxAddress->ucBytes, pxEndPoint->ipv6_settings.xPrefix.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+        pxAddress->ucBytes[ 14 ] = 0x01U;
+        pxAddress->ucBytes[ 15 ] = ( uint8_t ) uxIndex;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvNDRefresh( void * pvContext,
+                              uint32_t ulIterations )
+    {
+        const CacheContext_t * pxContext = ( const CacheContext_t * ) pvContext;
+        MACAddress_t xMACAddress = { { 0x02, 0x00, 0x00, 0x00, 0x02, 0x00 } };
+        IPv6_Address_t xIPAddress;
+        size_t uxNext = 0U;
+        uint32_t ulIndex;
+
+        for( ulIndex = 0U; ulIndex < ulIterations; ulIndex++ )
+        {
+            xMACAddress.ucBytes[ 5 ] = ( uint8_t ) uxNext;
+            prvIPv6Neighbour( pxContext->pxEndPoint, uxNext, &( xIPAddress ) );
+            vNDRefreshCacheEntry( &( xMACAddress ), &( xIPAddress ), pxContext->pxEndPoint );
+
+            uxNext++;
+
+            if( uxNext == pxContext->uxCount )
+            {
+                uxNext = 0U;
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvNDLookup( void * pvContext,
+                             uint32_t ulIterations )
+    {
+        const CacheContext_t * pxContext = ( const CacheContext_t * ) pvContext;
+        MACAddress_t xMACAddress;
+        NetworkEndPoint_t * pxEndPoint;
+        IPv6_Address_t xIPAddress;
+        uintptr_t uxHits = 0U;
+        size_t uxNext = 0U;
+        uint32_t ulIndex;
+
+        for( ulIndex = 0U; ulIndex < ulIterations; ulIndex++ )
+        {
+            prvIPv6Neighbour( pxContext->pxEndPoint, uxNext, &( xIPAddress ) );
+
+            if( eNDGetCacheEntry( &( xIPAddress ), &( xMACAddress ), &( pxEndPoint ) ) == eResolutionCacheHit )
+            {
+                uxHits++;
+            }
+
+            uxNext++;
+
+            if( uxNext == pxContext->uxCount )
+            {
+                uxNext = 0U;
+            }
+        }
+
+        vBenchmarkConsume( uxHits );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvRunND( void )
+    {
+        CacheContext_t xContext;
+
+        ( void ) memset( &( xContext ), 0, sizeof( xContext ) );
+        xContext.pxEndPoint = FreeRTOS_FirstEndPoint_IPv6( NULL );
+
+        if( xContext.pxEndPoint != NULL )
+        {
+            /* A miss in the ND cache is followed by a search for a gateway,
+             * so only the hits are a measure of the cache itself. */
+            xContext.uxCount = ipconfigND_CACHE_ENTRIES;
+            prvNDRefresh( &( xContext ), ipconfigND_CACHE_ENTRIES );
+
+            vBenchmarkRun( prvNDRefresh, &( xContext ), 0U, "nd/refresh/%u", ( unsigned ) xContext.uxCount );
+            vBenchmarkRun( prvNDLookup, &( xContext ), 0U, "nd/lookup/%u/hit", ( unsigned ) xContext.uxCount );
+        }
+    }
+
+#endif /* ipconfigUSE_IPv6 != 0 */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_DNS != 0 )
+
+    #if ( ( ipconfigUSE_DNS_CACHE != 0 ) && ( ipconfigUSE_IPv4 != 0 ) )
+
+        static void prvDNSName( size_t uxIndex,
+                                char * pcName,
+                                size_t uxSize )
+        {
+            ( void ) snprintf( pcName, uxSize, "host%u.example.com", ( unsigned ) uxIndex );
+        }
+/*-----------------------------------------------------------*/
+
+        static void prvDNSUpdate( void * pvContext,
+                                  uint32_t ulIterations )
+        {
+            const CacheContext_t * pxContext = ( const CacheContext_t * ) pvContext;
+            IPv46_Address_t xAddress;
+            char cName[ 32 ];
+            size_t uxNext = 0U;
+            uint32_t ulIndex;
+
+            ( void ) memset( &( xAddress ), 0, sizeof( xAddress ) );
+
+            for( ulIndex = 0U; ulIndex < ulIterations; ulIndex++ )
+            {
+                prvDNSName( uxNext, cName, sizeof( cName ) );
+                xAddress.xIPAddress.ulIP_IPv4 = FreeRTOS_inet_addr_quick( 10, 0, 0, ( uint8_t ) uxNext );
+                ( void ) FreeRTOS_dns_update( cName, &( xAddress ), 3600U, pdFALSE, NULL );
+
+                uxNext++;
+
+                if( uxNext == pxContext->uxCount )
+                {
+                    uxNext = 0U;
+                }
+            }
+        }
+/*-----------------------------------------------------------*/
+
+        static void prvDNSLookup( void * pvContext,
+                                  uint32_t ulIterations )
+        {
+            const CacheContext_t * pxContext = ( const CacheContext_t * ) pvContext;
+            char cNames[ ipconfigDNS_CACHE_ENTRIES + 1U ][ 32 ];
+            uintptr_t uxFound = 0U;
+            size_t uxNext = 0U;
+            uint32_t ulIndex;
+
+            /* Format the names up front: only the lookups are measured. */
+            for( ulIndex = 0U; ulIndex <= pxContext->uxCount; ulIndex++ )
+            {
+                prvDNSName( ulIndex, cNames[ ulIndex ], sizeof( cNames[ ulIndex ] ) );
+            }
+
+            for( ulIndex = 0U; ulIndex < ulIterations; ulIndex++ )
+            {
+                uxFound += FreeRTOS_dnslookup( cNames[ ( pxContext->xMiss != pdFALSE ) ? pxContext->uxCount : uxNext ] );
+
+                uxNext++;
+
+                if( uxNext == pxContext->uxCount )
+                {
+                    uxNext = 0U;
+                }
+            }
+
+            vBenchmarkConsume( uxFound );
+        }
+    #endif /* ( ipconfigUSE_DNS_CACHE != 0 ) && ( ipconfigUSE_IPv4 != 0 ) */
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Write a reply from a DNS server, with a number of A records for
+ *        the name of the question.
+ *
+ * @return The length of the reply.
+ */
+    static size_t prvMakeDNSReply( uint8_t * pucBuffer,
+                                   size_t uxAnswers )
+    {
+        static const uint8_t ucHeader[] =
+        {
+            0x12, 0x34, /* Identifier. */
+            0x81, 0x80, /* Flags: a response without errors, recursion available. */
+            0x00, 0x01, /* Questions. */
+            0x00, 0x00, /* Answers, filled in below. */
+            0x00, 0x00, /* Authority records. */
+            0x00, 0x00  /* Additional records. */
+        };
+        static const uint8_t ucQuestion[] =
+        {
+            3, 'w', 'w', 'w', 7, 'e', 'x', 'a', 'm', 'p', 'l', 'e', 3, 'c', 'o', 'm', 0,
+            0x00, 0x01, /* Type A. */
+            0x00, 0x01  /* Class IN. */
+        };
+        static const uint8_t ucAnswer[] =
+        {
+            0xC0, 0x0C,            /* A pointer to the name in the question. */
+            0x00, 0x01,            /* Type A. */
+            0x00, 0x01,            /* Class IN. */
+            0x00, 0x00, 0x0E, 0x10, /* TTL: one hour. */
+            0x00, 0x04,            /* The length of the address. */
+            93, 184, 216, 0        /* The address, completed below. */
+        };
+        size_t uxLength = 0U;
+        size_t uxIndex;
+
+        ( void ) memcpy( &( pucBuffer[ uxLength ] ), ucHeader, sizeof( ucHeader ) );
+        pucBuffer[ 7 ] = ( uint8_t ) uxAnswers;
+        uxLength += sizeof( ucHeader );
+
+        ( void ) memcpy( &( pucBuffer[ uxLength ] ), ucQuestion, sizeof( ucQuestion ) );
+        uxLength += sizeof( ucQuestion );
+
+        for( uxIndex = 0U; uxIndex < uxAnswers; uxIndex++ )
+        {
+            ( void ) memcpy( &( pucBuffer[ uxLength ] ), ucAnswer, sizeof( ucAnswer ) );
+            uxLength += sizeof( ucAnswer );
+            pucBuffer[ uxLength - 1U ] = ( uint8_t ) ( uxIndex + 1U );
+        }
+
+        return uxLength;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvDNSParse( void * pvContext,
+                             uint32_t ulIterations )
+    {
+        const DNSContext_t * pxContext = ( const DNSContext_t * ) pvContext;
+        uintptr_t uxFound = 0U;
+        uint32_t ulIndex;
+
+        /* The reply is expected, so the answers are stored in the DNS cache,
+         * as they are when the reply to a query arrives. */
+        for( ulIndex = 0U; ulIndex < ulIterations; ulIndex++ )
+        {
+            uxFound += ( uintptr_t ) DNS_ParseDNSReply( pxContext->pucReply, pxContext->uxLength, NULL, pdTRUE, ipDNS_PORT );
+        }
+
+        vBenchmarkConsume( uxFound );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvRunDNS( void )
+    {
+        static const size_t uxAnswers[] = { 1U, benchmarkDNS_MAX_ANSWERS };
+        static uint8_t ucReply[ 128 ];
+        DNSContext_t xDNSContext;
+        size_t uxIndex;
+
+        #if ( ( ipconfigUSE_DNS_CACHE != 0 ) && ( ipconfigUSE_IPv4 != 0 ) )
+        {
+            CacheContext_t xContext;
+
+            ( void ) memset( &( xContext ), 0, sizeof( xContext ) );
+            FreeRTOS_dnsclear();
+
+            xContext.uxCount = ipconfigDNS_CACHE_ENTRIES;
+            prvDNSUpdate( &( xContext ), ipconfigDNS_CACHE_ENTRIES );
+
+            vBenchmarkRun( prvDNSUpdate, &( xContext ), 0U, "dns_cache/update/%u", ( unsigned ) xContext.uxCount );
+            xContext.xMiss = pdFALSE;
+            vBenchmarkRun( prvDNSLookup, &( xContext ), 0U, "dns_cache/lookup/%u/hit", ( unsigned ) xContext.uxCount );
+            xContext.xMiss = pdTRUE;
+            vBenchmarkRun( prvDNSLookup, &( xContext ), 0U, "dns_cache/lookup/%u/miss", ( unsigned ) xContext.uxCount );
+        }
+        #endif /* ( ipconfigUSE_DNS_CACHE != 0 ) && ( ipconfigUSE_IPv4 != 0 ) */
+
+        xDNSContext.pucReply = ucReply;
+
+        for( uxIndex = 0U; uxIndex < benchmarkCOUNT( uxAnswers ); uxIndex++ )
+        {
+            xDNSContext.uxLength = prvMakeDNSReply( ucReply, uxAnswers[ uxIndex ] );
+
+            vBenchmarkRun( prvDNSParse, &( xDNSContext ), xDNSContext.uxLength,
+                           "dns_parse/%u_answers", ( unsigned ) uxAnswers[ uxIndex ] );
+        }
+    }
+
+#endif /* ipconfigUSE_DNS != 0 */
+/*-----------------------------------------------------------*/
+
+static void prvNetworkBuffer( void * pvContext,
+                              uint32_t ulIterations )
+{
+    size_t uxSize = *( ( const size_t * ) pvContext );
+    NetworkBufferDescriptor_t * pxBuffer;
+    uintptr_t uxFailed = 0U;
+    uint32_t ulIndex;
+
+    for( ulIndex = 0U; ulIndex < ulIterations; ulIndex++ )
+    {
+        pxBuffer = pxGetNetworkBufferWithDescriptor( uxSize, 0U );
+
+        if( pxBuffer != NULL )
+        {
+            vReleaseNetworkBufferAndDescriptor( pxBuffer );
+        }
+        else
+        {
+            uxFailed++;
+        }
+    }
+
+    vBenchmarkConsume( uxFailed );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunNetworkBuffer( void )
+{
+    static const size_t uxSizes[] = { 64U, ipTOTAL_ETHERNET_FRAME_SIZE };
+    size_t uxIndex;
+
+    for( uxIndex = 0U; uxIndex < benchmarkCOUNT( uxSizes ); uxIndex++ )
+    {
+        vBenchmarkRun( prvNetworkBuffer, ( void * ) &( uxSizes[ uxIndex ] ), 0U,
+                       "network_buffer/get_release/%u", ( unsigned ) uxSizes[ uxIndex ] );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vBenchmarkRunAll( void )
+{
+    prvRunChecksum();
+    prvRunStreamBuffer();
+    prvRunUDPLookup();
+
+    #if ( ipconfigUSE_TCP == 1 )
+        prvRunTCPLookup();
+    #endif
+
+    #if ( ipconfigUSE_IPv4 != 0 )
+        prvRunARP();
+    #endif
+
+    #if ( ipconfigUSE_IPv6 != 0 )
+        prvRunND();
+    #endif
+
+    #if ( ipconfigUSE_DNS != 0 )
+        prvRunDNS();
+    #endif
+
+    prvRunNetworkBuffer();
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+# FreeRTOS+TCP
+# Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+#
+# SPDX-License-Identifier: MIT
+
+"""Compare two runs of freertos_plus_tcp_benchmark and report regressions.
+
+Both files are written with --json. A benchmark regresses when its median
+time per operation grew by more than the threshold. Benchmarks that appear in
+only one of the files are listed, but are not counted as a regression.
+
+The exit code is 1 when there is a regression, so the script can be used as
+a test.
+
+Examples:
+    compare_benchmarks.py baseline.json benchmark_results.json
+    compare_benchmarks.py baseline.json benchmark_results.json --threshold 5 --filter checksum
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(file_name):
+    """Return the benchmarks of a result file as a dictionary by name."""
+    with open(file_name, "r", encoding="utf-8") as handle:
+        report = json.load(handle)
+    if report.get("version") != 1:
+        raise ValueError("%s: unsupported version %s" % (file_name, report.get("version")))
+    return {benchmark["name"]: benchmark for benchmark in report["benchmarks"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline", help="the results of the reference run")
+    parser.add_argument("current", help="the results of the run to be checked")
+    parser.add_argument("--threshold", type=float, default=25.0,
+                        help="the slow-down in percent that counts as a regression")
+    parser.add_argument("--filter", default="", help="only compare benchmarks whose name contains this text")
+    args = parser.parse_args()
+
+    try:
+        baseline = load(args.baseline)
+        current = load(args.current)
+    except (OSError, ValueError, KeyError) as error:
+        print("compare_benchmarks: %s" % error, file=sys.stderr)
+        return 2
+
+    regressions = 0
+    print("%-44s %12s %12s %8s" % ("benchmark", "base ns/op", "ns/op", "change"))
+
+    for name in sorted(set(baseline) | set(current)):
+        if args.filter not in name:
+            continue
+        if name not in current:
+            print("%-44s %12.2f %12s %8s" % (name, baseline[name]["ns_per_op"], "-", "removed"))
+            continue
+        if name not in baseline:
+            print("%-44s %12s %12.2f %8s" % (name, "-", current[name]["ns_per_op"], "new"))
+            continue
+
+        before = baseline[name]["ns_per_op"]
+        after = current[name]["ns_per_op"]
+        change = (after - before) * 100.0 / before if before > 0 else 0.0
+        mark = ""
+        if change > args.threshold:
+            mark = "  REGRESSION"
+            regressions += 1
+        print("%-44s %12.2f %12.2f %+7.1f%%%s" % (name, before, after, change, mark))
+
+    if regressions:
+        print("%u benchmark(s) slower than the threshold of %.1f%%" % (regressions, args.threshold))
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,518 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/**
+ * @file main.c
+ * @brief Runs the micro-benchmarks of test/benchmark in a FreeRTOS task, and
+ *        reports the results as a table and optionally as a JSON file.
+ *
+ * Usage: freertos_plus_tcp_benchmark [--json FILE] [--filter TEXT] [--min-time MS]
+ */
+
+/* Standard includes. */
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* FreeRTOS include. */
+#include <FreeRTOS.h>
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+#include "NetworkBufferManagement.h"
+
+#include "benchmark.h"
+
+/* The task that runs the benchmarks needs a large stack for the POSIX port:
+ * the stack of a task is the stack of its thread. */
+#define mainBENCHMARK_STACK_SIZE    ( configMINIMAL_STACK_SIZE * 16U )
+#define mainBENCHMARK_PRIORITY      ( tskIDLE_PRIORITY + 2U )
+
+/* The default minimum duration of one timed run. */
+#define mainDEFAULT_MIN_TIME_MS     50U
+
+/* The time to wait for the IP-task to bring up the end-points. */
+#define mainNETWORK_UP_TIMEOUT_MS    5000U
+
+/*-----------------------------------------------------------*/
+
+static void prvBenchmarkTask( void * pvParameters );
+static void prvAddNetworkInterface( void );
+static BaseType_t prvNullInitialise( NetworkInterface_t * pxInterface );
+static BaseType_t prvNullOutput( NetworkInterface_t * pxInterface,
+                                 NetworkBufferDescriptor_t * const pxNetworkBuffer,
+                                 BaseType_t xReleaseAfterSend );
+static BaseType_t prvNullGetPhyLinkStatus( NetworkInterface_t * pxInterface );
+static uint64_t prvTimeNs( void );
+static BaseType_t prvWriteJSON( const char * pcFileName );
+
+/*-----------------------------------------------------------*/
+
+/* The command line options. */
+static const char * pcJSONFile = NULL;
+static const char * pcFilter = NULL;
+static uint64_t ullMinTimeNs = ( uint64_t ) mainDEFAULT_MIN_TIME_MS * 1000000U;
+
+/* The results, in the order in which the benchmarks were run. */
+static BenchmarkResult_t xResults[ benchmarkMAX_RESULTS ];
+static size_t uxResultCount = 0U;
+
+/* The interface and the end-points that the lookups in benchmark_cases.c
+ * find. The interface sends nothing: the few packets that the IP-task sends
+ * by itself, such as a gratuitous ARP, are dropped. */
+static NetworkInterface_t xInterface;
+static NetworkEndPoint_t xEndPoints[ 2 ];
+
+static const uint8_t ucMACAddress[ 6 ] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+
+#if ( ipconfigUSE_IPv4 != 0 )
+    static const uint8_t ucIPAddress[ 4 ] = { 192, 168, 10, 2 };
+    static const uint8_t ucNetMask[ 4 ] = { 255, 255, 255, 0 };
+    static const uint8_t ucGatewayAddress[ 4 ] = { 192, 168, 10, 1 };
+    static const uint8_t ucDNSServerAddress[ 4 ] = { 192, 168, 10, 1 };
+#endif
+
+/* Written by vBenchmarkConsume(), so that results can not be optimised away. */
+static volatile uintptr_t uxSink;
+
+/* Use by the pseudo random number generator. */
+static UBaseType_t ulNextRand;
+
+/*-----------------------------------------------------------*/
+
+int main( int argc,
+          char ** argv )
+{
+    int iIndex;
+
+    for( iIndex = 1; iIndex < argc; iIndex++ )
+    {
+        if( ( strcmp( argv[ iIndex ], "--json" ) == 0 ) && ( ( iIndex + 1 ) < argc ) )
+        {
+            pcJSONFile = argv[ ++iIndex ];
+        }
+        else if( ( strcmp( argv[ iIndex ], "--filter" ) == 0 ) && ( ( iIndex + 1 ) < argc ) )
+        {
+            pcFilter = argv[ ++iIndex ];
+        }
+        else if( ( strcmp( argv[ iIndex ], "--min-time" ) == 0 ) && ( ( iIndex + 1 ) < argc ) )
+        {
+            ullMinTimeNs = ( uint64_t ) strtoul( argv[ ++iIndex ], NULL, 10 ) * 1000000U;
+        }
+        else
+        {
+            fprintf( stderr, "Usage: %s [--json FILE] [--filter TEXT] [--min-time MS]\n", argv[ 0 ] );
+            return 2;
+        }
+    }
+
+    prvAddNetworkInterface();
+
+    if( FreeRTOS_IPInit_Multi() != pdPASS )
+    {
+        fprintf( stderr, "Can not start the IP-task\n" );
+        return 1;
+    }
+
+    if( xTaskCreate( prvBenchmarkTask, "Benchmark", mainBENCHMARK_STACK_SIZE, NULL, mainBENCHMARK_PRIORITY, NULL ) != pdPASS )
+    {
+        fprintf( stderr, "Can not create the benchmark task\n" );
+        return 1;
+    }
+
+    vTaskStartScheduler();
+
+    /* Only reached when the scheduler could not start. */
+    return 1;
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchmarkTask( void * pvParameters )
+{
+    int iExitCode = 0;
+    TickType_t xWaited = 0U;
+
+    ( void ) pvParameters;
+
+    /* The benchmarks create sockets, which can only be done when the
+     * IP-task is running, and look up the end-points. */
+    while( ( FreeRTOS_IsNetworkUp() == pdFALSE ) && ( xWaited < pdMS_TO_TICKS( mainNETWORK_UP_TIMEOUT_MS ) ) )
+    {
+        vTaskDelay( pdMS_TO_TICKS( 10U ) );
+        xWaited += pdMS_TO_TICKS( 10U );
+    }
+
+    if( FreeRTOS_IsNetworkUp() == pdFALSE )
+    {
+        fprintf( stderr, "The network did not come up\n" );
+        exit( 1 );
+    }
+
+    printf( "%-44s %10s %12s %12s %10s\n", "benchmark", "iterations", "ns/op", "min ns/op", "MB/s" );
+
+    vBenchmarkRunAll();
+
+    if( ( pcJSONFile != NULL ) && ( prvWriteJSON( pcJSONFile ) != pdPASS ) )
+    {
+        fprintf( stderr, "Can not write '%s'\n", pcJSONFile );
+        iExitCode = 1;
+    }
+
+    /* The POSIX port runs every task in a thread of this process: leaving
+     * the process ends the scheduler as well. */
+    fflush( stdout );
+    exit( iExitCode );
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddNetworkInterface( void )
+{
+    xInterface.pcName = "null";
+    xInterface.pfInitialise = prvNullInitialise;
+    xInterface.pfOutput = prvNullOutput;
+    xInterface.pfGetPhyLinkStatus = prvNullGetPhyLinkStatus;
+
+    ( void ) FreeRTOS_AddNetworkInterface( &( xInterface ) );
+
+    #if ( ipconfigUSE_IPv4 != 0 )
+    {
+        FreeRTOS_FillEndPoint( &( xInterface ), &( xEndPoints[ 0 ] ), ucIPAddress, ucNetMask, ucGatewayAddress, ucDNSServerAddress, ucMACAddress );
+    }
+    #endif
+
+    #if ( ipconfigUSE_IPv6 != 0 )
+    {
+        IPv6_Address_t xIPAddress;
+        IPv6_Address_t xPrefix;
+        IPv6_Address_t xGateway;
+        IPv6_Address_t xDNSServer;
+
+        ( void ) FreeRTOS_inet_pton6( "2001:db8::2", xIPAddress.ucBytes );
+        ( void ) FreeRTOS_inet_pton6( "2001:db8::", xPrefix.ucBytes );
+        ( void ) FreeRTOS_inet_pton6( "2001:db8::1", xGateway.ucBytes );
+        ( void ) FreeRTOS_inet_pton6( "2001:db8::1", xDNSServer.ucBytes );
+
+        FreeRTOS_FillEndPoint_IPv6( &( xInterface ), &( xEndPoints[ 1 ] ), &( xIPAddress ), &( xPrefix ), 64U, &( xGateway ), &( xDNSServer ), ucMACAddress );
+    }
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvNullInitialise( NetworkInterface_t * pxInterface )
+{
+    ( void ) pxInterface;
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvNullOutput( NetworkInterface_t * pxInterface,
+                                 NetworkBufferDescriptor_t * const pxNetworkBuffer,
+                                 BaseType_t xReleaseAfterSend )
+{
+    ( void ) pxInterface;
+
+    if( xReleaseAfterSend != pdFALSE )
+    {
+        vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+    }
+
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvNullGetPhyLinkStatus( NetworkInterface_t * pxInterface )
+{
+    ( void ) pxInterface;
+
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvTimeNs( void )
+{
+    struct timespec xNow;
+
+    ( void ) clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+    return ( ( uint64_t ) xNow.tv_sec * 1000000000U ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvTimeRun( BenchmarkFunction_t pxFunction,
+                            void * pvContext,
+                            uint32_t ulIterations )
+{
+    uint64_t ullStart = prvTimeNs();
+
+    pxFunction( pvContext, ulIterations );
+
+    return prvTimeNs() - ullStart;
+}
+/*-----------------------------------------------------------*/
+
+void vBenchmarkRun( BenchmarkFunction_t pxFunction,
+                    void * pvContext,
+                    size_t uxBytesPerOp,
+                    const char * pcNameFormat,
+                    ... )
+{
+    BenchmarkResult_t * pxResult;
+    char cName[ sizeof( pxResult->cName ) ];
+    double dRuns[ benchmarkREPEAT_COUNT ];
+    double dSwap;
+    uint64_t ullTime;
+    uint64_t ullIterations = 1U;
+    size_t uxRun;
+    size_t uxOther;
+    va_list xArgs;
+
+    va_start( xArgs, pcNameFormat );
+    ( void ) vsnprintf( cName, sizeof( cName ), pcNameFormat, xArgs );
+    va_end( xArgs );
+
+    if( ( pcFilter != NULL ) && ( strstr( cName, pcFilter ) == NULL ) )
+    {
+        return;
+    }
+
+    if( uxResultCount >= benchmarkMAX_RESULTS )
+    {
+        fprintf( stderr, "Too many benchmarks, %s is skipped\n", cName );
+        return;
+    }
+
+    /* Warm up the caches, then grow the number of iterations until a run
+     * takes at least the minimum time. */
+    pxFunction( pvContext, 1U );
+
+    for( ; ; )
+    {
+        ullTime = prvTimeRun( pxFunction, pvContext, ( uint32_t ) ullIterations );
+
+        if( ( ullTime >= ullMinTimeNs ) || ( ullIterations >= 0x40000000U ) )
+        {
+            break;
+        }
+
+        if( ullTime < ( ullMinTimeNs / 100U ) )
+        {
+            ullIterations *= 10U;
+        }
+        else
+        {
+            /* Aim a little beyond the minimum, to avoid another round. */
+            ullIterations = ( ( ullIterations * ullMinTimeNs * 6U ) / ( ullTime * 5U ) ) + 1U;
+        }
+    }
+
+    for( uxRun = 0U; uxRun < benchmarkREPEAT_COUNT; uxRun++ )
+    {
+        ullTime = prvTimeRun( pxFunction, pvContext, ( uint32_t ) ullIterations );
+        dRuns[ uxRun ] = ( double ) ullTime / ( double ) ullIterations;
+
+        /* Keep the runs sorted. */
+        for( uxOther = uxRun; ( uxOther > 0U ) && ( dRuns[ uxOther - 1U ] > dRuns[ uxOther ] ); uxOther-- )
+        {
+            dSwap = dRuns[ uxOther - 1U ];
+            dRuns[ uxOther - 1U ] = dRuns[ uxOther ];
+            dRuns[ uxOther ] = dSwap;
+        }
+    }
+
+    pxResult = &( xResults[ uxResultCount ] );
+    uxResultCount++;
+
+    ( void ) memcpy( pxResult->cName, cName, sizeof( pxResult->cName ) );
+    pxResult->ulIterations = ( uint32_t ) ullIterations;
+    pxResult->dMedianNs = dRuns[ benchmarkREPEAT_COUNT / 2U ];
+    pxResult->dMinNs = dRuns[ 0 ];
+    pxResult->uxBytesPerOp = uxBytesPerOp;
+
+    if( uxBytesPerOp != 0U )
+    {
+        printf( "%-44s %10u %12.2f %12.2f %10.1f\n", pxResult->cName, ( unsigned ) pxResult->ulIterations,
+                pxResult->dMedianNs, pxResult->dMinNs, ( ( double ) uxBytesPerOp * 1000.0 ) / pxResult->dMedianNs );
+    }
+    else
+    {
+        printf( "%-44s %10u %12.2f %12.2f %10s\n", pxResult->cName, ( unsigned ) pxResult->ulIterations,
+                pxResult->dMedianNs, pxResult->dMinNs, "-" );
+    }
+
+    fflush( stdout );
+}
+/*-----------------------------------------------------------*/
+
+void vBenchmarkConsume( uintptr_t uxValue )
+{
+    uxSink += uxValue;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvWriteJSON( const char * pcFileName )
+{
+    FILE * pxFile = fopen( pcFileName, "w" );
+    const BenchmarkResult_t * pxResult;
+    size_t uxIndex;
+    BaseType_t xReturn = pdFAIL;
+
+    if( pxFile != NULL )
+    {
+        fprintf( pxFile, "{\n" );
+        fprintf( pxFile, "  \"suite\": \"FreeRTOS-Plus-TCP micro-benchmarks\",\n" );
+        fprintf( pxFile, "  \"version\": 1,\n" );
+        fprintf( pxFile, "  \"stack\": \"%s\",\n", ipFR_TCP_VERSION_NUMBER );
+        fprintf( pxFile, "  \"repeat\": %u,\n", ( unsigned ) benchmarkREPEAT_COUNT );
+        fprintf( pxFile, "  \"min_time_ms\": %u,\n", ( unsigned ) ( ullMinTimeNs / 1000000U ) );
+        fprintf( pxFile, "  \"benchmarks\": [\n" );
+
+        for( uxIndex = 0U; uxIndex < uxResultCount; uxIndex++ )
+        {
+            pxResult = &( xResults[ uxIndex ] );
+
+            /* The names are made of letters, digits, '_' and '/', which need no escaping. */
+            fprintf( pxFile, "    { \"name\": \"%s\", \"iterations\": %u, \"ns_per_op\": %.3f, \"ns_per_op_min\": %.3f",
+                     pxResult->cName, ( unsigned ) pxResult->ulIterations, pxResult->dMedianNs, pxResult->dMinNs );
+
+            if( pxResult->uxBytesPerOp != 0U )
+            {
+                fprintf( pxFile, ", \"bytes_per_op\": %u, \"mb_per_s\": %.1f",
+                         ( unsigned ) pxResult->uxBytesPerOp,
+                         ( ( double ) pxResult->uxBytesPerOp * 1000.0 ) / pxResult->dMedianNs );
+            }
+
+            fprintf( pxFile, " }%s\n", ( ( uxIndex + 1U ) < uxResultCount ) ? "," : "" );
+        }
+
+        fprintf( pxFile, "  ]\n}\n" );
+
+        if( fclose( pxFile ) == 0 )
+        {
+            xReturn = pdPASS;
+        }
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+/* The hooks and call-backs that the kernel and the stack need. */
+
+void vApplicationGetIdleTaskMemory( StaticTask_t ** ppxIdleTaskTCBBuffer,
+                                    StackType_t ** ppxIdleTaskStackBuffer,
+                                    configSTACK_DEPTH_TYPE * pulIdleTaskStackSize )
+{
+    static StaticTask_t xIdleTaskTCB;
+    static StackType_t uxIdleTaskStack[ configMINIMAL_STACK_SIZE ];
+
+    *ppxIdleTaskTCBBuffer = &( xIdleTaskTCB );
+    *ppxIdleTaskStackBuffer = uxIdleTaskStack;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+/*-----------------------------------------------------------*/
+
+void vApplicationGetTimerTaskMemory( StaticTask_t ** ppxTimerTaskTCBBuffer,
+                                     StackType_t ** ppxTimerTaskStackBuffer,
+                                     configSTACK_DEPTH_TYPE * pulTimerTaskStackSize )
+{
+    static StaticTask_t xTimerTaskTCB;
+    static StackType_t uxTimerTaskStack[ configTIMER_TASK_STACK_DEPTH ];
+
+    *ppxTimerTaskTCBBuffer = &( xTimerTaskTCB );
+    *ppxTimerTaskStackBuffer = uxTimerTaskStack;
+    *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+/*-----------------------------------------------------------*/
+
+void vApplicationIdleHook( void )
+{
+    /* Provide a stub for this function. */
+}
+/*-----------------------------------------------------------*/
+
+void vApplicationMallocFailedHook( void )
+{
+    fprintf( stderr, "Out of heap memory\n" );
+    exit( 1 );
+}
+/*-----------------------------------------------------------*/
+
+void vLoggingPrintf( const char * pcFormat,
+                     ... )
+{
+    va_list arg;
+
+    va_start( arg, pcFormat );
+    vprintf( pcFormat, arg );
+    va_end( arg );
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxRand( void )
+{
+    const uint32_t ulMultiplier = 0x015a4e35UL, ulIncrement = 1UL;
+
+    /* Utility function to generate a pseudo random number. */
+
+    ulNextRand = ( ulMultiplier * ulNextRand ) + ulIncrement;
+    return( ( int ) ( ulNextRand ) & 0x7fffUL );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xApplicationGetRandomNumber( uint32_t * pulNumber )
+{
+    *pulNumber = ( uint32_t ) uxRand();
+
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Callback that provides the inputs necessary to generate a randomized TCP
+ * Initial Sequence Number per RFC 6528.  THIS IS ONLY A DUMMY IMPLEMENTATION
+ * THAT RETURNS A PSEUDO RANDOM NUMBER SO IS NOT INTENDED FOR USE IN PRODUCTION
+ * SYSTEMS.
+ */
+uint32_t ulApplicationGetNextSequenceNumber( uint32_t ulSourceAddress,
+                                             uint16_t usSourcePort,
+                                             uint32_t ulDestinationAddress,
+                                             uint16_t usDestinationPort )
+{
+    ( void ) ulSourceAddress;
+    ( void ) usSourcePort;
+    ( void ) ulDestinationAddress;
+    ( void ) usDestinationPort;
+
+    return ( uint32_t ) uxRand();
+}
+/*-----------------------------------------------------------*/
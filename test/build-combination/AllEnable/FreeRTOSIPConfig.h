@@ -245,6 +245,28 @@
 /* USE_WIN: Let TCP use windowing mechanism. */
 #define ipconfigUSE_TCP_WIN                            ( 1 )
 
+/* Use the RFC 6298 retransmission time-out and the TCP Timestamps option. */
+#define ipconfigUSE_TCP_RTO_RFC6298                    ( 1 )
+#define ipconfigUSE_TCP_TIMESTAMP_OPTION               ( 1 )
+#define ipconfigTCP_RX_AUTOTUNE                        ( 1 )
+#define ipconfigTCP_PACING                             ( 1 )
+#define ipconfigTCP_TAIL_LOSS_PROBE                    ( 1 )
+#define ipconfigTCP_SACK_RECOVERY                      ( 1 )
+#define ipconfigTCP_ACCEPT_QUEUE                       ( 1 )
+#define ipconfigUDP_BATCH_CALLS                        ( 1 )
+#define ipconfigSOCKET_IOVEC_CALLS                     ( 1 )
+#define ipconfigUDP_CONNECTED_SOCKETS                  ( 1 )
+#define ipconfigUDP_GSO                                ( 1 )
+#define ipconfigSUPPORT_IP_MULTICAST                   ( 1 )
+#define ipconfigTCP_RX_BUFFER_LENDING                  ( 1 )
+#define ipconfigTCP_TX_BY_REFERENCE                    ( 1 )
+#define ipconfigTCP_INFO                               ( 1 )
+#define ipconfigUSE_MIB_COUNTERS                       ( 1 )
+#define ipconfigUSE_DROP_REASONS                       ( 1 )
+#define ipconfigDROP_CAPTURE_COUNT                     ( 8 )
+#define ipconfigDROP_CAPTURE_SAMPLE_RATE               ( 2 )
+#define ipconfigUSE_IP_TASK_PROFILING                  ( 1 )
+
 /* The MTU is the maximum number of bytes the payload of a network frame can
  * contain.  For normal Ethernet V2 frames the maximum MTU is 1500.  Setting a
  * lower value can save RAM, depending on the buffer management scheme used.  If
@@ -267,6 +289,7 @@
 /* If ipconfigSUPPORT_SELECT_FUNCTION is set to 1 then the FreeRTOS_select()
  * (and associated) API function is available. */
 #define ipconfigSUPPORT_SELECT_FUNCTION                1
+#define ipconfigSELECT_READY_LIST                      1
 
 /* If ipconfigFILTER_OUT_NON_ETHERNET_II_FRAMES is set to 1 then Ethernet frames
  * that are not in Ethernet II format will be dropped.  This option is included for
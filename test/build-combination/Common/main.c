@@ -369,3 +369,11 @@ void vApplicationPingReplyHook( ePingReplyStatus_t eStatus,
         return ( uint32_t ) time( NULL );
     }
 #endif
+
+#if ( ipconfigUSE_IP_TASK_PROFILING == 1 )
+    /* The clock of the IP-task histograms. */
+    uint64_t ullGetHighResolutionTime( void )
+    {
+        return ( uint64_t ) xTaskGetTickCount();
+    }
+#endif
@@ -0,0 +1,246 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mock_task.h"
+
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_Drop.h"
+
+#include "catch_assert.h"
+
+#include "FreeRTOSIPConfig.h"
+
+/* ============================== Test Helpers ============================== */
+
+static uint8_t ucFrame[ ipconfigNETWORK_MTU ];
+static NetworkBufferDescriptor_t xNetworkBuffer;
+
+/* Drop a frame of a given length, whose first byte is ucMarker. */
+static void prvDrop( uint8_t ucMarker,
+                     size_t uxLength,
+                     eIPDropReason_t eReason )
+{
+    ucFrame[ 0 ] = ucMarker;
+    xNetworkBuffer.xDataLength = uxLength;
+
+    vIPDropFrame( &xNetworkBuffer, eReason );
+}
+
+void setUp( void )
+{
+    size_t uxIndex;
+
+    vTaskSuspendAll_Ignore();
+    xTaskResumeAll_IgnoreAndReturn( pdFALSE );
+    xTaskGetTickCount_IgnoreAndReturn( 1234U );
+
+    FreeRTOS_ClearDropCounters();
+
+    for( uxIndex = 0U; uxIndex < sizeof( ucFrame ); uxIndex++ )
+    {
+        ucFrame[ uxIndex ] = ( uint8_t ) uxIndex;
+    }
+
+    memset( &xNetworkBuffer, 0, sizeof( xNetworkBuffer ) );
+    xNetworkBuffer.pucEthernetBuffer = ucFrame;
+}
+
+/* ============================== Test Cases ============================== */
+
+/**
+ * @brief Every drop increments the counter of its reason.
+ */
+void test_vIPDropFrame_Counters( void )
+{
+    DropCounters_t xCounters;
+
+    prvDrop( 1U, 60U, eIPDropChecksum );
+    prvDrop( 2U, 60U, eIPDropChecksum );
+    vIPDropFrame( NULL, eIPDropNoBuffer );
+
+    TEST_ASSERT_EQUAL( pdPASS, FreeRTOS_GetDropCounters( &xCounters ) );
+    TEST_ASSERT_EQUAL_UINT32( 2U, xCounters.ulCounters[ eIPDropChecksum ] );
+    TEST_ASSERT_EQUAL_UINT32( 1U, xCounters.ulCounters[ eIPDropNoBuffer ] );
+    TEST_ASSERT_EQUAL_UINT32( 0U, xCounters.ulCounters[ eIPDropFragment ] );
+}
+
+/**
+ * @brief A reason that is out of range is ignored.
+ */
+void test_vIPDropFrame_InvalidReason( void )
+{
+    DropCounters_t xCounters;
+    DropCounters_t xZero;
+
+    vIPDropFrame( &xNetworkBuffer, eIPDropReasonCount );
+
+    memset( &xZero, 0, sizeof( xZero ) );
+    TEST_ASSERT_EQUAL( pdPASS, FreeRTOS_GetDropCounters( &xCounters ) );
+    TEST_ASSERT_EQUAL_MEMORY( &xZero, &xCounters, sizeof( xCounters ) );
+}
+
+/**
+ * @brief A snapshot needs a place to be written.
+ */
+void test_FreeRTOS_GetDropCounters_NullCounters( void )
+{
+    TEST_ASSERT_EQUAL( pdFAIL, FreeRTOS_GetDropCounters( NULL ) );
+}
+
+/**
+ * @brief Clearing resets the counters and the capture rings.
+ */
+void test_FreeRTOS_ClearDropCounters( void )
+{
+    DropCounters_t xCounters;
+    DroppedFrame_t xFrames[ 2 ];
+
+    prvDrop( 1U, 60U, eIPDropChecksum );
+    FreeRTOS_ClearDropCounters();
+
+    TEST_ASSERT_EQUAL( pdPASS, FreeRTOS_GetDropCounters( &xCounters ) );
+    TEST_ASSERT_EQUAL_UINT32( 0U, xCounters.ulCounters[ eIPDropChecksum ] );
+    TEST_ASSERT_EQUAL( 0U, FreeRTOS_GetDroppedFrames( eIPDropChecksum, xFrames, 2U ) );
+}
+
+/**
+ * @brief A captured frame keeps its original length and at most
+ *        ipconfigDROP_CAPTURE_BYTES of its contents.
+ */
+void test_FreeRTOS_GetDroppedFrames_Truncated( void )
+{
+    DroppedFrame_t xFrames[ 2 ];
+
+    prvDrop( 0xA5U, 60U, eIPDropFragment );
+
+    TEST_ASSERT_EQUAL( 1U, FreeRTOS_GetDroppedFrames( eIPDropFragment, xFrames, 2U ) );
+    TEST_ASSERT_EQUAL( 1234U, xFrames[ 0 ].xTimeStamp );
+    TEST_ASSERT_EQUAL( eIPDropFragment, xFrames[ 0 ].ucReason );
+    TEST_ASSERT_EQUAL( 60U, xFrames[ 0 ].usLength );
+    TEST_ASSERT_EQUAL( ipconfigDROP_CAPTURE_BYTES, xFrames[ 0 ].usCaptured );
+    TEST_ASSERT_EQUAL_MEMORY( ucFrame, xFrames[ 0 ].ucHeader, ipconfigDROP_CAPTURE_BYTES );
+}
+
+/**
+ * @brief A drop without a frame is captured without contents.
+ */
+void test_FreeRTOS_GetDroppedFrames_NoFrame( void )
+{
+    DroppedFrame_t xFrames[ 2 ];
+
+    vIPDropFrame( NULL, eIPDropNoBuffer );
+
+    TEST_ASSERT_EQUAL( 1U, FreeRTOS_GetDroppedFrames( eIPDropNoBuffer, xFrames, 2U ) );
+    TEST_ASSERT_EQUAL( 0U, xFrames[ 0 ].usLength );
+    TEST_ASSERT_EQUAL( 0U, xFrames[ 0 ].usCaptured );
+}
+
+/**
+ * @brief Every reason has its own ring.
+ */
+void test_FreeRTOS_GetDroppedFrames_RingPerReason( void )
+{
+    DroppedFrame_t xFrames[ 2 ];
+
+    prvDrop( 1U, 8U, eIPDropChecksum );
+    prvDrop( 2U, 8U, eIPDropUDPQueueFull );
+
+    TEST_ASSERT_EQUAL( 1U, FreeRTOS_GetDroppedFrames( eIPDropChecksum, xFrames, 2U ) );
+    TEST_ASSERT_EQUAL( 1U, xFrames[ 0 ].ucHeader[ 0 ] );
+    TEST_ASSERT_EQUAL( 8U, xFrames[ 0 ].usCaptured );
+
+    TEST_ASSERT_EQUAL( 1U, FreeRTOS_GetDroppedFrames( eIPDropUDPQueueFull, xFrames, 2U ) );
+    TEST_ASSERT_EQUAL( 2U, xFrames[ 0 ].ucHeader[ 0 ] );
+
+    TEST_ASSERT_EQUAL( 0U, FreeRTOS_GetDroppedFrames( eIPDropFragment, xFrames, 2U ) );
+}
+
+/**
+ * @brief Only one in every ipconfigDROP_CAPTURE_SAMPLE_RATE drops of a reason
+ *        is captured, the oldest entries are overwritten, and the frames are
+ *        returned oldest first.
+ */
+void test_FreeRTOS_GetDroppedFrames_SampledRing( void )
+{
+    DroppedFrame_t xFrames[ 2 ];
+    DropCounters_t xCounters;
+
+    /* Captured: 1, 3 and 5. The other reason has its own count-down. */
+    prvDrop( 1U, 20U, eIPDropChecksum );
+    prvDrop( 2U, 20U, eIPDropChecksum );
+    prvDrop( 9U, 20U, eIPDropTCPRejected );
+    prvDrop( 3U, 20U, eIPDropChecksum );
+    prvDrop( 4U, 20U, eIPDropChecksum );
+    prvDrop( 5U, 20U, eIPDropChecksum );
+
+    TEST_ASSERT_EQUAL( pdPASS, FreeRTOS_GetDropCounters( &xCounters ) );
+    TEST_ASSERT_EQUAL_UINT32( 5U, xCounters.ulCounters[ eIPDropChecksum ] );
+
+    TEST_ASSERT_EQUAL( 2U, FreeRTOS_GetDroppedFrames( eIPDropChecksum, xFrames, 2U ) );
+    TEST_ASSERT_EQUAL( 3U, xFrames[ 0 ].ucHeader[ 0 ] );
+    TEST_ASSERT_EQUAL( 5U, xFrames[ 1 ].ucHeader[ 0 ] );
+
+    TEST_ASSERT_EQUAL( 1U, FreeRTOS_GetDroppedFrames( eIPDropTCPRejected, xFrames, 2U ) );
+    TEST_ASSERT_EQUAL( 9U, xFrames[ 0 ].ucHeader[ 0 ] );
+}
+
+/**
+ * @brief When the caller has less room, the most recent frames are returned.
+ */
+void test_FreeRTOS_GetDroppedFrames_MostRecent( void )
+{
+    DroppedFrame_t xFrames[ 2 ];
+
+    prvDrop( 1U, 20U, eIPDropChecksum );
+    prvDrop( 2U, 20U, eIPDropChecksum );
+    prvDrop( 3U, 20U, eIPDropChecksum );
+
+    TEST_ASSERT_EQUAL( 1U, FreeRTOS_GetDroppedFrames( eIPDropChecksum, xFrames, 1U ) );
+    TEST_ASSERT_EQUAL( 3U, xFrames[ 0 ].ucHeader[ 0 ] );
+}
+
+/**
+ * @brief Invalid parameters return no frames.
+ */
+void test_FreeRTOS_GetDroppedFrames_InvalidParameters( void )
+{
+    DroppedFrame_t xFrames[ 2 ];
+
+    prvDrop( 1U, 20U, eIPDropChecksum );
+
+    TEST_ASSERT_EQUAL( 0U, FreeRTOS_GetDroppedFrames( eIPDropChecksum, NULL, 2U ) );
+    TEST_ASSERT_EQUAL( 0U, FreeRTOS_GetDroppedFrames( eIPDropReasonCount, xFrames, 2U ) );
+}
@@ -0,0 +1,416 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mock_task.h"
+#include "mock_FreeRTOS_IP.h"
+#include "mock_FreeRTOS_IP_Private.h"
+#include "mock_FreeRTOS_IPv4_Utils.h"
+#include "mock_FreeRTOS_IPv6_Utils.h"
+#include "mock_FreeRTOS_Routing.h"
+#include "mock_NetworkBufferManagement.h"
+
+#include "FreeRTOS_IGMP.h"
+
+#include "catch_assert.h"
+
+#include "FreeRTOSIPConfig.h"
+
+/* =========================== EXTERN VARIABLES =========================== */
+
+extern BaseType_t xMulticastTimerActive;
+extern BaseType_t xMulticastTimerEnabled;
+extern BaseType_t xMulticastTimerReloads;
+
+/* ============================== Test Helpers ============================== */
+
+/* 239.1.2.3 and 239.1.2.4 in network byte order. */
+#define igmptestGROUP_A          FreeRTOS_htonl( 0xEF010203UL )
+#define igmptestGROUP_B          FreeRTOS_htonl( 0xEF010204UL )
+
+/* Offsets in a frame that is sent: the IP-header has a Router Alert option. */
+#define igmptestTX_DESTINATION   ( ipSIZE_OF_ETH_HEADER + 16U )
+#define igmptestTX_IGMP          ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + 4U )
+
+/* Offset of the IGMP message in a frame that is received. */
+#define igmptestRX_IGMP          ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER )
+
+static NetworkInterface_t xInterface;
+static NetworkEndPoint_t xEndPoint;
+static FreeRTOS_Socket_t xSocket1;
+static FreeRTOS_Socket_t xSocket2;
+
+static uint8_t ucTxFrame[ ipconfigNETWORK_MTU ];
+static NetworkBufferDescriptor_t xTxBuffer;
+
+static uint8_t ucRxFrame[ ipconfigNETWORK_MTU ];
+static NetworkBufferDescriptor_t xRxBuffer;
+
+/* The number of frames that were passed to the network interface. */
+static BaseType_t xFramesSent;
+
+static BaseType_t prvOutput( struct xNetworkInterface * pxDescriptor,
+                             NetworkBufferDescriptor_t * const pxNetworkBuffer,
+                             BaseType_t xReleaseAfterSend )
+{
+    TEST_ASSERT_EQUAL_PTR( &xInterface, pxDescriptor );
+    TEST_ASSERT_EQUAL_PTR( &xTxBuffer, pxNetworkBuffer );
+    TEST_ASSERT_EQUAL( pdTRUE, xReleaseAfterSend );
+    xFramesSent++;
+
+    return pdTRUE;
+}
+
+/* Let a socket join or leave a group, as the API does. */
+static BaseType_t prvRequest( const FreeRTOS_Socket_t * pxSocket,
+                              uint32_t ulGroup,
+                              BaseType_t xJoin )
+{
+    IP_Address_t xGroup;
+
+    memset( &xGroup, 0, sizeof( xGroup ) );
+    xGroup.ulIP_IPv4 = ulGroup;
+
+    return xMulticastMembershipRequest( pxSocket, &xGroup, pdFALSE, &xInterface, xJoin );
+}
+
+/* The next report will be written in xTxBuffer. */
+static void prvExpectFrame( void )
+{
+    memset( ucTxFrame, 0, sizeof( ucTxFrame ) );
+    pxGetNetworkBufferWithDescriptor_ExpectAnyArgsAndReturn( &xTxBuffer );
+}
+
+/* Join a group and let the IP-task send the first report. */
+static void prvJoinGroup( const FreeRTOS_Socket_t * pxSocket,
+                          uint32_t ulGroup )
+{
+    xSendEventToIPTask_ExpectAndReturn( eMulticastGroupEvent, pdPASS );
+    TEST_ASSERT_EQUAL( 0, prvRequest( pxSocket, ulGroup, pdTRUE ) );
+
+    prvExpectFrame();
+    vMulticastProcessRequests();
+}
+
+/* Receive an IGMP message of a given length. */
+static eFrameProcessingResult_t prvReceive( uint8_t ucType,
+                                            uint8_t ucCode,
+                                            uint32_t ulGroup,
+                                            size_t uxIGMPLength )
+{
+    IPHeader_t * pxIPHeader = ( IPHeader_t * ) &( ucRxFrame[ ipSIZE_OF_ETH_HEADER ] );
+
+    memset( ucRxFrame, 0, sizeof( ucRxFrame ) );
+    pxIPHeader->usLength = FreeRTOS_htons( ( uint16_t ) ( ipSIZE_OF_IPv4_HEADER + uxIGMPLength ) );
+    ucRxFrame[ igmptestRX_IGMP ] = ucType;
+    ucRxFrame[ igmptestRX_IGMP + 1U ] = ucCode;
+    memcpy( &( ucRxFrame[ igmptestRX_IGMP + 4U ] ), &( ulGroup ), sizeof( ulGroup ) );
+    xRxBuffer.xDataLength = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + uxIGMPLength;
+
+    return eProcessIGMPPacket( &xRxBuffer );
+}
+
+/* Check the type and the destination of the report in xTxBuffer. */
+static void prvCheckFrame( uint8_t ucType,
+                           uint32_t ulDestination )
+{
+    uint32_t ulSentTo;
+
+    memcpy( &( ulSentTo ), &( ucTxFrame[ igmptestTX_DESTINATION ] ), sizeof( ulSentTo ) );
+    TEST_ASSERT_EQUAL_HEX8( ucType, ucTxFrame[ igmptestTX_IGMP ] );
+    TEST_ASSERT_EQUAL_HEX32( ulDestination, ulSentTo );
+}
+
+void setUp( void )
+{
+    memset( &xInterface, 0, sizeof( xInterface ) );
+    memset( &xEndPoint, 0, sizeof( xEndPoint ) );
+    memset( &xTxBuffer, 0, sizeof( xTxBuffer ) );
+    memset( &xRxBuffer, 0, sizeof( xRxBuffer ) );
+
+    xInterface.pfOutput = prvOutput;
+    xEndPoint.pxNetworkInterface = &xInterface;
+    xEndPoint.ipv4_settings.ulIPAddress = FreeRTOS_htonl( 0xC0A80102UL );
+    xTxBuffer.pucEthernetBuffer = ucTxFrame;
+    xRxBuffer.pucEthernetBuffer = ucRxFrame;
+    xRxBuffer.pxInterface = &xInterface;
+    xFramesSent = 0;
+
+    vTaskSuspendAll_Ignore();
+    xTaskResumeAll_IgnoreAndReturn( pdFALSE );
+    FreeRTOS_FirstEndPoint_IgnoreAndReturn( &xEndPoint );
+    vSetMultiCastIPv4MacAddress_Ignore();
+    usGenerateChecksum_IgnoreAndReturn( 0U );
+    xApplicationGetRandomNumber_IgnoreAndReturn( pdFALSE );
+}
+
+void tearDown( void )
+{
+    /* Leave all groups silently, the table is shared by the tests. */
+    FreeRTOS_FirstEndPoint_IgnoreAndReturn( NULL );
+    vMulticastSocketClose( &xSocket1 );
+    vMulticastSocketClose( &xSocket2 );
+
+    xMulticastTimerActive = pdFALSE;
+    xMulticastTimerEnabled = pdFALSE;
+    xMulticastTimerReloads = 0;
+}
+
+/* ============================== Test Cases ============================== */
+
+/**
+ * @brief A socket can join a group only once.
+ */
+void test_xMulticastMembershipRequest_JoinTwice( void )
+{
+    xSendEventToIPTask_ExpectAndReturn( eMulticastGroupEvent, pdPASS );
+    TEST_ASSERT_EQUAL( 0, prvRequest( &xSocket1, igmptestGROUP_A, pdTRUE ) );
+
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EADDRINUSE, prvRequest( &xSocket1, igmptestGROUP_A, pdTRUE ) );
+}
+
+/**
+ * @brief A group that was not joined can not be left.
+ */
+void test_xMulticastMembershipRequest_LeaveUnknownGroup( void )
+{
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EADDRNOTAVAIL, prvRequest( &xSocket1, igmptestGROUP_A, pdFALSE ) );
+}
+
+/**
+ * @brief The number of memberships is limited.
+ */
+void test_xMulticastMembershipRequest_TableFull( void )
+{
+    uint32_t ulGroup;
+    size_t uxIndex;
+
+    for( uxIndex = 0U; uxIndex < ( size_t ) ipconfigMULTICAST_MAX_MEMBERSHIPS; uxIndex++ )
+    {
+        ulGroup = FreeRTOS_htonl( 0xEF010200UL + uxIndex );
+        xSendEventToIPTask_ExpectAndReturn( eMulticastGroupEvent, pdPASS );
+        TEST_ASSERT_EQUAL( 0, prvRequest( &xSocket1, ulGroup, pdTRUE ) );
+    }
+
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_ENOMEM, prvRequest( &xSocket2, igmptestGROUP_A, pdTRUE ) );
+}
+
+/**
+ * @brief A join is undone when the IP-task can not be reached.
+ */
+void test_xMulticastMembershipRequest_IPTaskNotReached( void )
+{
+    xSendEventToIPTask_ExpectAndReturn( eMulticastGroupEvent, pdFAIL );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_ENOBUFS, prvRequest( &xSocket1, igmptestGROUP_A, pdTRUE ) );
+
+    /* The entry was released, so the group can be joined again. */
+    xSendEventToIPTask_ExpectAndReturn( eMulticastGroupEvent, pdPASS );
+    TEST_ASSERT_EQUAL( 0, prvRequest( &xSocket1, igmptestGROUP_A, pdTRUE ) );
+}
+
+/**
+ * @brief Without an older querier, a join is announced with an IGMPv3 report.
+ */
+void test_vMulticastProcessRequests_JoinSendsV3Report( void )
+{
+    uint32_t ulGroup = igmptestGROUP_A;
+
+    prvJoinGroup( &xSocket1, igmptestGROUP_A );
+
+    TEST_ASSERT_EQUAL( 1, xFramesSent );
+    prvCheckFrame( ipIGMP_V3_MEMBERSHIP_REPORT, FreeRTOS_htonl( 0xE0000016UL ) );
+    /* One record: CHANGE_TO_EXCLUDE_MODE for the group. */
+    TEST_ASSERT_EQUAL( 1U, ucTxFrame[ igmptestTX_IGMP + 7U ] );
+    TEST_ASSERT_EQUAL( 4U, ucTxFrame[ igmptestTX_IGMP + 8U ] );
+    TEST_ASSERT_EQUAL_MEMORY( &( ulGroup ), &( ucTxFrame[ igmptestTX_IGMP + 12U ] ), sizeof( ulGroup ) );
+
+    /* The second unsolicited report is pending. */
+    TEST_ASSERT_EQUAL( pdTRUE, xMulticastTimerEnabled );
+}
+
+/**
+ * @brief Only the first socket that joins a group sends reports.
+ */
+void test_vMulticastProcessRequests_SecondMemberIsSilent( void )
+{
+    prvJoinGroup( &xSocket1, igmptestGROUP_A );
+
+    xSendEventToIPTask_ExpectAndReturn( eMulticastGroupEvent, pdPASS );
+    TEST_ASSERT_EQUAL( 0, prvRequest( &xSocket2, igmptestGROUP_A, pdTRUE ) );
+    vMulticastProcessRequests();
+
+    /* Leaving is silent as well while the other socket is a member. */
+    xSendEventToIPTask_ExpectAndReturn( eMulticastGroupEvent, pdPASS );
+    TEST_ASSERT_EQUAL( 0, prvRequest( &xSocket1, igmptestGROUP_A, pdFALSE ) );
+    vMulticastProcessRequests();
+
+    TEST_ASSERT_EQUAL( 1, xFramesSent );
+}
+
+/**
+ * @brief An IGMPv2 query is answered with an IGMPv2 report, and the group
+ *        is left with a leave message to all routers.
+ */
+void test_eProcessIGMPPacket_V2Query( void )
+{
+    prvJoinGroup( &xSocket1, igmptestGROUP_A );
+
+    TEST_ASSERT_EQUAL( eReleaseBuffer, prvReceive( ipIGMP_MEMBERSHIP_QUERY, 10U, 0U, 8U ) );
+
+    /* The random delay is one timer period. */
+    prvExpectFrame();
+    vMulticastTimerExpired();
+    prvCheckFrame( ipIGMP_V2_MEMBERSHIP_REPORT, igmptestGROUP_A );
+
+    xSendEventToIPTask_ExpectAndReturn( eMulticastGroupEvent, pdPASS );
+    TEST_ASSERT_EQUAL( 0, prvRequest( &xSocket1, igmptestGROUP_A, pdFALSE ) );
+    prvExpectFrame();
+    vMulticastProcessRequests();
+    prvCheckFrame( ipIGMP_LEAVE_GROUP, FreeRTOS_htonl( 0xE0000002UL ) );
+
+    TEST_ASSERT_EQUAL( 3, xFramesSent );
+}
+
+/**
+ * @brief An IGMPv1 query, with a maximum response time of zero, is answered
+ *        with an IGMPv1 report, and the group is left without a message.
+ */
+void test_eProcessIGMPPacket_V1Query( void )
+{
+    prvJoinGroup( &xSocket1, igmptestGROUP_A );
+
+    TEST_ASSERT_EQUAL( eReleaseBuffer, prvReceive( ipIGMP_MEMBERSHIP_QUERY, 0U, 0U, 8U ) );
+
+    prvExpectFrame();
+    vMulticastTimerExpired();
+    prvCheckFrame( ipIGMP_V1_MEMBERSHIP_REPORT, igmptestGROUP_A );
+    /* An IGMPv1 report has no maximum response time. */
+    TEST_ASSERT_EQUAL( 0U, ucTxFrame[ igmptestTX_IGMP + 1U ] );
+
+    /* IGMPv1 has no leave message. */
+    xSendEventToIPTask_ExpectAndReturn( eMulticastGroupEvent, pdPASS );
+    TEST_ASSERT_EQUAL( 0, prvRequest( &xSocket1, igmptestGROUP_A, pdFALSE ) );
+    vMulticastProcessRequests();
+
+    TEST_ASSERT_EQUAL( 2, xFramesSent );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EADDRNOTAVAIL, prvRequest( &xSocket1, igmptestGROUP_A, pdFALSE ) );
+}
+
+/**
+ * @brief A group that is joined while an IGMPv1 querier is present on the
+ *        link is announced with an IGMPv1 report.
+ */
+void test_eProcessIGMPPacket_V1QuerierAppliesToNewGroups( void )
+{
+    prvJoinGroup( &xSocket1, igmptestGROUP_A );
+
+    TEST_ASSERT_EQUAL( eReleaseBuffer, prvReceive( ipIGMP_MEMBERSHIP_QUERY, 0U, igmptestGROUP_A, 8U ) );
+
+    prvJoinGroup( &xSocket2, igmptestGROUP_B );
+    prvCheckFrame( ipIGMP_V1_MEMBERSHIP_REPORT, igmptestGROUP_B );
+}
+
+/**
+ * @brief After the Older Version Querier Present timeout, IGMPv3 is used
+ *        again.
+ */
+void test_vMulticastTimerExpired_V1QuerierTimesOut( void )
+{
+    size_t uxCount;
+
+    prvJoinGroup( &xSocket1, igmptestGROUP_A );
+
+    TEST_ASSERT_EQUAL( eReleaseBuffer, prvReceive( ipIGMP_MEMBERSHIP_QUERY, 0U, 0U, 8U ) );
+
+    /* The remaining unsolicited report also answers the query. */
+    prvExpectFrame();
+
+    for( uxCount = 0U; uxCount < 2600U; uxCount++ )
+    {
+        vMulticastTimerExpired();
+    }
+
+    TEST_ASSERT_EQUAL( 2, xFramesSent );
+    TEST_ASSERT_EQUAL( pdFALSE, xMulticastTimerEnabled );
+
+    xSendEventToIPTask_ExpectAndReturn( eMulticastGroupEvent, pdPASS );
+    TEST_ASSERT_EQUAL( 0, prvRequest( &xSocket1, igmptestGROUP_A, pdFALSE ) );
+    prvExpectFrame();
+    vMulticastProcessRequests();
+    prvCheckFrame( ipIGMP_V3_MEMBERSHIP_REPORT, FreeRTOS_htonl( 0xE0000016UL ) );
+    /* One record: CHANGE_TO_INCLUDE_MODE for the group. */
+    TEST_ASSERT_EQUAL( 3U, ucTxFrame[ igmptestTX_IGMP + 8U ] );
+}
+
+/**
+ * @brief While an IGMPv2 querier is present, a report of another host makes
+ *        our own report unnecessary.
+ */
+void test_eProcessIGMPPacket_ReportOfOtherHost( void )
+{
+    size_t uxCount;
+
+    prvJoinGroup( &xSocket1, igmptestGROUP_A );
+
+    /* Send the remaining unsolicited report first. */
+    prvExpectFrame();
+
+    for( uxCount = 0U; uxCount < 10U; uxCount++ )
+    {
+        vMulticastTimerExpired();
+    }
+
+    TEST_ASSERT_EQUAL( eReleaseBuffer, prvReceive( ipIGMP_MEMBERSHIP_QUERY, 10U, 0U, 8U ) );
+    TEST_ASSERT_EQUAL( eReleaseBuffer, prvReceive( ipIGMP_V2_MEMBERSHIP_REPORT, 0U, igmptestGROUP_A, 8U ) );
+
+    vMulticastTimerExpired();
+
+    TEST_ASSERT_EQUAL( 2, xFramesSent );
+}
+
+/**
+ * @brief A message that is shorter than its IP-header claims is dropped.
+ */
+void test_eProcessIGMPPacket_Truncated( void )
+{
+    prvJoinGroup( &xSocket1, igmptestGROUP_A );
+
+    xRxBuffer.xDataLength = 0U;
+    TEST_ASSERT_EQUAL( eReleaseBuffer, eProcessIGMPPacket( &xRxBuffer ) );
+
+    vMulticastTimerExpired();
+
+    TEST_ASSERT_EQUAL( 1, xFramesSent );
+}
@@ -1118,7 +1118,7 @@ void test_prvProcessIPEventsAndTimers_Error( void )
 
     xNetworkDownEventPending = pdFALSE;
 
-    xReceivedEvent.eEventType = eSocketSetDeleteEvent + 1;
+    xReceivedEvent.eEventType = eSocketUDPHeaderEvent + 1;
 
     /* prvProcessIPEventsAndTimers */
     vCheckNetworkTimers_Expect();
@@ -0,0 +1,243 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mock_task.h"
+
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_IP_Profiling.h"
+
+#include "catch_assert.h"
+
+#include "FreeRTOSIPConfig.h"
+
+/* ============================== Test Helpers ============================== */
+
+/* The time returned by the profiling clock, see the stubs. */
+extern uint64_t ullTestTime;
+
+/* Let the IP-task spend ullDuration on an event of type eEventType. */
+static void prvProcess( eIPEvent_t eEventType,
+                        uint64_t ullDuration )
+{
+    ullTestTime = 1000U + ullDuration;
+    vIPTaskProfileProcessing( eEventType, 1000U );
+}
+
+/* Get a snapshot of the histograms. */
+static void prvGetProfile( IPTaskProfile_t * pxProfile )
+{
+    TEST_ASSERT_EQUAL( pdPASS, FreeRTOS_GetIPTaskProfile( pxProfile ) );
+}
+
+void setUp( void )
+{
+    vTaskSuspendAll_Ignore();
+    xTaskResumeAll_IgnoreAndReturn( pdFALSE );
+
+    FreeRTOS_ClearIPTaskProfile();
+    ullTestTime = 0U;
+}
+
+/* ============================== Test Cases ============================== */
+
+/**
+ * @brief A duration is counted in the bucket of its number of significant
+ *        bits, and the last bucket also counts all longer durations.
+ */
+void test_vIPTaskProfileProcessing_Buckets( void )
+{
+    static IPTaskProfile_t xProfile;
+    const IPTaskHistogram_t * pxHistogram = &( xProfile.xProcessing[ eNetworkRxEvent + 1 ] );
+
+    prvProcess( eNetworkRxEvent, 0U );
+    prvProcess( eNetworkRxEvent, 1U );
+    prvProcess( eNetworkRxEvent, 2U );
+    prvProcess( eNetworkRxEvent, 3U );
+    prvProcess( eNetworkRxEvent, 4U );
+    prvProcess( eNetworkRxEvent, 7U );
+    prvProcess( eNetworkRxEvent, 8U );
+    prvProcess( eNetworkRxEvent, 0x100000000ULL );
+
+    prvGetProfile( &xProfile );
+
+    TEST_ASSERT_EQUAL_UINT32( 8U, pxHistogram->ulCount );
+    TEST_ASSERT_EQUAL_UINT64( 0x100000000ULL + 25U, pxHistogram->ullTotal );
+    TEST_ASSERT_EQUAL_UINT64( 0x100000000ULL, pxHistogram->ullMax );
+    TEST_ASSERT_EQUAL_UINT32( 1U, pxHistogram->ulBuckets[ 0 ] );
+    TEST_ASSERT_EQUAL_UINT32( 1U, pxHistogram->ulBuckets[ 1 ] );
+    TEST_ASSERT_EQUAL_UINT32( 2U, pxHistogram->ulBuckets[ 2 ] );
+    TEST_ASSERT_EQUAL_UINT32( 4U, pxHistogram->ulBuckets[ ipconfigIP_TASK_PROFILING_BUCKETS - 1 ] );
+}
+
+/**
+ * @brief The maximum is not lowered by a shorter duration.
+ */
+void test_vIPTaskProfileProcessing_KeepsMax( void )
+{
+    static IPTaskProfile_t xProfile;
+
+    prvProcess( eStackTxEvent, 6U );
+    prvProcess( eStackTxEvent, 5U );
+
+    prvGetProfile( &xProfile );
+
+    TEST_ASSERT_EQUAL_UINT32( 2U, xProfile.xProcessing[ eStackTxEvent + 1 ].ulCount );
+    TEST_ASSERT_EQUAL_UINT64( 6U, xProfile.xProcessing[ eStackTxEvent + 1 ].ullMax );
+}
+
+/**
+ * @brief Every event type has its own histogram, eNoEvent included, and an
+ *        unknown type is ignored.
+ */
+void test_vIPTaskProfileProcessing_EventTypes( void )
+{
+    static IPTaskProfile_t xProfile;
+    static IPTaskProfile_t xExpected;
+
+    prvProcess( eNoEvent, 1U );
+    prvProcess( eSocketUDPHeaderEvent, 2U );
+    prvProcess( ( eIPEvent_t ) ( eSocketUDPHeaderEvent + 1 ), 2U );
+    prvProcess( ( eIPEvent_t ) -2, 2U );
+
+    memset( &xExpected, 0, sizeof( xExpected ) );
+    xExpected.xProcessing[ 0 ].ulCount = 1U;
+    xExpected.xProcessing[ 0 ].ullTotal = 1U;
+    xExpected.xProcessing[ 0 ].ullMax = 1U;
+    xExpected.xProcessing[ 0 ].ulBuckets[ 1 ] = 1U;
+    xExpected.xProcessing[ ipIP_TASK_PROFILE_EVENT_COUNT - 1U ].ulCount = 1U;
+    xExpected.xProcessing[ ipIP_TASK_PROFILE_EVENT_COUNT - 1U ].ullTotal = 2U;
+    xExpected.xProcessing[ ipIP_TASK_PROFILE_EVENT_COUNT - 1U ].ullMax = 2U;
+    xExpected.xProcessing[ ipIP_TASK_PROFILE_EVENT_COUNT - 1U ].ulBuckets[ 2 ] = 1U;
+
+    prvGetProfile( &xProfile );
+
+    TEST_ASSERT_EQUAL_MEMORY( &xExpected, &xProfile, sizeof( xProfile ) );
+}
+
+/**
+ * @brief The time between posting and receiving an event is counted.
+ */
+void test_vIPTaskProfileQueueWait_Stamped( void )
+{
+    static IPTaskProfile_t xProfile;
+    IPStackEvent_t xEvent;
+
+    xEvent.eEventType = eTCPTimerEvent;
+    xEvent.pvData = NULL;
+    xEvent.ullPostTime = 500U;
+
+    vIPTaskProfileQueueWait( &xEvent, 503U );
+
+    prvGetProfile( &xProfile );
+
+    TEST_ASSERT_EQUAL_UINT32( 1U, xProfile.xQueueWait[ eTCPTimerEvent + 1 ].ulCount );
+    TEST_ASSERT_EQUAL_UINT64( 3U, xProfile.xQueueWait[ eTCPTimerEvent + 1 ].ullTotal );
+    TEST_ASSERT_EQUAL_UINT32( 1U, xProfile.xQueueWait[ eTCPTimerEvent + 1 ].ulBuckets[ 2 ] );
+    TEST_ASSERT_EQUAL_UINT32( 0U, xProfile.xProcessing[ eTCPTimerEvent + 1 ].ulCount );
+}
+
+/**
+ * @brief An event without a time stamp, or one that seems to be received
+ *        before it was posted, is ignored.
+ */
+void test_vIPTaskProfileQueueWait_Ignored( void )
+{
+    static IPTaskProfile_t xProfile;
+    static IPTaskProfile_t xZero;
+    IPStackEvent_t xEvent;
+
+    xEvent.eEventType = eNetworkRxEvent;
+    xEvent.pvData = NULL;
+    xEvent.ullPostTime = 0U;
+    vIPTaskProfileQueueWait( &xEvent, 503U );
+
+    xEvent.ullPostTime = 504U;
+    vIPTaskProfileQueueWait( &xEvent, 503U );
+
+    xEvent.eEventType = ( eIPEvent_t ) ( eSocketUDPHeaderEvent + 1 );
+    xEvent.ullPostTime = 500U;
+    vIPTaskProfileQueueWait( &xEvent, 503U );
+
+    memset( &xZero, 0, sizeof( xZero ) );
+    prvGetProfile( &xProfile );
+
+    TEST_ASSERT_EQUAL_MEMORY( &xZero, &xProfile, sizeof( xProfile ) );
+}
+
+/**
+ * @brief The time spent checking the network timers has its own histogram.
+ */
+void test_vIPTaskProfileTimerCheck( void )
+{
+    static IPTaskProfile_t xProfile;
+
+    ullTestTime = 2000U;
+    vIPTaskProfileTimerCheck( 1999U );
+
+    prvGetProfile( &xProfile );
+
+    TEST_ASSERT_EQUAL_UINT32( 1U, xProfile.xTimerCheck.ulCount );
+    TEST_ASSERT_EQUAL_UINT64( 1U, xProfile.xTimerCheck.ullMax );
+    TEST_ASSERT_EQUAL_UINT32( 1U, xProfile.xTimerCheck.ulBuckets[ 1 ] );
+}
+
+/**
+ * @brief A snapshot needs a place to be written.
+ */
+void test_FreeRTOS_GetIPTaskProfile_NullProfile( void )
+{
+    TEST_ASSERT_EQUAL( pdFAIL, FreeRTOS_GetIPTaskProfile( NULL ) );
+}
+
+/**
+ * @brief Clearing resets all histograms.
+ */
+void test_FreeRTOS_ClearIPTaskProfile( void )
+{
+    static IPTaskProfile_t xProfile;
+    static IPTaskProfile_t xZero;
+
+    prvProcess( eNetworkRxEvent, 5U );
+    ullTestTime = 10U;
+    vIPTaskProfileTimerCheck( 1U );
+
+    FreeRTOS_ClearIPTaskProfile();
+
+    memset( &xZero, 0, sizeof( xZero ) );
+    prvGetProfile( &xProfile );
+
+    TEST_ASSERT_EQUAL_MEMORY( &xZero, &xProfile, sizeof( xProfile ) );
+}
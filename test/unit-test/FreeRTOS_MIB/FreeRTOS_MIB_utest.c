@@ -0,0 +1,307 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mock_task.h"
+#include "mock_FreeRTOS_Routing.h"
+
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_MIB.h"
+
+#include "catch_assert.h"
+
+#include "FreeRTOSIPConfig.h"
+
+/* =========================== EXTERN VARIABLES =========================== */
+
+extern MIBCounters_t xGlobalMIB;
+extern MIBCounters_t xFromTaskMIB;
+
+/* ============================== Test Helpers ============================== */
+
+static NetworkInterface_t xInterface;
+static NetworkEndPoint_t xEndPoint;
+
+static uint8_t ucFrame[ ipconfigNETWORK_MTU ];
+static NetworkBufferDescriptor_t xNetworkBuffer;
+
+/* Prepare xNetworkBuffer to carry an IPv4 packet of the given protocol. */
+static IPPacket_t * prvIPv4Packet( uint8_t ucProtocol,
+                                   size_t uxLength )
+{
+    IPPacket_t * pxIPPacket = ( IPPacket_t * ) ucFrame;
+
+    pxIPPacket->xEthernetHeader.usFrameType = ipIPv4_FRAME_TYPE;
+    pxIPPacket->xIPHeader.ucVersionHeaderLength = ipIPV4_VERSION_HEADER_LENGTH_MIN;
+    pxIPPacket->xIPHeader.ucProtocol = ucProtocol;
+    xNetworkBuffer.xDataLength = uxLength;
+
+    return pxIPPacket;
+}
+
+/* Take a snapshot of the counters of the whole stack, with one interface
+ * that has one end-point. */
+static void prvGetStackCounters( MIBCounters_t * pxCounters )
+{
+    vTaskSuspendAll_Expect();
+    FreeRTOS_FirstNetworkInterface_ExpectAndReturn( &xInterface );
+    FreeRTOS_NextNetworkInterface_ExpectAndReturn( &xInterface, NULL );
+    FreeRTOS_FirstEndPoint_ExpectAndReturn( NULL, &xEndPoint );
+    FreeRTOS_NextEndPoint_ExpectAndReturn( NULL, &xEndPoint, NULL );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    TEST_ASSERT_EQUAL( pdPASS, FreeRTOS_GetMIBCounters( NULL, NULL, pxCounters ) );
+}
+
+void setUp( void )
+{
+    memset( &xGlobalMIB, 0, sizeof( xGlobalMIB ) );
+    memset( &xFromTaskMIB, 0, sizeof( xFromTaskMIB ) );
+    memset( &xInterface, 0, sizeof( xInterface ) );
+    memset( &xEndPoint, 0, sizeof( xEndPoint ) );
+    memset( ucFrame, 0, sizeof( ucFrame ) );
+    memset( &xNetworkBuffer, 0, sizeof( xNetworkBuffer ) );
+
+    xEndPoint.pxNetworkInterface = &xInterface;
+    xNetworkBuffer.pucEthernetBuffer = ucFrame;
+}
+
+/* ============================== Test Cases ============================== */
+
+/**
+ * @brief An event is counted in the end-point when it is known.
+ */
+void test_vMIBCount_EndPoint( void )
+{
+    vMIBCount( &xInterface, &xEndPoint, eMIBIpInReceives );
+
+    TEST_ASSERT_EQUAL_UINT32( 1U, xEndPoint.xMIB.ulCounters[ eMIBIpInReceives ] );
+    TEST_ASSERT_EQUAL_UINT32( 0U, xInterface.xMIB.ulCounters[ eMIBIpInReceives ] );
+    TEST_ASSERT_EQUAL_UINT32( 0U, xGlobalMIB.ulCounters[ eMIBIpInReceives ] );
+}
+
+/**
+ * @brief Without an end-point, an event is counted in the interface.
+ */
+void test_vMIBCount_Interface( void )
+{
+    vMIBCount( &xInterface, NULL, eMIBIpInReceives );
+
+    TEST_ASSERT_EQUAL_UINT32( 0U, xEndPoint.xMIB.ulCounters[ eMIBIpInReceives ] );
+    TEST_ASSERT_EQUAL_UINT32( 1U, xInterface.xMIB.ulCounters[ eMIBIpInReceives ] );
+    TEST_ASSERT_EQUAL_UINT32( 0U, xGlobalMIB.ulCounters[ eMIBIpInReceives ] );
+}
+
+/**
+ * @brief Without an interface or an end-point, an event is counted stack-wide.
+ */
+void test_vMIBCount_Global( void )
+{
+    vMIBCount( NULL, NULL, eMIBIpOutNoRoutes );
+
+    TEST_ASSERT_EQUAL_UINT32( 0U, xInterface.xMIB.ulCounters[ eMIBIpOutNoRoutes ] );
+    TEST_ASSERT_EQUAL_UINT32( 1U, xGlobalMIB.ulCounters[ eMIBIpOutNoRoutes ] );
+}
+
+/**
+ * @brief Events counted by other tasks only show up in the stack-wide snapshot.
+ */
+void test_vMIBCountFromTask( void )
+{
+    MIBCounters_t xCounters;
+
+    vMIBCountFromTask( eMIBIpInDiscards );
+    vMIBCountFromTask( eMIBIpInDiscards );
+
+    TEST_ASSERT_EQUAL_UINT32( 2U, xFromTaskMIB.ulCounters[ eMIBIpInDiscards ] );
+    TEST_ASSERT_EQUAL_UINT32( 0U, xGlobalMIB.ulCounters[ eMIBIpInDiscards ] );
+
+    prvGetStackCounters( &xCounters );
+    TEST_ASSERT_EQUAL_UINT32( 2U, xCounters.ulCounters[ eMIBIpInDiscards ] );
+
+    vTaskSuspendAll_Expect();
+    FreeRTOS_FirstEndPoint_ExpectAndReturn( &xInterface, &xEndPoint );
+    FreeRTOS_NextEndPoint_ExpectAndReturn( &xInterface, &xEndPoint, NULL );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    TEST_ASSERT_EQUAL( pdPASS, FreeRTOS_GetMIBCounters( &xInterface, NULL, &xCounters ) );
+    TEST_ASSERT_EQUAL_UINT32( 0U, xCounters.ulCounters[ eMIBIpInDiscards ] );
+}
+
+/**
+ * @brief A checksum error is counted in general and per protocol.
+ */
+void test_vMIBCountChecksumError( void )
+{
+    xNetworkBuffer.pxInterface = &xInterface;
+    xNetworkBuffer.pxEndPoint = &xEndPoint;
+
+    vMIBCountChecksumError( &xNetworkBuffer, ipPROTOCOL_ICMP );
+    vMIBCountChecksumError( &xNetworkBuffer, ipPROTOCOL_ICMP_IPv6 );
+    vMIBCountChecksumError( &xNetworkBuffer, ipPROTOCOL_UDP );
+    vMIBCountChecksumError( &xNetworkBuffer, ipPROTOCOL_TCP );
+    vMIBCountChecksumError( &xNetworkBuffer, 0U );
+
+    TEST_ASSERT_EQUAL_UINT32( 5U, xEndPoint.xMIB.ulCounters[ eMIBInCsumErrors ] );
+    TEST_ASSERT_EQUAL_UINT32( 2U, xEndPoint.xMIB.ulCounters[ eMIBIcmpInErrors ] );
+    TEST_ASSERT_EQUAL_UINT32( 1U, xEndPoint.xMIB.ulCounters[ eMIBUdpInErrors ] );
+    TEST_ASSERT_EQUAL_UINT32( 1U, xEndPoint.xMIB.ulCounters[ eMIBTcpInErrs ] );
+}
+
+/**
+ * @brief An ARP request that is sent.
+ */
+void test_vMIBCountOutput_ARPRequest( void )
+{
+    ARPPacket_t * pxARPPacket = ( ARPPacket_t * ) ucFrame;
+
+    pxARPPacket->xEthernetHeader.usFrameType = ipARP_FRAME_TYPE;
+    pxARPPacket->xARPHeader.usOperation = ipARP_REQUEST;
+    xNetworkBuffer.xDataLength = sizeof( ARPPacket_t );
+    xNetworkBuffer.pxEndPoint = &xEndPoint;
+
+    vMIBCountOutput( &xNetworkBuffer );
+
+    TEST_ASSERT_EQUAL_UINT32( 1U, xEndPoint.xMIB.ulCounters[ eMIBArpOutRequests ] );
+    TEST_ASSERT_EQUAL_UINT32( 0U, xEndPoint.xMIB.ulCounters[ eMIBArpOutReplies ] );
+    TEST_ASSERT_EQUAL_UINT32( 0U, xEndPoint.xMIB.ulCounters[ eMIBIpOutRequests ] );
+}
+
+/**
+ * @brief A UDP packet that is sent.
+ */
+void test_vMIBCountOutput_UDP( void )
+{
+    ( void ) prvIPv4Packet( ipPROTOCOL_UDP, sizeof( UDPPacket_t ) );
+    xNetworkBuffer.pxEndPoint = &xEndPoint;
+
+    vMIBCountOutput( &xNetworkBuffer );
+
+    TEST_ASSERT_EQUAL_UINT32( 1U, xEndPoint.xMIB.ulCounters[ eMIBIpOutRequests ] );
+    TEST_ASSERT_EQUAL_UINT32( 1U, xEndPoint.xMIB.ulCounters[ eMIBUdpOutDatagrams ] );
+}
+
+/**
+ * @brief A TCP reset that is sent without an end-point is counted in the interface.
+ */
+void test_vMIBCountOutput_TCPReset( void )
+{
+    TCPPacket_t * pxTCPPacket = ( TCPPacket_t * ) prvIPv4Packet( ipPROTOCOL_TCP, sizeof( TCPPacket_t ) );
+
+    pxTCPPacket->xTCPHeader.ucTCPFlags = tcpTCP_FLAG_RST | tcpTCP_FLAG_ACK;
+    xNetworkBuffer.pxInterface = &xInterface;
+
+    vMIBCountOutput( &xNetworkBuffer );
+
+    TEST_ASSERT_EQUAL_UINT32( 1U, xInterface.xMIB.ulCounters[ eMIBIpOutRequests ] );
+    TEST_ASSERT_EQUAL_UINT32( 1U, xInterface.xMIB.ulCounters[ eMIBTcpOutSegs ] );
+    TEST_ASSERT_EQUAL_UINT32( 1U, xInterface.xMIB.ulCounters[ eMIBTcpOutRsts ] );
+}
+
+/**
+ * @brief An IP-header without a payload is counted, but not its protocol.
+ */
+void test_vMIBCountOutput_NoPayload( void )
+{
+    ( void ) prvIPv4Packet( ipPROTOCOL_UDP, ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER );
+    xNetworkBuffer.pxEndPoint = &xEndPoint;
+
+    vMIBCountOutput( &xNetworkBuffer );
+
+    TEST_ASSERT_EQUAL_UINT32( 1U, xEndPoint.xMIB.ulCounters[ eMIBIpOutRequests ] );
+    TEST_ASSERT_EQUAL_UINT32( 0U, xEndPoint.xMIB.ulCounters[ eMIBUdpOutDatagrams ] );
+}
+
+/**
+ * @brief A neighbour solicitation that is sent.
+ */
+void test_vMIBCountOutput_NeighbourSolicitation( void )
+{
+    ICMPPacket_IPv6_t * pxICMPPacket = ( ICMPPacket_IPv6_t * ) ucFrame;
+
+    pxICMPPacket->xEthernetHeader.usFrameType = ipIPv6_FRAME_TYPE;
+    pxICMPPacket->xIPHeader.ucNextHeader = ipPROTOCOL_ICMP_IPv6;
+    pxICMPPacket->xICMPHeaderIPv6.ucTypeOfMessage = ipICMP_NEIGHBOR_SOLICITATION_IPv6;
+    xNetworkBuffer.xDataLength = sizeof( ICMPPacket_IPv6_t );
+    xNetworkBuffer.pxEndPoint = &xEndPoint;
+
+    vMIBCountOutput( &xNetworkBuffer );
+
+    TEST_ASSERT_EQUAL_UINT32( 1U, xEndPoint.xMIB.ulCounters[ eMIBIpOutRequests ] );
+    TEST_ASSERT_EQUAL_UINT32( 1U, xEndPoint.xMIB.ulCounters[ eMIBIcmpOutMsgs ] );
+    TEST_ASSERT_EQUAL_UINT32( 1U, xEndPoint.xMIB.ulCounters[ eMIBNdOutSolicitations ] );
+}
+
+/**
+ * @brief A snapshot needs a place to be written.
+ */
+void test_FreeRTOS_GetMIBCounters_NullCounters( void )
+{
+    TEST_ASSERT_EQUAL( pdFAIL, FreeRTOS_GetMIBCounters( NULL, NULL, NULL ) );
+}
+
+/**
+ * @brief The snapshot of an end-point only contains its own counters.
+ */
+void test_FreeRTOS_GetMIBCounters_EndPoint( void )
+{
+    MIBCounters_t xCounters;
+
+    vMIBCount( &xInterface, &xEndPoint, eMIBUdpInDatagrams );
+    vMIBCount( &xInterface, NULL, eMIBUdpInDatagrams );
+
+    vTaskSuspendAll_Expect();
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    TEST_ASSERT_EQUAL( pdPASS, FreeRTOS_GetMIBCounters( NULL, &xEndPoint, &xCounters ) );
+    TEST_ASSERT_EQUAL_UINT32( 1U, xCounters.ulCounters[ eMIBUdpInDatagrams ] );
+}
+
+/**
+ * @brief The stack-wide snapshot adds up all the counters.
+ */
+void test_FreeRTOS_GetMIBCounters_Stack( void )
+{
+    MIBCounters_t xCounters;
+
+    vMIBCount( &xInterface, &xEndPoint, eMIBIpInDiscards );
+    vMIBCount( &xInterface, NULL, eMIBIpInDiscards );
+    vMIBCount( NULL, NULL, eMIBIpInDiscards );
+    vMIBCountFromTask( eMIBIpInDiscards );
+
+    prvGetStackCounters( &xCounters );
+    TEST_ASSERT_EQUAL_UINT32( 4U, xCounters.ulCounters[ eMIBIpInDiscards ] );
+    TEST_ASSERT_EQUAL_UINT32( 0U, xCounters.ulCounters[ eMIBIpInReceives ] );
+}
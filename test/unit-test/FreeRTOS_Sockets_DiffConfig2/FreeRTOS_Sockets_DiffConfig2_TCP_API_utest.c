@@ -0,0 +1,1349 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mock_task.h"
+#include "mock_list.h"
+#include "mock_event_groups.h"
+
+/* This must come after list.h is included (in this case, indirectly
+ * by mock_list.h). */
+#include "mock_Sockets_DiffConfig2_list_macros.h"
+#include "mock_portable.h"
+#include "mock_NetworkBufferManagement.h"
+#include "mock_FreeRTOS_IP.h"
+#include "mock_FreeRTOS_TCP_WIN.h"
+#include "mock_FreeRTOS_IP_Private.h"
+#include "mock_FreeRTOS_Stream_Buffer.h"
+
+#include "FreeRTOS_Sockets.h"
+
+#include "catch_assert.h"
+
+#include "FreeRTOSIPConfig.h"
+
+/* ============================ EXTERN VARIABLES ============================ */
+
+extern List_t xBoundUDPSocketsList;
+
+BaseType_t xTCPWindowLoggingLevel = 0;
+
+/* The offset of the TCP payload in the lent segments. */
+#define tcptestPAYLOAD_OFFSET    ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER )
+
+/* The number of payload bytes in a lent segment. */
+#define tcptestPAYLOAD_LENGTH    ( 100U )
+
+static uint8_t ucEthernetBuffer[ ipconfigNETWORK_MTU + ipSIZE_OF_ETH_HEADER ];
+static NetworkBufferDescriptor_t xNetworkBuffer;
+
+/* A stream buffer, only its length is used. */
+static StreamBuffer_t xStream;
+
+/* The size of the rxStream before and after it grows. */
+#define tcptestSMALL_STREAM      ( 1000U )
+#define tcptestWINDOW_LENGTH     ( 2000U )
+#define tcptestRX_STREAM_SIZE    ( 4000U )
+
+/* The value of 'LENGTH' of an rxStream of 'size' bytes. */
+#define tcptestSTREAM_LENGTH( size )    ( ( ( size ) + sizeof( size_t ) ) & ~( sizeof( size_t ) - 1U ) )
+
+/* The event that was sent to the IP-task. */
+static IPStackEvent_t xSentEvent;
+
+void vTCPRxStreamGrow( FreeRTOS_Socket_t * pxSocket );
+
+/* The calls to prvHandleDone(). */
+static BaseType_t xHandleDoneCount;
+static TCPTxReference_t * pxHandleDoneReference;
+static BaseType_t xHandleDoneAcked;
+
+/* ============================== Test Helpers ============================== */
+
+/**
+ * @brief Prepare a connected socket with one lent segment.
+ */
+static void prvPrepareLendingSocket( FreeRTOS_Socket_t * pxSocket )
+{
+    size_t uxIndex;
+
+    memset( pxSocket, 0, sizeof( *pxSocket ) );
+    pxSocket->ucProtocol = FREERTOS_IPPROTO_TCP;
+    pxSocket->u.xTCP.eTCPState = eESTABLISHED;
+    pxSocket->u.xTCP.bits.bRxLending = pdTRUE_UNSIGNED;
+    pxSocket->u.xTCP.uxRxLentBytes = tcptestPAYLOAD_LENGTH;
+
+    memset( &xNetworkBuffer, 0, sizeof( xNetworkBuffer ) );
+
+    for( uxIndex = 0U; uxIndex < sizeof( ucEthernetBuffer ); uxIndex++ )
+    {
+        ucEthernetBuffer[ uxIndex ] = ( uint8_t ) uxIndex;
+    }
+
+    xNetworkBuffer.pucEthernetBuffer = ucEthernetBuffer;
+    xNetworkBuffer.uxPayloadOffset = tcptestPAYLOAD_OFFSET;
+    xNetworkBuffer.xDataLength = tcptestPAYLOAD_OFFSET + tcptestPAYLOAD_LENGTH;
+}
+
+/**
+ * @brief Prepare a connected socket with a transmission stream.
+ */
+static void prvPrepareConnectedSocket( FreeRTOS_Socket_t * pxSocket )
+{
+    memset( pxSocket, 0, sizeof( *pxSocket ) );
+    pxSocket->ucProtocol = FREERTOS_IPPROTO_TCP;
+    pxSocket->u.xTCP.eTCPState = eESTABLISHED;
+    pxSocket->xSendBlockTime = 100;
+
+    memset( &xStream, 0, sizeof( xStream ) );
+    xStream.LENGTH = 100U;
+    pxSocket->u.xTCP.txStream = &xStream;
+}
+
+/**
+ * @brief Allocate a stream of 'uxLength' bytes, like prvTCPCreateStream() does.
+ */
+static StreamBuffer_t * prvCreateStream( size_t uxLength )
+{
+    size_t uxSize = ( sizeof( StreamBuffer_t ) + uxLength ) - sizeof( ( ( StreamBuffer_t * ) NULL )->ucArray );
+    StreamBuffer_t * pxStream = ( StreamBuffer_t * ) malloc( uxSize );
+
+    memset( pxStream, 0, uxSize );
+    pxStream->LENGTH = uxLength;
+
+    return pxStream;
+}
+
+/**
+ * @brief Prepare a connected socket whose reception window has grown beyond
+ *        the size of its rxStream.
+ */
+static void prvPrepareTunedSocket( FreeRTOS_Socket_t * pxSocket )
+{
+    prvPrepareConnectedSocket( pxSocket );
+    pxSocket->xEventGroup = ( EventGroupHandle_t ) 0x1234;
+    pxSocket->u.xTCP.uxRxStreamSize = tcptestRX_STREAM_SIZE;
+    pxSocket->u.xTCP.xTCPWindow.u.bits.bHasInit = pdTRUE_UNSIGNED;
+    pxSocket->u.xTCP.xTCPWindow.xSize.ulRxWindowLength = tcptestWINDOW_LENGTH;
+}
+
+/**
+ * @brief Record the event that is sent to the IP-task.
+ */
+static BaseType_t xSendEventStructToIPTask_Record( const IPStackEvent_t * pxEvent,
+                                                   TickType_t uxTimeout,
+                                                   int cmock_num_calls )
+{
+    ( void ) uxTimeout;
+    ( void ) cmock_num_calls;
+
+    xSentEvent = *pxEvent;
+
+    return pdPASS;
+}
+
+/**
+ * @brief The completion handler of a reference.
+ */
+static void prvHandleDone( Socket_t xSocket,
+                           TCPTxReference_t * pxReference,
+                           BaseType_t xAcked )
+{
+    ( void ) xSocket;
+
+    xHandleDoneCount++;
+    pxHandleDoneReference = pxReference;
+    xHandleDoneAcked = xAcked;
+}
+
+/**
+ * @brief Prepare a reference to application memory.
+ */
+static void prvPrepareReference( TCPTxReference_t * pxReference,
+                                 const uint8_t * pucData,
+                                 size_t uxLength )
+{
+    memset( pxReference, 0, sizeof( *pxReference ) );
+    pxReference->pucData = pucData;
+    pxReference->uxLength = uxLength;
+    pxReference->pxHandleDone = prvHandleDone;
+
+    xHandleDoneCount = 0;
+    pxHandleDoneReference = NULL;
+    xHandleDoneAcked = pdFALSE;
+}
+
+/**
+ * @brief Expect prvRecvLentData() to find the lent segment.
+ */
+static void prvExpectLentHead( FreeRTOS_Socket_t * pxSocket )
+{
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundTCPSocketsList );
+    listCURRENT_LIST_LENGTH_ExpectAndReturn( &( pxSocket->u.xTCP.xRxLentList ), 1 );
+    listLIST_IS_EMPTY_ExpectAndReturn( &( pxSocket->u.xTCP.xRxLentList ), pdFALSE );
+    vTaskSuspendAll_Expect();
+    listLIST_IS_EMPTY_ExpectAndReturn( &( pxSocket->u.xTCP.xRxLentList ), pdFALSE );
+    listGET_OWNER_OF_HEAD_ENTRY_ExpectAndReturn( &( pxSocket->u.xTCP.xRxLentList ), &xNetworkBuffer );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+}
+
+
+/**
+ * @brief Prepare a listening socket that creates a child socket for each connection.
+ */
+static void prvPrepareServerSocket( FreeRTOS_Socket_t * pxServerSocket )
+{
+    memset( pxServerSocket, 0, sizeof( *pxServerSocket ) );
+
+    pxServerSocket->ucProtocol = FREERTOS_IPPROTO_TCP;
+    pxServerSocket->u.xTCP.eTCPState = eTCP_LISTEN;
+}
+
+/**
+ * @brief Expect prvAcceptWaitClient() to take a child socket from the accept queue.
+ */
+static void prvExpectChildFromQueue( FreeRTOS_Socket_t * pxServerSocket,
+                                     FreeRTOS_Socket_t * pxChildSocket )
+{
+    pxChildSocket->u.xTCP.bits.bPassAccept = pdTRUE_UNSIGNED;
+
+    vTaskSuspendAll_Expect();
+    listLIST_IS_EMPTY_ExpectAndReturn( &( pxServerSocket->u.xTCP.xAcceptQueue ), pdFALSE );
+    listGET_OWNER_OF_HEAD_ENTRY_ExpectAndReturn( &( pxServerSocket->u.xTCP.xAcceptQueue ), pxChildSocket );
+    uxListRemove_ExpectAndReturn( &( pxChildSocket->u.xTCP.xAcceptItem ), 0 );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+}
+
+/**
+ * @brief Expect prvAcceptWaitClient() to find an empty accept queue.
+ */
+static void prvExpectEmptyQueue( FreeRTOS_Socket_t * pxServerSocket )
+{
+    vTaskSuspendAll_Expect();
+    listLIST_IS_EMPTY_ExpectAndReturn( &( pxServerSocket->u.xTCP.xAcceptQueue ), pdTRUE );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+}
+
+/* =============================== Test Cases =============================== */
+
+/**
+ * @brief Invalid parameters are passed to FreeRTOS_accept_batch.
+ */
+void test_FreeRTOS_accept_batch_InvalidParams( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xServerSocket;
+    Socket_t xClientSockets[ 3 ];
+
+    prvPrepareServerSocket( &xServerSocket );
+
+    /* No array to store the clients in. */
+    xReturn = FreeRTOS_accept_batch( &xServerSocket, NULL, 3 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    /* The array has no entries. */
+    xReturn = FreeRTOS_accept_batch( &xServerSocket, xClientSockets, 0 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    /* Invalid socket. */
+    xReturn = FreeRTOS_accept_batch( FREERTOS_INVALID_SOCKET, xClientSockets, 3 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    /* The socket is not bound. */
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( NULL );
+    xReturn = FreeRTOS_accept_batch( &xServerSocket, xClientSockets, 3 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    /* A UDP socket. */
+    xServerSocket.ucProtocol = FREERTOS_IPPROTO_UDP;
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+    xReturn = FreeRTOS_accept_batch( &xServerSocket, xClientSockets, 3 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    /* A listening socket that does not create child sockets. */
+    xServerSocket.ucProtocol = FREERTOS_IPPROTO_TCP;
+    xServerSocket.u.xTCP.bits.bReuseSocket = pdTRUE_UNSIGNED;
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundTCPSocketsList );
+    xReturn = FreeRTOS_accept_batch( &xServerSocket, xClientSockets, 3 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+}
+
+/**
+ * @brief The socket is not in listening mode.
+ */
+void test_FreeRTOS_accept_batch_NotListening( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xServerSocket;
+    Socket_t xClientSockets[ 3 ];
+
+    prvPrepareServerSocket( &xServerSocket );
+    xServerSocket.u.xTCP.eTCPState = eESTABLISHED;
+
+    /* Once by FreeRTOS_accept_batch(), once by FreeRTOS_accept(). */
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundTCPSocketsList );
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundTCPSocketsList );
+
+    xReturn = FreeRTOS_accept_batch( &xServerSocket, xClientSockets, 3 );
+
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+}
+
+/**
+ * @brief No connection is ready and the socket does not block.
+ */
+void test_FreeRTOS_accept_batch_NoClient( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xServerSocket;
+    Socket_t xClientSockets[ 3 ] = { NULL, NULL, NULL };
+
+    prvPrepareServerSocket( &xServerSocket );
+    xServerSocket.xReceiveBlockTime = 0U;
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundTCPSocketsList );
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundTCPSocketsList );
+    prvExpectEmptyQueue( &xServerSocket );
+
+    xReturn = FreeRTOS_accept_batch( &xServerSocket, xClientSockets, 3 );
+
+    TEST_ASSERT_EQUAL( 0, xReturn );
+    TEST_ASSERT_EQUAL_PTR( NULL, xClientSockets[ 0 ] );
+}
+
+/**
+ * @brief Two connections are queued, the array can hold three.
+ */
+void test_FreeRTOS_accept_batch_LessThanMax( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xServerSocket, xChildSockets[ 2 ];
+    Socket_t xClientSockets[ 3 ] = { NULL, NULL, NULL };
+
+    prvPrepareServerSocket( &xServerSocket );
+    memset( xChildSockets, 0, sizeof( xChildSockets ) );
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundTCPSocketsList );
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundTCPSocketsList );
+    prvExpectChildFromQueue( &xServerSocket, &( xChildSockets[ 0 ] ) );
+    prvExpectChildFromQueue( &xServerSocket, &( xChildSockets[ 1 ] ) );
+    prvExpectEmptyQueue( &xServerSocket );
+
+    xReturn = FreeRTOS_accept_batch( &xServerSocket, xClientSockets, 3 );
+
+    TEST_ASSERT_EQUAL( 2, xReturn );
+    TEST_ASSERT_EQUAL_PTR( &( xChildSockets[ 0 ] ), xClientSockets[ 0 ] );
+    TEST_ASSERT_EQUAL_PTR( &( xChildSockets[ 1 ] ), xClientSockets[ 1 ] );
+    TEST_ASSERT_EQUAL_PTR( NULL, xClientSockets[ 2 ] );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xChildSockets[ 0 ].u.xTCP.bits.bPassAccept );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xChildSockets[ 1 ].u.xTCP.bits.bPassAccept );
+}
+
+/**
+ * @brief Three connections are queued, the array can hold two. The third
+ *        connection stays in the accept queue.
+ */
+void test_FreeRTOS_accept_batch_MoreThanMax( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xServerSocket, xChildSockets[ 3 ];
+    Socket_t xClientSockets[ 2 ] = { NULL, NULL };
+
+    prvPrepareServerSocket( &xServerSocket );
+    memset( xChildSockets, 0, sizeof( xChildSockets ) );
+    xChildSockets[ 2 ].u.xTCP.bits.bPassAccept = pdTRUE_UNSIGNED;
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundTCPSocketsList );
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundTCPSocketsList );
+    prvExpectChildFromQueue( &xServerSocket, &( xChildSockets[ 0 ] ) );
+    prvExpectChildFromQueue( &xServerSocket, &( xChildSockets[ 1 ] ) );
+
+    xReturn = FreeRTOS_accept_batch( &xServerSocket, xClientSockets, 2 );
+
+    TEST_ASSERT_EQUAL( 2, xReturn );
+    TEST_ASSERT_EQUAL_PTR( &( xChildSockets[ 0 ] ), xClientSockets[ 0 ] );
+    TEST_ASSERT_EQUAL_PTR( &( xChildSockets[ 1 ] ), xClientSockets[ 1 ] );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xChildSockets[ 2 ].u.xTCP.bits.bPassAccept );
+}
+
+/**
+ * @brief Invalid parameters are passed to FreeRTOS_recv_lent.
+ */
+void test_FreeRTOS_recv_lent_InvalidParams( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    NetworkBufferDescriptor_t * pxBuffer;
+    size_t uxOffset;
+
+    prvPrepareLendingSocket( &xSocket );
+
+    /* The socket is not bound. */
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( NULL );
+    xReturn = FreeRTOS_recv_lent( &xSocket, &pxBuffer, &uxOffset, 0 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundTCPSocketsList );
+    xReturn = FreeRTOS_recv_lent( &xSocket, NULL, &uxOffset, 0 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundTCPSocketsList );
+    xReturn = FreeRTOS_recv_lent( &xSocket, &pxBuffer, NULL, 0 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+}
+
+/**
+ * @brief A lent segment is taken from the socket.
+ */
+void test_FreeRTOS_recv_lent_Segment( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    NetworkBufferDescriptor_t * pxBuffer = NULL;
+    size_t uxOffset = 0U;
+
+    prvPrepareLendingSocket( &xSocket );
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundTCPSocketsList );
+    listCURRENT_LIST_LENGTH_ExpectAndReturn( &( xSocket.u.xTCP.xRxLentList ), 1 );
+    vTaskSuspendAll_Expect();
+    listLIST_IS_EMPTY_ExpectAndReturn( &( xSocket.u.xTCP.xRxLentList ), pdFALSE );
+    listGET_OWNER_OF_HEAD_ENTRY_ExpectAndReturn( &( xSocket.u.xTCP.xRxLentList ), &xNetworkBuffer );
+    uxListRemove_ExpectAndReturn( &( xNetworkBuffer.xBufferListItem ), 0 );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    xReturn = FreeRTOS_recv_lent( &xSocket, &pxBuffer, &uxOffset, 0 );
+
+    TEST_ASSERT_EQUAL( tcptestPAYLOAD_LENGTH, xReturn );
+    TEST_ASSERT_EQUAL_PTR( &xNetworkBuffer, pxBuffer );
+    TEST_ASSERT_EQUAL( tcptestPAYLOAD_OFFSET, uxOffset );
+
+    /* The bytes are still lent until the segment is given back. */
+    TEST_ASSERT_EQUAL( tcptestPAYLOAD_LENGTH, xSocket.u.xTCP.uxRxLentBytes );
+}
+
+/**
+ * @brief Invalid parameters are passed to FreeRTOS_release_lent.
+ */
+void test_FreeRTOS_release_lent_InvalidParams( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+
+    prvPrepareLendingSocket( &xSocket );
+
+    xReturn = FreeRTOS_release_lent( FREERTOS_INVALID_SOCKET, &xNetworkBuffer );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    xReturn = FreeRTOS_release_lent( &xSocket, NULL );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    /* The segment was not taken from the socket. */
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( xNetworkBuffer.xBufferListItem ), &( xSocket.u.xTCP.xRxLentList ) );
+    xReturn = FreeRTOS_release_lent( &xSocket, &xNetworkBuffer );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    TEST_ASSERT_EQUAL( tcptestPAYLOAD_LENGTH, xSocket.u.xTCP.uxRxLentBytes );
+}
+
+/**
+ * @brief A segment is given back. The low-water mark had been reached, and
+ *        now the IP-task is asked to send a window update.
+ */
+void test_FreeRTOS_release_lent_ReopensWindow( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+
+    prvPrepareLendingSocket( &xSocket );
+    xSocket.u.xTCP.bits.bLowWater = pdTRUE_UNSIGNED;
+    xSocket.u.xTCP.uxRxStreamSize = 1000U;
+    xSocket.u.xTCP.uxEnoughSpace = 500U;
+
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( xNetworkBuffer.xBufferListItem ), NULL );
+    vReleaseNetworkBufferAndDescriptor_Expect( &xNetworkBuffer );
+    vTaskSuspendAll_Expect();
+    FreeRTOS_min_size_t_ExpectAndReturn( tcptestPAYLOAD_LENGTH, tcptestPAYLOAD_LENGTH, tcptestPAYLOAD_LENGTH );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+    xSendEventToIPTask_ExpectAndReturn( eTCPTimerEvent, pdPASS );
+
+    xReturn = FreeRTOS_release_lent( &xSocket, &xNetworkBuffer );
+
+    TEST_ASSERT_EQUAL( 0, xReturn );
+    TEST_ASSERT_EQUAL( 0U, xSocket.u.xTCP.uxRxLentBytes );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xSocket.u.xTCP.bits.bLowWater );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xSocket.u.xTCP.bits.bWinChange );
+}
+
+/**
+ * @brief FreeRTOS_recv() copies the data out of a lent segment. The segment
+ *        is released when all of its data has been read.
+ */
+void test_FreeRTOS_recv_LentSegment( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    uint8_t ucBuffer[ 60 ];
+
+    prvPrepareLendingSocket( &xSocket );
+
+    /* The first read takes 60 bytes. */
+    prvExpectLentHead( &xSocket );
+    FreeRTOS_min_size_t_ExpectAndReturn( tcptestPAYLOAD_LENGTH, sizeof( ucBuffer ), sizeof( ucBuffer ) );
+    vTaskSuspendAll_Expect();
+    FreeRTOS_min_size_t_ExpectAndReturn( sizeof( ucBuffer ), tcptestPAYLOAD_LENGTH, sizeof( ucBuffer ) );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    xReturn = FreeRTOS_recv( &xSocket, ucBuffer, sizeof( ucBuffer ), 0 );
+
+    TEST_ASSERT_EQUAL( sizeof( ucBuffer ), xReturn );
+    TEST_ASSERT_EQUAL_MEMORY( &( ucEthernetBuffer[ tcptestPAYLOAD_OFFSET ] ), ucBuffer, sizeof( ucBuffer ) );
+    TEST_ASSERT_EQUAL( tcptestPAYLOAD_OFFSET + sizeof( ucBuffer ), xNetworkBuffer.uxPayloadOffset );
+    TEST_ASSERT_EQUAL( tcptestPAYLOAD_LENGTH - sizeof( ucBuffer ), xSocket.u.xTCP.uxRxLentBytes );
+
+    /* The second read takes the remaining 40 bytes and releases the segment. */
+    prvExpectLentHead( &xSocket );
+    FreeRTOS_min_size_t_ExpectAndReturn( 40U, sizeof( ucBuffer ), 40U );
+    vTaskSuspendAll_Expect();
+    uxListRemove_ExpectAndReturn( &( xNetworkBuffer.xBufferListItem ), 0 );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+    vReleaseNetworkBufferAndDescriptor_Expect( &xNetworkBuffer );
+    vTaskSuspendAll_Expect();
+    FreeRTOS_min_size_t_ExpectAndReturn( 40U, 40U, 40U );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    xReturn = FreeRTOS_recv( &xSocket, ucBuffer, sizeof( ucBuffer ), 0 );
+
+    TEST_ASSERT_EQUAL( 40, xReturn );
+    TEST_ASSERT_EQUAL_MEMORY( &( ucEthernetBuffer[ tcptestPAYLOAD_OFFSET + 60U ] ), ucBuffer, 40U );
+    TEST_ASSERT_EQUAL( 0U, xSocket.u.xTCP.uxRxLentBytes );
+}
+
+/**
+ * @brief FreeRTOS_recv() with FREERTOS_ZERO_COPY points to the payload of a
+ *        lent segment, nothing is consumed.
+ */
+void test_FreeRTOS_recv_LentSegment_ZeroCopy( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    uint8_t * pucData = NULL;
+
+    prvPrepareLendingSocket( &xSocket );
+
+    prvExpectLentHead( &xSocket );
+
+    xReturn = FreeRTOS_recv( &xSocket, &pucData, 0U, FREERTOS_ZERO_COPY );
+
+    TEST_ASSERT_EQUAL( tcptestPAYLOAD_LENGTH, xReturn );
+    TEST_ASSERT_EQUAL_PTR( &( ucEthernetBuffer[ tcptestPAYLOAD_OFFSET ] ), pucData );
+    TEST_ASSERT_EQUAL( tcptestPAYLOAD_OFFSET, xNetworkBuffer.uxPayloadOffset );
+    TEST_ASSERT_EQUAL( tcptestPAYLOAD_LENGTH, xSocket.u.xTCP.uxRxLentBytes );
+}
+
+/**
+ * @brief Segments that are still queued when a socket is closed are released.
+ */
+void test_vSocketClose_LentSegments( void )
+{
+    FreeRTOS_Socket_t * pxSocket;
+    void * pvReturn;
+
+    pxSocket = ( FreeRTOS_Socket_t * ) malloc( sizeof( *pxSocket ) );
+    prvPrepareLendingSocket( pxSocket );
+
+    /* prvSocketSetNotReady() */
+    vTaskSuspendAll_Expect();
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( pxSocket->xSelectReadyItem ), NULL );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    vTCPWindowDestroy_Expect( &( pxSocket->u.xTCP.xTCPWindow ) );
+
+    /* vTCPTxRefFlush() */
+    vTaskSuspendAll_Expect();
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    listCURRENT_LIST_LENGTH_ExpectAndReturn( &( pxSocket->u.xTCP.xRxLentList ), 1 );
+    listGET_OWNER_OF_HEAD_ENTRY_ExpectAndReturn( &( pxSocket->u.xTCP.xRxLentList ), &xNetworkBuffer );
+    uxListRemove_ExpectAndReturn( &( xNetworkBuffer.xBufferListItem ), 0 );
+    vReleaseNetworkBufferAndDescriptor_Expect( &xNetworkBuffer );
+    listCURRENT_LIST_LENGTH_ExpectAndReturn( &( pxSocket->u.xTCP.xRxLentList ), 0 );
+
+    vTaskSuspendAll_Expect();
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( pxSocket->u.xTCP.xAcceptItem ), NULL );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    listGET_HEAD_ENTRY_ExpectAndReturn( &xBoundTCPSocketsList, ( ListItem_t * ) &( xBoundTCPSocketsList.xListEnd ) );
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( pxSocket->xBoundSocketListItem ), NULL );
+    vPortFree_Expect( pxSocket );
+
+    pvReturn = vSocketClose( pxSocket );
+
+    TEST_ASSERT_EQUAL( NULL, pvReturn );
+
+    free( pxSocket );
+}
+
+/**
+ * @brief Invalid parameters are passed to FreeRTOS_sendv.
+ */
+void test_FreeRTOS_sendv_InvalidParams( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    uint8_t ucData[ 10 ];
+    struct freertos_iovec xVector[ 2 ] = { { ucData, 4 }, { NULL, 6 } };
+
+    prvPrepareConnectedSocket( &xSocket );
+
+    xReturn = FreeRTOS_sendv( &xSocket, NULL, 1, 0 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    xReturn = FreeRTOS_sendv( &xSocket, xVector, 0, 0 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    /* A NULL buffer with a non-zero length. */
+    xReturn = FreeRTOS_sendv( &xSocket, xVector, 2, 0 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    /* The data does not fit in the stream at once. */
+    xVector[ 1 ].iov_base = ucData;
+    xVector[ 1 ].iov_len = xStream.LENGTH;
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundTCPSocketsList );
+    xReturn = FreeRTOS_sendv( &xSocket, xVector, 2, 0 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+}
+
+/**
+ * @brief There is not enough space for all buffers, nothing is sent.
+ */
+void test_FreeRTOS_sendv_NoSpace( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    uint8_t ucHeader[ 4 ] = { 0 };
+    uint8_t ucPayload[ 10 ] = { 0 };
+    struct freertos_iovec xVector[ 2 ] = { { ucHeader, sizeof( ucHeader ) }, { ucPayload, sizeof( ucPayload ) } };
+
+    prvPrepareConnectedSocket( &xSocket );
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundTCPSocketsList );
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    uxStreamBufferGetSpace_ExpectAndReturn( &xStream, 13U );
+
+    xReturn = FreeRTOS_sendv( &xSocket, xVector, 2, FREERTOS_MSG_DONTWAIT );
+
+    TEST_ASSERT_EQUAL( 0, xReturn );
+}
+
+/**
+ * @brief The buffers are added beyond the head first, then the head is moved
+ *        over all bytes at once.
+ */
+void test_FreeRTOS_sendv_HappyPath( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    uint8_t ucHeader[ 4 ] = { 0 };
+    uint8_t ucPayload[ 10 ] = { 0 };
+    struct freertos_iovec xVector[ 2 ] = { { ucHeader, sizeof( ucHeader ) }, { ucPayload, sizeof( ucPayload ) } };
+
+    prvPrepareConnectedSocket( &xSocket );
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundTCPSocketsList );
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    uxStreamBufferGetSpace_ExpectAndReturn( &xStream, 14U );
+    uxStreamBufferAdd_ExpectAndReturn( &xStream, sizeof( ucHeader ), ucPayload, sizeof( ucPayload ), sizeof( ucPayload ) );
+    vTaskSuspendAll_Expect();
+    uxStreamBufferAdd_ExpectAndReturn( &xStream, 0U, ucHeader, sizeof( ucHeader ), sizeof( ucHeader ) );
+    uxStreamBufferAdd_ExpectAndReturn( &xStream, 0U, NULL, sizeof( ucPayload ), sizeof( ucPayload ) );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    xSendEventToIPTask_ExpectAndReturn( eTCPTimerEvent, pdPASS );
+
+    xReturn = FreeRTOS_sendv( &xSocket, xVector, 2, 0 );
+
+    TEST_ASSERT_EQUAL( 14, xReturn );
+    TEST_ASSERT_EQUAL( 1U, xSocket.u.xTCP.usTimeout );
+}
+
+/**
+ * @brief FreeRTOS_recvv() fills the buffers in order from the stream.
+ */
+void test_FreeRTOS_recvv_Stream( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    uint8_t ucHeader[ 4 ];
+    uint8_t ucPayload[ 20 ];
+    struct freertos_iovec xVector[ 2 ] = { { ucHeader, sizeof( ucHeader ) }, { ucPayload, sizeof( ucPayload ) } };
+
+    prvPrepareConnectedSocket( &xSocket );
+    xSocket.u.xTCP.rxStream = &xStream;
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundTCPSocketsList );
+    uxStreamBufferGetSize_ExpectAndReturn( &xStream, 14U );
+    listCURRENT_LIST_LENGTH_ExpectAndReturn( &( xSocket.u.xTCP.xRxLentList ), 0 );
+    listLIST_IS_EMPTY_ExpectAndReturn( &( xSocket.u.xTCP.xRxLentList ), pdTRUE );
+    uxStreamBufferGet_ExpectAndReturn( &xStream, 0U, ucHeader, sizeof( ucHeader ), pdFALSE, sizeof( ucHeader ) );
+    uxStreamBufferGet_ExpectAndReturn( &xStream, 0U, ucPayload, sizeof( ucPayload ), pdFALSE, 10U );
+
+    xReturn = FreeRTOS_recvv( &xSocket, xVector, 2, 0 );
+
+    TEST_ASSERT_EQUAL( 14, xReturn );
+}
+
+/**
+ * @brief FreeRTOS_recvv() copies the data out of a lent segment.
+ */
+void test_FreeRTOS_recvv_LentSegment( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    uint8_t ucBuffers[ 2 ][ 60 ];
+    struct freertos_iovec xVector[ 2 ] = { { ucBuffers[ 0 ], 60 }, { ucBuffers[ 1 ], 60 } };
+
+    prvPrepareLendingSocket( &xSocket );
+
+    /* The first buffer is filled. */
+    prvExpectLentHead( &xSocket );
+    FreeRTOS_min_size_t_ExpectAndReturn( tcptestPAYLOAD_LENGTH, 60U, 60U );
+    vTaskSuspendAll_Expect();
+    FreeRTOS_min_size_t_ExpectAndReturn( 60U, tcptestPAYLOAD_LENGTH, 60U );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    /* The second buffer gets the rest of the segment, which is released. */
+    vTaskSuspendAll_Expect();
+    listLIST_IS_EMPTY_ExpectAndReturn( &( xSocket.u.xTCP.xRxLentList ), pdFALSE );
+    listGET_OWNER_OF_HEAD_ENTRY_ExpectAndReturn( &( xSocket.u.xTCP.xRxLentList ), &xNetworkBuffer );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+    FreeRTOS_min_size_t_ExpectAndReturn( 40U, 60U, 40U );
+    vTaskSuspendAll_Expect();
+    uxListRemove_ExpectAndReturn( &( xNetworkBuffer.xBufferListItem ), 0 );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+    vReleaseNetworkBufferAndDescriptor_Expect( &xNetworkBuffer );
+    vTaskSuspendAll_Expect();
+    FreeRTOS_min_size_t_ExpectAndReturn( 40U, 40U, 40U );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    xReturn = FreeRTOS_recvv( &xSocket, xVector, 2, 0 );
+
+    TEST_ASSERT_EQUAL( tcptestPAYLOAD_LENGTH, xReturn );
+    TEST_ASSERT_EQUAL_MEMORY( &( ucEthernetBuffer[ tcptestPAYLOAD_OFFSET ] ), ucBuffers[ 0 ], 60U );
+    TEST_ASSERT_EQUAL_MEMORY( &( ucEthernetBuffer[ tcptestPAYLOAD_OFFSET + 60U ] ), ucBuffers[ 1 ], 40U );
+    TEST_ASSERT_EQUAL( 0U, xSocket.u.xTCP.uxRxLentBytes );
+}
+
+/**
+ * @brief Invalid parameters are passed to FreeRTOS_send_ref.
+ */
+void test_FreeRTOS_send_ref_InvalidParams( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    TCPTxReference_t xReference;
+    static const uint8_t ucData[ 100 ] = { 0 };
+
+    prvPrepareConnectedSocket( &xSocket );
+    prvPrepareReference( &xReference, NULL, 10U );
+
+    xReturn = FreeRTOS_send_ref( &xSocket, NULL, 0 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    xReturn = FreeRTOS_send_ref( &xSocket, &xReference, 0 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    /* The reference is larger than the stream. */
+    prvPrepareReference( &xReference, ucData, xStream.LENGTH );
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundTCPSocketsList );
+    xReturn = FreeRTOS_send_ref( &xSocket, &xReference, 0 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    TEST_ASSERT_EQUAL_PTR( NULL, xSocket.u.xTCP.pxTxRefFirst );
+}
+
+/**
+ * @brief Two references are queued. Only space is reserved in the stream.
+ */
+void test_FreeRTOS_send_ref_HappyPath( void )
+{
+    BaseType_t xReturn;
+    BaseType_t xIndex;
+    FreeRTOS_Socket_t xSocket;
+    TCPTxReference_t xReferences[ 2 ];
+    static const uint8_t ucData[ 30 ] = { 0 };
+
+    prvPrepareConnectedSocket( &xSocket );
+    prvPrepareReference( &( xReferences[ 0 ] ), ucData, 10U );
+    prvPrepareReference( &( xReferences[ 1 ] ), &( ucData[ 10 ] ), 20U );
+
+    for( xIndex = 0; xIndex < 2; xIndex++ )
+    {
+        listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundTCPSocketsList );
+        xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+        vTaskSetTimeOutState_ExpectAnyArgs();
+        uxStreamBufferGetSpace_ExpectAndReturn( &xStream, 50U );
+        vTaskSuspendAll_Expect();
+        uxStreamBufferAdd_ExpectAndReturn( &xStream, 0U, NULL, xReferences[ xIndex ].uxLength, xReferences[ xIndex ].uxLength );
+        xTaskResumeAll_ExpectAndReturn( pdFALSE );
+        xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+        xSendEventToIPTask_ExpectAndReturn( eTCPTimerEvent, pdPASS );
+
+        xStream.uxHead = ( size_t ) ( 10 * xIndex );
+        xReturn = FreeRTOS_send_ref( &xSocket, &( xReferences[ xIndex ] ), 0 );
+
+        TEST_ASSERT_EQUAL( xReferences[ xIndex ].uxLength, xReturn );
+        TEST_ASSERT_EQUAL( xStream.uxHead, xReferences[ xIndex ].uxPosition );
+    }
+
+    TEST_ASSERT_EQUAL_PTR( &( xReferences[ 0 ] ), xSocket.u.xTCP.pxTxRefFirst );
+    TEST_ASSERT_EQUAL_PTR( &( xReferences[ 1 ] ), xReferences[ 0 ].pxNext );
+    TEST_ASSERT_EQUAL_PTR( &( xReferences[ 1 ] ), xSocket.u.xTCP.pxTxRefLast );
+    TEST_ASSERT_EQUAL( 0, xHandleDoneCount );
+}
+
+/**
+ * @brief uxTCPTxRefGet() takes copied bytes from the stream, and referenced
+ *        bytes from the application memory.
+ */
+void test_uxTCPTxRefGet_StreamAndReference( void )
+{
+    size_t uxReturn;
+    FreeRTOS_Socket_t xSocket;
+    TCPTxReference_t xReference;
+    uint8_t ucTarget[ 12 ];
+    uint8_t ucData[ 10 ];
+    size_t uxIndex;
+
+    for( uxIndex = 0U; uxIndex < sizeof( ucData ); uxIndex++ )
+    {
+        ucData[ uxIndex ] = ( uint8_t ) ( 0x80U + uxIndex );
+    }
+
+    prvPrepareConnectedSocket( &xSocket );
+    prvPrepareReference( &xReference, ucData, sizeof( ucData ) );
+    xReference.uxPosition = 5U;
+    xSocket.u.xTCP.pxTxRefFirst = &xReference;
+    xSocket.u.xTCP.pxTxRefLast = &xReference;
+    memset( ucTarget, 0, sizeof( ucTarget ) );
+
+    /* Five copied bytes precede the reference. */
+    uxStreamBufferDistance_ExpectAndReturn( &xStream, 0U, 5U, 5U );
+    FreeRTOS_min_size_t_ExpectAndReturn( 12U, 5U, 5U );
+    uxStreamBufferGet_ExpectAndReturn( &xStream, 0U, ucTarget, 5U, pdTRUE, 5U );
+
+    /* The rest comes from the reference. */
+    uxStreamBufferDistance_ExpectAndReturn( &xStream, 0U, 5U, 5U );
+    FreeRTOS_min_size_t_ExpectAndReturn( 7U, 10U, 7U );
+
+    uxReturn = uxTCPTxRefGet( &xSocket, 0U, ucTarget, sizeof( ucTarget ) );
+
+    TEST_ASSERT_EQUAL( sizeof( ucTarget ), uxReturn );
+    TEST_ASSERT_EQUAL_MEMORY( ucData, &( ucTarget[ 5 ] ), 7U );
+}
+
+/**
+ * @brief A reference that is completely acknowledged is removed and its
+ *        completion handler is called. The next one is partially acknowledged.
+ */
+void test_vTCPTxRefAcked_CompleteAndPartial( void )
+{
+    FreeRTOS_Socket_t xSocket;
+    TCPTxReference_t xReferences[ 2 ];
+    static const uint8_t ucData[ 30 ] = { 0 };
+
+    prvPrepareConnectedSocket( &xSocket );
+    prvPrepareReference( &( xReferences[ 0 ] ), ucData, 10U );
+    prvPrepareReference( &( xReferences[ 1 ] ), &( ucData[ 10 ] ), 20U );
+    xReferences[ 0 ].pxNext = &( xReferences[ 1 ] );
+    xReferences[ 1 ].uxPosition = 10U;
+    xSocket.u.xTCP.pxTxRefFirst = &( xReferences[ 0 ] );
+    xSocket.u.xTCP.pxTxRefLast = &( xReferences[ 1 ] );
+
+    uxStreamBufferDistance_ExpectAndReturn( &xStream, 0U, 0U, 0U );
+    vTaskSuspendAll_Expect();
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+    uxStreamBufferDistance_ExpectAndReturn( &xStream, 10U, 10U, 0U );
+
+    vTCPTxRefAcked( &xSocket, 15U );
+
+    TEST_ASSERT_EQUAL( 1, xHandleDoneCount );
+    TEST_ASSERT_EQUAL_PTR( &( xReferences[ 0 ] ), pxHandleDoneReference );
+    TEST_ASSERT_EQUAL( pdTRUE, xHandleDoneAcked );
+    TEST_ASSERT_EQUAL_PTR( &( xReferences[ 1 ] ), xSocket.u.xTCP.pxTxRefFirst );
+    TEST_ASSERT_EQUAL( 5U, xReferences[ 1 ].uxAcked );
+    TEST_ASSERT_EQUAL( 15U, xReferences[ 1 ].uxPosition );
+}
+
+/**
+ * @brief The owners of the queued references are told that their memory is
+ *        not used any more.
+ */
+void test_vTCPTxRefFlush( void )
+{
+    FreeRTOS_Socket_t xSocket;
+    TCPTxReference_t xReferences[ 2 ];
+    static const uint8_t ucData[ 30 ] = { 0 };
+
+    prvPrepareConnectedSocket( &xSocket );
+    prvPrepareReference( &( xReferences[ 0 ] ), ucData, 10U );
+    prvPrepareReference( &( xReferences[ 1 ] ), &( ucData[ 10 ] ), 20U );
+    xReferences[ 0 ].pxNext = &( xReferences[ 1 ] );
+    xSocket.u.xTCP.pxTxRefFirst = &( xReferences[ 0 ] );
+    xSocket.u.xTCP.pxTxRefLast = &( xReferences[ 1 ] );
+
+    vTaskSuspendAll_Expect();
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    vTCPTxRefFlush( &xSocket );
+
+    TEST_ASSERT_EQUAL( 2, xHandleDoneCount );
+    TEST_ASSERT_EQUAL_PTR( &( xReferences[ 1 ] ), pxHandleDoneReference );
+    TEST_ASSERT_EQUAL( pdFALSE, xHandleDoneAcked );
+    TEST_ASSERT_EQUAL_PTR( NULL, xSocket.u.xTCP.pxTxRefFirst );
+    TEST_ASSERT_EQUAL_PTR( NULL, xSocket.u.xTCP.pxTxRefLast );
+}
+
+/**
+ * @brief The rxStream is replaced by a bigger one. The data, also the data
+ *        that was received out of order, keeps its position relative to the
+ *        tail, also when it wraps around the end of the old stream.
+ */
+void test_vTCPRxStreamGrow_WrappedData( void )
+{
+    FreeRTOS_Socket_t xSocket;
+    StreamBuffer_t * pxOldStream;
+    StreamBuffer_t * pxNewStream;
+    size_t uxIndex;
+
+    prvPrepareTunedSocket( &xSocket );
+    pxOldStream = prvCreateStream( tcptestSMALL_STREAM );
+
+    for( uxIndex = 0U; uxIndex < tcptestSMALL_STREAM; uxIndex++ )
+    {
+        pxOldStream->ucArray[ uxIndex ] = ( uint8_t ) ( uxIndex % 251U );
+    }
+
+    /* 200 bytes in order, 200 bytes out of order, starting 100 bytes before
+     * the end of the stream. */
+    pxOldStream->uxTail = 900U;
+    pxOldStream->uxHead = 100U;
+    pxOldStream->uxFront = 300U;
+    xSocket.u.xTCP.rxStream = pxOldStream;
+
+    pxNewStream = prvCreateStream( tcptestSTREAM_LENGTH( tcptestWINDOW_LENGTH ) );
+
+    FreeRTOS_min_size_t_ExpectAndReturn( tcptestRX_STREAM_SIZE, tcptestWINDOW_LENGTH, tcptestWINDOW_LENGTH );
+    pvPortMalloc_ExpectAndReturn( sizeof( StreamBuffer_t ) + tcptestSTREAM_LENGTH( tcptestWINDOW_LENGTH ) - sizeof( pxNewStream->ucArray ), pxNewStream );
+    uxStreamBufferDistance_ExpectAndReturn( pxOldStream, 900U, 300U, 400U );
+    FreeRTOS_min_size_t_ExpectAndReturn( 100U, 400U, 100U );
+    uxStreamBufferDistance_ExpectAndReturn( pxOldStream, 900U, 100U, 200U );
+    vPortFree_Expect( pxOldStream );
+
+    vTCPRxStreamGrow( &xSocket );
+
+    TEST_ASSERT_EQUAL_PTR( pxNewStream, xSocket.u.xTCP.rxStream );
+    TEST_ASSERT_EQUAL( tcptestSTREAM_LENGTH( tcptestWINDOW_LENGTH ), pxNewStream->LENGTH );
+    TEST_ASSERT_EQUAL( 0U, pxNewStream->uxTail );
+    TEST_ASSERT_EQUAL( 200U, pxNewStream->uxHead );
+    TEST_ASSERT_EQUAL( 400U, pxNewStream->uxFront );
+    TEST_ASSERT_EQUAL_MEMORY( &( pxOldStream->ucArray[ 900 ] ), pxNewStream->ucArray, 100U );
+    TEST_ASSERT_EQUAL_MEMORY( pxOldStream->ucArray, &( pxNewStream->ucArray[ 100 ] ), 300U );
+
+    free( pxOldStream );
+    free( pxNewStream );
+}
+
+/**
+ * @brief The rxStream never grows beyond 'uxRxStreamSize', even when the
+ *        reception window is bigger.
+ */
+void test_vTCPRxStreamGrow_CappedAtStreamSize( void )
+{
+    FreeRTOS_Socket_t xSocket;
+    StreamBuffer_t * pxStream;
+
+    prvPrepareTunedSocket( &xSocket );
+    xSocket.u.xTCP.uxRxStreamSize = tcptestSMALL_STREAM;
+    pxStream = prvCreateStream( tcptestSTREAM_LENGTH( tcptestSMALL_STREAM ) );
+    xSocket.u.xTCP.rxStream = pxStream;
+
+    FreeRTOS_min_size_t_ExpectAndReturn( tcptestSMALL_STREAM, tcptestWINDOW_LENGTH, tcptestSMALL_STREAM );
+
+    vTCPRxStreamGrow( &xSocket );
+
+    TEST_ASSERT_EQUAL_PTR( pxStream, xSocket.u.xTCP.rxStream );
+    TEST_ASSERT_EQUAL( tcptestSTREAM_LENGTH( tcptestSMALL_STREAM ), pxStream->LENGTH );
+
+    free( pxStream );
+}
+
+/**
+ * @brief When there is no memory for a bigger stream, the old one is kept.
+ */
+void test_vTCPRxStreamGrow_NoMemory( void )
+{
+    FreeRTOS_Socket_t xSocket;
+    StreamBuffer_t * pxStream;
+
+    prvPrepareTunedSocket( &xSocket );
+    pxStream = prvCreateStream( tcptestSMALL_STREAM );
+    xSocket.u.xTCP.rxStream = pxStream;
+
+    FreeRTOS_min_size_t_ExpectAndReturn( tcptestRX_STREAM_SIZE, tcptestWINDOW_LENGTH, tcptestWINDOW_LENGTH );
+    pvPortMalloc_ExpectAnyArgsAndReturn( NULL );
+
+    vTCPRxStreamGrow( &xSocket );
+
+    TEST_ASSERT_EQUAL_PTR( pxStream, xSocket.u.xTCP.rxStream );
+
+    free( pxStream );
+}
+
+/**
+ * @brief Expect FreeRTOS_recvv() to read 14 bytes from the rxStream.
+ */
+static void prvExpectRecvvStream( FreeRTOS_Socket_t * pxSocket,
+                                  uint8_t * pucBuffer,
+                                  size_t uxLength )
+{
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundTCPSocketsList );
+    uxStreamBufferGetSize_ExpectAndReturn( pxSocket->u.xTCP.rxStream, 14U );
+    listCURRENT_LIST_LENGTH_ExpectAndReturn( &( pxSocket->u.xTCP.xRxLentList ), 0 );
+    listLIST_IS_EMPTY_ExpectAndReturn( &( pxSocket->u.xTCP.xRxLentList ), pdTRUE );
+    uxStreamBufferGet_ExpectAndReturn( pxSocket->u.xTCP.rxStream, 0U, pucBuffer, uxLength, pdFALSE, 14U );
+    FreeRTOS_min_size_t_ExpectAndReturn( tcptestRX_STREAM_SIZE, tcptestWINDOW_LENGTH, tcptestWINDOW_LENGTH );
+}
+
+/**
+ * @brief After reading, the user's task asks the IP-task to replace the
+ *        rxStream, and waits until that is done.
+ */
+void test_FreeRTOS_recvv_RxStreamGrow_SendsEvent( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    uint8_t ucBuffer[ 20 ];
+    struct freertos_iovec xVector[ 1 ] = { { ucBuffer, sizeof( ucBuffer ) } };
+
+    prvPrepareTunedSocket( &xSocket );
+    xSocket.u.xTCP.rxStream = &xStream;
+    memset( &xSentEvent, 0, sizeof( xSentEvent ) );
+
+    prvExpectRecvvStream( &xSocket, ucBuffer, sizeof( ucBuffer ) );
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    xSendEventStructToIPTask_Stub( xSendEventStructToIPTask_Record );
+    xEventGroupWaitBits_ExpectAndReturn( xSocket.xEventGroup, ( EventBits_t ) eSOCKET_BOUND, pdTRUE, pdFALSE, portMAX_DELAY, ( EventBits_t ) eSOCKET_BOUND );
+
+    xReturn = FreeRTOS_recvv( &xSocket, xVector, 1, 0 );
+
+    TEST_ASSERT_EQUAL( 14, xReturn );
+    TEST_ASSERT_EQUAL( eSocketRxGrowEvent, xSentEvent.eEventType );
+    TEST_ASSERT_EQUAL_PTR( &xSocket, xSentEvent.pvData );
+
+    /* The stream itself is replaced by the IP-task. */
+    TEST_ASSERT_EQUAL_PTR( &xStream, xSocket.u.xTCP.rxStream );
+}
+
+/**
+ * @brief When the event can not be sent, the user's task does not wait, the
+ *        rxStream will grow after a next read.
+ */
+void test_FreeRTOS_recvv_RxStreamGrow_QueueFull( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    uint8_t ucBuffer[ 20 ];
+    struct freertos_iovec xVector[ 1 ] = { { ucBuffer, sizeof( ucBuffer ) } };
+
+    prvPrepareTunedSocket( &xSocket );
+    xSocket.u.xTCP.rxStream = &xStream;
+
+    prvExpectRecvvStream( &xSocket, ucBuffer, sizeof( ucBuffer ) );
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    xSendEventStructToIPTask_ExpectAnyArgsAndReturn( pdFAIL );
+
+    xReturn = FreeRTOS_recvv( &xSocket, xVector, 1, 0 );
+
+    TEST_ASSERT_EQUAL( 14, xReturn );
+    TEST_ASSERT_EQUAL_PTR( &xStream, xSocket.u.xTCP.rxStream );
+}
+
+/**
+ * @brief When reading from a call-back in the IP-task, the rxStream is
+ *        replaced immediately.
+ */
+void test_FreeRTOS_recvv_RxStreamGrow_FromIPTask( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    uint8_t ucBuffer[ 20 ];
+    struct freertos_iovec xVector[ 1 ] = { { ucBuffer, sizeof( ucBuffer ) } };
+    StreamBuffer_t * pxNewStream;
+
+    prvPrepareTunedSocket( &xSocket );
+    xSocket.u.xTCP.rxStream = &xStream;
+    pxNewStream = prvCreateStream( tcptestSTREAM_LENGTH( tcptestWINDOW_LENGTH ) );
+
+    prvExpectRecvvStream( &xSocket, ucBuffer, sizeof( ucBuffer ) );
+    xIsCallingFromIPTask_ExpectAndReturn( pdTRUE );
+    FreeRTOS_min_size_t_ExpectAndReturn( tcptestRX_STREAM_SIZE, tcptestWINDOW_LENGTH, tcptestWINDOW_LENGTH );
+    pvPortMalloc_ExpectAnyArgsAndReturn( pxNewStream );
+    uxStreamBufferDistance_ExpectAndReturn( &xStream, 0U, 0U, 0U );
+    FreeRTOS_min_size_t_ExpectAndReturn( xStream.LENGTH, 0U, 0U );
+    uxStreamBufferDistance_ExpectAndReturn( &xStream, 0U, 0U, 0U );
+    vPortFree_Expect( &xStream );
+
+    xReturn = FreeRTOS_recvv( &xSocket, xVector, 1, 0 );
+
+    TEST_ASSERT_EQUAL( 14, xReturn );
+    TEST_ASSERT_EQUAL_PTR( pxNewStream, xSocket.u.xTCP.rxStream );
+
+    free( pxNewStream );
+}
+
+/**
+ * @brief No event is sent when the rxStream is big enough for the window.
+ */
+void test_FreeRTOS_recvv_RxStreamGrow_NotNeeded( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    uint8_t ucBuffer[ 20 ];
+    struct freertos_iovec xVector[ 1 ] = { { ucBuffer, sizeof( ucBuffer ) } };
+
+    prvPrepareTunedSocket( &xSocket );
+    xStream.LENGTH = tcptestSTREAM_LENGTH( tcptestWINDOW_LENGTH );
+    xSocket.u.xTCP.rxStream = &xStream;
+
+    prvExpectRecvvStream( &xSocket, ucBuffer, sizeof( ucBuffer ) );
+
+    xReturn = FreeRTOS_recvv( &xSocket, xVector, 1, 0 );
+
+    TEST_ASSERT_EQUAL( 14, xReturn );
+}
+
+/**
+ * @brief FreeRTOS_sendv() waits for space in the txStream: the time that it
+ *        was blocked is added to the statistics.
+ */
+void test_FreeRTOS_sendv_TCPInfo_StreamBlocked( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    uint8_t ucHeader[ 4 ] = { 0 };
+    uint8_t ucPayload[ 10 ] = { 0 };
+    struct freertos_iovec xVector[ 2 ] = { { ucHeader, sizeof( ucHeader ) }, { ucPayload, sizeof( ucPayload ) } };
+
+    prvPrepareConnectedSocket( &xSocket );
+    xSocket.u.xTCP.xStreamBlockedTicks = 50;
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundTCPSocketsList );
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    uxStreamBufferGetSpace_ExpectAndReturn( &xStream, 13U );
+    xTaskCheckForTimeOut_ExpectAnyArgsAndReturn( pdFALSE );
+    xTaskGetTickCount_ExpectAndReturn( 1000 );
+    xEventGroupWaitBits_ExpectAnyArgsAndReturn( ( EventBits_t ) eSOCKET_SEND );
+    xTaskGetTickCount_ExpectAndReturn( 1250 );
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundTCPSocketsList );
+    uxStreamBufferGetSpace_ExpectAndReturn( &xStream, 14U );
+    uxStreamBufferAdd_ExpectAndReturn( &xStream, sizeof( ucHeader ), ucPayload, sizeof( ucPayload ), sizeof( ucPayload ) );
+    vTaskSuspendAll_Expect();
+    uxStreamBufferAdd_ExpectAndReturn( &xStream, 0U, ucHeader, sizeof( ucHeader ), sizeof( ucHeader ) );
+    uxStreamBufferAdd_ExpectAndReturn( &xStream, 0U, NULL, sizeof( ucPayload ), sizeof( ucPayload ) );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    xSendEventToIPTask_ExpectAndReturn( eTCPTimerEvent, pdPASS );
+
+    xReturn = FreeRTOS_sendv( &xSocket, xVector, 2, 0 );
+
+    TEST_ASSERT_EQUAL( 14, xReturn );
+    TEST_ASSERT_EQUAL( 300, xSocket.u.xTCP.xStreamBlockedTicks );
+}
+
+/**
+ * @brief Invalid parameters are passed to FreeRTOS_GetTCPInfo().
+ */
+void test_FreeRTOS_GetTCPInfo_InvalidParams( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    TCPInfo_t xInfo;
+
+    prvPrepareConnectedSocket( &xSocket );
+
+    xReturn = FreeRTOS_GetTCPInfo( NULL, &xInfo );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    xReturn = FreeRTOS_GetTCPInfo( FREERTOS_INVALID_SOCKET, &xInfo );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    xReturn = FreeRTOS_GetTCPInfo( &xSocket, NULL );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    xSocket.ucProtocol = FREERTOS_IPPROTO_UDP;
+    xReturn = FreeRTOS_GetTCPInfo( &xSocket, &xInfo );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+}
+
+/**
+ * @brief The counters of the socket and its window are copied while the
+ *        scheduler is suspended. The times are converted to ms.
+ */
+void test_FreeRTOS_GetTCPInfo_Counters( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    TCPInfo_t xInfo;
+
+    prvPrepareConnectedSocket( &xSocket );
+    xSocket.u.xTCP.usMSS = 1460U;
+    xSocket.u.xTCP.ulSegmentsSent = 11U;
+    xSocket.u.xTCP.ulSegmentsReceived = 12U;
+    xSocket.u.xTCP.ulBytesReceived = 13U;
+    xSocket.u.xTCP.ulWindowSize = 14U;
+    xSocket.u.xTCP.xZeroWindowTicks = 150;
+    xSocket.u.xTCP.xStreamBlockedTicks = 250;
+    xSocket.u.xTCP.xTCPWindow.ulBytesSent = 21U;
+    xSocket.u.xTCP.xTCPWindow.ulRetransmissions = 22U;
+    xSocket.u.xTCP.xTCPWindow.lSRTT = 40;
+    xSocket.u.xTCP.xTCPWindow.xSize.ulTxWindowLength = 23U;
+    xSocket.u.xTCP.xTCPWindow.xSize.ulRxWindowLength = 24U;
+    xSocket.u.xTCP.xTCPWindow.ulSACKsSent = 25U;
+    xSocket.u.xTCP.xTCPWindow.ulSACKsReceived = 26U;
+
+    vTaskSuspendAll_Expect();
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    xReturn = FreeRTOS_GetTCPInfo( &xSocket, &xInfo );
+
+    TEST_ASSERT_EQUAL( 0, xReturn );
+    TEST_ASSERT_EQUAL( eESTABLISHED, xInfo.ucState );
+    TEST_ASSERT_EQUAL( 1460U, xInfo.usMSS );
+    TEST_ASSERT_EQUAL_UINT32( 21U, xInfo.ulBytesSent );
+    TEST_ASSERT_EQUAL_UINT32( 13U, xInfo.ulBytesReceived );
+    TEST_ASSERT_EQUAL_UINT32( 11U, xInfo.ulSegmentsSent );
+    TEST_ASSERT_EQUAL_UINT32( 12U, xInfo.ulSegmentsReceived );
+    TEST_ASSERT_EQUAL_UINT32( 22U, xInfo.ulRetransmissions );
+    TEST_ASSERT_EQUAL_UINT32( 40U, xInfo.ulSRTT );
+    /* Without the RFC 6298 RTO, the first retransmission takes place after
+     * 2 * SRTT. */
+    TEST_ASSERT_EQUAL_UINT32( 80U, xInfo.ulRTO );
+    TEST_ASSERT_EQUAL_UINT32( 14U, xInfo.ulPeerWindow );
+    TEST_ASSERT_EQUAL_UINT32( 23U, xInfo.ulTxWindow );
+    TEST_ASSERT_EQUAL_UINT32( 24U, xInfo.ulRxWindow );
+    TEST_ASSERT_EQUAL_UINT32( 25U, xInfo.ulSACKsSent );
+    TEST_ASSERT_EQUAL_UINT32( 26U, xInfo.ulSACKsReceived );
+    TEST_ASSERT_EQUAL_UINT32( pdTICKS_TO_MS( 150 ), xInfo.ulZeroWindowTime );
+    TEST_ASSERT_EQUAL_UINT32( pdTICKS_TO_MS( 250 ), xInfo.ulStreamBlockedTime );
+}
+
+/**
+ * @brief A zero-window period that is still going on is included in the
+ *        zero-window time, without ending the period.
+ */
+void test_FreeRTOS_GetTCPInfo_ZeroWindowOngoing( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    TCPInfo_t xInfo;
+
+    prvPrepareConnectedSocket( &xSocket );
+    xSocket.u.xTCP.xZeroWindowTicks = 150;
+    xSocket.u.xTCP.bits.bZeroWindow = pdTRUE_UNSIGNED;
+    xSocket.u.xTCP.xZeroWindowStart = 1000;
+
+    vTaskSuspendAll_Expect();
+    xTaskGetTickCount_ExpectAndReturn( 1400 );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    xReturn = FreeRTOS_GetTCPInfo( &xSocket, &xInfo );
+
+    TEST_ASSERT_EQUAL( 0, xReturn );
+    TEST_ASSERT_EQUAL_UINT32( pdTICKS_TO_MS( 550 ), xInfo.ulZeroWindowTime );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xSocket.u.xTCP.bits.bZeroWindow );
+    TEST_ASSERT_EQUAL( 150, xSocket.u.xTCP.xZeroWindowTicks );
+}
+
+/**
+ * @brief A socket that is reused by FreeRTOS_listen() starts with cleared
+ *        counters, also a zero-window period of the previous connection
+ *        is forgotten.
+ */
+void test_FreeRTOS_listen_TCPInfo_ReuseClearsCounters( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+
+    memset( &xSocket, 0, sizeof( xSocket ) );
+    xSocket.ucProtocol = FREERTOS_IPPROTO_TCP;
+    xSocket.u.xTCP.eTCPState = eCLOSE_WAIT;
+    xSocket.u.xTCP.bits.bReuseSocket = pdTRUE_UNSIGNED;
+    xSocket.u.xTCP.bits.bZeroWindow = pdTRUE_UNSIGNED;
+    xSocket.u.xTCP.ulSegmentsSent = 11U;
+    xSocket.u.xTCP.ulSegmentsReceived = 12U;
+    xSocket.u.xTCP.ulBytesReceived = 13U;
+    xSocket.u.xTCP.xZeroWindowTicks = 150;
+    xSocket.u.xTCP.xStreamBlockedTicks = 250;
+    xSocket.u.xTCP.xTCPWindow.ulBytesSent = 21U;
+    xSocket.u.xTCP.xTCPWindow.ulRetransmissions = 22U;
+    xSocket.u.xTCP.xTCPWindow.ulSACKsSent = 25U;
+    xSocket.u.xTCP.xTCPWindow.ulSACKsReceived = 26U;
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundTCPSocketsList );
+    FreeRTOS_min_int32_ExpectAndReturn( ( int32_t ) 0xffff, 4, 4 );
+    /* vTCPTxRefFlush() */
+    vTaskSuspendAll_Expect();
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+    vTCPStateChange_Expect( &xSocket, eTCP_LISTEN );
+
+    xReturn = FreeRTOS_listen( &xSocket, 4 );
+
+    TEST_ASSERT_EQUAL( 0, xReturn );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xSocket.u.xTCP.bits.bReuseSocket );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xSocket.u.xTCP.bits.bZeroWindow );
+    TEST_ASSERT_EQUAL_UINT32( 0U, xSocket.u.xTCP.ulSegmentsSent );
+    TEST_ASSERT_EQUAL_UINT32( 0U, xSocket.u.xTCP.ulSegmentsReceived );
+    TEST_ASSERT_EQUAL_UINT32( 0U, xSocket.u.xTCP.ulBytesReceived );
+    TEST_ASSERT_EQUAL( 0, xSocket.u.xTCP.xZeroWindowTicks );
+    TEST_ASSERT_EQUAL( 0, xSocket.u.xTCP.xStreamBlockedTicks );
+    TEST_ASSERT_EQUAL_UINT32( 0U, xSocket.u.xTCP.xTCPWindow.ulBytesSent );
+    TEST_ASSERT_EQUAL_UINT32( 0U, xSocket.u.xTCP.xTCPWindow.ulRetransmissions );
+    TEST_ASSERT_EQUAL_UINT32( 0U, xSocket.u.xTCP.xTCPWindow.ulSACKsSent );
+    TEST_ASSERT_EQUAL_UINT32( 0U, xSocket.u.xTCP.xTCPWindow.ulSACKsReceived );
+}
@@ -0,0 +1,1357 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mock_task.h"
+#include "mock_list.h"
+#include "mock_event_groups.h"
+
+/* This must come after list.h is included (in this case, indirectly
+ * by mock_list.h). */
+#include "mock_Sockets_DiffConfig2_list_macros.h"
+#include "mock_NetworkBufferManagement.h"
+#include "mock_FreeRTOS_IPv4_Sockets.h"
+#include "mock_FreeRTOS_IP.h"
+#include "mock_FreeRTOS_IP_Private.h"
+#include "mock_FreeRTOS_IPv4.h"
+#include "mock_FreeRTOS_ARP.h"
+
+#include "FreeRTOS_Sockets.h"
+
+#include "catch_assert.h"
+
+#include "FreeRTOSIPConfig.h"
+
+/* ============================ EXTERN VARIABLES ============================ */
+
+extern List_t xBoundUDPSocketsList;
+
+BaseType_t xTCPWindowLoggingLevel = 0;
+
+volatile UBaseType_t uxARPCacheGeneration = 0U;
+
+/* The offset of the UDP payload in an IPv4 packet. */
+#define udptestPAYLOAD_OFFSET    ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_UDP_HEADER )
+
+static uint8_t ucEthernetBuffers[ 2 ][ ipconfigNETWORK_MTU + ipSIZE_OF_ETH_HEADER ];
+static NetworkBufferDescriptor_t xNetworkBuffers[ 2 ];
+
+/* The events sent to the IP-task by xSendEventStructToIPTask_Record(). */
+static IPStackEvent_t xSentEvents[ 2 ];
+
+/* ============================== Test Helpers ============================== */
+
+/**
+ * @brief Prepare a bound UDP socket and the network buffers.
+ */
+static void prvPrepareUDPSocket( FreeRTOS_Socket_t * pxSocket )
+{
+    BaseType_t xIndex;
+
+    memset( pxSocket, 0, sizeof( *pxSocket ) );
+    pxSocket->ucProtocol = FREERTOS_IPPROTO_UDP;
+
+    memset( xNetworkBuffers, 0, sizeof( xNetworkBuffers ) );
+    memset( ucEthernetBuffers, 0, sizeof( ucEthernetBuffers ) );
+
+    for( xIndex = 0; xIndex < 2; xIndex++ )
+    {
+        xNetworkBuffers[ xIndex ].pucEthernetBuffer = ucEthernetBuffers[ xIndex ];
+    }
+}
+
+/**
+ * @brief Prepare an IPv4 datagram.
+ */
+static void prvPrepareDatagram( UDPDatagram_t * pxDatagram,
+                                void * pvBuffer,
+                                size_t uxLength )
+{
+    memset( pxDatagram, 0, sizeof( *pxDatagram ) );
+    pxDatagram->pvBuffer = pvBuffer;
+    pxDatagram->uxBufferLength = uxLength;
+    pxDatagram->xAddress.sin_family = FREERTOS_AF_INET4;
+    pxDatagram->xAddress.sin_port = FreeRTOS_htons( 5000 );
+    pxDatagram->xAddress.sin_address.ulIP_IPv4 = 0x0A000001;
+}
+
+/**
+ * @brief Expect a datagram to be copied into a new network buffer.
+ */
+static void prvExpectDatagramPrepared( UDPDatagram_t * pxDatagram,
+                                       NetworkBufferDescriptor_t * pxNetworkBuffer )
+{
+    pxGetNetworkBufferWithDescriptor_ExpectAndReturn( udptestPAYLOAD_OFFSET + pxDatagram->uxBufferLength, 0, pxNetworkBuffer );
+    xTaskCheckForTimeOut_ExpectAnyArgsAndReturn( pdFALSE );
+    xSend_UDP_Update_IPv4_ExpectAndReturn( pxNetworkBuffer, &( pxDatagram->xAddress ), NULL );
+    listGET_LIST_ITEM_VALUE_ExpectAnyArgsAndReturn( 1234 );
+    vListInsertEnd_ExpectAnyArgs();
+}
+
+/**
+ * @brief Expect one datagram of a segmented write to be prepared.
+ */
+static void prvExpectSegmentPrepared( const UDPDatagram_t * pxDatagram,
+                                      size_t uxSegmentSize,
+                                      size_t uxRemaining,
+                                      NetworkBufferDescriptor_t * pxNetworkBuffer )
+{
+    size_t uxLength = ( uxRemaining < uxSegmentSize ) ? uxRemaining : uxSegmentSize;
+
+    FreeRTOS_min_size_t_ExpectAndReturn( uxSegmentSize, uxRemaining, uxLength );
+    pxGetNetworkBufferWithDescriptor_ExpectAndReturn( udptestPAYLOAD_OFFSET + uxLength, 0, pxNetworkBuffer );
+    xTaskCheckForTimeOut_ExpectAnyArgsAndReturn( pdFALSE );
+    xSend_UDP_Update_IPv4_ExpectAndReturn( pxNetworkBuffer, &( pxDatagram->xAddress ), NULL );
+    listGET_LIST_ITEM_VALUE_ExpectAnyArgsAndReturn( 1234 );
+    vListInsertEnd_ExpectAnyArgs();
+}
+
+/**
+ * @brief Expect the datagrams of a segmented write to be handed over to the
+ *        IP-task by prvSendBatchHandOver().
+ */
+static void prvExpectSegmentsHandedOver( FreeRTOS_Socket_t * pxSocket,
+                                         size_t uxCount )
+{
+    size_t uxIndex;
+
+    listLIST_IS_EMPTY_ExpectAnyArgsAndReturn( pdFALSE );
+
+    vTaskSuspendAll_Expect();
+    listLIST_IS_EMPTY_ExpectAndReturn( &( pxSocket->u.xUDP.xTxBatchList ), pdTRUE );
+
+    for( uxIndex = 0U; uxIndex < uxCount; uxIndex++ )
+    {
+        listLIST_IS_EMPTY_ExpectAnyArgsAndReturn( pdFALSE );
+        listGET_OWNER_OF_HEAD_ENTRY_ExpectAnyArgsAndReturn( &( xNetworkBuffers[ uxIndex ] ) );
+        uxListRemove_ExpectAndReturn( &( xNetworkBuffers[ uxIndex ].xBufferListItem ), 0 );
+        vListInsertEnd_Expect( &( pxSocket->u.xUDP.xTxBatchList ), &( xNetworkBuffers[ uxIndex ].xBufferListItem ) );
+    }
+
+    listLIST_IS_EMPTY_ExpectAnyArgsAndReturn( pdTRUE );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+    xSendEventStructToIPTask_ExpectAnyArgsAndReturn( pdPASS );
+}
+
+/**
+ * @brief Record the events that are sent to the IP-task.
+ */
+static BaseType_t xSendEventStructToIPTask_Record( const IPStackEvent_t * pxEvent,
+                                                   TickType_t uxTimeout,
+                                                   int cmock_num_calls )
+{
+    ( void ) uxTimeout;
+
+    TEST_ASSERT_LESS_THAN( 2, cmock_num_calls );
+    xSentEvents[ cmock_num_calls ] = *pxEvent;
+
+    return pdPASS;
+}
+
+/**
+ * @brief Let a prepared UDP socket be connected to the peer of 'pxDatagram'.
+ */
+static void prvConnectUDPSocket( FreeRTOS_Socket_t * pxSocket,
+                                 const UDPDatagram_t * pxDatagram )
+{
+    memcpy( &( pxSocket->u.xUDP.xRemoteAddress ), &( pxDatagram->xAddress ), sizeof( pxDatagram->xAddress ) );
+    pxSocket->u.xUDP.xIsConnected = pdTRUE;
+}
+
+/* =============================== Test Cases =============================== */
+
+/**
+ * @brief Invalid parameters are passed to FreeRTOS_sendto_batch.
+ */
+void test_FreeRTOS_sendto_batch_InvalidParams( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagram;
+    uint8_t ucData[ 10 ] = { 0 };
+
+    prvPrepareUDPSocket( &xSocket );
+    prvPrepareDatagram( &xDatagram, ucData, sizeof( ucData ) );
+
+    /* No datagrams. */
+    xReturn = FreeRTOS_sendto_batch( &xSocket, NULL, 1, 0 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    xReturn = FreeRTOS_sendto_batch( &xSocket, &xDatagram, 0, 0 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    /* Invalid socket. */
+    xReturn = FreeRTOS_sendto_batch( FREERTOS_INVALID_SOCKET, &xDatagram, 1, 0 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    /* The socket is not bound. */
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( NULL );
+    xReturn = FreeRTOS_sendto_batch( &xSocket, &xDatagram, 1, 0 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    /* A TCP socket. */
+    xSocket.ucProtocol = FREERTOS_IPPROTO_TCP;
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+    xReturn = FreeRTOS_sendto_batch( &xSocket, &xDatagram, 1, 0 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    TEST_ASSERT_EQUAL( 0, xDatagram.uxDataLength );
+}
+
+/**
+ * @brief The first datagram does not fit in a packet, nothing is sent.
+ */
+void test_FreeRTOS_sendto_batch_DatagramTooLong( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagram;
+    uint8_t ucData[ 10 ] = { 0 };
+
+    prvPrepareUDPSocket( &xSocket );
+    prvPrepareDatagram( &xDatagram, ucData, ipconfigNETWORK_MTU );
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+    vListInitialise_ExpectAnyArgs();
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    listCURRENT_LIST_LENGTH_ExpectAnyArgsAndReturn( 0 );
+
+    xReturn = FreeRTOS_sendto_batch( &xSocket, &xDatagram, 1, FREERTOS_MSG_DONTWAIT );
+
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+    TEST_ASSERT_EQUAL( 0, xDatagram.uxDataLength );
+}
+
+/**
+ * @brief Two datagrams are passed to the IP-task with a single message.
+ */
+void test_FreeRTOS_sendto_batch_HappyPath( void )
+{
+    BaseType_t xReturn;
+    BaseType_t xIndex;
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagrams[ 2 ];
+    uint8_t ucData[ 2 ][ 20 ];
+
+    prvPrepareUDPSocket( &xSocket );
+    memset( ucData[ 0 ], 0xAA, sizeof( ucData[ 0 ] ) );
+    memset( ucData[ 1 ], 0x55, sizeof( ucData[ 1 ] ) );
+    prvPrepareDatagram( &( xDatagrams[ 0 ] ), ucData[ 0 ], 20 );
+    prvPrepareDatagram( &( xDatagrams[ 1 ] ), ucData[ 1 ], 12 );
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+    vListInitialise_ExpectAnyArgs();
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    prvExpectDatagramPrepared( &( xDatagrams[ 0 ] ), &( xNetworkBuffers[ 0 ] ) );
+    prvExpectDatagramPrepared( &( xDatagrams[ 1 ] ), &( xNetworkBuffers[ 1 ] ) );
+    listCURRENT_LIST_LENGTH_ExpectAnyArgsAndReturn( 2 );
+
+    /* The packets are moved to the batch list of the socket. */
+    vTaskSuspendAll_Expect();
+    listLIST_IS_EMPTY_ExpectAndReturn( &( xSocket.u.xUDP.xTxBatchList ), pdTRUE );
+
+    for( xIndex = 0; xIndex < 2; xIndex++ )
+    {
+        listLIST_IS_EMPTY_ExpectAnyArgsAndReturn( pdFALSE );
+        listGET_OWNER_OF_HEAD_ENTRY_ExpectAnyArgsAndReturn( &( xNetworkBuffers[ xIndex ] ) );
+        uxListRemove_ExpectAndReturn( &( xNetworkBuffers[ xIndex ].xBufferListItem ), 0 );
+        vListInsertEnd_Expect( &( xSocket.u.xUDP.xTxBatchList ), &( xNetworkBuffers[ xIndex ].xBufferListItem ) );
+    }
+
+    listLIST_IS_EMPTY_ExpectAnyArgsAndReturn( pdTRUE );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+    xSendEventStructToIPTask_ExpectAnyArgsAndReturn( pdPASS );
+
+    xReturn = FreeRTOS_sendto_batch( &xSocket, xDatagrams, 2, FREERTOS_MSG_DONTWAIT );
+
+    TEST_ASSERT_EQUAL( 2, xReturn );
+
+    for( xIndex = 0; xIndex < 2; xIndex++ )
+    {
+        TEST_ASSERT_EQUAL( xDatagrams[ xIndex ].uxBufferLength, xDatagrams[ xIndex ].uxDataLength );
+        TEST_ASSERT_EQUAL( udptestPAYLOAD_OFFSET + xDatagrams[ xIndex ].uxBufferLength, xNetworkBuffers[ xIndex ].xDataLength );
+        TEST_ASSERT_EQUAL( FreeRTOS_htons( 5000 ), xNetworkBuffers[ xIndex ].usPort );
+        TEST_ASSERT_EQUAL( 1234, xNetworkBuffers[ xIndex ].usBoundPort );
+        TEST_ASSERT_EQUAL_MEMORY( ucData[ xIndex ], &( ucEthernetBuffers[ xIndex ][ udptestPAYLOAD_OFFSET ] ), xDatagrams[ xIndex ].uxBufferLength );
+    }
+}
+
+/**
+ * @brief The IP-task can not be reached, the queued packets are released.
+ */
+void test_FreeRTOS_sendto_batch_IPTaskNotReached( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagram;
+    uint8_t ucData[ 10 ] = { 0 };
+
+    prvPrepareUDPSocket( &xSocket );
+    prvPrepareDatagram( &xDatagram, ucData, sizeof( ucData ) );
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+    vListInitialise_ExpectAnyArgs();
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    prvExpectDatagramPrepared( &xDatagram, &( xNetworkBuffers[ 0 ] ) );
+    listCURRENT_LIST_LENGTH_ExpectAnyArgsAndReturn( 1 );
+
+    vTaskSuspendAll_Expect();
+    listLIST_IS_EMPTY_ExpectAndReturn( &( xSocket.u.xUDP.xTxBatchList ), pdTRUE );
+    listLIST_IS_EMPTY_ExpectAnyArgsAndReturn( pdFALSE );
+    listGET_OWNER_OF_HEAD_ENTRY_ExpectAnyArgsAndReturn( &( xNetworkBuffers[ 0 ] ) );
+    uxListRemove_ExpectAndReturn( &( xNetworkBuffers[ 0 ].xBufferListItem ), 0 );
+    vListInsertEnd_Expect( &( xSocket.u.xUDP.xTxBatchList ), &( xNetworkBuffers[ 0 ].xBufferListItem ) );
+    listLIST_IS_EMPTY_ExpectAnyArgsAndReturn( pdTRUE );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    xSendEventStructToIPTask_ExpectAnyArgsAndReturn( pdFAIL );
+
+    /* The packet is taken back from the socket and released. */
+    vTaskSuspendAll_Expect();
+    listLIST_IS_EMPTY_ExpectAndReturn( &( xSocket.u.xUDP.xTxBatchList ), pdFALSE );
+    listGET_OWNER_OF_HEAD_ENTRY_ExpectAndReturn( &( xSocket.u.xUDP.xTxBatchList ), &( xNetworkBuffers[ 0 ] ) );
+    uxListRemove_ExpectAndReturn( &( xNetworkBuffers[ 0 ].xBufferListItem ), 0 );
+    vReleaseNetworkBufferAndDescriptor_Expect( &( xNetworkBuffers[ 0 ] ) );
+    listLIST_IS_EMPTY_ExpectAndReturn( &( xSocket.u.xUDP.xTxBatchList ), pdTRUE );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    xReturn = FreeRTOS_sendto_batch( &xSocket, &xDatagram, 1, FREERTOS_MSG_DONTWAIT );
+
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EAGAIN, xReturn );
+}
+
+/**
+ * @brief Invalid parameters are passed to FreeRTOS_recvfrom_batch.
+ */
+void test_FreeRTOS_recvfrom_batch_InvalidParams( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagram;
+    uint8_t ucData[ 10 ] = { 0 };
+
+    prvPrepareUDPSocket( &xSocket );
+    prvPrepareDatagram( &xDatagram, ucData, sizeof( ucData ) );
+
+    /* The socket is not bound. */
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( NULL );
+    xReturn = FreeRTOS_recvfrom_batch( &xSocket, &xDatagram, 1, 0 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+    xReturn = FreeRTOS_recvfrom_batch( &xSocket, NULL, 1, 0 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+    xReturn = FreeRTOS_recvfrom_batch( &xSocket, &xDatagram, 0, 0 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    /* Peeking is not supported. */
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+    xReturn = FreeRTOS_recvfrom_batch( &xSocket, &xDatagram, 1, FREERTOS_MSG_PEEK );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+}
+
+/**
+ * @brief No packet is waiting and the call may not block.
+ */
+void test_FreeRTOS_recvfrom_batch_NoPacket( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagram;
+    uint8_t ucData[ 10 ] = { 0 };
+
+    prvPrepareUDPSocket( &xSocket );
+    prvPrepareDatagram( &xDatagram, ucData, sizeof( ucData ) );
+    xSocket.xReceiveBlockTime = 100U;
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+    listCURRENT_LIST_LENGTH_ExpectAndReturn( &( xSocket.u.xUDP.xWaitingPacketsList ), 0 );
+
+    xReturn = FreeRTOS_recvfrom_batch( &xSocket, &xDatagram, 1, FREERTOS_MSG_DONTWAIT );
+
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EWOULDBLOCK, xReturn );
+}
+
+/**
+ * @brief Two packets are waiting, the caller can take three. Both packets are
+ *        copied and released.
+ */
+void test_FreeRTOS_recvfrom_batch_HappyPath( void )
+{
+    BaseType_t xReturn;
+    BaseType_t xIndex;
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagrams[ 3 ];
+    uint8_t ucData[ 3 ][ 20 ];
+
+    prvPrepareUDPSocket( &xSocket );
+
+    for( xIndex = 0; xIndex < 3; xIndex++ )
+    {
+        prvPrepareDatagram( &( xDatagrams[ xIndex ] ), ucData[ xIndex ], sizeof( ucData[ xIndex ] ) );
+    }
+
+    for( xIndex = 0; xIndex < 2; xIndex++ )
+    {
+        memset( &( ucEthernetBuffers[ xIndex ][ udptestPAYLOAD_OFFSET ] ), 0x11 * ( xIndex + 1 ), 8 );
+        xNetworkBuffers[ xIndex ].xDataLength = udptestPAYLOAD_OFFSET + 8U;
+    }
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+
+    /* The first packet is taken by prvRecvFromWaitForPacket(). */
+    listCURRENT_LIST_LENGTH_ExpectAndReturn( &( xSocket.u.xUDP.xWaitingPacketsList ), 2 );
+    vTaskSuspendAll_Expect();
+    listGET_OWNER_OF_HEAD_ENTRY_ExpectAndReturn( &( xSocket.u.xUDP.xWaitingPacketsList ), &( xNetworkBuffers[ 0 ] ) );
+    uxListRemove_ExpectAndReturn( &( xNetworkBuffers[ 0 ].xBufferListItem ), 1 );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    uxIPHeaderSizePacket_ExpectAndReturn( &( xNetworkBuffers[ 0 ] ), ipSIZE_OF_IPv4_HEADER );
+    xRecv_Update_IPv4_ExpectAndReturn( &( xNetworkBuffers[ 0 ] ), &( xDatagrams[ 0 ].xAddress ), udptestPAYLOAD_OFFSET );
+    vReleaseNetworkBufferAndDescriptor_Expect( &( xNetworkBuffers[ 0 ] ) );
+
+    /* The second one is already waiting. */
+    vTaskSuspendAll_Expect();
+    listLIST_IS_EMPTY_ExpectAndReturn( &( xSocket.u.xUDP.xWaitingPacketsList ), pdFALSE );
+    listGET_OWNER_OF_HEAD_ENTRY_ExpectAndReturn( &( xSocket.u.xUDP.xWaitingPacketsList ), &( xNetworkBuffers[ 1 ] ) );
+    uxListRemove_ExpectAndReturn( &( xNetworkBuffers[ 1 ].xBufferListItem ), 0 );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    uxIPHeaderSizePacket_ExpectAndReturn( &( xNetworkBuffers[ 1 ] ), ipSIZE_OF_IPv4_HEADER );
+    xRecv_Update_IPv4_ExpectAndReturn( &( xNetworkBuffers[ 1 ] ), &( xDatagrams[ 1 ].xAddress ), udptestPAYLOAD_OFFSET );
+    vReleaseNetworkBufferAndDescriptor_Expect( &( xNetworkBuffers[ 1 ] ) );
+
+    /* There is no third packet, the call does not block for it. */
+    vTaskSuspendAll_Expect();
+    listLIST_IS_EMPTY_ExpectAndReturn( &( xSocket.u.xUDP.xWaitingPacketsList ), pdTRUE );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    xReturn = FreeRTOS_recvfrom_batch( &xSocket, xDatagrams, 3, 0 );
+
+    TEST_ASSERT_EQUAL( 2, xReturn );
+
+    for( xIndex = 0; xIndex < 2; xIndex++ )
+    {
+        TEST_ASSERT_EQUAL( 8, xDatagrams[ xIndex ].uxDataLength );
+        TEST_ASSERT_EQUAL_MEMORY( &( ucEthernetBuffers[ xIndex ][ udptestPAYLOAD_OFFSET ] ), ucData[ xIndex ], 8 );
+    }
+
+    TEST_ASSERT_EQUAL( 0, xDatagrams[ 2 ].uxDataLength );
+}
+
+/**
+ * @brief The only waiting packet can not be stored: the error is returned,
+ *        not zero.
+ */
+void test_FreeRTOS_recvfrom_batch_StoreFailed( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagrams[ 2 ];
+    uint8_t ucData[ 20 ];
+
+    prvPrepareUDPSocket( &xSocket );
+    prvPrepareDatagram( &( xDatagrams[ 0 ] ), ucData, sizeof( ucData ) );
+    prvPrepareDatagram( &( xDatagrams[ 1 ] ), ucData, sizeof( ucData ) );
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+
+    listCURRENT_LIST_LENGTH_ExpectAndReturn( &( xSocket.u.xUDP.xWaitingPacketsList ), 1 );
+    vTaskSuspendAll_Expect();
+    listGET_OWNER_OF_HEAD_ENTRY_ExpectAndReturn( &( xSocket.u.xUDP.xWaitingPacketsList ), &( xNetworkBuffers[ 0 ] ) );
+    uxListRemove_ExpectAndReturn( &( xNetworkBuffers[ 0 ].xBufferListItem ), 0 );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    /* An unknown IP header size. */
+    uxIPHeaderSizePacket_ExpectAndReturn( &( xNetworkBuffers[ 0 ] ), 0U );
+    vReleaseNetworkBufferAndDescriptor_Expect( &( xNetworkBuffers[ 0 ] ) );
+
+    vTaskSuspendAll_Expect();
+    listLIST_IS_EMPTY_ExpectAndReturn( &( xSocket.u.xUDP.xWaitingPacketsList ), pdTRUE );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    xReturn = FreeRTOS_recvfrom_batch( &xSocket, xDatagrams, 2, 0 );
+
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+}
+
+/**
+ * @brief A packet that can not be stored is skipped, the next one is
+ *        returned.
+ */
+void test_FreeRTOS_recvfrom_batch_StoreFailed_NextStored( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagrams[ 2 ];
+    uint8_t ucData[ 2 ][ 20 ];
+
+    prvPrepareUDPSocket( &xSocket );
+    prvPrepareDatagram( &( xDatagrams[ 0 ] ), ucData[ 0 ], sizeof( ucData[ 0 ] ) );
+    prvPrepareDatagram( &( xDatagrams[ 1 ] ), ucData[ 1 ], sizeof( ucData[ 1 ] ) );
+    xNetworkBuffers[ 1 ].xDataLength = udptestPAYLOAD_OFFSET + 8U;
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+
+    listCURRENT_LIST_LENGTH_ExpectAndReturn( &( xSocket.u.xUDP.xWaitingPacketsList ), 2 );
+    vTaskSuspendAll_Expect();
+    listGET_OWNER_OF_HEAD_ENTRY_ExpectAndReturn( &( xSocket.u.xUDP.xWaitingPacketsList ), &( xNetworkBuffers[ 0 ] ) );
+    uxListRemove_ExpectAndReturn( &( xNetworkBuffers[ 0 ].xBufferListItem ), 1 );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    uxIPHeaderSizePacket_ExpectAndReturn( &( xNetworkBuffers[ 0 ] ), 0U );
+    vReleaseNetworkBufferAndDescriptor_Expect( &( xNetworkBuffers[ 0 ] ) );
+
+    vTaskSuspendAll_Expect();
+    listLIST_IS_EMPTY_ExpectAndReturn( &( xSocket.u.xUDP.xWaitingPacketsList ), pdFALSE );
+    listGET_OWNER_OF_HEAD_ENTRY_ExpectAndReturn( &( xSocket.u.xUDP.xWaitingPacketsList ), &( xNetworkBuffers[ 1 ] ) );
+    uxListRemove_ExpectAndReturn( &( xNetworkBuffers[ 1 ].xBufferListItem ), 0 );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    uxIPHeaderSizePacket_ExpectAndReturn( &( xNetworkBuffers[ 1 ] ), ipSIZE_OF_IPv4_HEADER );
+    xRecv_Update_IPv4_ExpectAndReturn( &( xNetworkBuffers[ 1 ] ), &( xDatagrams[ 0 ].xAddress ), udptestPAYLOAD_OFFSET );
+    vReleaseNetworkBufferAndDescriptor_Expect( &( xNetworkBuffers[ 1 ] ) );
+
+    vTaskSuspendAll_Expect();
+    listLIST_IS_EMPTY_ExpectAndReturn( &( xSocket.u.xUDP.xWaitingPacketsList ), pdTRUE );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    xReturn = FreeRTOS_recvfrom_batch( &xSocket, xDatagrams, 2, 0 );
+
+    TEST_ASSERT_EQUAL( 1, xReturn );
+    TEST_ASSERT_EQUAL( 8, xDatagrams[ 0 ].uxDataLength );
+}
+
+/**
+ * @brief Invalid parameters are passed to FreeRTOS_sendmsg.
+ */
+void test_FreeRTOS_sendmsg_InvalidParams( void )
+{
+    int32_t lReturn;
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagram;
+    uint8_t ucData[ 10 ] = { 0 };
+    struct freertos_iovec xVector[ 2 ] = { { ucData, 4 }, { NULL, 6 } };
+
+    prvPrepareUDPSocket( &xSocket );
+    prvPrepareDatagram( &xDatagram, ucData, sizeof( ucData ) );
+
+    lReturn = FreeRTOS_sendmsg( &xSocket, NULL, 1, 0, &( xDatagram.xAddress ), sizeof( xDatagram.xAddress ) );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, lReturn );
+
+    lReturn = FreeRTOS_sendmsg( &xSocket, xVector, 0, 0, &( xDatagram.xAddress ), sizeof( xDatagram.xAddress ) );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, lReturn );
+
+    /* A NULL buffer with a non-zero length. */
+    lReturn = FreeRTOS_sendmsg( &xSocket, xVector, 2, 0, &( xDatagram.xAddress ), sizeof( xDatagram.xAddress ) );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, lReturn );
+
+    /* Zero-copy is not supported. */
+    lReturn = FreeRTOS_sendmsg( &xSocket, xVector, 1, FREERTOS_ZERO_COPY, &( xDatagram.xAddress ), sizeof( xDatagram.xAddress ) );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, lReturn );
+
+    /* No destination. */
+    lReturn = FreeRTOS_sendmsg( &xSocket, xVector, 1, 0, NULL, 0 );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, lReturn );
+}
+
+/**
+ * @brief The buffers are gathered into a single datagram.
+ */
+void test_FreeRTOS_sendmsg_HappyPath( void )
+{
+    int32_t lReturn;
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagram;
+    uint8_t ucHeader[ 4 ];
+    uint8_t ucPayload[ 6 ];
+    struct freertos_iovec xVector[ 3 ] = { { ucHeader, sizeof( ucHeader ) }, { NULL, 0 }, { ucPayload, sizeof( ucPayload ) } };
+
+    prvPrepareUDPSocket( &xSocket );
+    prvPrepareDatagram( &xDatagram, NULL, 0 );
+    memset( ucHeader, 0x11, sizeof( ucHeader ) );
+    memset( ucPayload, 0x22, sizeof( ucPayload ) );
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    pxGetNetworkBufferWithDescriptor_ExpectAndReturn( udptestPAYLOAD_OFFSET + 10U, 0, &( xNetworkBuffers[ 0 ] ) );
+    xTaskCheckForTimeOut_ExpectAnyArgsAndReturn( pdFALSE );
+    xSend_UDP_Update_IPv4_ExpectAndReturn( &( xNetworkBuffers[ 0 ] ), &( xDatagram.xAddress ), NULL );
+    listGET_LIST_ITEM_VALUE_ExpectAnyArgsAndReturn( 1234 );
+    xSendEventStructToIPTask_ExpectAnyArgsAndReturn( pdPASS );
+
+    lReturn = FreeRTOS_sendmsg( &xSocket, xVector, 3, FREERTOS_MSG_DONTWAIT, &( xDatagram.xAddress ), sizeof( xDatagram.xAddress ) );
+
+    TEST_ASSERT_EQUAL( 10, lReturn );
+    TEST_ASSERT_EQUAL_MEMORY( ucHeader, &( ucEthernetBuffers[ 0 ][ udptestPAYLOAD_OFFSET ] ), sizeof( ucHeader ) );
+    TEST_ASSERT_EQUAL_MEMORY( ucPayload, &( ucEthernetBuffers[ 0 ][ udptestPAYLOAD_OFFSET + sizeof( ucHeader ) ] ), sizeof( ucPayload ) );
+    TEST_ASSERT_EQUAL( udptestPAYLOAD_OFFSET + 10U, xNetworkBuffers[ 0 ].xDataLength );
+}
+
+/**
+ * @brief A socket with a segment size splits the gathered data into several
+ *        datagrams, like FreeRTOS_sendto() does. A datagram may take bytes
+ *        from more than one buffer.
+ */
+void test_FreeRTOS_sendmsg_Segmented( void )
+{
+    int32_t lReturn;
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagram;
+    uint8_t ucHeader[ 7 ];
+    uint8_t ucPayload[ 18 ];
+    struct freertos_iovec xVector[ 2 ] = { { ucHeader, sizeof( ucHeader ) }, { ucPayload, sizeof( ucPayload ) } };
+    size_t uxIndex;
+
+    prvPrepareUDPSocket( &xSocket );
+    xSocket.u.xUDP.uxSegmentSize = 16U;
+    prvPrepareDatagram( &xDatagram, NULL, 0 );
+    memset( ucHeader, 0xAA, sizeof( ucHeader ) );
+
+    for( uxIndex = 0U; uxIndex < sizeof( ucPayload ); uxIndex++ )
+    {
+        ucPayload[ uxIndex ] = ( uint8_t ) uxIndex;
+    }
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+    vListInitialise_ExpectAnyArgs();
+    vTaskSetTimeOutState_ExpectAnyArgs();
+
+    prvExpectSegmentPrepared( &xDatagram, 16U, 25U, &( xNetworkBuffers[ 0 ] ) );
+    prvExpectSegmentPrepared( &xDatagram, 16U, 9U, &( xNetworkBuffers[ 1 ] ) );
+    prvExpectSegmentsHandedOver( &xSocket, 2U );
+
+    lReturn = FreeRTOS_sendmsg( &xSocket, xVector, 2, FREERTOS_MSG_DONTWAIT, &( xDatagram.xAddress ), sizeof( xDatagram.xAddress ) );
+
+    TEST_ASSERT_EQUAL( 25, lReturn );
+    TEST_ASSERT_EQUAL_MEMORY( ucHeader, &( ucEthernetBuffers[ 0 ][ udptestPAYLOAD_OFFSET ] ), sizeof( ucHeader ) );
+    TEST_ASSERT_EQUAL_MEMORY( ucPayload, &( ucEthernetBuffers[ 0 ][ udptestPAYLOAD_OFFSET + sizeof( ucHeader ) ] ), 9U );
+    TEST_ASSERT_EQUAL_MEMORY( &( ucPayload[ 9 ] ), &( ucEthernetBuffers[ 1 ][ udptestPAYLOAD_OFFSET ] ), 9U );
+}
+
+/**
+ * @brief Invalid parameters are passed to FreeRTOS_select_ready.
+ */
+void test_FreeRTOS_select_ready_InvalidParams( void )
+{
+    SocketSelect_t xSocketSet;
+    SocketReady_t xReady[ 2 ];
+    BaseType_t xReturn;
+
+    memset( &xSocketSet, 0, sizeof( xSocketSet ) );
+
+    xReturn = FreeRTOS_select_ready( &xSocketSet, NULL, 2, 0U );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    xReturn = FreeRTOS_select_ready( &xSocketSet, xReady, 0, 0U );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+}
+
+/**
+ * @brief Only the events that the user selected are reported, and only those
+ *        are consumed. Other bits stay in 'xSocketBits'.
+ */
+void test_FreeRTOS_select_ready_MaskedWithSelectBits( void )
+{
+    SocketSelect_t xSocketSet;
+    SocketReady_t xReady[ 2 ];
+    FreeRTOS_Socket_t xSocket;
+    BaseType_t xReturn;
+
+    memset( &xSocketSet, 0, sizeof( xSocketSet ) );
+    memset( xReady, 0, sizeof( xReady ) );
+    prvPrepareUDPSocket( &xSocket );
+    xSocket.xSelectBits = ( EventBits_t ) eSELECT_READ | ( EventBits_t ) eSELECT_EXCEPT;
+    xSocket.xSocketBits = ( EventBits_t ) eSELECT_READ | ( EventBits_t ) eSELECT_WRITE;
+
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    vTaskSuspendAll_Expect();
+    listLIST_IS_EMPTY_ExpectAndReturn( &( xSocketSet.xReadyList ), pdFALSE );
+    listGET_OWNER_OF_HEAD_ENTRY_ExpectAndReturn( &( xSocketSet.xReadyList ), &xSocket );
+    uxListRemove_ExpectAndReturn( &( xSocket.xSelectReadyItem ), 0 );
+    listLIST_IS_EMPTY_ExpectAndReturn( &( xSocketSet.xReadyList ), pdTRUE );
+    listLIST_IS_EMPTY_ExpectAndReturn( &( xSocketSet.xReadyList ), pdTRUE );
+    xEventGroupClearBits_ExpectAnyArgsAndReturn( 0U );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    xReturn = FreeRTOS_select_ready( &xSocketSet, xReady, 2, 0U );
+
+    TEST_ASSERT_EQUAL( 1, xReturn );
+    TEST_ASSERT_EQUAL_PTR( &xSocket, xReady[ 0 ].xSocket );
+    TEST_ASSERT_EQUAL( eSELECT_READ, xReady[ 0 ].xEvents );
+    TEST_ASSERT_EQUAL( eSELECT_WRITE, xSocket.xSocketBits );
+}
+
+/**
+ * @brief A socket without any selected events is taken from the ready list,
+ *        but it is not reported.
+ */
+void test_FreeRTOS_select_ready_NoSelectedEvents( void )
+{
+    SocketSelect_t xSocketSet;
+    SocketReady_t xReady[ 2 ];
+    FreeRTOS_Socket_t xSocket;
+    BaseType_t xReturn;
+
+    memset( &xSocketSet, 0, sizeof( xSocketSet ) );
+    prvPrepareUDPSocket( &xSocket );
+    xSocket.xSelectBits = ( EventBits_t ) eSELECT_READ;
+    xSocket.xSocketBits = ( EventBits_t ) eSELECT_WRITE;
+
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    vTaskSuspendAll_Expect();
+    listLIST_IS_EMPTY_ExpectAndReturn( &( xSocketSet.xReadyList ), pdFALSE );
+    listGET_OWNER_OF_HEAD_ENTRY_ExpectAndReturn( &( xSocketSet.xReadyList ), &xSocket );
+    uxListRemove_ExpectAndReturn( &( xSocket.xSelectReadyItem ), 0 );
+    listLIST_IS_EMPTY_ExpectAndReturn( &( xSocketSet.xReadyList ), pdTRUE );
+    listLIST_IS_EMPTY_ExpectAndReturn( &( xSocketSet.xReadyList ), pdTRUE );
+    xEventGroupClearBits_ExpectAnyArgsAndReturn( 0U );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+    xTaskCheckForTimeOut_ExpectAnyArgsAndReturn( pdTRUE );
+
+    xReturn = FreeRTOS_select_ready( &xSocketSet, xReady, 2, 0U );
+
+    TEST_ASSERT_EQUAL( 0, xReturn );
+    TEST_ASSERT_EQUAL( eSELECT_WRITE, xSocket.xSocketBits );
+}
+
+/**
+ * @brief No more than 'xMaxCount' sockets are returned, the others stay in
+ *        the ready list and the event group keeps its bits.
+ */
+void test_FreeRTOS_select_ready_MaxCount( void )
+{
+    SocketSelect_t xSocketSet;
+    SocketReady_t xReady[ 1 ];
+    FreeRTOS_Socket_t xSocket;
+    BaseType_t xReturn;
+
+    memset( &xSocketSet, 0, sizeof( xSocketSet ) );
+    prvPrepareUDPSocket( &xSocket );
+    xSocket.xSelectBits = ( EventBits_t ) eSELECT_READ;
+    xSocket.xSocketBits = ( EventBits_t ) eSELECT_READ;
+
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    vTaskSuspendAll_Expect();
+    listLIST_IS_EMPTY_ExpectAndReturn( &( xSocketSet.xReadyList ), pdFALSE );
+    listGET_OWNER_OF_HEAD_ENTRY_ExpectAndReturn( &( xSocketSet.xReadyList ), &xSocket );
+    uxListRemove_ExpectAndReturn( &( xSocket.xSelectReadyItem ), 1 );
+    listLIST_IS_EMPTY_ExpectAndReturn( &( xSocketSet.xReadyList ), pdFALSE );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    xReturn = FreeRTOS_select_ready( &xSocketSet, xReady, 1, 0U );
+
+    TEST_ASSERT_EQUAL( 1, xReturn );
+    TEST_ASSERT_EQUAL( eSELECT_READ, xReady[ 0 ].xEvents );
+    TEST_ASSERT_EQUAL( 0U, xSocket.xSocketBits );
+}
+
+/**
+ * @brief The socket set is signalled while no socket is ready.
+ */
+void test_FreeRTOS_select_ready_Interrupted( void )
+{
+    SocketSelect_t xSocketSet;
+    SocketReady_t xReady[ 2 ];
+    BaseType_t xReturn;
+
+    memset( &xSocketSet, 0, sizeof( xSocketSet ) );
+
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    vTaskSuspendAll_Expect();
+    listLIST_IS_EMPTY_ExpectAndReturn( &( xSocketSet.xReadyList ), pdTRUE );
+    listLIST_IS_EMPTY_ExpectAndReturn( &( xSocketSet.xReadyList ), pdTRUE );
+    xEventGroupClearBits_ExpectAnyArgsAndReturn( 0U );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+    xTaskCheckForTimeOut_ExpectAnyArgsAndReturn( pdFALSE );
+    xEventGroupWaitBits_ExpectAnyArgsAndReturn( ( EventBits_t ) eSELECT_INTR );
+    xEventGroupClearBits_ExpectAndReturn( xSocketSet.xSelectGroup, ( EventBits_t ) eSELECT_INTR, 0U );
+
+    xReturn = FreeRTOS_select_ready( &xSocketSet, xReady, 2, 10U );
+
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINTR, xReturn );
+}
+
+/**
+ * @brief A UDP socket is connected to a peer, and the association is
+ *        dissolved again by passing a NULL address.
+ */
+void test_FreeRTOS_connect_UDP_ConnectDisconnect( void )
+{
+    BaseType_t xReturn;
+    int32_t lReturn;
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagram;
+    uint8_t ucData[ 10 ] = { 0 };
+
+    prvPrepareUDPSocket( &xSocket );
+    prvPrepareDatagram( &xDatagram, ucData, sizeof( ucData ) );
+    uxARPCacheGeneration = 7U;
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+    vTaskSuspendAll_Expect();
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    xReturn = FreeRTOS_connect( &xSocket, &( xDatagram.xAddress ), sizeof( xDatagram.xAddress ) );
+
+    TEST_ASSERT_EQUAL( 0, xReturn );
+    TEST_ASSERT_EQUAL( pdTRUE, xSocket.u.xUDP.xIsConnected );
+    TEST_ASSERT_EQUAL_MEMORY( &( xDatagram.xAddress ), &( xSocket.u.xUDP.xRemoteAddress ), sizeof( xDatagram.xAddress ) );
+    TEST_ASSERT_EQUAL( pdFALSE, xSocket.u.xUDP.xHeaderValid );
+    /* The first packet must ask for new headers. */
+    TEST_ASSERT_NOT_EQUAL( uxARPCacheGeneration, xSocket.u.xUDP.uxARPGeneration );
+
+    vTaskSuspendAll_Expect();
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    xReturn = FreeRTOS_connect( &xSocket, NULL, 0 );
+
+    TEST_ASSERT_EQUAL( 0, xReturn );
+    TEST_ASSERT_EQUAL( pdFALSE, xSocket.u.xUDP.xIsConnected );
+
+    /* Without a peer, FreeRTOS_sendto() needs an address. */
+    lReturn = FreeRTOS_sendto( &xSocket, ucData, sizeof( ucData ), 0, NULL, 0 );
+
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, lReturn );
+}
+
+/**
+ * @brief FreeRTOS_connect() refuses an unknown address family, and a socket
+ *        that can not be bound.
+ */
+void test_FreeRTOS_connect_UDP_Invalid( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagram;
+
+    prvPrepareUDPSocket( &xSocket );
+    prvPrepareDatagram( &xDatagram, NULL, 0 );
+    xDatagram.xAddress.sin_family = 0x55;
+
+    xReturn = FreeRTOS_connect( &xSocket, &( xDatagram.xAddress ), sizeof( xDatagram.xAddress ) );
+
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+    TEST_ASSERT_EQUAL( pdFALSE, xSocket.u.xUDP.xIsConnected );
+
+    /* FreeRTOS_bind() fails because the IP-task can not be reached. */
+    xDatagram.xAddress.sin_family = FREERTOS_AF_INET4;
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( NULL );
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( NULL );
+    xSendEventStructToIPTask_ExpectAnyArgsAndReturn( pdFAIL );
+
+    xReturn = FreeRTOS_connect( &xSocket, &( xDatagram.xAddress ), sizeof( xDatagram.xAddress ) );
+
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EADDRNOTAVAIL, xReturn );
+    TEST_ASSERT_EQUAL( pdFALSE, xSocket.u.xUDP.xIsConnected );
+}
+
+/**
+ * @brief The IP-task builds the headers for the peer of a connected socket.
+ */
+void test_vSocketUDPHeaderRefresh_Build( void )
+{
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagram;
+    NetworkEndPoint_t xEndPoint;
+    MACAddress_t xMACAddress = { { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55 } };
+    const UDPPacket_t * pxHeader = ( const UDPPacket_t * ) xSocket.u.xUDP.ucHeader;
+
+    prvPrepareUDPSocket( &xSocket );
+    prvPrepareDatagram( &xDatagram, NULL, 0 );
+    prvConnectUDPSocket( &xSocket, &xDatagram );
+    memset( &xEndPoint, 0, sizeof( xEndPoint ) );
+    xEndPoint.ipv4_settings.ulIPAddress = 0x0A000002;
+    xSocket.pxEndPoint = &xEndPoint;
+    xSocket.u.xUDP.xHeaderPending = pdTRUE;
+    uxARPCacheGeneration = 3U;
+
+    listGET_LIST_ITEM_VALUE_ExpectAnyArgsAndReturn( FreeRTOS_htons( 1234 ) );
+    xIsIPv4Multicast_ExpectAndReturn( 0x0A000001, pdFALSE );
+    eARPGetCacheEntry_ExpectAnyArgsAndReturn( eResolutionCacheHit );
+    eARPGetCacheEntry_ReturnThruPtr_pxMACAddress( &xMACAddress );
+    vTaskSuspendAll_Expect();
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    vSocketUDPHeaderRefresh( &xSocket );
+
+    TEST_ASSERT_EQUAL( pdTRUE, xSocket.u.xUDP.xHeaderValid );
+    TEST_ASSERT_EQUAL( pdFALSE, xSocket.u.xUDP.xHeaderPending );
+    TEST_ASSERT_EQUAL( 3U, xSocket.u.xUDP.uxARPGeneration );
+    TEST_ASSERT_EQUAL_PTR( &xEndPoint, xSocket.u.xUDP.pxRemoteEndPoint );
+    TEST_ASSERT_EQUAL_MEMORY( xMACAddress.ucBytes, pxHeader->xEthernetHeader.xDestinationAddress.ucBytes, sizeof( xMACAddress ) );
+    TEST_ASSERT_EQUAL( 0x0A000002, pxHeader->xIPHeader.ulSourceIPAddress );
+    TEST_ASSERT_EQUAL( 0x0A000001, pxHeader->xIPHeader.ulDestinationIPAddress );
+    TEST_ASSERT_EQUAL( FreeRTOS_htons( 5000 ), pxHeader->xUDPHeader.usDestinationPort );
+    TEST_ASSERT_EQUAL( FreeRTOS_htons( 1234 ), pxHeader->xUDPHeader.usSourcePort );
+}
+
+/**
+ * @brief The peer is not in the ARP cache: the headers are invalidated, and the
+ *        generation is recorded so that the next request waits for a change.
+ */
+void test_vSocketUDPHeaderRefresh_CacheMiss( void )
+{
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagram;
+
+    prvPrepareUDPSocket( &xSocket );
+    prvPrepareDatagram( &xDatagram, NULL, 0 );
+    prvConnectUDPSocket( &xSocket, &xDatagram );
+    xSocket.u.xUDP.xHeaderValid = pdTRUE;
+    xSocket.u.xUDP.xHeaderPending = pdTRUE;
+    uxARPCacheGeneration = 4U;
+
+    listGET_LIST_ITEM_VALUE_ExpectAnyArgsAndReturn( FreeRTOS_htons( 1234 ) );
+    xIsIPv4Multicast_ExpectAndReturn( 0x0A000001, pdFALSE );
+    eARPGetCacheEntry_ExpectAnyArgsAndReturn( eResolutionCacheMiss );
+    vTaskSuspendAll_Expect();
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    vSocketUDPHeaderRefresh( &xSocket );
+
+    TEST_ASSERT_EQUAL( pdFALSE, xSocket.u.xUDP.xHeaderValid );
+    TEST_ASSERT_EQUAL( pdFALSE, xSocket.u.xUDP.xHeaderPending );
+    TEST_ASSERT_EQUAL( 4U, xSocket.u.xUDP.uxARPGeneration );
+}
+
+/**
+ * @brief The socket was disconnected before the IP-task handled the request.
+ */
+void test_vSocketUDPHeaderRefresh_NotConnected( void )
+{
+    FreeRTOS_Socket_t xSocket;
+
+    prvPrepareUDPSocket( &xSocket );
+    xSocket.u.xUDP.xHeaderValid = pdTRUE;
+    xSocket.u.xUDP.xHeaderPending = pdTRUE;
+
+    vTaskSuspendAll_Expect();
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    vSocketUDPHeaderRefresh( &xSocket );
+
+    TEST_ASSERT_EQUAL( pdFALSE, xSocket.u.xUDP.xHeaderValid );
+    TEST_ASSERT_EQUAL( pdFALSE, xSocket.u.xUDP.xHeaderPending );
+}
+
+/**
+ * @brief With valid cached headers, the datagram is completed by the sending
+ *        task and handed to the IP-task as a network packet.
+ */
+void test_FreeRTOS_sendto_Connected_CachedHeaders( void )
+{
+    int32_t lReturn;
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagram;
+    NetworkEndPoint_t xEndPoint;
+    UDPPacket_t * pxHeader = ( UDPPacket_t * ) xSocket.u.xUDP.ucHeader;
+    const UDPPacket_t * pxPacket = ( const UDPPacket_t * ) ucEthernetBuffers[ 0 ];
+    uint8_t ucData[ 10 ];
+
+    prvPrepareUDPSocket( &xSocket );
+    prvPrepareDatagram( &xDatagram, NULL, 0 );
+    prvConnectUDPSocket( &xSocket, &xDatagram );
+    memset( &xEndPoint, 0, sizeof( xEndPoint ) );
+    memset( ucData, 0x5A, sizeof( ucData ) );
+    memset( xSentEvents, 0, sizeof( xSentEvents ) );
+
+    pxHeader->xIPHeader.ulDestinationIPAddress = 0x0A000001;
+    pxHeader->xUDPHeader.usDestinationPort = FreeRTOS_htons( 5000 );
+    xSocket.u.xUDP.xHeaderValid = pdTRUE;
+    xSocket.u.xUDP.pxRemoteEndPoint = &xEndPoint;
+    uxARPCacheGeneration = 5U;
+    xSocket.u.xUDP.uxARPGeneration = 5U;
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    pxGetNetworkBufferWithDescriptor_ExpectAndReturn( udptestPAYLOAD_OFFSET + sizeof( ucData ), 0, &( xNetworkBuffers[ 0 ] ) );
+    xTaskCheckForTimeOut_ExpectAnyArgsAndReturn( pdFALSE );
+    vTaskSuspendAll_Expect();
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+    usGenerateChecksum_ExpectAnyArgsAndReturn( 0U );
+    xSendEventStructToIPTask_Stub( xSendEventStructToIPTask_Record );
+
+    lReturn = FreeRTOS_sendto( &xSocket, ucData, sizeof( ucData ), FREERTOS_MSG_DONTWAIT, NULL, 0 );
+
+    TEST_ASSERT_EQUAL( sizeof( ucData ), lReturn );
+    TEST_ASSERT_EQUAL( eNetworkTxEvent, xSentEvents[ 0 ].eEventType );
+    TEST_ASSERT_EQUAL_PTR( &( xNetworkBuffers[ 0 ] ), xSentEvents[ 0 ].pvData );
+    TEST_ASSERT_EQUAL( 0x0A000001, pxPacket->xIPHeader.ulDestinationIPAddress );
+    TEST_ASSERT_EQUAL( FreeRTOS_htons( sizeof( ucData ) + sizeof( UDPHeader_t ) ), pxPacket->xUDPHeader.usLength );
+    TEST_ASSERT_EQUAL_PTR( &xEndPoint, xNetworkBuffers[ 0 ].pxEndPoint );
+    TEST_ASSERT_EQUAL_MEMORY( ucData, &( ucEthernetBuffers[ 0 ][ udptestPAYLOAD_OFFSET ] ), sizeof( ucData ) );
+}
+
+/**
+ * @brief The ARP cache has changed since the headers were made: the IP-task
+ *        is asked to build them again, and the datagram takes the normal path.
+ */
+void test_FreeRTOS_sendto_Connected_StaleHeaders( void )
+{
+    int32_t lReturn;
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagram;
+    uint8_t ucData[ 10 ] = { 0 };
+
+    prvPrepareUDPSocket( &xSocket );
+    prvPrepareDatagram( &xDatagram, NULL, 0 );
+    prvConnectUDPSocket( &xSocket, &xDatagram );
+    memset( xSentEvents, 0, sizeof( xSentEvents ) );
+
+    xSocket.u.xUDP.xHeaderValid = pdTRUE;
+    xSocket.u.xUDP.uxARPGeneration = 5U;
+    uxARPCacheGeneration = 6U;
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    pxGetNetworkBufferWithDescriptor_ExpectAndReturn( udptestPAYLOAD_OFFSET + sizeof( ucData ), 0, &( xNetworkBuffers[ 0 ] ) );
+    xTaskCheckForTimeOut_ExpectAnyArgsAndReturn( pdFALSE );
+    vTaskSuspendAll_Expect();
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+    xSendEventStructToIPTask_Stub( xSendEventStructToIPTask_Record );
+    xSend_UDP_Update_IPv4_ExpectAndReturn( &( xNetworkBuffers[ 0 ] ), &( xSocket.u.xUDP.xRemoteAddress ), NULL );
+    listGET_LIST_ITEM_VALUE_ExpectAnyArgsAndReturn( 1234 );
+
+    lReturn = FreeRTOS_sendto( &xSocket, ucData, sizeof( ucData ), FREERTOS_MSG_DONTWAIT, NULL, 0 );
+
+    TEST_ASSERT_EQUAL( sizeof( ucData ), lReturn );
+    TEST_ASSERT_EQUAL( pdTRUE, xSocket.u.xUDP.xHeaderPending );
+    TEST_ASSERT_EQUAL( eSocketUDPHeaderEvent, xSentEvents[ 0 ].eEventType );
+    TEST_ASSERT_EQUAL_PTR( &xSocket, xSentEvents[ 0 ].pvData );
+    TEST_ASSERT_EQUAL( eStackTxEvent, xSentEvents[ 1 ].eEventType );
+    TEST_ASSERT_EQUAL_PTR( &( xNetworkBuffers[ 0 ] ), xSentEvents[ 1 ].pvData );
+}
+
+/**
+ * @brief While a request is pending, or after a failed attempt in an ARP cache
+ *        that has not changed, no new request is sent to the IP-task.
+ */
+void test_FreeRTOS_sendto_Connected_NoNewRequest( void )
+{
+    int32_t lReturn;
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagram;
+    uint8_t ucData[ 10 ] = { 0 };
+    BaseType_t xIndex;
+
+    prvPrepareUDPSocket( &xSocket );
+    prvPrepareDatagram( &xDatagram, NULL, 0 );
+    prvConnectUDPSocket( &xSocket, &xDatagram );
+    xSocket.u.xUDP.xHeaderPending = pdTRUE;
+    xSocket.u.xUDP.uxARPGeneration = 5U;
+    uxARPCacheGeneration = 6U;
+
+    for( xIndex = 0; xIndex < 2; xIndex++ )
+    {
+        if( xIndex == 1 )
+        {
+            /* The IP-task did not find the peer. */
+            xSocket.u.xUDP.xHeaderPending = pdFALSE;
+            xSocket.u.xUDP.uxARPGeneration = 6U;
+        }
+
+        listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+        vTaskSetTimeOutState_ExpectAnyArgs();
+        pxGetNetworkBufferWithDescriptor_ExpectAndReturn( udptestPAYLOAD_OFFSET + sizeof( ucData ), 0, &( xNetworkBuffers[ 0 ] ) );
+        xTaskCheckForTimeOut_ExpectAnyArgsAndReturn( pdFALSE );
+        vTaskSuspendAll_Expect();
+        xTaskResumeAll_ExpectAndReturn( pdFALSE );
+        xSend_UDP_Update_IPv4_ExpectAndReturn( &( xNetworkBuffers[ 0 ] ), &( xSocket.u.xUDP.xRemoteAddress ), NULL );
+        listGET_LIST_ITEM_VALUE_ExpectAnyArgsAndReturn( 1234 );
+        xSendEventStructToIPTask_ExpectAnyArgsAndReturn( pdPASS );
+
+        lReturn = FreeRTOS_sendto( &xSocket, ucData, sizeof( ucData ), FREERTOS_MSG_DONTWAIT, NULL, 0 );
+
+        TEST_ASSERT_EQUAL( sizeof( ucData ), lReturn );
+    }
+}
+
+/**
+ * @brief The request can not be sent to the IP-task, a next packet will try again.
+ */
+void test_FreeRTOS_sendto_Connected_RequestLost( void )
+{
+    int32_t lReturn;
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagram;
+    uint8_t ucData[ 10 ] = { 0 };
+
+    prvPrepareUDPSocket( &xSocket );
+    prvPrepareDatagram( &xDatagram, NULL, 0 );
+    prvConnectUDPSocket( &xSocket, &xDatagram );
+    xSocket.u.xUDP.uxARPGeneration = 5U;
+    uxARPCacheGeneration = 6U;
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    pxGetNetworkBufferWithDescriptor_ExpectAndReturn( udptestPAYLOAD_OFFSET + sizeof( ucData ), 0, &( xNetworkBuffers[ 0 ] ) );
+    xTaskCheckForTimeOut_ExpectAnyArgsAndReturn( pdFALSE );
+    vTaskSuspendAll_Expect();
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+    xSendEventStructToIPTask_ExpectAnyArgsAndReturn( pdFAIL );
+    xSend_UDP_Update_IPv4_ExpectAndReturn( &( xNetworkBuffers[ 0 ] ), &( xSocket.u.xUDP.xRemoteAddress ), NULL );
+    listGET_LIST_ITEM_VALUE_ExpectAnyArgsAndReturn( 1234 );
+    xSendEventStructToIPTask_ExpectAnyArgsAndReturn( pdPASS );
+
+    lReturn = FreeRTOS_sendto( &xSocket, ucData, sizeof( ucData ), FREERTOS_MSG_DONTWAIT, NULL, 0 );
+
+    TEST_ASSERT_EQUAL( sizeof( ucData ), lReturn );
+    TEST_ASSERT_EQUAL( pdFALSE, xSocket.u.xUDP.xHeaderPending );
+}
+
+/**
+ * @brief A connected socket only accepts packets from its IPv4 peer.
+ */
+void test_xUDPSocketAcceptsPacket_IPv4( void )
+{
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagram;
+    UDPPacket_t * pxPacket = ( UDPPacket_t * ) ucEthernetBuffers[ 0 ];
+
+    prvPrepareUDPSocket( &xSocket );
+    prvPrepareDatagram( &xDatagram, NULL, 0 );
+
+    pxPacket->xEthernetHeader.usFrameType = ipIPv4_FRAME_TYPE;
+    xNetworkBuffers[ 0 ].usPort = FreeRTOS_htons( 5000 );
+    xNetworkBuffers[ 0 ].xIPAddress.ulIP_IPv4 = 0x0A000001;
+
+    /* An unconnected socket accepts everything. */
+    xNetworkBuffers[ 0 ].usPort = FreeRTOS_htons( 5001 );
+    TEST_ASSERT_EQUAL( pdTRUE, xUDPSocketAcceptsPacket( &xSocket, &( xNetworkBuffers[ 0 ] ) ) );
+
+    prvConnectUDPSocket( &xSocket, &xDatagram );
+
+    /* Another port of the peer. */
+    TEST_ASSERT_EQUAL( pdFALSE, xUDPSocketAcceptsPacket( &xSocket, &( xNetworkBuffers[ 0 ] ) ) );
+
+    xNetworkBuffers[ 0 ].usPort = FreeRTOS_htons( 5000 );
+    TEST_ASSERT_EQUAL( pdTRUE, xUDPSocketAcceptsPacket( &xSocket, &( xNetworkBuffers[ 0 ] ) ) );
+
+    /* Another host. */
+    xNetworkBuffers[ 0 ].xIPAddress.ulIP_IPv4 = 0x0A000003;
+    TEST_ASSERT_EQUAL( pdFALSE, xUDPSocketAcceptsPacket( &xSocket, &( xNetworkBuffers[ 0 ] ) ) );
+
+    /* Not an IPv4 packet. */
+    xNetworkBuffers[ 0 ].xIPAddress.ulIP_IPv4 = 0x0A000001;
+    pxPacket->xEthernetHeader.usFrameType = ipIPv6_FRAME_TYPE;
+    TEST_ASSERT_EQUAL( pdFALSE, xUDPSocketAcceptsPacket( &xSocket, &( xNetworkBuffers[ 0 ] ) ) );
+}
+
+/**
+ * @brief A connected socket only accepts packets from its IPv6 peer.
+ */
+void test_xUDPSocketAcceptsPacket_IPv6( void )
+{
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagram;
+    UDPPacket_IPv6_t * pxPacket = ( UDPPacket_IPv6_t * ) ucEthernetBuffers[ 0 ];
+    const IPv6_Address_t xPeer = { { 0xfe, 0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01 } };
+
+    prvPrepareUDPSocket( &xSocket );
+    prvPrepareDatagram( &xDatagram, NULL, 0 );
+    xDatagram.xAddress.sin_family = FREERTOS_AF_INET6;
+    memcpy( xDatagram.xAddress.sin_address.xIP_IPv6.ucBytes, xPeer.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+    prvConnectUDPSocket( &xSocket, &xDatagram );
+
+    pxPacket->xEthernetHeader.usFrameType = ipIPv6_FRAME_TYPE;
+    memcpy( pxPacket->xIPHeader.xSourceAddress.ucBytes, xPeer.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+    xNetworkBuffers[ 0 ].usPort = FreeRTOS_htons( 5000 );
+
+    TEST_ASSERT_EQUAL( pdTRUE, xUDPSocketAcceptsPacket( &xSocket, &( xNetworkBuffers[ 0 ] ) ) );
+
+    /* Another host. */
+    pxPacket->xIPHeader.xSourceAddress.ucBytes[ 15 ] = 0x02;
+    TEST_ASSERT_EQUAL( pdFALSE, xUDPSocketAcceptsPacket( &xSocket, &( xNetworkBuffers[ 0 ] ) ) );
+
+    /* Not an IPv6 packet. */
+    pxPacket->xIPHeader.xSourceAddress.ucBytes[ 15 ] = 0x01;
+    pxPacket->xEthernetHeader.usFrameType = ipIPv4_FRAME_TYPE;
+    TEST_ASSERT_EQUAL( pdFALSE, xUDPSocketAcceptsPacket( &xSocket, &( xNetworkBuffers[ 0 ] ) ) );
+}
+
+/**
+ * @brief The data is an exact multiple of the segment size: all datagrams
+ *        are full.
+ */
+void test_FreeRTOS_sendto_Segmented_ExactMultiple( void )
+{
+    int32_t lReturn;
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagram;
+    uint8_t ucData[ 32 ];
+    size_t uxIndex;
+
+    prvPrepareUDPSocket( &xSocket );
+    xSocket.u.xUDP.uxSegmentSize = 16U;
+    prvPrepareDatagram( &xDatagram, NULL, 0 );
+
+    for( uxIndex = 0U; uxIndex < sizeof( ucData ); uxIndex++ )
+    {
+        ucData[ uxIndex ] = ( uint8_t ) uxIndex;
+    }
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+    vListInitialise_ExpectAnyArgs();
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    prvExpectSegmentPrepared( &xDatagram, 16U, 32U, &( xNetworkBuffers[ 0 ] ) );
+    prvExpectSegmentPrepared( &xDatagram, 16U, 16U, &( xNetworkBuffers[ 1 ] ) );
+    prvExpectSegmentsHandedOver( &xSocket, 2U );
+
+    lReturn = FreeRTOS_sendto( &xSocket, ucData, sizeof( ucData ), FREERTOS_MSG_DONTWAIT, &( xDatagram.xAddress ), sizeof( xDatagram.xAddress ) );
+
+    TEST_ASSERT_EQUAL( 32, lReturn );
+    TEST_ASSERT_EQUAL( udptestPAYLOAD_OFFSET + 16U, xNetworkBuffers[ 0 ].xDataLength );
+    TEST_ASSERT_EQUAL( udptestPAYLOAD_OFFSET + 16U, xNetworkBuffers[ 1 ].xDataLength );
+    TEST_ASSERT_EQUAL_MEMORY( ucData, &( ucEthernetBuffers[ 0 ][ udptestPAYLOAD_OFFSET ] ), 16U );
+    TEST_ASSERT_EQUAL_MEMORY( &( ucData[ 16 ] ), &( ucEthernetBuffers[ 1 ][ udptestPAYLOAD_OFFSET ] ), 16U );
+}
+
+/**
+ * @brief The last datagram holds the remainder of the data.
+ */
+void test_FreeRTOS_sendto_Segmented_Remainder( void )
+{
+    int32_t lReturn;
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagram;
+    uint8_t ucData[ 20 ];
+    size_t uxIndex;
+
+    prvPrepareUDPSocket( &xSocket );
+    xSocket.u.xUDP.uxSegmentSize = 16U;
+    prvPrepareDatagram( &xDatagram, NULL, 0 );
+
+    for( uxIndex = 0U; uxIndex < sizeof( ucData ); uxIndex++ )
+    {
+        ucData[ uxIndex ] = ( uint8_t ) uxIndex;
+    }
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+    vListInitialise_ExpectAnyArgs();
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    prvExpectSegmentPrepared( &xDatagram, 16U, 20U, &( xNetworkBuffers[ 0 ] ) );
+    prvExpectSegmentPrepared( &xDatagram, 16U, 4U, &( xNetworkBuffers[ 1 ] ) );
+    prvExpectSegmentsHandedOver( &xSocket, 2U );
+
+    lReturn = FreeRTOS_sendto( &xSocket, ucData, sizeof( ucData ), FREERTOS_MSG_DONTWAIT, &( xDatagram.xAddress ), sizeof( xDatagram.xAddress ) );
+
+    TEST_ASSERT_EQUAL( 20, lReturn );
+    TEST_ASSERT_EQUAL( udptestPAYLOAD_OFFSET + 16U, xNetworkBuffers[ 0 ].xDataLength );
+    TEST_ASSERT_EQUAL( udptestPAYLOAD_OFFSET + 4U, xNetworkBuffers[ 1 ].xDataLength );
+    TEST_ASSERT_EQUAL_MEMORY( &( ucData[ 16 ] ), &( ucEthernetBuffers[ 1 ][ udptestPAYLOAD_OFFSET ] ), 4U );
+}
+
+/**
+ * @brief A segment size that does not fit in the MTU is refused, nothing is sent.
+ */
+void test_FreeRTOS_sendto_Segmented_AboveMTU( void )
+{
+    int32_t lReturn;
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagram;
+    static uint8_t ucData[ 2U * ipconfigNETWORK_MTU ];
+    const size_t uxMaxPayload = ipconfigNETWORK_MTU - ( ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_UDP_HEADER );
+
+    prvPrepareUDPSocket( &xSocket );
+    prvPrepareDatagram( &xDatagram, NULL, 0 );
+
+    /* The largest segment that fits. */
+    xSocket.u.xUDP.uxSegmentSize = uxMaxPayload;
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+    vListInitialise_ExpectAnyArgs();
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    FreeRTOS_min_size_t_ExpectAndReturn( uxMaxPayload, uxMaxPayload + 1U, uxMaxPayload );
+    pxGetNetworkBufferWithDescriptor_ExpectAndReturn( udptestPAYLOAD_OFFSET + uxMaxPayload, 0, NULL );
+    xTaskCheckForTimeOut_ExpectAnyArgsAndReturn( pdFALSE );
+    listLIST_IS_EMPTY_ExpectAnyArgsAndReturn( pdTRUE );
+
+    lReturn = FreeRTOS_sendto( &xSocket, ucData, uxMaxPayload + 1U, FREERTOS_MSG_DONTWAIT, &( xDatagram.xAddress ), sizeof( xDatagram.xAddress ) );
+
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_ENOBUFS, lReturn );
+
+    /* One byte more. */
+    xSocket.u.xUDP.uxSegmentSize = uxMaxPayload + 1U;
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+
+    lReturn = FreeRTOS_sendto( &xSocket, ucData, sizeof( ucData ), FREERTOS_MSG_DONTWAIT, &( xDatagram.xAddress ), sizeof( xDatagram.xAddress ) );
+
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, lReturn );
+}
+
+/**
+ * @brief A segment size of zero switches segmentation off: the data is sent
+ *        as a single datagram, or not at all when it is too long.
+ */
+void test_FreeRTOS_sendto_Segmented_Zero( void )
+{
+    int32_t lReturn;
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    UDPDatagram_t xDatagram;
+    static uint8_t ucData[ 2U * ipconfigNETWORK_MTU ];
+    size_t uxSegmentSize = 0U;
+
+    prvPrepareUDPSocket( &xSocket );
+    xSocket.u.xUDP.uxSegmentSize = 16U;
+    prvPrepareDatagram( &xDatagram, NULL, 0 );
+
+    xReturn = FreeRTOS_setsockopt( &xSocket, 0, FREERTOS_SO_UDP_SEGMENT, &( uxSegmentSize ), sizeof( uxSegmentSize ) );
+
+    TEST_ASSERT_EQUAL( 0, xReturn );
+    TEST_ASSERT_EQUAL( 0U, xSocket.u.xUDP.uxSegmentSize );
+
+    listLIST_ITEM_CONTAINER_ExpectAnyArgsAndReturn( &xBoundUDPSocketsList );
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    pxGetNetworkBufferWithDescriptor_ExpectAndReturn( udptestPAYLOAD_OFFSET + 20U, 0, &( xNetworkBuffers[ 0 ] ) );
+    xTaskCheckForTimeOut_ExpectAnyArgsAndReturn( pdFALSE );
+    xSend_UDP_Update_IPv4_ExpectAndReturn( &( xNetworkBuffers[ 0 ] ), &( xDatagram.xAddress ), NULL );
+    listGET_LIST_ITEM_VALUE_ExpectAnyArgsAndReturn( 1234 );
+    xSendEventStructToIPTask_ExpectAnyArgsAndReturn( pdPASS );
+
+    lReturn = FreeRTOS_sendto( &xSocket, ucData, 20U, FREERTOS_MSG_DONTWAIT, &( xDatagram.xAddress ), sizeof( xDatagram.xAddress ) );
+
+    TEST_ASSERT_EQUAL( 20, lReturn );
+
+    /* Too long for a single datagram. */
+    lReturn = FreeRTOS_sendto( &xSocket, ucData, sizeof( ucData ), FREERTOS_MSG_DONTWAIT, &( xDatagram.xAddress ), sizeof( xDatagram.xAddress ) );
+
+    TEST_ASSERT_EQUAL( 0, lReturn );
+}
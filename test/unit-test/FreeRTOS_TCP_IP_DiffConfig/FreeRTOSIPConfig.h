@@ -221,6 +221,9 @@
 /* USE_WIN: Let TCP use windowing mechanism. */
 #define ipconfigUSE_TCP_WIN                            ( 1 )
 
+/* Keep the statistics that are read by FreeRTOS_GetTCPInfo(). */
+#define ipconfigTCP_INFO                               ( 1 )
+
 /* The MTU is the maximum number of bytes the payload of a network frame can
  * contain.  For normal Ethernet V2 frames the maximum MTU is 1500.  Setting a
  * lower value can save RAM, depending on the buffer management scheme used.  If
@@ -183,3 +183,196 @@ void test_vTCPStateChange_ClosedWaitState_CurrentStateSynFirstNextStateCloseWait
     TEST_ASSERT_EQUAL( 0, xSocket.u.xTCP.ucKeepRepCount );
     TEST_ASSERT_EQUAL( xTickCountAlive, xSocket.u.xTCP.xLastAliveTime );
 }
+
+/* @brief Prepare the socket and the packet of a valid ACK from the peer, which
+ *        advertises the window 'usWindow'. */
+static void test_Helper_PrepareWindowPacket( FreeRTOS_Socket_t * pxTestSocket,
+                                             uint16_t usWindow )
+{
+    ProtocolHeaders_t * pxProtocolHeaders = ( ( ProtocolHeaders_t * ) &( ucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER ] ) );
+
+    memset( pxTestSocket, 0, sizeof( *pxTestSocket ) );
+    memset( &xNetworkBuffer, 0, sizeof( xNetworkBuffer ) );
+
+    xNetworkBuffer.pucEthernetBuffer = ucEthernetBuffer;
+    xNetworkBuffer.xDataLength = 100;
+
+    pxTestSocket->u.xTCP.eTCPState = eESTABLISHED;
+    /* A time-out is pending, so prvTCPNextTimeout() will not consult the window. */
+    pxTestSocket->u.xTCP.usTimeout = 100U;
+
+    pxProtocolHeaders->xTCPHeader.ucTCPOffset = 0x50;
+    pxProtocolHeaders->xTCPHeader.ucTCPFlags = tcpTCP_FLAG_ACK;
+    pxProtocolHeaders->xTCPHeader.usWindow = FreeRTOS_htons( usWindow );
+
+    uxIPHeaderSizePacket_ExpectAnyArgsAndReturn( ipSIZE_OF_IPv4_HEADER );
+    pxTCPSocketLookup_ExpectAnyArgsAndReturn( pxTestSocket );
+    prvTCPSocketIsActive_ExpectAnyArgsAndReturn( pdTRUE );
+    uxIPHeaderSizeSocket_ExpectAnyArgsAndReturn( ipSIZE_OF_IPv4_HEADER );
+    /* prvTCPTouchSocket(). */
+    xTaskGetTickCount_ExpectAndReturn( 1000 );
+    xTaskGetTickCount_ExpectAndReturn( 1000 );
+}
+
+/* @brief The peer closes its window: the zero-window period starts, and the
+ *        segment is counted. */
+void test_xProcessReceivedTCPPacket_TCPInfo_ZeroWindowStarts( void )
+{
+    FreeRTOS_Socket_t xTestSocket;
+    BaseType_t xReturn;
+
+    test_Helper_PrepareWindowPacket( &xTestSocket, 0U );
+    xTaskGetTickCount_ExpectAndReturn( 1200 );
+    prvTCPHandleState_ExpectAnyArgsAndReturn( 0 );
+    vReleaseNetworkBufferAndDescriptor_ExpectAnyArgs();
+
+    xReturn = xProcessReceivedTCPPacket( &xNetworkBuffer );
+
+    TEST_ASSERT_EQUAL( pdPASS, xReturn );
+    TEST_ASSERT_EQUAL( 1U, xTestSocket.u.xTCP.ulSegmentsReceived );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xTestSocket.u.xTCP.bits.bZeroWindow );
+    TEST_ASSERT_EQUAL( 1200, xTestSocket.u.xTCP.xZeroWindowStart );
+    TEST_ASSERT_EQUAL( 0, xTestSocket.u.xTCP.xZeroWindowTicks );
+}
+
+/* @brief Another zero window while the period is going on: the start time
+ *        is kept. */
+void test_xProcessReceivedTCPPacket_TCPInfo_ZeroWindowContinues( void )
+{
+    FreeRTOS_Socket_t xTestSocket;
+    BaseType_t xReturn;
+
+    test_Helper_PrepareWindowPacket( &xTestSocket, 0U );
+    xTestSocket.u.xTCP.bits.bZeroWindow = pdTRUE_UNSIGNED;
+    xTestSocket.u.xTCP.xZeroWindowStart = 800;
+    xTestSocket.u.xTCP.ulSegmentsReceived = 5U;
+    prvTCPHandleState_ExpectAnyArgsAndReturn( 0 );
+    vReleaseNetworkBufferAndDescriptor_ExpectAnyArgs();
+
+    xReturn = xProcessReceivedTCPPacket( &xNetworkBuffer );
+
+    TEST_ASSERT_EQUAL( pdPASS, xReturn );
+    TEST_ASSERT_EQUAL( 6U, xTestSocket.u.xTCP.ulSegmentsReceived );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xTestSocket.u.xTCP.bits.bZeroWindow );
+    TEST_ASSERT_EQUAL( 800, xTestSocket.u.xTCP.xZeroWindowStart );
+    TEST_ASSERT_EQUAL( 0, xTestSocket.u.xTCP.xZeroWindowTicks );
+}
+
+/* @brief The peer opens its window again: the period is added to the
+ *        zero-window time. */
+void test_xProcessReceivedTCPPacket_TCPInfo_ZeroWindowEnds( void )
+{
+    FreeRTOS_Socket_t xTestSocket;
+    BaseType_t xReturn;
+
+    test_Helper_PrepareWindowPacket( &xTestSocket, 1000U );
+    xTestSocket.u.xTCP.bits.bZeroWindow = pdTRUE_UNSIGNED;
+    xTestSocket.u.xTCP.xZeroWindowStart = 800;
+    xTestSocket.u.xTCP.xZeroWindowTicks = 50;
+    xTaskGetTickCount_ExpectAndReturn( 1300 );
+    prvTCPHandleState_ExpectAnyArgsAndReturn( 0 );
+    vReleaseNetworkBufferAndDescriptor_ExpectAnyArgs();
+
+    xReturn = xProcessReceivedTCPPacket( &xNetworkBuffer );
+
+    TEST_ASSERT_EQUAL( pdPASS, xReturn );
+    TEST_ASSERT_EQUAL( 1U, xTestSocket.u.xTCP.ulSegmentsReceived );
+    TEST_ASSERT_EQUAL( 1000U, xTestSocket.u.xTCP.ulWindowSize );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xTestSocket.u.xTCP.bits.bZeroWindow );
+    TEST_ASSERT_EQUAL( 550, xTestSocket.u.xTCP.xZeroWindowTicks );
+}
+
+/* @brief An open window without a zero-window period: only the segment is
+ *        counted. */
+void test_xProcessReceivedTCPPacket_TCPInfo_WindowOpen( void )
+{
+    FreeRTOS_Socket_t xTestSocket;
+    BaseType_t xReturn;
+
+    test_Helper_PrepareWindowPacket( &xTestSocket, 1000U );
+    prvTCPHandleState_ExpectAnyArgsAndReturn( 0 );
+    vReleaseNetworkBufferAndDescriptor_ExpectAnyArgs();
+
+    xReturn = xProcessReceivedTCPPacket( &xNetworkBuffer );
+
+    TEST_ASSERT_EQUAL( pdPASS, xReturn );
+    TEST_ASSERT_EQUAL( 1U, xTestSocket.u.xTCP.ulSegmentsReceived );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xTestSocket.u.xTCP.bits.bZeroWindow );
+    TEST_ASSERT_EQUAL( 0, xTestSocket.u.xTCP.xZeroWindowTicks );
+}
+
+/* @brief A reset closes the connection while the peer's window is closed:
+ *        the zero-window period ends with the connection. */
+void test_vTCPStateChange_TCPInfo_ZeroWindowEndsOnClosed( void )
+{
+    FreeRTOS_Socket_t xTestSocket;
+
+    memset( &xTestSocket, 0, sizeof( xTestSocket ) );
+    xTestSocket.u.xTCP.eTCPState = eESTABLISHED;
+    xTestSocket.u.xTCP.bits.bZeroWindow = pdTRUE_UNSIGNED;
+    xTestSocket.u.xTCP.xZeroWindowStart = 800;
+    xTestSocket.u.xTCP.xZeroWindowTicks = 50;
+
+    prvTCPSocketIsActive_ExpectAndReturn( eESTABLISHED, pdTRUE );
+    xTaskGetTickCount_ExpectAndReturn( 1000 );
+    vTaskSuspendAll_Expect();
+    xTaskResumeAll_ExpectAndReturn( 0 );
+    xTaskGetTickCount_ExpectAndReturn( 1000 );
+    xTaskGetTickCount_ExpectAndReturn( 1000 );
+    FreeRTOS_inet_ntop_ExpectAnyArgsAndReturn( NULL );
+    vSocketWakeUpUser_Expect( &xTestSocket );
+
+    vTCPStateChange( &xTestSocket, eCLOSED );
+
+    TEST_ASSERT_EQUAL( eCLOSED, xTestSocket.u.xTCP.eTCPState );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xTestSocket.u.xTCP.bits.bZeroWindow );
+    TEST_ASSERT_EQUAL( 250, xTestSocket.u.xTCP.xZeroWindowTicks );
+}
+
+/* @brief The zero-window period also ends when the connection moves to
+ *        eTIME_WAIT, after the final segment. */
+void test_vTCPStateChange_TCPInfo_ZeroWindowEndsOnTimeWait( void )
+{
+    FreeRTOS_Socket_t xTestSocket;
+
+    memset( &xTestSocket, 0, sizeof( xTestSocket ) );
+    xTestSocket.u.xTCP.eTCPState = eFIN_WAIT_2;
+    xTestSocket.u.xTCP.bits.bZeroWindow = pdTRUE_UNSIGNED;
+    xTestSocket.u.xTCP.xZeroWindowStart = 800;
+
+    xTaskGetTickCount_ExpectAndReturn( 900 );
+    xTaskGetTickCount_ExpectAndReturn( 900 );
+    xTaskGetTickCount_ExpectAndReturn( 900 );
+    FreeRTOS_inet_ntop_ExpectAnyArgsAndReturn( NULL );
+    vSocketWakeUpUser_Expect( &xTestSocket );
+
+    vTCPStateChange( &xTestSocket, eTIME_WAIT );
+
+    TEST_ASSERT_EQUAL( eTIME_WAIT, xTestSocket.u.xTCP.eTCPState );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xTestSocket.u.xTCP.bits.bZeroWindow );
+    TEST_ASSERT_EQUAL( 100, xTestSocket.u.xTCP.xZeroWindowTicks );
+}
+
+/* @brief A state change that keeps the connection going does not end the
+ *        zero-window period. */
+void test_vTCPStateChange_TCPInfo_ZeroWindowKept( void )
+{
+    FreeRTOS_Socket_t xTestSocket;
+
+    memset( &xTestSocket, 0, sizeof( xTestSocket ) );
+    xTestSocket.u.xTCP.eTCPState = eESTABLISHED;
+    xTestSocket.u.xTCP.bits.bZeroWindow = pdTRUE_UNSIGNED;
+    xTestSocket.u.xTCP.xZeroWindowStart = 800;
+
+    xTaskGetTickCount_ExpectAndReturn( 900 );
+    xTaskGetTickCount_ExpectAndReturn( 900 );
+    FreeRTOS_inet_ntop_ExpectAnyArgsAndReturn( NULL );
+    vSocketWakeUpUser_Expect( &xTestSocket );
+
+    vTCPStateChange( &xTestSocket, eFIN_WAIT_1 );
+
+    TEST_ASSERT_EQUAL( eFIN_WAIT_1, xTestSocket.u.xTCP.eTCPState );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xTestSocket.u.xTCP.bits.bZeroWindow );
+    TEST_ASSERT_EQUAL( 800, xTestSocket.u.xTCP.xZeroWindowStart );
+    TEST_ASSERT_EQUAL( 0, xTestSocket.u.xTCP.xZeroWindowTicks );
+}
@@ -0,0 +1,337 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+
+#include "mock_FreeRTOS_IP.h"
+#include "mock_FreeRTOS_IP_Private.h"
+#include "mock_FreeRTOS_IP_Utils.h"
+#include "mock_NetworkBufferManagement.h"
+#include "mock_NetworkInterface.h"
+#include "mock_FreeRTOS_Sockets.h"
+#include "mock_FreeRTOS_Stream_Buffer.h"
+#include "mock_FreeRTOS_TCP_WIN.h"
+#include "mock_FreeRTOS_TCP_Transmission.h"
+
+#include "FreeRTOS_TCP_IP.h"
+
+#include "catch_assert.h"
+
+#include "FreeRTOSIPConfig.h"
+
+#include "FreeRTOS_TCP_Reception_DiffConfig_stubs.c"
+#include "FreeRTOS_TCP_Reception.h"
+
+int32_t prvSingleStepTCPHeaderOptions( const uint8_t * const pucPtr,
+                                       size_t uxTotalLength,
+                                       FreeRTOS_Socket_t * const pxSocket,
+                                       BaseType_t xHasSYNFlag );
+
+FreeRTOS_Socket_t xSocket, * pxSocket;
+NetworkBufferDescriptor_t xNetworkBuffer, * pxNetworkBuffer;
+uint8_t ucEthernetBuffer[ ipconfigNETWORK_MTU ];
+
+/* NOP, NOP, and a time-stamp option of which TSval and TSecr are read through
+ * ulChar2u32(). */
+static const uint8_t ucTCPOptions_TS[ tcpTCP_OPT_TIMESTAMP_SPACE ] =
+{
+    0x01, 0x01, 0x08, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+/* A time-stamp option with a wrong length field. */
+static const uint8_t ucTCPOptions_TS_Bad_Length[ tcpTCP_OPT_TIMESTAMP_SPACE ] =
+{
+    0x01, 0x01, 0x08, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+/* Prepare an IPv4 packet that carries 'pucOptions' and has the TCP flags
+ * 'ucFlags'. */
+static void prvPreparePacket( const uint8_t * pucOptions,
+                              uint8_t ucFlags )
+{
+    ProtocolHeaders_t * pxProtocolHeader;
+    TCPHeader_t * pxTCPHeader;
+
+    memset( ucEthernetBuffer, 0, sizeof( ucEthernetBuffer ) );
+
+    pxSocket = &xSocket;
+    pxNetworkBuffer = &xNetworkBuffer;
+    pxNetworkBuffer->pucEthernetBuffer = ucEthernetBuffer;
+    pxNetworkBuffer->xDataLength = 0x50;
+
+    pxProtocolHeader = ( ( ProtocolHeaders_t * )
+                         &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER ] ) );
+    pxTCPHeader = &( pxProtocolHeader->xTCPHeader );
+
+    /* A TCP header of 20 + 12 bytes. */
+    pxTCPHeader->ucTCPOffset = 0x80;
+    pxTCPHeader->ucTCPFlags = ucFlags;
+    memcpy( ( void * ) pxTCPHeader->ucOptdata, ( const void * ) pucOptions, tcpTCP_OPT_TIMESTAMP_SPACE );
+
+    uxIPHeaderSizePacket_ExpectAnyArgsAndReturn( ipSIZE_OF_IPv4_HEADER );
+}
+
+void setUp( void )
+{
+    memset( &xSocket, 0, sizeof( xSocket ) );
+}
+
+/**
+ * @brief A SYN with the time-stamp option enables time-stamps and records
+ *        the peer's TSval. The TSecr of a SYN+ACK is a valid echo.
+ */
+void test_prvCheckOptions_TimeStamp_SYN_ACK_Negotiates( void )
+{
+    BaseType_t xReturn;
+
+    prvPreparePacket( ucTCPOptions_TS, tcpTCP_FLAG_SYN | tcpTCP_FLAG_ACK );
+    ulChar2u32_ExpectAnyArgsAndReturn( 0x12345678U );
+    ulChar2u32_ExpectAnyArgsAndReturn( 0x00001000U );
+
+    xReturn = prvCheckOptions( pxSocket, pxNetworkBuffer );
+
+    TEST_ASSERT_EQUAL( pdPASS, xReturn );
+    TEST_ASSERT_EQUAL( ipTRUE_BOOL, pxSocket->u.xTCP.bits.bTimeStamps );
+    TEST_ASSERT_EQUAL_UINT32( 0x12345678U, pxSocket->u.xTCP.xTCPWindow.ulTSRecent );
+    TEST_ASSERT_EQUAL_UINT32( 0x00001000U, pxSocket->u.xTCP.xTCPWindow.ulTSEcho );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, pxSocket->u.xTCP.xTCPWindow.u.bits.bTSEchoValid );
+}
+
+/**
+ * @brief The TSecr of a pure SYN is not valid, because it has no ACK flag.
+ */
+void test_prvCheckOptions_TimeStamp_SYN_EchoNotValid( void )
+{
+    BaseType_t xReturn;
+
+    prvPreparePacket( ucTCPOptions_TS, tcpTCP_FLAG_SYN );
+    ulChar2u32_ExpectAnyArgsAndReturn( 0x12345678U );
+    ulChar2u32_ExpectAnyArgsAndReturn( 0x00001000U );
+
+    xReturn = prvCheckOptions( pxSocket, pxNetworkBuffer );
+
+    TEST_ASSERT_EQUAL( pdPASS, xReturn );
+    TEST_ASSERT_EQUAL( ipTRUE_BOOL, pxSocket->u.xTCP.bits.bTimeStamps );
+    TEST_ASSERT_EQUAL_UINT32( 0x12345678U, pxSocket->u.xTCP.xTCPWindow.ulTSRecent );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, pxSocket->u.xTCP.xTCPWindow.u.bits.bTSEchoValid );
+}
+
+/**
+ * @brief A TSecr of zero is a valid echo when the ACK flag is set.
+ */
+void test_prvCheckOptions_TimeStamp_ZeroEcho_Valid( void )
+{
+    BaseType_t xReturn;
+
+    prvPreparePacket( ucTCPOptions_TS, tcpTCP_FLAG_ACK );
+    pxSocket->u.xTCP.bits.bTimeStamps = ipTRUE_BOOL;
+    pxSocket->u.xTCP.xTCPWindow.ulTSEcho = 0x5555U;
+    ulChar2u32_ExpectAnyArgsAndReturn( 100U );
+    ulChar2u32_ExpectAnyArgsAndReturn( 0U );
+
+    xReturn = prvCheckOptions( pxSocket, pxNetworkBuffer );
+
+    TEST_ASSERT_EQUAL( pdPASS, xReturn );
+    TEST_ASSERT_EQUAL_UINT32( 0U, pxSocket->u.xTCP.xTCPWindow.ulTSEcho );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, pxSocket->u.xTCP.xTCPWindow.u.bits.bTSEchoValid );
+}
+
+/**
+ * @brief TSRecent only follows the peer's clock forward, also when it wraps.
+ */
+void test_prvCheckOptions_TimeStamp_TSRecent_Forward_Only( void )
+{
+    prvPreparePacket( ucTCPOptions_TS, tcpTCP_FLAG_ACK );
+    pxSocket->u.xTCP.bits.bTimeStamps = ipTRUE_BOOL;
+    pxSocket->u.xTCP.xTCPWindow.ulTSRecent = 1000U;
+
+    /* An older TSval, from a delayed segment. */
+    ulChar2u32_ExpectAnyArgsAndReturn( 999U );
+    ulChar2u32_ExpectAnyArgsAndReturn( 1U );
+    TEST_ASSERT_EQUAL( pdPASS, prvCheckOptions( pxSocket, pxNetworkBuffer ) );
+    TEST_ASSERT_EQUAL_UINT32( 1000U, pxSocket->u.xTCP.xTCPWindow.ulTSRecent );
+
+    /* A newer TSval. */
+    uxIPHeaderSizePacket_ExpectAnyArgsAndReturn( ipSIZE_OF_IPv4_HEADER );
+    ulChar2u32_ExpectAnyArgsAndReturn( 1001U );
+    ulChar2u32_ExpectAnyArgsAndReturn( 1U );
+    TEST_ASSERT_EQUAL( pdPASS, prvCheckOptions( pxSocket, pxNetworkBuffer ) );
+    TEST_ASSERT_EQUAL_UINT32( 1001U, pxSocket->u.xTCP.xTCPWindow.ulTSRecent );
+
+    /* The peer's clock wraps. */
+    pxSocket->u.xTCP.xTCPWindow.ulTSRecent = 0xFFFFFFF0U;
+    uxIPHeaderSizePacket_ExpectAnyArgsAndReturn( ipSIZE_OF_IPv4_HEADER );
+    ulChar2u32_ExpectAnyArgsAndReturn( 0x10U );
+    ulChar2u32_ExpectAnyArgsAndReturn( 1U );
+    TEST_ASSERT_EQUAL( pdPASS, prvCheckOptions( pxSocket, pxNetworkBuffer ) );
+    TEST_ASSERT_EQUAL_UINT32( 0x10U, pxSocket->u.xTCP.xTCPWindow.ulTSRecent );
+}
+
+/**
+ * @brief When time-stamps were not negotiated, the option is skipped.
+ */
+void test_prvCheckOptions_TimeStamp_NotNegotiated_Ignored( void )
+{
+    BaseType_t xReturn;
+
+    prvPreparePacket( ucTCPOptions_TS, tcpTCP_FLAG_ACK );
+    pxSocket->u.xTCP.xTCPWindow.ulTSRecent = 1000U;
+    ulChar2u32_ExpectAnyArgsAndReturn( 2000U );
+    ulChar2u32_ExpectAnyArgsAndReturn( 1U );
+
+    xReturn = prvCheckOptions( pxSocket, pxNetworkBuffer );
+
+    TEST_ASSERT_EQUAL( pdPASS, xReturn );
+    TEST_ASSERT_EQUAL( ipFALSE_BOOL, pxSocket->u.xTCP.bits.bTimeStamps );
+    TEST_ASSERT_EQUAL_UINT32( 1000U, pxSocket->u.xTCP.xTCPWindow.ulTSRecent );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, pxSocket->u.xTCP.xTCPWindow.u.bits.bTSEchoValid );
+}
+
+/**
+ * @brief A time-stamp option with a wrong length makes the options invalid.
+ */
+void test_prvCheckOptions_TimeStamp_Bad_Length( void )
+{
+    BaseType_t xReturn;
+
+    prvPreparePacket( ucTCPOptions_TS_Bad_Length, tcpTCP_FLAG_ACK );
+    pxSocket->u.xTCP.bits.bTimeStamps = ipTRUE_BOOL;
+
+    xReturn = prvCheckOptions( pxSocket, pxNetworkBuffer );
+
+    TEST_ASSERT_EQUAL( pdFAIL, xReturn );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, pxSocket->u.xTCP.xTCPWindow.u.bits.bTSEchoValid );
+}
+
+/**
+ * @brief A time-stamp option that does not fit in the remaining option space
+ *        is not read.
+ */
+void test_prvSingleStepTCPHeaderOptions_TimeStamp_Truncated( void )
+{
+    int32_t lResult;
+
+    pxSocket = &xSocket;
+    pxSocket->u.xTCP.bits.bTimeStamps = ipTRUE_BOOL;
+
+    lResult = prvSingleStepTCPHeaderOptions( &( ucTCPOptions_TS[ 2 ] ), tcpTCP_OPT_TIMESTAMP_LEN - 1U, pxSocket, pdFALSE );
+
+    TEST_ASSERT_EQUAL( -1, lResult );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, pxSocket->u.xTCP.xTCPWindow.u.bits.bTSEchoValid );
+}
+
+/* Accept the data as lTCPWindowRxCheck() does with a segment that is expected:
+ * RCV.NXT moves forward over the new data. */
+static int32_t lTCPWindowRxCheck_InOrder( TCPWindow_t * pxWindow,
+                                          uint32_t ulSequenceNumber,
+                                          uint32_t ulLength,
+                                          uint32_t ulSpace,
+                                          uint32_t * pulSkipCount,
+                                          int cmock_num_calls )
+{
+    ( void ) ulSequenceNumber;
+    ( void ) ulSpace;
+    ( void ) cmock_num_calls;
+
+    *pulSkipCount = 0U;
+    pxWindow->rx.ulCurrentSequenceNumber += ulLength;
+
+    return 0;
+}
+
+/* Store the data as lTCPWindowRxCheck() does with a segment that comes after
+ * a missing one of the same length: RCV.NXT does not move. */
+static int32_t lTCPWindowRxCheck_OutOfOrder( TCPWindow_t * pxWindow,
+                                             uint32_t ulSequenceNumber,
+                                             uint32_t ulLength,
+                                             uint32_t ulSpace,
+                                             uint32_t * pulSkipCount,
+                                             int cmock_num_calls )
+{
+    ( void ) pxWindow;
+    ( void ) ulSequenceNumber;
+    ( void ) ulSpace;
+    ( void ) cmock_num_calls;
+
+    *pulSkipCount = 0U;
+
+    return ( int32_t ) ulLength;
+}
+
+/**
+ * @brief Data that is received in order is added to the bytes received.
+ */
+void test_prvStoreRxData_TCPInfo_InOrder( void )
+{
+    uint8_t ucData[ 100 ];
+    BaseType_t xResult;
+
+    prvPreparePacket( ucTCPOptions_TS, tcpTCP_FLAG_ACK );
+    pxSocket->u.xTCP.eTCPState = eESTABLISHED;
+    pxSocket->u.xTCP.uxRxStreamSize = 1000U;
+    pxSocket->u.xTCP.xTCPWindow.rx.ulCurrentSequenceNumber = 5000U;
+    pxSocket->u.xTCP.ulBytesReceived = 20U;
+
+    lTCPWindowRxCheck_Stub( lTCPWindowRxCheck_InOrder );
+    lTCPAddRxdata_ExpectAnyArgsAndReturn( ( int32_t ) sizeof( ucData ) );
+
+    xResult = prvStoreRxData( pxSocket, ucData, pxNetworkBuffer, sizeof( ucData ) );
+
+    TEST_ASSERT_EQUAL( 0, xResult );
+    TEST_ASSERT_EQUAL_UINT32( 20U + sizeof( ucData ), pxSocket->u.xTCP.ulBytesReceived );
+}
+
+/**
+ * @brief Data that is stored out of order is not counted until the missing
+ *        data has arrived.
+ */
+void test_prvStoreRxData_TCPInfo_OutOfOrder( void )
+{
+    uint8_t ucData[ 100 ];
+    BaseType_t xResult;
+
+    prvPreparePacket( ucTCPOptions_TS, tcpTCP_FLAG_ACK );
+    pxSocket->u.xTCP.eTCPState = eESTABLISHED;
+    pxSocket->u.xTCP.uxRxStreamSize = 1000U;
+    pxSocket->u.xTCP.xTCPWindow.rx.ulCurrentSequenceNumber = 5000U;
+
+    lTCPWindowRxCheck_Stub( lTCPWindowRxCheck_OutOfOrder );
+    lTCPAddRxdata_ExpectAnyArgsAndReturn( ( int32_t ) sizeof( ucData ) );
+
+    xResult = prvStoreRxData( pxSocket, ucData, pxNetworkBuffer, sizeof( ucData ) );
+
+    TEST_ASSERT_EQUAL( 0, xResult );
+    TEST_ASSERT_EQUAL_UINT32( 0U, pxSocket->u.xTCP.ulBytesReceived );
+}
@@ -2653,3 +2653,48 @@ void test_prvTCPSendReset( void )
     TEST_ASSERT_EQUAL( tcpTCP_FLAG_ACK | tcpTCP_FLAG_RST, pxTCPPacket->xTCPHeader.ucTCPFlags );
     TEST_ASSERT_EQUAL( 0x50, pxTCPPacket->xTCPHeader.ucTCPOffset );
 }
+
+/**
+ * @brief The advertised window is limited by the free space in the rxStream.
+ *        After the rxStream has been replaced by a bigger one, because the
+ *        reception window had grown, the full window is advertised.
+ */
+void test_prvTCPReturn_CheckTCPWindow_RxStreamGrown( void )
+{
+    TCPWindow_t * pxTCPWindow;
+    TCPPacket_t * pxTCPPacket;
+
+    memset( &xSocket, 0, sizeof( xSocket ) );
+    pxSocket = &xSocket;
+    pxNetworkBuffer = &xNetworkBuffer;
+    pxNetworkBuffer->pucEthernetBuffer = ucEthernetBuffer;
+    pxTCPPacket = ( ( TCPPacket_t * ) pxNetworkBuffer->pucEthernetBuffer );
+    pxTCPWindow = &( pxSocket->u.xTCP.xTCPWindow );
+
+    pxSocket->u.xTCP.rxStream = ( StreamBuffer_t * ) 0x12345678;
+    pxSocket->u.xTCP.uxRxStreamSize = 16000;
+    pxSocket->u.xTCP.usMSS = 1000;
+    pxSocket->u.xTCP.ucMyWinScaleFactor = 1;
+    pxTCPWindow->xSize.ulRxWindowLength = 8000;
+    pxTCPWindow->rx.ulCurrentSequenceNumber = 50;
+
+    /* The window has grown, the rxStream not yet. */
+    uxStreamBufferFrontSpace_ExpectAndReturn( pxSocket->u.xTCP.rxStream, 2000 );
+    FreeRTOS_min_uint32_ExpectAndReturn( 8000, 2000, 2000 );
+
+    prvTCPReturn_CheckTCPWindow( pxSocket, pxNetworkBuffer, ipSIZE_OF_IPv4_HEADER );
+
+    TEST_ASSERT_EQUAL( FreeRTOS_htons( 1000 ), pxTCPPacket->xTCPHeader.usWindow );
+    TEST_ASSERT_EQUAL( 2050, pxSocket->u.xTCP.ulHighestRxAllowed );
+
+    /* The rxStream has been replaced by one that can hold the window. */
+    pxSocket->u.xTCP.rxStream = ( StreamBuffer_t * ) 0x87654321;
+    uxStreamBufferFrontSpace_ExpectAndReturn( pxSocket->u.xTCP.rxStream, 8000 );
+    FreeRTOS_min_uint32_ExpectAndReturn( 8000, 8000, 8000 );
+
+    prvTCPReturn_CheckTCPWindow( pxSocket, pxNetworkBuffer, ipSIZE_OF_IPv4_HEADER );
+
+    TEST_ASSERT_EQUAL( FreeRTOS_htons( 4000 ), pxTCPPacket->xTCPHeader.usWindow );
+    TEST_ASSERT_EQUAL( 8050, pxSocket->u.xTCP.ulHighestRxAllowed );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, pxSocket->u.xTCP.bits.bWinChange );
+}
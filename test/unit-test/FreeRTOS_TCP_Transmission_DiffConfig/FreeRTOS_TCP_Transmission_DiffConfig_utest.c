@@ -0,0 +1,324 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mock_list.h"
+
+/* This must come after list.h is included (in this case, indirectly
+ * by mock_list.h). */
+#include "mock_queue.h"
+#include "mock_event_groups.h"
+#include "mock_task.h"
+
+#include "mock_FreeRTOS_IP.h"
+#include "mock_FreeRTOS_IP_Private.h"
+#include "mock_FreeRTOS_IP_Utils.h"
+#include "mock_FreeRTOS_IP_Timers.h"
+#include "mock_NetworkBufferManagement.h"
+#include "mock_NetworkInterface.h"
+#include "mock_FreeRTOS_Sockets.h"
+#include "mock_FreeRTOS_Stream_Buffer.h"
+#include "mock_FreeRTOS_TCP_WIN.h"
+#include "mock_FreeRTOS_UDP_IP.h"
+#include "mock_FreeRTOS_ARP.h"
+#include "mock_FreeRTOS_TCP_State_Handling.h"
+#include "mock_FreeRTOS_TCP_Reception.h"
+#include "mock_FreeRTOS_TCP_Utils.h"
+#include "mock_TCP_Transmission_DiffConfig_list_macros.h"
+
+#include "FreeRTOS_TCP_IP.h"
+
+#include "catch_assert.h"
+
+#include "FreeRTOSIPConfig.h"
+
+#include "FreeRTOS_TCP_Transmission_DiffConfig_stubs.c"
+#include "FreeRTOS_TCP_Transmission.h"
+
+/* =========================== EXTERN VARIABLES =========================== */
+
+BaseType_t prvTCPPacingMaySend( FreeRTOS_Socket_t * pxSocket );
+uint32_t prvTCPPacingDelay( const FreeRTOS_Socket_t * pxSocket );
+
+/* The pacing rate used by most tests, in bytes per second. */
+#define tcptestPACING_RATE    ( 100000U )
+
+/* The MSS of the socket, a burst is two segments. */
+#define tcptestMSS            ( 1000U )
+
+static FreeRTOS_Socket_t xSocket;
+
+/* ======================== Stub Callback Functions ========================= */
+
+static uint32_t FreeRTOS_max_uint32_Callback( uint32_t a,
+                                              uint32_t b,
+                                              int cmock_num_calls )
+{
+    return ( a >= b ) ? a : b;
+}
+
+static uint32_t FreeRTOS_min_uint32_Callback( uint32_t a,
+                                              uint32_t b,
+                                              int cmock_num_calls )
+{
+    return ( a <= b ) ? a : b;
+}
+
+static int32_t FreeRTOS_min_int32_Callback( int32_t a,
+                                            int32_t b,
+                                            int cmock_num_calls )
+{
+    return ( a <= b ) ? a : b;
+}
+
+static int32_t FreeRTOS_max_int32_Callback( int32_t a,
+                                            int32_t b,
+                                            int cmock_num_calls )
+{
+    return ( a >= b ) ? a : b;
+}
+
+/* ============================== Test Cases ============================== */
+
+/**
+ * @brief calls at the beginning of each test case
+ */
+void setUp( void )
+{
+    memset( &xSocket, 0, sizeof( xSocket ) );
+    xSocket.u.xTCP.usMSS = tcptestMSS;
+    xSocket.u.xTCP.ulPacingRate = tcptestPACING_RATE;
+    xSocket.u.xTCP.xPacingLastTime = 500U;
+
+    FreeRTOS_max_uint32_Stub( FreeRTOS_max_uint32_Callback );
+    FreeRTOS_min_uint32_Stub( FreeRTOS_min_uint32_Callback );
+    FreeRTOS_min_int32_Stub( FreeRTOS_min_int32_Callback );
+    FreeRTOS_max_int32_Stub( FreeRTOS_max_int32_Callback );
+}
+
+/**
+ * @brief calls at the end of each test case
+ */
+void tearDown( void )
+{
+}
+
+/**
+ * @brief No time has passed and there is no credit: the segment must wait.
+ */
+void test_prvTCPPacingMaySend_NoCredit( void )
+{
+    BaseType_t xResult;
+
+    xTaskGetTickCount_ExpectAndReturn( 500U );
+
+    xResult = prvTCPPacingMaySend( &xSocket );
+
+    TEST_ASSERT_EQUAL( pdFALSE, xResult );
+    TEST_ASSERT_EQUAL( 0, xSocket.u.xTCP.lPacingCredit );
+    TEST_ASSERT_EQUAL( 500U, xSocket.u.xTCP.xPacingLastTime );
+}
+
+/**
+ * @brief Credit is earned at the pacing rate.
+ */
+void test_prvTCPPacingMaySend_CreditEarned( void )
+{
+    BaseType_t xResult;
+
+    xTaskGetTickCount_ExpectAndReturn( 500U + pdMS_TO_TICKS( 10U ) );
+
+    xResult = prvTCPPacingMaySend( &xSocket );
+
+    TEST_ASSERT_EQUAL( pdTRUE, xResult );
+    TEST_ASSERT_EQUAL( 1000, xSocket.u.xTCP.lPacingCredit );
+    TEST_ASSERT_EQUAL( 500U + pdMS_TO_TICKS( 10U ), xSocket.u.xTCP.xPacingLastTime );
+}
+
+/**
+ * @brief A negative credit must be paid back before a segment may be sent.
+ */
+void test_prvTCPPacingMaySend_NegativeCredit( void )
+{
+    BaseType_t xResult;
+
+    xSocket.u.xTCP.lPacingCredit = -1500;
+    xTaskGetTickCount_ExpectAndReturn( 500U + pdMS_TO_TICKS( 10U ) );
+
+    xResult = prvTCPPacingMaySend( &xSocket );
+
+    TEST_ASSERT_EQUAL( pdFALSE, xResult );
+    TEST_ASSERT_EQUAL( -500, xSocket.u.xTCP.lPacingCredit );
+}
+
+/**
+ * @brief The credit never exceeds a burst of two segments.
+ */
+void test_prvTCPPacingMaySend_CappedToBurst( void )
+{
+    BaseType_t xResult;
+
+    xTaskGetTickCount_ExpectAndReturn( 500U + pdMS_TO_TICKS( 1000U ) );
+
+    xResult = prvTCPPacingMaySend( &xSocket );
+
+    TEST_ASSERT_EQUAL( pdTRUE, xResult );
+    TEST_ASSERT_EQUAL( 2 * tcptestMSS, xSocket.u.xTCP.lPacingCredit );
+}
+
+/**
+ * @brief After a very long idle period, the conversion of the ticks to ms
+ *        would overflow: ( 2 ^ ( N - 3 ) ) * 1000 is a multiple of 2 ^ N.
+ *        The socket must still get its full burst.
+ */
+void test_prvTCPPacingMaySend_LongIdle( void )
+{
+    BaseType_t xResult;
+    TickType_t xIdle = ( ( TickType_t ) 1U ) << ( ( sizeof( TickType_t ) * 8U ) - 3U );
+
+    xSocket.u.xTCP.xPacingLastTime = 0U;
+    xTaskGetTickCount_ExpectAndReturn( xIdle );
+
+    xResult = prvTCPPacingMaySend( &xSocket );
+
+    TEST_ASSERT_EQUAL( pdTRUE, xResult );
+    TEST_ASSERT_EQUAL( 2 * tcptestMSS, xSocket.u.xTCP.lPacingCredit );
+    TEST_ASSERT_EQUAL( xIdle, xSocket.u.xTCP.xPacingLastTime );
+}
+
+/**
+ * @brief Without a user rate, the rate is twice the window per SRTT.
+ */
+void test_prvTCPPacingMaySend_RateFromWindow( void )
+{
+    BaseType_t xResult;
+
+    /* 2 * 10000 bytes per 100 ms is 200000 bytes per second. */
+    xSocket.u.xTCP.ulPacingRate = 0U;
+    xSocket.u.xTCP.ulWindowSize = 10000U;
+    xSocket.u.xTCP.xTCPWindow.xSize.ulTxWindowLength = 20000U;
+    xSocket.u.xTCP.xTCPWindow.lSRTT = 100;
+    xTaskGetTickCount_ExpectAndReturn( 500U + pdMS_TO_TICKS( 5U ) );
+
+    xResult = prvTCPPacingMaySend( &xSocket );
+
+    TEST_ASSERT_EQUAL( pdTRUE, xResult );
+    TEST_ASSERT_EQUAL( 1000, xSocket.u.xTCP.lPacingCredit );
+}
+
+/**
+ * @brief When the rate is not known, segments are not paced.
+ */
+void test_prvTCPPacingMaySend_RateUnknown( void )
+{
+    BaseType_t xResult;
+
+    xSocket.u.xTCP.ulPacingRate = 0U;
+    xSocket.u.xTCP.ulWindowSize = 0U;
+    xSocket.u.xTCP.xTCPWindow.lSRTT = 100;
+
+    xResult = prvTCPPacingMaySend( &xSocket );
+
+    TEST_ASSERT_EQUAL( pdTRUE, xResult );
+}
+
+/**
+ * @brief The delay is the time needed to earn back the missing credit.
+ */
+void test_prvTCPPacingDelay_Deficit( void )
+{
+    uint32_t ulDelay;
+
+    /* 1000 bytes at 100000 bytes per second take 10 ms, plus one. */
+    xSocket.u.xTCP.lPacingCredit = -999;
+
+    ulDelay = prvTCPPacingDelay( &xSocket );
+
+    TEST_ASSERT_EQUAL( 11U, ulDelay );
+}
+
+/**
+ * @brief There is no delay when the socket has credit.
+ */
+void test_prvTCPPacingDelay_Credit( void )
+{
+    uint32_t ulDelay;
+
+    xSocket.u.xTCP.lPacingCredit = 1;
+
+    ulDelay = prvTCPPacingDelay( &xSocket );
+
+    TEST_ASSERT_EQUAL( 0U, ulDelay );
+}
+
+/**
+ * @brief Every segment that a socket sends is counted, also an ACK in the
+ *        network buffer of a received packet.
+ */
+void test_prvTCPReturnPacket_TCPInfo_SegmentsSent( void )
+{
+    NetworkBufferDescriptor_t xNetworkBuffer;
+
+    memset( &xNetworkBuffer, 0, sizeof( xNetworkBuffer ) );
+    xSocket.u.xTCP.ulSegmentsSent = 7U;
+
+    uxIPHeaderSizeSocket_ExpectAnyArgsAndReturn( ipSIZE_OF_IPv6_HEADER );
+
+    prvTCPReturnPacket( &xSocket, NULL, 40, pdFALSE );
+
+    TEST_ASSERT_EQUAL_UINT32( 8U, xSocket.u.xTCP.ulSegmentsSent );
+
+    uxIPHeaderSizePacket_ExpectAnyArgsAndReturn( ipSIZE_OF_IPv6_HEADER );
+
+    prvTCPReturnPacket( &xSocket, &xNetworkBuffer, 40, pdTRUE );
+
+    TEST_ASSERT_EQUAL_UINT32( 9U, xSocket.u.xTCP.ulSegmentsSent );
+}
+
+/**
+ * @brief A reply without a socket, e.g. a RST, is not counted anywhere.
+ */
+void test_prvTCPReturnPacket_TCPInfo_NoSocket( void )
+{
+    NetworkBufferDescriptor_t xNetworkBuffer;
+
+    memset( &xNetworkBuffer, 0, sizeof( xNetworkBuffer ) );
+
+    uxIPHeaderSizePacket_ExpectAnyArgsAndReturn( ipSIZE_OF_IPv6_HEADER );
+
+    prvTCPReturnPacket( NULL, &xNetworkBuffer, 40, pdTRUE );
+
+    TEST_ASSERT_EQUAL_UINT32( 0U, xSocket.u.xTCP.ulSegmentsSent );
+}
@@ -0,0 +1,965 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdio.h>
+
+
+#include "FreeRTOS.h"
+
+#include "catch_assert.h"
+
+#include "FreeRTOSConfig.h"
+#include "FreeRTOSIPConfig.h"
+
+#include "FreeRTOS_TCP_WIN.h"
+
+#include "mock_list.h"
+#include "mock_FreeRTOS_TCP_WIN_DiffConfig_list_macros.h"
+#include "mock_portable.h"
+#include "mock_FreeRTOS_IP.h"
+#include "mock_task.h"
+
+/* The first sequence number and the length of the segments used in the tests. */
+#define SACK_TEST_FIRST_SEQUENCE    1000U
+#define SACK_TEST_MSS               1000U
+
+extern List_t xSegmentList;
+
+extern uint32_t prvTCPWindowTxPipe( const TCPWindow_t * pxWindow );
+extern void prvTCPWindowTxCheckAck_CalcRTO( TCPWindow_t * pxWindow,
+                                            int32_t lMeasured );
+extern uint32_t prvTCPWindowTxGetRTO( const TCPWindow_t * pxWindow,
+                                      const TCPSegment_t * pxSegment );
+
+static TCPWindow_t xWindow;
+static TCPSegment_t xSegments[ 8 ];
+static TickType_t xTickCount;
+
+static void initializeList( List_t * const pxList );
+static void prvPrepareWindow( size_t uxCount );
+
+/* ======================== Stub Callback Functions ========================= */
+
+static ListItem_t * listGET_NEXT_Callback( const ListItem_t * pxListItem,
+                                           int cmock_num_calls )
+{
+    return pxListItem->pxNext;
+}
+
+static void * listGET_LIST_ITEM_OWNER_Callback( const ListItem_t * pxListItem,
+                                                int cmock_num_calls )
+{
+    return pxListItem->pvOwner;
+}
+
+static BaseType_t listLIST_IS_EMPTY_Callback( const List_t * pxList,
+                                              int cmock_num_calls )
+{
+    return ( pxList->uxNumberOfItems == 0U ) ? pdTRUE : pdFALSE;
+}
+
+static ListItem_t * listGET_HEAD_ENTRY_Callback( const List_t * pxList,
+                                                 int cmock_num_calls )
+{
+    return pxList->xListEnd.pxNext;
+}
+
+static ListItem_t * listGET_END_MARKER_Callback( const List_t * pxList,
+                                                 int cmock_num_calls )
+{
+    return ( ListItem_t * ) &( pxList->xListEnd );
+}
+
+static UBaseType_t uxListRemove_Callback( ListItem_t * const pxItemToRemove,
+                                          int cmock_num_calls )
+{
+    List_t * const pxList = pxItemToRemove->pxContainer;
+
+    pxItemToRemove->pxNext->pxPrevious = pxItemToRemove->pxPrevious;
+    pxItemToRemove->pxPrevious->pxNext = pxItemToRemove->pxNext;
+
+    if( pxList->pxIndex == pxItemToRemove )
+    {
+        pxList->pxIndex = pxItemToRemove->pxPrevious;
+    }
+
+    pxItemToRemove->pxContainer = NULL;
+    ( pxList->uxNumberOfItems )--;
+
+    return pxList->uxNumberOfItems;
+}
+
+static TickType_t xTaskGetTickCount_Callback( int cmock_num_calls )
+{
+    return xTickCount;
+}
+
+static int32_t FreeRTOS_multiply_int32_Callback( int32_t a,
+                                                 int32_t b,
+                                                 int cmock_num_calls )
+{
+    return a * b;
+}
+
+static int32_t FreeRTOS_add_int32_Callback( int32_t a,
+                                            int32_t b,
+                                            int cmock_num_calls )
+{
+    return a + b;
+}
+
+static int32_t FreeRTOS_max_int32_Callback( int32_t a,
+                                            int32_t b,
+                                            int cmock_num_calls )
+{
+    return ( a >= b ) ? a : b;
+}
+
+static uint32_t FreeRTOS_max_uint32_Callback( uint32_t a,
+                                              uint32_t b,
+                                              int cmock_num_calls )
+{
+    return ( a >= b ) ? a : b;
+}
+
+static uint32_t FreeRTOS_min_uint32_Callback( uint32_t a,
+                                              uint32_t b,
+                                              int cmock_num_calls )
+{
+    return ( a <= b ) ? a : b;
+}
+
+/* ============================ Test Cases ============================ */
+
+/**
+ * @brief calls at the beginning of each test case
+ */
+void setUp( void )
+{
+    initializeList( &xSegmentList );
+    xTickCount = 100U;
+
+    /* The scoreboard walks real lists. */
+    listGET_NEXT_Stub( listGET_NEXT_Callback );
+    listGET_LIST_ITEM_OWNER_Stub( listGET_LIST_ITEM_OWNER_Callback );
+    listLIST_IS_EMPTY_Stub( listLIST_IS_EMPTY_Callback );
+    listGET_HEAD_ENTRY_Stub( listGET_HEAD_ENTRY_Callback );
+    listGET_END_MARKER_Stub( listGET_END_MARKER_Callback );
+    uxListRemove_Stub( uxListRemove_Callback );
+    xTaskGetTickCount_Stub( xTaskGetTickCount_Callback );
+    FreeRTOS_multiply_int32_Stub( FreeRTOS_multiply_int32_Callback );
+    FreeRTOS_add_int32_Stub( FreeRTOS_add_int32_Callback );
+    FreeRTOS_max_int32_Stub( FreeRTOS_max_int32_Callback );
+    FreeRTOS_max_uint32_Stub( FreeRTOS_max_uint32_Callback );
+    FreeRTOS_min_uint32_Stub( FreeRTOS_min_uint32_Callback );
+}
+
+/**
+ * @brief calls at the end of each test case
+ */
+void tearDown( void )
+{
+}
+
+static void initializeList( List_t * const pxList )
+{
+    pxList->pxIndex = ( ListItem_t * ) &( pxList->xListEnd );
+    pxList->xListEnd.xItemValue = portMAX_DELAY;
+    pxList->xListEnd.pxNext = ( ListItem_t * ) &( pxList->xListEnd );
+    pxList->xListEnd.pxPrevious = ( ListItem_t * ) &( pxList->xListEnd );
+    pxList->uxNumberOfItems = ( UBaseType_t ) 0U;
+}
+
+static void prvAppendToList( List_t * const pxList,
+                             ListItem_t * const pxItem )
+{
+    pxItem->pxNext = ( ListItem_t * ) &( pxList->xListEnd );
+    pxItem->pxPrevious = pxList->xListEnd.pxPrevious;
+    pxList->xListEnd.pxPrevious->pxNext = pxItem;
+    pxList->xListEnd.pxPrevious = pxItem;
+    pxItem->pxContainer = pxList;
+    ( pxList->uxNumberOfItems )++;
+}
+
+/* Create a window with 'uxCount' outstanding segments of SACK_TEST_MSS bytes,
+ * which are all waiting for an ACK. */
+static void prvPrepareWindow( size_t uxCount )
+{
+    size_t uxIndex;
+
+    memset( &xWindow, 0, sizeof( xWindow ) );
+    memset( xSegments, 0, sizeof( xSegments ) );
+
+    initializeList( &xWindow.xTxSegments );
+    initializeList( &xWindow.xPriorityQueue );
+    initializeList( &xWindow.xTxQueue );
+    initializeList( &xWindow.xWaitQueue );
+
+    xWindow.usMSS = SACK_TEST_MSS;
+    xWindow.lSRTT = ipconfigTCP_SRTT_MINIMUM_VALUE_MS;
+    xWindow.lRTO = 1000;
+    xWindow.tx.ulFirstSequenceNumber = SACK_TEST_FIRST_SEQUENCE;
+    xWindow.tx.ulCurrentSequenceNumber = SACK_TEST_FIRST_SEQUENCE;
+    xWindow.tx.ulHighestSequenceNumber = SACK_TEST_FIRST_SEQUENCE + ( uint32_t ) ( uxCount * SACK_TEST_MSS );
+
+    for( uxIndex = 0U; uxIndex < uxCount; uxIndex++ )
+    {
+        TCPSegment_t * pxSegment = &( xSegments[ uxIndex ] );
+
+        pxSegment->ulSequenceNumber = SACK_TEST_FIRST_SEQUENCE + ( uint32_t ) ( uxIndex * SACK_TEST_MSS );
+        pxSegment->lDataLength = ( int32_t ) SACK_TEST_MSS;
+        pxSegment->u.bits.bOutstanding = pdTRUE_UNSIGNED;
+        pxSegment->u.bits.ucTransmitCount = 1U;
+        pxSegment->xSegmentItem.pvOwner = pxSegment;
+        pxSegment->xQueueItem.pvOwner = pxSegment;
+
+        prvAppendToList( &xWindow.xTxSegments, &( pxSegment->xSegmentItem ) );
+        prvAppendToList( &xWindow.xWaitQueue, &( pxSegment->xQueueItem ) );
+    }
+}
+
+/* SACK the segments with index [ uxFirst, uxLast ). */
+static uint32_t prvSack( size_t uxFirst,
+                         size_t uxLast )
+{
+    return ulTCPWindowTxSack( &xWindow,
+                              SACK_TEST_FIRST_SEQUENCE + ( uint32_t ) ( uxFirst * SACK_TEST_MSS ),
+                              SACK_TEST_FIRST_SEQUENCE + ( uint32_t ) ( uxLast * SACK_TEST_MSS ) );
+}
+
+/**
+ * @brief Three SACK'd segments above a hole: the hole is lost and queued for
+ *        retransmission, and a recovery episode starts.
+ */
+void test_ulTCPWindowTxSack_ThreeSegmentsAbove_HoleIsLost( void )
+{
+    uint32_t ulAckCount;
+
+    prvPrepareWindow( 5U );
+
+    ulAckCount = prvSack( 1U, 4U );
+
+    /* The left edge did not move. */
+    TEST_ASSERT_EQUAL( 0U, ulAckCount );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xSegments[ 1 ].u.bits.bAcked );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xSegments[ 3 ].u.bits.bAcked );
+
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xSegments[ 0 ].u.bits.bIsLost );
+    TEST_ASSERT_EQUAL_PTR( &( xWindow.xPriorityQueue ), xSegments[ 0 ].xQueueItem.pxContainer );
+    TEST_ASSERT_EQUAL( 1U, xWindow.xPriorityQueue.uxNumberOfItems );
+
+    /* Nothing has been SACK'd above the last segment. */
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xSegments[ 4 ].u.bits.bIsLost );
+    TEST_ASSERT_EQUAL_PTR( &( xWindow.xWaitQueue ), xSegments[ 4 ].xQueueItem.pxContainer );
+
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xWindow.u.bits.bInRecovery );
+    TEST_ASSERT_EQUAL( xWindow.tx.ulHighestSequenceNumber, xWindow.ulRecoveryPoint );
+}
+
+/**
+ * @brief Three SACK'd segments declare a loss, even when they hold less than
+ *        2 * MSS bytes.
+ */
+void test_ulTCPWindowTxSack_ThreeSmallSegmentsAbove_HoleIsLost( void )
+{
+    prvPrepareWindow( 5U );
+
+    /* The segments are only half of the MSS. */
+    xWindow.usMSS = 2U * SACK_TEST_MSS;
+
+    ( void ) prvSack( 1U, 4U );
+
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xSegments[ 0 ].u.bits.bIsLost );
+    TEST_ASSERT_EQUAL_PTR( &( xWindow.xPriorityQueue ), xSegments[ 0 ].xQueueItem.pxContainer );
+}
+
+/**
+ * @brief Two SACK'd segments of MSS bytes are not enough to declare a loss.
+ */
+void test_ulTCPWindowTxSack_TwoSegmentsAbove_NotLost( void )
+{
+    prvPrepareWindow( 4U );
+
+    ( void ) prvSack( 1U, 3U );
+
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xSegments[ 0 ].u.bits.bIsLost );
+    TEST_ASSERT_EQUAL_PTR( &( xWindow.xWaitQueue ), xSegments[ 0 ].xQueueItem.pxContainer );
+    TEST_ASSERT_EQUAL( 0U, xWindow.xPriorityQueue.uxNumberOfItems );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xWindow.u.bits.bInRecovery );
+}
+
+/**
+ * @brief More than 2 * MSS of SACK'd data declares a loss, even when fewer than
+ *        three segments have been SACK'd.
+ */
+void test_ulTCPWindowTxSack_BytesAbove_HoleIsLost( void )
+{
+    prvPrepareWindow( 4U );
+
+    /* The MSS became smaller after the segments were sent. */
+    xWindow.usMSS = SACK_TEST_MSS / 2U;
+
+    ( void ) prvSack( 1U, 3U );
+
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xSegments[ 0 ].u.bits.bIsLost );
+    TEST_ASSERT_EQUAL_PTR( &( xWindow.xPriorityQueue ), xSegments[ 0 ].xQueueItem.pxContainer );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xWindow.u.bits.bInRecovery );
+}
+
+/**
+ * @brief Several holes are detected at once, and they are queued from low to
+ *        high sequence number.
+ */
+void test_ulTCPWindowTxSack_TwoHoles_BothLost( void )
+{
+    TCPSegment_t * pxFirst;
+
+    prvPrepareWindow( 6U );
+
+    /* SACK 1, then 3, 4 and 5: holes at 0 and 2. */
+    ( void ) prvSack( 1U, 2U );
+    TEST_ASSERT_EQUAL( 0U, xWindow.xPriorityQueue.uxNumberOfItems );
+
+    ( void ) prvSack( 3U, 6U );
+
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xSegments[ 0 ].u.bits.bIsLost );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xSegments[ 2 ].u.bits.bIsLost );
+    TEST_ASSERT_EQUAL( 2U, xWindow.xPriorityQueue.uxNumberOfItems );
+
+    pxFirst = ( TCPSegment_t * ) xWindow.xPriorityQueue.xListEnd.pxNext->pvOwner;
+    TEST_ASSERT_EQUAL_PTR( &( xSegments[ 0 ] ), pxFirst );
+}
+
+/**
+ * @brief A segment that was already marked as lost is not queued a second time.
+ */
+void test_ulTCPWindowTxSack_AlreadyLost_NotQueuedAgain( void )
+{
+    prvPrepareWindow( 6U );
+
+    ( void ) prvSack( 1U, 4U );
+    TEST_ASSERT_EQUAL( 1U, xWindow.xPriorityQueue.uxNumberOfItems );
+
+    /* The retransmission was sent, the segment is waiting again. */
+    ( void ) uxListRemove_Callback( &( xSegments[ 0 ].xQueueItem ), 0 );
+    prvAppendToList( &xWindow.xWaitQueue, &( xSegments[ 0 ].xQueueItem ) );
+
+    ( void ) prvSack( 4U, 5U );
+
+    TEST_ASSERT_EQUAL( 0U, xWindow.xPriorityQueue.uxNumberOfItems );
+    TEST_ASSERT_EQUAL_PTR( &( xWindow.xWaitQueue ), xSegments[ 0 ].xQueueItem.pxContainer );
+}
+
+/**
+ * @brief An ACK below the recovery point does not end the recovery.
+ */
+void test_ulTCPWindowTxAck_BelowRecoveryPoint_StaysInRecovery( void )
+{
+    uint32_t ulAckCount;
+
+    prvPrepareWindow( 5U );
+    ( void ) prvSack( 1U, 4U );
+
+    /* The retransmission of segment 0 arrived, segments 1..3 were SACK'd. */
+    ulAckCount = ulTCPWindowTxAck( &xWindow, SACK_TEST_FIRST_SEQUENCE + ( 4U * SACK_TEST_MSS ) );
+
+    TEST_ASSERT_EQUAL( 4U * SACK_TEST_MSS, ulAckCount );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xWindow.u.bits.bInRecovery );
+}
+
+/**
+ * @brief An ACK of the recovery point ends the recovery.
+ */
+void test_ulTCPWindowTxAck_RecoveryPoint_LeavesRecovery( void )
+{
+    uint32_t ulAckCount;
+
+    prvPrepareWindow( 5U );
+    ( void ) prvSack( 1U, 4U );
+
+    ulAckCount = ulTCPWindowTxAck( &xWindow, xWindow.ulRecoveryPoint );
+
+    TEST_ASSERT_EQUAL( 5U * SACK_TEST_MSS, ulAckCount );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xWindow.u.bits.bInRecovery );
+    TEST_ASSERT_EQUAL( 0U, xWindow.xTxSegments.uxNumberOfItems );
+}
+
+/**
+ * @brief The pipe counts outstanding data that is neither SACK'd nor lost, and
+ *        lost data once it has been retransmitted.
+ */
+void test_prvTCPWindowTxPipe( void )
+{
+    uint32_t ulPipe;
+
+    prvPrepareWindow( 5U );
+
+    TEST_ASSERT_EQUAL( 5U * SACK_TEST_MSS, prvTCPWindowTxPipe( &xWindow ) );
+
+    ( void ) prvSack( 1U, 4U );
+
+    /* Only segment 4 is in flight, segment 0 is lost. */
+    ulPipe = prvTCPWindowTxPipe( &xWindow );
+    TEST_ASSERT_EQUAL( SACK_TEST_MSS, ulPipe );
+
+    /* Segment 0 has been retransmitted. */
+    xSegments[ 0 ].u.bits.bSackRexmit = pdTRUE_UNSIGNED;
+
+    ulPipe = prvTCPWindowTxPipe( &xWindow );
+    TEST_ASSERT_EQUAL( 2U * SACK_TEST_MSS, ulPipe );
+}
+
+/**
+ * @brief The first RTT sample sets SRTT = R and RTTVAR = R / 2.
+ */
+void test_prvTCPWindowTxCheckAck_CalcRTO_FirstSample( void )
+{
+    prvPrepareWindow( 0U );
+
+    prvTCPWindowTxCheckAck_CalcRTO( &xWindow, 100 );
+
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xWindow.u.bits.bRTTSampled );
+    TEST_ASSERT_EQUAL( 100, xWindow.lSRTT );
+    TEST_ASSERT_EQUAL( 50, xWindow.lRTTVar );
+    /* RTO = SRTT + 4 * RTTVAR */
+    TEST_ASSERT_EQUAL( 300, xWindow.lRTO );
+}
+
+/**
+ * @brief Later samples update RTTVAR before SRTT, with beta = 1/4 and
+ *        alpha = 1/8.
+ */
+void test_prvTCPWindowTxCheckAck_CalcRTO_NextSample( void )
+{
+    prvPrepareWindow( 0U );
+
+    prvTCPWindowTxCheckAck_CalcRTO( &xWindow, 100 );
+    prvTCPWindowTxCheckAck_CalcRTO( &xWindow, 200 );
+
+    /* RTTVAR = ( 3 * 50 + | 100 - 200 | ) / 4 */
+    TEST_ASSERT_EQUAL( 62, xWindow.lRTTVar );
+    /* SRTT = ( 7 * 100 + 200 ) / 8 */
+    TEST_ASSERT_EQUAL( 112, xWindow.lSRTT );
+    TEST_ASSERT_EQUAL( 112 + ( 4 * 62 ), xWindow.lRTO );
+}
+
+/**
+ * @brief The variance term is at least the clock granularity, and the RTO does
+ *        not go below the minimum SRTT.
+ */
+void test_prvTCPWindowTxCheckAck_CalcRTO_LowerLimit( void )
+{
+    prvPrepareWindow( 0U );
+
+    prvTCPWindowTxCheckAck_CalcRTO( &xWindow, 1 );
+    TEST_ASSERT_EQUAL( ipconfigTCP_SRTT_MINIMUM_VALUE_MS, xWindow.lRTO );
+
+    /* After a series of identical samples, RTTVAR has dropped to zero. */
+    xWindow.lRTTVar = 0;
+    xWindow.lSRTT = 1000;
+    prvTCPWindowTxCheckAck_CalcRTO( &xWindow, 1000 );
+
+    TEST_ASSERT_EQUAL( 0, xWindow.lRTTVar );
+    TEST_ASSERT_EQUAL( 1000 + ( int32_t ) portTICK_PERIOD_MS, xWindow.lRTO );
+}
+
+/**
+ * @brief A negative or a very large sample is limited to 60 seconds, and so is
+ *        the RTO.
+ */
+void test_prvTCPWindowTxCheckAck_CalcRTO_UpperLimit( void )
+{
+    prvPrepareWindow( 0U );
+
+    prvTCPWindowTxCheckAck_CalcRTO( &xWindow, -1 );
+
+    TEST_ASSERT_EQUAL( 60000, xWindow.lSRTT );
+    TEST_ASSERT_EQUAL( 60000, xWindow.lRTO );
+
+    prvTCPWindowTxCheckAck_CalcRTO( &xWindow, 0x7FFFFFFF );
+
+    TEST_ASSERT_EQUAL( 60000, xWindow.lSRTT );
+    TEST_ASSERT_EQUAL( 60000, xWindow.lRTO );
+}
+
+/**
+ * @brief Every retransmission doubles the time-out, up to 60 seconds.
+ */
+void test_prvTCPWindowTxGetRTO_BackOff( void )
+{
+    prvPrepareWindow( 1U );
+    xWindow.lRTO = 1000;
+
+    xSegments[ 0 ].u.bits.ucTransmitCount = 1U;
+    TEST_ASSERT_EQUAL( 1000U, prvTCPWindowTxGetRTO( &xWindow, &( xSegments[ 0 ] ) ) );
+
+    xSegments[ 0 ].u.bits.ucTransmitCount = 3U;
+    TEST_ASSERT_EQUAL( 4000U, prvTCPWindowTxGetRTO( &xWindow, &( xSegments[ 0 ] ) ) );
+
+    xSegments[ 0 ].u.bits.ucTransmitCount = 10U;
+    TEST_ASSERT_EQUAL( 60000U, prvTCPWindowTxGetRTO( &xWindow, &( xSegments[ 0 ] ) ) );
+}
+
+/**
+ * @brief An echoed time-stamp gives an RTT sample, also when the segment was
+ *        retransmitted. The echo is used only once.
+ */
+void test_ulTCPWindowTxAck_TimeStampEcho_RetransmittedSegment( void )
+{
+    uint32_t ulNow = ulTCPWindowGetTimeStamp();
+
+    prvPrepareWindow( 2U );
+    xSegments[ 0 ].u.bits.ucTransmitCount = 2U;
+
+    xWindow.ulTSEcho = ulNow - 40U;
+    xWindow.u.bits.bTSEchoValid = pdTRUE_UNSIGNED;
+
+    ( void ) ulTCPWindowTxAck( &xWindow, SACK_TEST_FIRST_SEQUENCE + SACK_TEST_MSS );
+
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xWindow.u.bits.bRTTSampled );
+    TEST_ASSERT_EQUAL( 40, xWindow.lSRTT );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xWindow.u.bits.bTSEchoValid );
+}
+
+/**
+ * @brief A TSecr of zero is a valid echo, the clock may have been zero when
+ *        the segment was sent.
+ */
+void test_ulTCPWindowTxAck_TimeStampEcho_Zero( void )
+{
+    uint32_t ulNow = ulTCPWindowGetTimeStamp();
+
+    prvPrepareWindow( 2U );
+    xSegments[ 0 ].u.bits.ucTransmitCount = 2U;
+
+    xWindow.ulTSEcho = 0U;
+    xWindow.u.bits.bTSEchoValid = pdTRUE_UNSIGNED;
+
+    ( void ) ulTCPWindowTxAck( &xWindow, SACK_TEST_FIRST_SEQUENCE + SACK_TEST_MSS );
+
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xWindow.u.bits.bRTTSampled );
+    TEST_ASSERT_EQUAL( ( int32_t ) ulNow, xWindow.lSRTT );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xWindow.u.bits.bTSEchoValid );
+}
+
+/**
+ * @brief Without a valid echo, a retransmitted segment does not give an RTT
+ *        sample, and the flag is cleared after the ACK was processed.
+ */
+void test_ulTCPWindowTxAck_TimeStampEcho_NotValid( void )
+{
+    prvPrepareWindow( 2U );
+    xSegments[ 0 ].u.bits.ucTransmitCount = 2U;
+
+    xWindow.ulTSEcho = 1234U;
+    xWindow.u.bits.bTSEchoValid = pdFALSE_UNSIGNED;
+
+    ( void ) ulTCPWindowTxAck( &xWindow, SACK_TEST_FIRST_SEQUENCE + SACK_TEST_MSS );
+
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xWindow.u.bits.bRTTSampled );
+    TEST_ASSERT_EQUAL( 1000, xWindow.lRTO );
+
+    /* An ACK that does not acknowledge new data consumes the echo as well. */
+    xWindow.u.bits.bTSEchoValid = pdTRUE_UNSIGNED;
+
+    ( void ) ulTCPWindowTxAck( &xWindow, SACK_TEST_FIRST_SEQUENCE + SACK_TEST_MSS );
+
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xWindow.u.bits.bTSEchoValid );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xWindow.u.bits.bRTTSampled );
+}
+
+/* Prepare a reception window of 'ulSegments' segments, which may grow up to
+ * 'ulMaxSegments' segments. */
+static void prvPrepareRxWindow( uint32_t ulSegments,
+                                uint32_t ulMaxSegments )
+{
+    prvPrepareWindow( 0U );
+
+    xWindow.xSize.ulRxWindowLength = ulSegments * SACK_TEST_MSS;
+    xWindow.ulRxWindowMaximum = ulMaxSegments * SACK_TEST_MSS;
+}
+
+/**
+ * @brief When the peer fills the window during one RTT, the window grows to
+ *        twice the amount of data received per RTT.
+ */
+void test_xTCPWindowRxAutoTune_WindowFull_Grows( void )
+{
+    BaseType_t xResult;
+
+    prvPrepareRxWindow( 4U, 16U );
+
+    /* The measurement starts, no RTT has passed yet. */
+    xResult = xTCPWindowRxAutoTune( &xWindow, 4U * SACK_TEST_MSS );
+    TEST_ASSERT_EQUAL( pdFALSE, xResult );
+    TEST_ASSERT_EQUAL( 4U * SACK_TEST_MSS, xWindow.xSize.ulRxWindowLength );
+
+    /* One RTT later. */
+    xTickCount += pdMS_TO_TICKS( ipconfigTCP_SRTT_MINIMUM_VALUE_MS );
+    xResult = xTCPWindowRxAutoTune( &xWindow, 0U );
+
+    TEST_ASSERT_EQUAL( pdTRUE, xResult );
+    TEST_ASSERT_EQUAL( 8U * SACK_TEST_MSS, xWindow.xSize.ulRxWindowLength );
+    TEST_ASSERT_EQUAL( 0U, xWindow.ulRxAutoTuneBytes );
+}
+
+/**
+ * @brief The grown window is rounded up to a whole number of segments.
+ */
+void test_xTCPWindowRxAutoTune_RoundedToMSS( void )
+{
+    BaseType_t xResult;
+
+    prvPrepareRxWindow( 4U, 16U );
+
+    ( void ) xTCPWindowRxAutoTune( &xWindow, ( 3U * SACK_TEST_MSS ) + 100U );
+    xTickCount += pdMS_TO_TICKS( ipconfigTCP_SRTT_MINIMUM_VALUE_MS );
+    xResult = xTCPWindowRxAutoTune( &xWindow, 0U );
+
+    TEST_ASSERT_EQUAL( pdTRUE, xResult );
+    TEST_ASSERT_EQUAL( 7U * SACK_TEST_MSS, xWindow.xSize.ulRxWindowLength );
+}
+
+/**
+ * @brief When less than 75% of the window was used, the window is not the
+ *        bottleneck and it does not grow.
+ */
+void test_xTCPWindowRxAutoTune_WindowNotFull_NoGrowth( void )
+{
+    BaseType_t xResult;
+
+    prvPrepareRxWindow( 4U, 16U );
+
+    ( void ) xTCPWindowRxAutoTune( &xWindow, 2U * SACK_TEST_MSS );
+    xTickCount += pdMS_TO_TICKS( ipconfigTCP_SRTT_MINIMUM_VALUE_MS );
+    xResult = xTCPWindowRxAutoTune( &xWindow, 0U );
+
+    TEST_ASSERT_EQUAL( pdFALSE, xResult );
+    TEST_ASSERT_EQUAL( 4U * SACK_TEST_MSS, xWindow.xSize.ulRxWindowLength );
+    TEST_ASSERT_EQUAL( 0U, xWindow.ulRxAutoTuneBytes );
+}
+
+/**
+ * @brief The window never grows beyond 'ulRxWindowMaximum'.
+ */
+void test_xTCPWindowRxAutoTune_CappedAtMaximum( void )
+{
+    BaseType_t xResult;
+
+    prvPrepareRxWindow( 4U, 6U );
+
+    /* Twice the data per RTT would be 8 segments. */
+    ( void ) xTCPWindowRxAutoTune( &xWindow, 4U * SACK_TEST_MSS );
+    xTickCount += pdMS_TO_TICKS( ipconfigTCP_SRTT_MINIMUM_VALUE_MS );
+    xResult = xTCPWindowRxAutoTune( &xWindow, 0U );
+
+    TEST_ASSERT_EQUAL( pdTRUE, xResult );
+    TEST_ASSERT_EQUAL( 6U * SACK_TEST_MSS, xWindow.xSize.ulRxWindowLength );
+
+    /* Once at the maximum, it does not grow any further. */
+    ( void ) xTCPWindowRxAutoTune( &xWindow, 6U * SACK_TEST_MSS );
+    xTickCount += pdMS_TO_TICKS( ipconfigTCP_SRTT_MINIMUM_VALUE_MS );
+    xResult = xTCPWindowRxAutoTune( &xWindow, 0U );
+
+    TEST_ASSERT_EQUAL( pdFALSE, xResult );
+    TEST_ASSERT_EQUAL( 6U * SACK_TEST_MSS, xWindow.xSize.ulRxWindowLength );
+}
+
+/**
+ * @brief A measurement that took several RTTs is averaged per RTT.
+ */
+void test_xTCPWindowRxAutoTune_SeveralRTTs( void )
+{
+    BaseType_t xResult;
+
+    prvPrepareRxWindow( 4U, 16U );
+
+    /* 4 segments in 2 RTTs is only half of the window per RTT. */
+    ( void ) xTCPWindowRxAutoTune( &xWindow, 4U * SACK_TEST_MSS );
+    xTickCount += pdMS_TO_TICKS( 2U * ipconfigTCP_SRTT_MINIMUM_VALUE_MS );
+    xResult = xTCPWindowRxAutoTune( &xWindow, 0U );
+
+    TEST_ASSERT_EQUAL( pdFALSE, xResult );
+    TEST_ASSERT_EQUAL( 4U * SACK_TEST_MSS, xWindow.xSize.ulRxWindowLength );
+}
+
+/* Mark all outstanding segments as sent at 'xTickCount', and let 'xElapsed'
+ * ms pass. */
+static void prvSetSegmentAge( size_t uxCount,
+                              TickType_t xElapsed )
+{
+    size_t uxIndex;
+
+    for( uxIndex = 0U; uxIndex < uxCount; uxIndex++ )
+    {
+        xSegments[ uxIndex ].xTransmitTimer.uxBorn = xTickCount;
+    }
+
+    xTickCount += pdMS_TO_TICKS( xElapsed );
+}
+
+/**
+ * @brief The probe time-out of a flight is 2 * SRTT, counted from the moment
+ *        the last segment was sent.
+ */
+void test_xTCPWindowTxHasData_TailLossProbe_Delay( void )
+{
+    TickType_t xDelay;
+    BaseType_t xResult;
+
+    prvPrepareWindow( 2U );
+    xWindow.lSRTT = 50;
+    prvSetSegmentAge( 2U, 30U );
+
+    xResult = xTCPWindowTxHasData( &xWindow, 8U * SACK_TEST_MSS, &xDelay );
+
+    TEST_ASSERT_EQUAL( pdTRUE, xResult );
+    TEST_ASSERT_EQUAL( 70U, xDelay );
+}
+
+/**
+ * @brief When a single segment is outstanding, the PTO allows for a delayed
+ *        ACK from the peer.
+ */
+void test_xTCPWindowTxHasData_TailLossProbe_SingleSegment( void )
+{
+    TickType_t xDelay;
+
+    prvPrepareWindow( 1U );
+    xWindow.lSRTT = 50;
+    prvSetSegmentAge( 1U, 30U );
+
+    ( void ) xTCPWindowTxHasData( &xWindow, 8U * SACK_TEST_MSS, &xDelay );
+
+    TEST_ASSERT_EQUAL( ( 2U * 50U ) + 200U - 30U, xDelay );
+}
+
+/**
+ * @brief Once a probe has been sent, the next time-out is the RTO.
+ */
+void test_xTCPWindowTxHasData_TailLossProbe_AlreadySent( void )
+{
+    TickType_t xDelay;
+
+    prvPrepareWindow( 2U );
+    xWindow.lSRTT = 50;
+    xWindow.u.bits.bProbeSent = pdTRUE_UNSIGNED;
+    prvSetSegmentAge( 2U, 30U );
+
+    ( void ) xTCPWindowTxHasData( &xWindow, 8U * SACK_TEST_MSS, &xDelay );
+
+    TEST_ASSERT_EQUAL( 1000U - 30U, xDelay );
+}
+
+/**
+ * @brief A PTO that does not come before the RTO is not used.
+ */
+void test_xTCPWindowTxHasData_TailLossProbe_NotBeforeRTO( void )
+{
+    TickType_t xDelay;
+
+    prvPrepareWindow( 2U );
+    xWindow.lSRTT = 600;
+    prvSetSegmentAge( 2U, 30U );
+
+    ( void ) xTCPWindowTxHasData( &xWindow, 8U * SACK_TEST_MSS, &xDelay );
+
+    TEST_ASSERT_EQUAL( 1000U - 30U, xDelay );
+}
+
+/**
+ * @brief Before the PTO has expired, there is nothing to send.
+ */
+void test_ulTCPWindowTxGet_TailLossProbe_NotExpired( void )
+{
+    int32_t lPosition = -1;
+    uint32_t ulLength;
+
+    prvPrepareWindow( 2U );
+    xWindow.lSRTT = 50;
+    prvSetSegmentAge( 2U, 99U );
+
+    ulLength = ulTCPWindowTxGet( &xWindow, 8U * SACK_TEST_MSS, &lPosition );
+
+    TEST_ASSERT_EQUAL( 0U, ulLength );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xWindow.u.bits.bProbeSent );
+}
+
+/**
+ * @brief When the PTO expires, the last segment is sent again. The probe is
+ *        not counted as a transmission, so the RTO is not backed off.
+ */
+void test_ulTCPWindowTxGet_TailLossProbe_Sent( void )
+{
+    int32_t lPosition = -1;
+    uint32_t ulLength;
+
+    prvPrepareWindow( 2U );
+    xWindow.lSRTT = 50;
+    xSegments[ 1 ].lStreamPos = ( int32_t ) SACK_TEST_MSS;
+    prvSetSegmentAge( 2U, 100U );
+
+    ulLength = ulTCPWindowTxGet( &xWindow, 8U * SACK_TEST_MSS, &lPosition );
+
+    TEST_ASSERT_EQUAL( SACK_TEST_MSS, ulLength );
+    TEST_ASSERT_EQUAL( ( int32_t ) SACK_TEST_MSS, lPosition );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xWindow.u.bits.bProbeSent );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xSegments[ 1 ].u.bits.bIsProbe );
+    TEST_ASSERT_EQUAL( 1U, xSegments[ 1 ].u.bits.ucTransmitCount );
+    TEST_ASSERT_EQUAL( 1000U, prvTCPWindowTxGetRTO( &xWindow, &( xSegments[ 1 ] ) ) );
+
+    /* For the statistics, the probe is a retransmission. */
+    TEST_ASSERT_EQUAL( 1U, xWindow.ulRetransmissions );
+    TEST_ASSERT_EQUAL( SACK_TEST_MSS, xWindow.ulBytesSent );
+
+    /* The probe is sent only once. */
+    ulLength = ulTCPWindowTxGet( &xWindow, 8U * SACK_TEST_MSS, &lPosition );
+    TEST_ASSERT_EQUAL( 0U, ulLength );
+}
+
+/**
+ * @brief The ACK of a probed segment is ambiguous, no RTT sample is taken.
+ */
+void test_ulTCPWindowTxAck_TailLossProbe_NoRTTSample( void )
+{
+    prvPrepareWindow( 1U );
+    xWindow.lSRTT = 50;
+    xSegments[ 0 ].u.bits.bIsProbe = pdTRUE_UNSIGNED;
+    prvSetSegmentAge( 1U, 40U );
+
+    ( void ) ulTCPWindowTxAck( &xWindow, SACK_TEST_FIRST_SEQUENCE + SACK_TEST_MSS );
+
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xWindow.u.bits.bRTTSampled );
+    TEST_ASSERT_EQUAL( 50, xWindow.lSRTT );
+}
+
+/**
+ * @brief A segment from the priority queue that was sent before is counted
+ *        as a retransmission, and its bytes as sent.
+ */
+void test_ulTCPWindowTxGet_TCPInfo_Retransmission( void )
+{
+    int32_t lPosition = -1;
+    uint32_t ulLength;
+
+    prvPrepareWindow( 1U );
+    ( void ) uxListRemove( &( xSegments[ 0 ].xQueueItem ) );
+    prvAppendToList( &xWindow.xPriorityQueue, &( xSegments[ 0 ].xQueueItem ) );
+    xWindow.ulBytesSent = 500U;
+
+    ulLength = ulTCPWindowTxGet( &xWindow, 8U * SACK_TEST_MSS, &lPosition );
+
+    TEST_ASSERT_EQUAL( SACK_TEST_MSS, ulLength );
+    TEST_ASSERT_EQUAL( 2U, xSegments[ 0 ].u.bits.ucTransmitCount );
+    TEST_ASSERT_EQUAL( 1U, xWindow.ulRetransmissions );
+    TEST_ASSERT_EQUAL( 500U + SACK_TEST_MSS, xWindow.ulBytesSent );
+}
+
+/**
+ * @brief The first transmission of a segment counts its bytes, but it is not
+ *        a retransmission.
+ */
+void test_ulTCPWindowTxGet_TCPInfo_FirstTransmission( void )
+{
+    int32_t lPosition = -1;
+    uint32_t ulLength;
+
+    prvPrepareWindow( 1U );
+    ( void ) uxListRemove( &( xSegments[ 0 ].xQueueItem ) );
+    prvAppendToList( &xWindow.xPriorityQueue, &( xSegments[ 0 ].xQueueItem ) );
+    xSegments[ 0 ].u.bits.ucTransmitCount = 0U;
+
+    ulLength = ulTCPWindowTxGet( &xWindow, 8U * SACK_TEST_MSS, &lPosition );
+
+    TEST_ASSERT_EQUAL( SACK_TEST_MSS, ulLength );
+    TEST_ASSERT_EQUAL( 1U, xSegments[ 0 ].u.bits.ucTransmitCount );
+    TEST_ASSERT_EQUAL( 0U, xWindow.ulRetransmissions );
+    TEST_ASSERT_EQUAL( SACK_TEST_MSS, xWindow.ulBytesSent );
+}
+
+/**
+ * @brief Every SACK block from the peer is counted.
+ */
+void test_ulTCPWindowTxSack_TCPInfo_Counted( void )
+{
+    prvPrepareWindow( 4U );
+
+    ( void ) prvSack( 1U, 2U );
+    ( void ) prvSack( 3U, 4U );
+
+    TEST_ASSERT_EQUAL( 2U, xWindow.ulSACKsReceived );
+}
+
+/**
+ * @brief A segment that was stored out of order arrives again: a SACK option
+ *        is prepared and counted.
+ */
+void test_lTCPWindowRxCheck_TCPInfo_SACKSent( void )
+{
+    uint32_t ulSkipCount;
+    int32_t lReturn;
+
+    prvPrepareWindow( 0U );
+    initializeList( &xWindow.xRxSegments );
+    xWindow.rx.ulCurrentSequenceNumber = SACK_TEST_FIRST_SEQUENCE;
+    xSegments[ 0 ].ulSequenceNumber = SACK_TEST_FIRST_SEQUENCE + 2U * SACK_TEST_MSS;
+    xSegments[ 0 ].lDataLength = ( int32_t ) SACK_TEST_MSS;
+    xSegments[ 0 ].xSegmentItem.pvOwner = &( xSegments[ 0 ] );
+    prvAppendToList( &xWindow.xRxSegments, &( xSegments[ 0 ].xSegmentItem ) );
+
+    lReturn = lTCPWindowRxCheck( &xWindow, SACK_TEST_FIRST_SEQUENCE + 2U * SACK_TEST_MSS, SACK_TEST_MSS, 8U * SACK_TEST_MSS, &ulSkipCount );
+
+    TEST_ASSERT_EQUAL( -1, lReturn );
+    TEST_ASSERT_NOT_EQUAL( 0U, xWindow.ucOptionLength );
+    TEST_ASSERT_EQUAL( 1U, xWindow.ulSACKsSent );
+}
+
+/**
+ * @brief An out-of-order segment can not be stored because all segments are
+ *        in use: no SACK is sent, so none is counted.
+ */
+void test_lTCPWindowRxCheck_TCPInfo_NoSegment_NotCounted( void )
+{
+    uint32_t ulSkipCount;
+    int32_t lReturn;
+
+    prvPrepareWindow( 0U );
+    initializeList( &xWindow.xRxSegments );
+    xWindow.rx.ulCurrentSequenceNumber = SACK_TEST_FIRST_SEQUENCE;
+
+    lReturn = lTCPWindowRxCheck( &xWindow, SACK_TEST_FIRST_SEQUENCE + 2U * SACK_TEST_MSS, SACK_TEST_MSS, 8U * SACK_TEST_MSS, &ulSkipCount );
+
+    TEST_ASSERT_EQUAL( -1, lReturn );
+    TEST_ASSERT_EQUAL( 0U, xWindow.ucOptionLength );
+    TEST_ASSERT_EQUAL( 0U, xWindow.ulSACKsSent );
+}
@@ -76,6 +76,9 @@ void * listGET_LIST_ITEM_OWNER( const ListItem_t * listItem );
 
 FreeRTOS_Socket_t * pxUDPSocketLookup( UBaseType_t uxLocalPort );
 
+BaseType_t xUDPSocketAcceptsPacket( const FreeRTOS_Socket_t * pxSocket,
+                                    const NetworkBufferDescriptor_t * pxNetworkBuffer );
+
 size_t uxIPHeaderSizePacket( const NetworkBufferDescriptor_t * pxNetworkBuffer );
 
 uint16_t usGenerateChecksum( uint16_t usSum,
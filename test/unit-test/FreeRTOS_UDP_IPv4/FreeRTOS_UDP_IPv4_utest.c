@@ -629,6 +629,41 @@ void test_xProcessReceivedUDPPacket_IPv4_NoSocket()
     TEST_ASSERT_EQUAL( pdFAIL, xReturn );
 }
 
+/**
+ * @brief To validate that a socket which is connected to another peer is treated
+ *        as if no one is waiting for the packet.
+ */
+void test_xProcessReceivedUDPPacket_IPv4_SocketConnectedOtherPeer()
+{
+    BaseType_t xReturn;
+    uint16_t usSrcPort = 2048U;
+    uint16_t usDestPort = 1024U;
+    uint16_t usDestPortNetworkEndian = FreeRTOS_htons( usDestPort );
+    BaseType_t xIsWaitingForARPResolution;
+    NetworkBufferDescriptor_t xNetworkBuffer;
+    uint8_t pucEthernetBuffer[ ipconfigTCP_MSS ];
+    UDPPacket_t * pxUDPPacket;
+    FreeRTOS_Socket_t xSocket;
+
+    memset( &xNetworkBuffer, 0, sizeof( xNetworkBuffer ) );
+    memset( pucEthernetBuffer, 0, sizeof( pucEthernetBuffer ) );
+    memset( &xSocket, 0, sizeof( xSocket ) );
+
+    xNetworkBuffer.pucEthernetBuffer = pucEthernetBuffer;
+    pxUDPPacket = ( UDPPacket_t * ) pucEthernetBuffer;
+
+    pxUDPPacket->xUDPHeader.usChecksum = 0x1234U;
+    pxUDPPacket->xUDPHeader.usSourcePort = FreeRTOS_htons( usSrcPort );
+    pxUDPPacket->xUDPHeader.usDestinationPort = usDestPortNetworkEndian;
+
+    pxUDPSocketLookup_ExpectAndReturn( usDestPortNetworkEndian, &xSocket );
+    xUDPSocketAcceptsPacket_ExpectAndReturn( &xSocket, &xNetworkBuffer, pdFALSE );
+
+    xReturn = xProcessReceivedUDPPacket_IPv4( &xNetworkBuffer, usDestPortNetworkEndian, &xIsWaitingForARPResolution );
+
+    TEST_ASSERT_EQUAL( pdFAIL, xReturn );
+}
+
 /**
  * @brief To validate the flow that socket has NULL endpoint.
  */
@@ -657,6 +692,7 @@ void test_xProcessReceivedUDPPacket_IPv4_SocketNullEndpoint()
     pxUDPPacket->xUDPHeader.usDestinationPort = usDestPortNetworkEndian;
 
     pxUDPSocketLookup_ExpectAndReturn( usDestPortNetworkEndian, &xSocket );
+    xUDPSocketAcceptsPacket_ExpectAndReturn( &xSocket, &xNetworkBuffer, pdTRUE );
 
     xReturn = xProcessReceivedUDPPacket_IPv4( &xNetworkBuffer, usDestPortNetworkEndian, &xIsWaitingForARPResolution );
 
@@ -695,6 +731,7 @@ void test_xProcessReceivedUDPPacket_IPv4_SocketEndPointZeroIP()
     pxUDPPacket->xUDPHeader.usDestinationPort = usDestPortNetworkEndian;
 
     pxUDPSocketLookup_ExpectAndReturn( usDestPortNetworkEndian, &xSocket );
+    xUDPSocketAcceptsPacket_ExpectAndReturn( &xSocket, &xNetworkBuffer, pdTRUE );
 
     xReturn = xProcessReceivedUDPPacket_IPv4( &xNetworkBuffer, usDestPortNetworkEndian, &xIsWaitingForARPResolution );
 
@@ -733,6 +770,7 @@ void test_xProcessReceivedUDPPacket_IPv4_SocketNeedARP()
     pxUDPPacket->xUDPHeader.usDestinationPort = usDestPortNetworkEndian;
 
     pxUDPSocketLookup_ExpectAndReturn( usDestPortNetworkEndian, &xSocket );
+    xUDPSocketAcceptsPacket_ExpectAndReturn( &xSocket, &xNetworkBuffer, pdTRUE );
     xCheckRequiresARPResolution_ExpectAndReturn( &xNetworkBuffer, pdTRUE );
 
     xReturn = xProcessReceivedUDPPacket_IPv4( &xNetworkBuffer, usDestPortNetworkEndian, &xIsWaitingForARPResolution );
@@ -779,6 +817,7 @@ void test_xProcessReceivedUDPPacket_IPv4_SocketRecvHandlerFail()
     xSocket.u.xUDP.pxHandleReceive = xStubUDPReceiveHandler_Fail;
 
     pxUDPSocketLookup_ExpectAndReturn( usDestPortNetworkEndian, &xSocket );
+    xUDPSocketAcceptsPacket_ExpectAndReturn( &xSocket, &xNetworkBuffer, pdTRUE );
     xCheckRequiresARPResolution_ExpectAndReturn( &xNetworkBuffer, pdFALSE );
     vARPRefreshCacheEntryAge_Ignore();
 
@@ -825,6 +864,7 @@ void test_xProcessReceivedUDPPacket_IPv4_UDPListBufferFull()
     xSocket.u.xUDP.pxHandleReceive = xStubUDPReceiveHandler_Pass;
 
     pxUDPSocketLookup_ExpectAndReturn( usDestPortNetworkEndian, &xSocket );
+    xUDPSocketAcceptsPacket_ExpectAndReturn( &xSocket, &xNetworkBuffer, pdTRUE );
     xCheckRequiresARPResolution_ExpectAndReturn( &xNetworkBuffer, pdFALSE );
     vARPRefreshCacheEntryAge_Ignore();
 
@@ -877,6 +917,7 @@ void test_xProcessReceivedUDPPacket_IPv4_Pass()
     xSocket.u.xUDP.pxHandleReceive = NULL;
 
     pxUDPSocketLookup_ExpectAndReturn( usDestPortNetworkEndian, &xSocket );
+    xUDPSocketAcceptsPacket_ExpectAndReturn( &xSocket, &xNetworkBuffer, pdTRUE );
     xCheckRequiresARPResolution_ExpectAndReturn( &xNetworkBuffer, pdFALSE );
     vARPRefreshCacheEntryAge_Ignore();
 
@@ -948,6 +989,7 @@ void test_xProcessReceivedUDPPacket_IPv4_PassNoEventGroup()
     xSocket.xEventGroup = NULL;
 
     pxUDPSocketLookup_ExpectAndReturn( usDestPortNetworkEndian, &xSocket );
+    xUDPSocketAcceptsPacket_ExpectAndReturn( &xSocket, &xNetworkBuffer, pdTRUE );
     xCheckRequiresARPResolution_ExpectAndReturn( &xNetworkBuffer, pdFALSE );
     vARPRefreshCacheEntryAge_Ignore();
 
@@ -1016,6 +1058,7 @@ void test_xProcessReceivedUDPPacket_IPv4_PassNoSelectBit()
     xSocket.xEventGroup = xEventGroup;
 
     pxUDPSocketLookup_ExpectAndReturn( usDestPortNetworkEndian, &xSocket );
+    xUDPSocketAcceptsPacket_ExpectAndReturn( &xSocket, &xNetworkBuffer, pdTRUE );
     xCheckRequiresARPResolution_ExpectAndReturn( &xNetworkBuffer, pdFALSE );
     vARPRefreshCacheEntryAge_Ignore();
 
@@ -1084,6 +1127,7 @@ void test_xProcessReceivedUDPPacket_IPv4_PassNoSelectSet()
     xSocket.xEventGroup = xEventGroup;
 
     pxUDPSocketLookup_ExpectAndReturn( usDestPortNetworkEndian, &xSocket );
+    xUDPSocketAcceptsPacket_ExpectAndReturn( &xSocket, &xNetworkBuffer, pdTRUE );
     xCheckRequiresARPResolution_ExpectAndReturn( &xNetworkBuffer, pdFALSE );
     vARPRefreshCacheEntryAge_Ignore();
 
@@ -1150,6 +1194,7 @@ void test_xProcessReceivedUDPPacket_IPv4_PassNoSem()
     xSocket.xEventGroup = xEventGroup;
 
     pxUDPSocketLookup_ExpectAndReturn( usDestPortNetworkEndian, &xSocket );
+    xUDPSocketAcceptsPacket_ExpectAndReturn( &xSocket, &xNetworkBuffer, pdTRUE );
     xCheckRequiresARPResolution_ExpectAndReturn( &xNetworkBuffer, pdFALSE );
     vARPRefreshCacheEntryAge_Ignore();
 
@@ -1217,6 +1262,7 @@ void test_xProcessReceivedUDPPacket_IPv4_PassNoDHCP()
     xSocket.xEventGroup = xEventGroup;
 
     pxUDPSocketLookup_ExpectAndReturn( usDestPortNetworkEndian, &xSocket );
+    xUDPSocketAcceptsPacket_ExpectAndReturn( &xSocket, &xNetworkBuffer, pdTRUE );
     xCheckRequiresARPResolution_ExpectAndReturn( &xNetworkBuffer, pdFALSE );
     vARPRefreshCacheEntryAge_Ignore();
 
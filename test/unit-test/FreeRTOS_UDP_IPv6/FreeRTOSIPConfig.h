@@ -336,4 +336,7 @@
 #define ipconfigIP_PASS_PACKETS_WITH_IP_OPTIONS    ( 0 )
 #define ipconfigZERO_COPY_TX_DRIVER                ( 1 )
 
+/* A connected UDP socket only accepts packets from its peer. */
+#define ipconfigUDP_CONNECTED_SOCKETS              ( 1 )
+
 #endif /* FREERTOS_IP_CONFIG_H */
@@ -73,6 +73,9 @@ TickType_t listGET_ITEM_VALUE_OF_HEAD_ENTRY( List_t * list );
 void * listGET_LIST_ITEM_OWNER( const ListItem_t * listItem );
 
 FreeRTOS_Socket_t * pxUDPSocketLookup( UBaseType_t uxLocalPort );
+
+BaseType_t xUDPSocketAcceptsPacket( const FreeRTOS_Socket_t * pxSocket,
+                                    const NetworkBufferDescriptor_t * pxNetworkBuffer );
 size_t uxIPHeaderSizePacket( const NetworkBufferDescriptor_t * pxNetworkBuffer );
 uint16_t usGenerateProtocolChecksum( uint8_t * pucEthernetBuffer,
                                      size_t uxBufferLength,
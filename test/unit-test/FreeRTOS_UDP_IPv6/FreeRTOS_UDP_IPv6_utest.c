@@ -477,6 +477,41 @@ void test_xProcessReceivedUDPPacket_IPv6_NoSocket()
     TEST_ASSERT_EQUAL( pdFAIL, xReturn );
 }
 
+/**
+ * @brief To validate that a socket which is connected to another peer is treated
+ *        as if no one is waiting for the packet.
+ */
+void test_xProcessReceivedUDPPacket_IPv6_SocketConnectedOtherPeer()
+{
+    BaseType_t xReturn;
+    uint16_t usSrcPort = 2048U;
+    uint16_t usDestPort = 1024U;
+    uint16_t usDestPortNetworkEndian = FreeRTOS_htons( usDestPort );
+    BaseType_t xIsWaitingForARPResolution;
+    NetworkBufferDescriptor_t xNetworkBuffer;
+    uint8_t pucEthernetBuffer[ ipconfigTCP_MSS ];
+    UDPPacket_IPv6_t * pxUDPv6Packet;
+    FreeRTOS_Socket_t xSocket;
+
+    memset( &xNetworkBuffer, 0, sizeof( xNetworkBuffer ) );
+    memset( pucEthernetBuffer, 0, sizeof( pucEthernetBuffer ) );
+    memset( &xSocket, 0, sizeof( xSocket ) );
+
+    xNetworkBuffer.pucEthernetBuffer = pucEthernetBuffer;
+    pxUDPv6Packet = ( UDPPacket_IPv6_t * ) pucEthernetBuffer;
+
+    pxUDPv6Packet->xUDPHeader.usChecksum = 0x1234U;
+    pxUDPv6Packet->xUDPHeader.usSourcePort = FreeRTOS_htons( usSrcPort );
+    pxUDPv6Packet->xUDPHeader.usDestinationPort = usDestPortNetworkEndian;
+
+    pxUDPSocketLookup_ExpectAndReturn( usDestPortNetworkEndian, &xSocket );
+    xUDPSocketAcceptsPacket_ExpectAndReturn( &xSocket, &xNetworkBuffer, pdFALSE );
+
+    xReturn = xProcessReceivedUDPPacket_IPv6( &xNetworkBuffer, usDestPortNetworkEndian, &xIsWaitingForARPResolution );
+
+    TEST_ASSERT_EQUAL( pdFAIL, xReturn );
+}
+
 /**
  * @brief To validate the flow that socket needs neighbor discovery.
  */
@@ -504,6 +539,7 @@ void test_xProcessReceivedUDPPacket_IPv6_SocketNeedND()
     pxUDPv6Packet->xUDPHeader.usDestinationPort = usDestPortNetworkEndian;
 
     pxUDPSocketLookup_ExpectAndReturn( usDestPortNetworkEndian, &xSocket );
+    xUDPSocketAcceptsPacket_ExpectAndReturn( &xSocket, &xNetworkBuffer, pdTRUE );
     xCheckRequiresNDResolution_ExpectAndReturn( &xNetworkBuffer, pdTRUE );
 
     xReturn = xProcessReceivedUDPPacket_IPv6( &xNetworkBuffer, usDestPortNetworkEndian, &xIsWaitingForARPResolution );
@@ -545,6 +581,7 @@ void test_xProcessReceivedUDPPacket_IPv6_SocketRecvHandlerFail()
     xSocket.u.xUDP.pxHandleReceive = xStubUDPReceiveHandler_Fail;
 
     pxUDPSocketLookup_ExpectAndReturn( usDestPortNetworkEndian, &xSocket );
+    xUDPSocketAcceptsPacket_ExpectAndReturn( &xSocket, &xNetworkBuffer, pdTRUE );
     xCheckRequiresNDResolution_ExpectAndReturn( &xNetworkBuffer, pdFALSE );
     vNDRefreshCacheEntry_Ignore();
     uxIPHeaderSizePacket_ExpectAndReturn( &xNetworkBuffer, ipSIZE_OF_IPv6_HEADER );
@@ -587,6 +624,7 @@ void test_xProcessReceivedUDPPacket_IPv6_UDPListBufferFull()
     xSocket.u.xUDP.pxHandleReceive = xStubUDPReceiveHandler_Pass;
 
     pxUDPSocketLookup_ExpectAndReturn( usDestPortNetworkEndian, &xSocket );
+    xUDPSocketAcceptsPacket_ExpectAndReturn( &xSocket, &xNetworkBuffer, pdTRUE );
     xCheckRequiresNDResolution_ExpectAndReturn( &xNetworkBuffer, pdFALSE );
     vNDRefreshCacheEntry_Ignore();
     uxIPHeaderSizePacket_ExpectAndReturn( &xNetworkBuffer, ipSIZE_OF_IPv6_HEADER );
@@ -635,6 +673,7 @@ void test_xProcessReceivedUDPPacket_IPv6_Pass()
     xSocket.u.xUDP.pxHandleReceive = NULL;
 
     pxUDPSocketLookup_ExpectAndReturn( usDestPortNetworkEndian, &xSocket );
+    xUDPSocketAcceptsPacket_ExpectAndReturn( &xSocket, &xNetworkBuffer, pdTRUE );
     xCheckRequiresNDResolution_ExpectAndReturn( &xNetworkBuffer, pdFALSE );
     vNDRefreshCacheEntry_Ignore();
     uxIPHeaderSizePacket_ExpectAndReturn( &xNetworkBuffer, ipSIZE_OF_IPv6_HEADER );
@@ -702,6 +741,7 @@ void test_xProcessReceivedUDPPacket_IPv6_PassNoEventGroup()
     xSocket.xEventGroup = NULL;
 
     pxUDPSocketLookup_ExpectAndReturn( usDestPortNetworkEndian, &xSocket );
+    xUDPSocketAcceptsPacket_ExpectAndReturn( &xSocket, &xNetworkBuffer, pdTRUE );
     xCheckRequiresNDResolution_ExpectAndReturn( &xNetworkBuffer, pdFALSE );
     vNDRefreshCacheEntry_Ignore();
     uxIPHeaderSizePacket_ExpectAndReturn( &xNetworkBuffer, ipSIZE_OF_IPv6_HEADER );
@@ -767,6 +807,7 @@ void test_xProcessReceivedUDPPacket_IPv6_PassNoSelectBit()
     xSocket.xEventGroup = xEventGroup;
 
     pxUDPSocketLookup_ExpectAndReturn( usDestPortNetworkEndian, &xSocket );
+    xUDPSocketAcceptsPacket_ExpectAndReturn( &xSocket, &xNetworkBuffer, pdTRUE );
     xCheckRequiresNDResolution_ExpectAndReturn( &xNetworkBuffer, pdFALSE );
     vNDRefreshCacheEntry_Ignore();
     uxIPHeaderSizePacket_ExpectAndReturn( &xNetworkBuffer, ipSIZE_OF_IPv6_HEADER );
@@ -831,6 +872,7 @@ void test_xProcessReceivedUDPPacket_IPv6_PassNoSelectSet()
     xSocket.xEventGroup = xEventGroup;
 
     pxUDPSocketLookup_ExpectAndReturn( usDestPortNetworkEndian, &xSocket );
+    xUDPSocketAcceptsPacket_ExpectAndReturn( &xSocket, &xNetworkBuffer, pdTRUE );
     xCheckRequiresNDResolution_ExpectAndReturn( &xNetworkBuffer, pdFALSE );
     vNDRefreshCacheEntry_Ignore();
     uxIPHeaderSizePacket_ExpectAndReturn( &xNetworkBuffer, ipSIZE_OF_IPv6_HEADER );
@@ -893,6 +935,7 @@ void test_xProcessReceivedUDPPacket_IPv6_PassNoSem()
     xSocket.xEventGroup = xEventGroup;
 
     pxUDPSocketLookup_ExpectAndReturn( usDestPortNetworkEndian, &xSocket );
+    xUDPSocketAcceptsPacket_ExpectAndReturn( &xSocket, &xNetworkBuffer, pdTRUE );
     xCheckRequiresNDResolution_ExpectAndReturn( &xNetworkBuffer, pdFALSE );
     vNDRefreshCacheEntry_Ignore();
     uxIPHeaderSizePacket_ExpectAndReturn( &xNetworkBuffer, ipSIZE_OF_IPv6_HEADER );
@@ -956,6 +999,7 @@ void test_xProcessReceivedUDPPacket_IPv6_PassNoDHCP()
     xSocket.xEventGroup = xEventGroup;
 
     pxUDPSocketLookup_ExpectAndReturn( usDestPortNetworkEndian, &xSocket );
+    xUDPSocketAcceptsPacket_ExpectAndReturn( &xSocket, &xNetworkBuffer, pdTRUE );
     xCheckRequiresNDResolution_ExpectAndReturn( &xNetworkBuffer, pdFALSE );
     vNDRefreshCacheEntry_Ignore();
     uxIPHeaderSizePacket_ExpectAndReturn( &xNetworkBuffer, ipSIZE_OF_IPv6_HEADER );
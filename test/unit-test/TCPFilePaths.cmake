@@ -13,8 +13,11 @@ set( TCP_SOURCES
      "${CMAKE_CURRENT_LIST_DIR}/../../source/FreeRTOS_DNS_Callback.c"
      "${CMAKE_CURRENT_LIST_DIR}/../../source/FreeRTOS_DNS_Networking.c"
      "${CMAKE_CURRENT_LIST_DIR}/../../source/FreeRTOS_DNS_Parser.c"
+     "${CMAKE_CURRENT_LIST_DIR}/../../source/FreeRTOS_Drop.c"
      "${CMAKE_CURRENT_LIST_DIR}/../../source/FreeRTOS_ICMP.c"
+     "${CMAKE_CURRENT_LIST_DIR}/../../source/FreeRTOS_IGMP.c"
      "${CMAKE_CURRENT_LIST_DIR}/../../source/FreeRTOS_IP.c"
+     "${CMAKE_CURRENT_LIST_DIR}/../../source/FreeRTOS_IP_Profiling.c"
      "${CMAKE_CURRENT_LIST_DIR}/../../source/FreeRTOS_IP_Timers.c"
      "${CMAKE_CURRENT_LIST_DIR}/../../source/FreeRTOS_IP_Utils.c"
      "${CMAKE_CURRENT_LIST_DIR}/../../source/FreeRTOS_IPv4.c"
@@ -23,6 +26,7 @@ set( TCP_SOURCES
      "${CMAKE_CURRENT_LIST_DIR}/../../source/FreeRTOS_IPv6.c"
      "${CMAKE_CURRENT_LIST_DIR}/../../source/FreeRTOS_IPv6_Sockets.c"
      "${CMAKE_CURRENT_LIST_DIR}/../../source/FreeRTOS_IPv6_Utils.c"
+     "${CMAKE_CURRENT_LIST_DIR}/../../source/FreeRTOS_MIB.c"
      "${CMAKE_CURRENT_LIST_DIR}/../../source/FreeRTOS_ND.c"
      "${CMAKE_CURRENT_LIST_DIR}/../../source/FreeRTOS_RA.c"
      "${CMAKE_CURRENT_LIST_DIR}/../../source/FreeRTOS_Routing.c"
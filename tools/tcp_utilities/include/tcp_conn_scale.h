@@ -0,0 +1,106 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/*
+ * tcp_conn_scale.h
+ * A server that accepts many concurrent TCP connections and reports the
+ * connection rate, the memory used per connection and the load of the
+ * IP-task, while a host opens and closes connections with tcp_conn_scale.py.
+ * See tools/tcp_utilities/tcp_conn_scale.md for further description.
+ */
+
+#ifndef TCP_CONN_SCALE_H
+
+    #define TCP_CONN_SCALE_H
+
+    #include <stdint.h>
+
+    #ifdef __cplusplus
+    extern "C" {
+    #endif
+
+/* The port number of the server. */
+    #ifndef connscaleDEFAULT_PORT
+        #define connscaleDEFAULT_PORT    5203U
+    #endif
+
+/* The maximum number of connections that are open at the same time. A
+ * connection beyond this number is closed as soon as it is accepted. */
+    #ifndef connscaleMAX_CONNECTIONS
+        #define connscaleMAX_CONNECTIONS    256U
+    #endif
+
+/* When not zero, the size of the stream buffers of every connection. Smaller
+ * buffers allow for more connections. */
+    #ifndef connscaleSTREAM_BUFFER_SIZE
+        #define connscaleSTREAM_BUFFER_SIZE    0U
+    #endif
+
+/* The time that the echo of a connection waits for space in its transmit
+ * buffer. A connection that does not get its data out in time is closed. */
+    #ifndef connscaleSEND_TIMEOUT_MS
+        #define connscaleSEND_TIMEOUT_MS    1000U
+    #endif
+
+/* The interval between two reports. */
+    #ifndef connscaleREPORT_INTERVAL_MS
+        #define connscaleREPORT_INTERVAL_MS    1000U
+    #endif
+
+/* The statistics of the server. */
+    typedef struct xCONN_SCALE_STATS
+    {
+        uint32_t ulOpen;                         /* The number of open connections. */
+        uint32_t ulPeakOpen;                     /* The highest number of open connections. */
+        uint32_t ulAccepted;                     /* The number of connections accepted since the start. */
+        uint32_t ulClosed;                       /* The number of connections closed since the start. */
+        uint32_t ulRefused;                      /* Connections closed at once, because the table was full. */
+        uint32_t ulAcceptRate;                   /* Unit: connections per second, during the last interval. */
+        uint32_t ulBytesPerConnection;           /* Unit: bytes. The heap used per open connection, 0 when unknown. */
+        uint32_t ulIPTaskPermille;               /* The CPU load of the IP-task during the last interval, 0 when unknown. */
+        UBaseType_t uxMinimumFreeNetworkBuffers; /* The lowest number of free network buffers seen. */
+    } ConnScaleStats_t;
+
+/*
+ * Start a task that accepts connections on a port, echoes all data, and
+ * closes a connection when the peer closes it.
+ */
+    BaseType_t xConnScaleStartServer( uint16_t usPort,
+                                      uint16_t usStackSize,
+                                      UBaseType_t uxPriority );
+
+/*
+ * Get the statistics as they were at the last report.
+ */
+    void vConnScaleGetStats( ConnScaleStats_t * pxStats );
+
+    #ifdef __cplusplus
+}         /* extern "C" */
+    #endif
+
+#endif /* TCP_CONN_SCALE_H */
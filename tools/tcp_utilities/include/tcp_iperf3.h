@@ -0,0 +1,108 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * tcp_iperf3.h
+ * A throughput benchmark that speaks the protocol of iperf3, so that it can
+ * be used against a host running "iperf3 -s" or "iperf3 -c".
+ * See tools/tcp_utilities/tcp_iperf3.md for further description.
+ */
+
+#ifndef TCP_IPERF3_H
+
+    #define TCP_IPERF3_H
+
+    #include <stdint.h>
+
+    #ifdef __cplusplus
+    extern "C" {
+    #endif
+
+/* The port number used by iperf3 for both the control and the data connections. */
+    #ifndef iperf3DEFAULT_PORT
+        #define iperf3DEFAULT_PORT    5201U
+    #endif
+
+/* The buffer used for sending and receiving data. It also limits the block
+ * size of a TCP test. */
+    #ifndef iperf3BUFFER_SIZE
+        #define iperf3BUFFER_SIZE    8192U
+    #endif
+
+/* The settings of a test. */
+    typedef struct xIPERF3_SETTINGS
+    {
+        BaseType_t xUDP;      /* pdTRUE for a UDP test, pdFALSE for TCP. */
+        BaseType_t xReverse;  /* pdTRUE when the server sends and the client receives. */
+        uint32_t ulDuration;  /* Unit: seconds. The duration of the test. */
+        uint32_t ulBlockSize; /* Unit: bytes. The size of each send, and of each UDP datagram. */
+        uint32_t ulBandwidth; /* Unit: bits per second. The UDP sending rate, 0 for 1 Mbit/s. */
+    } IPerf3Settings_t;
+
+/* The results of a test, as seen from this side. */
+    typedef struct xIPERF3_RESULT
+    {
+        BaseType_t xSender;      /* pdTRUE when this side sent the data. */
+        BaseType_t xUDP;         /* pdTRUE for a UDP test. */
+        uint64_t ullBytes;       /* The number of data bytes sent or received. */
+        uint64_t ullDurationUs;  /* Unit: microseconds. The duration of the data transfer. */
+        uint64_t ullPeerBytes;   /* The number of bytes reported by the peer. */
+        uint32_t ulRetransmits;  /* TCP segments retransmitted by this side, needs ipconfigTCP_INFO. */
+        uint32_t ulPackets;      /* UDP datagrams sent or received. */
+        uint32_t ulLost;         /* UDP datagrams lost, as seen by the receiver. */
+        uint32_t ulJitterUs;     /* Unit: microseconds. The UDP jitter, as seen by the receiver. */
+        uint32_t ulCPUPermille;  /* The CPU load during the test, 0 when not measured. */
+    } IPerf3Result_t;
+
+    struct freertos_sockaddr;
+
+/*
+ * Start a task that serves one test at a time, like "iperf3 -s". Test it
+ * from a host with e.g. "iperf3 -c <address>", "-R" to reverse, "-u" for UDP.
+ */
+    BaseType_t xIPerf3StartServer( uint16_t usPort,
+                                   uint16_t usStackSize,
+                                   UBaseType_t uxPriority );
+
+/*
+ * Run a test against a host running "iperf3 -s". The function blocks for
+ * the duration of the test. Not to be called from the IP-task.
+ */
+    BaseType_t xIPerf3RunClient( const struct freertos_sockaddr * pxServer,
+                                 const IPerf3Settings_t * pxSettings,
+                                 IPerf3Result_t * pxResult );
+
+/*
+ * Print a summary of a test with FreeRTOS_printf().
+ */
+    void vIPerf3PrintResult( const IPerf3Result_t * pxResult );
+
+    #ifdef __cplusplus
+}         /* extern "C" */
+    #endif
+
+#endif /* TCP_IPERF3_H */
@@ -0,0 +1,162 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/*
+ * tcp_latency.h
+ * A request/response benchmark that measures the round-trip time of TCP or
+ * UDP messages, and reports percentiles. With the help of the trace macros
+ * the time is broken down into driver, IP-task and application.
+ * See tools/tcp_utilities/tcp_latency.md for further description.
+ */
+
+#ifndef TCP_LATENCY_H
+
+    #define TCP_LATENCY_H
+
+    #include <stdint.h>
+
+    #ifdef __cplusplus
+    extern "C" {
+    #endif
+
+/* The port used by the reflector for both TCP and UDP, the echo port. */
+    #ifndef latencyDEFAULT_PORT
+        #define latencyDEFAULT_PORT    7U
+    #endif
+
+/* The largest message, it fits in a single Ethernet frame. */
+    #ifndef latencyBUFFER_SIZE
+        #define latencyBUFFER_SIZE    1400U
+    #endif
+
+/* Define as 1 in FreeRTOSIPConfig.h, before including this header, to let
+ * the trace macros time the phases of a round trip. */
+    #ifndef latencyUSE_TRACE_HOOKS
+        #define latencyUSE_TRACE_HOOKS    0
+    #endif
+
+/* The phases of a round trip, as seen by the client. */
+    typedef enum eLATENCY_PHASE
+    {
+        eLatencyStackTx = 0, /* From the call to send() until the IP-task passes the frame to the driver. */
+        eLatencyNetwork,     /* From the driver output until the driver receives the reply: wire and peer. */
+        eLatencyDriverRx,    /* From the driver receiving the reply until the IP-task takes the event. */
+        eLatencyStackRx,     /* The IP-task processing the reply. */
+        eLatencyApplication, /* From the IP-task until recv() returns in the application. */
+        eLatencyPhaseCount
+    } eLatencyPhase_t;
+
+/* The settings of a test. */
+    typedef struct xLATENCY_SETTINGS
+    {
+        BaseType_t xUDP;        /* pdTRUE for UDP messages, pdFALSE for TCP. */
+        uint32_t ulMessageSize; /* Unit: bytes. The size of a request and of its reply, at least 4. */
+        uint32_t ulRate;        /* Unit: messages per second. 0 means: send the next request as soon as the reply is in. */
+        uint32_t ulCount;       /* The number of round trips. */
+        uint32_t ulTimeoutMs;   /* Unit: milliseconds. A UDP request without a reply within this time is lost. */
+    } LatencySettings_t;
+
+/* A summary of a series of measurements, all in microseconds. The percentiles
+ * have a resolution of 1/16th, the minimum, maximum and mean are exact. */
+    typedef struct xLATENCY_STATS
+    {
+        uint32_t ulCount;
+        uint32_t ulMin;
+        uint32_t ulMean;
+        uint32_t ulP50;
+        uint32_t ulP99;
+        uint32_t ulP999;
+        uint32_t ulMax;
+    } LatencyStats_t;
+
+/* The results of a test. */
+    typedef struct xLATENCY_RESULT
+    {
+        BaseType_t xUDP;                                /* pdTRUE for a UDP test. */
+        uint32_t ulMessageSize;                         /* Unit: bytes. */
+        uint32_t ulSent;                                /* The number of requests sent. */
+        uint32_t ulLost;                                /* The number of requests without a reply. */
+        LatencyStats_t xRoundTrip;                      /* The round-trip times. */
+        LatencyStats_t xPhases[ eLatencyPhaseCount ];   /* Only filled when latencyUSE_TRACE_HOOKS is 1. */
+    } LatencyResult_t;
+
+    struct freertos_sockaddr;
+
+/*
+ * Start two tasks that echo TCP and UDP messages on a port, to serve as the
+ * peer of xLatencyRunClient() on another instance.
+ */
+    BaseType_t xLatencyStartReflector( uint16_t usPort,
+                                       uint16_t usStackSize,
+                                       UBaseType_t uxPriority );
+
+/*
+ * Send requests to an echo server and measure the time until each reply.
+ * The function blocks until the test is done. Only one test can run at
+ * a time. Not to be called from the IP-task.
+ */
+    BaseType_t xLatencyRunClient( const struct freertos_sockaddr * pxPeer,
+                                  const LatencySettings_t * pxSettings,
+                                  LatencyResult_t * pxResult );
+
+/*
+ * Print the results of a test with FreeRTOS_printf().
+ */
+    void vLatencyPrintResult( const LatencyResult_t * pxResult );
+
+    #if ( latencyUSE_TRACE_HOOKS == 1 )
+
+/* The functions that receive the time points. A project that defines these
+ * trace macros itself, can call the functions from its own definitions. */
+        void vLatencyTraceOutput( void );
+        void vLatencyTraceDriverReceive( void );
+        void vLatencyTraceEventReceived( BaseType_t xEvent );
+        void vLatencyTraceEventProcessed( BaseType_t xEvent );
+
+        #ifndef iptraceNETWORK_INTERFACE_OUTPUT
+            #define iptraceNETWORK_INTERFACE_OUTPUT( uxDataLength, pucEthernetBuffer )    vLatencyTraceOutput()
+        #endif
+
+        #ifndef iptraceNETWORK_INTERFACE_RECEIVE
+            #define iptraceNETWORK_INTERFACE_RECEIVE()    vLatencyTraceDriverReceive()
+        #endif
+
+        #ifndef iptraceNETWORK_EVENT_RECEIVED
+            #define iptraceNETWORK_EVENT_RECEIVED( eEvent )    vLatencyTraceEventReceived( ( BaseType_t ) ( eEvent ) )
+        #endif
+
+        #ifndef iptraceNETWORK_EVENT_PROCESSED
+            #define iptraceNETWORK_EVENT_PROCESSED( eEvent )    vLatencyTraceEventProcessed( ( BaseType_t ) ( eEvent ) )
+        #endif
+    #endif /* ( latencyUSE_TRACE_HOOKS == 1 ) */
+
+    #ifdef __cplusplus
+}         /* extern "C" */
+    #endif
+
+#endif /* TCP_LATENCY_H */
@@ -0,0 +1,127 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * tcp_pcapng.h
+ * Streams the frames of the iptraceDUMP_PACKET() macro as pcapng, for
+ * inspection in Wireshark.
+ * See tools/tcp_utilities/tcp_pcapng.md for further description.
+ * This header is included from FreeRTOSIPConfig.h, after defining
+ * ipconfigUSE_PCAPNG_CAPTURE.
+ */
+
+#ifndef TCP_PCAPNG_H
+
+    #define TCP_PCAPNG_H
+
+    #include <stddef.h>
+    #include <stdint.h>
+
+    #ifdef __cplusplus
+    extern "C" {
+    #endif
+
+/* The number of bytes of the buffer between the capturing tasks and the writer
+ * thread. When it is full, frames are dropped and counted. */
+    #ifndef pcapngBUFFER_SIZE
+        #define pcapngBUFFER_SIZE    ( 256U * 1024U )
+    #endif
+
+/* Filter flags for PcapngConfig_t::ulFilter. A value of 0 captures everything.
+ * When any direction flag is set, only those directions are captured. When any
+ * frame-type flag is set, only those frame types are captured. */
+    #define pcapngFILTER_INCOMING    0x00000001UL
+    #define pcapngFILTER_OUTGOING    0x00000002UL
+    #define pcapngFILTER_ARP         0x00000100UL
+    #define pcapngFILTER_IPv4        0x00000200UL
+    #define pcapngFILTER_IPv6        0x00000400UL
+    #define pcapngFILTER_OTHER       0x00000800UL
+
+    #define pcapngFILTER_DIRECTIONS \
+    ( pcapngFILTER_INCOMING | pcapngFILTER_OUTGOING )
+    #define pcapngFILTER_FRAME_TYPES \
+    ( pcapngFILTER_ARP | pcapngFILTER_IPv4 | pcapngFILTER_IPv6 | pcapngFILTER_OTHER )
+
+/* An optional filter that is called for every frame that passed ulFilter.
+ * It is called from the task that captures the frame, so it must be short.
+ * Return pdTRUE to capture the frame. */
+    typedef BaseType_t ( * PcapngFilterFunction_t )( const uint8_t * pucBuffer,
+                                                     size_t uxLength,
+                                                     BaseType_t xIncoming );
+
+/* The settings of a capture. */
+    typedef struct xPCAPNG_CONFIG
+    {
+        const char * pcFileName;          /* A file name, a named pipe, or "-" for stdout. */
+        size_t uxMaxFileSize;             /* Start a new file when this size is reached, 0 for one file. */
+        size_t uxFileCount;               /* The number of files in the ring, the oldest file is overwritten. */
+        size_t uxSnapLength;              /* The maximum number of bytes stored per frame, 0 for all. */
+        uint32_t ulFilter;                /* A combination of the pcapngFILTER_ flags. */
+        PcapngFilterFunction_t fnFilter;  /* An optional filter, or NULL. */
+    } PcapngConfig_t;
+
+/* The statistics of the current capture. */
+    typedef struct xPCAPNG_STATS
+    {
+        uint32_t ulCaptured;    /* Frames that were passed to the writer thread. */
+        uint32_t ulFiltered;    /* Frames that were rejected by a filter. */
+        uint32_t ulDropped;     /* Frames that were dropped because the buffer was full. */
+        uint32_t ulWritten;     /* Frames that were written. */
+        uint32_t ulWriteErrors; /* Failures to open or to write a file. */
+        uint32_t ulFiles;       /* The number of files that were opened. */
+    } PcapngStats_t;
+
+    #if ( ipconfigUSE_PCAPNG_CAPTURE != 0 )
+
+        #if ( ipconfigUSE_DUMP_PACKETS != 0 )
+            #error ipconfigUSE_PCAPNG_CAPTURE and ipconfigUSE_DUMP_PACKETS both use iptraceDUMP_PACKET
+        #endif
+
+/* Start a capture and its writer thread. Only one capture can be active. */
+        BaseType_t xPcapngStart( const PcapngConfig_t * pxConfig );
+
+/* Stop the capture: the frames still buffered are written and the file is closed. */
+        void vPcapngStop( void );
+
+/* Queue a frame for the writer thread. Called through iptraceDUMP_PACKET(). */
+        void vPcapngCapture( const uint8_t * pucBuffer,
+                             size_t uxLength,
+                             BaseType_t xIncoming );
+
+/* Get the statistics of the current, or the last capture. */
+        void vPcapngGetStats( PcapngStats_t * pxStats );
+
+        #define iptraceDUMP_PACKET( pucBuffer, uxLength, xIncoming ) \
+    vPcapngCapture( ( pucBuffer ), ( uxLength ), ( BaseType_t ) ( xIncoming ) )
+
+    #endif /* ( ipconfigUSE_PCAPNG_CAPTURE != 0 ) */
+
+    #ifdef __cplusplus
+}         /* extern "C" */
+    #endif
+
+#endif /* TCP_PCAPNG_H */
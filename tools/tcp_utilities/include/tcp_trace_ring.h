@@ -0,0 +1,289 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * tcp_trace_ring.h
+ * A binary trace ring for the iptrace macros.
+ * See tools/tcp_utilities/tcp_trace_ring.md for further description.
+ * This header is included from FreeRTOSIPConfig.h, after defining
+ * ipconfigUSE_TRACE_RING.
+ */
+
+#ifndef TCP_TRACE_RING_H
+
+    #define TCP_TRACE_RING_H
+
+    #include <stddef.h>
+    #include <stdint.h>
+
+    #ifdef __cplusplus
+    extern "C" {
+    #endif
+
+/* The event ID's of the trace records. The host-side decoder
+ * 'tcp_trace_decode.py' uses the same numbering. Do not change the values of
+ * existing entries, add new ones at the end. */
+    typedef enum xTRACE_RING_EVENT
+    {
+        eTraceNone = 0,
+        eTraceNetworkEventReceived,       /* 1: IP-task received an event, p1 = eIPEvent_t. */
+        eTraceNetworkInterfaceInput,      /* 2: IP-task starts processing a frame, p1 = length, p2 = frame type. */
+        eTraceNetworkInterfaceOutput,     /* 3: A frame is passed to the driver, p1 = length, p2 = frame type. */
+        eTraceNetworkInterfaceReceive,    /* 4: The driver received a frame. */
+        eTraceNetworkInterfaceTransmit,   /* 5: The driver transmitted a frame. */
+        eTraceNetworkBufferObtained,      /* 6: p1 = descriptor address. */
+        eTraceNetworkBufferObtainedISR,   /* 7: p1 = descriptor address. */
+        eTraceNetworkBufferReleased,      /* 8: p1 = descriptor address. */
+        eTraceNetworkBufferFailed,        /* 9: No network buffer available. */
+        eTraceNetworkBufferFailedISR,     /* 10: No network buffer available in an ISR. */
+        eTraceStackTxEventLost,           /* 11: The event queue was full, p1 = eIPEvent_t. */
+        eTraceEthernetRxEventLost,        /* 12: The driver could not pass a frame to the IP-task. */
+        eTraceWaitingForTxDMADescriptor,  /* 13: The driver waits for a free DMA descriptor. */
+        eTraceSendingUDPPacket,           /* 14: p1 = IPv4 address, network order. */
+        eTraceNoBufferForSendto,          /* 15: FreeRTOS_sendto() could not get a buffer. */
+        eTraceRecvfromTimeout,            /* 16: FreeRTOS_recvfrom() timed out. */
+        eTraceARPPacketReceived,          /* 17: An ARP packet was received. */
+        eTraceCreatingARPRequest,         /* 18: p1 = IPv4 address, network order. */
+        eTracePacketDroppedToGenerateARP, /* 19: p1 = IPv4 address, network order. */
+        eTraceDelayedARPBufferFull,       /* 20: A packet was dropped while waiting for ARP. */
+        eTraceDelayedARPRequestStarted,   /* 21: A packet is held while waiting for ARP. */
+        eTraceDelayedARPTimerExpired,     /* 22: The held packet is released. */
+        eTraceDelayedNDBufferFull,        /* 23: A packet was dropped while waiting for ND. */
+        eTraceDelayedNDRequestStarted,    /* 24: A packet is held while waiting for ND. */
+        eTraceDelayedNDTimerExpired,      /* 25: The held packet is released. */
+        eTraceICMPPacketReceived,         /* 26: An ICMP packet was received. */
+        eTraceSendingPingReply,           /* 27: p1 = IPv4 address, network order. */
+        eTraceNetworkDown,                /* 28: The network went down. */
+        eTraceUser = 0x8000               /* The first ID that the application may use. */
+    } TraceRingEvent_t;
+
+/* One trace record. Records are stored and dumped in the byte order of the target. */
+    typedef struct xTRACE_RING_RECORD
+    {
+        uint32_t ulTimeStamp;  /* See traceRING_TIMESTAMP(). */
+        uint16_t usEventID;    /* A TraceRingEvent_t. */
+        uint16_t usSequence;   /* The lower 16 bits of the record number, to detect gaps. */
+        uint32_t ulParameter1; /* Depends on the event. */
+        uint32_t ulParameter2; /* Depends on the event. */
+    } TraceRingRecord_t;
+
+/* Every block of records that is dumped starts with this header. */
+    typedef struct xTRACE_RING_HEADER
+    {
+        uint32_t ulMagic;       /* traceRING_MAGIC, also tells the byte order. */
+        uint16_t usVersion;     /* traceRING_VERSION. */
+        uint16_t usRecordSize;  /* sizeof( TraceRingRecord_t ). */
+        uint32_t ulTimeStampHz; /* The frequency of the time stamps. */
+        uint32_t ulRecordCount; /* The number of records that follow. */
+        uint32_t ulLostCount;   /* Records overwritten before they could be read. */
+    } TraceRingHeader_t;
+
+    #define traceRING_MAGIC      0x54524331UL /* "TRC1" */
+    #define traceRING_VERSION    1U
+
+    struct freertos_sockaddr;
+
+    #if ( ipconfigUSE_TRACE_RING != 0 )
+
+/* Add a record to the ring. May be called from tasks and from interrupts. */
+        void vTraceRingRecord( uint16_t usEventID,
+                               uint32_t ulParameter1,
+                               uint32_t ulParameter2 );
+
+/* Move at most uxMaxCount records, the oldest first, from the ring to pxRecords.
+ * pxHeader will be filled in for the records copied. Only one task at a time
+ * should read the ring. */
+        size_t uxTraceRingRead( TraceRingHeader_t * pxHeader,
+                                TraceRingRecord_t * pxRecords,
+                                size_t uxMaxCount );
+
+/* Send the contents of the ring as UDP packets to pxDestination, each packet
+ * contains a header and a number of records. Not to be called from the IP-task. */
+        BaseType_t xTraceRingSendUDP( const struct freertos_sockaddr * pxDestination );
+
+        #if defined( __linux__ ) || defined( _WIN32 )
+
+/* Append the contents of the ring to a file. */
+            BaseType_t xTraceRingWriteFile( const char * pcFileName );
+        #endif
+
+/* The frame type of an Ethernet frame, in host order. */
+        #define traceRING_FRAME_TYPE( pucBuffer ) \
+    ( ( ( uint32_t ) ( pucBuffer )[ 12 ] << 8 ) | ( uint32_t ) ( pucBuffer )[ 13 ] )
+
+/* A macro that is already defined by the application is left alone. */
+        #ifndef iptraceNETWORK_EVENT_RECEIVED
+            #define iptraceNETWORK_EVENT_RECEIVED( eEvent ) \
+    vTraceRingRecord( ( uint16_t ) eTraceNetworkEventReceived, ( uint32_t ) ( eEvent ), 0U )
+        #endif
+
+        #ifndef iptraceNETWORK_INTERFACE_INPUT
+            #define iptraceNETWORK_INTERFACE_INPUT( uxDataLength, pucEthernetBuffer ) \
+    vTraceRingRecord( ( uint16_t ) eTraceNetworkInterfaceInput, ( uint32_t ) ( uxDataLength ), traceRING_FRAME_TYPE( pucEthernetBuffer ) )
+        #endif
+
+        #ifndef iptraceNETWORK_INTERFACE_OUTPUT
+            #define iptraceNETWORK_INTERFACE_OUTPUT( uxDataLength, pucEthernetBuffer ) \
+    vTraceRingRecord( ( uint16_t ) eTraceNetworkInterfaceOutput, ( uint32_t ) ( uxDataLength ), traceRING_FRAME_TYPE( pucEthernetBuffer ) )
+        #endif
+
+        #ifndef iptraceNETWORK_INTERFACE_RECEIVE
+            #define iptraceNETWORK_INTERFACE_RECEIVE() \
+    vTraceRingRecord( ( uint16_t ) eTraceNetworkInterfaceReceive, 0U, 0U )
+        #endif
+
+        #ifndef iptraceNETWORK_INTERFACE_TRANSMIT
+            #define iptraceNETWORK_INTERFACE_TRANSMIT() \
+    vTraceRingRecord( ( uint16_t ) eTraceNetworkInterfaceTransmit, 0U, 0U )
+        #endif
+
+        #ifndef iptraceNETWORK_BUFFER_OBTAINED
+            #define iptraceNETWORK_BUFFER_OBTAINED( pxBufferAddress ) \
+    vTraceRingRecord( ( uint16_t ) eTraceNetworkBufferObtained, ( uint32_t ) ( uintptr_t ) ( pxBufferAddress ), 0U )
+        #endif
+
+        #ifndef iptraceNETWORK_BUFFER_OBTAINED_FROM_ISR
+            #define iptraceNETWORK_BUFFER_OBTAINED_FROM_ISR( pxBufferAddress ) \
+    vTraceRingRecord( ( uint16_t ) eTraceNetworkBufferObtainedISR, ( uint32_t ) ( uintptr_t ) ( pxBufferAddress ), 0U )
+        #endif
+
+        #ifndef iptraceNETWORK_BUFFER_RELEASED
+            #define iptraceNETWORK_BUFFER_RELEASED( pxBufferAddress ) \
+    vTraceRingRecord( ( uint16_t ) eTraceNetworkBufferReleased, ( uint32_t ) ( uintptr_t ) ( pxBufferAddress ), 0U )
+        #endif
+
+        #ifndef iptraceFAILED_TO_OBTAIN_NETWORK_BUFFER
+            #define iptraceFAILED_TO_OBTAIN_NETWORK_BUFFER() \
+    vTraceRingRecord( ( uint16_t ) eTraceNetworkBufferFailed, 0U, 0U )
+        #endif
+
+        #ifndef iptraceFAILED_TO_OBTAIN_NETWORK_BUFFER_FROM_ISR
+            #define iptraceFAILED_TO_OBTAIN_NETWORK_BUFFER_FROM_ISR() \
+    vTraceRingRecord( ( uint16_t ) eTraceNetworkBufferFailedISR, 0U, 0U )
+        #endif
+
+        #ifndef iptraceSTACK_TX_EVENT_LOST
+            #define iptraceSTACK_TX_EVENT_LOST( xEvent ) \
+    vTraceRingRecord( ( uint16_t ) eTraceStackTxEventLost, ( uint32_t ) ( xEvent ), 0U )
+        #endif
+
+        #ifndef iptraceETHERNET_RX_EVENT_LOST
+            #define iptraceETHERNET_RX_EVENT_LOST() \
+    vTraceRingRecord( ( uint16_t ) eTraceEthernetRxEventLost, 0U, 0U )
+        #endif
+
+        #ifndef iptraceWAITING_FOR_TX_DMA_DESCRIPTOR
+            #define iptraceWAITING_FOR_TX_DMA_DESCRIPTOR() \
+    vTraceRingRecord( ( uint16_t ) eTraceWaitingForTxDMADescriptor, 0U, 0U )
+        #endif
+
+        #ifndef iptraceSENDING_UDP_PACKET
+            #define iptraceSENDING_UDP_PACKET( ulIPAddress ) \
+    vTraceRingRecord( ( uint16_t ) eTraceSendingUDPPacket, ( uint32_t ) ( ulIPAddress ), 0U )
+        #endif
+
+        #ifndef iptraceNO_BUFFER_FOR_SENDTO
+            #define iptraceNO_BUFFER_FOR_SENDTO() \
+    vTraceRingRecord( ( uint16_t ) eTraceNoBufferForSendto, 0U, 0U )
+        #endif
+
+        #ifndef iptraceRECVFROM_TIMEOUT
+            #define iptraceRECVFROM_TIMEOUT() \
+    vTraceRingRecord( ( uint16_t ) eTraceRecvfromTimeout, 0U, 0U )
+        #endif
+
+        #ifndef iptraceARP_PACKET_RECEIVED
+            #define iptraceARP_PACKET_RECEIVED() \
+    vTraceRingRecord( ( uint16_t ) eTraceARPPacketReceived, 0U, 0U )
+        #endif
+
+        #ifndef iptraceCREATING_ARP_REQUEST
+            #define iptraceCREATING_ARP_REQUEST( ulIPAddress ) \
+    vTraceRingRecord( ( uint16_t ) eTraceCreatingARPRequest, ( uint32_t ) ( ulIPAddress ), 0U )
+        #endif
+
+        #ifndef iptracePACKET_DROPPED_TO_GENERATE_ARP
+            #define iptracePACKET_DROPPED_TO_GENERATE_ARP( ulIPAddress ) \
+    vTraceRingRecord( ( uint16_t ) eTracePacketDroppedToGenerateARP, ( uint32_t ) ( ulIPAddress ), 0U )
+        #endif
+
+        #ifndef iptraceDELAYED_ARP_BUFFER_FULL
+            #define iptraceDELAYED_ARP_BUFFER_FULL() \
+    vTraceRingRecord( ( uint16_t ) eTraceDelayedARPBufferFull, 0U, 0U )
+        #endif
+
+        #ifndef iptraceDELAYED_ARP_REQUEST_STARTED
+            #define iptraceDELAYED_ARP_REQUEST_STARTED() \
+    vTraceRingRecord( ( uint16_t ) eTraceDelayedARPRequestStarted, 0U, 0U )
+        #endif
+
+        #ifndef iptraceDELAYED_ARP_TIMER_EXPIRED
+            #define iptraceDELAYED_ARP_TIMER_EXPIRED() \
+    vTraceRingRecord( ( uint16_t ) eTraceDelayedARPTimerExpired, 0U, 0U )
+        #endif
+
+        #ifndef iptraceDELAYED_ND_BUFFER_FULL
+            #define iptraceDELAYED_ND_BUFFER_FULL() \
+    vTraceRingRecord( ( uint16_t ) eTraceDelayedNDBufferFull, 0U, 0U )
+        #endif
+
+        #ifndef iptraceDELAYED_ND_REQUEST_STARTED
+            #define iptraceDELAYED_ND_REQUEST_STARTED() \
+    vTraceRingRecord( ( uint16_t ) eTraceDelayedNDRequestStarted, 0U, 0U )
+        #endif
+
+        #ifndef iptraceDELAYED_ND_TIMER_EXPIRED
+            #define iptraceDELAYED_ND_TIMER_EXPIRED() \
+    vTraceRingRecord( ( uint16_t ) eTraceDelayedNDTimerExpired, 0U, 0U )
+        #endif
+
+        #ifndef iptraceICMP_PACKET_RECEIVED
+            #define iptraceICMP_PACKET_RECEIVED() \
+    vTraceRingRecord( ( uint16_t ) eTraceICMPPacketReceived, 0U, 0U )
+        #endif
+
+        #ifndef iptraceSENDING_PING_REPLY
+            #define iptraceSENDING_PING_REPLY( ulIPAddress ) \
+    vTraceRingRecord( ( uint16_t ) eTraceSendingPingReply, ( uint32_t ) ( ulIPAddress ), 0U )
+        #endif
+
+        #ifndef iptraceNETWORK_DOWN
+            #define iptraceNETWORK_DOWN() \
+    vTraceRingRecord( ( uint16_t ) eTraceNetworkDown, 0U, 0U )
+        #endif
+
+    #else /* if ( ipconfigUSE_TRACE_RING != 0 ) */
+
+/* The header file 'IPTraceMacroDefaults.h' will define the default empty macro's. */
+
+    #endif /* ipconfigUSE_TRACE_RING != 0 */
+
+    #ifdef __cplusplus
+}         /* extern "C" */
+    #endif
+
+#endif /* TCP_TRACE_RING_H */
@@ -0,0 +1,418 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/*
+ * @file tcp_conn_scale.c
+ * @brief A server for many concurrent TCP connections, which reports the
+ *        connection rate, the memory per connection and the IP-task load.
+ * See tools/tcp_utilities/tcp_conn_scale.md for further description.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include <FreeRTOS.h>
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+#include "FreeRTOS_IP_Profiling.h"
+#include "NetworkBufferManagement.h"
+
+#include "tcp_conn_scale.h"
+
+#if ( ipconfigUSE_TCP == 1 ) && ( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
+
+/* The free heap space, used to calculate the memory per connection. Define
+ * it as 0 when the heap implementation can not tell, e.g. heap_3. */
+    #ifndef connscaleFREE_HEAP
+        #define connscaleFREE_HEAP()    xPortGetFreeHeapSize()
+    #endif
+
+/* The load of the IP-task is taken from the IP-task profile, or else from the
+ * run-time statistics of the kernel. */
+    #if ( ipconfigUSE_IP_TASK_PROFILING == 1 )
+        #define connscaleIP_TASK_LOAD    1
+    #elif ( ( configGENERATE_RUN_TIME_STATS == 1 ) && ( configUSE_TRACE_FACILITY == 1 ) && defined( portGET_RUN_TIME_COUNTER_VALUE ) )
+        #define connscaleIP_TASK_LOAD    2
+    #else
+        #define connscaleIP_TASK_LOAD    0
+    #endif
+
+/* Received data is echoed in chunks of this size. */
+    #define connscaleECHO_SIZE    512U
+
+    static Socket_t xListenSocket;
+    static SocketSet_t xSocketSet;
+
+/* The open connections, the first xStats.ulOpen entries are in use. */
+    static Socket_t xConnections[ connscaleMAX_CONNECTIONS ];
+
+/* The statistics as they are being counted, and as they were at the last report. */
+    static ConnScaleStats_t xStats;
+    static ConnScaleStats_t xReportedStats;
+
+/* The values at the previous report, to calculate rates. */
+    static uint32_t ulLastAccepted;
+    static size_t uxBaseFreeHeap;
+    static uint64_t ullLastBusy;
+    static uint64_t ullLastTotal;
+
+    static uint8_t ucEchoBuffer[ connscaleECHO_SIZE ];
+
+/*-----------------------------------------------------------*/
+
+/* Get the time that the IP-task was busy, and the time that passed, both
+ * in the same unit. */
+    static void prvGetIPTaskTimes( uint64_t * pullBusy,
+                                   uint64_t * pullTotal )
+    {
+        #if ( connscaleIP_TASK_LOAD == 1 )
+        {
+            /* Static, because the profile is large. */
+            static IPTaskProfile_t xProfile;
+            size_t uxIndex;
+            uint64_t ullBusy = 0U;
+
+            if( FreeRTOS_GetIPTaskProfile( &( xProfile ) ) == pdPASS )
+            {
+                for( uxIndex = 0U; uxIndex < ipIP_TASK_PROFILE_EVENT_COUNT; uxIndex++ )
+                {
+                    ullBusy += xProfile.xProcessing[ uxIndex ].ullTotal;
+                }
+
+                ullBusy += xProfile.xTimerCheck.ullTotal;
+            }
+
+            *pullBusy = ullBusy;
+            *pullTotal = ipconfigIP_TASK_PROFILING_TIME();
+        }
+        #elif ( connscaleIP_TASK_LOAD == 2 )
+        {
+            TaskStatus_t xStatus;
+
+            vTaskGetInfo( FreeRTOS_GetIPTaskHandle(), &( xStatus ), pdFALSE, eRunning );
+            *pullBusy = ( uint64_t ) xStatus.ulRunTimeCounter;
+            *pullTotal = ( uint64_t ) portGET_RUN_TIME_COUNTER_VALUE();
+        }
+        #else
+        {
+            *pullBusy = 0U;
+            *pullTotal = 0U;
+        }
+        #endif /* if ( connscaleIP_TASK_LOAD == 1 ) */
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvReport( TickType_t xElapsed )
+    {
+        uint64_t ullBusy;
+        uint64_t ullTotal;
+        size_t uxFreeHeap = ( size_t ) connscaleFREE_HEAP();
+
+        prvGetIPTaskTimes( &( ullBusy ), &( ullTotal ) );
+
+        if( ( ullTotal > ullLastTotal ) && ( ullBusy >= ullLastBusy ) )
+        {
+            xStats.ulIPTaskPermille = ( uint32_t ) ( ( ( ullBusy - ullLastBusy ) * 1000U ) / ( ullTotal - ullLastTotal ) );
+        }
+
+        ullLastBusy = ullBusy;
+        ullLastTotal = ullTotal;
+
+        xStats.ulAcceptRate = ( uint32_t ) ( ( ( uint64_t ) ( xStats.ulAccepted - ulLastAccepted ) * configTICK_RATE_HZ ) / xElapsed );
+        ulLastAccepted = xStats.ulAccepted;
+
+        /* The heap in use without connections is the base line. */
+        if( xStats.ulOpen == 0U )
+        {
+            uxBaseFreeHeap = uxFreeHeap;
+            xStats.ulBytesPerConnection = 0U;
+        }
+        else if( uxBaseFreeHeap > uxFreeHeap )
+        {
+            xStats.ulBytesPerConnection = ( uint32_t ) ( ( uxBaseFreeHeap - uxFreeHeap ) / xStats.ulOpen );
+        }
+        else
+        {
+            /* The heap size is not known. */
+        }
+
+        xStats.uxMinimumFreeNetworkBuffers = uxGetMinimumFreeNetworkBuffers();
+
+        vTaskSuspendAll();
+        {
+            xReportedStats = xStats;
+        }
+        ( void ) xTaskResumeAll();
+
+        /* Only report while there is activity. */
+        if( ( xStats.ulOpen != 0U ) || ( xStats.ulAcceptRate != 0U ) )
+        {
+            FreeRTOS_printf( ( "connscale: open %u peak %u accepted %u ( %u/s ) refused %u, %u bytes/conn, IP-task %u.%u %%, min free buffers %u\n",
+                               ( unsigned ) xStats.ulOpen,
+                               ( unsigned ) xStats.ulPeakOpen,
+                               ( unsigned ) xStats.ulAccepted,
+                               ( unsigned ) xStats.ulAcceptRate,
+                               ( unsigned ) xStats.ulRefused,
+                               ( unsigned ) xStats.ulBytesPerConnection,
+                               ( unsigned ) ( xStats.ulIPTaskPermille / 10U ),
+                               ( unsigned ) ( xStats.ulIPTaskPermille % 10U ),
+                               ( unsigned ) xStats.uxMinimumFreeNetworkBuffers ) );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvCloseConnection( size_t uxIndex )
+    {
+        Socket_t xSocket = xConnections[ uxIndex ];
+
+        FreeRTOS_FD_CLR( xSocket, xSocketSet, eSELECT_ALL );
+        ( void ) FreeRTOS_closesocket( xSocket );
+
+        /* Keep the table compact: move the last entry into the hole. */
+        xStats.ulOpen--;
+        xConnections[ uxIndex ] = xConnections[ xStats.ulOpen ];
+        xConnections[ xStats.ulOpen ] = NULL;
+        xStats.ulClosed++;
+    }
+/*-----------------------------------------------------------*/
+
+/* Accept all connections that are waiting. */
+    static void prvAcceptConnections( void )
+    {
+        for( ; ; )
+        {
+            struct freertos_sockaddr xAddress;
+            socklen_t xAddressLength = sizeof( xAddress );
+            Socket_t xSocket = FreeRTOS_accept( xListenSocket, &( xAddress ), &( xAddressLength ) );
+
+            if( ( xSocket == NULL ) || ( xSocket == FREERTOS_INVALID_SOCKET ) )
+            {
+                break;
+            }
+
+            xStats.ulAccepted++;
+
+            if( xStats.ulOpen >= connscaleMAX_CONNECTIONS )
+            {
+                xStats.ulRefused++;
+                ( void ) FreeRTOS_closesocket( xSocket );
+            }
+            else
+            {
+                xConnections[ xStats.ulOpen ] = xSocket;
+                xStats.ulOpen++;
+
+                if( xStats.ulPeakOpen < xStats.ulOpen )
+                {
+                    xStats.ulPeakOpen = xStats.ulOpen;
+                }
+
+                /* A connection that is closed by the peer only reports EXCEPT. */
+                FreeRTOS_FD_SET( xSocket, xSocketSet, ( EventBits_t ) eSELECT_READ | ( EventBits_t ) eSELECT_EXCEPT );
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/* Send the first uxLength bytes of the echo buffer. Every call to send blocks
+ * for at most connscaleSEND_TIMEOUT_MS. Returns the number of bytes sent, or
+ * a negative value when not all bytes could be sent. */
+    static BaseType_t prvSendAll( Socket_t xSocket,
+                                  size_t uxLength )
+    {
+        size_t uxSent = 0U;
+        BaseType_t xResult = 0;
+
+        while( uxSent < uxLength )
+        {
+            xResult = FreeRTOS_send( xSocket, &( ucEchoBuffer[ uxSent ] ), uxLength - uxSent, 0 );
+
+            if( xResult <= 0 )
+            {
+                /* An error, or the peer did not read its data in time. */
+                xResult = -pdFREERTOS_ERRNO_ENOSPC;
+                break;
+            }
+
+            uxSent += ( size_t ) xResult;
+        }
+
+        if( uxSent == uxLength )
+        {
+            xResult = ( BaseType_t ) uxSent;
+        }
+
+        return xResult;
+    }
+/*-----------------------------------------------------------*/
+
+/* Echo the data of a connection, and close it when the peer has closed it.
+ * Returns pdTRUE when the connection was closed. */
+    static BaseType_t prvServeConnection( size_t uxIndex )
+    {
+        Socket_t xSocket = xConnections[ uxIndex ];
+        BaseType_t xClosed = pdFALSE;
+
+        for( ; ; )
+        {
+            BaseType_t xResult = FreeRTOS_recv( xSocket, ucEchoBuffer, sizeof( ucEchoBuffer ), FREERTOS_MSG_DONTWAIT );
+
+            if( xResult > 0 )
+            {
+                xResult = prvSendAll( xSocket, ( size_t ) xResult );
+            }
+
+            if( xResult <= 0 )
+            {
+                if( xResult < 0 )
+                {
+                    prvCloseConnection( uxIndex );
+                    xClosed = pdTRUE;
+                }
+
+                break;
+            }
+        }
+
+        return xClosed;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvServerTask( void * pvParameters )
+    {
+        struct freertos_sockaddr xBindAddress;
+        TickType_t xNoTimeout = 0U;
+        TickType_t xSendTimeout = pdMS_TO_TICKS( connscaleSEND_TIMEOUT_MS );
+        TickType_t xLastReport;
+        size_t uxIndex;
+
+        ( void ) memset( &( xBindAddress ), 0, sizeof( xBindAddress ) );
+        xBindAddress.sin_len = ( uint8_t ) sizeof( xBindAddress );
+        xBindAddress.sin_family = FREERTOS_AF_INET;
+        #if ( ipconfigUSE_IPv4 == 0 )
+            xBindAddress.sin_family = FREERTOS_AF_INET6;
+        #endif
+        xBindAddress.sin_port = FreeRTOS_htons( ( uint16_t ) ( ( uintptr_t ) pvParameters ) );
+
+        xListenSocket = FreeRTOS_socket( ( BaseType_t ) xBindAddress.sin_family, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+        configASSERT( xListenSocket != FREERTOS_INVALID_SOCKET );
+
+        xSocketSet = FreeRTOS_CreateSocketSet();
+        configASSERT( xSocketSet != NULL );
+
+        /* The connections inherit these properties from the listening socket. */
+        ( void ) FreeRTOS_setsockopt( xListenSocket, 0, FREERTOS_SO_RCVTIMEO, &( xNoTimeout ), sizeof( xNoTimeout ) );
+        ( void ) FreeRTOS_setsockopt( xListenSocket, 0, FREERTOS_SO_SNDTIMEO, &( xSendTimeout ), sizeof( xSendTimeout ) );
+
+        #if ( connscaleSTREAM_BUFFER_SIZE != 0U )
+        {
+            BaseType_t xBufferSize = ( BaseType_t ) connscaleSTREAM_BUFFER_SIZE;
+
+            ( void ) FreeRTOS_setsockopt( xListenSocket, 0, FREERTOS_SO_RCVBUF, &( xBufferSize ), sizeof( xBufferSize ) );
+            ( void ) FreeRTOS_setsockopt( xListenSocket, 0, FREERTOS_SO_SNDBUF, &( xBufferSize ), sizeof( xBufferSize ) );
+        }
+        #endif
+
+        ( void ) FreeRTOS_bind( xListenSocket, &( xBindAddress ), sizeof( xBindAddress ) );
+
+        /* The backlog limits the number of child sockets that exist at the same time,
+         * accepted or not. Allow a few extra to be able to refuse them. */
+        ( void ) FreeRTOS_listen( xListenSocket, ( BaseType_t ) connscaleMAX_CONNECTIONS + 8 );
+        FreeRTOS_FD_SET( xListenSocket, xSocketSet, eSELECT_READ );
+
+        FreeRTOS_printf( ( "connscale: listening on port %u for up to %u connections\n",
+                           ( unsigned ) FreeRTOS_ntohs( xBindAddress.sin_port ),
+                           ( unsigned ) connscaleMAX_CONNECTIONS ) );
+
+        uxBaseFreeHeap = ( size_t ) connscaleFREE_HEAP();
+        prvGetIPTaskTimes( &( ullLastBusy ), &( ullLastTotal ) );
+        xLastReport = xTaskGetTickCount();
+
+        for( ; ; )
+        {
+            TickType_t xElapsed;
+
+            if( FreeRTOS_select( xSocketSet, pdMS_TO_TICKS( 100U ) ) > 0 )
+            {
+                if( FreeRTOS_FD_ISSET( xListenSocket, xSocketSet ) != 0U )
+                {
+                    prvAcceptConnections();
+                }
+
+                uxIndex = 0U;
+
+                while( uxIndex < ( size_t ) xStats.ulOpen )
+                {
+                    /* A closed connection is replaced by the last one, which must
+                     * then be checked at the same index. */
+                    if( ( FreeRTOS_FD_ISSET( xConnections[ uxIndex ], xSocketSet ) == 0U ) ||
+                        ( prvServeConnection( uxIndex ) == pdFALSE ) )
+                    {
+                        uxIndex++;
+                    }
+                }
+            }
+
+            xElapsed = xTaskGetTickCount() - xLastReport;
+
+            if( xElapsed >= pdMS_TO_TICKS( connscaleREPORT_INTERVAL_MS ) )
+            {
+                prvReport( xElapsed );
+                xLastReport += xElapsed;
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xConnScaleStartServer( uint16_t usPort,
+                                      uint16_t usStackSize,
+                                      UBaseType_t uxPriority )
+    {
+        uintptr_t uxPort = ( usPort != 0U ) ? ( uintptr_t ) usPort : ( uintptr_t ) connscaleDEFAULT_PORT;
+
+        return xTaskCreate( prvServerTask, "connscale", usStackSize, ( void * ) uxPort, uxPriority, NULL );
+    }
+/*-----------------------------------------------------------*/
+
+    void vConnScaleGetStats( ConnScaleStats_t * pxStats )
+    {
+        vTaskSuspendAll();
+        {
+            *pxStats = xReportedStats;
+        }
+        ( void ) xTaskResumeAll();
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigSUPPORT_SELECT_FUNCTION == 1 ) */
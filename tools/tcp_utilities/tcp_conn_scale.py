@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+# FreeRTOS+TCP
+# Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+#
+# SPDX-License-Identifier: MIT
+
+"""Open many TCP connections to the server of tcp_conn_scale.c and churn them.
+
+First N connections are opened at the given rate. Then, for the given
+duration, the oldest connection is closed and a new one is opened, at the
+same rate. Every new connection sends one byte and waits for the echo.
+
+Two times are measured for every new connection:
+    connect: until the three-way handshake is done.
+    accept:  until the echo arrives, so also until the server has accepted
+             the connection and read from it.
+
+Examples:
+    tcp_conn_scale.py 192.168.2.114 --connections 200 --rate 100
+    tcp_conn_scale.py 192.168.2.114 --connections 1000 --rate 500 --duration 30 --json
+"""
+
+import argparse
+import asyncio
+import collections
+import json
+import sys
+import time
+
+
+def percentile(values, fraction):
+    """Return the smallest value that is not exceeded by the given fraction of values."""
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    index = max(0, min(len(ordered) - 1, int(len(ordered) * fraction + 0.999999) - 1))
+    return ordered[index]
+
+
+def summary(values):
+    """Summarise a list of times in seconds as microseconds."""
+    return {
+        "count": len(values),
+        "min_us": round(min(values) * 1e6) if values else 0,
+        "p50_us": round(percentile(values, 0.50) * 1e6),
+        "p99_us": round(percentile(values, 0.99) * 1e6),
+        "p99.9_us": round(percentile(values, 0.999) * 1e6),
+        "max_us": round(max(values) * 1e6) if values else 0,
+    }
+
+
+class Churn:
+    """Keep a set of open connections and replace them at a fixed rate."""
+
+    def __init__(self, args):
+        self.args = args
+        self.open = collections.deque()
+        self.connect_times = []
+        self.accept_times = []
+        self.failures = 0
+        self.closed = 0
+        self.pending = set()
+
+    async def open_one(self):
+        start = time.perf_counter()
+        try:
+            reader, writer = await asyncio.wait_for(
+                asyncio.open_connection(self.args.host, self.args.port), self.args.timeout)
+            connected = time.perf_counter()
+            writer.write(b"x")
+            await writer.drain()
+            await asyncio.wait_for(reader.readexactly(1), self.args.timeout)
+            echoed = time.perf_counter()
+        except (OSError, asyncio.TimeoutError, asyncio.IncompleteReadError):
+            self.failures += 1
+            return
+        self.connect_times.append(connected - start)
+        self.accept_times.append(echoed - start)
+        self.open.append(writer)
+
+    def start_one(self):
+        task = asyncio.ensure_future(self.open_one())
+        self.pending.add(task)
+        task.add_done_callback(self.pending.discard)
+
+    def close_oldest(self):
+        if self.open:
+            writer = self.open.popleft()
+            writer.close()
+            self.closed += 1
+
+    async def run(self):
+        interval = 1.0 / self.args.rate
+        next_time = time.perf_counter()
+
+        # Ramp up to the number of concurrent connections.
+        ramp_start = next_time
+        for _ in range(self.args.connections):
+            await asyncio.sleep(max(0.0, next_time - time.perf_counter()))
+            self.start_one()
+            next_time += interval
+        if self.pending:
+            await asyncio.wait(list(self.pending))
+        ramp_time = time.perf_counter() - ramp_start
+        ramp_open = len(self.open)
+
+        # Churn: replace the oldest connection by a new one.
+        churn_start = time.perf_counter()
+        next_time = churn_start
+        opened = 0
+        while time.perf_counter() - churn_start < self.args.duration:
+            await asyncio.sleep(max(0.0, next_time - time.perf_counter()))
+            self.close_oldest()
+            self.start_one()
+            opened += 1
+            next_time += interval
+        if self.pending:
+            await asyncio.wait(list(self.pending))
+        churn_time = time.perf_counter() - churn_start
+
+        while self.open:
+            self.close_oldest()
+        await asyncio.sleep(0.1)
+
+        return {
+            "host": self.args.host,
+            "port": self.args.port,
+            "target_connections": self.args.connections,
+            "target_rate": self.args.rate,
+            "ramp_open": ramp_open,
+            "ramp_seconds": round(ramp_time, 3),
+            "churn_seconds": round(churn_time, 3),
+            "churn_rate": round(opened / churn_time, 1) if churn_time > 0 else 0.0,
+            "failures": self.failures,
+            "connect": summary(self.connect_times),
+            "accept": summary(self.accept_times),
+        }
+
+
+def print_report(report):
+    print("%u of %u connections open after %.3f s" %
+          (report["ramp_open"], report["target_connections"], report["ramp_seconds"]))
+    print("churned at %.1f connections/s ( target %u ), %u failures" %
+          (report["churn_rate"], report["target_rate"], report["failures"]))
+    for name in ("connect", "accept"):
+        stats = report[name]
+        print("%-8s: n %u min %u p50 %u p99 %u p99.9 %u max %u us" %
+              (name, stats["count"], stats["min_us"], stats["p50_us"],
+               stats["p99_us"], stats["p99.9_us"], stats["max_us"]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("host", help="the address of the device")
+    parser.add_argument("--port", type=int, default=5203, help="the port of the server")
+    parser.add_argument("--connections", type=int, default=100,
+                        help="the number of concurrent connections")
+    parser.add_argument("--rate", type=float, default=100.0,
+                        help="new connections per second")
+    parser.add_argument("--duration", type=float, default=10.0,
+                        help="the duration of the churn, in seconds")
+    parser.add_argument("--timeout", type=float, default=5.0,
+                        help="the time-out for connecting and for the echo, in seconds")
+    parser.add_argument("--json", action="store_true", help="write the results as JSON")
+    args = parser.parse_args()
+
+    if args.rate <= 0:
+        parser.error("the rate must be positive")
+
+    report = asyncio.run(Churn(args).run())
+
+    if args.json:
+        json.dump(report, sys.stdout, indent=2)
+        print()
+    else:
+        print_report(report)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,1238 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/*
+ * @file tcp_iperf3.c
+ * @brief A throughput benchmark that speaks the protocol of iperf3. It can
+ *        serve a host running "iperf3 -c", or test against "iperf3 -s".
+ * See tools/tcp_utilities/tcp_iperf3.md for further description.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include <FreeRTOS.h>
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+
+#include "tcp_iperf3.h"
+
+#if ( ipconfigUSE_TCP == 1 )
+
+/* The states of a test, as they are exchanged over the control connection. */
+    #define iperf3TEST_START          ( 1 )
+    #define iperf3TEST_RUNNING        ( 2 )
+    #define iperf3TEST_END            ( 4 )
+    #define iperf3PARAM_EXCHANGE      ( 9 )
+    #define iperf3CREATE_STREAMS      ( 10 )
+    #define iperf3SERVER_TERMINATE    ( 11 )
+    #define iperf3CLIENT_TERMINATE    ( 12 )
+    #define iperf3EXCHANGE_RESULTS    ( 13 )
+    #define iperf3DISPLAY_RESULTS     ( 14 )
+    #define iperf3IPERF_DONE          ( 16 )
+    #define iperf3ACCESS_DENIED       ( -1 )
+
+/* A cookie of 36 characters plus a nul, identifies the streams of a test. */
+    #define iperf3COOKIE_SIZE         37U
+
+/* The first datagram of a UDP test, sent by the client, and the replies
+ * that the server may send. */
+    #define iperf3UDP_CONNECT_MSG             0x075BCD15UL
+    #define iperf3UDP_CONNECT_REPLY           0x3ADE68B1UL
+    #define iperf3UDP_CONNECT_REPLY_LEGACY    0x39383736UL
+
+/* Every UDP datagram starts with seconds, microseconds and a packet count. */
+    #define iperf3UDP_HEADER_SIZE             12U
+
+/* The JSON messages with the parameters and the results are short. */
+    #define iperf3JSON_SIZE                   640U
+
+/* The default UDP rate is 1 Mbit/s, like iperf3. */
+    #define iperf3DEFAULT_BANDWIDTH           1000000UL
+    #define iperf3DEFAULT_DURATION            10UL
+
+/* The data sockets are polled, so that the end of a test is noticed. */
+    #define iperf3POLL_TICKS                  pdMS_TO_TICKS( 100U )
+    #define iperf3CONTROL_TICKS               pdMS_TO_TICKS( 10000U )
+
+/* The clock used to measure the duration and the UDP jitter, in microseconds.
+ * ullGetHighResolutionTime() must be supplied by the application. */
+    #ifndef iperf3TIME_US
+        extern uint64_t ullGetHighResolutionTime( void );
+        #define iperf3TIME_US()    ullGetHighResolutionTime()
+    #endif
+
+/* The CPU load is measured with the run-time statistics of the kernel. */
+    #if ( ( configGENERATE_RUN_TIME_STATS == 1 ) && ( INCLUDE_xTaskGetIdleTaskHandle == 1 ) && defined( portGET_RUN_TIME_COUNTER_VALUE ) )
+        #define iperf3MEASURE_CPU    1
+    #else
+        #define iperf3MEASURE_CPU    0
+    #endif
+
+/* The state of a test, either as a client or as a server. */
+    typedef struct xIPERF3_TEST
+    {
+        Socket_t xControl;                    /* The TCP control connection. */
+        Socket_t xData;                       /* The TCP or UDP data stream. */
+        struct freertos_sockaddr xUDPPeer;    /* The peer of a UDP stream. */
+        IPerf3Settings_t xSettings;           /* The parameters of the test. */
+        IPerf3Result_t * pxResult;            /* The results as seen from this side. */
+        char cCookie[ iperf3COOKIE_SIZE ];    /* Identifies the test. */
+        uint32_t ulLastCount;                 /* The highest UDP packet count received. */
+        int64_t llLastTransit;                /* The previous UDP transit time, for the jitter. */
+        uint64_t ullJitter16;                 /* The UDP jitter in microseconds, times 16. */
+        #if ( iperf3MEASURE_CPU == 1 )
+            uint32_t ulIdleStart;             /* The idle run time when the test started. */
+            uint32_t ulTotalStart;            /* The total run time when the test started. */
+        #endif
+    } IPerf3Test_t;
+
+/* Only one test can run at a time, they share these buffers. */
+    static uint8_t ucDataBuffer[ iperf3BUFFER_SIZE ];
+    static char cJSONBuffer[ iperf3JSON_SIZE ];
+
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvSendAll( Socket_t xSocket,
+                                  const void * pvData,
+                                  size_t uxLength )
+    {
+        const uint8_t * pucData = ( const uint8_t * ) pvData;
+        size_t uxSent = 0U;
+        BaseType_t xReturn = pdPASS;
+
+        while( uxSent < uxLength )
+        {
+            BaseType_t xResult = FreeRTOS_send( xSocket, &( pucData[ uxSent ] ), uxLength - uxSent, 0 );
+
+            if( xResult <= 0 )
+            {
+                xReturn = pdFAIL;
+                break;
+            }
+
+            uxSent += ( size_t ) xResult;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvReceiveAll( Socket_t xSocket,
+                                     void * pvData,
+                                     size_t uxLength )
+    {
+        uint8_t * pucData = ( uint8_t * ) pvData;
+        size_t uxReceived = 0U;
+        BaseType_t xReturn = pdPASS;
+
+        while( uxReceived < uxLength )
+        {
+            /* A time-out is also treated as an error. */
+            BaseType_t xResult = FreeRTOS_recv( xSocket, &( pucData[ uxReceived ] ), uxLength - uxReceived, 0 );
+
+            if( xResult <= 0 )
+            {
+                xReturn = pdFAIL;
+                break;
+            }
+
+            uxReceived += ( size_t ) xResult;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvSendState( Socket_t xSocket,
+                                    int8_t cState )
+    {
+        return prvSendAll( xSocket, &( cState ), 1U );
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvReceiveState( Socket_t xSocket,
+                                       int8_t * pcState )
+    {
+        return prvReceiveAll( xSocket, pcState, 1U );
+    }
+/*-----------------------------------------------------------*/
+
+/* A JSON message is preceded by its length as a 32-bit big-endian number. */
+    static BaseType_t prvSendJSON( Socket_t xSocket,
+                                   const char * pcJSON )
+    {
+        uint32_t ulLength = ( uint32_t ) strlen( pcJSON );
+        uint8_t ucLength[ 4 ];
+        BaseType_t xReturn;
+
+        ucLength[ 0 ] = ( uint8_t ) ( ulLength >> 24 );
+        ucLength[ 1 ] = ( uint8_t ) ( ulLength >> 16 );
+        ucLength[ 2 ] = ( uint8_t ) ( ulLength >> 8 );
+        ucLength[ 3 ] = ( uint8_t ) ulLength;
+
+        xReturn = prvSendAll( xSocket, ucLength, sizeof( ucLength ) );
+
+        if( xReturn == pdPASS )
+        {
+            xReturn = prvSendAll( xSocket, pcJSON, ( size_t ) ulLength );
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvReceiveJSON( Socket_t xSocket,
+                                      char * pcJSON,
+                                      size_t uxSize )
+    {
+        uint8_t ucLength[ 4 ];
+        uint32_t ulLength = 0U;
+        BaseType_t xReturn = prvReceiveAll( xSocket, ucLength, sizeof( ucLength ) );
+
+        if( xReturn == pdPASS )
+        {
+            ulLength = ( ( ( uint32_t ) ucLength[ 0 ] ) << 24 ) |
+                       ( ( ( uint32_t ) ucLength[ 1 ] ) << 16 ) |
+                       ( ( ( uint32_t ) ucLength[ 2 ] ) << 8 ) |
+                       ( ( uint32_t ) ucLength[ 3 ] );
+
+            if( ( size_t ) ulLength >= uxSize )
+            {
+                FreeRTOS_printf( ( "iperf3: JSON message of %u bytes is too long\n", ( unsigned ) ulLength ) );
+                xReturn = pdFAIL;
+            }
+        }
+
+        if( xReturn == pdPASS )
+        {
+            xReturn = prvReceiveAll( xSocket, pcJSON, ( size_t ) ulLength );
+            pcJSON[ ulLength ] = '\0';
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/* Find the value of a key in a flat JSON message. Only the first occurrence
+ * counts, which is good enough for the messages of iperf3. */
+    static const char * prvJSONFind( const char * pcJSON,
+                                     const char * pcKey )
+    {
+        const char * pcValue = NULL;
+        size_t uxKeyLength = strlen( pcKey );
+        const char * pcPosition = pcJSON;
+
+        while( ( pcPosition = strchr( pcPosition, '"' ) ) != NULL )
+        {
+            pcPosition++;
+
+            if( ( strncmp( pcPosition, pcKey, uxKeyLength ) == 0 ) &&
+                ( pcPosition[ uxKeyLength ] == '"' ) )
+            {
+                pcValue = &( pcPosition[ uxKeyLength + 1U ] );
+
+                while( ( *pcValue == ' ' ) || ( *pcValue == ':' ) )
+                {
+                    pcValue++;
+                }
+
+                break;
+            }
+        }
+
+        return pcValue;
+    }
+/*-----------------------------------------------------------*/
+
+/* Read an unsigned integer value. When pulMicro is not NULL, the value may
+ * have a fraction, which is returned in millionths. */
+    static BaseType_t prvJSONGetNumber( const char * pcJSON,
+                                        const char * pcKey,
+                                        uint64_t * pullValue,
+                                        uint32_t * pulMicro )
+    {
+        const char * pcValue = prvJSONFind( pcJSON, pcKey );
+        BaseType_t xReturn = pdFALSE;
+        uint64_t ullValue = 0U;
+        uint32_t ulMicro = 0U;
+        uint32_t ulScale = 100000U;
+
+        if( ( pcValue != NULL ) && ( *pcValue >= '0' ) && ( *pcValue <= '9' ) )
+        {
+            while( ( *pcValue >= '0' ) && ( *pcValue <= '9' ) )
+            {
+                ullValue = ( ullValue * 10U ) + ( uint64_t ) ( *pcValue - '0' );
+                pcValue++;
+            }
+
+            if( *pcValue == '.' )
+            {
+                pcValue++;
+
+                while( ( *pcValue >= '0' ) && ( *pcValue <= '9' ) )
+                {
+                    ulMicro += ( uint32_t ) ( *pcValue - '0' ) * ulScale;
+                    ulScale /= 10U;
+                    pcValue++;
+                }
+            }
+
+            *pullValue = ullValue;
+
+            if( pulMicro != NULL )
+            {
+                *pulMicro = ulMicro;
+            }
+
+            xReturn = pdTRUE;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvJSONIsTrue( const char * pcJSON,
+                                     const char * pcKey )
+    {
+        const char * pcValue = prvJSONFind( pcJSON, pcKey );
+        BaseType_t xReturn = pdFALSE;
+
+        if( ( pcValue != NULL ) && ( strncmp( pcValue, "true", 4 ) == 0 ) )
+        {
+            xReturn = pdTRUE;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvMakeCookie( char * pcCookie )
+    {
+        static const char cAlphabet[] = "abcdefghijklmnopqrstuvwxyz234567";
+        size_t uxIndex;
+        uint32_t ulRandom = 0U;
+
+        for( uxIndex = 0U; uxIndex < ( iperf3COOKIE_SIZE - 1U ); uxIndex++ )
+        {
+            /* Every random number gives 6 characters of 5 bits. */
+            if( ( uxIndex % 6U ) == 0U )
+            {
+                ( void ) xApplicationGetRandomNumber( &( ulRandom ) );
+            }
+
+            pcCookie[ uxIndex ] = cAlphabet[ ulRandom & 0x1FU ];
+            ulRandom >>= 5;
+        }
+
+        pcCookie[ iperf3COOKIE_SIZE - 1U ] = '\0';
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvCPUStart( IPerf3Test_t * pxTest )
+    {
+        #if ( iperf3MEASURE_CPU == 1 )
+        {
+            pxTest->ulIdleStart = ( uint32_t ) ulTaskGetIdleRunTimeCounter();
+            pxTest->ulTotalStart = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE();
+        }
+        #else
+        {
+            ( void ) pxTest;
+        }
+        #endif
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvCPUStop( IPerf3Test_t * pxTest )
+    {
+        #if ( iperf3MEASURE_CPU == 1 )
+        {
+            uint32_t ulIdle = ( uint32_t ) ulTaskGetIdleRunTimeCounter() - pxTest->ulIdleStart;
+            uint32_t ulTotal = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() - pxTest->ulTotalStart;
+
+            if( ( ulTotal != 0U ) && ( ulIdle <= ulTotal ) )
+            {
+                pxTest->pxResult->ulCPUPermille = ( uint32_t ) ( ( ( uint64_t ) ( ulTotal - ulIdle ) * 1000U ) / ulTotal );
+            }
+        }
+        #else
+        {
+            ( void ) pxTest;
+        }
+        #endif
+    }
+/*-----------------------------------------------------------*/
+
+    static Socket_t prvCreateSocket( BaseType_t xFamily,
+                                     BaseType_t xUDP )
+    {
+        Socket_t xSocket;
+        TickType_t xTimeout = iperf3CONTROL_TICKS;
+
+        if( xUDP != pdFALSE )
+        {
+            xSocket = FreeRTOS_socket( xFamily, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+        }
+        else
+        {
+            xSocket = FreeRTOS_socket( xFamily, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+        }
+
+        if( xSocket == FREERTOS_INVALID_SOCKET )
+        {
+            xSocket = NULL;
+        }
+        else
+        {
+            ( void ) FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_RCVTIMEO, &( xTimeout ), sizeof( xTimeout ) );
+            ( void ) FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_SNDTIMEO, &( xTimeout ), sizeof( xTimeout ) );
+        }
+
+        return xSocket;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvCloseSocket( Socket_t * pxSocket )
+    {
+        if( *pxSocket != NULL )
+        {
+            ( void ) FreeRTOS_shutdown( *pxSocket, FREERTOS_SHUT_RDWR );
+            ( void ) FreeRTOS_closesocket( *pxSocket );
+            *pxSocket = NULL;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/* Once the data stream exists, use short time-outs, so that the control
+ * connection can be checked regularly. */
+    static void prvSetPollTimeouts( Socket_t xSocket )
+    {
+        TickType_t xTimeout = iperf3POLL_TICKS;
+
+        ( void ) FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_RCVTIMEO, &( xTimeout ), sizeof( xTimeout ) );
+        ( void ) FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_SNDTIMEO, &( xTimeout ), sizeof( xTimeout ) );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvWriteUInt32( uint8_t * pucBuffer,
+                                uint32_t ulValue )
+    {
+        pucBuffer[ 0 ] = ( uint8_t ) ( ulValue >> 24 );
+        pucBuffer[ 1 ] = ( uint8_t ) ( ulValue >> 16 );
+        pucBuffer[ 2 ] = ( uint8_t ) ( ulValue >> 8 );
+        pucBuffer[ 3 ] = ( uint8_t ) ulValue;
+    }
+/*-----------------------------------------------------------*/
+
+    static uint32_t prvReadUInt32( const uint8_t * pucBuffer )
+    {
+        return ( ( ( uint32_t ) pucBuffer[ 0 ] ) << 24 ) |
+               ( ( ( uint32_t ) pucBuffer[ 1 ] ) << 16 ) |
+               ( ( ( uint32_t ) pucBuffer[ 2 ] ) << 8 ) |
+               ( ( uint32_t ) pucBuffer[ 3 ] );
+    }
+/*-----------------------------------------------------------*/
+
+/* Send one block of data. UDP datagrams are paced to the requested rate. */
+    static BaseType_t prvSendBlock( IPerf3Test_t * pxTest,
+                                    uint64_t ullStartTime,
+                                    uint64_t ullNow )
+    {
+        IPerf3Result_t * pxResult = pxTest->pxResult;
+        size_t uxLength = ( size_t ) pxTest->xSettings.ulBlockSize;
+        BaseType_t xReturn = pdPASS;
+        BaseType_t xResult;
+
+        if( pxTest->xSettings.xUDP == pdFALSE )
+        {
+            xResult = FreeRTOS_send( pxTest->xData, ucDataBuffer, uxLength, 0 );
+
+            if( xResult > 0 )
+            {
+                pxResult->ullBytes += ( uint64_t ) xResult;
+            }
+            else if( ( xResult == 0 ) || ( xResult == -pdFREERTOS_ERRNO_ENOSPC ) )
+            {
+                /* The send buffer stayed full, try again. */
+            }
+            else
+            {
+                xReturn = pdFAIL;
+            }
+        }
+        else
+        {
+            uint64_t ullAllowed = ( ( ullNow - ullStartTime ) * pxTest->xSettings.ulBandwidth ) / 8000000U;
+
+            if( pxResult->ullBytes >= ullAllowed )
+            {
+                /* Ahead of schedule. */
+                vTaskDelay( 1U );
+            }
+            else
+            {
+                pxResult->ulPackets++;
+                prvWriteUInt32( &( ucDataBuffer[ 0 ] ), ( uint32_t ) ( ullNow / 1000000U ) );
+                prvWriteUInt32( &( ucDataBuffer[ 4 ] ), ( uint32_t ) ( ullNow % 1000000U ) );
+                prvWriteUInt32( &( ucDataBuffer[ 8 ] ), pxResult->ulPackets );
+
+                xResult = FreeRTOS_sendto( pxTest->xData, ucDataBuffer, uxLength, 0,
+                                           &( pxTest->xUDPPeer ), sizeof( pxTest->xUDPPeer ) );
+
+                /* A datagram that could not be sent counts as lost. */
+                pxResult->ullBytes += ( uint64_t ) uxLength;
+
+                if( xResult <= 0 )
+                {
+                    vTaskDelay( 1U );
+                }
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/* Receive data. For UDP, the loss and the jitter are calculated as in RFC 1889. */
+    static BaseType_t prvReceiveBlock( IPerf3Test_t * pxTest )
+    {
+        IPerf3Result_t * pxResult = pxTest->pxResult;
+        BaseType_t xReturn = pdPASS;
+        BaseType_t xResult;
+
+        if( pxTest->xSettings.xUDP == pdFALSE )
+        {
+            xResult = FreeRTOS_recv( pxTest->xData, ucDataBuffer, sizeof( ucDataBuffer ), 0 );
+
+            if( xResult > 0 )
+            {
+                pxResult->ullBytes += ( uint64_t ) xResult;
+            }
+            else if( xResult < 0 )
+            {
+                /* The peer closed the data connection. */
+                xReturn = pdFAIL;
+            }
+            else
+            {
+                /* Time-out. */
+            }
+        }
+        else
+        {
+            struct freertos_sockaddr xAddress;
+            socklen_t xAddressLength = sizeof( xAddress );
+
+            xResult = FreeRTOS_recvfrom( pxTest->xData, ucDataBuffer, sizeof( ucDataBuffer ), 0, &( xAddress ), &( xAddressLength ) );
+
+            if( xResult >= ( BaseType_t ) iperf3UDP_HEADER_SIZE )
+            {
+                uint64_t ullArrival = iperf3TIME_US();
+                uint64_t ullSent = ( ( uint64_t ) prvReadUInt32( &( ucDataBuffer[ 0 ] ) ) * 1000000U ) +
+                                   ( uint64_t ) prvReadUInt32( &( ucDataBuffer[ 4 ] ) );
+                uint32_t ulCount = prvReadUInt32( &( ucDataBuffer[ 8 ] ) );
+                int64_t llTransit = ( int64_t ) ( ullArrival - ullSent );
+
+                pxResult->ullBytes += ( uint64_t ) xResult;
+                pxResult->ulPackets++;
+
+                if( ulCount > pxTest->ulLastCount )
+                {
+                    pxResult->ulLost += ulCount - pxTest->ulLastCount - 1U;
+                    pxTest->ulLastCount = ulCount;
+                }
+                else if( pxResult->ulLost > 0U )
+                {
+                    /* A datagram that arrived out of order, it was counted as lost. */
+                    pxResult->ulLost--;
+                }
+                else
+                {
+                    /* A duplicate. */
+                }
+
+                if( pxResult->ulPackets > 1U )
+                {
+                    int64_t llDelta = llTransit - pxTest->llLastTransit;
+                    uint64_t ullDelta = ( llDelta < 0 ) ? ( uint64_t ) -llDelta : ( uint64_t ) llDelta;
+
+                    /* J = J + ( |D| - J ) / 16, kept as 16 * J. */
+                    pxTest->ullJitter16 = pxTest->ullJitter16 + ullDelta - ( pxTest->ullJitter16 / 16U );
+                }
+
+                pxTest->llLastTransit = llTransit;
+                pxResult->ulJitterUs = ( uint32_t ) ( pxTest->ullJitter16 / 16U );
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/* Transfer data until the duration has passed ( client ), or until the client
+ * sends TEST_END ( server ). */
+    static BaseType_t prvRunTransfer( IPerf3Test_t * pxTest,
+                                      BaseType_t xIsClient )
+    {
+        IPerf3Result_t * pxResult = pxTest->pxResult;
+        uint64_t ullStartTime = iperf3TIME_US();
+        uint64_t ullEndTime = ullStartTime + ( ( uint64_t ) pxTest->xSettings.ulDuration * 1000000U );
+        uint64_t ullNow = ullStartTime;
+        BaseType_t xDataOpen = pdTRUE;
+        BaseType_t xReturn = pdPASS;
+
+        prvSetPollTimeouts( pxTest->xData );
+        prvCPUStart( pxTest );
+
+        for( ; ; )
+        {
+            if( xIsClient != pdFALSE )
+            {
+                if( ( ullNow >= ullEndTime ) || ( xDataOpen == pdFALSE ) )
+                {
+                    break;
+                }
+            }
+            else
+            {
+                int8_t cState;
+                BaseType_t xResult = FreeRTOS_recv( pxTest->xControl, &( cState ), 1U, FREERTOS_MSG_DONTWAIT );
+
+                if( xResult > 0 )
+                {
+                    if( cState != iperf3TEST_END )
+                    {
+                        FreeRTOS_printf( ( "iperf3: unexpected state %d\n", ( int ) cState ) );
+                        xReturn = pdFAIL;
+                    }
+
+                    break;
+                }
+                else if( xResult < 0 )
+                {
+                    xReturn = pdFAIL;
+                    break;
+                }
+                else if( xDataOpen == pdFALSE )
+                {
+                    /* Wait for TEST_END. */
+                    vTaskDelay( iperf3POLL_TICKS );
+                    continue;
+                }
+                else
+                {
+                    /* Continue with the data stream. */
+                }
+            }
+
+            if( pxResult->xSender != pdFALSE )
+            {
+                xDataOpen = prvSendBlock( pxTest, ullStartTime, ullNow );
+            }
+            else
+            {
+                xDataOpen = prvReceiveBlock( pxTest );
+            }
+
+            ullNow = iperf3TIME_US();
+        }
+
+        pxResult->ullDurationUs = iperf3TIME_US() - ullStartTime;
+        prvCPUStop( pxTest );
+
+        #if ( ipconfigTCP_INFO == 1 )
+            if( ( pxResult->xSender != pdFALSE ) && ( pxResult->xUDP == pdFALSE ) )
+            {
+                TCPInfo_t xInfo;
+
+                if( FreeRTOS_GetTCPInfo( pxTest->xData, &( xInfo ) ) == 0 )
+                {
+                    pxResult->ulRetransmits = xInfo.ulRetransmissions;
+                }
+            }
+        #endif
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvMakeResults( const IPerf3Test_t * pxTest )
+    {
+        const IPerf3Result_t * pxResult = pxTest->pxResult;
+        BaseType_t xHasRetransmits = pdFALSE;
+
+        #if ( ipconfigTCP_INFO == 1 )
+            xHasRetransmits = ( ( pxResult->xSender != pdFALSE ) && ( pxResult->xUDP == pdFALSE ) ) ? pdTRUE : pdFALSE;
+        #endif
+
+        ( void ) snprintf( cJSONBuffer, sizeof( cJSONBuffer ),
+                           "{\"cpu_util_total\":%u.%u,\"cpu_util_user\":%u.%u,\"cpu_util_system\":0,"
+                           "\"sender_has_retransmits\":%d,\"streams\":[{\"id\":1,\"bytes\":%llu,"
+                           "\"retransmits\":%u,\"jitter\":%u.%06u,\"errors\":%u,\"packets\":%u,"
+                           "\"start_time\":0,\"end_time\":%u.%06u}]}",
+                           ( unsigned ) ( pxResult->ulCPUPermille / 10U ),
+                           ( unsigned ) ( pxResult->ulCPUPermille % 10U ),
+                           ( unsigned ) ( pxResult->ulCPUPermille / 10U ),
+                           ( unsigned ) ( pxResult->ulCPUPermille % 10U ),
+                           ( int ) xHasRetransmits,
+                           ( unsigned long long ) pxResult->ullBytes,
+                           ( unsigned ) pxResult->ulRetransmits,
+                           ( unsigned ) ( pxResult->ulJitterUs / 1000000U ),
+                           ( unsigned ) ( pxResult->ulJitterUs % 1000000U ),
+                           ( unsigned ) pxResult->ulLost,
+                           ( unsigned ) pxResult->ulPackets,
+                           ( unsigned ) ( pxResult->ullDurationUs / 1000000U ),
+                           ( unsigned ) ( pxResult->ullDurationUs % 1000000U ) );
+    }
+/*-----------------------------------------------------------*/
+
+/* Read the results of the peer. When the peer was the receiver of a UDP test,
+ * its loss and jitter are the ones that matter. */
+    static void prvReadPeerResults( IPerf3Test_t * pxTest )
+    {
+        IPerf3Result_t * pxResult = pxTest->pxResult;
+        uint64_t ullValue;
+        uint32_t ulMicro;
+
+        if( prvJSONGetNumber( cJSONBuffer, "bytes", &( ullValue ), NULL ) != pdFALSE )
+        {
+            pxResult->ullPeerBytes = ullValue;
+        }
+
+        if( ( pxResult->xUDP != pdFALSE ) && ( pxResult->xSender != pdFALSE ) )
+        {
+            if( prvJSONGetNumber( cJSONBuffer, "errors", &( ullValue ), NULL ) != pdFALSE )
+            {
+                pxResult->ulLost = ( uint32_t ) ullValue;
+            }
+
+            if( prvJSONGetNumber( cJSONBuffer, "jitter", &( ullValue ), &( ulMicro ) ) != pdFALSE )
+            {
+                pxResult->ulJitterUs = ( uint32_t ) ( ullValue * 1000000U ) + ulMicro;
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/* The client sends its results first, the server answers with its own. */
+    static BaseType_t prvExchangeResults( IPerf3Test_t * pxTest,
+                                          BaseType_t xIsClient )
+    {
+        BaseType_t xReturn;
+
+        if( xIsClient != pdFALSE )
+        {
+            prvMakeResults( pxTest );
+            xReturn = prvSendJSON( pxTest->xControl, cJSONBuffer );
+
+            if( xReturn == pdPASS )
+            {
+                xReturn = prvReceiveJSON( pxTest->xControl, cJSONBuffer, sizeof( cJSONBuffer ) );
+            }
+
+            if( xReturn == pdPASS )
+            {
+                prvReadPeerResults( pxTest );
+            }
+        }
+        else
+        {
+            xReturn = prvReceiveJSON( pxTest->xControl, cJSONBuffer, sizeof( cJSONBuffer ) );
+
+            if( xReturn == pdPASS )
+            {
+                prvReadPeerResults( pxTest );
+                prvMakeResults( pxTest );
+                xReturn = prvSendJSON( pxTest->xControl, cJSONBuffer );
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/* The server side of a UDP stream: wait for the first datagram of the client
+ * and answer it, so that both sides know each other's address. */
+    static BaseType_t prvAcceptUDPStream( IPerf3Test_t * pxTest )
+    {
+        socklen_t xAddressLength = sizeof( pxTest->xUDPPeer );
+        BaseType_t xResult;
+        BaseType_t xReturn = pdFAIL;
+
+        xResult = FreeRTOS_recvfrom( pxTest->xData, ucDataBuffer, sizeof( ucDataBuffer ), 0, &( pxTest->xUDPPeer ), &( xAddressLength ) );
+
+        if( xResult >= 4 )
+        {
+            /* The value is sent in the byte order of the client, so it is not
+             * checked. The reply is sent in little-endian order, as most hosts use. */
+            ucDataBuffer[ 0 ] = ( uint8_t ) iperf3UDP_CONNECT_REPLY;
+            ucDataBuffer[ 1 ] = ( uint8_t ) ( iperf3UDP_CONNECT_REPLY >> 8 );
+            ucDataBuffer[ 2 ] = ( uint8_t ) ( iperf3UDP_CONNECT_REPLY >> 16 );
+            ucDataBuffer[ 3 ] = ( uint8_t ) ( iperf3UDP_CONNECT_REPLY >> 24 );
+
+            if( FreeRTOS_sendto( pxTest->xData, ucDataBuffer, 4U, 0, &( pxTest->xUDPPeer ), xAddressLength ) == 4 )
+            {
+                xReturn = pdPASS;
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/* The client side of a UDP stream: announce the stream and wait for the reply. */
+    static BaseType_t prvConnectUDPStream( IPerf3Test_t * pxTest )
+    {
+        struct freertos_sockaddr xAddress;
+        socklen_t xAddressLength = sizeof( xAddress );
+        BaseType_t xReturn = pdFAIL;
+
+        ucDataBuffer[ 0 ] = ( uint8_t ) iperf3UDP_CONNECT_MSG;
+        ucDataBuffer[ 1 ] = ( uint8_t ) ( iperf3UDP_CONNECT_MSG >> 8 );
+        ucDataBuffer[ 2 ] = ( uint8_t ) ( iperf3UDP_CONNECT_MSG >> 16 );
+        ucDataBuffer[ 3 ] = ( uint8_t ) ( iperf3UDP_CONNECT_MSG >> 24 );
+
+        if( FreeRTOS_sendto( pxTest->xData, ucDataBuffer, 4U, 0, &( pxTest->xUDPPeer ), sizeof( pxTest->xUDPPeer ) ) == 4 )
+        {
+            if( FreeRTOS_recvfrom( pxTest->xData, ucDataBuffer, sizeof( ucDataBuffer ), 0, &( xAddress ), &( xAddressLength ) ) >= 4 )
+            {
+                uint32_t ulReply = ( ( uint32_t ) ucDataBuffer[ 0 ] ) |
+                                   ( ( ( uint32_t ) ucDataBuffer[ 1 ] ) << 8 ) |
+                                   ( ( ( uint32_t ) ucDataBuffer[ 2 ] ) << 16 ) |
+                                   ( ( ( uint32_t ) ucDataBuffer[ 3 ] ) << 24 );
+
+                /* Accept the reply in either byte order. */
+                if( ( ulReply == iperf3UDP_CONNECT_REPLY ) ||
+                    ( ulReply == iperf3UDP_CONNECT_REPLY_LEGACY ) ||
+                    ( FreeRTOS_ntohl( ulReply ) == iperf3UDP_CONNECT_REPLY ) ||
+                    ( FreeRTOS_ntohl( ulReply ) == iperf3UDP_CONNECT_REPLY_LEGACY ) )
+                {
+                    xReturn = pdPASS;
+                }
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/* Serve one test on an accepted control connection. */
+    static void prvServeTest( Socket_t xListenSocket,
+                              Socket_t xControl,
+                              const struct freertos_sockaddr * pxBindAddress )
+    {
+        IPerf3Test_t xTest;
+        IPerf3Result_t xResult;
+        BaseType_t xReturn;
+        uint64_t ullValue;
+        int8_t cState;
+
+        ( void ) memset( &( xTest ), 0, sizeof( xTest ) );
+        ( void ) memset( &( xResult ), 0, sizeof( xResult ) );
+        xTest.xControl = xControl;
+        xTest.pxResult = &( xResult );
+
+        xReturn = prvReceiveAll( xControl, xTest.cCookie, iperf3COOKIE_SIZE );
+
+        if( xReturn == pdPASS )
+        {
+            xReturn = prvSendState( xControl, iperf3PARAM_EXCHANGE );
+        }
+
+        if( xReturn == pdPASS )
+        {
+            xReturn = prvReceiveJSON( xControl, cJSONBuffer, sizeof( cJSONBuffer ) );
+        }
+
+        if( xReturn == pdPASS )
+        {
+            xTest.xSettings.xUDP = prvJSONIsTrue( cJSONBuffer, "udp" );
+            xTest.xSettings.xReverse = prvJSONIsTrue( cJSONBuffer, "reverse" );
+            xTest.xSettings.ulBlockSize = iperf3BUFFER_SIZE;
+            xTest.xSettings.ulBandwidth = iperf3DEFAULT_BANDWIDTH;
+
+            if( prvJSONGetNumber( cJSONBuffer, "len", &( ullValue ), NULL ) != pdFALSE )
+            {
+                xTest.xSettings.ulBlockSize = ( uint32_t ) ullValue;
+            }
+
+            if( prvJSONGetNumber( cJSONBuffer, "bandwidth", &( ullValue ), NULL ) != pdFALSE )
+            {
+                xTest.xSettings.ulBandwidth = ( uint32_t ) ullValue;
+            }
+
+            /* Only a single stream in one direction is supported. */
+            if( ( ( prvJSONGetNumber( cJSONBuffer, "parallel", &( ullValue ), NULL ) != pdFALSE ) && ( ullValue != 1U ) ) ||
+                ( prvJSONIsTrue( cJSONBuffer, "bidirectional" ) != pdFALSE ) ||
+                ( xTest.xSettings.ulBlockSize < iperf3UDP_HEADER_SIZE ) ||
+                ( xTest.xSettings.ulBlockSize > iperf3BUFFER_SIZE ) )
+            {
+                FreeRTOS_printf( ( "iperf3: test parameters not supported: %s\n", cJSONBuffer ) );
+                ( void ) prvSendState( xControl, iperf3ACCESS_DENIED );
+                xReturn = pdFAIL;
+            }
+        }
+
+        if( xReturn == pdPASS )
+        {
+            xResult.xUDP = xTest.xSettings.xUDP;
+            xResult.xSender = xTest.xSettings.xReverse;
+
+            if( xTest.xSettings.xUDP != pdFALSE )
+            {
+                /* The UDP socket must exist before the client is told to create its stream. */
+                xTest.xData = prvCreateSocket( ( BaseType_t ) pxBindAddress->sin_family, pdTRUE );
+
+                if( ( xTest.xData == NULL ) || ( FreeRTOS_bind( xTest.xData, pxBindAddress, sizeof( *pxBindAddress ) ) != 0 ) )
+                {
+                    xReturn = pdFAIL;
+                }
+
+                if( xReturn == pdPASS )
+                {
+                    xReturn = prvSendState( xControl, iperf3CREATE_STREAMS );
+                }
+
+                if( xReturn == pdPASS )
+                {
+                    xReturn = prvAcceptUDPStream( &( xTest ) );
+                }
+            }
+            else
+            {
+                struct freertos_sockaddr xAddress;
+                socklen_t xAddressLength = sizeof( xAddress );
+                char cCookie[ iperf3COOKIE_SIZE ];
+
+                xReturn = prvSendState( xControl, iperf3CREATE_STREAMS );
+
+                if( xReturn == pdPASS )
+                {
+                    xTest.xData = FreeRTOS_accept( xListenSocket, &( xAddress ), &( xAddressLength ) );
+
+                    if( xTest.xData == FREERTOS_INVALID_SOCKET )
+                    {
+                        xTest.xData = NULL;
+                    }
+
+                    if( ( xTest.xData == NULL ) ||
+                        ( prvReceiveAll( xTest.xData, cCookie, iperf3COOKIE_SIZE ) != pdPASS ) ||
+                        ( memcmp( cCookie, xTest.cCookie, iperf3COOKIE_SIZE ) != 0 ) )
+                    {
+                        xReturn = pdFAIL;
+                    }
+                }
+            }
+        }
+
+        if( xReturn == pdPASS )
+        {
+            xReturn = prvSendState( xControl, iperf3TEST_START );
+        }
+
+        if( xReturn == pdPASS )
+        {
+            xReturn = prvSendState( xControl, iperf3TEST_RUNNING );
+        }
+
+        if( xReturn == pdPASS )
+        {
+            xReturn = prvRunTransfer( &( xTest ), pdFALSE );
+        }
+
+        if( xReturn == pdPASS )
+        {
+            xReturn = prvSendState( xControl, iperf3EXCHANGE_RESULTS );
+        }
+
+        if( xReturn == pdPASS )
+        {
+            xReturn = prvExchangeResults( &( xTest ), pdFALSE );
+        }
+
+        if( xReturn == pdPASS )
+        {
+            xReturn = prvSendState( xControl, iperf3DISPLAY_RESULTS );
+        }
+
+        if( xReturn == pdPASS )
+        {
+            /* The client answers with IPERF_DONE. */
+            xReturn = prvReceiveState( xControl, &( cState ) );
+        }
+
+        prvCloseSocket( &( xTest.xData ) );
+
+        if( xReturn == pdPASS )
+        {
+            vIPerf3PrintResult( &( xResult ) );
+        }
+        else
+        {
+            FreeRTOS_printf( ( "iperf3: test failed\n" ) );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvServerTask( void * pvParameters )
+    {
+        struct freertos_sockaddr xBindAddress;
+        Socket_t xListenSocket;
+        BaseType_t xFamily = FREERTOS_AF_INET;
+
+        #if ( ipconfigUSE_IPv4 == 0 )
+            xFamily = FREERTOS_AF_INET6;
+        #endif
+
+        ( void ) memset( &( xBindAddress ), 0, sizeof( xBindAddress ) );
+        xBindAddress.sin_len = ( uint8_t ) sizeof( xBindAddress );
+        xBindAddress.sin_family = ( uint8_t ) xFamily;
+        xBindAddress.sin_port = FreeRTOS_htons( ( uint16_t ) ( ( uintptr_t ) pvParameters ) );
+
+        xListenSocket = prvCreateSocket( xFamily, pdFALSE );
+        configASSERT( xListenSocket != NULL );
+
+        ( void ) FreeRTOS_bind( xListenSocket, &( xBindAddress ), sizeof( xBindAddress ) );
+        ( void ) FreeRTOS_listen( xListenSocket, 2 );
+
+        FreeRTOS_printf( ( "iperf3: server listening on port %u\n", ( unsigned ) FreeRTOS_ntohs( xBindAddress.sin_port ) ) );
+
+        for( ; ; )
+        {
+            struct freertos_sockaddr xAddress;
+            socklen_t xAddressLength = sizeof( xAddress );
+            Socket_t xControl = FreeRTOS_accept( xListenSocket, &( xAddress ), &( xAddressLength ) );
+
+            if( ( xControl != NULL ) && ( xControl != FREERTOS_INVALID_SOCKET ) )
+            {
+                prvServeTest( xListenSocket, xControl, &( xBindAddress ) );
+                prvCloseSocket( &( xControl ) );
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xIPerf3StartServer( uint16_t usPort,
+                                   uint16_t usStackSize,
+                                   UBaseType_t uxPriority )
+    {
+        uintptr_t uxPort = ( usPort != 0U ) ? ( uintptr_t ) usPort : ( uintptr_t ) iperf3DEFAULT_PORT;
+
+        return xTaskCreate( prvServerTask, "iperf3", usStackSize, ( void * ) uxPort, uxPriority, NULL );
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xIPerf3RunClient( const struct freertos_sockaddr * pxServer,
+                                 const IPerf3Settings_t * pxSettings,
+                                 IPerf3Result_t * pxResult )
+    {
+        IPerf3Test_t xTest;
+        BaseType_t xReturn = pdPASS;
+        BaseType_t xDone = pdFALSE;
+        int8_t cState;
+
+        ( void ) memset( &( xTest ), 0, sizeof( xTest ) );
+        ( void ) memset( pxResult, 0, sizeof( *pxResult ) );
+        xTest.xSettings = *pxSettings;
+        xTest.pxResult = pxResult;
+        xTest.xUDPPeer = *pxServer;
+
+        if( xTest.xSettings.ulDuration == 0U )
+        {
+            xTest.xSettings.ulDuration = iperf3DEFAULT_DURATION;
+        }
+
+        if( xTest.xSettings.ulBandwidth == 0U )
+        {
+            xTest.xSettings.ulBandwidth = iperf3DEFAULT_BANDWIDTH;
+        }
+
+        if( ( xTest.xSettings.ulBlockSize < iperf3UDP_HEADER_SIZE ) || ( xTest.xSettings.ulBlockSize > iperf3BUFFER_SIZE ) )
+        {
+            /* Like iperf3, use a smaller default for UDP to avoid fragmentation. */
+            xTest.xSettings.ulBlockSize = ( xTest.xSettings.xUDP != pdFALSE ) ? 1400U : iperf3BUFFER_SIZE;
+        }
+
+        pxResult->xUDP = xTest.xSettings.xUDP;
+        pxResult->xSender = ( xTest.xSettings.xReverse != pdFALSE ) ? pdFALSE : pdTRUE;
+
+        prvMakeCookie( xTest.cCookie );
+        xTest.xControl = prvCreateSocket( ( BaseType_t ) pxServer->sin_family, pdFALSE );
+
+        if( ( xTest.xControl == NULL ) || ( FreeRTOS_connect( xTest.xControl, pxServer, sizeof( *pxServer ) ) != 0 ) )
+        {
+            FreeRTOS_printf( ( "iperf3: can not connect to the server\n" ) );
+            xReturn = pdFAIL;
+        }
+        else
+        {
+            xReturn = prvSendAll( xTest.xControl, xTest.cCookie, iperf3COOKIE_SIZE );
+        }
+
+        while( ( xReturn == pdPASS ) && ( xDone == pdFALSE ) )
+        {
+            xReturn = prvReceiveState( xTest.xControl, &( cState ) );
+
+            if( xReturn != pdPASS )
+            {
+                break;
+            }
+
+            switch( cState )
+            {
+                case iperf3PARAM_EXCHANGE:
+
+                    if( xTest.xSettings.xUDP != pdFALSE )
+                    {
+                        ( void ) snprintf( cJSONBuffer, sizeof( cJSONBuffer ), "{\"udp\":true,\"bandwidth\":%u,", ( unsigned ) xTest.xSettings.ulBandwidth );
+                    }
+                    else
+                    {
+                        ( void ) snprintf( cJSONBuffer, sizeof( cJSONBuffer ), "{\"tcp\":true," );
+                    }
+
+                    ( void ) snprintf( &( cJSONBuffer[ strlen( cJSONBuffer ) ] ), sizeof( cJSONBuffer ) - strlen( cJSONBuffer ),
+                                       "%s\"omit\":0,\"time\":%u,\"num\":0,\"blockcount\":0,\"parallel\":1,"
+                                       "\"len\":%u,\"pacing_timer\":1000,\"client_version\":\"3.1.3\"}",
+                                       ( xTest.xSettings.xReverse != pdFALSE ) ? "\"reverse\":true," : "",
+                                       ( unsigned ) xTest.xSettings.ulDuration,
+                                       ( unsigned ) xTest.xSettings.ulBlockSize );
+                    xReturn = prvSendJSON( xTest.xControl, cJSONBuffer );
+                    break;
+
+                case iperf3CREATE_STREAMS:
+                    xTest.xData = prvCreateSocket( ( BaseType_t ) pxServer->sin_family, xTest.xSettings.xUDP );
+
+                    if( xTest.xData == NULL )
+                    {
+                        xReturn = pdFAIL;
+                    }
+                    else if( xTest.xSettings.xUDP != pdFALSE )
+                    {
+                        xReturn = prvConnectUDPStream( &( xTest ) );
+                    }
+                    else if( FreeRTOS_connect( xTest.xData, pxServer, sizeof( *pxServer ) ) != 0 )
+                    {
+                        xReturn = pdFAIL;
+                    }
+                    else
+                    {
+                        xReturn = prvSendAll( xTest.xData, xTest.cCookie, iperf3COOKIE_SIZE );
+                    }
+
+                    break;
+
+                case iperf3TEST_START:
+                    break;
+
+                case iperf3TEST_RUNNING:
+                    ( void ) prvRunTransfer( &( xTest ), pdTRUE );
+                    xReturn = prvSendState( xTest.xControl, iperf3TEST_END );
+                    break;
+
+                case iperf3EXCHANGE_RESULTS:
+                    xReturn = prvExchangeResults( &( xTest ), pdTRUE );
+                    break;
+
+                case iperf3DISPLAY_RESULTS:
+                    xReturn = prvSendState( xTest.xControl, iperf3IPERF_DONE );
+                    xDone = pdTRUE;
+                    break;
+
+                default:
+                    /* ACCESS_DENIED, SERVER_TERMINATE, or an error of the server. */
+                    FreeRTOS_printf( ( "iperf3: the server ended the test with state %d\n", ( int ) cState ) );
+                    xReturn = pdFAIL;
+                    break;
+            }
+        }
+
+        prvCloseSocket( &( xTest.xData ) );
+        prvCloseSocket( &( xTest.xControl ) );
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    void vIPerf3PrintResult( const IPerf3Result_t * pxResult )
+    {
+        uint64_t ullDuration = ( pxResult->ullDurationUs != 0U ) ? pxResult->ullDurationUs : 1U;
+        /* Bits per microsecond is Mbit/s, keep two decimals. */
+        uint32_t ulRate = ( uint32_t ) ( ( pxResult->ullBytes * 800U ) / ullDuration );
+        /* The CPU time used per MB that was transferred. */
+        uint32_t ulCPUPerMB = 0U;
+
+        if( pxResult->ullBytes != 0U )
+        {
+            ulCPUPerMB = ( uint32_t ) ( ( ullDuration * pxResult->ulCPUPermille * 1000U ) / pxResult->ullBytes );
+        }
+
+        FreeRTOS_printf( ( "iperf3 %s %s: %u KB in %u.%03u s = %u.%02u Mbit/s, peer reports %u KB\n",
+                           ( pxResult->xUDP != pdFALSE ) ? "UDP" : "TCP",
+                           ( pxResult->xSender != pdFALSE ) ? "sender" : "receiver",
+                           ( unsigned ) ( pxResult->ullBytes / 1024U ),
+                           ( unsigned ) ( ullDuration / 1000000U ),
+                           ( unsigned ) ( ( ullDuration / 1000U ) % 1000U ),
+                           ( unsigned ) ( ulRate / 100U ),
+                           ( unsigned ) ( ulRate % 100U ),
+                           ( unsigned ) ( pxResult->ullPeerBytes / 1024U ) ) );
+
+        if( pxResult->xUDP != pdFALSE )
+        {
+            FreeRTOS_printf( ( "iperf3 UDP: %u datagrams, %u lost, jitter %u us\n",
+                               ( unsigned ) pxResult->ulPackets,
+                               ( unsigned ) pxResult->ulLost,
+                               ( unsigned ) pxResult->ulJitterUs ) );
+        }
+        else
+        {
+            FreeRTOS_printf( ( "iperf3 TCP: %u retransmissions\n", ( unsigned ) pxResult->ulRetransmits ) );
+        }
+
+        if( pxResult->ulCPUPermille != 0U )
+        {
+            FreeRTOS_printf( ( "iperf3 CPU: %u.%u %%, %u us per MB\n",
+                               ( unsigned ) ( pxResult->ulCPUPermille / 10U ),
+                               ( unsigned ) ( pxResult->ulCPUPermille % 10U ),
+                               ( unsigned ) ulCPUPerMB ) );
+        }
+
+        /* In case FreeRTOS_printf() is defined as empty. */
+        ( void ) ulRate;
+        ( void ) ulCPUPerMB;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ( ipconfigUSE_TCP == 1 ) */
@@ -0,0 +1,770 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/*
+ * @file tcp_latency.c
+ * @brief A request/response benchmark that reports percentiles of the
+ *        round-trip time of TCP and UDP messages.
+ * See tools/tcp_utilities/tcp_latency.md for further description.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include <FreeRTOS.h>
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+#include "FreeRTOS_IP_Private.h"
+
+#include "tcp_latency.h"
+
+#if ( ipconfigUSE_TCP == 1 )
+
+/* The clock used for all measurements, in microseconds. When the trace hooks
+ * are used, it is also called from the IP-task and from the driver.
+ * ullGetHighResolutionTime() must be supplied by the application. */
+    #ifndef latencyTIME_US
+        extern uint64_t ullGetHighResolutionTime( void );
+        #define latencyTIME_US()    ullGetHighResolutionTime()
+    #endif
+
+    #define latencyDEFAULT_COUNT         1000UL
+    #define latencyDEFAULT_TIMEOUT_MS    1000UL
+
+/* A request starts with a 32-bit sequence number. */
+    #define latencyHEADER_SIZE           4U
+
+/* A histogram has 32 buckets for the values 0 to 31, and 16 buckets for every
+ * next power of 2. A value is counted with a resolution of 1/16th at worst. */
+    #define latencySUB_BUCKETS           16U
+    #define latencyHISTOGRAM_SIZE        ( ( 28U * latencySUB_BUCKETS ) + latencySUB_BUCKETS )
+
+/* The round trip and every phase have their own histogram. */
+    #define latencyHISTOGRAM_COUNT       ( 1U + ( size_t ) eLatencyPhaseCount )
+
+    typedef struct xLATENCY_HISTOGRAM
+    {
+        uint32_t ulCount;                              /* The number of values. */
+        uint32_t ulMin;                                /* The smallest value. */
+        uint32_t ulMax;                                /* The largest value. */
+        uint64_t ullTotal;                             /* The sum of all values, for the mean. */
+        uint32_t ulBuckets[ latencyHISTOGRAM_SIZE ];   /* The number of values per bucket. */
+    } LatencyHistogram_t;
+
+/* Only one test can run at a time. Index 0 holds the round-trip times. */
+    static LatencyHistogram_t xHistograms[ latencyHISTOGRAM_COUNT ];
+
+/* The requests and replies of the client. */
+    static uint8_t ucClientBuffer[ latencyBUFFER_SIZE ];
+
+    #if ( latencyUSE_TRACE_HOOKS == 1 )
+
+/* The moments that divide a round trip into phases. */
+        typedef enum eLATENCY_POINT
+        {
+            eLatencyPointSend = 0,  /* The application calls send(). */
+            eLatencyPointOutput,    /* The IP-task passes the first frame to the driver. */
+            eLatencyPointDriverRx,  /* The driver receives the next frame. */
+            eLatencyPointIPRx,      /* The IP-task takes the eNetworkRxEvent. */
+            eLatencyPointIPDone,    /* The IP-task has processed that event. */
+            eLatencyPointCount
+        } eLatencyPoint_t;
+
+/* While armed, the trace hooks fill in the time points one after the other.
+ * Frames of other traffic can disturb the measurement, so use a quiet network. */
+        static volatile BaseType_t xProbeArmed = pdFALSE;
+        static volatile uint64_t ullProbe[ eLatencyPointCount ];
+    #endif /* ( latencyUSE_TRACE_HOOKS == 1 ) */
+
+/*-----------------------------------------------------------*/
+
+    static size_t prvBucketIndex( uint32_t ulValue )
+    {
+        size_t uxIndex;
+
+        if( ulValue < ( 2U * latencySUB_BUCKETS ) )
+        {
+            uxIndex = ( size_t ) ulValue;
+        }
+        else
+        {
+            uint32_t ulShift = 0U;
+
+            /* Keep the 5 most significant bits. */
+            while( ( ulValue >> ulShift ) >= ( 2U * latencySUB_BUCKETS ) )
+            {
+                ulShift++;
+            }
+
+            uxIndex = ( size_t ) ( ( ulShift * latencySUB_BUCKETS ) + ( ulValue >> ulShift ) );
+        }
+
+        return uxIndex;
+    }
+/*-----------------------------------------------------------*/
+
+/* The highest value that is counted in a bucket. */
+    static uint32_t prvBucketHighest( size_t uxIndex )
+    {
+        uint32_t ulValue;
+
+        if( uxIndex < ( 2U * latencySUB_BUCKETS ) )
+        {
+            ulValue = ( uint32_t ) uxIndex;
+        }
+        else
+        {
+            uint32_t ulShift = ( uint32_t ) ( uxIndex / latencySUB_BUCKETS ) - 1U;
+            uint64_t ullNext = ( uint64_t ) ( ( uxIndex % latencySUB_BUCKETS ) + latencySUB_BUCKETS + 1U ) << ulShift;
+
+            ulValue = ( uint32_t ) ( ullNext - 1U );
+        }
+
+        return ulValue;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvHistogramAdd( LatencyHistogram_t * pxHistogram,
+                                 uint64_t ullValue )
+    {
+        uint32_t ulValue = ( ullValue > 0xFFFFFFFFU ) ? 0xFFFFFFFFU : ( uint32_t ) ullValue;
+
+        if( ( pxHistogram->ulCount == 0U ) || ( ulValue < pxHistogram->ulMin ) )
+        {
+            pxHistogram->ulMin = ulValue;
+        }
+
+        if( ulValue > pxHistogram->ulMax )
+        {
+            pxHistogram->ulMax = ulValue;
+        }
+
+        pxHistogram->ulCount++;
+        pxHistogram->ullTotal += ulValue;
+        pxHistogram->ulBuckets[ prvBucketIndex( ulValue ) ]++;
+    }
+/*-----------------------------------------------------------*/
+
+/* Return the value below which a fraction of the values is found. The
+ * fraction is given per 100000. */
+    static uint32_t prvHistogramPercentile( const LatencyHistogram_t * pxHistogram,
+                                            uint32_t ulFraction )
+    {
+        uint32_t ulRank = ( uint32_t ) ( ( ( ( uint64_t ) pxHistogram->ulCount * ulFraction ) + 99999U ) / 100000U );
+        uint32_t ulSeen = 0U;
+        uint32_t ulValue = pxHistogram->ulMax;
+        size_t uxIndex;
+
+        for( uxIndex = 0U; uxIndex < latencyHISTOGRAM_SIZE; uxIndex++ )
+        {
+            ulSeen += pxHistogram->ulBuckets[ uxIndex ];
+
+            if( ( ulSeen != 0U ) && ( ulSeen >= ulRank ) )
+            {
+                ulValue = prvBucketHighest( uxIndex );
+                break;
+            }
+        }
+
+        /* The bucket may reach beyond the actual values. */
+        if( ulValue > pxHistogram->ulMax )
+        {
+            ulValue = pxHistogram->ulMax;
+        }
+
+        if( ulValue < pxHistogram->ulMin )
+        {
+            ulValue = pxHistogram->ulMin;
+        }
+
+        return ulValue;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvHistogramStats( const LatencyHistogram_t * pxHistogram,
+                                   LatencyStats_t * pxStats )
+    {
+        ( void ) memset( pxStats, 0, sizeof( *pxStats ) );
+
+        if( pxHistogram->ulCount != 0U )
+        {
+            pxStats->ulCount = pxHistogram->ulCount;
+            pxStats->ulMin = pxHistogram->ulMin;
+            pxStats->ulMax = pxHistogram->ulMax;
+            pxStats->ulMean = ( uint32_t ) ( pxHistogram->ullTotal / pxHistogram->ulCount );
+            pxStats->ulP50 = prvHistogramPercentile( pxHistogram, 50000U );
+            pxStats->ulP99 = prvHistogramPercentile( pxHistogram, 99000U );
+            pxStats->ulP999 = prvHistogramPercentile( pxHistogram, 99900U );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( latencyUSE_TRACE_HOOKS == 1 )
+
+        void vLatencyTraceOutput( void )
+        {
+            if( ( xProbeArmed != pdFALSE ) && ( ullProbe[ eLatencyPointOutput ] == 0U ) )
+            {
+                ullProbe[ eLatencyPointOutput ] = latencyTIME_US();
+            }
+        }
+/*-----------------------------------------------------------*/
+
+        void vLatencyTraceDriverReceive( void )
+        {
+            if( ( xProbeArmed != pdFALSE ) &&
+                ( ullProbe[ eLatencyPointOutput ] != 0U ) &&
+                ( ullProbe[ eLatencyPointDriverRx ] == 0U ) )
+            {
+                ullProbe[ eLatencyPointDriverRx ] = latencyTIME_US();
+            }
+        }
+/*-----------------------------------------------------------*/
+
+        void vLatencyTraceEventReceived( BaseType_t xEvent )
+        {
+            if( ( xProbeArmed != pdFALSE ) &&
+                ( xEvent == ( BaseType_t ) eNetworkRxEvent ) &&
+                ( ullProbe[ eLatencyPointDriverRx ] != 0U ) &&
+                ( ullProbe[ eLatencyPointIPRx ] == 0U ) )
+            {
+                ullProbe[ eLatencyPointIPRx ] = latencyTIME_US();
+            }
+        }
+/*-----------------------------------------------------------*/
+
+        void vLatencyTraceEventProcessed( BaseType_t xEvent )
+        {
+            if( ( xProbeArmed != pdFALSE ) &&
+                ( xEvent == ( BaseType_t ) eNetworkRxEvent ) &&
+                ( ullProbe[ eLatencyPointIPRx ] != 0U ) &&
+                ( ullProbe[ eLatencyPointIPDone ] == 0U ) )
+            {
+                ullProbe[ eLatencyPointIPDone ] = latencyTIME_US();
+            }
+        }
+/*-----------------------------------------------------------*/
+
+/* Count the phases of a round trip, but only when all time points were seen
+ * in the right order. */
+        static void prvAddPhases( uint64_t ullReplyTime )
+        {
+            BaseType_t xIndex;
+            BaseType_t xComplete = pdTRUE;
+
+            for( xIndex = 1; xIndex < ( BaseType_t ) eLatencyPointCount; xIndex++ )
+            {
+                if( ( ullProbe[ xIndex ] == 0U ) || ( ullProbe[ xIndex ] < ullProbe[ xIndex - 1 ] ) )
+                {
+                    xComplete = pdFALSE;
+                    break;
+                }
+            }
+
+            if( ( xComplete != pdFALSE ) && ( ullReplyTime >= ullProbe[ eLatencyPointIPDone ] ) )
+            {
+                for( xIndex = 0; xIndex < ( BaseType_t ) eLatencyPhaseCount; xIndex++ )
+                {
+                    uint64_t ullEnd = ( xIndex < ( BaseType_t ) eLatencyApplication ) ? ullProbe[ xIndex + 1 ] : ullReplyTime;
+
+                    prvHistogramAdd( &( xHistograms[ xIndex + 1 ] ), ullEnd - ullProbe[ xIndex ] );
+                }
+            }
+        }
+
+    #endif /* ( latencyUSE_TRACE_HOOKS == 1 ) */
+/*-----------------------------------------------------------*/
+
+/* Record the time of sending, and let the trace hooks follow the request. */
+    static void prvStartProbe( uint64_t ullSendTime )
+    {
+        #if ( latencyUSE_TRACE_HOOKS == 1 )
+        {
+            BaseType_t xIndex;
+
+            xProbeArmed = pdFALSE;
+
+            for( xIndex = 0; xIndex < ( BaseType_t ) eLatencyPointCount; xIndex++ )
+            {
+                ullProbe[ xIndex ] = 0U;
+            }
+
+            ullProbe[ eLatencyPointSend ] = ullSendTime;
+            xProbeArmed = pdTRUE;
+        }
+        #else
+        {
+            ( void ) ullSendTime;
+        }
+        #endif
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvStopProbe( BaseType_t xHasReply,
+                              uint64_t ullReplyTime )
+    {
+        #if ( latencyUSE_TRACE_HOOKS == 1 )
+        {
+            xProbeArmed = pdFALSE;
+
+            if( xHasReply != pdFALSE )
+            {
+                prvAddPhases( ullReplyTime );
+            }
+        }
+        #else
+        {
+            ( void ) xHasReply;
+            ( void ) ullReplyTime;
+        }
+        #endif
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvWriteSequence( uint8_t * pucBuffer,
+                                  uint32_t ulSequence )
+    {
+        pucBuffer[ 0 ] = ( uint8_t ) ( ulSequence >> 24 );
+        pucBuffer[ 1 ] = ( uint8_t ) ( ulSequence >> 16 );
+        pucBuffer[ 2 ] = ( uint8_t ) ( ulSequence >> 8 );
+        pucBuffer[ 3 ] = ( uint8_t ) ulSequence;
+    }
+/*-----------------------------------------------------------*/
+
+    static uint32_t prvReadSequence( const uint8_t * pucBuffer )
+    {
+        return ( ( ( uint32_t ) pucBuffer[ 0 ] ) << 24 ) |
+               ( ( ( uint32_t ) pucBuffer[ 1 ] ) << 16 ) |
+               ( ( ( uint32_t ) pucBuffer[ 2 ] ) << 8 ) |
+               ( ( uint32_t ) pucBuffer[ 3 ] );
+    }
+/*-----------------------------------------------------------*/
+
+/* Send a request and wait for the reply with the same sequence number. */
+    static BaseType_t prvRoundTrip( Socket_t xSocket,
+                                    const struct freertos_sockaddr * pxPeer,
+                                    const LatencySettings_t * pxSettings,
+                                    uint32_t ulSequence )
+    {
+        size_t uxLength = ( size_t ) pxSettings->ulMessageSize;
+        size_t uxDone = 0U;
+        BaseType_t xReturn = pdFAIL;
+        BaseType_t xResult;
+
+        prvWriteSequence( ucClientBuffer, ulSequence );
+
+        if( pxSettings->xUDP != pdFALSE )
+        {
+            if( FreeRTOS_sendto( xSocket, ucClientBuffer, uxLength, 0, pxPeer, sizeof( *pxPeer ) ) > 0 )
+            {
+                struct freertos_sockaddr xAddress;
+                socklen_t xAddressLength = sizeof( xAddress );
+
+                /* Late replies to earlier requests are skipped. */
+                for( ; ; )
+                {
+                    xResult = FreeRTOS_recvfrom( xSocket, ucClientBuffer, sizeof( ucClientBuffer ), 0, &( xAddress ), &( xAddressLength ) );
+
+                    if( xResult <= 0 )
+                    {
+                        break;
+                    }
+
+                    if( ( xResult >= ( BaseType_t ) latencyHEADER_SIZE ) && ( prvReadSequence( ucClientBuffer ) == ulSequence ) )
+                    {
+                        xReturn = pdPASS;
+                        break;
+                    }
+                }
+            }
+        }
+        else
+        {
+            while( uxDone < uxLength )
+            {
+                xResult = FreeRTOS_send( xSocket, &( ucClientBuffer[ uxDone ] ), uxLength - uxDone, 0 );
+
+                if( xResult <= 0 )
+                {
+                    break;
+                }
+
+                uxDone += ( size_t ) xResult;
+            }
+
+            if( uxDone == uxLength )
+            {
+                uxDone = 0U;
+
+                /* A TCP reply may arrive in pieces. */
+                while( uxDone < uxLength )
+                {
+                    xResult = FreeRTOS_recv( xSocket, &( ucClientBuffer[ uxDone ] ), uxLength - uxDone, 0 );
+
+                    if( xResult <= 0 )
+                    {
+                        break;
+                    }
+
+                    uxDone += ( size_t ) xResult;
+                }
+
+                if( ( uxDone == uxLength ) && ( prvReadSequence( ucClientBuffer ) == ulSequence ) )
+                {
+                    xReturn = pdPASS;
+                }
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/* Wait until the next request is due, when a rate was given. */
+    static void prvWaitForSchedule( uint64_t ullStartTime,
+                                    const LatencySettings_t * pxSettings,
+                                    uint32_t ulSequence )
+    {
+        if( pxSettings->ulRate != 0U )
+        {
+            uint64_t ullDue = ullStartTime + ( ( ( uint64_t ) ulSequence * 1000000U ) / pxSettings->ulRate );
+            uint64_t ullNow = latencyTIME_US();
+
+            while( ullNow < ullDue )
+            {
+                TickType_t xTicks = pdMS_TO_TICKS( ( uint32_t ) ( ( ullDue - ullNow ) / 1000U ) );
+
+                if( xTicks == 0U )
+                {
+                    /* Less than a clock tick to go. */
+                    break;
+                }
+
+                vTaskDelay( xTicks );
+                ullNow = latencyTIME_US();
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xLatencyRunClient( const struct freertos_sockaddr * pxPeer,
+                                  const LatencySettings_t * pxSettings,
+                                  LatencyResult_t * pxResult )
+    {
+        LatencySettings_t xSettings = *pxSettings;
+        Socket_t xSocket;
+        BaseType_t xReturn = pdPASS;
+        TickType_t xTimeout;
+        uint64_t ullStartTime;
+        uint32_t ulSequence;
+        size_t uxIndex;
+
+        ( void ) memset( pxResult, 0, sizeof( *pxResult ) );
+        ( void ) memset( xHistograms, 0, sizeof( xHistograms ) );
+
+        if( xSettings.ulMessageSize < latencyHEADER_SIZE )
+        {
+            xSettings.ulMessageSize = latencyHEADER_SIZE;
+        }
+
+        if( xSettings.ulMessageSize > latencyBUFFER_SIZE )
+        {
+            xSettings.ulMessageSize = latencyBUFFER_SIZE;
+        }
+
+        if( xSettings.ulCount == 0U )
+        {
+            xSettings.ulCount = latencyDEFAULT_COUNT;
+        }
+
+        if( xSettings.ulTimeoutMs == 0U )
+        {
+            xSettings.ulTimeoutMs = latencyDEFAULT_TIMEOUT_MS;
+        }
+
+        pxResult->xUDP = xSettings.xUDP;
+        pxResult->ulMessageSize = xSettings.ulMessageSize;
+
+        if( xSettings.xUDP != pdFALSE )
+        {
+            xSocket = FreeRTOS_socket( ( BaseType_t ) pxPeer->sin_family, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+        }
+        else
+        {
+            xSocket = FreeRTOS_socket( ( BaseType_t ) pxPeer->sin_family, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+        }
+
+        if( xSocket == FREERTOS_INVALID_SOCKET )
+        {
+            FreeRTOS_printf( ( "latency: can not create a socket\n" ) );
+            xReturn = pdFAIL;
+        }
+        else
+        {
+            xTimeout = pdMS_TO_TICKS( xSettings.ulTimeoutMs );
+            ( void ) FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_RCVTIMEO, &( xTimeout ), sizeof( xTimeout ) );
+            ( void ) FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_SNDTIMEO, &( xTimeout ), sizeof( xTimeout ) );
+
+            if( ( xSettings.xUDP == pdFALSE ) && ( FreeRTOS_connect( xSocket, pxPeer, sizeof( *pxPeer ) ) != 0 ) )
+            {
+                FreeRTOS_printf( ( "latency: can not connect to the peer\n" ) );
+                xReturn = pdFAIL;
+            }
+        }
+
+        if( xReturn == pdPASS )
+        {
+            ( void ) memset( ucClientBuffer, 0x55, sizeof( ucClientBuffer ) );
+            ullStartTime = latencyTIME_US();
+
+            for( ulSequence = 0U; ulSequence < xSettings.ulCount; ulSequence++ )
+            {
+                uint64_t ullSendTime;
+                uint64_t ullReplyTime;
+                BaseType_t xHasReply;
+
+                prvWaitForSchedule( ullStartTime, &( xSettings ), ulSequence );
+
+                ullSendTime = latencyTIME_US();
+                prvStartProbe( ullSendTime );
+                xHasReply = prvRoundTrip( xSocket, pxPeer, &( xSettings ), ulSequence );
+                ullReplyTime = latencyTIME_US();
+                prvStopProbe( xHasReply, ullReplyTime );
+
+                pxResult->ulSent++;
+
+                if( xHasReply != pdFALSE )
+                {
+                    prvHistogramAdd( &( xHistograms[ 0 ] ), ullReplyTime - ullSendTime );
+                }
+                else
+                {
+                    pxResult->ulLost++;
+
+                    if( xSettings.xUDP == pdFALSE )
+                    {
+                        /* A TCP connection that fails can not be continued. */
+                        FreeRTOS_printf( ( "latency: the TCP connection failed\n" ) );
+                        xReturn = pdFAIL;
+                        break;
+                    }
+                }
+            }
+        }
+
+        if( xSocket != FREERTOS_INVALID_SOCKET )
+        {
+            ( void ) FreeRTOS_shutdown( xSocket, FREERTOS_SHUT_RDWR );
+            ( void ) FreeRTOS_closesocket( xSocket );
+        }
+
+        prvHistogramStats( &( xHistograms[ 0 ] ), &( pxResult->xRoundTrip ) );
+
+        for( uxIndex = 0U; uxIndex < ( size_t ) eLatencyPhaseCount; uxIndex++ )
+        {
+            prvHistogramStats( &( xHistograms[ uxIndex + 1U ] ), &( pxResult->xPhases[ uxIndex ] ) );
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvPrintStats( const char * pcName,
+                               const LatencyStats_t * pxStats )
+    {
+        FreeRTOS_printf( ( "  %-12s: n %u min %u p50 %u p99 %u p99.9 %u max %u mean %u us\n",
+                           pcName,
+                           ( unsigned ) pxStats->ulCount,
+                           ( unsigned ) pxStats->ulMin,
+                           ( unsigned ) pxStats->ulP50,
+                           ( unsigned ) pxStats->ulP99,
+                           ( unsigned ) pxStats->ulP999,
+                           ( unsigned ) pxStats->ulMax,
+                           ( unsigned ) pxStats->ulMean ) );
+
+        /* In case FreeRTOS_printf() is defined as empty. */
+        ( void ) pcName;
+        ( void ) pxStats;
+    }
+/*-----------------------------------------------------------*/
+
+    void vLatencyPrintResult( const LatencyResult_t * pxResult )
+    {
+        static const char * const pcPhaseNames[ eLatencyPhaseCount ] =
+        {
+            "stack tx",
+            "network",
+            "driver rx",
+            "stack rx",
+            "application"
+        };
+        size_t uxIndex;
+
+        FreeRTOS_printf( ( "latency %s %u bytes: %u requests, %u lost\n",
+                           ( pxResult->xUDP != pdFALSE ) ? "UDP" : "TCP",
+                           ( unsigned ) pxResult->ulMessageSize,
+                           ( unsigned ) pxResult->ulSent,
+                           ( unsigned ) pxResult->ulLost ) );
+
+        prvPrintStats( "round trip", &( pxResult->xRoundTrip ) );
+
+        for( uxIndex = 0U; uxIndex < ( size_t ) eLatencyPhaseCount; uxIndex++ )
+        {
+            /* The phases are only known when the trace hooks were called. */
+            if( pxResult->xPhases[ uxIndex ].ulCount != 0U )
+            {
+                prvPrintStats( pcPhaseNames[ uxIndex ], &( pxResult->xPhases[ uxIndex ] ) );
+            }
+        }
+
+        ( void ) pcPhaseNames;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvReflectorBind( Socket_t xSocket,
+                                        uint16_t usPort )
+    {
+        struct freertos_sockaddr xBindAddress;
+
+        ( void ) memset( &( xBindAddress ), 0, sizeof( xBindAddress ) );
+        xBindAddress.sin_len = ( uint8_t ) sizeof( xBindAddress );
+        xBindAddress.sin_family = FREERTOS_AF_INET;
+        #if ( ipconfigUSE_IPv4 == 0 )
+            xBindAddress.sin_family = FREERTOS_AF_INET6;
+        #endif
+        xBindAddress.sin_port = FreeRTOS_htons( usPort );
+
+        return FreeRTOS_bind( xSocket, &( xBindAddress ), sizeof( xBindAddress ) );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvUDPReflectorTask( void * pvParameters )
+    {
+        static uint8_t ucBuffer[ latencyBUFFER_SIZE ];
+        Socket_t xSocket;
+        TickType_t xTimeout = portMAX_DELAY;
+
+        #if ( ipconfigUSE_IPv4 != 0 )
+            xSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+        #else
+            xSocket = FreeRTOS_socket( FREERTOS_AF_INET6, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+        #endif
+        configASSERT( xSocket != FREERTOS_INVALID_SOCKET );
+
+        ( void ) FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_RCVTIMEO, &( xTimeout ), sizeof( xTimeout ) );
+        ( void ) prvReflectorBind( xSocket, ( uint16_t ) ( ( uintptr_t ) pvParameters ) );
+
+        for( ; ; )
+        {
+            struct freertos_sockaddr xAddress;
+            socklen_t xAddressLength = sizeof( xAddress );
+            BaseType_t xResult = FreeRTOS_recvfrom( xSocket, ucBuffer, sizeof( ucBuffer ), 0, &( xAddress ), &( xAddressLength ) );
+
+            if( xResult > 0 )
+            {
+                ( void ) FreeRTOS_sendto( xSocket, ucBuffer, ( size_t ) xResult, 0, &( xAddress ), xAddressLength );
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvTCPReflectorTask( void * pvParameters )
+    {
+        static uint8_t ucBuffer[ latencyBUFFER_SIZE ];
+        Socket_t xListenSocket;
+        TickType_t xTimeout = portMAX_DELAY;
+
+        #if ( ipconfigUSE_IPv4 != 0 )
+            xListenSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+        #else
+            xListenSocket = FreeRTOS_socket( FREERTOS_AF_INET6, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+        #endif
+        configASSERT( xListenSocket != FREERTOS_INVALID_SOCKET );
+
+        ( void ) FreeRTOS_setsockopt( xListenSocket, 0, FREERTOS_SO_RCVTIMEO, &( xTimeout ), sizeof( xTimeout ) );
+        ( void ) prvReflectorBind( xListenSocket, ( uint16_t ) ( ( uintptr_t ) pvParameters ) );
+        ( void ) FreeRTOS_listen( xListenSocket, 1 );
+
+        for( ; ; )
+        {
+            struct freertos_sockaddr xAddress;
+            socklen_t xAddressLength = sizeof( xAddress );
+            Socket_t xSocket = FreeRTOS_accept( xListenSocket, &( xAddress ), &( xAddressLength ) );
+
+            if( ( xSocket == NULL ) || ( xSocket == FREERTOS_INVALID_SOCKET ) )
+            {
+                continue;
+            }
+
+            /* Echo until the client closes the connection. */
+            for( ; ; )
+            {
+                BaseType_t xResult = FreeRTOS_recv( xSocket, ucBuffer, sizeof( ucBuffer ), 0 );
+
+                if( xResult < 0 )
+                {
+                    break;
+                }
+
+                if( ( xResult > 0 ) && ( FreeRTOS_send( xSocket, ucBuffer, ( size_t ) xResult, 0 ) < 0 ) )
+                {
+                    break;
+                }
+            }
+
+            ( void ) FreeRTOS_shutdown( xSocket, FREERTOS_SHUT_RDWR );
+            ( void ) FreeRTOS_closesocket( xSocket );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xLatencyStartReflector( uint16_t usPort,
+                                       uint16_t usStackSize,
+                                       UBaseType_t uxPriority )
+    {
+        uintptr_t uxPort = ( usPort != 0U ) ? ( uintptr_t ) usPort : ( uintptr_t ) latencyDEFAULT_PORT;
+        BaseType_t xReturn;
+
+        xReturn = xTaskCreate( prvUDPReflectorTask, "lat_udp", usStackSize, ( void * ) uxPort, uxPriority, NULL );
+
+        if( xReturn == pdPASS )
+        {
+            xReturn = xTaskCreate( prvTCPReflectorTask, "lat_tcp", usStackSize, ( void * ) uxPort, uxPriority, NULL );
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ( ipconfigUSE_TCP == 1 ) */
@@ -0,0 +1,730 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * @file tcp_pcapng.c
+ * @brief Streams the frames passed to iptraceDUMP_PACKET() as pcapng to a file,
+ *        a ring of files, or a pipe. Only for the Linux port.
+ * See tools/tcp_utilities/tcp_pcapng.md for further description.
+ *
+ * The capturing tasks only copy a frame into a buffer. A pthread writes the
+ * buffered frames to the file, so that the IP-task never waits for file I/O.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include <FreeRTOS.h>
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_Stream_Buffer.h"
+
+#include "tcp_pcapng.h"
+
+#if ( ipconfigUSE_PCAPNG_CAPTURE != 0 )
+
+    #include <pthread.h>
+    #include <signal.h>
+    #include <time.h>
+    #include <sys/stat.h>
+
+    #include <utils/wait_for_event.h>
+
+/* The block types, option codes and constants of the pcapng format. */
+    #define pcapngBLOCK_SECTION_HEADER          0x0A0D0D0AUL
+    #define pcapngBLOCK_INTERFACE_DESCRIPTION   0x00000001UL
+    #define pcapngBLOCK_ENHANCED_PACKET         0x00000006UL
+    #define pcapngBYTE_ORDER_MAGIC              0x1A2B3C4DUL
+    #define pcapngLINKTYPE_ETHERNET             1U
+
+    #define pcapngOPTION_END                    0U
+    #define pcapngOPTION_SHB_USERAPPL           4U
+    #define pcapngOPTION_IF_NAME                2U
+    #define pcapngOPTION_IF_TSRESOL             9U
+    #define pcapngOPTION_EPB_FLAGS              2U
+    #define pcapngOPTION_EPB_DROPCOUNT          4U
+
+    #define pcapngEPB_FLAG_INBOUND              1UL
+    #define pcapngEPB_FLAG_OUTBOUND             2UL
+
+/* The largest frame that is stored. */
+    #define pcapngMAX_FRAME_SIZE                ( ( size_t ) ipTOTAL_ETHERNET_FRAME_SIZE )
+
+/* The largest block: the fixed fields and options of an enhanced packet
+ * block, plus a frame padded to 32 bits. */
+    #define pcapngMAX_BLOCK_SIZE                ( 64U + pcapngMAX_FRAME_SIZE + 3U )
+
+/* The maximum time that the writer thread sleeps before it checks the buffer. */
+    #define pcapngWRITER_WAIT_MS                ( 500 )
+
+/* The name written in the section header and interface description blocks. */
+    #define pcapngAPPLICATION_NAME              "FreeRTOS+TCP"
+
+/* Every frame in the buffer is preceded by this record. */
+    typedef struct xPCAPNG_RECORD
+    {
+        uint64_t ullTimeUs;  /* The time of capture, in microseconds since 1970. */
+        uint32_t ulLength;   /* The length of the frame. */
+        uint32_t ulCaptured; /* The number of bytes that follow the record. */
+        uint32_t ulDropped;  /* The number of frames dropped just before this one. */
+        uint32_t ulIncoming; /* Non-zero for a received frame. */
+    } PcapngRecord_t;
+
+/* The buffer between the capturing tasks and the writer thread. The tasks add
+ * frames while the scheduler is suspended, the writer only reads. */
+    static StreamBuffer_t * pxPcapngBuffer = NULL;
+
+/* Used to wake up the writer thread. */
+    static struct event * pxPcapngEvent = NULL;
+
+    static pthread_t xPcapngThread;
+
+/* A copy of the settings, and of the file name. */
+    static PcapngConfig_t xPcapngConfig;
+    static char * pcPcapngFileName = NULL;
+
+    static PcapngStats_t xPcapngStats;
+
+/* The tasks change the capture counters while the scheduler is suspended. The
+ * writer thread is not stopped by that, so the counters that it changes,
+ * 'ulWritten', 'ulWriteErrors' and 'ulFiles', are protected by this mutex. */
+    static pthread_mutex_t xPcapngStatsMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Only changed while the scheduler is suspended. */
+    static volatile BaseType_t xPcapngRunning = pdFALSE;
+
+/* The number of frames dropped since the last frame that was buffered. */
+    static uint32_t ulPcapngPendingDrops = 0U;
+
+/* The following variables are only used by the writer thread. */
+    static FILE * pxPcapngFile = NULL;
+    static BaseType_t xPcapngIsStream = pdFALSE;
+    static size_t uxPcapngFileSize = 0U;
+    static uint32_t ulPcapngFilePackets = 0U;
+    static uint32_t ulPcapngFileNumber = 0U;
+    static uint8_t ucPcapngFrame[ pcapngMAX_FRAME_SIZE ];
+    static uint8_t ucPcapngBlock[ pcapngMAX_BLOCK_SIZE ];
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Check a frame against the filter flags and the filter function.
+ */
+    static BaseType_t prvPcapngAccept( const uint8_t * pucBuffer,
+                                       size_t uxLength,
+                                       BaseType_t xIncoming )
+    {
+        uint32_t ulFilter = xPcapngConfig.ulFilter;
+        uint32_t ulFlag;
+        uint16_t usFrameType;
+        BaseType_t xAccept = pdTRUE;
+
+        if( ( ulFilter & pcapngFILTER_DIRECTIONS ) != 0U )
+        {
+            ulFlag = ( xIncoming != pdFALSE ) ? pcapngFILTER_INCOMING : pcapngFILTER_OUTGOING;
+
+            if( ( ulFilter & ulFlag ) == 0U )
+            {
+                xAccept = pdFALSE;
+            }
+        }
+
+        if( ( xAccept != pdFALSE ) && ( ( ulFilter & pcapngFILTER_FRAME_TYPES ) != 0U ) )
+        {
+            ulFlag = pcapngFILTER_OTHER;
+
+            if( uxLength >= ipSIZE_OF_ETH_HEADER )
+            {
+                usFrameType = ( uint16_t ) ( ( ( uint16_t ) pucBuffer[ 12 ] << 8 ) | pucBuffer[ 13 ] );
+
+                switch( usFrameType )
+                {
+                    case 0x0806U:
+                        ulFlag = pcapngFILTER_ARP;
+                        break;
+
+                    case 0x0800U:
+                        ulFlag = pcapngFILTER_IPv4;
+                        break;
+
+                    case 0x86DDU:
+                        ulFlag = pcapngFILTER_IPv6;
+                        break;
+
+                    default:
+                        /* Other frame types. */
+                        break;
+                }
+            }
+
+            if( ( ulFilter & ulFlag ) == 0U )
+            {
+                xAccept = pdFALSE;
+            }
+        }
+
+        if( ( xAccept != pdFALSE ) && ( xPcapngConfig.fnFilter != NULL ) )
+        {
+            xAccept = xPcapngConfig.fnFilter( pucBuffer, uxLength, xIncoming );
+        }
+
+        return xAccept;
+    }
+/*-----------------------------------------------------------*/
+
+    void vPcapngCapture( const uint8_t * pucBuffer,
+                         size_t uxLength,
+                         BaseType_t xIncoming )
+    {
+        PcapngRecord_t xRecord;
+        struct timespec xNow;
+        size_t uxCaptured;
+
+        if( ( xPcapngRunning != pdFALSE ) && ( pucBuffer != NULL ) )
+        {
+            if( prvPcapngAccept( pucBuffer, uxLength, xIncoming ) == pdFALSE )
+            {
+                vTaskSuspendAll();
+                {
+                    xPcapngStats.ulFiltered++;
+                }
+                ( void ) xTaskResumeAll();
+            }
+            else
+            {
+                uxCaptured = FreeRTOS_min_size_t( uxLength, pcapngMAX_FRAME_SIZE );
+
+                if( ( xPcapngConfig.uxSnapLength != 0U ) && ( uxCaptured > xPcapngConfig.uxSnapLength ) )
+                {
+                    uxCaptured = xPcapngConfig.uxSnapLength;
+                }
+
+                ( void ) clock_gettime( CLOCK_REALTIME, &xNow );
+                xRecord.ullTimeUs = ( ( uint64_t ) xNow.tv_sec * 1000000U ) + ( ( uint64_t ) xNow.tv_nsec / 1000U );
+                xRecord.ulLength = ( uint32_t ) uxLength;
+                xRecord.ulCaptured = ( uint32_t ) uxCaptured;
+                xRecord.ulIncoming = ( xIncoming != pdFALSE ) ? 1U : 0U;
+
+                vTaskSuspendAll();
+                {
+                    /* Check again, vPcapngStop() might have been called. */
+                    if( ( xPcapngRunning != pdFALSE ) &&
+                        ( uxStreamBufferGetSpace( pxPcapngBuffer ) >= ( sizeof( xRecord ) + uxCaptured ) ) )
+                    {
+                        xRecord.ulDropped = ulPcapngPendingDrops;
+                        ulPcapngPendingDrops = 0U;
+
+                        /* The writer waits until both the record and the
+                         * frame are present. */
+                        ( void ) uxStreamBufferAdd( pxPcapngBuffer, 0U, ( const uint8_t * ) &( xRecord ), sizeof( xRecord ) );
+                        ( void ) uxStreamBufferAdd( pxPcapngBuffer, 0U, pucBuffer, uxCaptured );
+                        xPcapngStats.ulCaptured++;
+
+                        /* Signal while suspended, vPcapngStop() deletes the event. */
+                        event_signal( pxPcapngEvent );
+                    }
+                    else
+                    {
+                        ulPcapngPendingDrops++;
+                        xPcapngStats.ulDropped++;
+                    }
+                }
+                ( void ) xTaskResumeAll();
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Store a 16-bit value in the block being built.
+ */
+    static size_t prvPcapngPut16( size_t uxOffset,
+                                  uint16_t usValue )
+    {
+        ( void ) memcpy( &( ucPcapngBlock[ uxOffset ] ), &( usValue ), sizeof( usValue ) );
+
+        return uxOffset + sizeof( usValue );
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Store a 32-bit value in the block being built.
+ */
+    static size_t prvPcapngPut32( size_t uxOffset,
+                                  uint32_t ulValue )
+    {
+        ( void ) memcpy( &( ucPcapngBlock[ uxOffset ] ), &( ulValue ), sizeof( ulValue ) );
+
+        return uxOffset + sizeof( ulValue );
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Store an option, or data, padded to a multiple of 32 bits. When usCode is
+ * zero, only the data is stored.
+ */
+    static size_t prvPcapngPutPadded( size_t uxOffset,
+                                      uint16_t usCode,
+                                      const void * pvData,
+                                      size_t uxLength )
+    {
+        size_t uxNext = uxOffset;
+
+        if( usCode != 0U )
+        {
+            uxNext = prvPcapngPut16( uxNext, usCode );
+            uxNext = prvPcapngPut16( uxNext, ( uint16_t ) uxLength );
+        }
+
+        ( void ) memcpy( &( ucPcapngBlock[ uxNext ] ), pvData, uxLength );
+        uxNext += uxLength;
+
+        while( ( uxNext & 3U ) != 0U )
+        {
+            ucPcapngBlock[ uxNext ] = 0U;
+            uxNext++;
+        }
+
+        return uxNext;
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Increment one of the counters that are changed by the writer thread.
+ */
+    static void prvPcapngCountWriter( uint32_t * pulCounter )
+    {
+        ( void ) pthread_mutex_lock( &( xPcapngStatsMutex ) );
+        ( *pulCounter )++;
+        ( void ) pthread_mutex_unlock( &( xPcapngStatsMutex ) );
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Close a block that was built from offset 0: add the end-of-options, fill
+ * in the lengths, and write it. Returns pdPASS when the block was written.
+ */
+    static BaseType_t prvPcapngWriteBlock( size_t uxOffset,
+                                           BaseType_t xHasOptions )
+    {
+        size_t uxLength = uxOffset;
+        BaseType_t xReturn = pdFAIL;
+
+        if( xHasOptions != pdFALSE )
+        {
+            uxLength = prvPcapngPut32( uxLength, pcapngOPTION_END );
+        }
+
+        /* The trailing block length. */
+        uxLength += sizeof( uint32_t );
+        ( void ) prvPcapngPut32( 4U, ( uint32_t ) uxLength );
+        ( void ) prvPcapngPut32( uxLength - sizeof( uint32_t ), ( uint32_t ) uxLength );
+
+        if( pxPcapngFile != NULL )
+        {
+            if( fwrite( ucPcapngBlock, 1U, uxLength, pxPcapngFile ) == uxLength )
+            {
+                uxPcapngFileSize += uxLength;
+                xReturn = pdPASS;
+            }
+            else
+            {
+                prvPcapngCountWriter( &( xPcapngStats.ulWriteErrors ) );
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Write the section header and interface description blocks, which start
+ * every file.
+ */
+    static void prvPcapngWriteHeaders( void )
+    {
+        size_t uxOffset;
+        uint8_t ucResolution = 6U; /* Microseconds. */
+        uint32_t ulSnapLength = ( uint32_t ) pcapngMAX_FRAME_SIZE;
+
+        if( ( xPcapngConfig.uxSnapLength != 0U ) && ( xPcapngConfig.uxSnapLength < pcapngMAX_FRAME_SIZE ) )
+        {
+            ulSnapLength = ( uint32_t ) xPcapngConfig.uxSnapLength;
+        }
+
+        /* Section header block, written in the byte order of the host. */
+        uxOffset = prvPcapngPut32( 0U, pcapngBLOCK_SECTION_HEADER );
+        uxOffset = prvPcapngPut32( uxOffset, 0U );
+        uxOffset = prvPcapngPut32( uxOffset, pcapngBYTE_ORDER_MAGIC );
+        uxOffset = prvPcapngPut16( uxOffset, 1U );
+        uxOffset = prvPcapngPut16( uxOffset, 0U );
+        /* The section length is not known: -1 as a 64-bit value. */
+        uxOffset = prvPcapngPut32( uxOffset, 0xFFFFFFFFUL );
+        uxOffset = prvPcapngPut32( uxOffset, 0xFFFFFFFFUL );
+        uxOffset = prvPcapngPutPadded( uxOffset, pcapngOPTION_SHB_USERAPPL, pcapngAPPLICATION_NAME, sizeof( pcapngAPPLICATION_NAME ) - 1U );
+        ( void ) prvPcapngWriteBlock( uxOffset, pdTRUE );
+
+        /* Interface description block for the only interface. */
+        uxOffset = prvPcapngPut32( 0U, pcapngBLOCK_INTERFACE_DESCRIPTION );
+        uxOffset = prvPcapngPut32( uxOffset, 0U );
+        uxOffset = prvPcapngPut16( uxOffset, pcapngLINKTYPE_ETHERNET );
+        uxOffset = prvPcapngPut16( uxOffset, 0U );
+        uxOffset = prvPcapngPut32( uxOffset, ulSnapLength );
+        uxOffset = prvPcapngPutPadded( uxOffset, pcapngOPTION_IF_NAME, pcapngAPPLICATION_NAME, sizeof( pcapngAPPLICATION_NAME ) - 1U );
+        uxOffset = prvPcapngPutPadded( uxOffset, pcapngOPTION_IF_TSRESOL, &( ucResolution ), sizeof( ucResolution ) );
+        ( void ) prvPcapngWriteBlock( uxOffset, pdTRUE );
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Make the name of a file in the ring: "capture.pcapng" becomes
+ * "capture_00003.pcapng".
+ */
+    static void prvPcapngFileName( char * pcBuffer,
+                                   size_t uxBufferSize,
+                                   uint32_t ulNumber )
+    {
+        const char * pcDot = strrchr( pcPcapngFileName, '.' );
+        const char * pcSlash = strrchr( pcPcapngFileName, '/' );
+        int iStemLength;
+
+        if( ( pcDot == NULL ) || ( ( pcSlash != NULL ) && ( pcDot < pcSlash ) ) )
+        {
+            pcDot = pcPcapngFileName + strlen( pcPcapngFileName );
+        }
+
+        iStemLength = ( int ) ( pcDot - pcPcapngFileName );
+        ( void ) snprintf( pcBuffer, uxBufferSize, "%.*s_%05u%s", iStemLength, pcPcapngFileName, ( unsigned ) ulNumber, pcDot );
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Open the first file, or close the current file and open the next file of
+ * the ring. The oldest file of the ring is removed.
+ */
+    static void prvPcapngOpenFile( void )
+    {
+        char pcName[ 256 ];
+        struct stat xStat;
+        BaseType_t xRotate;
+
+        if( pxPcapngFile != NULL )
+        {
+            ( void ) fclose( pxPcapngFile );
+            pxPcapngFile = NULL;
+        }
+
+        if( strcmp( pcPcapngFileName, "-" ) == 0 )
+        {
+            pxPcapngFile = stdout;
+            xPcapngIsStream = pdTRUE;
+        }
+        else
+        {
+            /* A named pipe, e.g. read by "wireshark -k -i", is never rotated. */
+            xPcapngIsStream = ( ( stat( pcPcapngFileName, &( xStat ) ) == 0 ) && S_ISFIFO( xStat.st_mode ) ) ? pdTRUE : pdFALSE;
+            xRotate = ( ( xPcapngIsStream == pdFALSE ) && ( xPcapngConfig.uxMaxFileSize != 0U ) ) ? pdTRUE : pdFALSE;
+
+            if( xRotate != pdFALSE )
+            {
+                if( ( xPcapngConfig.uxFileCount != 0U ) && ( ulPcapngFileNumber >= xPcapngConfig.uxFileCount ) )
+                {
+                    prvPcapngFileName( pcName, sizeof( pcName ), ulPcapngFileNumber - ( uint32_t ) xPcapngConfig.uxFileCount );
+                    ( void ) remove( pcName );
+                }
+
+                prvPcapngFileName( pcName, sizeof( pcName ), ulPcapngFileNumber );
+            }
+            else
+            {
+                ( void ) snprintf( pcName, sizeof( pcName ), "%s", pcPcapngFileName );
+            }
+
+            /* Opening a named pipe blocks until there is a reader. */
+            pxPcapngFile = fopen( pcName, "wb" );
+        }
+
+        uxPcapngFileSize = 0U;
+        ulPcapngFilePackets = 0U;
+
+        if( pxPcapngFile != NULL )
+        {
+            ulPcapngFileNumber++;
+            prvPcapngCountWriter( &( xPcapngStats.ulFiles ) );
+            prvPcapngWriteHeaders();
+        }
+        else
+        {
+            prvPcapngCountWriter( &( xPcapngStats.ulWriteErrors ) );
+            FreeRTOS_printf( ( "tcp_pcapng: can not open '%s'\n", pcName ) );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Write one frame as an enhanced packet block.
+ */
+    static void prvPcapngWritePacket( const PcapngRecord_t * pxRecord )
+    {
+        size_t uxOffset;
+        uint32_t ulFlags = ( pxRecord->ulIncoming != 0U ) ? pcapngEPB_FLAG_INBOUND : pcapngEPB_FLAG_OUTBOUND;
+        uint64_t ullDropped = pxRecord->ulDropped;
+
+        uxOffset = prvPcapngPut32( 0U, pcapngBLOCK_ENHANCED_PACKET );
+        uxOffset = prvPcapngPut32( uxOffset, 0U );
+        uxOffset = prvPcapngPut32( uxOffset, 0U ); /* Interface ID. */
+        uxOffset = prvPcapngPut32( uxOffset, ( uint32_t ) ( pxRecord->ullTimeUs >> 32 ) );
+        uxOffset = prvPcapngPut32( uxOffset, ( uint32_t ) ( pxRecord->ullTimeUs & 0xFFFFFFFFUL ) );
+        uxOffset = prvPcapngPut32( uxOffset, pxRecord->ulCaptured );
+        uxOffset = prvPcapngPut32( uxOffset, pxRecord->ulLength );
+        uxOffset = prvPcapngPutPadded( uxOffset, 0U, ucPcapngFrame, pxRecord->ulCaptured );
+        uxOffset = prvPcapngPutPadded( uxOffset, pcapngOPTION_EPB_FLAGS, &( ulFlags ), sizeof( ulFlags ) );
+
+        if( ullDropped != 0U )
+        {
+            uxOffset = prvPcapngPutPadded( uxOffset, pcapngOPTION_EPB_DROPCOUNT, &( ullDropped ), sizeof( ullDropped ) );
+        }
+
+        if( ( xPcapngIsStream == pdFALSE ) &&
+            ( xPcapngConfig.uxMaxFileSize != 0U ) &&
+            ( ulPcapngFilePackets != 0U ) &&
+            ( ( uxPcapngFileSize + uxOffset ) > xPcapngConfig.uxMaxFileSize ) )
+        {
+            /* The headers overwrite the block that was built, so build it
+             * again in the new file, which has no packets yet. */
+            prvPcapngOpenFile();
+            prvPcapngWritePacket( pxRecord );
+        }
+        else if( prvPcapngWriteBlock( uxOffset, pdTRUE ) == pdPASS )
+        {
+            ulPcapngFilePackets++;
+            prvPcapngCountWriter( &( xPcapngStats.ulWritten ) );
+        }
+        else
+        {
+            /* The error was counted. */
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Write all complete frames that are in the buffer.
+ */
+    static void prvPcapngDrain( void )
+    {
+        PcapngRecord_t xRecord;
+        size_t uxSize;
+        BaseType_t xWritten = pdFALSE;
+
+        for( ; ; )
+        {
+            uxSize = uxStreamBufferGetSize( pxPcapngBuffer );
+
+            if( uxSize < sizeof( xRecord ) )
+            {
+                break;
+            }
+
+            ( void ) uxStreamBufferGet( pxPcapngBuffer, 0U, ( uint8_t * ) &( xRecord ), sizeof( xRecord ), pdTRUE );
+
+            if( uxSize < ( sizeof( xRecord ) + xRecord.ulCaptured ) )
+            {
+                /* The frame is still being added. */
+                break;
+            }
+
+            ( void ) uxStreamBufferGet( pxPcapngBuffer, 0U, NULL, sizeof( xRecord ), pdFALSE );
+            ( void ) uxStreamBufferGet( pxPcapngBuffer, 0U, ucPcapngFrame, xRecord.ulCaptured, pdFALSE );
+            prvPcapngWritePacket( &( xRecord ) );
+            xWritten = pdTRUE;
+        }
+
+        if( ( xWritten != pdFALSE ) && ( pxPcapngFile != NULL ) )
+        {
+            ( void ) fflush( pxPcapngFile );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * The writer thread. It is a Linux thread, so it may not call any FreeRTOS
+ * function.
+ */
+    static void * prvPcapngWriterThread( void * pvParam )
+    {
+        sigset_t xSignals;
+        BaseType_t xRunning;
+
+        ( void ) pvParam;
+
+        /* Block all signals, so that the POSIX port does not treat this thread
+         * as a FreeRTOS task. */
+        ( void ) sigfillset( &( xSignals ) );
+        ( void ) pthread_sigmask( SIG_SETMASK, &( xSignals ), NULL );
+
+        prvPcapngOpenFile();
+
+        for( ; ; )
+        {
+            /* Read the flag before draining, so that the frames added before
+             * vPcapngStop() are written. */
+            xRunning = xPcapngRunning;
+            prvPcapngDrain();
+
+            if( xRunning == pdFALSE )
+            {
+                break;
+            }
+
+            ( void ) event_wait_timed( pxPcapngEvent, pcapngWRITER_WAIT_MS );
+        }
+
+        if( ( pxPcapngFile != NULL ) && ( pxPcapngFile != stdout ) )
+        {
+            ( void ) fclose( pxPcapngFile );
+        }
+
+        pxPcapngFile = NULL;
+
+        return NULL;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xPcapngStart( const PcapngConfig_t * pxConfig )
+    {
+        BaseType_t xReturn = pdFAIL;
+        size_t uxNameLength;
+
+        if( ( xPcapngRunning == pdFALSE ) && ( pxConfig != NULL ) && ( pxConfig->pcFileName != NULL ) )
+        {
+            uxNameLength = strlen( pxConfig->pcFileName ) + 1U;
+            pcPcapngFileName = ( char * ) malloc( uxNameLength );
+            pxPcapngBuffer = ( StreamBuffer_t * ) malloc( sizeof( *pxPcapngBuffer ) - sizeof( pxPcapngBuffer->ucArray ) + pcapngBUFFER_SIZE + 1U );
+            pxPcapngEvent = event_create();
+
+            if( ( pcPcapngFileName != NULL ) && ( pxPcapngBuffer != NULL ) && ( pxPcapngEvent != NULL ) )
+            {
+                ( void ) memcpy( pcPcapngFileName, pxConfig->pcFileName, uxNameLength );
+                ( void ) memcpy( &( xPcapngConfig ), pxConfig, sizeof( xPcapngConfig ) );
+                xPcapngConfig.pcFileName = pcPcapngFileName;
+
+                ( void ) memset( pxPcapngBuffer, 0, sizeof( *pxPcapngBuffer ) - sizeof( pxPcapngBuffer->ucArray ) );
+                pxPcapngBuffer->LENGTH = pcapngBUFFER_SIZE + 1U;
+
+                ( void ) memset( &( xPcapngStats ), 0, sizeof( xPcapngStats ) );
+                ulPcapngPendingDrops = 0U;
+                ulPcapngFileNumber = 0U;
+                xPcapngRunning = pdTRUE;
+
+                if( pthread_create( &( xPcapngThread ), NULL, prvPcapngWriterThread, NULL ) == 0 )
+                {
+                    xReturn = pdPASS;
+                }
+                else
+                {
+                    xPcapngRunning = pdFALSE;
+                }
+            }
+
+            if( xReturn != pdPASS )
+            {
+                FreeRTOS_printf( ( "xPcapngStart: failed to start a capture\n" ) );
+
+                if( pxPcapngEvent != NULL )
+                {
+                    event_delete( pxPcapngEvent );
+                    pxPcapngEvent = NULL;
+                }
+
+                free( pxPcapngBuffer );
+                pxPcapngBuffer = NULL;
+                free( pcPcapngFileName );
+                pcPcapngFileName = NULL;
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    void vPcapngStop( void )
+    {
+        BaseType_t xWasRunning;
+
+        /* No frames will be added after this. */
+        vTaskSuspendAll();
+        {
+            xWasRunning = xPcapngRunning;
+            xPcapngRunning = pdFALSE;
+        }
+        ( void ) xTaskResumeAll();
+
+        if( xWasRunning != pdFALSE )
+        {
+            event_signal( pxPcapngEvent );
+            ( void ) pthread_join( xPcapngThread, NULL );
+
+            event_delete( pxPcapngEvent );
+            pxPcapngEvent = NULL;
+            free( pxPcapngBuffer );
+            pxPcapngBuffer = NULL;
+            free( pcPcapngFileName );
+            pcPcapngFileName = NULL;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    void vPcapngGetStats( PcapngStats_t * pxStats )
+    {
+        if( pxStats != NULL )
+        {
+            vTaskSuspendAll();
+            {
+                ( void ) memcpy( pxStats, &( xPcapngStats ), sizeof( *pxStats ) );
+            }
+            ( void ) xTaskResumeAll();
+
+            /* The writer thread does not know about the scheduler. */
+            ( void ) pthread_mutex_lock( &( xPcapngStatsMutex ) );
+            {
+                pxStats->ulWritten = xPcapngStats.ulWritten;
+                pxStats->ulWriteErrors = xPcapngStats.ulWriteErrors;
+                pxStats->ulFiles = xPcapngStats.ulFiles;
+            }
+            ( void ) pthread_mutex_unlock( &( xPcapngStatsMutex ) );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_PCAPNG_CAPTURE != 0 */
@@ -0,0 +1,193 @@
+#!/usr/bin/env python3
+# FreeRTOS+TCP
+# Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+#
+# SPDX-License-Identifier: MIT
+
+"""Decode the binary records of tcp_trace_ring.c into a readable timeline.
+
+The input is a sequence of blocks, each made of a TraceRingHeader_t followed
+by a number of TraceRingRecord_t's. Blocks are read from a file written by
+xTraceRingWriteFile(), or received as UDP packets sent by xTraceRingSendUDP().
+
+Examples:
+    tcp_trace_decode.py trace.bin
+    tcp_trace_decode.py --udp 5555
+    tcp_trace_decode.py --csv trace.bin > trace.csv
+"""
+
+import argparse
+import socket
+import struct
+import sys
+
+TRACE_MAGIC = 0x54524331
+HEADER_SIZE = 20
+RECORD_SIZE = 16
+
+# Must be kept in sync with TraceRingEvent_t in include/tcp_trace_ring.h.
+# The second field tells how the parameters are shown.
+EVENTS = {
+    1: ("NETWORK_EVENT_RECEIVED", "event"),
+    2: ("NETWORK_INTERFACE_INPUT", "frame"),
+    3: ("NETWORK_INTERFACE_OUTPUT", "frame"),
+    4: ("NETWORK_INTERFACE_RECEIVE", None),
+    5: ("NETWORK_INTERFACE_TRANSMIT", None),
+    6: ("NETWORK_BUFFER_OBTAINED", "pointer"),
+    7: ("NETWORK_BUFFER_OBTAINED_FROM_ISR", "pointer"),
+    8: ("NETWORK_BUFFER_RELEASED", "pointer"),
+    9: ("FAILED_TO_OBTAIN_NETWORK_BUFFER", None),
+    10: ("FAILED_TO_OBTAIN_NETWORK_BUFFER_FROM_ISR", None),
+    11: ("STACK_TX_EVENT_LOST", "event"),
+    12: ("ETHERNET_RX_EVENT_LOST", None),
+    13: ("WAITING_FOR_TX_DMA_DESCRIPTOR", None),
+    14: ("SENDING_UDP_PACKET", "ip"),
+    15: ("NO_BUFFER_FOR_SENDTO", None),
+    16: ("RECVFROM_TIMEOUT", None),
+    17: ("ARP_PACKET_RECEIVED", None),
+    18: ("CREATING_ARP_REQUEST", "ip"),
+    19: ("PACKET_DROPPED_TO_GENERATE_ARP", "ip"),
+    20: ("DELAYED_ARP_BUFFER_FULL", None),
+    21: ("DELAYED_ARP_REQUEST_STARTED", None),
+    22: ("DELAYED_ARP_TIMER_EXPIRED", None),
+    23: ("DELAYED_ND_BUFFER_FULL", None),
+    24: ("DELAYED_ND_REQUEST_STARTED", None),
+    25: ("DELAYED_ND_TIMER_EXPIRED", None),
+    26: ("ICMP_PACKET_RECEIVED", None),
+    27: ("SENDING_PING_REPLY", "ip"),
+    28: ("NETWORK_DOWN", None),
+}
+
+TRACE_USER = 0x8000
+
+# Must be kept in sync with eIPEvent_t in FreeRTOS_IP_Private.h.
+IP_EVENTS = [
+    "eNetworkDownEvent", "eNetworkRxEvent", "eNetworkTxEvent", "eARPTimerEvent",
+    "eNDTimerEvent", "eStackTxEvent", "eDHCPEvent", "eTCPTimerEvent",
+    "eTCPAcceptEvent", "eTCPNetStat", "eSocketBindEvent", "eSocketCloseEvent",
+    "eSocketSelectEvent", "eSocketSignalEvent", "eSocketSetDeleteEvent",
+    "eSocketTxBatchEvent", "eMulticastGroupEvent", "eSocketRxGrowEvent",
+    "eSocketUDPHeaderEvent",
+]
+
+FRAME_TYPES = {0x0800: "IPv4", 0x0806: "ARP", 0x86DD: "IPv6"}
+
+
+def format_parameters(kind, endian, p1, p2):
+    """Show the two parameters of a record in the way that suits the event."""
+    if kind == "event":
+        if p1 == 0xFFFFFFFF:
+            return "eNoEvent"
+        return IP_EVENTS[p1] if p1 < len(IP_EVENTS) else "event %u" % p1
+    if kind == "frame":
+        return "len %u %s" % (p1, FRAME_TYPES.get(p2, "type 0x%04x" % p2))
+    if kind == "pointer":
+        return "0x%08x" % p1
+    if kind == "ip":
+        # The address is in network order, as it was stored in memory.
+        return socket.inet_ntoa(struct.pack(endian + "I", p1))
+    return ""
+
+
+def read_blocks(data):
+    """Yield ( endian, header, records ) for every block in a byte string."""
+    offset = 0
+    while offset + HEADER_SIZE <= len(data):
+        for endian in ("<", ">"):
+            if struct.unpack_from(endian + "I", data, offset)[0] == TRACE_MAGIC:
+                break
+        else:
+            raise ValueError("no trace header at offset %u" % offset)
+
+        _, version, record_size, hz, count, lost = struct.unpack_from(
+            endian + "IHHIII", data, offset)
+        if version != 1 or record_size != RECORD_SIZE:
+            raise ValueError("unsupported version %u or record size %u" % (version, record_size))
+        offset += HEADER_SIZE
+
+        records = []
+        for _ in range(count):
+            if offset + RECORD_SIZE > len(data):
+                raise ValueError("truncated block")
+            records.append(struct.unpack_from(endian + "IHHII", data, offset))
+            offset += RECORD_SIZE
+        yield endian, (hz, lost), records
+
+
+class Timeline:
+    """Turn records into lines of text, keeping track of time and gaps."""
+
+    def __init__(self, csv):
+        self.csv = csv
+        self.first = None
+        self.previous = None
+        self.sequence = None
+        if csv:
+            print("time_us,delta_us,sequence,event,parameter1,parameter2,text")
+
+    def add(self, endian, hz, lost, record):
+        stamp, event_id, sequence, p1, p2 = record
+
+        if lost and not self.csv:
+            print("--- %u records lost ---" % lost)
+        elif self.sequence is not None and sequence != ((self.sequence + 1) & 0xFFFF) and not self.csv:
+            print("--- gap in sequence numbers ---")
+        self.sequence = sequence
+
+        if self.first is None:
+            self.first = stamp
+            self.previous = stamp
+        # The time stamps are 32-bit and wrap around.
+        elapsed = ((stamp - self.first) & 0xFFFFFFFF) * 1e6 / hz
+        delta = ((stamp - self.previous) & 0xFFFFFFFF) * 1e6 / hz
+        self.previous = stamp
+
+        if event_id >= TRACE_USER:
+            name, kind = "USER+%u" % (event_id - TRACE_USER), None
+        else:
+            name, kind = EVENTS.get(event_id, ("EVENT_%u" % event_id, None))
+        text = format_parameters(kind, endian, p1, p2)
+        if kind is None and (p1 or p2):
+            text = "%u %u" % (p1, p2)
+
+        if self.csv:
+            print("%.1f,%.1f,%u,%s,%u,%u,%s" % (elapsed, delta, sequence, name, p1, p2, text))
+        else:
+            print("%12.1f %+10.1f  %-40s %s" % (elapsed, delta, name, text))
+
+    def add_data(self, data):
+        for endian, (hz, lost), records in read_blocks(data):
+            for index, record in enumerate(records):
+                self.add(endian, hz or 1, lost if index == 0 else 0, record)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("file", nargs="?", help="a file written by xTraceRingWriteFile()")
+    parser.add_argument("--udp", type=int, metavar="PORT",
+                        help="receive the packets sent by xTraceRingSendUDP() on this port")
+    parser.add_argument("--csv", action="store_true", help="write CSV instead of a table")
+    args = parser.parse_args()
+
+    timeline = Timeline(args.csv)
+
+    if args.udp is not None:
+        sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        sock.bind(("", args.udp))
+        try:
+            while True:
+                data, _ = sock.recvfrom(65536)
+                timeline.add_data(data)
+                sys.stdout.flush()
+        except KeyboardInterrupt:
+            pass
+    elif args.file is not None:
+        with open(args.file, "rb") as handle:
+            timeline.add_data(handle.read())
+    else:
+        parser.error("give a file name or --udp PORT")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,253 @@
+/*
+ * FreeRTOS+TCP
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * @file tcp_trace_ring.c
+ * @brief Implements the iptrace macros by writing compact binary records
+ *        into a ring buffer, which can be dumped over UDP or to a file.
+ * See tools/tcp_utilities/tcp_trace_ring.md for further description.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include <FreeRTOS.h>
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+#include "FreeRTOS_IP_Private.h"
+
+#include "tcp_trace_ring.h"
+
+#if ( ipconfigUSE_TRACE_RING != 0 )
+
+/* The time stamp of a record. By default the tick count is used. For a better
+ * resolution, define it as e.g. a free-running cycle counter, together with
+ * its frequency in traceRING_TIMESTAMP_HZ. It will be called from interrupts
+ * as well. */
+    #ifndef traceRING_TIMESTAMP
+        #define traceRING_TIMESTAMP()    ( ( uint32_t ) xTaskGetTickCountFromISR() )
+        #define traceRING_TIMESTAMP_HZ    ( ( uint32_t ) configTICK_RATE_HZ )
+    #endif
+
+/* The number of records that are sent in one UDP packet. Every call to
+ * xTraceRingSendUDP() or xTraceRingWriteFile() keeps one block of this size on
+ * the stack of the calling task. */
+    #ifndef traceRING_RECORDS_PER_PACKET
+        #define traceRING_RECORDS_PER_PACKET    32U
+    #endif
+
+    #define traceRING_INDEX_MASK    ( ( uint32_t ) ipconfigTRACE_RING_RECORD_COUNT - 1U )
+
+/* The ring. Writers and the reader only access it with interrupts masked,
+ * for the time needed to copy a single record, so no locks are needed. */
+    static TraceRingRecord_t xTraceRing[ ipconfigTRACE_RING_RECORD_COUNT ];
+
+/* The number of records written since start-up, wraps around. */
+    static uint32_t ulTraceWriteIndex;
+
+/* The number of records read since start-up, wraps around. */
+    static uint32_t ulTraceReadIndex;
+
+/* The number of records that were overwritten before they could be read. */
+    static uint32_t ulTraceLostCount;
+
+/* One block of records, as it is sent or written. It lives on the stack of
+ * the caller, so that concurrent dumps do not overwrite each other's block. */
+    typedef struct xTRACE_RING_BLOCK
+    {
+        TraceRingHeader_t xHeader;
+        TraceRingRecord_t xRecords[ traceRING_RECORDS_PER_PACKET ];
+    } TraceRingBlock_t;
+
+/*-----------------------------------------------------------*/
+
+    void vTraceRingRecord( uint16_t usEventID,
+                           uint32_t ulParameter1,
+                           uint32_t ulParameter2 )
+    {
+        TraceRingRecord_t * pxRecord;
+        UBaseType_t uxSavedInterruptStatus;
+
+        uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+        {
+            pxRecord = &( xTraceRing[ ulTraceWriteIndex & traceRING_INDEX_MASK ] );
+            pxRecord->ulTimeStamp = traceRING_TIMESTAMP();
+            pxRecord->usEventID = usEventID;
+            pxRecord->usSequence = ( uint16_t ) ulTraceWriteIndex;
+            pxRecord->ulParameter1 = ulParameter1;
+            pxRecord->ulParameter2 = ulParameter2;
+            ulTraceWriteIndex++;
+        }
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+    }
+/*-----------------------------------------------------------*/
+
+    size_t uxTraceRingRead( TraceRingHeader_t * pxHeader,
+                            TraceRingRecord_t * pxRecords,
+                            size_t uxMaxCount )
+    {
+        size_t uxCount = 0U;
+        uint32_t ulLost = 0U;
+        uint32_t ulAvailable;
+        BaseType_t xDone = pdFALSE;
+        UBaseType_t uxSavedInterruptStatus;
+
+        while( ( uxCount < uxMaxCount ) && ( xDone == pdFALSE ) )
+        {
+            uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+            {
+                ulAvailable = ulTraceWriteIndex - ulTraceReadIndex;
+
+                if( ulAvailable > ( uint32_t ) ipconfigTRACE_RING_RECORD_COUNT )
+                {
+                    /* The writers have overtaken the reader, skip to the oldest record. */
+                    ulTraceLostCount += ulAvailable - ( uint32_t ) ipconfigTRACE_RING_RECORD_COUNT;
+                    ulTraceReadIndex = ulTraceWriteIndex - ( uint32_t ) ipconfigTRACE_RING_RECORD_COUNT;
+                }
+
+                if( ulAvailable == 0U )
+                {
+                    xDone = pdTRUE;
+                }
+                else
+                {
+                    ( void ) memcpy( &( pxRecords[ uxCount ] ), &( xTraceRing[ ulTraceReadIndex & traceRING_INDEX_MASK ] ), sizeof( pxRecords[ uxCount ] ) );
+                    ulTraceReadIndex++;
+                    uxCount++;
+                }
+            }
+            portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+        }
+
+        if( uxCount > 0U )
+        {
+            /* The lost count is reported together with the records that follow the gap. */
+            uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+            {
+                ulLost = ulTraceLostCount;
+                ulTraceLostCount = 0U;
+            }
+            portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+        }
+
+        if( pxHeader != NULL )
+        {
+            pxHeader->ulMagic = traceRING_MAGIC;
+            pxHeader->usVersion = ( uint16_t ) traceRING_VERSION;
+            pxHeader->usRecordSize = ( uint16_t ) sizeof( TraceRingRecord_t );
+            pxHeader->ulTimeStampHz = traceRING_TIMESTAMP_HZ;
+            pxHeader->ulRecordCount = ( uint32_t ) uxCount;
+            pxHeader->ulLostCount = ulLost;
+        }
+
+        return uxCount;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xTraceRingSendUDP( const struct freertos_sockaddr * pxDestination )
+    {
+        BaseType_t xResult = pdFAIL;
+        Socket_t xSocket;
+        size_t uxCount;
+        size_t uxLength;
+        TraceRingBlock_t xTraceBlock;
+
+        xSocket = FreeRTOS_socket( ( BaseType_t ) pxDestination->sin_family, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+
+        if( xSocketValid( xSocket ) == pdTRUE )
+        {
+            xResult = pdPASS;
+
+            do
+            {
+                uxCount = uxTraceRingRead( &( xTraceBlock.xHeader ), xTraceBlock.xRecords, traceRING_RECORDS_PER_PACKET );
+
+                if( uxCount > 0U )
+                {
+                    uxLength = sizeof( xTraceBlock.xHeader ) + ( uxCount * sizeof( xTraceBlock.xRecords[ 0 ] ) );
+
+                    if( FreeRTOS_sendto( xSocket, &( xTraceBlock ), uxLength, 0, pxDestination, sizeof( *pxDestination ) ) <= 0 )
+                    {
+                        /* The records read are lost. */
+                        xResult = pdFAIL;
+                    }
+                }
+            } while( ( uxCount == traceRING_RECORDS_PER_PACKET ) && ( xResult == pdPASS ) );
+
+            ( void ) FreeRTOS_closesocket( xSocket );
+        }
+
+        return xResult;
+    }
+/*-----------------------------------------------------------*/
+
+    #if defined( __linux__ ) || defined( _WIN32 )
+
+        BaseType_t xTraceRingWriteFile( const char * pcFileName )
+        {
+            BaseType_t xResult = pdFAIL;
+            FILE * pxFile;
+            size_t uxCount;
+            size_t uxLength;
+            TraceRingBlock_t xTraceBlock;
+
+            pxFile = fopen( pcFileName, "ab" );
+
+            if( pxFile != NULL )
+            {
+                xResult = pdPASS;
+
+                do
+                {
+                    uxCount = uxTraceRingRead( &( xTraceBlock.xHeader ), xTraceBlock.xRecords, traceRING_RECORDS_PER_PACKET );
+
+                    if( uxCount > 0U )
+                    {
+                        uxLength = sizeof( xTraceBlock.xHeader ) + ( uxCount * sizeof( xTraceBlock.xRecords[ 0 ] ) );
+
+                        if( fwrite( &( xTraceBlock ), 1U, uxLength, pxFile ) != uxLength )
+                        {
+                            xResult = pdFAIL;
+                        }
+                    }
+                } while( ( uxCount == traceRING_RECORDS_PER_PACKET ) && ( xResult == pdPASS ) );
+
+                ( void ) fclose( pxFile );
+            }
+
+            return xResult;
+        }
+    #endif /* defined( __linux__ ) || defined( _WIN32 ) */
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_TRACE_RING != 0 */